@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <exception>
+# include <memory>
+# include <vector>
+# include <QRunnable>
+# include <QSemaphore>
+# include <QThread>
+# include <QThreadPool>
+#endif
+
+#include "Parallel.h"
+
+
+namespace {
+
+class ChunkRunner : public QRunnable
+{
+public:
+    ChunkRunner(const std::function<void(std::size_t, std::size_t)>& func,
+                std::size_t begin, std::size_t end, QSemaphore& done)
+        : func(func), begin(begin), end(end), done(done)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        try {
+            func(begin, end);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        done.release();
+    }
+
+    std::exception_ptr error;
+
+private:
+    const std::function<void(std::size_t, std::size_t)>& func;
+    std::size_t begin;
+    std::size_t end;
+    QSemaphore& done;
+};
+
+}
+
+int Base::idealThreadCount(int threads)
+{
+    if (threads < 1)
+        threads = QThread::idealThreadCount();
+    return std::max(threads, 1);
+}
+
+void Base::parallel_for(std::size_t count, int threads,
+                        const std::function<void(std::size_t, std::size_t)>& func)
+{
+    std::size_t numChunks = std::min<std::size_t>(count, static_cast<std::size_t>(idealThreadCount(threads)));
+    if (numChunks < 2) {
+        func(std::size_t(0), count);
+        return;
+    }
+
+    std::size_t chunk = (count + numChunks - 1) / numChunks;
+    QThreadPool* pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    std::vector<std::unique_ptr<ChunkRunner>> runners;
+    for (std::size_t begin = chunk; begin < count; begin += chunk) {
+        runners.emplace_back(new ChunkRunner(func, begin, std::min(begin + chunk, count), done));
+        pool->start(runners.back().get());
+    }
+
+    std::exception_ptr error;
+    try {
+        func(std::size_t(0), std::min(chunk, count));
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    // Chunks that no pool thread has picked up yet are run here. This way nested
+    // calls from inside a pool thread cannot dead-lock on an exhausted pool.
+    for (auto& it : runners) {
+        if (pool->tryTake(it.get()))
+            it->run();
+    }
+    done.acquire(static_cast<int>(runners.size()));
+
+    for (auto& it : runners) {
+        if (!error)
+            error = it->error;
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_PARALLEL_H
+#define BASE_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <FCGlobal.h>
+
+namespace Base
+{
+
+/** Splits the range [0, count) into consecutive chunks and calls \a func(begin, end)
+ * for each of them in up to \a threads threads of the global thread pool. The first
+ * chunk is processed in the calling thread. A value of 0 or less for \a threads uses
+ * as many threads as cores are available.
+ * The function returns after all chunks are processed. If \a func throws an exception
+ * the remaining chunks are still waited for and the first exception is re-thrown.
+ */
+BaseExport void parallel_for(std::size_t count, int threads,
+                             const std::function<void(std::size_t, std::size_t)>& func);
+
+/** Returns \a threads if it is positive, otherwise the number of available cores.
+ */
+BaseExport int idealThreadCount(int threads = 0);
+
+/** Sorts the range [begin, end) by sorting consecutive chunks of it in up to \a threads
+ * threads and merging them pairwise afterwards.
+ */
+template <class Iter, class Pred>
+void parallel_sort(Iter begin, Iter end, Pred comp, int threads)
+{
+    std::size_t count = static_cast<std::size_t>(end - begin);
+    std::size_t numChunks = std::min<std::size_t>(count, static_cast<std::size_t>(idealThreadCount(threads)));
+    if (numChunks < 2) {
+        std::sort(begin, end, comp);
+        return;
+    }
+
+    std::size_t chunk = (count + numChunks - 1) / numChunks;
+    numChunks = (count + chunk - 1) / chunk;
+    parallel_for(numChunks, static_cast<int>(numChunks), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++)
+            std::sort(begin + i * chunk, begin + std::min((i + 1) * chunk, count), comp);
+    });
+    for (std::size_t width = chunk; width < count; width *= 2) {
+        std::size_t numMerges = (count + 2 * width - 1) / (2 * width);
+        parallel_for(numMerges, threads, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                std::size_t lo = i * 2 * width;
+                std::size_t mid = std::min(lo + width, count);
+                std::size_t hi = std::min(lo + 2 * width, count);
+                if (mid < hi)
+                    std::inplace_merge(begin + lo, begin + mid, begin + hi, comp);
+            }
+        });
+    }
+}
+
+} // namespace Base
+
+#endif // BASE_PARALLEL_H
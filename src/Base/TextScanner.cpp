@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <charconv>
+# include <cstdlib>
+# include <cstring>
+#endif
+
+#include "TextScanner.h"
+
+
+using namespace Base;
+
+const char* TextScanner::SkipBlanks(const char* ptr, const char* end)
+{
+    while (ptr != end && IsBlank(*ptr))
+        ++ptr;
+    return ptr;
+}
+
+const char* TextScanner::NextLine(const char* ptr, const char* end)
+{
+    const char* eol = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+    return eol ? eol + 1 : end;
+}
+
+bool TextScanner::ReadNumber(const char*& ptr, const char* end, double& value)
+{
+    const char* first = SkipBlanks(ptr, end);
+    const char* last = first;
+    while (!IsLineEnd(last, end) && !IsBlank(*last))
+        ++last;
+    if (first == last)
+        return false;
+
+    // std::from_chars doesn't accept a leading plus sign
+    const char* digits = first;
+    if (*digits == '+' && last - digits > 1 && digits[1] != '-')
+        ++digits;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(digits, last, value);
+    if (result.ec != std::errc() || result.ptr != last)
+        return false;
+#else
+    char token[64];
+    std::size_t length = static_cast<std::size_t>(last - digits);
+    if (length >= sizeof(token))
+        return false;
+    std::memcpy(token, digits, length);
+    token[length] = '\0';
+    char* stop = nullptr;
+    value = std::strtod(token, &stop);
+    if (stop != token + length)
+        return false;
+#endif
+
+    ptr = last;
+    return true;
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef BASE_TEXTSCANNER_H
+#define BASE_TEXTSCANNER_H
+
+#include <FCGlobal.h>
+
+namespace Base
+{
+
+/**
+ * The TextScanner class decodes the lines of a text in memory. The text is given
+ * by a range [ptr, end) and the functions move \a ptr forward without copying.
+ */
+class BaseExport TextScanner
+{
+public:
+    /// Returns true for a space, tab or carriage return.
+    static bool IsBlank(char c)
+    { return c == ' ' || c == '\t' || c == '\r'; }
+    /// Returns true if \a ptr is at the end of the current line.
+    static bool IsLineEnd(const char* ptr, const char* end)
+    { return ptr == end || *ptr == '\n'; }
+    /// Returns the first character of the current line that is not blank.
+    static const char* SkipBlanks(const char* ptr, const char* end);
+    /// Returns the start of the next line.
+    static const char* NextLine(const char* ptr, const char* end);
+    /** Reads the next blank separated token of the current line as number and moves
+     * \a ptr behind it. If there is no further token or it's not a number false is returned.
+     */
+    static bool ReadNumber(const char*& ptr, const char* end, double& value);
+};
+
+} // namespace Base
+
+#endif // BASE_TEXTSCANNER_H
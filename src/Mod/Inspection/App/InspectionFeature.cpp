@@ -416,11 +416,13 @@ float InspectNominalFastMesh::getDistance(const Base::Vector3f& point) const
 
 // ----------------------------------------------------------------
 
-InspectNominalPoints::InspectNominalPoints(const Points::PointKernel& Kernel, float /*offset*/)
+InspectNominalPoints::InspectNominalPoints(const Points::PointKernel& Kernel, float offset)
   : _rKernel(Kernel)
+  , _fOffset(offset)
 {
-    int uGridPerAxis = 50; // totally 125.000 grid elements 
-    this->_pGrid = new Points::PointsGrid (Kernel, uGridPerAxis);
+    unsigned long ulX, ulY, ulZ;
+    Points::PointsGrid::CalculateGridCounts(Kernel, POINTS_CT_GRID_SEARCH, ulX, ulY, ulZ);
+    this->_pGrid = new Points::PointsGrid (Kernel, ulX, ulY, ulZ);
 }
 
 InspectNominalPoints::~InspectNominalPoints()
@@ -430,23 +432,14 @@ InspectNominalPoints::~InspectNominalPoints()
 
 float InspectNominalPoints::getDistance(const Base::Vector3f& point) const
 {
-    //TODO: Make faster
-    std::set<unsigned long> indices;
-    unsigned long x,y,z;
+    // points further away than the search radius are rejected by the caller anyway
+    std::vector<unsigned long> indices;
+    std::vector<double> distances;
     Base::Vector3d pointd(point.x,point.y,point.z);
-    _pGrid->Position(pointd, x, y, z);
-    _pGrid->GetElements(x,y,z,indices);
-
-    double fMinDist=DBL_MAX;
-    for (std::set<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        Base::Vector3d pt = _rKernel.getPoint(*it);
-        double fDist = Base::Distance(pointd, pt);
-        if (fDist < fMinDist) {
-            fMinDist = fDist;
-        }
-    }
+    if (_pGrid->FindNearest(pointd, 1, indices, &distances, _fOffset) == 0)
+        return FLT_MAX;
 
-    return (float)fMinDist;
+    return (float)distances.front();
 }
 
 // ----------------------------------------------------------------
@@ -147,6 +147,7 @@ public:
 private:
     const Points::PointKernel& _rKernel;
     Points::PointsGrid* _pGrid;
+    float _fOffset;
 };
 
 class InspectionExport InspectNominalShape : public InspectNominalGeometry
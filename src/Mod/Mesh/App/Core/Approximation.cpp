@@ -1433,6 +1433,157 @@ void SphereFit::ProjectToSphere()
 
 // -------------------------------------------------------------------------------
 
+PlaneMomentFit::PlaneMomentFit()
+{
+    Clear();
+}
+
+void PlaneMomentFit::Clear()
+{
+    _vOrigin.Set(0.0, 0.0, 0.0);
+    std::fill(_dSum, _dSum + 3, 0.0);
+    std::fill(_dSum2, _dSum2 + 6, 0.0);
+    _ulCount = 0;
+    _bIsFitted = false;
+    _vBase.Set(0.0f, 0.0f, 0.0f);
+    _vNormal.Set(0.0f, 0.0f, 0.0f);
+}
+
+void PlaneMomentFit::AddPoint(const Base::Vector3f &rcVector)
+{
+    if (_ulCount == 0)
+        _vOrigin = Base::convertTo<Base::Vector3d>(rcVector);
+
+    double x = double(rcVector.x) - _vOrigin.x;
+    double y = double(rcVector.y) - _vOrigin.y;
+    double z = double(rcVector.z) - _vOrigin.z;
+    _dSum[0] += x; _dSum[1] += y; _dSum[2] += z;
+    _dSum2[0] += x * x; _dSum2[1] += x * y; _dSum2[2] += x * z;
+    _dSum2[3] += y * y; _dSum2[4] += y * z; _dSum2[5] += z * z;
+    _ulCount++;
+    _bIsFitted = false;
+}
+
+float PlaneMomentFit::Fit()
+{
+    _bIsFitted = true;
+    if (_ulCount < 3)
+        return FLOAT_MAX;
+
+    double nSize = double(_ulCount);
+    double mx = _dSum[0] / nSize;
+    double my = _dSum[1] / nSize;
+    double mz = _dSum[2] / nSize;
+
+    // Covariance matrix
+    Eigen::Matrix3d covMat;
+    covMat(0,0) = _dSum2[0] - _dSum[0] * mx;
+    covMat(1,1) = _dSum2[3] - _dSum[1] * my;
+    covMat(2,2) = _dSum2[5] - _dSum[2] * mz;
+    covMat(0,1) = covMat(1,0) = _dSum2[1] - _dSum[0] * my;
+    covMat(0,2) = covMat(2,0) = _dSum2[2] - _dSum[0] * mz;
+    covMat(1,2) = covMat(2,1) = _dSum2[4] - _dSum[1] * mz;
+
+    // The eigenvalues are in increasing order
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(covMat);
+    if (eig.info() != Eigen::Success)
+        return FLOAT_MAX;
+
+    // points describe a line or even are identical
+    if (!(eig.eigenvalues()(1) > 0))
+        return FLOAT_MAX;
+
+    Eigen::Vector3d w = eig.eigenvectors().col(0);
+    _vNormal.Set(float(w.x()), float(w.y()), float(w.z()));
+    _vBase.Set(float(_vOrigin.x + mx), float(_vOrigin.y + my), float(_vOrigin.z + mz));
+
+    // This must be caused by some round-off errors
+    double sigma = std::max(eig.eigenvalues()(0), 0.0);
+    if (_ulCount > 3)
+        return float(sqrt(sigma / (nSize - 3)));
+    return 0.0f;
+}
+
+float PlaneMomentFit::GetDistanceToPlane(const Base::Vector3f &rcPoint) const
+{
+    if (_vNormal.IsNull())
+        return FLOAT_MAX;
+    return (rcPoint - _vBase) * _vNormal;
+}
+
+// -------------------------------------------------------------------------------
+
+SphereMomentFit::SphereMomentFit()
+{
+    Clear();
+}
+
+void SphereMomentFit::Clear()
+{
+    _vOrigin.Set(0.0, 0.0, 0.0);
+    std::fill(_dSum, _dSum + 4, 0.0);
+    std::fill(_dSum2, _dSum2 + 6, 0.0);
+    std::fill(_dSumW, _dSumW + 4, 0.0);
+    _ulCount = 0;
+    _bIsFitted = false;
+    _vCenter.Set(0.0f, 0.0f, 0.0f);
+    _fRadius = FLOAT_MAX;
+}
+
+void SphereMomentFit::AddPoint(const Base::Vector3f &rcVector)
+{
+    if (_ulCount == 0)
+        _vOrigin = Base::convertTo<Base::Vector3d>(rcVector);
+
+    double x = double(rcVector.x) - _vOrigin.x;
+    double y = double(rcVector.y) - _vOrigin.y;
+    double z = double(rcVector.z) - _vOrigin.z;
+    double w = x * x + y * y + z * z;
+    _dSum[0] += x; _dSum[1] += y; _dSum[2] += z; _dSum[3] += w;
+    _dSum2[0] += x * x; _dSum2[1] += x * y; _dSum2[2] += x * z;
+    _dSum2[3] += y * y; _dSum2[4] += y * z; _dSum2[5] += z * z;
+    _dSumW[0] += w * x; _dSumW[1] += w * y; _dSumW[2] += w * z; _dSumW[3] += w * w;
+    _ulCount++;
+    _bIsFitted = false;
+}
+
+float SphereMomentFit::Fit()
+{
+    _bIsFitted = true;
+    if (_ulCount < 4)
+        return FLOAT_MAX;
+
+    // Normal equations of the linear least-squares problem in (a, b, c, d)
+    Eigen::Matrix4d mat;
+    mat << _dSum2[0], _dSum2[1], _dSum2[2], _dSum[0],
+           _dSum2[1], _dSum2[3], _dSum2[4], _dSum[1],
+           _dSum2[2], _dSum2[4], _dSum2[5], _dSum[2],
+           _dSum[0],  _dSum[1],  _dSum[2],  double(_ulCount);
+    Eigen::Vector4d rhs(-_dSumW[0], -_dSumW[1], -_dSumW[2], -_dSum[3]);
+
+    // the points lie on a plane or line
+    Eigen::FullPivLU<Eigen::Matrix4d> lu(mat);
+    if (!lu.isInvertible())
+        return FLOAT_MAX;
+
+    Eigen::Vector4d abcd = lu.solve(rhs);
+    Eigen::Vector3d center = -0.5 * abcd.head<3>();
+    double radius2 = center.squaredNorm() - abcd(3);
+    if (!(radius2 > 0))
+        return FLOAT_MAX;
+
+    double radius = sqrt(radius2);
+    _vCenter.Set(float(_vOrigin.x + center.x()), float(_vOrigin.y + center.y()),
+                 float(_vOrigin.z + center.z()));
+    _fRadius = float(radius);
+
+    // The algebraic residual (|p-c|^2 - r^2) is about 2*r times the geometric distance
+    double residual = std::max(_dSumW[3] - abcd.dot(rhs), 0.0);
+    return float(sqrt(residual / double(_ulCount)) / (2.0 * radius));
+}
+
+// -------------------------------------------------------------------------------
+
 PolynomialFit::PolynomialFit()
 {
     for (int i=0; i<9; i++)
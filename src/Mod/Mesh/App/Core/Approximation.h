@@ -478,6 +478,98 @@ protected:
 
 // -------------------------------------------------------------------------------
 
+/**
+ * Approximation of a plane that only keeps the first and second order moments of the
+ * added points instead of the points themselves. Adding a point and refitting are
+ * constant time operations which makes the class suitable for algorithms that refit
+ * after each new point, e.g. region growing.
+ */
+class MeshExport PlaneMomentFit
+{
+public:
+    PlaneMomentFit();
+    void Clear();
+    void AddPoint(const Base::Vector3f &rcVector);
+    std::size_t CountPoints() const { return _ulCount; }
+    /**
+     * Returns true if Fit() has been called since the last point was added.
+     */
+    bool Done() const { return _bIsFitted; }
+    /**
+     * Fit a plane into the added points. We must have at least three non-collinear points
+     * to succeed. If the fit fails FLOAT_MAX is returned, otherwise the standard deviation.
+     */
+    float Fit();
+    /**
+     * Returns the base of the last successful fit.
+     */
+    Base::Vector3f GetBase() const { return _vBase; }
+    /**
+     * Returns the normal of the last successful fit or the null vector.
+     */
+    Base::Vector3f GetNormal() const { return _vNormal; }
+    /**
+     * Returns the distance from the point \a rcPoint to the fitted plane. If no fit has
+     * succeeded FLOAT_MAX is returned.
+     */
+    float GetDistanceToPlane(const Base::Vector3f &rcPoint) const;
+
+private:
+    Base::Vector3d _vOrigin; /**< The moments are taken relative to the first point. */
+    double _dSum[3];
+    double _dSum2[6];
+    std::size_t _ulCount;
+    bool _bIsFitted;
+    Base::Vector3f _vBase;
+    Base::Vector3f _vNormal;
+};
+
+// -------------------------------------------------------------------------------
+
+/**
+ * Algebraic approximation of a sphere that only keeps the moments of the added points.
+ * It minimizes the sum of (|p|^2 + a*x + b*y + c*z + d)^2 which is a linear problem and
+ * thus can be refitted in constant time after each new point.
+ */
+class MeshExport SphereMomentFit
+{
+public:
+    SphereMomentFit();
+    void Clear();
+    void AddPoint(const Base::Vector3f &rcVector);
+    std::size_t CountPoints() const { return _ulCount; }
+    /**
+     * Returns true if Fit() has been called since the last point was added.
+     */
+    bool Done() const { return _bIsFitted; }
+    /**
+     * Fit a sphere into the added points. At least four points not lying on a plane are
+     * needed to succeed. If the fit fails FLOAT_MAX is returned, otherwise the approximated
+     * standard deviation.
+     */
+    float Fit();
+    /**
+     * Returns the center of the last successful fit.
+     */
+    Base::Vector3f GetCenter() const { return _vCenter; }
+    /**
+     * Returns the radius of the last successful fit or FLOAT_MAX.
+     */
+    float GetRadius() const { return _fRadius; }
+
+private:
+    Base::Vector3d _vOrigin; /**< The moments are taken relative to the first point. */
+    double _dSum[4];   /**< x, y, z, |p|^2 */
+    double _dSum2[6];  /**< xx, xy, xz, yy, yz, zz */
+    double _dSumW[4];  /**< |p|^2*x, |p|^2*y, |p|^2*z, |p|^4 */
+    std::size_t _ulCount;
+    bool _bIsFitted;
+    Base::Vector3f _vCenter;
+    float _fRadius;
+};
+
+// -------------------------------------------------------------------------------
+
 /**
  * Helper class for the quadric fit. Includes the
  * partial derivates of the quadric and serves for
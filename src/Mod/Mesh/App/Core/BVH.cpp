@@ -0,0 +1,142 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <numeric>
+#endif
+
+#include "BVH.h"
+#include "MeshKernel.h"
+
+
+using namespace MeshCore;
+
+MeshFacetBVH::MeshFacetBVH(const MeshKernel& mesh, unsigned int leafSize)
+{
+    const MeshPointArray& points = mesh.GetPoints();
+    const MeshFacetArray& rFacets = mesh.GetFacets();
+    std::size_t numFacets = rFacets.size();
+
+    boxes.resize(numFacets);
+    centers.resize(numFacets);
+    for (std::size_t i = 0; i < numFacets; i++) {
+        const MeshFacet& face = rFacets[i];
+        Base::BoundBox3f& box = boxes[i];
+        box.Add(points[face._aulPoints[0]]);
+        box.Add(points[face._aulPoints[1]]);
+        box.Add(points[face._aulPoints[2]]);
+        centers[i] = box.GetCenter();
+    }
+
+    facets.resize(numFacets);
+    std::iota(facets.begin(), facets.end(), 0);
+
+    if (numFacets > 0) {
+        nodes.reserve(2 * numFacets / std::max<unsigned int>(leafSize, 1) + 1);
+        Build(0, numFacets, std::max<unsigned int>(leafSize, 1));
+    }
+}
+
+MeshFacetBVH::~MeshFacetBVH()
+{
+}
+
+std::size_t MeshFacetBVH::Build(std::size_t begin, std::size_t end, unsigned int leafSize)
+{
+    std::size_t index = nodes.size();
+    nodes.emplace_back();
+
+    Base::BoundBox3f box;
+    Base::BoundBox3f centerBox;
+    for (std::size_t i = begin; i < end; i++) {
+        box.Add(boxes[facets[i]]);
+        centerBox.Add(centers[facets[i]]);
+    }
+
+    nodes[index].box = box;
+    if (end - begin <= leafSize) {
+        nodes[index].index = begin;
+        nodes[index].count = end - begin;
+        return index;
+    }
+
+    // split at the median of the facet centers along the longest axis
+    int axis = 0;
+    float length = centerBox.LengthX();
+    if (centerBox.LengthY() > length) {
+        axis = 1;
+        length = centerBox.LengthY();
+    }
+    if (centerBox.LengthZ() > length) {
+        axis = 2;
+    }
+
+    std::size_t mid = begin + (end - begin) / 2;
+    std::nth_element(facets.begin() + begin, facets.begin() + mid, facets.begin() + end,
+                     [this, axis](FacetIndex a, FacetIndex b) {
+        return centers[a][axis] < centers[b][axis];
+    });
+
+    Build(begin, mid, leafSize);
+    std::size_t right = Build(mid, end, leafSize);
+    nodes[index].index = right;
+    nodes[index].count = 0;
+    return index;
+}
+
+Base::BoundBox3f MeshFacetBVH::GetBoundBox() const
+{
+    if (nodes.empty())
+        return Base::BoundBox3f();
+    return nodes.front().box;
+}
+
+void MeshFacetBVH::Intersect(const Base::BoundBox3f& box, std::vector<FacetIndex>& result) const
+{
+    if (nodes.empty())
+        return;
+
+    std::vector<std::size_t> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        std::size_t index = stack.back();
+        stack.pop_back();
+        if (!(node.box && box))
+            continue;
+
+        if (node.count > 0) {
+            for (std::size_t i = node.index; i < node.index + node.count; i++) {
+                FacetIndex facet = facets[i];
+                if (boxes[facet] && box)
+                    result.push_back(facet);
+            }
+        }
+        else {
+            stack.push_back(node.index);
+            stack.push_back(index + 1);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <vector>
+#include <Base/BoundBox.h>
+
+#include "Definitions.h"
+
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH class is a bounding volume hierarchy over the facets of a mesh.
+ * The nodes are stored in a flat array in depth-first order and each leaf refers to
+ * a contiguous range of a facet index array. Once built the hierarchy is read-only
+ * and thus can be queried from several threads at the same time.
+ */
+class MeshExport MeshFacetBVH
+{
+public:
+    /// Builds the hierarchy over all facets of \a mesh.
+    explicit MeshFacetBVH(const MeshKernel& mesh, unsigned int leafSize = 4);
+    ~MeshFacetBVH();
+
+    /// Returns the bounding box of all facets.
+    Base::BoundBox3f GetBoundBox() const;
+    /// Returns the bounding box of the facet with index \a facet.
+    const Base::BoundBox3f& GetBoundBox(FacetIndex facet) const
+    { return boxes[facet]; }
+    /// Appends the indices of all facets whose bounding box intersects with \a box.
+    void Intersect(const Base::BoundBox3f& box, std::vector<FacetIndex>& facets) const;
+    /// Returns the number of nodes of the hierarchy.
+    std::size_t CountNodes() const
+    { return nodes.size(); }
+    /**
+     * Visits the facets in the order of the distance of their bounding boxes to \a pnt and
+     * returns the facet with the smallest distance \a func(facet) or FACET_INDEX_MAX. The
+     * distance returned by \a func must not be smaller than the distance of \a pnt to the
+     * bounding box of the facet, FLOAT_MAX marks a facet without result. Of several facets
+     * with the same distance the one with the lowest index is taken.
+     */
+    template <class Func>
+    FacetIndex NearestFacet(const Base::Vector3f& pnt, Func func) const;
+
+private:
+    struct Node
+    {
+        Base::BoundBox3f box;
+        // For inner nodes the index of the right child (the left child directly
+        // follows its parent), for leaves the first entry in the facet array
+        std::size_t index;
+        // number of facets of a leaf, 0 for inner nodes
+        std::size_t count;
+    };
+
+    std::size_t Build(std::size_t begin, std::size_t end, unsigned int leafSize);
+
+private:
+    std::vector<Node> nodes;
+    std::vector<FacetIndex> facets;
+    std::vector<Base::BoundBox3f> boxes;
+    std::vector<Base::Vector3f> centers;
+};
+
+template <class Func>
+FacetIndex MeshFacetBVH::NearestFacet(const Base::Vector3f& pnt, Func func) const
+{
+    FacetIndex nearest = FACET_INDEX_MAX;
+    float minDist = FLOAT_MAX;
+    if (nodes.empty())
+        return nearest;
+
+    auto boxDistance = [&pnt](const Base::BoundBox3f& box) {
+        float dx = std::max(std::max(box.MinX - pnt.x, pnt.x - box.MaxX), 0.0f);
+        float dy = std::max(std::max(box.MinY - pnt.y, pnt.y - box.MaxY), 0.0f);
+        float dz = std::max(std::max(box.MinZ - pnt.z, pnt.z - box.MaxZ), 0.0f);
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    };
+
+    using Entry = std::pair<float, std::size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    queue.emplace(boxDistance(nodes.front().box), 0);
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+        if (entry.first > minDist)
+            break;
+
+        const Node& node = nodes[entry.second];
+        if (node.count > 0) {
+            for (std::size_t i = node.index; i < node.index + node.count; i++) {
+                FacetIndex facet = facets[i];
+                if (boxDistance(boxes[facet]) > minDist)
+                    continue;
+                float dist = func(facet);
+                if (dist < minDist || (dist == minDist && dist < FLOAT_MAX && facet < nearest)) {
+                    minDist = dist;
+                    nearest = facet;
+                }
+            }
+        }
+        else {
+            queue.emplace(boxDistance(nodes[entry.second + 1].box), entry.second + 1);
+            queue.emplace(boxDistance(nodes[node.index].box), node.index);
+        }
+    }
+
+    return nearest;
+}
+
+} // namespace MeshCore
+
+#endif // MESH_BVH_H
@@ -26,22 +26,18 @@
 # include <functional>
 #endif
 
-#include <QFuture>
-#include <QFutureWatcher>
-#include <QtConcurrentMap>
-
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
 
 //#define OPTIMIZE_CURVATURE
 #ifdef OPTIMIZE_CURVATURE
 # include <Eigen/Eigenvalues>
-#else
-# include <Mod/Mesh/App/WildMagic4/Wm4MeshCurvature.h>
 #endif
+#include <Mod/Mesh/App/WildMagic4/Wm4MeshCurvature.h>
 
 #include "Curvature.h"
 #include "Approximation.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
 #include "Tools.h"
@@ -51,14 +47,14 @@ using namespace MeshCore;
 namespace sp = std::placeholders;
 
 MeshCurvature::MeshCurvature(const MeshKernel& kernel)
-  : myKernel(kernel), myMinPoints(20), myRadius(0.5f)
+  : myKernel(kernel), myMinPoints(20), myRadius(0.5f), myThreads(1)
 {
     mySegment.resize(kernel.CountFacets());
     std::generate(mySegment.begin(), mySegment.end(), Base::iotaGen<FacetIndex>(0));
 }
 
 MeshCurvature::MeshCurvature(const MeshKernel& kernel, const std::vector<FacetIndex>& segm)
-  : myKernel(kernel), myMinPoints(20), myRadius(0.5f), mySegment(segm)
+  : myKernel(kernel), myMinPoints(20), myRadius(0.5f), myThreads(1), mySegment(segm)
 {
 }
 
@@ -79,14 +75,12 @@ void MeshCurvature::ComputePerFace(bool parallel)
         }
     }
     else {
-        QFuture<CurvatureInfo> future = QtConcurrent::mapped
-            (mySegment, std::bind(&FacetCurvature::Compute, &face, sp::_1));
-        QFutureWatcher<CurvatureInfo> watcher;
-        watcher.setFuture(future);
-        watcher.waitForFinished();
-        for (QFuture<CurvatureInfo>::const_iterator it = future.begin(); it != future.end(); ++it) {
-            myCurvature.push_back(*it);
-        }
+        // write directly into the preallocated result
+        myCurvature.resize(mySegment.size());
+        parallel_for(mySegment.size(), myThreads == 1 ? 0 : myThreads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                myCurvature[i] = face.Compute(mySegment[i]);
+        });
     }
 }
 
@@ -124,6 +118,11 @@ void GenerateComplementBasis (Eigen::Vector3f& rkU, Eigen::Vector3f& rkV,
 
 void MeshCurvature::ComputePerVertex()
 {
+    if (myThreads != 1) {
+        ComputePerVertexParallel();
+        return;
+    }
+
     // get all points
     const MeshPointArray& pts = myKernel.GetPoints();
 
@@ -291,6 +290,11 @@ void MeshCurvature::ComputePerVertex()
 #else
 void MeshCurvature::ComputePerVertex()
 {
+    if (myThreads != 1) {
+        ComputePerVertexParallel();
+        return;
+    }
+
     myCurvature.clear();
 
     // get all points
@@ -337,6 +341,143 @@ void MeshCurvature::ComputePerVertex()
 }
 #endif // OPTIMIZE_CURVATURE
 
+void MeshCurvature::ComputePerVertexParallel()
+{
+    // This is the algorithm of Wm4::MeshCurvature but instead of accumulating the
+    // values triangle by triangle each point gathers them from its adjacent triangles.
+    // As the triangles are visited in the same order the results are identical.
+    myCurvature.clear();
+    std::size_t numPoints = myKernel.CountPoints();
+    std::size_t numFacets = myKernel.CountFacets();
+    if (numPoints == 0 || numFacets == 0)
+        return;
+
+    const MeshPointArray& pts = myKernel.GetPoints();
+    const MeshFacetArray& fts = myKernel.GetFacets();
+    int threads = myThreads;
+
+    // flat list of the triangle corners per point
+    std::vector<std::size_t> offsets(numPoints + 1, 0);
+    for (const auto& it : fts) {
+        for (PointIndex index : it._aulPoints)
+            offsets[index + 1]++;
+    }
+    for (std::size_t i = 0; i < numPoints; i++)
+        offsets[i + 1] += offsets[i];
+    std::vector<std::size_t> corners(offsets.back());
+    {
+        std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < numFacets; i++) {
+            for (std::size_t j = 0; j < 3; j++)
+                corners[fill[fts[i]._aulPoints[j]]++] = 3 * i + j;
+        }
+    }
+
+    auto vertex = [&pts](PointIndex index) {
+        const MeshPoint& p = pts[index];
+        return Wm4::Vector3<double>(p.x, p.y, p.z);
+    };
+
+    // compute normal vectors
+    std::vector< Wm4::Vector3<double> > akNormal(numPoints);
+    parallel_for(numPoints, threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Wm4::Vector3<double> kSum(0.0, 0.0, 0.0);
+            for (std::size_t k = offsets[i]; k < offsets[i + 1]; k++) {
+                const MeshFacet& face = fts[corners[k] / 3];
+                Wm4::Vector3<double> kV0 = vertex(face._aulPoints[0]);
+                Wm4::Vector3<double> kEdge1 = vertex(face._aulPoints[1]) - kV0;
+                Wm4::Vector3<double> kEdge2 = vertex(face._aulPoints[2]) - kV0;
+                kSum += kEdge1.Cross(kEdge2);
+            }
+            kSum.Normalize();
+            akNormal[i] = kSum;
+        }
+    });
+
+    myCurvature.resize(numPoints);
+    parallel_for(numPoints, threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Wm4::Matrix3<double> akWWTrn(0, 0, 0, 0, 0, 0, 0, 0, 0);
+            Wm4::Matrix3<double> akDWTrn(0, 0, 0, 0, 0, 0, 0, 0, 0);
+            const Wm4::Vector3<double>& kN = akNormal[i];
+            Wm4::Vector3<double> kV0 = vertex(i);
+
+            for (std::size_t k = offsets[i]; k < offsets[i + 1]; k++) {
+                const MeshFacet& face = fts[corners[k] / 3];
+                std::size_t j = corners[k] % 3;
+                PointIndex aiV[2] = {face._aulPoints[(j+1)%3], face._aulPoints[(j+2)%3]};
+                for (PointIndex iV : aiV) {
+                    // Compute edge from V0 to V1, project to tangent plane of vertex,
+                    // and compute difference of adjacent normals.
+                    Wm4::Vector3<double> kE = vertex(iV) - kV0;
+                    Wm4::Vector3<double> kW = kE - (kE.Dot(kN))*kN;
+                    Wm4::Vector3<double> kD = akNormal[iV] - kN;
+                    for (int iRow = 0; iRow < 3; iRow++) {
+                        for (int iCol = 0; iCol < 3; iCol++) {
+                            akWWTrn[iRow][iCol] += kW[iRow]*kW[iCol];
+                            akDWTrn[iRow][iCol] += kD[iRow]*kW[iCol];
+                        }
+                    }
+                }
+            }
+
+            // Add in N*N^T to W*W^T for numerical stability.
+            for (int iRow = 0; iRow < 3; iRow++) {
+                for (int iCol = 0; iCol < 3; iCol++) {
+                    akWWTrn[iRow][iCol] = 0.5*akWWTrn[iRow][iCol] + kN[iRow]*kN[iCol];
+                    akDWTrn[iRow][iCol] *= 0.5;
+                }
+            }
+
+            Wm4::Matrix3<double> akDNormal = akDWTrn*akWWTrn.Inverse();
+
+            // compute U and V given N
+            Wm4::Vector3<double> kU, kV;
+            Wm4::Vector3<double>::GenerateComplementBasis(kU,kV,kN);
+
+            // Compute S = J^T * dN/dX * J and make sure it is symmetric
+            double fS01 = kU.Dot(akDNormal*kV);
+            double fS10 = kV.Dot(akDNormal*kU);
+            double fSAvr = 0.5*(fS01+fS10);
+            Wm4::Matrix2<double> kS(kU.Dot(akDNormal*kU), fSAvr,
+                                    fSAvr, kV.Dot(akDNormal*kV));
+
+            // compute the eigenvalues of S (min and max curvatures)
+            double fTrace = kS[0][0] + kS[1][1];
+            double fDet = kS[0][0]*kS[1][1] - kS[0][1]*kS[1][0];
+            double fDiscr = fTrace*fTrace - 4.0*fDet;
+            double fRootDiscr = sqrt(fabs(fDiscr));
+            double fMinCurvature = 0.5*(fTrace - fRootDiscr);
+            double fMaxCurvature = 0.5*(fTrace + fRootDiscr);
+
+            // compute the eigenvectors of S
+            auto direction = [&](double fCurvature) {
+                Wm4::Vector2<double> kW0(kS[0][1],fCurvature-kS[0][0]);
+                Wm4::Vector2<double> kW1(fCurvature-kS[1][1],kS[1][0]);
+                Wm4::Vector3<double> kDir;
+                if (kW0.SquaredLength() >= kW1.SquaredLength()) {
+                    kW0.Normalize();
+                    kDir = kW0.X()*kU + kW0.Y()*kV;
+                }
+                else {
+                    kW1.Normalize();
+                    kDir = kW1.X()*kU + kW1.Y()*kV;
+                }
+                return Base::Vector3f(static_cast<float>(kDir.X()),
+                                      static_cast<float>(kDir.Y()),
+                                      static_cast<float>(kDir.Z()));
+            };
+
+            CurvatureInfo& ci = myCurvature[i];
+            ci.cMaxCurvDir = direction(fMaxCurvature);
+            ci.cMinCurvDir = direction(fMinCurvature);
+            ci.fMaxCurvature = static_cast<float>(fMaxCurvature);
+            ci.fMinCurvature = static_cast<float>(fMinCurvature);
+        }
+    });
+}
+
 // --------------------------------------------------------
 
 namespace MeshCore {
@@ -59,14 +59,24 @@ public:
     MeshCurvature(const MeshKernel& kernel, const std::vector<FacetIndex>& segm);
     float GetRadius() const { return myRadius; }
     void SetRadius(float r) { myRadius = r; }
+    /** Sets the number of threads. With a value other than 1 the per-vertex curvature is
+     * computed by a native implementation that processes the points concurrently and
+     * writes into the preallocated result. A value of 0 uses all available cores.
+     * The default is 1.
+     */
+    void SetThreads(int num) { myThreads = num; }
     void ComputePerFace(bool parallel);
     void ComputePerVertex();
     const std::vector<CurvatureInfo>& GetCurvature() const { return myCurvature; }
 
+private:
+    void ComputePerVertexParallel();
+
 private:
     const MeshKernel& myKernel;
     unsigned long myMinPoints;
     float myRadius;
+    int myThreads;
     std::vector<FacetIndex> mySegment;
     std::vector<CurvatureInfo> myCurvature;
 };
@@ -21,6 +21,17 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <functional>
+# include <numeric>
+# include <unordered_map>
+#endif
+
+#include <QFuture>
+#include <QtConcurrentMap>
+
+#include <Base/Sequencer.h>
 
 #include "Decimation.h"
 #include "MeshKernel.h"
@@ -29,20 +40,11 @@
 
 using namespace MeshCore;
 
-MeshSimplify::MeshSimplify(MeshKernel& mesh)
-  : myKernel(mesh)
-{
-}
+namespace {
 
-MeshSimplify::~MeshSimplify()
+void fillSimplify(const MeshPointArray& points, const MeshFacetArray& facets, Simplify& alg)
 {
-}
-
-void MeshSimplify::simplify(float tolerance, float reduction)
-{
-    Simplify alg;
-
-    const MeshPointArray& points = myKernel.GetPoints();
+    alg.vertices.reserve(points.size());
     for (std::size_t i = 0; i < points.size(); i++) {
         Simplify::Vertex v;
         v.tstart = 0;
@@ -52,7 +54,7 @@ void MeshSimplify::simplify(float tolerance, float reduction)
         alg.vertices.push_back(v);
     }
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
+    alg.triangles.reserve(facets.size());
     for (std::size_t i = 0; i < facets.size(); i++) {
         Simplify::Triangle t;
         t.deleted = 0;
@@ -63,13 +65,10 @@ void MeshSimplify::simplify(float tolerance, float reduction)
             t.v[j] = facets[i]._aulPoints[j];
         alg.triangles.push_back(t);
     }
+}
 
-    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0f-reduction));
-
-    // Simplification starts
-    alg.simplify_mesh(target_count, tolerance);
-
-    // Simplification done
+void adoptSimplify(const Simplify& alg, MeshKernel& kernel)
+{
     MeshPointArray new_points;
     new_points.reserve(alg.vertices.size());
     for (std::size_t i = 0; i < alg.vertices.size(); i++) {
@@ -93,61 +92,288 @@ void MeshSimplify::simplify(float tolerance, float reduction)
         }
     }
 
-    myKernel.Adopt(new_points, new_facets, true);
+    kernel.Adopt(new_points, new_facets, true);
 }
 
-void MeshSimplify::simplify(int targetSize)
+using FacetRange = std::pair<std::vector<FacetIndex>::iterator,
+                             std::vector<FacetIndex>::iterator>;
+
+/*
+ * Result of a decimated partition. Points that are shared with other partitions
+ * keep their global index so that the partitions can be stitched together again.
+ */
+struct PartitionResult
 {
-    Simplify alg;
+    std::vector<Base::Vector3f> points;
+    std::vector<PointIndex> shared;
+    std::vector<int> triangles;
+};
 
-    const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.tstart = 0;
-        v.tcount = 0;
-        v.border = 0;
-        v.p = points[i];
-        alg.vertices.push_back(v);
+class PartitionDecimation
+{
+public:
+    PartitionDecimation(const MeshKernel& kernel, const std::vector<int>& owner,
+                        double ratio, double tolerance, double maxError)
+      : points(kernel.GetPoints())
+      , facets(kernel.GetFacets())
+      , owner(owner)
+      , ratio(ratio)
+      , tolerance(tolerance)
+      , maxError(maxError)
+    {
     }
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        t.deleted = 0;
-        t.dirty = 0;
-        for (int j = 0; j < 4; j++)
-            t.err[j] = 0.0;
-        for (int j = 0; j < 3; j++)
-            t.v[j] = facets[i]._aulPoints[j];
-        alg.triangles.push_back(t);
+    PartitionResult operator()(const FacetRange& range) const
+    {
+        // collect the points of the partition
+        std::vector<PointIndex> indices;
+        indices.reserve(3 * (range.second - range.first));
+        for (auto it = range.first; it != range.second; ++it) {
+            const MeshFacet& face = facets[*it];
+            indices.insert(indices.end(), face._aulPoints, face._aulPoints + 3);
+        }
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+        Simplify alg;
+        alg.max_error = maxError;
+        alg.vertices.resize(indices.size());
+        for (std::size_t i = 0; i < indices.size(); i++) {
+            Simplify::Vertex& v = alg.vertices[i];
+            v.tstart = 0;
+            v.tcount = 0;
+            v.border = 0;
+            v.p = points[indices[i]];
+            v.locked = owner[indices[i]] < 0 ? 1 : 0;
+            v.id = static_cast<int>(i);
+        }
+
+        alg.triangles.resize(range.second - range.first);
+        std::size_t index = 0;
+        for (auto it = range.first; it != range.second; ++it, ++index) {
+            const MeshFacet& face = facets[*it];
+            Simplify::Triangle& t = alg.triangles[index];
+            t.deleted = 0;
+            t.dirty = 0;
+            for (int j = 0; j < 4; j++)
+                t.err[j] = 0.0;
+            for (int j = 0; j < 3; j++) {
+                auto pos = std::lower_bound(indices.begin(), indices.end(), face._aulPoints[j]);
+                t.v[j] = static_cast<int>(pos - indices.begin());
+            }
+        }
+
+        int target_count = static_cast<int>(ratio * static_cast<double>(alg.triangles.size()));
+        alg.simplify_mesh(target_count, tolerance);
+
+        PartitionResult result;
+        result.points.reserve(alg.vertices.size());
+        result.shared.reserve(alg.vertices.size());
+        for (const auto& v : alg.vertices) {
+            result.points.push_back(v.p);
+            result.shared.push_back(v.locked ? indices[v.id] : POINT_INDEX_MAX);
+        }
+
+        result.triangles.reserve(3 * alg.triangles.size());
+        for (const auto& t : alg.triangles) {
+            if (!t.deleted)
+                result.triangles.insert(result.triangles.end(), t.v, t.v + 3);
+        }
+
+        return result;
+    }
+
+private:
+    const MeshPointArray& points;
+    const MeshFacetArray& facets;
+    const std::vector<int>& owner;
+    double ratio;
+    double tolerance;
+    double maxError;
+};
+
+}
+
+MeshSimplify::MeshSimplify(MeshKernel& mesh)
+  : myKernel(mesh)
+  , myPartitionSize(0)
+  , myParallel(true)
+{
+}
+
+MeshSimplify::~MeshSimplify()
+{
+}
+
+void MeshSimplify::setPartitionSize(std::size_t facets)
+{
+    myPartitionSize = facets;
+}
+
+void MeshSimplify::setParallel(bool on)
+{
+    myParallel = on;
+}
+
+void MeshSimplify::simplify(float tolerance, float reduction)
+{
+    std::size_t numFacets = myKernel.CountFacets();
+    int target_count = static_cast<int>(static_cast<float>(numFacets) * (1.0f-reduction));
+    simplifyKernel(target_count, tolerance, 0.0);
+}
+
+void MeshSimplify::simplify(int targetSize)
+{
+    simplifyKernel(targetSize, FLT_MAX, 0.0);
+}
+
+void MeshSimplify::simplifyToError(float maxError, int targetSize)
+{
+    simplifyKernel(std::max<int>(targetSize, 0), maxError, maxError);
+}
+
+void MeshSimplify::simplifyKernel(int targetSize, double tolerance, double maxError)
+{
+    if (myPartitionSize > 0 && myKernel.CountFacets() > myPartitionSize) {
+        simplifyPartitioned(targetSize, tolerance, maxError);
+        return;
     }
 
+    Simplify alg;
+    alg.max_error = maxError;
+    fillSimplify(myKernel.GetPoints(), myKernel.GetFacets(), alg);
+
     // Simplification starts
-    alg.simplify_mesh(targetSize, FLT_MAX);
+    alg.simplify_mesh(targetSize, tolerance);
 
     // Simplification done
-    MeshPointArray new_points;
-    new_points.reserve(alg.vertices.size());
-    for (std::size_t i = 0; i < alg.vertices.size(); i++) {
-        new_points.push_back(alg.vertices[i].p);
+    adoptSimplify(alg, myKernel);
+}
+
+void MeshSimplify::simplifyPartitioned(int targetSize, double tolerance, double maxError)
+{
+    const MeshPointArray& points = myKernel.GetPoints();
+    const MeshFacetArray& facets = myKernel.GetFacets();
+
+    // Split the facets recursively at the median of their centers along the
+    // longest side until each partition is small enough
+    std::vector<FacetIndex> order(facets.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    auto center = [&](FacetIndex index) {
+        const MeshFacet& face = facets[index];
+        return points[face._aulPoints[0]] + points[face._aulPoints[1]] + points[face._aulPoints[2]];
+    };
+
+    std::vector<FacetRange> parts;
+    std::vector<FacetRange> stack;
+    stack.emplace_back(order.begin(), order.end());
+    while (!stack.empty()) {
+        FacetRange range = stack.back();
+        stack.pop_back();
+        std::size_t count = range.second - range.first;
+        if (count <= myPartitionSize) {
+            parts.push_back(range);
+            continue;
+        }
+
+        Base::BoundBox3f box;
+        for (auto it = range.first; it != range.second; ++it)
+            box.Add(center(*it));
+        int axis = 0;
+        if (box.LengthY() > box.LengthX())
+            axis = 1;
+        if (box.LengthZ() > std::max(box.LengthX(), box.LengthY()))
+            axis = 2;
+
+        auto mid = range.first + count / 2;
+        std::nth_element(range.first, mid, range.second, [&](FacetIndex a, FacetIndex b) {
+            return center(a)[axis] < center(b)[axis];
+        });
+        stack.emplace_back(range.first, mid);
+        stack.emplace_back(mid, range.second);
     }
 
-    std::size_t numFacets = 0;
-    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted)
-            numFacets++;
+    // Points that are referenced by facets of different partitions get locked
+    std::vector<int> owner(points.size(), -1);
+    for (std::size_t i = 0; i < parts.size(); i++) {
+        int part = static_cast<int>(i) + 1;
+        for (auto it = parts[i].first; it != parts[i].second; ++it) {
+            for (PointIndex index : facets[*it]._aulPoints) {
+                if (owner[index] == -1)
+                    owner[index] = part;
+                else if (owner[index] != part)
+                    owner[index] = 0;
+            }
+        }
     }
-    MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
-    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted) {
-            MeshFacet face;
-            face._aulPoints[0] = alg.triangles[i].v[0];
-            face._aulPoints[1] = alg.triangles[i].v[1];
-            face._aulPoints[2] = alg.triangles[i].v[2];
-            new_facets.push_back(face);
+    for (auto& it : owner) {
+        if (it == 0)
+            it = -1;
+        else if (it > 0)
+            it = 0;
+    }
+
+    double ratio = static_cast<double>(targetSize) / static_cast<double>(facets.size());
+    PartitionDecimation decimate(myKernel, owner, ratio, tolerance, maxError);
+
+    // Only the partitions currently processed are copied into the working structure
+    std::vector<PartitionResult> results;
+    results.reserve(parts.size());
+    Base::SequencerLauncher seq("Decimating mesh...", parts.size() + 1);
+    if (myParallel) {
+        QFuture<PartitionResult> future = QtConcurrent::mapped
+            (parts, std::function<PartitionResult(const FacetRange&)>(decimate));
+        for (int i = 0; i < static_cast<int>(parts.size()); i++) {
+            results.push_back(future.resultAt(i));
+            seq.next();
+        }
+    }
+    else {
+        for (const auto& it : parts) {
+            results.push_back(decimate(it));
+            seq.next();
         }
     }
 
-    myKernel.Adopt(new_points, new_facets, true);
+    std::vector<int>().swap(owner);
+    std::vector<FacetIndex>().swap(order);
+
+    // Stitch the partitions together
+    MeshPointArray mergedPoints;
+    MeshFacetArray mergedFacets;
+    std::unordered_map<PointIndex, PointIndex> sharedPoints;
+    for (const auto& it : results) {
+        std::vector<PointIndex> index(it.points.size());
+        for (std::size_t i = 0; i < it.points.size(); i++) {
+            if (it.shared[i] != POINT_INDEX_MAX) {
+                auto jt = sharedPoints.insert(std::make_pair(it.shared[i], mergedPoints.size()));
+                if (jt.second)
+                    mergedPoints.push_back(it.points[i]);
+                index[i] = jt.first->second;
+            }
+            else {
+                index[i] = mergedPoints.size();
+                mergedPoints.push_back(it.points[i]);
+            }
+        }
+
+        for (std::size_t i = 0; i + 2 < it.triangles.size(); i += 3) {
+            mergedFacets.push_back(MeshFacet(index[it.triangles[i]],
+                                             index[it.triangles[i+1]],
+                                             index[it.triangles[i+2]]));
+        }
+    }
+    results.clear();
+
+    // Final pass to remove the seams between the partitions
+    Simplify alg;
+    alg.max_error = maxError;
+    fillSimplify(mergedPoints, mergedFacets, alg);
+    mergedPoints.clear();
+    mergedFacets.clear();
+    alg.simplify_mesh(targetSize, tolerance);
+    seq.next();
+
+    adoptSimplify(alg, myKernel);
 }
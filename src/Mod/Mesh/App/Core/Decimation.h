@@ -24,6 +24,7 @@
 #ifndef MESH_DECIMATION_H
 #define MESH_DECIMATION_H
 
+#include <cstddef>
 #include <Mod/Mesh/MeshGlobal.h>
 
 namespace MeshCore
@@ -37,9 +38,29 @@ public:
     ~MeshSimplify();
     void simplify(float tolerance, float reduction);
     void simplify(int targetSize);
+    /** Collapses edges as long as the quadric error of a collapse doesn't exceed \a maxError.
+     * If \a targetSize is greater than 0 the decimation stops when this number of facets is reached.
+     */
+    void simplifyToError(float maxError, int targetSize = 0);
+
+    /** Meshes with more than \a facets facets are split into spatial partitions of about this
+     * size. Each partition is decimated on its own while the vertices it shares with other
+     * partitions are locked. Afterwards a final pass over the merged mesh removes the seams.
+     * This way only the partitions being processed need to be copied into the working structure
+     * of the decimation. A value of 0 disables the partitioning (default).
+     */
+    void setPartitionSize(std::size_t facets);
+    /// Decimate the partitions concurrently (default: true)
+    void setParallel(bool);
+
+private:
+    void simplifyKernel(int targetSize, double tolerance, double maxError);
+    void simplifyPartitioned(int targetSize, double tolerance, double maxError);
 
 private:
     MeshKernel& myKernel;
+    std::size_t myPartitionSize;
+    bool myParallel;
 };
 
 } // namespace MeshCore
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <QtConcurrentRun>
 #include <QFuture>
+#include <Base/Parallel.h>
 
 
 namespace MeshCore
@@ -57,6 +58,8 @@ namespace MeshCore
         }
     }
 
+    using Base::parallel_for;
+
 } // namespace MeshCore
 
 
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <cctype>
+# include <charconv>
+#endif
+
+#include "ChunkedReader.h"
+
+
+using namespace MeshCore;
+
+ChunkedReader::ChunkedReader(std::istream& in, int threads, std::size_t chunkSize)
+  : in(in)
+  , threads(threads)
+  , chunkSize(std::max<std::size_t>(chunkSize, 1))
+{
+}
+
+bool ChunkedReader::ReadChunk(std::string& buf)
+{
+    // start with the incomplete line of the previous chunk
+    buf.swap(incomplete);
+    incomplete.clear();
+
+    std::size_t pos = std::string::npos;
+    while (in && pos == std::string::npos) {
+        std::size_t size = buf.size();
+        buf.resize(size + chunkSize);
+        in.read(&buf[size], static_cast<std::streamsize>(chunkSize));
+        buf.resize(size + static_cast<std::size_t>(in.gcount()));
+        pos = buf.rfind('\n');
+    }
+
+    // the last line is kept for the next chunk unless the end of the stream is reached
+    if (in && pos != std::string::npos) {
+        incomplete.assign(buf, pos + 1, std::string::npos);
+        buf.resize(pos + 1);
+    }
+
+    return !buf.empty();
+}
+
+bool ChunkedReader::ReadKeyword(const char*& ptr, const char* end, const char* keyword,
+                                bool ignoreCase)
+{
+    const char* pos = SkipBlanks(ptr, end);
+    for (; *keyword; ++keyword, ++pos) {
+        if (pos == end)
+            return false;
+        char c = *pos;
+        if (ignoreCase)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (c != *keyword)
+            return false;
+    }
+
+    if (!IsLineEnd(pos, end) && !IsBlank(*pos))
+        return false;
+    ptr = pos;
+    return true;
+}
+
+bool ChunkedReader::ReadNumber(const char*& ptr, const char* end, float& value)
+{
+    double number;
+    if (!ReadNumber(ptr, end, number))
+        return false;
+    value = static_cast<float>(number);
+    return true;
+}
+
+bool ChunkedReader::ReadInt(const char*& ptr, const char* end, int& value)
+{
+    const char* first = SkipBlanks(ptr, end);
+    if (first != end && *first == '+' && end - first > 1 && first[1] != '-')
+        ++first;
+    auto result = std::from_chars(first, end, value);
+    if (result.ec != std::errc())
+        return false;
+    ptr = result.ptr;
+    return true;
+}
+
+std::string ChunkedReader::ReadLine(const char*& ptr, const char* end)
+{
+    const char* first = SkipBlanks(ptr, end);
+    const char* last = first;
+    while (!IsLineEnd(last, end))
+        ++last;
+    ptr = last;
+    while (last != first && IsBlank(last[-1]))
+        --last;
+    return std::string(first, last);
+}
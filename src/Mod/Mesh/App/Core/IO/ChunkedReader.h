@@ -0,0 +1,127 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_IO_CHUNKED_READER_H
+#define MESH_IO_CHUNKED_READER_H
+
+#include <algorithm>
+#include <istream>
+#include <string>
+#include <vector>
+#include <QThread>
+
+#include <Base/TextScanner.h>
+#include <Mod/Mesh/MeshGlobal.h>
+#include <Mod/Mesh/App/Core/Functional.h>
+
+namespace MeshCore
+{
+
+/**
+ * The ChunkedReader class decodes text from a stream.
+ * The stream is read in chunks that end at a line break and several chunks are
+ * parsed by different threads at a time. The results of the chunks are merged in
+ * the original order, so that the outcome is the same as with a serial reader.
+ * Only a few chunks are kept in memory at a time. The chunks can be decoded with
+ * the functions of Base::TextScanner and the ones below.
+ */
+class MeshExport ChunkedReader : public Base::TextScanner
+{
+public:
+    /*!
+     * \brief ChunkedReader
+     * \param in -- the input stream
+     * \param threads -- the number of threads, a value of 0 or less uses all cores
+     * \param chunkSize -- the number of bytes that are read into one buffer
+     */
+    explicit ChunkedReader(std::istream& in, int threads = 0, std::size_t chunkSize = 0x400000);
+
+    /*!
+     * \brief Calls \a parse(result, begin, end) for each chunk of the stream where
+     * [begin, end) holds complete lines. Afterwards \a merge(result) is called for
+     * the results in the order of the chunks.
+     */
+    template <class Result, class Parse, class Merge>
+    bool Read(Parse parse, Merge merge);
+
+    /** @name Decoding */
+    //@{
+    /// Reads \a keyword if it's followed by a blank or the line end.
+    static bool ReadKeyword(const char*& ptr, const char* end, const char* keyword,
+                            bool ignoreCase = false);
+    using Base::TextScanner::ReadNumber;
+    /// Reads the next blank separated token of the current line as number.
+    static bool ReadNumber(const char*& ptr, const char* end, float& value);
+    /// Reads the next integer of the current line and stops at the first non-digit.
+    static bool ReadInt(const char*& ptr, const char* end, int& value);
+    /// Reads the rest of the current line without surrounding blanks.
+    static std::string ReadLine(const char*& ptr, const char* end);
+    //@}
+
+private:
+    bool ReadChunk(std::string& buf);
+
+private:
+    std::istream& in;
+    int threads;
+    std::size_t chunkSize;
+    std::string incomplete;
+};
+
+template <class Result, class Parse, class Merge>
+bool ChunkedReader::Read(Parse parse, Merge merge)
+{
+    if (!in || in.bad())
+        return false;
+
+    int numThreads = threads < 1 ? QThread::idealThreadCount() : threads;
+    std::size_t wave = static_cast<std::size_t>(std::max(numThreads, 1));
+
+    std::vector<std::string> buffers(wave);
+    std::vector<Result> results(wave);
+    for (;;) {
+        std::size_t numRead = 0;
+        while (numRead < wave && ReadChunk(buffers[numRead]))
+            numRead++;
+        if (numRead == 0)
+            break;
+
+        parallel_for(numRead, threads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                const char* data = buffers[i].data();
+                results[i] = Result();
+                parse(results[i], data, data + buffers[i].size());
+            }
+        });
+
+        for (std::size_t i = 0; i < numRead; i++)
+            merge(results[i]);
+    }
+
+    return true;
+}
+
+} // namespace MeshCore
+
+
+#endif  // MESH_IO_CHUNKED_READER_H
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <cstring>
+# include <iterator>
+#endif
+
+#include <fmt/format.h>
+
+#include "ChunkedWriter.h"
+
+
+using namespace MeshCore;
+
+ChunkedWriter::ChunkedWriter(std::ostream& out, int threads, std::size_t chunkSize)
+  : out(out)
+  , threads(threads)
+  , chunkSize(std::max<std::size_t>(chunkSize, 1))
+{
+}
+
+void ChunkedWriter::AppendFixed(std::string& buf, double value)
+{
+    fmt::format_to(std::back_inserter(buf), FMT_STRING("{:.6f}"), value);
+}
+
+void ChunkedWriter::AppendGeneral(std::string& buf, double value)
+{
+    fmt::format_to(std::back_inserter(buf), FMT_STRING("{:g}"), value);
+}
+
+void ChunkedWriter::AppendInt(std::string& buf, long long value)
+{
+    fmt::format_int str(value);
+    buf.append(str.data(), str.size());
+}
+
+void ChunkedWriter::AppendBinary(std::string& buf, float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    AppendBinary(buf, bits);
+}
+
+void ChunkedWriter::AppendBinary(std::string& buf, std::uint32_t value)
+{
+    char bytes[4] = {static_cast<char>(value & 0xff),
+                     static_cast<char>((value >> 8) & 0xff),
+                     static_cast<char>((value >> 16) & 0xff),
+                     static_cast<char>((value >> 24) & 0xff)};
+    buf.append(bytes, 4);
+}
+
+void ChunkedWriter::AppendBinary(std::string& buf, std::int32_t value)
+{
+    AppendBinary(buf, static_cast<std::uint32_t>(value));
+}
+
+void ChunkedWriter::AppendBinary(std::string& buf, std::uint16_t value)
+{
+    char bytes[2] = {static_cast<char>(value & 0xff),
+                     static_cast<char>((value >> 8) & 0xff)};
+    buf.append(bytes, 2);
+}
+
+void ChunkedWriter::AppendBinary(std::string& buf, std::uint8_t value)
+{
+    buf.push_back(static_cast<char>(value));
+}
@@ -0,0 +1,170 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_IO_CHUNKED_WRITER_H
+#define MESH_IO_CHUNKED_WRITER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentRun>
+
+#include <Base/Sequencer.h>
+#include <Mod/Mesh/MeshGlobal.h>
+#include <Mod/Mesh/App/Core/Functional.h>
+#include <Mod/Mesh/App/Core/Iterator.h>
+
+namespace MeshCore
+{
+
+/**
+ * The ChunkedWriter class encodes a sequence of elements into a stream.
+ * The elements are split into chunks that are encoded into string buffers by
+ * several threads. The buffers are written to the stream in the original order
+ * while the next chunks are encoded, so that the output is the same as with a
+ * serial writer. Only a few chunks are kept in memory at a time.
+ */
+class MeshExport ChunkedWriter
+{
+public:
+    /*!
+     * \brief ChunkedWriter
+     * \param out -- the output stream
+     * \param threads -- the number of threads, a value of 0 or less uses all cores
+     * \param chunkSize -- the number of elements that are encoded into one buffer
+     */
+    explicit ChunkedWriter(std::ostream& out, int threads = 0, std::size_t chunkSize = 0x4000);
+
+    /*!
+     * \brief Calls \a encode(buffer, begin, end) for consecutive ranges of [0, count)
+     * and writes the buffers in order to the stream. If \a seq is given it advances
+     * one step per chunk.
+     */
+    template <class Func>
+    bool Write(std::size_t count, Func encode, Base::SequencerLauncher* seq = nullptr);
+    /*!
+     * \brief Calls \a encode(buffer, facet, index) for each facet the iterator
+     * \a iter can reach. Each chunk uses its own copy of \a iter so that the
+     * facets (with the transformation of the iterator) are computed on the fly.
+     */
+    template <class Func>
+    bool WriteFacets(const MeshFacetIterator& iter, std::size_t count, Func encode,
+                     Base::SequencerLauncher* seq = nullptr);
+    /// Returns the number of chunks for \a count elements.
+    std::size_t CountChunks(std::size_t count) const
+    { return (count + chunkSize - 1) / chunkSize; }
+
+    /** @name Encoding */
+    //@{
+    /// Appends \a value like an ostream with std::fixed and precision 6.
+    static void AppendFixed(std::string& buf, double value);
+    /// Appends \a value like an ostream with default formatting.
+    static void AppendGeneral(std::string& buf, double value);
+    /// Appends the decimal representation of \a value.
+    static void AppendInt(std::string& buf, long long value);
+    /// Appends the bytes of \a value in little endian order.
+    static void AppendBinary(std::string& buf, float value);
+    static void AppendBinary(std::string& buf, std::uint32_t value);
+    static void AppendBinary(std::string& buf, std::int32_t value);
+    static void AppendBinary(std::string& buf, std::uint16_t value);
+    static void AppendBinary(std::string& buf, std::uint8_t value);
+    //@}
+
+private:
+    std::ostream& out;
+    int threads;
+    std::size_t chunkSize;
+};
+
+template <class Func>
+bool ChunkedWriter::Write(std::size_t count, Func encode, Base::SequencerLauncher* seq)
+{
+    if (!out || out.bad())
+        return false;
+
+    int numThreads = threads < 1 ? QThread::idealThreadCount() : threads;
+    std::size_t numChunks = CountChunks(count);
+    std::size_t wave = static_cast<std::size_t>(std::max(numThreads, 1));
+
+    // while the buffers of one wave are written the next wave is encoded
+    std::vector<std::string> encoded(wave), written(wave);
+    std::size_t numWritten = 0;
+    QFuture<void> writer;
+    auto writeBuffers = [this, &written, &numWritten]() {
+        for (std::size_t i = 0; i < numWritten; i++)
+            out.write(written[i].data(), static_cast<std::streamsize>(written[i].size()));
+    };
+
+    try {
+        for (std::size_t first = 0; first < numChunks; first += wave) {
+            std::size_t numEncoded = std::min(wave, numChunks - first);
+            parallel_for(numEncoded, threads, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    std::size_t chunk = first + i;
+                    encoded[i].clear();
+                    encode(encoded[i], chunk * chunkSize, std::min((chunk + 1) * chunkSize, count));
+                }
+            });
+
+            writer.waitForFinished();
+            if (!out)
+                return false;
+            encoded.swap(written);
+            numWritten = numEncoded;
+            writer = QtConcurrent::run(writeBuffers);
+
+            if (seq) {
+                for (std::size_t i = 0; i < numEncoded; i++)
+                    seq->next(true); // allow to cancel
+            }
+        }
+    }
+    catch (...) {
+        writer.waitForFinished();
+        throw;
+    }
+
+    writer.waitForFinished();
+    return out.good();
+}
+
+template <class Func>
+bool ChunkedWriter::WriteFacets(const MeshFacetIterator& iter, std::size_t count, Func encode,
+                                Base::SequencerLauncher* seq)
+{
+    return Write(count, [&iter, &encode](std::string& buf, std::size_t begin, std::size_t end) {
+        MeshFacetIterator it(iter);
+        it.Set(begin);
+        for (std::size_t index = begin; index < end; ++index, ++it)
+            encode(buf, *it, index);
+    }, seq);
+}
+
+} // namespace MeshCore
+
+
+#endif  // MESH_IO_CHUNKED_WRITER_H
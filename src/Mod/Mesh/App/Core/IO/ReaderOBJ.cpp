@@ -22,21 +22,159 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 # include <istream>
 # include <boost/lexical_cast.hpp>
-# include <boost/regex.hpp>
 # include <boost/tokenizer.hpp>
 #endif
 
 #include <Base/Tools.h>
 #include "Core/MeshIO.h"
 #include "Core/MeshKernel.h"
+#include "ChunkedReader.h"
 
 #include "ReaderOBJ.h"
 
 
 using namespace MeshCore;
 
+namespace {
+
+/* The content of a chunk of an OBJ file. The face indexes are kept as in the file
+ * together with the number of vertexes read before to resolve relative indexes.
+ * Groups and materials are kept with the number of faces read before.
+ */
+struct ChunkOBJ
+{
+    enum Kind {
+        Group,
+        Library,
+        Material
+    };
+    struct Face
+    {
+        int index[4];
+        int count;
+        std::size_t vertexes;
+    };
+    struct Name
+    {
+        Kind kind;
+        std::size_t faces;
+        std::string name;
+    };
+
+    MeshPointArray points;
+    std::vector<Face> faces;
+    std::vector<Name> names;
+    bool hasColors = false;
+};
+
+// a name consists of printable characters without spaces
+bool isName(const std::string& name)
+{
+    return !name.empty() && std::all_of(name.begin(), name.end(), [](char c) {
+        return c >= 0x21 && c <= 0x7E;
+    });
+}
+
+// a color component of a vertex can be an integer with up to three digits
+bool isColorByte(const char* first, const char* last)
+{
+    return last - first >= 1 && last - first <= 3 &&
+           std::all_of(first, last, [](char c) { return c >= '0' && c <= '9'; });
+}
+
+bool readFaceIndex(const char*& ptr, const char* end, int& index)
+{
+    if (!ChunkedReader::ReadInt(ptr, end, index))
+        return false;
+    // skip texture and normal indexes
+    while (!ChunkedReader::IsLineEnd(ptr, end) && !ChunkedReader::IsBlank(*ptr)) {
+        char c = *ptr++;
+        if (c != '/' && c != '+' && c != '-' && (c < '0' || c > '9'))
+            return false;
+    }
+    return true;
+}
+
+void parseVertex(ChunkOBJ& chunk, const char* ptr, const char* end)
+{
+    float values[6];
+    const char* first[6];
+    const char* last[6];
+    int count = 0;
+    for (; count < 6; count++) {
+        first[count] = ChunkedReader::SkipBlanks(ptr, end);
+        if (!ChunkedReader::ReadNumber(ptr, end, values[count]))
+            break;
+        last[count] = ptr;
+    }
+    if (!ChunkedReader::IsLineEnd(ChunkedReader::SkipBlanks(ptr, end), end))
+        return;
+    if (count != 3 && count != 6)
+        return;
+
+    chunk.points.push_back(MeshPoint(Base::Vector3f(values[0], values[1], values[2])));
+    if (count == 6) {
+        float r = values[3];
+        float g = values[4];
+        float b = values[5];
+        if (isColorByte(first[3], last[3]) && isColorByte(first[4], last[4]) &&
+            isColorByte(first[5], last[5])) {
+            r = std::min<int>(r, 255) / 255.0f;
+            g = std::min<int>(g, 255) / 255.0f;
+            b = std::min<int>(b, 255) / 255.0f;
+        }
+
+        App::Color c(r,g,b);
+        unsigned long prop = static_cast<uint32_t>(c.getPackedValue());
+        chunk.points.back().SetProperty(prop);
+        chunk.hasColors = true;
+    }
+}
+
+void parseFace(ChunkOBJ& chunk, const char* ptr, const char* end)
+{
+    ChunkOBJ::Face face;
+    face.count = 0;
+    face.vertexes = chunk.points.size();
+    while (!ChunkedReader::IsLineEnd(ChunkedReader::SkipBlanks(ptr, end), end)) {
+        if (face.count == 4 || !readFaceIndex(ptr, end, face.index[face.count]))
+            return;
+        face.count++;
+    }
+
+    if (face.count >= 3)
+        chunk.faces.push_back(face);
+}
+
+void parseName(ChunkOBJ& chunk, ChunkOBJ::Kind kind, const char* ptr, const char* end)
+{
+    std::string name = ChunkedReader::ReadLine(ptr, end);
+    if (kind == ChunkOBJ::Library ? !name.empty() : isName(name))
+        chunk.names.push_back({kind, chunk.faces.size(), name});
+}
+
+void parseChunk(ChunkOBJ& chunk, const char* begin, const char* end)
+{
+    for (const char* ptr = begin; ptr != end; ptr = ChunkedReader::NextLine(ptr, end)) {
+        const char* pos = ptr;
+        if (ChunkedReader::ReadKeyword(pos, end, "v"))
+            parseVertex(chunk, pos, end);
+        else if (ChunkedReader::ReadKeyword(pos, end, "f"))
+            parseFace(chunk, pos, end);
+        else if (ChunkedReader::ReadKeyword(pos, end, "g"))
+            parseName(chunk, ChunkOBJ::Group, pos, end);
+        else if (ChunkedReader::ReadKeyword(pos, end, "mtllib"))
+            parseName(chunk, ChunkOBJ::Library, pos, end);
+        else if (ChunkedReader::ReadKeyword(pos, end, "usemtl"))
+            parseName(chunk, ChunkOBJ::Material, pos, end);
+    }
+}
+
+}
+
 ReaderOBJ::ReaderOBJ(MeshKernel& kernel, Material* material)
   : _kernel(kernel)
   , _material(material)
@@ -45,37 +183,10 @@ ReaderOBJ::ReaderOBJ(MeshKernel& kernel, Material* material)
 
 bool ReaderOBJ::Load(std::istream &str)
 {
-    boost::regex rx_m("^mtllib\\s+(.+)\\s*$");
-    boost::regex rx_u("^usemtl\\s+([\\x21-\\x7E]+)\\s*$");
-    boost::regex rx_g("^g\\s+([\\x21-\\x7E]+)\\s*$");
-    boost::regex rx_p("^v\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::regex rx_c("^v\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+(\\d{1,3})\\s+(\\d{1,3})\\s+(\\d{1,3})\\s*$");
-    boost::regex rx_t("^v\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::regex rx_f3("^f\\s+([-+]?[0-9]+)/?[-+]?[0-9]*/?[-+]?[0-9]*"
-                         "\\s+([-+]?[0-9]+)/?[-+]?[0-9]*/?[-+]?[0-9]*"
-                         "\\s+([-+]?[0-9]+)/?[-+]?[0-9]*/?[-+]?[0-9]*\\s*$");
-    boost::regex rx_f4("^f\\s+([-+]?[0-9]+)/?[-+]?[0-9]*/?[-+]?[0-9]*"
-                         "\\s+([-+]?[0-9]+)/?[-+]?[0-9]*/?[-+]?[0-9]*"
-                         "\\s+([-+]?[0-9]+)/?[-+]?[0-9]*/?[-+]?[0-9]*"
-                         "\\s+([-+]?[0-9]+)/?[-+]?[0-9]*/?[-+]?[0-9]*\\s*$");
-    boost::cmatch what;
-
     unsigned long segment=0;
     MeshPointArray meshPoints;
     MeshFacetArray meshFacets;
 
-    std::string line;
-    float fX, fY, fZ;
     int  i1=1, i2=1, i3=1, i4=1;
     MeshFacet item;
 
@@ -92,80 +203,39 @@ bool ReaderOBJ::Load(std::istream &str)
     std::string materialName;
     unsigned long countMaterialFacets = 0;
 
-    while (std::getline(str, line)) {
-        if (boost::regex_match(line.c_str(), what, rx_p)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            meshPoints.push_back(MeshPoint(Base::Vector3f(fX, fY, fZ)));
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_c)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            float r = std::min<int>(std::atof(what[10].first), 255) / 255.0f;
-            float g = std::min<int>(std::atof(what[11].first), 255) / 255.0f;
-            float b = std::min<int>(std::atof(what[12].first), 255) / 255.0f;
-            meshPoints.push_back(MeshPoint(Base::Vector3f(fX, fY, fZ)));
-
-            App::Color c(r,g,b);
-            unsigned long prop = static_cast<uint32_t>(c.getPackedValue());
-            meshPoints.back().SetProperty(prop);
-            rgb_value = MeshIO::PER_VERTEX;
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_t)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            float r = static_cast<float>(std::atof(what[10].first));
-            float g = static_cast<float>(std::atof(what[13].first));
-            float b = static_cast<float>(std::atof(what[16].first));
-            meshPoints.push_back(MeshPoint(Base::Vector3f(fX, fY, fZ)));
-
-            App::Color c(r,g,b);
-            unsigned long prop = static_cast<uint32_t>(c.getPackedValue());
-            meshPoints.back().SetProperty(prop);
-            rgb_value = MeshIO::PER_VERTEX;
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_g)) {
+    auto setName = [&](const ChunkOBJ::Name& name) {
+        switch (name.kind) {
+        case ChunkOBJ::Group:
             new_segment = true;
-            groupName = Base::Tools::escapedUnicodeToUtf8(what[1].first);
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_m)) {
+            groupName = Base::Tools::escapedUnicodeToUtf8(name.name);
+            break;
+        case ChunkOBJ::Library:
             if (_material)
-                _material->library = Base::Tools::escapedUnicodeToUtf8(what[1].first);
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_u)) {
+                _material->library = Base::Tools::escapedUnicodeToUtf8(name.name);
+            break;
+        case ChunkOBJ::Material:
             if (!materialName.empty()) {
                 _materialNames.emplace_back(materialName, countMaterialFacets);
             }
-            materialName = Base::Tools::escapedUnicodeToUtf8(what[1].first);
+            materialName = Base::Tools::escapedUnicodeToUtf8(name.name);
             countMaterialFacets = 0;
+            break;
         }
-        else if (boost::regex_match(line.c_str(), what, rx_f3)) {
-            // starts a new segment
-            if (new_segment) {
-                if (!groupName.empty()) {
-                    _groupNames.push_back(groupName);
-                    groupName.clear();
-                }
-                new_segment = false;
-                segment++;
-            }
+    };
+
+    // the chunks are parsed in parallel and merged in the order of the file
+    ChunkedReader reader(str);
+    reader.Read<ChunkOBJ>(parseChunk, [&](ChunkOBJ& chunk) {
+        std::size_t offset = meshPoints.size();
+        meshPoints.insert(meshPoints.end(), chunk.points.begin(), chunk.points.end());
+        if (chunk.hasColors)
+            rgb_value = MeshIO::PER_VERTEX;
+
+        auto name = chunk.names.begin();
+        for (std::size_t i = 0; i < chunk.faces.size(); i++) {
+            for (; name != chunk.names.end() && name->faces == i; ++name)
+                setName(*name);
 
-            // 3-vertex face
-            i1 = std::atoi(what[1].first);
-            i1 = i1 > 0 ? i1-1 : i1+static_cast<int>(meshPoints.size());
-            i2 = std::atoi(what[2].first);
-            i2 = i2 > 0 ? i2-1 : i2+static_cast<int>(meshPoints.size());
-            i3 = std::atoi(what[3].first);
-            i3 = i3 > 0 ? i3-1 : i3+static_cast<int>(meshPoints.size());
-            item.SetVertices(i1,i2,i3);
-            item.SetProperty(segment);
-            meshFacets.push_back(item);
-            countMaterialFacets++;
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_f4)) {
             // starts a new segment
             if (new_segment) {
                 if (!groupName.empty()) {
@@ -176,27 +246,41 @@ bool ReaderOBJ::Load(std::istream &str)
                 segment++;
             }
 
-            // 4-vertex face
-            i1 = std::atoi(what[1].first);
-            i1 = i1 > 0 ? i1-1 : i1+static_cast<int>(meshPoints.size());
-            i2 = std::atoi(what[2].first);
-            i2 = i2 > 0 ? i2-1 : i2+static_cast<int>(meshPoints.size());
-            i3 = std::atoi(what[3].first);
-            i3 = i3 > 0 ? i3-1 : i3+static_cast<int>(meshPoints.size());
-            i4 = std::atoi(what[4].first);
-            i4 = i4 > 0 ? i4-1 : i4+static_cast<int>(meshPoints.size());
-
-            item.SetVertices(i1,i2,i3);
-            item.SetProperty(segment);
-            meshFacets.push_back(item);
-            countMaterialFacets++;
-
-            item.SetVertices(i3,i4,i1);
-            item.SetProperty(segment);
-            meshFacets.push_back(item);
-            countMaterialFacets++;
+            const ChunkOBJ::Face& face = chunk.faces[i];
+            int numPoints = static_cast<int>(offset + face.vertexes);
+            auto index = [numPoints](int idx) {
+                return idx > 0 ? idx-1 : idx+numPoints;
+            };
+
+            i1 = index(face.index[0]);
+            i2 = index(face.index[1]);
+            i3 = index(face.index[2]);
+            if (face.count == 3) {
+                // 3-vertex face
+                item.SetVertices(i1,i2,i3);
+                item.SetProperty(segment);
+                meshFacets.push_back(item);
+                countMaterialFacets++;
+            }
+            else {
+                // 4-vertex face
+                i4 = index(face.index[3]);
+
+                item.SetVertices(i1,i2,i3);
+                item.SetProperty(segment);
+                meshFacets.push_back(item);
+                countMaterialFacets++;
+
+                item.SetVertices(i3,i4,i1);
+                item.SetProperty(segment);
+                meshFacets.push_back(item);
+                countMaterialFacets++;
+            }
         }
-    }
+
+        for (; name != chunk.names.end(); ++name)
+            setName(*name);
+    });
 
     // Add the last added material name
     if (!materialName.empty()) {
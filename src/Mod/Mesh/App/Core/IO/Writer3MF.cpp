@@ -30,6 +30,7 @@
 #include "Core/Evaluation.h"
 #include "Core/MeshKernel.h"
 
+#include "ChunkedWriter.h"
 #include "Writer3MF.h"
 
 
@@ -54,6 +55,11 @@ void Writer3MF::SetForceModel(bool model)
     forceModel = model;
 }
 
+void Writer3MF::SetThreads(int num)
+{
+    threads = num;
+}
+
 void Writer3MF::Initialize(std::ostream &str)
 {
     str << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
@@ -118,31 +124,44 @@ bool Writer3MF::SaveObject(std::ostream &str, int id, const MeshKernel& mesh) co
     str << Base::blanks(2) << "<object id=\"" << id << "\" type=\"" << GetType(mesh) << "\">\n";
     str << Base::blanks(3) << "<mesh>\n";
 
+    ChunkedWriter writer(str, threads);
+
     // vertices
     str << Base::blanks(4) << "<vertices>\n";
-    std::size_t index = 0;
-    for (MeshPointArray::_TConstIterator it = rPoints.begin(); it != rPoints.end(); ++it, ++index) {
-        str << Base::blanks(5) << "<vertex x=\"" << it->x
-                                    << "\" y=\"" << it->y
-                                    << "\" z=\"" << it->z
-                                    << "\" />\n";
-    }
+    bool ok = writer.Write(rPoints.size(), [&rPoints](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            const MeshPoint& it = rPoints[index];
+            buf += "     <vertex x=\"";
+            ChunkedWriter::AppendGeneral(buf, it.x);
+            buf += "\" y=\"";
+            ChunkedWriter::AppendGeneral(buf, it.y);
+            buf += "\" z=\"";
+            ChunkedWriter::AppendGeneral(buf, it.z);
+            buf += "\" />\n";
+        }
+    });
     str << Base::blanks(4) << "</vertices>\n";
 
     // facet indices
     str << Base::blanks(4) << "<triangles>\n";
-    for (MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
-        str << Base::blanks(5) << "<triangle v1=\"" << it->_aulPoints[0]
-                                      << "\" v2=\"" << it->_aulPoints[1]
-                                      << "\" v3=\"" << it->_aulPoints[2]
-                                      << "\" />\n";
-    }
+    ok = ok && writer.Write(rFacets.size(), [&rFacets](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            const MeshFacet& it = rFacets[index];
+            buf += "     <triangle v1=\"";
+            ChunkedWriter::AppendInt(buf, it._aulPoints[0]);
+            buf += "\" v2=\"";
+            ChunkedWriter::AppendInt(buf, it._aulPoints[1]);
+            buf += "\" v3=\"";
+            ChunkedWriter::AppendInt(buf, it._aulPoints[2]);
+            buf += "\" />\n";
+        }
+    });
     str << Base::blanks(4) << "</triangles>\n";
 
     str << Base::blanks(3) << "</mesh>\n";
     str << Base::blanks(2) << "</object>\n";
 
-    return true;
+    return ok && str.good();
 }
 
 std::string Writer3MF::GetType(const MeshKernel& mesh) const
@@ -68,6 +68,11 @@ public:
      * \param model
      */
     void SetForceModel(bool model);
+    /*!
+     * \brief SetThreads
+     * Sets the number of threads to encode the mesh data. A value of 0 or less uses all cores.
+     */
+    void SetThreads(int num);
     /*!
      * \brief Add a mesh object resource to the 3MF file.
      * \param mesh The mesh object to be written
@@ -103,6 +108,7 @@ private:
     std::vector<std::string> items;
     std::vector<Resource3MF> resources;
     bool forceModel = true;
+    int threads = 0;
 };
 
 } // namespace MeshCore
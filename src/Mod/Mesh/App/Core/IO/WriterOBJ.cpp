@@ -27,6 +27,7 @@
 #include <Base/Tools.h>
 #include "Core/Iterator.h"
 
+#include "ChunkedWriter.h"
 #include "WriterOBJ.h"
 
 
@@ -51,6 +52,7 @@ WriterOBJ::WriterOBJ(const MeshKernel& kernel, const Material* material)
   : _kernel(kernel)
   , _material(material)
   , apply_transform(false)
+  , _threads(0)
 {
 }
 
@@ -66,6 +68,11 @@ void WriterOBJ::SetTransform(const Base::Matrix4D& mat)
         apply_transform = true;
 }
 
+void WriterOBJ::SetThreads(int threads)
+{
+    _threads = threads;
+}
+
 bool WriterOBJ::Save(std::ostream& out)
 {
     const MeshPointArray& rPoints = _kernel.GetPoints();
@@ -74,7 +81,18 @@ bool WriterOBJ::Save(std::ostream& out)
     if (!out || out.bad())
         return false;
 
-    Base::SequencerLauncher seq("saving...", _kernel.CountPoints() + _kernel.CountFacets());
+    ChunkedWriter writer(out, _threads);
+    // every group is written in chunks of its own
+    std::size_t faceChunks = 0;
+    if (_groups.empty()) {
+        faceChunks = writer.CountChunks(_kernel.CountFacets());
+    }
+    for (const auto& group : _groups) {
+        faceChunks += writer.CountChunks(group.indices.size());
+    }
+    Base::SequencerLauncher seq("saving...", writer.CountChunks(_kernel.CountPoints()) +
+                                             writer.CountChunks(_kernel.CountFacets()) +
+                                             faceChunks);
     bool exportColorPerVertex = false;
     bool exportColorPerFace = false;
 
@@ -111,142 +129,116 @@ bool WriterOBJ::Save(std::ostream& out)
         out << "mtllib " << _material->library << '\n';
     }
 
-    out.precision(6);
-    out.setf(std::ios::fixed | std::ios::showpoint);
+    auto vector = [](std::string& buf, const char* prefix, const Base::Vector3f& pt) {
+        buf += prefix;
+        ChunkedWriter::AppendFixed(buf, pt.x);
+        buf += ' ';
+        ChunkedWriter::AppendFixed(buf, pt.y);
+        buf += ' ';
+        ChunkedWriter::AppendFixed(buf, pt.z);
+    };
 
     // vertices
-    Base::Vector3f pt;
-    std::size_t index = 0;
-    for (MeshPointArray::_TConstIterator it = rPoints.begin(); it != rPoints.end(); ++it, ++index) {
-        if (this->apply_transform) {
-            pt = this->_transform * *it;
-        }
-        else {
-            pt.Set(it->x, it->y, it->z);
-        }
-
-        if (exportColorPerVertex) {
-            App::Color c;
-            if (_material->binding == MeshIO::PER_VERTEX) {
-                c = _material->diffuseColor[index];
+    bool ok = writer.Write(rPoints.size(), [&](std::string& buf, std::size_t begin, std::size_t end) {
+        Base::Vector3f pt;
+        for (std::size_t index = begin; index < end; index++) {
+            const MeshPoint& it = rPoints[index];
+            if (this->apply_transform) {
+                pt = this->_transform * it;
             }
             else {
-                c = _material->diffuseColor.front();
+                pt.Set(it.x, it.y, it.z);
             }
 
-            int r = static_cast<int>(c.r * 255.0f);
-            int g = static_cast<int>(c.g * 255.0f);
-            int b = static_cast<int>(c.b * 255.0f);
+            vector(buf, "v ", pt);
+            if (exportColorPerVertex) {
+                App::Color c;
+                if (_material->binding == MeshIO::PER_VERTEX) {
+                    c = _material->diffuseColor[index];
+                }
+                else {
+                    c = _material->diffuseColor.front();
+                }
 
-            out << "v " << pt.x << " " << pt.y << " " << pt.z << " " << r << " " << g << " " << b << '\n';
-        }
-        else {
-            out << "v " << pt.x << " " << pt.y << " " << pt.z << '\n';
+                int r = static_cast<int>(c.r * 255.0f);
+                int g = static_cast<int>(c.g * 255.0f);
+                int b = static_cast<int>(c.b * 255.0f);
+
+                for (int v : {r, g, b}) {
+                    buf += ' ';
+                    ChunkedWriter::AppendInt(buf, v);
+                }
+            }
+            buf += '\n';
         }
-        seq.next(true); // allow to cancel
-    }
+    }, &seq);
+
     // Export normals
-    MeshFacetIterator clIter(_kernel), clEnd(_kernel);
-    const MeshGeomFacet* pclFacet;
-
-    clIter.Begin();
-    clEnd.End();
-
-    while (clIter < clEnd) {
-        pclFacet = &(*clIter);
-        out << "vn " << pclFacet->GetNormal().x << " "
-            << pclFacet->GetNormal().y << " "
-            << pclFacet->GetNormal().z << '\n';
-        ++clIter;
-        seq.next(true); // allow to cancel
+    MeshFacetIterator clIter(_kernel);
+    ok = ok && writer.WriteFacets(clIter, rFacets.size(),
+                                  [&vector](std::string& buf, const MeshGeomFacet& facet, std::size_t) {
+        vector(buf, "vn ", facet.GetNormal());
+        buf += '\n';
+    }, &seq);
+
+    // make sure to use the 'usemtl' statement as less often as possible
+    std::vector<App::Color> colors;
+    if (exportColorPerFace) {
+        colors = _material->diffuseColor;
+        std::sort(colors.begin(), colors.end(), Color_Less());
+        colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
     }
 
-    if (_groups.empty()) {
+    // Writes the facet with index 'facet' and switches the material if its color differs
+    // from the facet 'prev' written before (or if there is none)
+    auto face = [&](std::string& buf, FacetIndex facet, FacetIndex prev, std::size_t faceIdx) {
         if (exportColorPerFace) {
-            // facet indices (no texture and normal indices)
-
-            // make sure to use the 'usemtl' statement as less often as possible
-            std::vector<App::Color> colors = _material->diffuseColor;
-            std::sort(colors.begin(), colors.end(), Color_Less());
-            colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
-
-            std::size_t index = 0;
-            App::Color prev;
-            int faceIdx = 1;
             const std::vector<App::Color>& Kd = _material->diffuseColor;
-            for (MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it, index++) {
-                if (index == 0 || prev != Kd[index]) {
-                    prev = Kd[index];
-                    std::vector<App::Color>::iterator c_it = std::find(colors.begin(), colors.end(), prev);
-                    if (c_it != colors.end()) {
-                        out << "usemtl material_" << (c_it - colors.begin()) << '\n';
-                    }
+            if (prev == FACET_INDEX_MAX || Kd[prev] != Kd[facet]) {
+                std::vector<App::Color>::iterator c_it = std::find(colors.begin(), colors.end(), Kd[facet]);
+                if (c_it != colors.end()) {
+                    buf += "usemtl material_";
+                    ChunkedWriter::AppendInt(buf, c_it - colors.begin());
+                    buf += '\n';
                 }
-                out << "f " << it->_aulPoints[0]+1 << "//" << faceIdx << " "
-                            << it->_aulPoints[1]+1 << "//" << faceIdx << " "
-                            << it->_aulPoints[2]+1 << "//" << faceIdx << '\n';
-                seq.next(true); // allow to cancel
-                faceIdx++;
             }
         }
-        else {
-            // facet indices (no texture and normal indices)
-            std::size_t faceIdx = 1;
-            for (MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
-                out << "f " << it->_aulPoints[0]+1 << "//" << faceIdx << " "
-                            << it->_aulPoints[1]+1 << "//" << faceIdx << " "
-                            << it->_aulPoints[2]+1 << "//" << faceIdx << '\n';
-                seq.next(true); // allow to cancel
-                faceIdx++;
-            }
-        }
-    }
-    else {
-        if (exportColorPerFace) {
-            // make sure to use the 'usemtl' statement as less often as possible
-            std::vector<App::Color> colors = _material->diffuseColor;
-            std::sort(colors.begin(), colors.end(), Color_Less());
-            colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
 
-            bool first = true;
-            App::Color prev;
-            const std::vector<App::Color>& Kd = _material->diffuseColor;
+        const MeshFacet& f = rFacets[facet];
+        buf += "f";
+        for (int i = 0; i < 3; i++) {
+            buf += ' ';
+            ChunkedWriter::AppendInt(buf, f._aulPoints[i] + 1);
+            buf += "//";
+            ChunkedWriter::AppendInt(buf, faceIdx);
+        }
+        buf += '\n';
+    };
 
-            for (std::vector<Group>::const_iterator gt = _groups.begin(); gt != _groups.end(); ++gt) {
-                out << "g " << Base::Tools::escapedUnicodeFromUtf8(gt->name.c_str()) << '\n';
-                for (std::vector<FacetIndex>::const_iterator it = gt->indices.begin(); it != gt->indices.end(); ++it) {
-                    const MeshFacet& f = rFacets[*it];
-                    if (first || prev != Kd[*it]) {
-                        first = false;
-                        prev = Kd[*it];
-                        std::vector<App::Color>::iterator c_it = std::find(colors.begin(), colors.end(), prev);
-                        if (c_it != colors.end()) {
-                            out << "usemtl material_" << (c_it - colors.begin()) << '\n';
-                        }
-                    }
-
-                    out << "f " << f._aulPoints[0]+1 << "//" << *it + 1 << " "
-                                << f._aulPoints[1]+1 << "//" << *it + 1 << " "
-                                << f._aulPoints[2]+1 << "//" << *it + 1 << '\n';
-                    seq.next(true); // allow to cancel
-                }
+    if (_groups.empty()) {
+        // facet indices (no texture and normal indices)
+        ok = ok && writer.Write(rFacets.size(), [&face](std::string& buf, std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                face(buf, index, index > 0 ? index - 1 : FACET_INDEX_MAX, index + 1);
             }
-        }
-        else {
-            for (std::vector<Group>::const_iterator gt = _groups.begin(); gt != _groups.end(); ++gt) {
-                out << "g " << Base::Tools::escapedUnicodeFromUtf8(gt->name.c_str()) << '\n';
-                for (std::vector<FacetIndex>::const_iterator it = gt->indices.begin(); it != gt->indices.end(); ++it) {
-                    const MeshFacet& f = rFacets[*it];
-                    out << "f " << f._aulPoints[0]+1 << "//" << *it + 1 << " "
-                                << f._aulPoints[1]+1 << "//" << *it + 1 << " "
-                                << f._aulPoints[2]+1 << "//" << *it + 1 << '\n';
-                    seq.next(true); // allow to cancel
+        }, &seq);
+    }
+    else {
+        FacetIndex last = FACET_INDEX_MAX;
+        for (std::vector<Group>::const_iterator gt = _groups.begin(); gt != _groups.end(); ++gt) {
+            out << "g " << Base::Tools::escapedUnicodeFromUtf8(gt->name.c_str()) << '\n';
+            const std::vector<FacetIndex>& indices = gt->indices;
+            ok = ok && writer.Write(indices.size(), [&](std::string& buf, std::size_t begin, std::size_t end) {
+                for (std::size_t index = begin; index < end; index++) {
+                    face(buf, indices[index], index > 0 ? indices[index - 1] : last, indices[index] + 1);
                 }
-            }
+            }, &seq);
+            if (!indices.empty())
+                last = indices.back();
         }
     }
 
-    return true;
+    return ok;
 }
 
 bool WriterOBJ::SaveMaterial(std::ostream& out)
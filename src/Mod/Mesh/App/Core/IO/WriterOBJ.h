@@ -49,6 +49,11 @@ public:
      * \brief Apply a transformation for the exported mesh.
      */
     void SetTransform(const Base::Matrix4D&);
+    /*!
+     * \brief Set the number of threads to encode the data.
+     * A value of 0 or less uses all cores.
+     */
+    void SetThreads(int);
     /*!
      * \brief Save the mesh to an OBJ file.
      * \return true if the data could be written successfully, false otherwise.
@@ -67,6 +72,7 @@ private:
     const Material* _material;
     Base::Matrix4D _transform;
     bool apply_transform;
+    int _threads;
     std::vector<Group> _groups;
 };
 
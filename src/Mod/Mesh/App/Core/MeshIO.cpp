@@ -46,6 +46,8 @@
 #include <Base/Stream.h>
 #include <Base/Tools.h>
 #include <Base/Writer.h>
+#include "IO/ChunkedReader.h"
+#include "IO/ChunkedWriter.h"
 #include "IO/Reader3MF.h"
 #include "IO/ReaderOBJ.h"
 #include "IO/Writer3MF.h"
@@ -1118,74 +1120,47 @@ bool MeshInput::LoadMeshNode (std::istream &rstrIn)
 /** Loads an ASCII STL file. */
 bool MeshInput::LoadAsciiSTL (std::istream &rstrIn)
 {
-    boost::regex rx_p("^\\s*VERTEX\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::regex rx_f("^\\s*FACET\\s+NORMAL\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::cmatch what;
-
-    std::string line;
-    float fX, fY, fZ;
-    unsigned long ulVertexCt, ulFacetCt=0;
-    MeshGeomFacet clFacet;
-
     if (!rstrIn || rstrIn.bad())
         return false;
 
-    std::streamoff ulSize = 0;
     std::streambuf* buf = rstrIn.rdbuf();
-    ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-    buf->pubseekoff(0, std::ios::beg, std::ios::in);
-    ulSize -= 20;
-
-    // count facets
-    while (std::getline(rstrIn, line)) {
-        boost::algorithm::to_upper(line);
-        if (line.find("ENDFACET") != std::string::npos)
-            ulFacetCt++;
-        // prevent from reading EOF (as I don't know how to reread the file then)
-        if (rstrIn.tellg() > ulSize)
-            break;
-        else if (line.find("ENDSOLID") != std::string::npos)
-            break;
-    }
-
-    // restart from the beginning
+    if (!buf)
+        return false;
     buf->pubseekoff(0, std::ios::beg, std::ios::in);
 
-#if 0
-    MeshBuilder builder(this->_rclMesh);
-#else
+    // Only the vertices are of interest because the builder doesn't use the normals.
+    // Each three consecutive vertices define a facet even if they span several chunks.
     MeshFastBuilder builder(this->_rclMesh);
-#endif
-    builder.Initialize(ulFacetCt);
-
-    ulVertexCt = 0;
-    while (std::getline(rstrIn, line)) {
-        boost::algorithm::to_upper(line);
-        if (boost::regex_match(line.c_str(), what, rx_f)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            clFacet.SetNormal(Base::Vector3f(fX, fY, fZ));
+    MeshGeomFacet clFacet;
+    int ulVertexCt = 0;
+
+    ChunkedReader reader(rstrIn);
+    bool ok = reader.Read<std::vector<Base::Vector3f>>(
+        [](std::vector<Base::Vector3f>& vertexes, const char* begin, const char* end) {
+        for (const char* ptr = begin; ptr != end; ptr = ChunkedReader::NextLine(ptr, end)) {
+            const char* pos = ptr;
+            Base::Vector3f pnt;
+            if (ChunkedReader::ReadKeyword(pos, end, "vertex", true) &&
+                ChunkedReader::ReadNumber(pos, end, pnt.x) &&
+                ChunkedReader::ReadNumber(pos, end, pnt.y) &&
+                ChunkedReader::ReadNumber(pos, end, pnt.z) &&
+                ChunkedReader::IsLineEnd(ChunkedReader::SkipBlanks(pos, end), end)) {
+                vertexes.push_back(pnt);
+            }
         }
-        else if (boost::regex_match(line.c_str(), what, rx_p)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            clFacet._aclPoints[ulVertexCt++].Set(fX, fY, fZ);
+    }, [&](const std::vector<Base::Vector3f>& vertexes) {
+        for (const auto& pnt : vertexes) {
+            clFacet._aclPoints[ulVertexCt++] = pnt;
             if (ulVertexCt == 3) {
                 ulVertexCt = 0;
                 builder.AddFacet(clFacet);
             }
         }
-    }
+    });
 
     builder.Finish();
 
-    return true;
+    return ok;
 }
 
 /** Loads a binary STL file. */
@@ -1930,100 +1905,90 @@ bool MeshOutput::SaveFormat(std::ostream &str, MeshIO::Format fmt) const
 /** Saves the mesh object into an ASCII file. */
 bool MeshOutput::SaveAsciiSTL (std::ostream &rstrOut) const
 {
-    MeshFacetIterator clIter(_rclMesh), clEnd(_rclMesh);
+    MeshFacetIterator clIter(_rclMesh);
     clIter.Transform(this->_transform);
-    const MeshGeomFacet *pclFacet;
 
     if (!rstrOut || rstrOut.bad() || _rclMesh.CountFacets() == 0)
         return false;
 
-    rstrOut.precision(6);
-    rstrOut.setf(std::ios::fixed | std::ios::showpoint);
-    Base::SequencerLauncher seq("saving...", _rclMesh.CountFacets() + 1);
+    ChunkedWriter writer(rstrOut, _threads);
+    Base::SequencerLauncher seq("saving...", writer.CountChunks(_rclMesh.CountFacets()) + 1);
 
     if (this->objectName.empty())
         rstrOut << "solid Mesh\n";
     else
         rstrOut << "solid " << this->objectName << '\n';
 
-    clIter.Begin();
-    clEnd.End();
-    while (clIter < clEnd) {
-        pclFacet = &(*clIter);
+    auto vector = [](std::string& buf, const Base::Vector3f& v) {
+        ChunkedWriter::AppendFixed(buf, v.x);
+        buf += ' ';
+        ChunkedWriter::AppendFixed(buf, v.y);
+        buf += ' ';
+        ChunkedWriter::AppendFixed(buf, v.z);
+        buf += '\n';
+    };
 
+    bool ok = writer.WriteFacets(clIter, _rclMesh.CountFacets(),
+                                 [&vector](std::string& buf, const MeshGeomFacet& facet, std::size_t) {
         // normal
-        rstrOut << "  facet normal " << pclFacet->GetNormal().x << " "
-                                     << pclFacet->GetNormal().y << " "
-                                     << pclFacet->GetNormal().z << '\n';
-        rstrOut << "    outer loop\n";
+        buf += "  facet normal ";
+        vector(buf, facet.GetNormal());
+        buf += "    outer loop\n";
 
         // vertices
         for (int i = 0; i < 3; i++) {
-            rstrOut << "      vertex "  << pclFacet->_aclPoints[i].x << " "
-                                        << pclFacet->_aclPoints[i].y << " "
-                                        << pclFacet->_aclPoints[i].z << '\n';
+            buf += "      vertex ";
+            vector(buf, facet._aclPoints[i]);
         }
 
-        rstrOut << "    endloop\n";
-        rstrOut << "  endfacet\n";
-
-        ++clIter;
-        seq.next(true);// allow to cancel
-    }
+        buf += "    endloop\n";
+        buf += "  endfacet\n";
+    }, &seq);
 
     rstrOut << "endsolid Mesh\n";
 
-    return true;
+    return ok;
 }
 
 /** Saves the mesh object into a binary file. */
 bool MeshOutput::SaveBinarySTL (std::ostream &rstrOut) const
 {
-    MeshFacetIterator clIter(_rclMesh), clEnd(_rclMesh);
+    MeshFacetIterator clIter(_rclMesh);
     clIter.Transform(this->_transform);
-    const MeshGeomFacet *pclFacet;
-    uint32_t i;
-    uint16_t usAtt;
     char szInfo[81];
 
     if (!rstrOut || rstrOut.bad() /*|| _rclMesh.CountFacets() == 0*/)
         return false;
 
-    Base::SequencerLauncher seq("saving...", _rclMesh.CountFacets() + 1);
+    ChunkedWriter writer(rstrOut, _threads);
+    Base::SequencerLauncher seq("saving...", writer.CountChunks(_rclMesh.CountFacets()) + 1);
 
     // stl_header has a length of 80
     strcpy(szInfo, stl_header.c_str());
     rstrOut.write(szInfo, std::strlen(szInfo));
 
-    uint32_t uCtFts = (uint32_t)_rclMesh.CountFacets();
-    rstrOut.write((const char*)&uCtFts, sizeof(uCtFts));
+    std::string count;
+    ChunkedWriter::AppendBinary(count, static_cast<uint32_t>(_rclMesh.CountFacets()));
+    rstrOut.write(count.data(), count.size());
 
-    usAtt = 0;
-    clIter.Begin();
-    clEnd.End();
-    while (clIter < clEnd) {
-        pclFacet = &(*clIter);
+    return writer.WriteFacets(clIter, _rclMesh.CountFacets(),
+                              [](std::string& buf, const MeshGeomFacet& facet, std::size_t) {
         // normal
-        Base::Vector3f normal = pclFacet->GetNormal();
-        rstrOut.write((const char*)&(normal.x), sizeof(float));
-        rstrOut.write((const char*)&(normal.y), sizeof(float));
-        rstrOut.write((const char*)&(normal.z), sizeof(float));
+        Base::Vector3f normal = facet.GetNormal();
+        ChunkedWriter::AppendBinary(buf, normal.x);
+        ChunkedWriter::AppendBinary(buf, normal.y);
+        ChunkedWriter::AppendBinary(buf, normal.z);
 
         // vertices
-        for (i = 0; i < 3; i++) {
-            rstrOut.write((const char*)&(pclFacet->_aclPoints[i].x), sizeof(float));
-            rstrOut.write((const char*)&(pclFacet->_aclPoints[i].y), sizeof(float));
-            rstrOut.write((const char*)&(pclFacet->_aclPoints[i].z), sizeof(float));
+        for (int i = 0; i < 3; i++) {
+            ChunkedWriter::AppendBinary(buf, facet._aclPoints[i].x);
+            ChunkedWriter::AppendBinary(buf, facet._aclPoints[i].y);
+            ChunkedWriter::AppendBinary(buf, facet._aclPoints[i].z);
         }
 
         // attribute
-        rstrOut.write((const char*)&usAtt, sizeof(usAtt));
-
-        ++clIter;
-        seq.next(true); // allow to cancel
-    }
-
-    return true;
+        ChunkedWriter::AppendBinary(buf, uint16_t(0));
+    }, &seq);
 }
 
 /** Saves an OBJ file. */
@@ -2032,6 +1997,7 @@ bool MeshOutput::SaveOBJ (std::ostream &out) const
     WriterOBJ writer(this->_rclMesh, this->_material);
     writer.SetTransform(this->_transform);
     writer.SetGroups(this->_groups);
+    writer.SetThreads(this->_threads);
     return writer.Save(out);
 }
 
@@ -2040,6 +2006,7 @@ bool MeshOutput::SaveOBJ (std::ostream &out, const char* filename) const
     WriterOBJ writer(this->_rclMesh, this->_material);
     writer.SetTransform(this->_transform);
     writer.SetGroups(this->_groups);
+    writer.SetThreads(this->_threads);
     if (writer.Save(out)) {
         if (this->_material && this->_material->binding == MeshCore::MeshIO::PER_FACE) {
             Base::FileInfo fi(filename);
@@ -2218,7 +2185,9 @@ bool MeshOutput::SaveOFF (std::ostream &out) const
     if (!out || out.bad())
         return false;
 
-    Base::SequencerLauncher seq("saving...", _rclMesh.CountPoints() + _rclMesh.CountFacets());
+    ChunkedWriter writer(out, _threads);
+    Base::SequencerLauncher seq("saving...", writer.CountChunks(_rclMesh.CountPoints()) +
+                                             writer.CountChunks(_rclMesh.CountFacets()));
 
     bool exportColor = false;
     if (_material) {
@@ -2250,47 +2219,61 @@ bool MeshOutput::SaveOFF (std::ostream &out) const
     out << rPoints.size() << " " << rFacets.size() << " 0\n";
 
     // vertices
-    Base::Vector3f pt;
-    std::size_t index = 0;
-    for (MeshPointArray::_TConstIterator it = rPoints.begin(); it != rPoints.end(); ++it, ++index) {
-        if (this->apply_transform) {
-            pt = this->_transform * *it;
-        }
-        else {
-            pt.Set(it->x, it->y, it->z);
-        }
-
-        if (exportColor) {
-            App::Color c;
-            if (_material->binding == MeshIO::PER_VERTEX) {
-                c = _material->diffuseColor[index];
+    bool ok = writer.Write(rPoints.size(), [&](std::string& buf, std::size_t begin, std::size_t end) {
+        Base::Vector3f pt;
+        for (std::size_t index = begin; index < end; index++) {
+            const MeshPoint& it = rPoints[index];
+            if (this->apply_transform) {
+                pt = this->_transform * it;
             }
             else {
-                c = _material->diffuseColor.front();
+                pt.Set(it.x, it.y, it.z);
             }
 
-            int r = static_cast<int>(c.r * 255.0f);
-            int g = static_cast<int>(c.g * 255.0f);
-            int b = static_cast<int>(c.b * 255.0f);
-            int a = static_cast<int>(c.a * 255.0f);
+            ChunkedWriter::AppendGeneral(buf, pt.x);
+            buf += ' ';
+            ChunkedWriter::AppendGeneral(buf, pt.y);
+            buf += ' ';
+            ChunkedWriter::AppendGeneral(buf, pt.z);
 
-            out << pt.x << " " << pt.y << " " << pt.z << " " << r << " " << g << " " << b << " " << a << '\n';
-        }
-        else {
-            out << pt.x << " " << pt.y << " " << pt.z << '\n';
+            if (exportColor) {
+                App::Color c;
+                if (_material->binding == MeshIO::PER_VERTEX) {
+                    c = _material->diffuseColor[index];
+                }
+                else {
+                    c = _material->diffuseColor.front();
+                }
+
+                int r = static_cast<int>(c.r * 255.0f);
+                int g = static_cast<int>(c.g * 255.0f);
+                int b = static_cast<int>(c.b * 255.0f);
+                int a = static_cast<int>(c.a * 255.0f);
+
+                for (int v : {r, g, b, a}) {
+                    buf += ' ';
+                    ChunkedWriter::AppendInt(buf, v);
+                }
+            }
+            buf += '\n';
         }
-        seq.next(true); // allow to cancel
-    }
+    }, &seq);
 
     // facet indices (no texture and normal indices)
-    for (MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
-        out << "3 " << it->_aulPoints[0]
-            << " " << it->_aulPoints[1]
-            << " " << it->_aulPoints[2] << '\n';
-        seq.next(true); // allow to cancel
-    }
-
-    return true;
+    ok = ok && writer.Write(rFacets.size(), [&rFacets](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            const MeshFacet& it = rFacets[index];
+            buf += "3 ";
+            ChunkedWriter::AppendInt(buf, it._aulPoints[0]);
+            buf += ' ';
+            ChunkedWriter::AppendInt(buf, it._aulPoints[1]);
+            buf += ' ';
+            ChunkedWriter::AppendInt(buf, it._aulPoints[2]);
+            buf += '\n';
+        }
+    }, &seq);
+
+    return ok;
 }
 
 bool MeshOutput::SaveBinaryPLY (std::ostream &out) const
@@ -2319,38 +2302,36 @@ bool MeshOutput::SaveBinaryPLY (std::ostream &out) const
         << "property list uchar int vertex_index\n"
         << "end_header\n";
 
-    Base::OutputStream os(out);
-    os.setByteOrder(Base::Stream::LittleEndian);
-
-    for (std::size_t i = 0; i < v_count; i++) {
-        const MeshPoint& p = rPoints[i];
-        if (this->apply_transform) {
-            Base::Vector3f pt = this->_transform * p;
-            os << pt.x << pt.y << pt.z;
-        }
-        else {
-            os << p.x << p.y << p.z;
+    ChunkedWriter writer(out, _threads);
+    bool ok = writer.Write(v_count, [&](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Base::Vector3f pt = rPoints[i];
+            if (this->apply_transform) {
+                pt = this->_transform * pt;
+            }
+            ChunkedWriter::AppendBinary(buf, pt.x);
+            ChunkedWriter::AppendBinary(buf, pt.y);
+            ChunkedWriter::AppendBinary(buf, pt.z);
+            if (saveVertexColor) {
+                const App::Color& c = _material->diffuseColor[i];
+                ChunkedWriter::AppendBinary(buf, uint8_t(255.0f * c.r));
+                ChunkedWriter::AppendBinary(buf, uint8_t(255.0f * c.g));
+                ChunkedWriter::AppendBinary(buf, uint8_t(255.0f * c.b));
+            }
         }
-        if (saveVertexColor) {
-            const App::Color& c = _material->diffuseColor[i];
-            uint8_t r = uint8_t(255.0f * c.r);
-            uint8_t g = uint8_t(255.0f * c.g);
-            uint8_t b = uint8_t(255.0f * c.b);
-            os << r << g << b;
+    });
+
+    ok = ok && writer.Write(f_count, [&rFacets](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const MeshFacet& f = rFacets[i];
+            ChunkedWriter::AppendBinary(buf, uint8_t(3));
+            ChunkedWriter::AppendBinary(buf, int32_t(f._aulPoints[0]));
+            ChunkedWriter::AppendBinary(buf, int32_t(f._aulPoints[1]));
+            ChunkedWriter::AppendBinary(buf, int32_t(f._aulPoints[2]));
         }
-    }
-    unsigned char n = 3;
-    int f1, f2, f3;
-    for (std::size_t i = 0; i < f_count; i++) {
-        const MeshFacet& f = rFacets[i];
-        f1 = (int)f._aulPoints[0];
-        f2 = (int)f._aulPoints[1];
-        f3 = (int)f._aulPoints[2];
-        os << n;
-        os << f1 << f2 << f3;
-    }
+    });
 
-    return true;
+    return ok;
 }
 
 bool MeshOutput::SaveAsciiPLY (std::ostream &out) const
@@ -2380,50 +2361,46 @@ bool MeshOutput::SaveAsciiPLY (std::ostream &out) const
         << "property list uchar int vertex_index\n"
         << "end_header\n";
 
-    out.precision(6);
-    out.setf(std::ios::fixed | std::ios::showpoint);
-    if (saveVertexColor) {
-        for (std::size_t i = 0; i < v_count; i++) {
-            const MeshPoint& p = rPoints[i];
+    ChunkedWriter writer(out, _threads);
+    bool ok = writer.Write(v_count, [&](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Base::Vector3f pt = rPoints[i];
             if (this->apply_transform) {
-                Base::Vector3f pt = this->_transform * p;
-                out << pt.x << " " << pt.y << " " << pt.z;
-            }
-            else {
-                out << p.x << " " << p.y << " " << p.z;
+                pt = this->_transform * pt;
             }
-
-            const App::Color& c = _material->diffuseColor[i];
-            int r = (int)(255.0f * c.r);
-            int g = (int)(255.0f * c.g);
-            int b = (int)(255.0f * c.b);
-            out << " " << r << " " << g << " " << b << '\n';
-        }
-    }
-    else {
-        for (std::size_t i = 0; i < v_count; i++) {
-            const MeshPoint& p = rPoints[i];
-            if (this->apply_transform) {
-                Base::Vector3f pt = this->_transform * p;
-                out << pt.x << " " << pt.y << " " << pt.z << '\n';
-            }
-            else {
-                out << p.x << " " << p.y << " " << p.z << '\n';
+            ChunkedWriter::AppendFixed(buf, pt.x);
+            buf += ' ';
+            ChunkedWriter::AppendFixed(buf, pt.y);
+            buf += ' ';
+            ChunkedWriter::AppendFixed(buf, pt.z);
+            if (saveVertexColor) {
+                const App::Color& c = _material->diffuseColor[i];
+                int r = (int)(255.0f * c.r);
+                int g = (int)(255.0f * c.g);
+                int b = (int)(255.0f * c.b);
+                for (int v : {r, g, b}) {
+                    buf += ' ';
+                    ChunkedWriter::AppendInt(buf, v);
+                }
             }
+            buf += '\n';
         }
-    }
+    });
 
-    unsigned int n = 3;
-    int f1, f2, f3;
-    for (std::size_t i = 0; i < f_count; i++) {
-        const MeshFacet& f = rFacets[i];
-        f1 = (int)f._aulPoints[0];
-        f2 = (int)f._aulPoints[1];
-        f3 = (int)f._aulPoints[2];
-        out << n << " " << f1 << " " << f2 << " " << f3 << '\n';
-    }
+    ok = ok && writer.Write(f_count, [&rFacets](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const MeshFacet& f = rFacets[i];
+            buf += "3 ";
+            ChunkedWriter::AppendInt(buf, (int)f._aulPoints[0]);
+            buf += ' ';
+            ChunkedWriter::AppendInt(buf, (int)f._aulPoints[1]);
+            buf += ' ';
+            ChunkedWriter::AppendInt(buf, (int)f._aulPoints[2]);
+            buf += '\n';
+        }
+    });
 
-    return true;
+    return ok;
 }
 
 bool MeshOutput::SaveMeshNode (std::ostream &rstrOut)
@@ -2519,6 +2496,7 @@ void MeshOutput::SaveXML (Base::Writer &writer) const
 bool MeshOutput::Save3MF(std::ostream &str) const
 {
     Writer3MF writer(str);
+    writer.SetThreads(_threads);
     writer.AddMesh(_rclMesh, _transform);
     return writer.Save();
 }
@@ -2711,7 +2689,8 @@ bool MeshOutput::SaveX3DContent (std::ostream &out, bool exportViewpoints) const
     bool saveFaceColor   = (_material && _material->binding == MeshIO::PER_FACE &&
                             _material->diffuseColor.size() == fts.size());
 
-    Base::SequencerLauncher seq("Saving...", _rclMesh.CountFacets() + 1);
+    ChunkedWriter writer(out, _threads);
+    Base::SequencerLauncher seq("Saving...", writer.CountChunks(_rclMesh.CountFacets()) + 1);
     out.precision(6);
     out.setf(std::ios::fixed | std::ios::showpoint);
 
@@ -2786,15 +2765,30 @@ bool MeshOutput::SaveX3DContent (std::ostream &out, bool exportViewpoints) const
     }
 
     out << "coordIndex=\"";
-    for (MeshFacetArray::_TConstIterator it = fts.begin(); it != fts.end(); ++it) {
-        out << it->_aulPoints[0] << " " << it->_aulPoints[1] << " " << it->_aulPoints[2] << " -1 ";
-    }
+    bool ok = writer.Write(fts.size(), [&fts](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const MeshFacet& it = fts[i];
+            for (int j = 0; j < 3; j++) {
+                ChunkedWriter::AppendInt(buf, it._aulPoints[j]);
+                buf += ' ';
+            }
+            buf += "-1 ";
+        }
+    }, &seq);
     out << "\">\n";
 
     out << "          <Coordinate point=\"";
-    for (MeshPointArray::_TConstIterator it = pts.begin(); it != pts.end(); ++it) {
-        out << it->x << " " << it->y << " " << it->z << ", ";
-    }
+    ok = ok && writer.Write(pts.size(), [&pts](std::string& buf, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const MeshPoint& it = pts[i];
+            ChunkedWriter::AppendFixed(buf, it.x);
+            buf += ' ';
+            ChunkedWriter::AppendFixed(buf, it.y);
+            buf += ' ';
+            ChunkedWriter::AppendFixed(buf, it.z);
+            buf += ", ";
+        }
+    });
     out << "\"/>\n";
 
     // write colors per vertex or face
@@ -2815,7 +2809,7 @@ bool MeshOutput::SaveX3DContent (std::ostream &out, bool exportViewpoints) const
         << "  </Scene>\n"
         << "</X3D>\n";
 
-    return true;
+    return ok && out.good();
 }
 
 /** Writes an X3DOM file. */
@@ -171,6 +171,11 @@ public:
     void SetGroups(const std::vector<Group>& g) {
         _groups = g;
     }
+    /** Sets the number of threads used to encode the mesh data of the formats
+     * that support it. A value of 0 or less uses all cores.
+     */
+    void SetThreads(int threads)
+    { _threads = threads; }
 
     void Transform(const Base::Matrix4D&);
     /** Set custom data to the header of a binary STL.
@@ -246,6 +251,7 @@ protected:
     bool apply_transform;
     std::string objectName;
     std::vector<Group> _groups;
+    int _threads = 0;
     static std::string stl_header;
     static std::string asyWidth;
     static std::string asyHeight;
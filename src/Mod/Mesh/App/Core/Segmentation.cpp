@@ -28,6 +28,7 @@
 #include "Segmentation.h"
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "Functional.h"
 
 using namespace MeshCore;
 
@@ -44,6 +45,11 @@ void MeshSurfaceSegment::AddFacet(const MeshFacet&)
 {
 }
 
+MeshSurfaceSegmentPtr MeshSurfaceSegment::Clone() const
+{
+    return nullptr;
+}
+
 void MeshSurfaceSegment::AddSegment(const std::vector<FacetIndex>& segm)
 {
     if (segm.size() >= minFacets) {
@@ -64,7 +70,7 @@ MeshSegment MeshSurfaceSegment::FindSegment(FacetIndex index) const
 // --------------------------------------------------------
 
 MeshDistancePlanarSegment::MeshDistancePlanarSegment(const MeshKernel& mesh, unsigned long minFacets, float tol)
-  : MeshDistanceSurfaceSegment(mesh, minFacets, tol), fitter(new PlaneFit)
+  : MeshDistanceSurfaceSegment(mesh, minFacets, tol), fitter(new PlaneMomentFit)
 {
 }
 
@@ -104,10 +110,15 @@ void MeshDistancePlanarSegment::AddFacet(const MeshFacet& face)
     fitter->AddPoint(triangle.GetGravityPoint());
 }
 
+MeshSurfaceSegmentPtr MeshDistancePlanarSegment::Clone() const
+{
+    return std::make_shared<MeshDistancePlanarSegment>(kernel, minFacets, tolerance);
+}
+
 // --------------------------------------------------------
 
 PlaneSurfaceFit::PlaneSurfaceFit()
-    : fitter(new PlaneFit)
+    : fitter(new PlaneMomentFit)
 {
 }
 
@@ -130,10 +141,12 @@ void PlaneSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
         normal = tria.GetNormal();
 
         fitter->Clear();
+        points.clear();
 
-        fitter->AddPoint(tria._aclPoints[0]);
-        fitter->AddPoint(tria._aclPoints[1]);
-        fitter->AddPoint(tria._aclPoints[2]);
+        for (const auto& pnt : tria._aclPoints) {
+            fitter->AddPoint(pnt);
+            points.push_back(pnt);
+        }
         fitter->Fit();
     }
 }
@@ -145,8 +158,11 @@ bool PlaneSurfaceFit::TestTriangle(const MeshGeomFacet&) const
 
 void PlaneSurfaceFit::AddTriangle(const MeshCore::MeshGeomFacet& tria)
 {
-    if (fitter)
-        fitter->AddPoint(tria.GetGravityPoint());
+    if (fitter) {
+        Base::Vector3f pnt = tria.GetGravityPoint();
+        fitter->AddPoint(pnt);
+        points.push_back(pnt);
+    }
 }
 
 bool PlaneSurfaceFit::Done() const
@@ -178,8 +194,18 @@ std::vector<float> PlaneSurfaceFit::Parameters() const
     Base::Vector3f base = basepoint;
     Base::Vector3f norm = normal;
     if (fitter) {
-        base = fitter->GetBase();
-        norm = fitter->GetNormal();
+        // The moment fit is only used while growing the segment. The final
+        // parameters come from a full fit of the collected points.
+        PlaneFit fit;
+        fit.AddPoints(points);
+        if (fit.Fit() < FLOAT_MAX) {
+            base = fit.GetBase();
+            norm = fit.GetNormal();
+        }
+        else {
+            base = fitter->GetBase();
+            norm = fitter->GetNormal();
+        }
     }
 
     std::vector<float> c;
@@ -192,10 +218,18 @@ std::vector<float> PlaneSurfaceFit::Parameters() const
     return c;
 }
 
+AbstractSurfaceFit* PlaneSurfaceFit::Clone() const
+{
+    if (fitter)
+        return new PlaneSurfaceFit();
+    return new PlaneSurfaceFit(basepoint, normal);
+}
+
 // --------------------------------------------------------
 
 CylinderSurfaceFit::CylinderSurfaceFit()
     : fitter(new CylinderFit)
+    , refitPoints(0)
 {
     axis.Set(0,0,0);
     radius = FLOAT_MAX;
@@ -210,6 +244,7 @@ CylinderSurfaceFit::CylinderSurfaceFit(const Base::Vector3f& b, const Base::Vect
     , axis(a)
     , radius(r)
     , fitter(nullptr)
+    , refitPoints(0)
 {
 }
 
@@ -221,6 +256,12 @@ CylinderSurfaceFit::~CylinderSurfaceFit()
 void CylinderSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
+        // do not use the cylinder of the previous segment
+        basepoint.Set(0,0,0);
+        axis.Set(0,0,0);
+        radius = FLOAT_MAX;
+        refitPoints = 0;
+
         fitter->Clear();
         fitter->AddPoint(tria._aclPoints[0]);
         fitter->AddPoint(tria._aclPoints[1]);
@@ -248,7 +289,9 @@ bool CylinderSurfaceFit::TestTriangle(const MeshGeomFacet& tria) const
 bool CylinderSurfaceFit::Done() const
 {
     if (fitter) {
-        return fitter->Done();
+        // The cylinder fit is iterative and thus expensive. Once it has succeeded
+        // it is only repeated after the number of points has grown by a quarter.
+        return fitter->Done() || fitter->CountPoints() < refitPoints;
     }
 
     return true;
@@ -265,12 +308,16 @@ float CylinderSurfaceFit::Fit()
         axis = fitter->GetAxis();
         radius = fitter->GetRadius();
     }
+    if (fitter->Done()) {
+        std::size_t count = fitter->CountPoints();
+        refitPoints = count + count / 4;
+    }
     return fit;
 }
 
 float CylinderSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
 {
-    if (fitter && !fitter->Done()) {
+    if (fitter && refitPoints == 0) {
         // collect some points
         return 0;
     }
@@ -300,10 +347,17 @@ std::vector<float> CylinderSurfaceFit::Parameters() const
     return c;
 }
 
+AbstractSurfaceFit* CylinderSurfaceFit::Clone() const
+{
+    if (fitter)
+        return new CylinderSurfaceFit();
+    return new CylinderSurfaceFit(basepoint, axis, radius);
+}
+
 // --------------------------------------------------------
 
 SphereSurfaceFit::SphereSurfaceFit()
-    : fitter(new SphereFit)
+    : fitter(new SphereMomentFit)
 {
     center.Set(0,0,0);
     radius = FLOAT_MAX;
@@ -325,19 +379,26 @@ SphereSurfaceFit::~SphereSurfaceFit()
 void SphereSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
+        // do not use the sphere of the previous segment
+        center.Set(0,0,0);
+        radius = FLOAT_MAX;
+
         fitter->Clear();
-        fitter->AddPoint(tria._aclPoints[0]);
-        fitter->AddPoint(tria._aclPoints[1]);
-        fitter->AddPoint(tria._aclPoints[2]);
+        points.clear();
+        for (const auto& pnt : tria._aclPoints) {
+            fitter->AddPoint(pnt);
+            points.push_back(pnt);
+        }
     }
 }
 
 void SphereSurfaceFit::AddTriangle(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
-        fitter->AddPoint(tria._aclPoints[0]);
-        fitter->AddPoint(tria._aclPoints[1]);
-        fitter->AddPoint(tria._aclPoints[2]);
+        for (const auto& pnt : tria._aclPoints) {
+            fitter->AddPoint(pnt);
+            points.push_back(pnt);
+        }
     }
 }
 
@@ -371,6 +432,10 @@ float SphereSurfaceFit::Fit()
 
 float SphereSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
 {
+    if (fitter && fitter->CountPoints() < 4) {
+        // collect some points
+        return 0;
+    }
     float dist = Base::Distance(pnt, center);
     return (dist - radius);
 }
@@ -380,8 +445,18 @@ std::vector<float> SphereSurfaceFit::Parameters() const
     Base::Vector3f base = center;
     float radval = radius;
     if (fitter) {
-        base = fitter->GetCenter();
-        radval = fitter->GetRadius();
+        // The algebraic fit is only used while growing the segment. The final
+        // parameters come from the geometric fit of the collected points.
+        SphereFit fit;
+        fit.AddPoints(points);
+        if (fit.Fit() < FLOAT_MAX) {
+            base = fit.GetCenter();
+            radval = fit.GetRadius();
+        }
+        else {
+            base = fitter->GetCenter();
+            radval = fitter->GetRadius();
+        }
     }
 
     std::vector<float> c;
@@ -392,6 +467,13 @@ std::vector<float> SphereSurfaceFit::Parameters() const
     return c;
 }
 
+AbstractSurfaceFit* SphereSurfaceFit::Clone() const
+{
+    if (fitter)
+        return new SphereSurfaceFit();
+    return new SphereSurfaceFit(center, radius);
+}
+
 // --------------------------------------------------------
 
 MeshDistanceGenericSurfaceFitSegment::MeshDistanceGenericSurfaceFitSegment(AbstractSurfaceFit* fit,
@@ -443,6 +525,14 @@ void MeshDistanceGenericSurfaceFitSegment::AddFacet(const MeshFacet& face)
     fitter->AddTriangle(triangle);
 }
 
+MeshSurfaceSegmentPtr MeshDistanceGenericSurfaceFitSegment::Clone() const
+{
+    AbstractSurfaceFit* fit = fitter->Clone();
+    if (!fit)
+        return nullptr;
+    return std::make_shared<MeshDistanceGenericSurfaceFitSegment>(fit, kernel, minFacets, tolerance);
+}
+
 std::vector<float> MeshDistanceGenericSurfaceFitSegment::Parameters() const
 {
     return fitter->Parameters();
@@ -463,6 +553,11 @@ bool MeshCurvaturePlanarSegment::TestFacet (const MeshFacet &rclFacet) const
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvaturePlanarSegment::Clone() const
+{
+    return std::make_shared<MeshCurvaturePlanarSegment>(info, minFacets, tolerance);
+}
+
 bool MeshCurvatureCylindricalSegment::TestFacet (const MeshFacet &rclFacet) const
 {
     for (int i=0; i<3; i++) {
@@ -478,6 +573,11 @@ bool MeshCurvatureCylindricalSegment::TestFacet (const MeshFacet &rclFacet) cons
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvatureCylindricalSegment::Clone() const
+{
+    return std::make_shared<MeshCurvatureCylindricalSegment>(info, minFacets, toleranceMin, toleranceMax, curvature);
+}
+
 bool MeshCurvatureSphericalSegment::TestFacet (const MeshFacet &rclFacet) const
 {
     for (int i=0; i<3; i++) {
@@ -496,6 +596,11 @@ bool MeshCurvatureSphericalSegment::TestFacet (const MeshFacet &rclFacet) const
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvatureSphericalSegment::Clone() const
+{
+    return std::make_shared<MeshCurvatureSphericalSegment>(info, minFacets, tolerance, curvature);
+}
+
 bool MeshCurvatureFreeformSegment::TestFacet (const MeshFacet &rclFacet) const
 {
     for (int i=0; i<3; i++) {
@@ -509,6 +614,11 @@ bool MeshCurvatureFreeformSegment::TestFacet (const MeshFacet &rclFacet) const
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvatureFreeformSegment::Clone() const
+{
+    return std::make_shared<MeshCurvatureFreeformSegment>(info, minFacets, toleranceMin, toleranceMax, c1, c2);
+}
+
 // --------------------------------------------------------
 
 MeshSurfaceVisitor::MeshSurfaceVisitor (MeshSurfaceSegment& segm, std::vector<FacetIndex> &indices)
@@ -536,6 +646,144 @@ bool MeshSurfaceVisitor::Visit (const MeshFacet & face, const MeshFacet &,
 
 // --------------------------------------------------------
 
+namespace {
+struct SegmentRegion
+{
+    std::vector<FacetIndex> indices;
+    bool aborted = false;
+};
+
+/*!
+ * \brief growRegion
+ * Grows the region of the seed \a seeds[pos] the same way as MeshKernel::VisitNeighbourFacets
+ * with MeshSurfaceVisitor does. Facets already marked as visited are skipped but no flags are
+ * modified so that this can run concurrently. If the region reaches the seed of a preceding
+ * candidate it could never be accepted and the growth is aborted.
+ */
+void growRegion(const MeshKernel& kernel, MeshSurfaceSegment& segm,
+                const std::vector<FacetIndex>& seeds, std::size_t pos,
+                std::vector<char>& marks, SegmentRegion& region)
+{
+    const MeshFacetArray& rFAry = kernel.GetFacets();
+    FacetIndex seed = seeds[pos];
+    region.indices.clear();
+    region.aborted = false;
+
+    segm.Initialize(seed);
+    if (segm.TestInitialFacet(seed))
+        region.indices.push_back(seed);
+
+    std::vector<FacetIndex> currentLevel, nextLevel;
+    currentLevel.push_back(seed);
+    marks[seed] = 1;
+
+    while (!currentLevel.empty() && !region.aborted) {
+        for (FacetIndex index : currentLevel) {
+            const MeshFacet& face = rFAry[index];
+            for (unsigned short i = 0; i < 3 && !region.aborted; i++) {
+                FacetIndex nb = face._aulNeighbours[i];
+                if (nb >= rFAry.size())
+                    continue;
+                const MeshFacet& nbFace = rFAry[nb];
+                if (!segm.TestFacet(nbFace))
+                    continue;
+                if (marks[nb] || nbFace.IsFlag(MeshFacet::VISIT))
+                    continue;
+
+                marks[nb] = 1;
+                nextLevel.push_back(nb);
+                region.indices.push_back(nb);
+                segm.AddFacet(nbFace);
+                if (std::binary_search(seeds.begin(), seeds.begin() + pos, nb))
+                    region.aborted = true;
+            }
+            if (region.aborted)
+                break;
+        }
+
+        currentLevel.swap(nextLevel);
+        nextLevel.clear();
+    }
+
+    marks[seed] = 0;
+    for (FacetIndex index : region.indices)
+        marks[index] = 0;
+}
+}
+
+void MeshSegmentAlgorithm::FindSegmentsParallel(MeshSurfaceSegment& segm,
+                                                std::vector<FacetIndex>& resetVisited)
+{
+    const MeshCore::MeshFacetArray& rFAry = myKernel.GetFacets();
+    std::size_t numFacets = rFAry.size();
+
+    int numThreads = myThreads < 1 ? QThread::idealThreadCount() : myThreads;
+    std::size_t numSlots = static_cast<std::size_t>(std::max(numThreads, 1));
+
+    // each thread grows its regions with an own copy of the segment
+    std::vector<MeshSurfaceSegmentPtr> clones;
+    std::vector< std::vector<char> > marks(numSlots);
+    for (std::size_t i = 0; i < numSlots; i++) {
+        clones.push_back(segm.Clone());
+        marks[i].resize(numFacets, 0);
+    }
+
+    std::size_t waveSize = 4 * numSlots;
+    std::vector<FacetIndex> seeds;
+    std::vector<SegmentRegion> regions(waveSize);
+    FacetIndex startFacet = 0;
+
+    for (;;) {
+        // the next not visited facets are the seeds of this wave
+        seeds.clear();
+        for (FacetIndex index = startFacet; index < numFacets && seeds.size() < waveSize; index++) {
+            if (!rFAry[index].IsFlag(MeshFacet::VISIT))
+                seeds.push_back(index);
+        }
+        if (seeds.empty())
+            break;
+
+        parallel_for(numSlots, static_cast<int>(numSlots), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t slot = begin; slot < end; slot++) {
+                for (std::size_t pos = slot; pos < seeds.size(); pos += numSlots)
+                    growRegion(myKernel, *clones[slot], seeds, pos, marks[slot], regions[pos]);
+            }
+        });
+
+        // Accept the regions in seed order. A seed that has become part of an accepted
+        // region is skipped. A region that overlaps with an accepted region would have
+        // grown differently in the serial search, so the next wave starts with its seed.
+        startFacet = seeds.back() + 1;
+        for (std::size_t pos = 0; pos < seeds.size(); pos++) {
+            FacetIndex seed = seeds[pos];
+            if (rFAry[seed].IsFlag(MeshFacet::VISIT))
+                continue;
+
+            const SegmentRegion& region = regions[pos];
+            bool overlap = region.aborted ||
+                std::any_of(region.indices.begin(), region.indices.end(), [&rFAry](FacetIndex index) {
+                    return rFAry[index].IsFlag(MeshFacet::VISIT);
+                });
+            if (overlap) {
+                startFacet = seed;
+                break;
+            }
+
+            rFAry[seed].SetFlag(MeshFacet::VISIT);
+            for (FacetIndex index : region.indices)
+                rFAry[index].SetFlag(MeshFacet::VISIT);
+
+            // add or discard the segment
+            if (region.indices.size() <= 1) {
+                resetVisited.push_back(seed);
+            }
+            else {
+                segm.AddSegment(region.indices);
+            }
+        }
+    }
+}
+
 void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegmentPtr>& segm)
 {
     // reset VISIT flags
@@ -556,6 +804,11 @@ void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegmentPtr>& segm
         cAlgo.ResetFacetsFlag(resetVisited, MeshCore::MeshFacet::VISIT);
         resetVisited.clear();
 
+        if (myThreads != 1 && (*it)->Clone()) {
+            FindSegmentsParallel(**it, resetVisited);
+            continue;
+        }
+
         MeshCore::MeshIsNotFlag<MeshCore::MeshFacet> flag;
         iCur = std::find_if(iBeg, iEnd, [flag](const MeshFacet& f) {
             return flag(f, MeshFacet::VISIT);
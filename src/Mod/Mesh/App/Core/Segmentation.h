@@ -33,11 +33,13 @@
 
 namespace MeshCore {
 
-class PlaneFit;
+class PlaneMomentFit;
 class CylinderFit;
-class SphereFit;
+class SphereMomentFit;
 class MeshFacet;
+class MeshSurfaceSegment;
 using MeshSegment = std::vector<FacetIndex>;
+using MeshSurfaceSegmentPtr = std::shared_ptr<MeshSurfaceSegment>;
 
 class MeshExport MeshSurfaceSegment
 {
@@ -50,6 +52,11 @@ public:
     virtual void Initialize(FacetIndex);
     virtual bool TestInitialFacet(FacetIndex) const;
     virtual void AddFacet(const MeshFacet& rclFacet);
+    /** Returns a new instance with the same settings but without segments. It is used to
+     * grow several regions concurrently. If a null pointer is returned the segments are
+     * searched serially.
+     */
+    virtual MeshSurfaceSegmentPtr Clone() const;
     void AddSegment(const std::vector<FacetIndex>&);
     const std::vector<MeshSegment>& GetSegments() const { return segments; }
     MeshSegment FindSegment(FacetIndex) const;
@@ -58,7 +65,6 @@ protected:
     std::vector<MeshSegment> segments;
     unsigned long minFacets;
 };
-using MeshSurfaceSegmentPtr = std::shared_ptr<MeshSurfaceSegment>;
 
 // --------------------------------------------------------
 
@@ -82,11 +88,12 @@ public:
     const char* GetType() const override { return "Plane"; }
     void Initialize(FacetIndex) override;
     void AddFacet(const MeshFacet& rclFacet) override;
+    MeshSurfaceSegmentPtr Clone() const override;
 
 protected:
     Base::Vector3f basepoint;
     Base::Vector3f normal;
-    PlaneFit* fitter;
+    PlaneMomentFit* fitter;
 };
 
 class MeshExport AbstractSurfaceFit
@@ -102,6 +109,8 @@ public:
     virtual float Fit() = 0;
     virtual float GetDistanceToSurface(const Base::Vector3f&) const = 0;
     virtual std::vector<float> Parameters() const = 0;
+    /// Returns a new instance with the same settings or null if not supported.
+    virtual AbstractSurfaceFit* Clone() const { return nullptr; }
 };
 
 class MeshExport PlaneSurfaceFit : public AbstractSurfaceFit
@@ -118,11 +127,13 @@ public:
     float Fit() override;
     float GetDistanceToSurface(const Base::Vector3f&) const override;
     std::vector<float> Parameters() const override;
+    AbstractSurfaceFit* Clone() const override;
 
 private:
     Base::Vector3f basepoint;
     Base::Vector3f normal;
-    PlaneFit* fitter;
+    PlaneMomentFit* fitter;
+    std::vector<Base::Vector3f> points; /**< For the final fit in Parameters(). */
 };
 
 class MeshExport CylinderSurfaceFit : public AbstractSurfaceFit
@@ -139,12 +150,14 @@ public:
     float Fit() override;
     float GetDistanceToSurface(const Base::Vector3f&) const override;
     std::vector<float> Parameters() const override;
+    AbstractSurfaceFit* Clone() const override;
 
 private:
     Base::Vector3f basepoint;
     Base::Vector3f axis;
     float radius;
     CylinderFit* fitter;
+    std::size_t refitPoints;
 };
 
 class MeshExport SphereSurfaceFit : public AbstractSurfaceFit
@@ -161,11 +174,13 @@ public:
     float Fit() override;
     float GetDistanceToSurface(const Base::Vector3f&) const override;
     std::vector<float> Parameters() const override;
+    AbstractSurfaceFit* Clone() const override;
 
 private:
     Base::Vector3f center;
     float radius;
-    SphereFit* fitter;
+    SphereMomentFit* fitter;
+    std::vector<Base::Vector3f> points; /**< For the final fit in Parameters(). */
 };
 
 class MeshExport MeshDistanceGenericSurfaceFitSegment : public MeshDistanceSurfaceSegment
@@ -179,6 +194,7 @@ public:
     void Initialize(FacetIndex) override;
     bool TestInitialFacet(FacetIndex) const override;
     void AddFacet(const MeshFacet& rclFacet) override;
+    MeshSurfaceSegmentPtr Clone() const override;
     std::vector<float> Parameters() const;
 
 protected:
@@ -204,6 +220,7 @@ public:
         : MeshCurvatureSurfaceSegment(ci, minFacets), tolerance(tol) {}
     bool TestFacet (const MeshFacet &rclFacet) const override;
     const char* GetType() const override { return "Plane"; }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float tolerance;
@@ -217,6 +234,7 @@ public:
         : MeshCurvatureSurfaceSegment(ci, minFacets), toleranceMin(tolMin), toleranceMax(tolMax) { curvature = curv;}
     bool TestFacet (const MeshFacet &rclFacet) const override;
     const char* GetType() const override { return "Cylinder"; }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float curvature;
@@ -231,6 +249,7 @@ public:
         : MeshCurvatureSurfaceSegment(ci, minFacets), tolerance(tol) { curvature = curv;}
     bool TestFacet (const MeshFacet &rclFacet) const override;
     const char* GetType() const override { return "Sphere"; }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float curvature;
@@ -246,6 +265,7 @@ public:
           toleranceMin(tolMin), toleranceMax(tolMax) {}
     bool TestFacet (const MeshFacet &rclFacet) const override;
     const char* GetType() const override { return "Freeform"; }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float c1, c2;
@@ -271,11 +291,22 @@ protected:
 class MeshExport MeshSegmentAlgorithm
 {
 public:
-    explicit MeshSegmentAlgorithm(const MeshKernel& kernel) : myKernel(kernel) {}
+    explicit MeshSegmentAlgorithm(const MeshKernel& kernel) : myKernel(kernel), myThreads(1) {}
+    /** Sets the number of threads. With a value other than 1 the regions of a segment
+     * that can be cloned are grown from several seeds at once. The regions are accepted
+     * in seed order as long as they don't overlap with an accepted region so that the
+     * result is identical to the serial search. A value of 0 uses all available cores.
+     * The default is 1.
+     */
+    void SetThreads(int num) { myThreads = num; }
     void FindSegments(std::vector<MeshSurfaceSegmentPtr>&);
 
+private:
+    void FindSegmentsParallel(MeshSurfaceSegment&, std::vector<FacetIndex>& resetVisited);
+
 private:
     const MeshKernel& myKernel;
+    int myThreads;
 };
 
 } // MeshCore
@@ -23,18 +23,24 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
 # include <fstream>
 # include <ios>
+# include <vector>
 #endif
 
 #include <Base/Builder3D.h>
+#include <Base/Parallel.h>
 #include <Base/Sequencer.h>
 
 #include "SetOperations.h"
 #include "Algorithm.h"
+#include "BVH.h"
 #include "Builder.h"
 #include "Definitions.h"
 #include "Elements.h"
+#include "Functional.h"
 #include "Grid.h"
 #include "Iterator.h"
 #include "Triangulation.h"
@@ -44,13 +50,254 @@
 using namespace Base;
 using namespace MeshCore;
 
+namespace {
+
+// Expansion arithmetic after J. R. Shewchuk, "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates". An expansion is a sum of
+// non-overlapping doubles ordered by increasing magnitude whose sign is the
+// sign of its last component.
+using Expansion = std::vector<double>;
+
+inline void TwoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bv = x - a;
+    double av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+inline void TwoProduct(double a, double b, double& x, double& y)
+{
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+void GrowExpansion(Expansion& e, double b)
+{
+    Expansion h;
+    h.reserve(e.size() + 1);
+    double q = b;
+    for (double ei : e) {
+        double x, y;
+        TwoSum(q, ei, x, y);
+        if (y != 0.0)
+            h.push_back(y);
+        q = x;
+    }
+    if (q != 0.0)
+        h.push_back(q);
+    e.swap(h);
+}
+
+Expansion DiffExpansion(double a, double b)
+{
+    Expansion e;
+    GrowExpansion(e, a);
+    GrowExpansion(e, -b);
+    return e;
+}
+
+Expansion MultExpansion(const Expansion& e, const Expansion& f)
+{
+    Expansion h;
+    for (double ei : e) {
+        for (double fj : f) {
+            double x, y;
+            TwoProduct(ei, fj, x, y);
+            GrowExpansion(h, y);
+            GrowExpansion(h, x);
+        }
+    }
+    return h;
+}
+
+Expansion SubExpansion(Expansion e, const Expansion& f)
+{
+    for (double fj : f)
+        GrowExpansion(e, -fj);
+    return e;
+}
+
+Expansion AddExpansion(Expansion e, const Expansion& f)
+{
+    for (double fj : f)
+        GrowExpansion(e, fj);
+    return e;
+}
+
+/*
+ * Returns the determinant of the vectors a-d, b-d, c-d. The sign of the returned value
+ * is always exact: if the floating point result cannot be trusted the determinant is
+ * re-evaluated with expansion arithmetic.
+ */
+double Orient3d(const double* a, const double* b, const double* c, const double* d)
+{
+    double adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+    double bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+    double cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+
+    double det = adx * (bdy * cdz - bdz * cdy)
+               + bdx * (cdy * adz - cdz * ady)
+               + cdx * (ady * bdz - adz * bdy);
+    double permanent = std::fabs(adx) * (std::fabs(bdy * cdz) + std::fabs(bdz * cdy))
+                     + std::fabs(bdx) * (std::fabs(cdy * adz) + std::fabs(cdz * ady))
+                     + std::fabs(cdx) * (std::fabs(ady * bdz) + std::fabs(adz * bdy));
+    const double errbound = 7.7715611723761027e-16; // (7 + 56 * eps) * eps
+    if (std::fabs(det) > errbound * permanent)
+        return det;
+
+    Expansion eadx = DiffExpansion(a[0], d[0]), eady = DiffExpansion(a[1], d[1]), eadz = DiffExpansion(a[2], d[2]);
+    Expansion ebdx = DiffExpansion(b[0], d[0]), ebdy = DiffExpansion(b[1], d[1]), ebdz = DiffExpansion(b[2], d[2]);
+    Expansion ecdx = DiffExpansion(c[0], d[0]), ecdy = DiffExpansion(c[1], d[1]), ecdz = DiffExpansion(c[2], d[2]);
+
+    Expansion m1 = SubExpansion(MultExpansion(ebdy, ecdz), MultExpansion(ebdz, ecdy));
+    Expansion m2 = SubExpansion(MultExpansion(ecdy, eadz), MultExpansion(ecdz, eady));
+    Expansion m3 = SubExpansion(MultExpansion(eady, ebdz), MultExpansion(eadz, ebdy));
+    Expansion exact = AddExpansion(AddExpansion(MultExpansion(eadx, m1), MultExpansion(ebdx, m2)),
+                                   MultExpansion(ecdx, m3));
+    if (exact.empty())
+        return 0.0;
+    // keep the magnitude of the approximation but with the exact sign
+    double sign = exact.back() > 0.0 ? 1.0 : -1.0;
+    double value = std::fabs(det) > 0.0 ? std::fabs(det) : std::fabs(exact.back());
+    return sign * value;
+}
+
+inline int Sign(double value)
+{
+    return (value > 0.0) - (value < 0.0);
+}
+
+/*
+ * Computes the part of the triangle \a tria that lies on the plane of the other triangle.
+ * The arrays \a sign and \a dist contain the exact sign and the approximate signed distance
+ * of each corner to the plane. The function returns the number of points written to \a pts.
+ */
+int ClipToPlane(const double tria[3][3], const int sign[3], const double dist[3], double pts[2][3])
+{
+    int num = 0;
+    for (int i = 0; i < 3 && num < 2; i++) {
+        if (sign[i] == 0) {
+            std::copy(tria[i], tria[i] + 3, pts[num++]);
+        }
+    }
+    for (int i = 0; i < 3 && num < 2; i++) {
+        int j = (i + 1) % 3;
+        if (sign[i] * sign[j] < 0) {
+            double t = dist[i] / (dist[i] - dist[j]);
+            t = std::max(0.0, std::min(1.0, t));
+            for (int k = 0; k < 3; k++)
+                pts[num][k] = tria[i][k] + t * (tria[j][k] - tria[i][k]);
+            num++;
+        }
+    }
+    return num;
+}
+
+/*
+ * Robust variant of MeshGeomFacet::IntersectWithFacet(). Whether a corner of a facet lies on,
+ * above or below the plane of the other facet is decided with exact orientation predicates so
+ * that touching facets are neither missed nor reported for facets that are apart. Coplanar
+ * facets are handled by MeshGeomFacet::IntersectWithFacet().
+ */
+int IntersectFacetsExact(const MeshGeomFacet& f1, const MeshGeomFacet& f2,
+                         Base::Vector3f& rclPt0, Base::Vector3f& rclPt1)
+{
+    double P[3][3], Q[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int k = 0; k < 3; k++) {
+            P[i][k] = static_cast<double>(f1._aclPoints[i][k]);
+            Q[i][k] = static_cast<double>(f2._aclPoints[i][k]);
+        }
+    }
+
+    double distP[3], distQ[3];
+    int signP[3], signQ[3];
+    for (int i = 0; i < 3; i++) {
+        distP[i] = Orient3d(Q[0], Q[1], Q[2], P[i]);
+        signP[i] = Sign(distP[i]);
+    }
+
+    if (signP[0] == 0 && signP[1] == 0 && signP[2] == 0)
+        return f1.IntersectWithFacet(f2, rclPt0, rclPt1);
+    if (signP[0] == signP[1] && signP[1] == signP[2])
+        return 0;
+
+    for (int i = 0; i < 3; i++) {
+        distQ[i] = Orient3d(P[0], P[1], P[2], Q[i]);
+        signQ[i] = Sign(distQ[i]);
+    }
+
+    if (signQ[0] == signQ[1] && signQ[1] == signQ[2])
+        return 0;
+
+    // Both facets cross the plane of the other facet, so the parts on the
+    // planes are segments (or points) on the line where the planes meet
+    double segP[2][3], segQ[2][3];
+    int numP = ClipToPlane(P, signP, distP, segP);
+    int numQ = ClipToPlane(Q, signQ, distQ, segQ);
+    if (numP == 0 || numQ == 0)
+        return 0;
+    if (numP == 1)
+        std::copy(segP[0], segP[0] + 3, segP[1]);
+    if (numQ == 1)
+        std::copy(segQ[0], segQ[0] + 3, segQ[1]);
+
+    double u[3], v[3], dir[3];
+    for (int k = 0; k < 3; k++) {
+        u[k] = P[1][k] - P[0][k];
+        v[k] = P[2][k] - P[0][k];
+    }
+    double n1[3] = {u[1]*v[2] - u[2]*v[1], u[2]*v[0] - u[0]*v[2], u[0]*v[1] - u[1]*v[0]};
+    for (int k = 0; k < 3; k++) {
+        u[k] = Q[1][k] - Q[0][k];
+        v[k] = Q[2][k] - Q[0][k];
+    }
+    double n2[3] = {u[1]*v[2] - u[2]*v[1], u[2]*v[0] - u[0]*v[2], u[0]*v[1] - u[1]*v[0]};
+    dir[0] = n1[1]*n2[2] - n1[2]*n2[1];
+    dir[1] = n1[2]*n2[0] - n1[0]*n2[2];
+    dir[2] = n1[0]*n2[1] - n1[1]*n2[0];
+    if (dir[0] == 0.0 && dir[1] == 0.0 && dir[2] == 0.0)
+        return f1.IntersectWithFacet(f2, rclPt0, rclPt1);
+
+    auto project = [&dir](const double* pt) {
+        return pt[0] * dir[0] + pt[1] * dir[1] + pt[2] * dir[2];
+    };
+
+    // sort both segments along the line
+    double tP0 = project(segP[0]), tP1 = project(segP[1]);
+    if (tP0 > tP1) {
+        std::swap(tP0, tP1);
+        std::swap(segP[0], segP[1]);
+    }
+    double tQ0 = project(segQ[0]), tQ1 = project(segQ[1]);
+    if (tQ0 > tQ1) {
+        std::swap(tQ0, tQ1);
+        std::swap(segQ[0], segQ[1]);
+    }
+
+    if (tP1 < tQ0 || tQ1 < tP0)
+        return 0;
+
+    const double* lo = tP0 >= tQ0 ? segP[0] : segQ[0];
+    const double* hi = tP1 <= tQ1 ? segP[1] : segQ[1];
+    rclPt0.Set(static_cast<float>(lo[0]), static_cast<float>(lo[1]), static_cast<float>(lo[2]));
+    rclPt1.Set(static_cast<float>(hi[0]), static_cast<float>(hi[1]), static_cast<float>(hi[2]));
+    return rclPt0 == rclPt1 ? 1 : 2;
+}
+
+}
+
+
 
 SetOperations::SetOperations (const MeshKernel &cutMesh1, const MeshKernel &cutMesh2, MeshKernel &result, OperationType opType, float minDistanceToPoint)
 : _cutMesh0(cutMesh1),
   _cutMesh1(cutMesh2),
   _resultMesh(result),
   _operationType(opType),
-  _minDistanceToPoint(minDistanceToPoint)
+  _minDistanceToPoint(minDistanceToPoint),
+  _threads(Base::idealThreadCount()),
+  _robust(false)
 {
 }
 
@@ -167,244 +414,262 @@ void SetOperations::Do ()
 
 void SetOperations::Cut (std::set<FacetIndex>& facetsCuttingEdge0, std::set<FacetIndex>& facetsCuttingEdge1)
 {
-  MeshFacetGrid grid1(_cutMesh0, 20);
-  MeshFacetGrid grid2(_cutMesh1, 20);
-
-  unsigned long ctGx1, ctGy1, ctGz1;
-  grid1.GetCtGrids(ctGx1, ctGy1, ctGz1);
+  // broad phase: bounding volume hierarchies over the facets of both meshes
+  MeshFacetBVH bvh0(_cutMesh0);
+  MeshFacetBVH bvh1(_cutMesh1);
+  if (!(bvh0.GetBoundBox() && bvh1.GetBoundBox()))
+    return;
 
-  unsigned long gx1;
-  for (gx1 = 0; gx1 < ctGx1; gx1++)
-  {
-    unsigned long gy1;
-    for (gy1 = 0; gy1 < ctGy1; gy1++)
+  // narrow phase: each block of facets of the first mesh writes into its own bucket
+  // so that no locking is needed and the result doesn't depend on the scheduling
+  std::size_t numFacets = _cutMesh0.CountFacets();
+  std::size_t numBlocks = std::min<std::size_t>(numFacets, 256);
+  std::vector< std::vector<CutRecord> > buckets(numBlocks);
+  parallel_for(numBlocks, _threads, [&](std::size_t begin, std::size_t end) {
+    std::vector<FacetIndex> candidates;
+    for (std::size_t block = begin; block < end; block++)
     {
-      unsigned long gz1;
-      for (gz1 = 0; gz1 < ctGz1; gz1++)
+      std::size_t first = block * numFacets / numBlocks;
+      std::size_t last = (block + 1) * numFacets / numBlocks;
+      for (FacetIndex fidx1 = first; fidx1 < last; fidx1++)
       {
-        if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
+        candidates.clear();
+        bvh1.Intersect(bvh0.GetBoundBox(fidx1), candidates);
+        if (candidates.empty())
+          continue;
+
+        std::sort(candidates.begin(), candidates.end());
+        MeshGeomFacet f1 = _cutMesh0.GetFacet(fidx1);
+        for (FacetIndex fidx2 : candidates)
         {
-          std::vector<FacetIndex> vecFacets2;
-          grid2.Inside(grid1.GetBoundBox(gx1, gy1, gz1), vecFacets2);
+          MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
 
-          if (!vecFacets2.empty())
-          {
-            std::set<FacetIndex> vecFacets1;
-            grid1.GetElements(gx1, gy1, gz1, vecFacets1);
+          MeshPoint p0, p1;
 
-            std::set<FacetIndex>::iterator it1;
-            for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
+          int isect = _robust ? IntersectFacetsExact(f1, f2, p0, p1)
+                              : f1.IntersectWithFacet(f2, p0, p1);
+          if (isect > 0)
+          {
+             // optimize cut line if distance to nearest point is too small
+            float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
+            MeshPoint np0 = p0, np1 = p1;
+            int i;
+            for (i = 0; i < 3; i++)
             {
-              FacetIndex fidx1 = *it1;
-              MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
-
-              std::vector<FacetIndex>::iterator it2;
-              for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
+              float d1 = (f1._aclPoints[i] - p0).Length();
+              float d2 = (f1._aclPoints[i] - p1).Length();
+              if (d1 < minDist1)
               {
-                FacetIndex fidx2 = *it2;
-                MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
-
-                MeshPoint p0, p1;
-
-                int isect = f1.IntersectWithFacet(f2, p0, p1);
-                if (isect > 0)
-                {
-                   // optimize cut line if distance to nearest point is too small
-                  float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
-                  MeshPoint np0 = p0, np1 = p1;
-                  int i;
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f1._aclPoints[i] - p0).Length();
-                    float d2 = (f1._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f1._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      p1 = f1._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  // optimize cut line if distance to nearest point is too small
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f2._aclPoints[i] - p0).Length();
-                    float d2 = (f2._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f2._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      np1 = f2._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  MeshPoint mp0 = np0;
-                  MeshPoint mp1 = np1;
-
-                  if (mp0 != mp1)
-                  {
-                    facetsCuttingEdge0.insert(fidx1);
-                    facetsCuttingEdge1.insert(fidx2);
+                minDist1 = d1;
+                np0 = f1._aclPoints[i];
+              }
+              if (d2 < minDist2)
+              {
+                minDist2 = d2;
+                p1 = f1._aclPoints[i];
+              }
+            } // for (int i = 0; i < 3; i++)
 
-                    _cutPoints.insert(mp0);
-                    _cutPoints.insert(mp1);
+            // optimize cut line if distance to nearest point is too small
+            for (i = 0; i < 3; i++)
+            {
+              float d1 = (f2._aclPoints[i] - p0).Length();
+              float d2 = (f2._aclPoints[i] - p1).Length();
+              if (d1 < minDist1)
+              {
+                minDist1 = d1;
+                np0 = f2._aclPoints[i];
+              }
+              if (d2 < minDist2)
+              {
+                minDist2 = d2;
+                np1 = f2._aclPoints[i];
+              }
+            } // for (int i = 0; i < 3; i++)
+
+            CutRecord rec;
+            rec.facet0 = fidx1;
+            rec.facet1 = fidx2;
+            rec.pt0 = np0;
+            rec.pt1 = np1;
+            buckets[block].push_back(rec);
+          } // if (f1.IntersectWithFacet(f2, p0, p1))
+        } // for (FacetIndex fidx2 : candidates)
+      } // for (fidx1 = first; fidx1 < last; fidx1++)
+    } // for (block = begin; block < end; block++)
+  });
+
+  // merge the buckets in the order of the facets of the first mesh
+  for (const auto& bucket : buckets)
+  {
+    for (const auto& rec : bucket)
+    {
+      const MeshPoint& mp0 = rec.pt0;
+      const MeshPoint& mp1 = rec.pt1;
 
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
+      if (mp0 != mp1)
+      {
+        facetsCuttingEdge0.insert(rec.facet0);
+        facetsCuttingEdge1.insert(rec.facet1);
 
-                    _edges[Edge(mp0, mp1)] = EdgeInfo();
+        std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
+        std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
 
-                    _facet2points[0][fidx1].push_back(pit0.first);
-                    _facet2points[0][fidx1].push_back(pit1.first);
-                    _facet2points[1][fidx2].push_back(pit0.first);
-                    _facet2points[1][fidx2].push_back(pit1.first);
+        _edges[Edge(mp0, mp1)] = EdgeInfo();
 
-                  }
-                  else
-                  {
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
+        _facet2points[0][rec.facet0].push_back(pit0.first);
+        _facet2points[0][rec.facet0].push_back(pit1.first);
+        _facet2points[1][rec.facet1].push_back(pit0.first);
+        _facet2points[1][rec.facet1].push_back(pit1.first);
+      }
+      else
+      {
+        std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
 
-                    // do not insert a facet when only one corner point cuts the edge
-                    // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
-                    {
-                      facetsCuttingEdge0.insert(fidx1);
-                      _facet2points[0][fidx1].push_back(pit.first);
-                    }
+        // do not insert a facet when only one corner point cuts the edge
+        // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
+        {
+          facetsCuttingEdge0.insert(rec.facet0);
+          _facet2points[0][rec.facet0].push_back(pit.first);
+        }
 
-                    // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
-                    {
-                      facetsCuttingEdge1.insert(fidx2);
-                      _facet2points[1][fidx2].push_back(pit.first);
-                    }
-                  }
-
-                 } // if (f1.IntersectWithFacet(f2, p0, p1))
-              } // for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
-            } // for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
-          } // if (vecFacets2.size() > 0)
-        } // if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
-      } // for (gz1 = 0; gz1 < ctGz1; gz1++)
-    } // for (gy1 = 0; gy1 < ctGy1; gy1++)
-  } // for (gx1 = 0; gx1 < ctGx1; gx1++)
+        // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
+        {
+          facetsCuttingEdge1.insert(rec.facet1);
+          _facet2points[1][rec.facet1].push_back(pit.first);
+        }
+      }
+    }
+  }
 }
 
 void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
 {
-  // Triangulate Mesh
-  std::map<FacetIndex, std::list<std::set<MeshPoint>::iterator> >::iterator it1;
-  for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
-  {
-    std::vector<Vector3f> points;
-    std::set<MeshPoint>   pointsSet;
-
-    FacetIndex fidx = it1->first;
-    MeshGeomFacet f = cutMesh.GetFacet(fidx);
+  using FacetPointMap = std::map<FacetIndex, std::list<std::set<MeshPoint>::iterator> >;
+  std::vector<FacetPointMap::iterator> cutFacets;
+  cutFacets.reserve(_facet2points[side].size());
+  for (FacetPointMap::iterator it = _facet2points[side].begin(); it != _facet2points[side].end(); ++it)
+    cutFacets.push_back(it);
+
+  // Triangulate Mesh, each cut facet independently of the others
+  std::vector< std::vector<MeshGeomFacet> > triangulation(cutFacets.size());
+  parallel_for(cutFacets.size(), _threads, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t index = begin; index < end; index++)
+    {
+      FacetPointMap::iterator it1 = cutFacets[index];
+      std::vector<Vector3f> points;
+      std::set<MeshPoint>   pointsSet;
 
-    //if (side == 1)
-    //    _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0, 1, 1);
+      FacetIndex fidx = it1->first;
+      MeshGeomFacet f = cutMesh.GetFacet(fidx);
 
-     // facet corner points
-    //const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
-    int i;
-    for (i = 0; i < 3; i++)
-    {
-      pointsSet.insert(f._aclPoints[i]);
-      points.push_back(f._aclPoints[i]);
-    }
+      //if (side == 1)
+      //    _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0, 1, 1);
 
-    // triangulated facets
-    std::list<std::set<MeshPoint>::iterator>::iterator it2;
-    for (it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
-    {
-      if (pointsSet.find(*(*it2)) == pointsSet.end())
+       // facet corner points
+      //const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
+      int i;
+      for (i = 0; i < 3; i++)
       {
-        pointsSet.insert(*(*it2));
-        points.push_back(*(*it2));
+        pointsSet.insert(f._aclPoints[i]);
+        points.push_back(f._aclPoints[i]);
       }
 
-    }
-
-    Vector3f normal = f.GetNormal();
-    Vector3f base = points[0];
-    Vector3f dirX = points[1] - points[0];
-    dirX.Normalize();
-    Vector3f dirY = dirX % normal;
+      // triangulated facets
+      std::list<std::set<MeshPoint>::iterator>::iterator it2;
+      for (it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
+      {
+        if (pointsSet.find(*(*it2)) == pointsSet.end())
+        {
+          pointsSet.insert(*(*it2));
+          points.push_back(*(*it2));
+        }
 
-    // project points to 2D plane
-    std::vector<Vector3f>::iterator it;
-    std::vector<Vector3f> vertices;
-    for (it = points.begin(); it != points.end(); ++it)
-    {
-      Vector3f pv = *it;
-      pv.TransformToCoordinateSystem(base, dirX, dirY);
-      vertices.push_back(pv);
-    }
+      }
 
-    DelaunayTriangulator tria;
-    tria.SetPolygon(vertices);
-    tria.TriangulatePolygon();
+      Vector3f normal = f.GetNormal();
+      Vector3f base = points[0];
+      Vector3f dirX = points[1] - points[0];
+      dirX.Normalize();
+      Vector3f dirY = dirX % normal;
 
-    std::vector<MeshFacet> facets = tria.GetFacets();
-    for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
-    {
-      if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
-          (it->_aulPoints[1] == it->_aulPoints[2]) ||
-          (it->_aulPoints[2] == it->_aulPoints[0]))
-      { // two same triangle corner points
-        continue;
+      // project points to 2D plane
+      std::vector<Vector3f>::iterator it;
+      std::vector<Vector3f> vertices;
+      for (it = points.begin(); it != points.end(); ++it)
+      {
+        Vector3f pv = *it;
+        pv.TransformToCoordinateSystem(base, dirX, dirY);
+        vertices.push_back(pv);
       }
 
-      MeshGeomFacet facet(points[it->_aulPoints[0]],
-                          points[it->_aulPoints[1]],
-                          points[it->_aulPoints[2]]);
+      DelaunayTriangulator tria;
+      tria.SetPolygon(vertices);
+      tria.TriangulatePolygon();
 
-      //if (side == 1)
-      // _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
-      //if (facet.Area() < 0.0001f)
-      //{ // too small facet
-      //  continue;
-      //}
-
-      float dist0 = facet._aclPoints[0].DistanceToLine
-          (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
-      float dist1 = facet._aclPoints[1].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
-      float dist2 = facet._aclPoints[2].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
-
-      if ((dist0 < _minDistanceToPoint) ||
-          (dist1 < _minDistanceToPoint) ||
-          (dist2 < _minDistanceToPoint))
+      std::vector<MeshFacet> facets = tria.GetFacets();
+      for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
       {
-        continue;
-      }
+        if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
+            (it->_aulPoints[1] == it->_aulPoints[2]) ||
+            (it->_aulPoints[2] == it->_aulPoints[0]))
+        { // two same triangle corner points
+          continue;
+        }
 
-      //dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
-      //dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
-      //dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
+        MeshGeomFacet facet(points[it->_aulPoints[0]],
+                            points[it->_aulPoints[1]],
+                            points[it->_aulPoints[2]]);
 
-      //if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 < _minDistanceToPoint))
-      //{
-      //  continue;
-      //}
+        //if (side == 1)
+        // _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
 
-      facet.CalcNormal();
-      if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
-      { // adjust normal
-         std::swap(facet._aclPoints[0], facet._aclPoints[1]);
-         facet.CalcNormal();
-      }
+        //if (facet.Area() < 0.0001f)
+        //{ // too small facet
+        //  continue;
+        //}
+
+        float dist0 = facet._aclPoints[0].DistanceToLine
+            (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
+        float dist1 = facet._aclPoints[1].DistanceToLine
+            (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
+        float dist2 = facet._aclPoints[2].DistanceToLine
+            (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
+
+        if ((dist0 < _minDistanceToPoint) ||
+            (dist1 < _minDistanceToPoint) ||
+            (dist2 < _minDistanceToPoint))
+        {
+          continue;
+        }
 
+        //dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
+        //dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
+        //dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
 
+        //if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 < _minDistanceToPoint))
+        //{
+        //  continue;
+        //}
+
+        facet.CalcNormal();
+        if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
+        { // adjust normal
+           std::swap(facet._aclPoints[0], facet._aclPoints[1]);
+           facet.CalcNormal();
+        }
+
+        triangulation[index].push_back(facet);
+      } // for (i = 0; i < (out->numberoftriangles * 3); i += 3)
+    } // for (index = begin; index < end; index++)
+  });
+
+  // register the new facets at the cut edges in the order of the facet indices
+  for (std::size_t index = 0; index < cutFacets.size(); index++)
+  {
+    FacetIndex fidx = cutFacets[index]->first;
+    for (MeshGeomFacet& facet : triangulation[index])
+    {
       int j;
       for (j = 0; j < 3; j++)
       {
@@ -428,9 +693,8 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
       }
 
       _newMeshFacets[side].push_back(facet);
-
-    } // for (i = 0; i < (out->numberoftriangles * 3); i += 3)
-  } // for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+    }
+  }
 }
 
 void SetOperations::CollectFacets (int side, float mult)
@@ -634,53 +898,59 @@ void MeshIntersection::getIntersection(std::list<MeshIntersection::Tuple>& intsc
     const MeshKernel& k1 = kernel1;
     const MeshKernel& k2 = kernel2;
 
-    // Contains bounding boxes for every facet of 'k1'
-    std::vector<Base::BoundBox3f> boxes1;
-    MeshFacetIterator cMFI1(k1);
-    for (cMFI1.Begin(); cMFI1.More(); cMFI1.Next()) {
-        boxes1.push_back((*cMFI1).GetBoundBox());
-    }
-
-    // Contains bounding boxes for every facet of 'k2'
-    std::vector<Base::BoundBox3f> boxes2;
-    MeshFacetIterator cMFI2(k2);
-    for (cMFI2.Begin(); cMFI2.More(); cMFI2.Next()) {
-        boxes2.push_back((*cMFI2).GetBoundBox());
-    }
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(k1);
-
-    const MeshFacetArray& rFaces2 = k2.GetFacets();
-    Base::SequencerLauncher seq("Checking for intersections...", rFaces2.size());
-    int index = 0;
-    MeshGeomFacet facet1, facet2;
-    Base::Vector3f pt1, pt2;
-
-    // Iterate over the facets of the 2nd mesh and find the grid elements of the 1st mesh
-    for (MeshFacetArray::_TConstIterator it = rFaces2.begin(); it != rFaces2.end(); ++it, index++) {
-        seq.next();
-        std::vector<FacetIndex> elements;
-        cMeshFacetGrid.Inside(boxes2[index], elements, true);
-
-        cMFI2.Set(index);
-        facet2 = *cMFI2;
-
-        for (std::vector<FacetIndex>::iterator jt = elements.begin(); jt != elements.end(); ++jt) {
-            if (boxes2[index] && boxes1[*jt]) {
-                cMFI1.Set(*jt);
-                facet1 = *cMFI1;
-                int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                if (ret == 2) {
-                    Tuple d;
-                    d.p1 = pt1;
-                    d.p2 = pt2;
-                    d.f1 = *jt;
-                    d.f2 = index;
-                    intsct.push_back(d);
+    // Bounding volume hierarchies of both meshes
+    MeshFacetBVH bvh1(k1);
+    MeshFacetBVH bvh2(k2);
+    if (!(bvh1.GetBoundBox() && bvh2.GetBoundBox()))
+        return;
+
+    // Check the facets of the 2nd mesh in packets so that the progress can be shown
+    // in the calling thread. Each block of a packet collects the intersections in its
+    // own bucket which are appended in the order of the facets afterwards.
+    const std::size_t numFacets = k2.CountFacets();
+    const std::size_t packetSize = 4096;
+    const std::size_t blockSize = 64;
+    std::size_t numPackets = (numFacets + packetSize - 1) / packetSize;
+    Base::SequencerLauncher seq("Checking for intersections...", numPackets);
+
+    for (std::size_t packet = 0; packet < numPackets; packet++) {
+        std::size_t first = packet * packetSize;
+        std::size_t last = std::min(first + packetSize, numFacets);
+        std::size_t numBlocks = (last - first + blockSize - 1) / blockSize;
+        std::vector< std::vector<Tuple> > buckets(numBlocks);
+
+        parallel_for(numBlocks, threads, [&](std::size_t begin, std::size_t end) {
+            std::vector<FacetIndex> elements;
+            Base::Vector3f pt1, pt2;
+            for (std::size_t block = begin; block < end; block++) {
+                std::size_t blockEnd = std::min(first + (block + 1) * blockSize, last);
+                for (std::size_t index = first + block * blockSize; index < blockEnd; index++) {
+                    elements.clear();
+                    bvh1.Intersect(bvh2.GetBoundBox(index), elements);
+                    if (elements.empty())
+                        continue;
+
+                    std::sort(elements.begin(), elements.end());
+                    MeshGeomFacet facet2 = k2.GetFacet(index);
+                    for (FacetIndex jt : elements) {
+                        MeshGeomFacet facet1 = k1.GetFacet(jt);
+                        int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
+                        if (ret == 2) {
+                            Tuple d;
+                            d.p1 = pt1;
+                            d.p2 = pt2;
+                            d.f1 = jt;
+                            d.f2 = index;
+                            buckets[block].push_back(d);
+                        }
+                    }
                 }
             }
-        }
+        });
+
+        for (const auto& bucket : buckets)
+            intsct.insert(intsct.end(), bucket.begin(), bucket.end());
+        seq.next();
     }
 }
 
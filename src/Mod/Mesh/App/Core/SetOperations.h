@@ -67,12 +67,29 @@ public:
    */
   void Do ();
 
+  /** Sets the number of threads used to intersect and re-triangulate the facets. A value of 0 or
+   * less uses as many threads as cores are available, 1 runs the computation in the calling thread.
+   * The result does not depend on the number of threads.
+   */
+  void SetThreads (int threads)
+  { _threads = threads; }
+  /** If \a on is true the decision whether two facets intersect is made with exact orientation
+   * predicates instead of floating point arithmetic. This is slower but does not miss or invent
+   * intersections for nearly touching or nearly coplanar facets.
+   * Only this predicate stage is exact: the intersection segments are still computed in double
+   * precision, and coplanar facets and the re-triangulation take the usual floating point path.
+   */
+  void SetRobust (bool on)
+  { _robust = on; }
+
 protected:
   const MeshKernel   &_cutMesh0;             /** Mesh for set operations source 1 */
   const MeshKernel   &_cutMesh1;             /** Mesh for set operations source 2 */
   MeshKernel         &_resultMesh;           /** Result mesh */
   OperationType       _operationType;        /** Set Operation Type */
   float               _minDistanceToPoint;   /** Minimal distance to facet corner points */
+  int                 _threads;              /** Number of threads */
+  bool                _robust;               /** Use exact predicates */
 
 private:
   // Helper class cutting edge to its two attached facets
@@ -169,6 +186,13 @@ private:
 
   std::vector<MeshGeomFacet> _newMeshFacets[2];
 
+  /** Intersection segment of two facets */
+  struct CutRecord
+  {
+    FacetIndex        facet0, facet1;
+    MeshPoint         pt0, pt1;
+  };
+
   /** Cut mesh 1 with mesh 2 */
   void Cut (std::set<FacetIndex>& facetsNotCuttingEdge0, std::set<FacetIndex>& facetsCuttingEdge1);
   /** Trianglute each facets cut with its cutting points */
@@ -214,6 +238,12 @@ public:
     {
     }
 
+    /// Sets the number of threads, a value of 0 or less uses all cores.
+    void setThreads(int num)
+    {
+        threads = num;
+    }
+
     bool hasIntersection() const;
     void getIntersection(std::list<Tuple>&) const;
     /*!
@@ -229,6 +259,7 @@ private:
     const MeshKernel& kernel1;
     const MeshKernel& kernel2;
     float minDistance;
+    int threads = 0;
 };
 
 
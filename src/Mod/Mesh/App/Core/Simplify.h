@@ -9,6 +9,8 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Add locked vertices and a caller-defined vertex id to support partitioned decimation
+// * Add an optional upper limit for the quadric error of a collapse
 
 #include <vector>
 
@@ -84,11 +86,13 @@ class Simplify
 {
 public:
     struct Triangle { int v[3];double err[4];int deleted,dirty;vec3f n; };
-    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;};
+    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;int locked=0;int id=-1;};
     struct Ref { int tid,tvertex; };
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
     std::vector<Ref> refs;
+    // if > 0 no edge with a higher quadric error will be collapsed
+    double max_error=0;
 
     void simplify_mesh(int target_count, double tolerance, double aggressiveness=7);
 
@@ -155,6 +159,8 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
         // If it does not, try to adjust the 3 parameters
         //
         double threshold = 0.000000001*pow(double(iteration+3),aggressiveness);
+        if (max_error > 0.0)
+            threshold = std::min(threshold, max_error);
         if (tolerance > 0.0)
         {
             bool canContinue = false;
@@ -198,6 +204,10 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     if (v0.border != v1.border)
                         continue;
 
+                    // Locked vertices must keep their position
+                    if (v0.locked || v1.locked)
+                        continue;
+
                     // Compute vertex to collapse to
                     vec3f p;
                     calculate_error(i0,i1,p);
@@ -478,6 +488,8 @@ void Simplify::compact_mesh()
         {
             vertices[i].tstart=dst;
             vertices[dst].p=vertices[i].p;
+            vertices[dst].locked=vertices[i].locked;
+            vertices[dst].id=vertices[i].id;
             dst++;
         }
     }
@@ -0,0 +1,463 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <deque>
+# include <numeric>
+# include <unordered_map>
+#endif
+
+#include "Slicer.h"
+#include "Functional.h"
+#include "MeshKernel.h"
+
+
+using namespace MeshCore;
+
+namespace {
+
+using Line = std::pair<Base::Vector3f, Base::Vector3f>;
+
+/*
+ * Connects lines at their end points. The end points are stored in a hash grid whose
+ * cell size is the search radius so that only the 27 neighbouring cells are checked.
+ */
+class LineJoiner
+{
+public:
+    LineJoiner(const std::vector<Line>& lines, float fMinEps)
+      : lines(lines), eps2(fMinEps * fMinEps), cellSize(fMinEps)
+    {
+        // enlarge the cells if the coordinates divided by the cell size would
+        // exceed the range of the cell indices
+        float maxCoord = 0.0f;
+        for (const auto& line : lines) {
+            for (const auto& pnt : {line.first, line.second}) {
+                maxCoord = std::max({maxCoord, std::fabs(pnt.x), std::fabs(pnt.y), std::fabs(pnt.z)});
+            }
+        }
+        if (std::isfinite(maxCoord))
+            cellSize = std::max(cellSize, float(double(maxCoord) / MaxIndex));
+    }
+
+    void Connect(MeshSlicer::Polylines& polylines)
+    {
+        // skip all lines whose length is smaller than epsilon
+        std::vector<char> used(lines.size(), 0);
+        float toDelete = eps2 / 10.0f;
+        for (std::size_t i = 0; i < lines.size(); i++) {
+            if (Base::DistanceP2(lines[i].first, lines[i].second) < toDelete) {
+                used[i] = 1;
+            }
+            else if (cellSize > 0.0f) {
+                grid[toCell(lines[i].first)].push_back(2 * i);
+                grid[toCell(lines[i].second)].push_back(2 * i + 1);
+            }
+        }
+
+        for (std::size_t i = 0; i < lines.size(); i++) {
+            if (used[i])
+                continue;
+
+            // new polyline
+            used[i] = 1;
+            std::deque<Base::Vector3f> poly;
+            poly.push_back(lines[i].first);
+            poly.push_back(lines[i].second);
+
+            // search for the next line on the begin/end of the polyline and add it
+            bool found = true;
+            while (found) {
+                found = false;
+                std::size_t front = findNearest(poly.front(), used);
+                if (front != NoPoint) {
+                    used[front / 2] = 1;
+                    poly.push_front(otherPoint(front));
+                    found = true;
+                }
+                std::size_t end = findNearest(poly.back(), used);
+                if (end != NoPoint) {
+                    used[end / 2] = 1;
+                    poly.push_back(otherPoint(end));
+                    found = true;
+                }
+            }
+
+            // skip polylines with too few length
+            if (poly.size() == 2 && Base::DistanceP2(poly[0], poly[1]) <= eps2)
+                continue;
+            polylines.emplace_back(poly.begin(), poly.end());
+        }
+    }
+
+private:
+    struct Cell
+    {
+        long long x, y, z;
+        bool operator == (const Cell& c) const
+        { return x == c.x && y == c.y && z == c.z; }
+    };
+    struct CellHash
+    {
+        std::size_t operator()(const Cell& c) const
+        {
+            std::size_t h = std::hash<long long>()(c.x);
+            h = h * 31 + std::hash<long long>()(c.y);
+            h = h * 31 + std::hash<long long>()(c.z);
+            return h;
+        }
+    };
+
+    long long toIndex(float coord) const
+    {
+        // clamp so that the conversion is defined for any input including inf and nan
+        double index = std::floor(double(coord) / double(cellSize));
+        if (!(index > -MaxIndex))
+            return static_cast<long long>(-MaxIndex);
+        if (!(index < MaxIndex))
+            return static_cast<long long>(MaxIndex);
+        return static_cast<long long>(index);
+    }
+    Cell toCell(const Base::Vector3f& p) const
+    {
+        return Cell{toIndex(p.x), toIndex(p.y), toIndex(p.z)};
+    }
+    const Base::Vector3f& point(std::size_t id) const
+    {
+        return (id % 2 == 0) ? lines[id / 2].first : lines[id / 2].second;
+    }
+    const Base::Vector3f& otherPoint(std::size_t id) const
+    {
+        return (id % 2 == 0) ? lines[id / 2].second : lines[id / 2].first;
+    }
+    std::size_t findNearest(const Base::Vector3f& pnt, const std::vector<char>& used) const
+    {
+        std::size_t nearest = NoPoint;
+        if (grid.empty())
+            return nearest;
+
+        float minDist = eps2;
+        Cell c = toCell(pnt);
+        for (long long i = -1; i <= 1; i++) {
+            for (long long j = -1; j <= 1; j++) {
+                for (long long k = -1; k <= 1; k++) {
+                    auto it = grid.find(Cell{c.x + i, c.y + j, c.z + k});
+                    if (it == grid.end())
+                        continue;
+                    for (std::size_t id : it->second) {
+                        if (used[id / 2])
+                            continue;
+                        float dist = Base::DistanceP2(pnt, point(id));
+                        if (dist < minDist) {
+                            minDist = dist;
+                            nearest = id;
+                        }
+                    }
+                }
+            }
+        }
+
+        return nearest;
+    }
+
+private:
+    static constexpr std::size_t NoPoint = static_cast<std::size_t>(-1);
+    static constexpr double MaxIndex = 1.0e15;
+    const std::vector<Line>& lines;
+    float eps2;
+    float cellSize;
+    std::unordered_map<Cell, std::vector<std::size_t>, CellHash> grid;
+};
+
+/*
+ * Closes the gaps between polylines: for each polyline a line from its front point to
+ * the nearest end point of another polyline is added if that one is closer than its own
+ * back point. Same as MeshAlgorithm::ConnectPolygons().
+ */
+void connectPolygons(const MeshSlicer::Polylines& polylines, std::vector<Line>& lines)
+{
+    for (auto outer = polylines.begin(); outer != polylines.end(); ++outer) {
+        if (outer->empty())
+            continue;
+        Line line(outer->front(), outer->back());
+        float dist = Base::Distance(outer->front(), outer->back());
+        for (auto inner = polylines.begin(); inner != polylines.end(); ++inner) {
+            if (outer == inner || inner->empty())
+                continue;
+            float distFront = Base::Distance(outer->front(), inner->front());
+            if (distFront < dist) {
+                line.second = inner->front();
+                dist = distFront;
+            }
+            float distBack = Base::Distance(outer->front(), inner->back());
+            if (distBack < dist) {
+                line.second = inner->back();
+                dist = distBack;
+            }
+        }
+        lines.push_back(line);
+    }
+}
+
+/*
+ * Intersects a triangle with the plane h = d where \a h are the heights of its corners
+ * along the plane normal. The cases are handled as in MeshGeomFacet::IntersectWithPlane().
+ * An edge is always interpolated from the point with the lower index so that neighbouring
+ * facets get exactly the same intersection point.
+ */
+bool intersectTriangle(const PointIndex* idx, const Base::Vector3f* p, const float* h,
+                       float d, float eps, Line& line)
+{
+    float s[3] = {h[0] - d, h[1] - d, h[2] - d};
+    bool on[3] = {std::fabs(s[0]) < eps, std::fabs(s[1]) < eps, std::fabs(s[2]) < eps};
+    auto crossing = [&](int a, int b, Base::Vector3f& res) {
+        if ((s[a] < 0.0f && s[b] > 0.0f) || (s[a] > 0.0f && s[b] < 0.0f)) {
+            if (idx[b] < idx[a])
+                std::swap(a, b);
+            res = p[a] + (p[b] - p[a]) * (s[a] / (s[a] - s[b]));
+            return true;
+        }
+        return false;
+    };
+
+    // first check if a triangle's edge lies on the plane
+    for (int i = 0; i < 3; i++) {
+        int j = (i + 1) % 3;
+        if (on[i] && on[j]) {
+            line.first = p[i];
+            line.second = p[j];
+            return true;
+        }
+    }
+
+    // now check if a triangle's corner lies on the plane
+    for (int i = 0; i < 3; i++) {
+        if (on[i]) {
+            line.first = p[i];
+            line.second = p[i];
+            crossing((i + 1) % 3, (i + 2) % 3, line.second);
+            return true;
+        }
+    }
+
+    // check for arbitrary intersections
+    Base::Vector3f pnt[3];
+    int num = 0;
+    for (int i = 0; i < 3; i++) {
+        if (crossing(i, (i + 1) % 3, pnt[num]))
+            num++;
+    }
+    if (num < 2)
+        return false;
+    line.first = pnt[0];
+    line.second = pnt[1];
+    return true;
+}
+
+}
+
+MeshSlicer::MeshSlicer(const MeshKernel& mesh)
+  : kernel(mesh), transform(false), threads(0)
+{
+}
+
+MeshSlicer::~MeshSlicer()
+{
+}
+
+void MeshSlicer::SetTransform(const Base::Matrix4D& mat)
+{
+    matrix = mat;
+    transform = !mat.isUnity();
+}
+
+void MeshSlicer::CutWithPlanes(const std::vector<Plane>& planes, std::vector<Polylines>& sections,
+                               float fMinEps, bool bConnectPolygons) const
+{
+    std::size_t offset = sections.size();
+    sections.resize(offset + planes.size());
+
+    // sweep all planes with the same normal at once
+    std::vector<char> done(planes.size(), 0);
+    for (std::size_t i = 0; i < planes.size(); i++) {
+        if (done[i])
+            continue;
+
+        Base::Vector3f normal = planes[i].second;
+        normal.Normalize();
+
+        std::vector<std::size_t> group;
+        std::vector<float> distances;
+        for (std::size_t j = i; j < planes.size(); j++) {
+            if (done[j])
+                continue;
+            Base::Vector3f n = planes[j].second;
+            n.Normalize();
+            if (n.x == normal.x && n.y == normal.y && n.z == normal.z) {
+                done[j] = 1;
+                group.push_back(j);
+                distances.push_back(n * planes[j].first);
+            }
+        }
+
+        std::vector<Polylines> result;
+        CutWithParallelPlanes(normal, distances, result, fMinEps, bConnectPolygons);
+        for (std::size_t j = 0; j < group.size(); j++)
+            sections[offset + group[j]].swap(result[j]);
+    }
+}
+
+void MeshSlicer::CutWithParallelPlanes(const Base::Vector3f& normal, const std::vector<float>& distances,
+                                       std::vector<Polylines>& sections,
+                                       float fMinEps, bool bConnectPolygons) const
+{
+    std::size_t offset = sections.size();
+    sections.resize(offset + distances.size());
+
+    Base::Vector3d worldNormal(normal.x, normal.y, normal.z);
+    if (distances.empty() || worldNormal.Length() == 0.0 || kernel.CountFacets() == 0)
+        return;
+    worldNormal.Normalize();
+
+    // Instead of transforming the points move the planes into the local system of the mesh:
+    // n * (A * p + t) = d  <=>  (A^T * n) * p = d - n * t
+    Base::Vector3d localNormal = worldNormal;
+    double shift = 0.0;
+    if (transform) {
+        for (int i = 0; i < 3; i++) {
+            localNormal[i] = matrix[0][i] * worldNormal.x
+                           + matrix[1][i] * worldNormal.y
+                           + matrix[2][i] * worldNormal.z;
+        }
+        shift = worldNormal.x * matrix[0][3] + worldNormal.y * matrix[1][3] + worldNormal.z * matrix[2][3];
+    }
+
+    double scale = localNormal.Length();
+    if (scale == 0.0)
+        return;
+    localNormal /= scale;
+
+    // the tolerance of MeshGeomFacet::IntersectWithPlane in global coordinates
+    float eps = static_cast<float>(1.0e-6 / scale);
+    std::vector<float> planeHeights(distances.size());
+    for (std::size_t i = 0; i < distances.size(); i++)
+        planeHeights[i] = static_cast<float>((double(distances[i]) - shift) / scale);
+
+    int numThreads = threads < 1 ? QThread::idealThreadCount() : threads;
+    const MeshPointArray& points = kernel.GetPoints();
+    const MeshFacetArray& facets = kernel.GetFacets();
+
+    // height of all points along the normal
+    std::vector<float> heights(points.size());
+    parallel_for(points.size(), numThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const MeshPoint& p = points[i];
+            heights[i] = static_cast<float>(localNormal.x * p.x + localNormal.y * p.y + localNormal.z * p.z);
+        }
+    });
+
+    // extent of all facets along the normal
+    std::vector<float> minHeight(facets.size()), maxHeight(facets.size());
+    parallel_for(facets.size(), numThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const PointIndex* idx = facets[i]._aulPoints;
+            float h0 = heights[idx[0]], h1 = heights[idx[1]], h2 = heights[idx[2]];
+            minHeight[i] = std::min(h0, std::min(h1, h2)) - eps;
+            maxHeight[i] = std::max(h0, std::max(h1, h2)) + eps;
+        }
+    });
+
+    // sort the facets and the planes once
+    std::vector<FacetIndex> sortedFacets(facets.size());
+    std::iota(sortedFacets.begin(), sortedFacets.end(), 0);
+    parallel_sort(sortedFacets.begin(), sortedFacets.end(), [&minHeight](FacetIndex a, FacetIndex b) {
+        return minHeight[a] < minHeight[b] || (minHeight[a] == minHeight[b] && a < b);
+    }, numThreads);
+
+    std::vector<std::size_t> sortedPlanes(distances.size());
+    std::iota(sortedPlanes.begin(), sortedPlanes.end(), 0);
+    std::stable_sort(sortedPlanes.begin(), sortedPlanes.end(), [&planeHeights](std::size_t a, std::size_t b) {
+        return planeHeights[a] < planeHeights[b];
+    });
+
+    // Each chunk of planes sweeps over the sorted facets and keeps the facets that span
+    // the current plane.
+    parallel_for(sortedPlanes.size(), numThreads, [&](std::size_t begin, std::size_t end) {
+        std::vector<FacetIndex> active, cut;
+        std::vector<Line> lines;
+        std::size_t next = 0;
+        for (std::size_t k = begin; k < end; k++) {
+            std::size_t plane = sortedPlanes[k];
+            float d = planeHeights[plane];
+            while (next < sortedFacets.size() && minHeight[sortedFacets[next]] <= d) {
+                active.push_back(sortedFacets[next]);
+                next++;
+            }
+            active.erase(std::remove_if(active.begin(), active.end(), [&maxHeight, d](FacetIndex f) {
+                return maxHeight[f] < d;
+            }), active.end());
+
+            // keep the order of MeshAlgorithm::CutWithPlane()
+            cut.assign(active.begin(), active.end());
+            std::sort(cut.begin(), cut.end());
+
+            lines.clear();
+            for (FacetIndex f : cut) {
+                const PointIndex* idx = facets[f]._aulPoints;
+                Base::Vector3f p[3] = {points[idx[0]], points[idx[1]], points[idx[2]]};
+                float h[3] = {heights[idx[0]], heights[idx[1]], heights[idx[2]]};
+                Line line;
+                if (intersectTriangle(idx, p, h, d, eps, line)) {
+                    if (transform) {
+                        line.first = matrix * line.first;
+                        line.second = matrix * line.second;
+                    }
+                    lines.push_back(line);
+                }
+            }
+
+            Polylines& section = sections[offset + plane];
+            if (bConnectPolygons) {
+                Polylines polylines;
+                ConnectLines(lines, polylines, fMinEps);
+                std::vector<Line> allLines;
+                connectPolygons(polylines, allLines);
+                allLines.insert(allLines.end(), lines.begin(), lines.end());
+                ConnectLines(allLines, section, fMinEps);
+            }
+            else {
+                ConnectLines(lines, section, fMinEps);
+            }
+        }
+    });
+}
+
+void MeshSlicer::ConnectLines(const std::vector<Line>& lines, Polylines& polylines, float fMinEps)
+{
+    LineJoiner joiner(lines, fMinEps);
+    joiner.Connect(polylines);
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_SLICER_H
+#define MESH_SLICER_H
+
+#include <list>
+#include <utility>
+#include <vector>
+#include <Base/Matrix.h>
+#include <Base/Vector3D.h>
+
+#include "Definitions.h"
+
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshSlicer class cuts a mesh with many planes at once. All planes with the same
+ * normal are handled in one sweep over the facets sorted by their extent along the normal
+ * so that each plane only tests the facets it actually crosses. The planes are processed
+ * in parallel chunks and the intersection lines of a plane are connected to polylines
+ * with a spatial hash instead of a linear search for each line.
+ *
+ * A transformation can be set which is applied to the points on the fly, the kernel
+ * itself is never copied or modified.
+ */
+class MeshExport MeshSlicer
+{
+public:
+    using Plane = std::pair<Base::Vector3f, Base::Vector3f>;
+    using Polylines = std::list<std::vector<Base::Vector3f> >;
+
+    explicit MeshSlicer(const MeshKernel& mesh);
+    ~MeshSlicer();
+
+    /// Sets the placement of the mesh. The resulting polylines are in global coordinates.
+    void SetTransform(const Base::Matrix4D& mat);
+    /// Sets the number of threads, a value of 0 or less uses all cores. The result does
+    /// not depend on the number of threads.
+    void SetThreads(int num)
+    { threads = num; }
+
+    /**
+     * Cuts the mesh with the planes given by base point and normal and appends one
+     * entry to \a sections for each plane. The meaning of \a fMinEps and
+     * \a bConnectPolygons is the same as for MeshAlgorithm::CutWithPlane().
+     */
+    void CutWithPlanes(const std::vector<Plane>& planes, std::vector<Polylines>& sections,
+                       float fMinEps = 1.0e-2f, bool bConnectPolygons = false) const;
+    /**
+     * Cuts the mesh with the parallel planes n*x = d for each d of \a distances and
+     * appends one entry to \a sections for each plane.
+     */
+    void CutWithParallelPlanes(const Base::Vector3f& normal, const std::vector<float>& distances,
+                               std::vector<Polylines>& sections,
+                               float fMinEps = 1.0e-2f, bool bConnectPolygons = false) const;
+    /**
+     * Connects the lines \a lines to polylines. Lines shorter than \a fMinEps / sqrt(10)
+     * are skipped and two lines are joined if their end points are closer than \a fMinEps.
+     */
+    static void ConnectLines(const std::vector<std::pair<Base::Vector3f, Base::Vector3f> >& lines,
+                             Polylines& polylines, float fMinEps);
+
+private:
+    const MeshKernel& kernel;
+    Base::Matrix4D matrix;
+    bool transform;
+    int threads;
+};
+
+} // namespace MeshCore
+
+#endif // MESH_SLICER_H
@@ -27,17 +27,96 @@
 #include "Smoothing.h"
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
 
 
 using namespace MeshCore;
 
+namespace {
+/*
+ * Compressed copy of a neighbourhood structure which is used by the parallel
+ * smoothing kernels. Unlike the std::set based structures it can be traversed
+ * without any pointer chasing.
+ */
+class FlatNeighbourhood
+{
+public:
+    template <class Ref>
+    void Build(const Ref& ref, std::size_t count)
+    {
+        offsets.clear();
+        indices.clear();
+        offsets.reserve(count + 1);
+        offsets.push_back(0);
+        for (std::size_t i = 0; i < count; i++) {
+            const auto& nb = ref[i];
+            indices.insert(indices.end(), nb.begin(), nb.end());
+            offsets.push_back(indices.size());
+        }
+    }
+    std::size_t Count(std::size_t pos) const {
+        return offsets[pos + 1] - offsets[pos];
+    }
+    const ElementIndex* Begin(std::size_t pos) const {
+        return indices.data() + offsets[pos];
+    }
+    const ElementIndex* End(std::size_t pos) const {
+        return indices.data() + offsets[pos + 1];
+    }
+
+private:
+    std::vector<std::size_t> offsets;
+    std::vector<ElementIndex> indices;
+};
+
+std::vector<Base::Vector3f> copyPoints(const MeshKernel& kernel)
+{
+    const MeshPointArray& points = kernel.GetPoints();
+    std::vector<Base::Vector3f> coords(points.begin(), points.end());
+    return coords;
+}
+
+void assignPoints(MeshKernel& kernel, const std::vector<Base::Vector3f>& coords,
+                  const std::vector<PointIndex>* point_indices)
+{
+    if (point_indices) {
+        for (auto pos : *point_indices)
+            kernel.SetPoint(pos, coords[pos]);
+    }
+    else {
+        PointIndex count = kernel.CountPoints();
+        for (PointIndex pos = 0; pos < count; pos++)
+            kernel.SetPoint(pos, coords[pos]);
+    }
+}
+
+// Calls func for all points or the given subset of points in several threads
+template <class Func>
+void forEachPoint(std::size_t count, const std::vector<PointIndex>* point_indices, int threads, Func func)
+{
+    if (point_indices) {
+        parallel_for(point_indices->size(), threads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                func((*point_indices)[i]);
+        });
+    }
+    else {
+        parallel_for(count, threads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                func(static_cast<PointIndex>(i));
+        });
+    }
+}
+}
+
 
 AbstractSmoothing::AbstractSmoothing(MeshKernel& m)
   : kernel(m)
   , component(Normal)
   , continuity(C0)
+  , threads(1)
 {
 }
 
@@ -63,6 +142,11 @@ PlaneFitSmoothing::~PlaneFitSmoothing()
 
 void PlaneFitSmoothing::Smooth(unsigned int iterations)
 {
+    if (threads != 1) {
+        SmoothParallel(iterations, nullptr);
+        return;
+    }
+
     MeshCore::MeshPoint center;
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
 
@@ -116,6 +200,11 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
 
 void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<PointIndex>& point_indices)
 {
+    if (threads != 1) {
+        SmoothParallel(iterations, &point_indices);
+        return;
+    }
+
     MeshCore::MeshPoint center;
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
 
@@ -168,6 +257,56 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<
     }
 }
 
+void PlaneFitSmoothing::SmoothParallel(unsigned int iterations, const std::vector<PointIndex>* point_indices)
+{
+    FlatNeighbourhood neighbours;
+    neighbours.Build(MeshRefPointToPoints(kernel), kernel.CountPoints());
+
+    std::vector<Base::Vector3f> current = copyPoints(kernel);
+    std::vector<Base::Vector3f> next = current;
+
+    for (unsigned int i=0; i<iterations; i++) {
+        forEachPoint(current.size(), point_indices, threads, [&](PointIndex pos) {
+            const Base::Vector3f& pnt = current[pos];
+            next[pos] = pnt;
+            std::size_t count = neighbours.Count(pos);
+            if (count < 3)
+                return;
+
+            MeshCore::PlaneFit pf;
+            pf.AddPoint(pnt);
+            Base::Vector3f center = pnt;
+            for (const ElementIndex* it = neighbours.Begin(pos); it != neighbours.End(pos); ++it) {
+                pf.AddPoint(current[*it]);
+                center += current[*it];
+            }
+
+            float scale = 1.0f/(static_cast<float>(count)+1.0f);
+            center.Scale(scale,scale,scale);
+
+            // get the mean plane of the current vertex with the surrounding vertices
+            pf.Fit();
+            Base::Vector3f N = pf.GetNormal();
+            N.Normalize();
+
+            // look in which direction we should move the vertex
+            Base::Vector3f L = pnt - center;
+            if (N*L < 0.0f)
+                N.Scale(-1.0, -1.0, -1.0);
+
+            // maximum value to move is distance to mean plane
+            float d = std::min<float>(fabs(this->maximum),fabs(N*L));
+            N.Scale(d,d,d);
+
+            next[pos] = pnt - N;
+        });
+
+        current.swap(next);
+    }
+
+    assignPoints(kernel, current, point_indices);
+}
+
 LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
   : AbstractSmoothing(m), lambda(0.6307)
 {
@@ -248,8 +387,65 @@ void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
     }
 }
 
+void LaplaceSmoothing::UmbrellaParallel(unsigned int iterations,
+                                        const std::vector<double>& stepsizes,
+                                        const std::vector<PointIndex>* point_indices)
+{
+    PointIndex numPoints = kernel.CountPoints();
+    FlatNeighbourhood neighbours;
+    std::vector<char> fixed(numPoints);
+    {
+        MeshCore::MeshRefPointToPoints vv_it(kernel);
+        MeshCore::MeshRefPointToFacets vf_it(kernel);
+        neighbours.Build(vv_it, numPoints);
+
+        // do nothing for border points
+        for (PointIndex pos = 0; pos < numPoints; pos++) {
+            const std::set<PointIndex>& cv = vv_it[pos];
+            fixed[pos] = (cv.size() < 3 || cv.size() != vf_it[pos].size()) ? 1 : 0;
+        }
+    }
+
+    std::vector<Base::Vector3f> current = copyPoints(kernel);
+    std::vector<Base::Vector3f> next = current;
+
+    for (unsigned int i=0; i<iterations; i++) {
+        for (double stepsize : stepsizes) {
+            forEachPoint(numPoints, point_indices, threads, [&](PointIndex pos) {
+                const Base::Vector3f& pnt = current[pos];
+                if (fixed[pos]) {
+                    next[pos] = pnt;
+                    return;
+                }
+
+                double w = 1.0/double(neighbours.Count(pos));
+                double delx=0.0,dely=0.0,delz=0.0;
+                for (const ElementIndex* it = neighbours.Begin(pos); it != neighbours.End(pos); ++it) {
+                    const Base::Vector3f& nb = current[*it];
+                    delx += w*static_cast<double>(nb.x-pnt.x);
+                    dely += w*static_cast<double>(nb.y-pnt.y);
+                    delz += w*static_cast<double>(nb.z-pnt.z);
+                }
+
+                next[pos].Set(static_cast<float>(static_cast<double>(pnt.x)+stepsize*delx),
+                              static_cast<float>(static_cast<double>(pnt.y)+stepsize*dely),
+                              static_cast<float>(static_cast<double>(pnt.z)+stepsize*delz));
+            });
+
+            current.swap(next);
+        }
+    }
+
+    assignPoints(kernel, current, point_indices);
+}
+
 void LaplaceSmoothing::Smooth(unsigned int iterations)
 {
+    if (threads != 1) {
+        UmbrellaParallel(iterations, {lambda}, nullptr);
+        return;
+    }
+
     MeshCore::MeshRefPointToPoints vv_it(kernel);
     MeshCore::MeshRefPointToFacets vf_it(kernel);
 
@@ -260,6 +456,11 @@ void LaplaceSmoothing::Smooth(unsigned int iterations)
 
 void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<PointIndex>& point_indices)
 {
+    if (threads != 1) {
+        UmbrellaParallel(iterations, {lambda}, &point_indices);
+        return;
+    }
+
     MeshCore::MeshRefPointToPoints vv_it(kernel);
     MeshCore::MeshRefPointToFacets vf_it(kernel);
 
@@ -279,11 +480,16 @@ TaubinSmoothing::~TaubinSmoothing()
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
+    // Theoretically Taubin does not shrink the surface
+    iterations = (iterations+1)/2; // two steps per iteration
+    if (threads != 1) {
+        UmbrellaParallel(iterations, {lambda, -(lambda+micro)}, nullptr);
+        return;
+    }
+
     MeshCore::MeshRefPointToPoints vv_it(kernel);
     MeshCore::MeshRefPointToFacets vf_it(kernel);
 
-    // Theoretically Taubin does not shrink the surface
-    iterations = (iterations+1)/2; // two steps per iteration
     for (unsigned int i=0; i<iterations; i++) {
         Umbrella(vv_it, vf_it, lambda);
         Umbrella(vv_it, vf_it, -(lambda+micro));
@@ -292,11 +498,16 @@ void TaubinSmoothing::Smooth(unsigned int iterations)
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations, const std::vector<PointIndex>& point_indices)
 {
+    // Theoretically Taubin does not shrink the surface
+    iterations = (iterations+1)/2; // two steps per iteration
+    if (threads != 1) {
+        UmbrellaParallel(iterations, {lambda, -(lambda+micro)}, &point_indices);
+        return;
+    }
+
     MeshCore::MeshRefPointToPoints vv_it(kernel);
     MeshCore::MeshRefPointToFacets vf_it(kernel);
 
-    // Theoretically Taubin does not shrink the surface
-    iterations = (iterations+1)/2; // two steps per iteration
     for (unsigned int i=0; i<iterations; i++) {
         Umbrella(vv_it, vf_it, lambda, point_indices);
         Umbrella(vv_it, vf_it, -(lambda+micro), point_indices);
@@ -337,6 +548,11 @@ MedianFilterSmoothing::~MedianFilterSmoothing()
 
 void MedianFilterSmoothing::Smooth(unsigned int iterations)
 {
+    if (threads != 1) {
+        SmoothParallel(iterations, nullptr);
+        return;
+    }
+
     std::vector<unsigned long> point_indices(kernel.CountPoints());
     std::generate(point_indices.begin(), point_indices.end(), Base::iotaGen<unsigned long>(0));
     MeshCore::MeshRefFacetToFacets ff_it(kernel);
@@ -349,6 +565,11 @@ void MedianFilterSmoothing::Smooth(unsigned int iterations)
 
 void MedianFilterSmoothing::SmoothPoints(unsigned int iterations, const std::vector<PointIndex>& point_indices)
 {
+    if (threads != 1) {
+        SmoothParallel(iterations, &point_indices);
+        return;
+    }
+
     MeshCore::MeshRefFacetToFacets ff_it(kernel);
     MeshCore::MeshRefPointToFacets vf_it(kernel);
 
@@ -427,3 +648,94 @@ void MedianFilterSmoothing::UpdatePoints(const MeshRefFacetToFacets& ff_it,
         kernel.SetPoint(pos, Base::toVector<float>(P));
     }
 }
+
+void MedianFilterSmoothing::SmoothParallel(unsigned int iterations,
+                                           const std::vector<PointIndex>* point_indices)
+{
+    const MeshCore::MeshFacetArray& facets = kernel.GetFacets();
+    FlatNeighbourhood ff_it, vf_it;
+    ff_it.Build(MeshRefFacetToFacets(kernel), facets.size());
+    vf_it.Build(MeshRefPointToFacets(kernel), kernel.CountPoints());
+
+    std::vector<Base::Vector3f> current = copyPoints(kernel);
+    std::vector<Base::Vector3f> next = current;
+    std::vector<Base::Vector3d> realNormals(facets.size());
+    std::vector<Base::Vector3d> faceNormals(facets.size());
+
+    auto getFacet = [&](FacetIndex index) {
+        const MeshFacet& face = facets[index];
+        return MeshGeomFacet(current[face._aulPoints[0]],
+                             current[face._aulPoints[1]],
+                             current[face._aulPoints[2]]);
+    };
+
+    for (unsigned int i=0; i<iterations; i++) {
+        parallel_for(facets.size(), threads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t pos = begin; pos < end; pos++)
+                realNormals[pos] = Base::toVector<double>(getFacet(pos).GetNormal());
+        });
+
+        // Step 1: determine face normals
+        parallel_for(facets.size(), threads, [&](std::size_t begin, std::size_t end) {
+            std::vector<AngleNormal> anglesWithFaces;
+            for (std::size_t pos = begin; pos < end; pos++) {
+                const Base::Vector3d& refNormal = realNormals[pos];
+                const MeshCore::MeshFacet& facet = facets[pos];
+
+                anglesWithFaces.clear();
+                for (const ElementIndex* it = ff_it.Begin(pos); it != ff_it.End(pos); ++it) {
+                    FacetIndex fi = *it;
+                    const Base::Vector3d& faceNormal = realNormals[fi];
+                    double angle = refNormal.GetAngle(faceNormal);
+
+                    int absWeight = std::abs(weights);
+                    if (absWeight > 1 && facet.IsNeighbour(fi)) {
+                        if (weights < 0) {
+                            angle = -angle;
+                        }
+                        for (int j = 0; j < absWeight; j++) {
+                            anglesWithFaces.emplace_back(angle, faceNormal);
+                        }
+                    }
+                    else {
+                        anglesWithFaces.emplace_back(angle, faceNormal);
+                    }
+                }
+
+                if (anglesWithFaces.empty())
+                    faceNormals[pos] = refNormal;
+                else
+                    faceNormals[pos] = find_median(anglesWithFaces);
+            }
+        });
+
+        // Step 2: move vertices
+        forEachPoint(current.size(), point_indices, threads, [&](PointIndex pos) {
+            Base::Vector3d P = Base::toVector<double>(current[pos]);
+
+            double totalArea = 0.0;
+            Base::Vector3d totalvT;
+            for (const ElementIndex* it = vf_it.Begin(pos); it != vf_it.End(pos); ++it) {
+                MeshGeomFacet face = getFacet(*it);
+
+                double faceArea = face.Area();
+                totalArea += faceArea;
+
+                Base::Vector3d C = Base::toVector<double>(face.GetGravityPoint());
+
+                Base::Vector3d PC = C - P;
+                Base::Vector3d mT = faceNormals[*it];
+                Base::Vector3d vT = (PC * mT) * mT;
+                totalvT += vT * faceArea;
+            }
+
+            if (totalArea > 0.0)
+                P = P + totalvT / totalArea;
+            next[pos] = Base::toVector<float>(P);
+        });
+
+        current.swap(next);
+    }
+
+    assignPoints(kernel, current, point_indices);
+}
@@ -54,6 +54,14 @@ public:
     explicit AbstractSmoothing(MeshKernel&);
     virtual ~AbstractSmoothing();
     void initialize(Component comp, Continuity cont);
+    /** Sets the number of threads. With a value other than 1 all points of an
+     * iteration are moved based on the positions of the previous iteration
+     * (Jacobi-style) which allows to process them concurrently.
+     * A value of 0 uses all available cores. The default is 1.
+     */
+    void SetThreads(int num) {
+        threads = num;
+    }
 
     /** Smooth the triangle mesh. */
     virtual void Smooth(unsigned int) = 0;
@@ -64,6 +72,7 @@ protected:
 
     Component   component;
     Continuity  continuity;
+    int         threads;
 };
 
 class MeshExport PlaneFitSmoothing : public AbstractSmoothing
@@ -77,6 +86,9 @@ public:
     void Smooth(unsigned int) override;
     void SmoothPoints(unsigned int, const std::vector<PointIndex>&) override;
 
+private:
+    void SmoothParallel(unsigned int, const std::vector<PointIndex>*);
+
 private:
     float maximum;
 };
@@ -96,6 +108,8 @@ protected:
     void Umbrella(const MeshRefPointToPoints&,
                   const MeshRefPointToFacets&, double,
                   const std::vector<PointIndex>&);
+    void UmbrellaParallel(unsigned int, const std::vector<double>&,
+                          const std::vector<PointIndex>*);
 
 protected:
     double lambda;
@@ -134,6 +148,7 @@ private:
     void UpdatePoints(const MeshRefFacetToFacets&,
                       const MeshRefPointToFacets&,
                       const std::vector<PointIndex>&);
+    void SmoothParallel(unsigned int, const std::vector<PointIndex>*);
 
 private:
     int weights;
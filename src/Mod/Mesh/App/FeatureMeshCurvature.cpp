@@ -58,6 +58,7 @@ App::DocumentObjectExecReturn *Curvature::execute()
     // get all points
     const MeshCore::MeshKernel& rMesh = pcFeat->Mesh.getValue().getKernel();
     MeshCore::MeshCurvature meshCurv(rMesh);
+    meshCurv.SetThreads(0);
     meshCurv.ComputePerVertex();
     const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
 
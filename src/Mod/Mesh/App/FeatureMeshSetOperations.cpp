@@ -39,6 +39,9 @@ SetOperations::SetOperations()
     ADD_PROPERTY(Source1, (nullptr));
     ADD_PROPERTY(Source2, (nullptr));
     ADD_PROPERTY(OperationType, ("union"));
+    ADD_PROPERTY_TYPE(Robust, (false), nullptr, App::Prop_None,
+                      "Use exact predicates to decide on which side of each other two facets lie.\n"
+                      "The intersection points themselves are still computed in floating point.");
 }
 
 short SetOperations::mustExecute() const
@@ -50,6 +53,8 @@ short SetOperations::mustExecute() const
             return 1;
         if (OperationType.isTouched())
             return 1;
+        if (Robust.isTouched())
+            return 1;
     }
 
     return 0;
@@ -84,6 +89,8 @@ App::DocumentObjectExecReturn *SetOperations::execute()
 
         MeshCore::SetOperations setOp(meshKernel1.getKernel(), meshKernel2.getKernel(),
             pcKernel->getKernel(), type, 1.0e-5f);
+        setOp.SetThreads(MeshObject::booleanThreads());
+        setOp.SetRobust(Robust.getValue());
         setOp.Do();
         Mesh.setValuePtr(pcKernel.release());
     }
@@ -46,6 +46,7 @@ public:
     App::PropertyLink   Source1;
     App::PropertyLink   Source2;
     App::PropertyString OperationType;
+    App::PropertyBool   Robust;
 
     /** @name methods override Feature */
     //@{
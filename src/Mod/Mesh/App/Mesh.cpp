@@ -26,11 +26,13 @@
 # include <sstream>
 #endif
 
+#include <App/Application.h>
 #include <Base/Builder3D.h>
 #include <Base/Console.h>
 #include <Base/Converter.h>
 #include <Base/Exception.h>
 #include <Base/Interpreter.h>
+#include <Base/Parallel.h>
 #include <Base/Reader.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
@@ -47,6 +49,8 @@
 #include "Core/MeshKernel.h"
 #include "Core/Segmentation.h"
 #include "Core/SetOperations.h"
+#include "Core/Slicer.h"
+#include "Core/Smoothing.h"
 #include "Core/TopoAlgorithm.h"
 #include "Core/Trim.h"
 #include "Core/TrimByPlane.h"
@@ -365,9 +369,10 @@ void MeshObject::RestoreDocFile(Base::Reader &reader)
 
 void MeshObject::save(const char* file, MeshCore::MeshIO::Format f,
                       const MeshCore::Material* mat,
-                      const char* objectname) const
+                      const char* objectname, int threads) const
 {
     MeshCore::MeshOutput aWriter(this->_kernel, mat);
+    aWriter.SetThreads(threads);
     if (objectname)
         aWriter.SetObjectName(objectname);
 
@@ -394,9 +399,10 @@ void MeshObject::save(const char* file, MeshCore::MeshIO::Format f,
 
 void MeshObject::save(std::ostream& str, MeshCore::MeshIO::Format f,
                       const MeshCore::Material* mat,
-                      const char* objectname) const
+                      const char* objectname, int threads) const
 {
     MeshCore::MeshOutput aWriter(this->_kernel, mat);
+    aWriter.SetThreads(threads);
     if (objectname)
         aWriter.SetObjectName(objectname);
 
@@ -1027,9 +1033,24 @@ void MeshObject::setPoint(PointIndex index, const Base::Vector3d& p)
     _kernel.SetPoint(index, transformPointToInside(p));
 }
 
-void MeshObject::smooth(int iterations, float d_max)
+void MeshObject::smooth(int iterations, float d_max, int threads)
 {
-    _kernel.Smooth(iterations, d_max);
+    MeshCore::MeshPointArray points = _kernel.GetPoints();
+    MeshCore::LaplaceSmoothing smooth(_kernel);
+    smooth.SetThreads(threads);
+    smooth.Smooth(iterations);
+
+    // pull back the points that moved further than d_max
+    if (d_max > 0.0f) {
+        PointIndex count = _kernel.CountPoints();
+        for (PointIndex index = 0; index < count; index++) {
+            Base::Vector3f move = _kernel.GetPoint(index) - points[index];
+            float dist = move.Length();
+            if (dist > d_max) {
+                _kernel.SetPoint(index, points[index] + move * (d_max / dist));
+            }
+        }
+    }
 }
 
 void MeshObject::decimate(float fTolerance, float fReduction)
@@ -1044,6 +1065,17 @@ void MeshObject::decimate(int targetSize)
     dm.simplify(targetSize);
 }
 
+void MeshObject::decimate(int targetSize, float maxError, unsigned long partitionSize, bool parallel)
+{
+    MeshCore::MeshSimplify dm(this->_kernel);
+    dm.setPartitionSize(partitionSize);
+    dm.setParallel(parallel);
+    if (maxError > 0.0f)
+        dm.simplifyToError(maxError, targetSize);
+    else
+        dm.simplify(targetSize);
+}
+
 Base::Vector3d MeshObject::getPointNormal(PointIndex index) const
 {
     std::vector<Base::Vector3f> temp = _kernel.CalcVertexNormals();
@@ -1066,16 +1098,9 @@ std::vector<Base::Vector3d> MeshObject::getPointNormals() const
 void MeshObject::crossSections(const std::vector<MeshObject::TPlane>& planes, std::vector<MeshObject::TPolylines> &sections,
                                float fMinEps, bool bConnectPolygons) const
 {
-    MeshCore::MeshKernel kernel(this->_kernel);
-    kernel.Transform(this->_Mtrx);
-
-    MeshCore::MeshFacetGrid grid(kernel);
-    MeshCore::MeshAlgorithm algo(kernel);
-    for (std::vector<MeshObject::TPlane>::const_iterator it = planes.begin(); it != planes.end(); ++it) {
-        MeshObject::TPolylines polylines;
-        algo.CutWithPlane(it->first, it->second, grid, polylines, fMinEps, bConnectPolygons);
-        sections.push_back(polylines);
-    }
+    MeshCore::MeshSlicer slicer(this->_kernel);
+    slicer.SetTransform(this->_Mtrx);
+    slicer.CutWithPlanes(planes, sections, fMinEps, bConnectPolygons);
 }
 
 void MeshObject::cut(const Base::Polygon2d& polygon2d,
@@ -1164,7 +1189,14 @@ void MeshObject::trimByPlane(const Base::Vector3f& base, const Base::Vector3f& n
         this->_kernel.AddFacets(triangle);
 }
 
-MeshObject* MeshObject::unite(const MeshObject& mesh) const
+int MeshObject::booleanThreads()
+{
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Mesh");
+    return Base::idealThreadCount(static_cast<int>(hGrp->GetInt("BooleanThreads", 0)));
+}
+
+MeshObject* MeshObject::unite(const MeshObject& mesh, bool robust) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1173,11 +1205,13 @@ MeshObject* MeshObject::unite(const MeshObject& mesh) const
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
                                   MeshCore::SetOperations::Union, Epsilon);
+    setOp.SetThreads(booleanThreads());
+    setOp.SetRobust(robust);
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::intersect(const MeshObject& mesh) const
+MeshObject* MeshObject::intersect(const MeshObject& mesh, bool robust) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1186,11 +1220,13 @@ MeshObject* MeshObject::intersect(const MeshObject& mesh) const
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
                                   MeshCore::SetOperations::Intersect, Epsilon);
+    setOp.SetThreads(booleanThreads());
+    setOp.SetRobust(robust);
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::subtract(const MeshObject& mesh) const
+MeshObject* MeshObject::subtract(const MeshObject& mesh, bool robust) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1199,11 +1235,13 @@ MeshObject* MeshObject::subtract(const MeshObject& mesh) const
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
                                   MeshCore::SetOperations::Difference, Epsilon);
+    setOp.SetThreads(booleanThreads());
+    setOp.SetRobust(robust);
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::inner(const MeshObject& mesh) const
+MeshObject* MeshObject::inner(const MeshObject& mesh, bool robust) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1212,11 +1250,13 @@ MeshObject* MeshObject::inner(const MeshObject& mesh) const
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
                                   MeshCore::SetOperations::Inner, Epsilon);
+    setOp.SetThreads(booleanThreads());
+    setOp.SetRobust(robust);
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::outer(const MeshObject& mesh) const
+MeshObject* MeshObject::outer(const MeshObject& mesh, bool robust) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1225,6 +1265,8 @@ MeshObject* MeshObject::outer(const MeshObject& mesh) const
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
                                   MeshCore::SetOperations::Outer, Epsilon);
+    setOp.SetThreads(booleanThreads());
+    setOp.SetRobust(robust);
     setOp.Do();
     return new MeshObject(result);
 }
@@ -1967,13 +2009,15 @@ MeshObject* MeshObject::meshFromSegment(const std::vector<FacetIndex>& indices)
 }
 
 std::vector<Segment> MeshObject::getSegmentsOfType(MeshObject::GeometryType type,
-                                                   float dev, unsigned long minFacets) const
+                                                   float dev, unsigned long minFacets,
+                                                   int threads) const
 {
     std::vector<Segment> segm;
     if (this->_kernel.CountFacets() == 0)
         return segm;
 
     MeshCore::MeshSegmentAlgorithm finder(this->_kernel);
+    finder.SetThreads(threads);
     std::shared_ptr<MeshCore::MeshDistanceSurfaceSegment> surf;
     switch (type) {
     case PLANE:
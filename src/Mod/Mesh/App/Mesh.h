@@ -175,12 +175,15 @@ public:
     void SaveDocFile (Base::Writer &writer) const override;
     void Restore(Base::XMLReader &reader) override;
     void RestoreDocFile(Base::Reader &reader) override;
+    /** Writes the mesh in the given format. The mesh data of most formats is encoded
+     * in \a threads threads, 0 uses all available cores.
+     */
     void save(const char* file,MeshCore::MeshIO::Format f=MeshCore::MeshIO::Undefined,
         const MeshCore::Material* mat = nullptr,
-        const char* objectname = nullptr) const;
+        const char* objectname = nullptr, int threads = 0) const;
     void save(std::ostream&,MeshCore::MeshIO::Format f,
         const MeshCore::Material* mat = nullptr,
-        const char* objectname = nullptr) const;
+        const char* objectname = nullptr, int threads = 0) const;
     bool load(const char* file, MeshCore::Material* mat = nullptr);
     bool load(std::istream&, MeshCore::MeshIO::Format f, MeshCore::Material* mat = nullptr);
     // Save and load in internal format
@@ -239,9 +242,18 @@ public:
     Base::Matrix4D getEigenSystem(Base::Vector3d& v) const;
     void movePoint(PointIndex, const Base::Vector3d& v);
     void setPoint(PointIndex, const Base::Vector3d& v);
-    void smooth(int iterations, float d_max);
+    /** Smooths the mesh with the Laplace algorithm. No point is moved further than
+     * \a d_max from where it was before. With a \a threads value other than 1
+     * the points are moved concurrently, 0 uses all available cores.
+     */
+    void smooth(int iterations, float d_max, int threads = 1);
     void decimate(float fTolerance, float fReduction);
     void decimate(int targetSize);
+    /** Decimates the mesh until \a targetSize facets are left or no further edge can be
+     * collapsed without exceeding \a maxError. A value of 0 disables the corresponding limit.
+     * Meshes with more than \a partitionSize facets are decimated in spatial partitions.
+     */
+    void decimate(int targetSize, float maxError, unsigned long partitionSize, bool parallel);
     Base::Vector3d getPointNormal(PointIndex) const;
     std::vector<Base::Vector3d> getPointNormals() const;
     void crossSections(const std::vector<TPlane>&, std::vector<TPolylines> &sections,
@@ -271,11 +283,15 @@ public:
 
     /** @name Boolean operations */
     //@{
-    MeshObject* unite(const MeshObject&) const;
-    MeshObject* intersect(const MeshObject&) const;
-    MeshObject* subtract(const MeshObject&) const;
-    MeshObject* inner(const MeshObject&) const;
-    MeshObject* outer(const MeshObject&) const;
+    /** Returns the number of threads the boolean operations use. It is taken from the
+     * BooleanThreads parameter of the Mesh module, 0 or less uses all available cores.
+     */
+    static int booleanThreads();
+    MeshObject* unite(const MeshObject&, bool robust = false) const;
+    MeshObject* intersect(const MeshObject&, bool robust = false) const;
+    MeshObject* subtract(const MeshObject&, bool robust = false) const;
+    MeshObject* inner(const MeshObject&, bool robust = false) const;
+    MeshObject* outer(const MeshObject&, bool robust = false) const;
     std::vector< std::vector<Base::Vector3f> > section(const MeshObject&, bool connectLines, float fMinDist) const;
     //@}
 
@@ -335,7 +351,8 @@ public:
     const Segment& getSegment(unsigned long) const;
     Segment& getSegment(unsigned long);
     MeshObject* meshFromSegment(const std::vector<FacetIndex>&) const;
-    std::vector<Segment> getSegmentsOfType(GeometryType, float dev, unsigned long minFacets) const;
+    std::vector<Segment> getSegmentsOfType(GeometryType, float dev, unsigned long minFacets,
+                                           int threads = 1) const;
     //@}
 
     /** @name Primitives */
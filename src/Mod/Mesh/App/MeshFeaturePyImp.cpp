@@ -69,13 +69,14 @@ PyObject*  MeshFeaturePy::smooth(PyObject *args)
 {
     int iter=1;
     float d_max=FLOAT_MAX;
-    if (!PyArg_ParseTuple(args, "|if", &iter,&d_max))
+    int threads=1;
+    if (!PyArg_ParseTuple(args, "|ifi", &iter,&d_max,&threads))
         return nullptr;
 
     PY_TRY {
         Mesh::Feature* obj = getFeaturePtr();
         MeshObject* kernel = obj->Mesh.startEditing();
-        kernel->smooth(iter, d_max);
+        kernel->smooth(iter, d_max, threads);
         obj->Mesh.finishEditing();
     } PY_CATCH;
 
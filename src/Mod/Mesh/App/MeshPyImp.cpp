@@ -189,6 +189,7 @@ PyObject*  MeshPy::write(PyObject *args, PyObject *kwds)
     char* Ext=nullptr;
     char* ObjName=nullptr;
     PyObject* List=nullptr;
+    int threads=0;
 
     MeshCore::MeshIO::Format format = MeshCore::MeshIO::Undefined;
     std::map<std::string, MeshCore::MeshIO::Format> ext;
@@ -215,9 +216,9 @@ PyObject*  MeshPy::write(PyObject *args, PyObject *kwds)
     ext["ASY"  ] = MeshCore::MeshIO::ASY;
     ext["3MF"  ] = MeshCore::MeshIO::ThreeMF;
 
-    static char* keywords_path[] = {"Filename","Format","Name","Material",nullptr};
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "et|ssO", keywords_path, "utf-8",
-                                    &Name, &Ext, &ObjName, &List)) {
+    static char* keywords_path[] = {"Filename","Format","Name","Material","Threads",nullptr};
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "et|ssOi", keywords_path, "utf-8",
+                                    &Name, &Ext, &ObjName, &List, &threads)) {
         if (Ext) {
             std::string fmt(Ext);
             boost::to_upper(fmt);
@@ -243,10 +244,10 @@ PyObject*  MeshPy::write(PyObject *args, PyObject *kwds)
                 mat.binding = MeshCore::MeshIO::PER_FACE;
             else
                 mat.binding = MeshCore::MeshIO::OVERALL;
-            getMeshObjectPtr()->save(Name, format, &mat, ObjName);
+            getMeshObjectPtr()->save(Name, format, &mat, ObjName, threads);
         }
         else {
-            getMeshObjectPtr()->save(Name, format, nullptr, ObjName);
+            getMeshObjectPtr()->save(Name, format, nullptr, ObjName, threads);
         }
 
         PyMem_Free(Name);
@@ -255,10 +256,10 @@ PyObject*  MeshPy::write(PyObject *args, PyObject *kwds)
 
     PyErr_Clear();
 
-    static char* keywords_stream[] = {"Stream","Format","Name","Material",nullptr};
+    static char* keywords_stream[] = {"Stream","Format","Name","Material","Threads",nullptr};
     PyObject* input;
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "Os|sO", keywords_stream,
-                                    &input, &Ext, &ObjName, &List)) {
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "Os|sOi", keywords_stream,
+                                    &input, &Ext, &ObjName, &List, &threads)) {
         std::string fmt(Ext);
         boost::to_upper(fmt);
         if (ext.find(fmt) != ext.end()) {
@@ -289,7 +290,7 @@ PyObject*  MeshPy::write(PyObject *args, PyObject *kwds)
         Base::PyStreambuf buf(input);
         std::ostream str(nullptr);
         str.rdbuf(&buf);
-        getMeshObjectPtr()->save(str, format, mat.get(), ObjName);
+        getMeshObjectPtr()->save(str, format, mat.get(), ObjName, threads);
 
         Py_Return;
     }
@@ -401,13 +402,14 @@ PyObject*  MeshPy::unite(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))
+    PyObject *robust = Py_False;
+    if (!PyArg_ParseTuple(args, "O!|O!", &(MeshPy::Type), &pcObj, &PyBool_Type, &robust))
         return nullptr;
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->unite(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->unite(*pcObject->getMeshObjectPtr(), Base::asBoolean(robust));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -418,13 +420,14 @@ PyObject*  MeshPy::intersect(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))
+    PyObject *robust = Py_False;
+    if (!PyArg_ParseTuple(args, "O!|O!", &(MeshPy::Type), &pcObj, &PyBool_Type, &robust))
         return nullptr;
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->intersect(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->intersect(*pcObject->getMeshObjectPtr(), Base::asBoolean(robust));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -435,13 +438,14 @@ PyObject*  MeshPy::difference(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))
+    PyObject *robust = Py_False;
+    if (!PyArg_ParseTuple(args, "O!|O!", &(MeshPy::Type), &pcObj, &PyBool_Type, &robust))
         return nullptr;
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->subtract(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->subtract(*pcObject->getMeshObjectPtr(), Base::asBoolean(robust));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -452,13 +456,14 @@ PyObject*  MeshPy::inner(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))
+    PyObject *robust = Py_False;
+    if (!PyArg_ParseTuple(args, "O!|O!", &(MeshPy::Type), &pcObj, &PyBool_Type, &robust))
         return nullptr;
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->inner(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->inner(*pcObject->getMeshObjectPtr(), Base::asBoolean(robust));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -469,13 +474,14 @@ PyObject*  MeshPy::outer(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))
+    PyObject *robust = Py_False;
+    if (!PyArg_ParseTuple(args, "O!|O!", &(MeshPy::Type), &pcObj, &PyBool_Type, &robust))
         return nullptr;
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->outer(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->outer(*pcObject->getMeshObjectPtr(), Base::asBoolean(robust));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -1753,9 +1759,10 @@ PyObject* MeshPy::smooth(PyObject *args, PyObject *kwds)
     double micro = 0;
     double maximum = 1000;
     int weight = 1;
-    static char* keywords_smooth[] = {"Method", "Iteration", "Lambda", "Micro", "Maximum", "Weight", nullptr};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sidddi",keywords_smooth,
-                                     &method, &iter, &lambda, &micro, &maximum, &weight))
+    int threads = 1;
+    static char* keywords_smooth[] = {"Method", "Iteration", "Lambda", "Micro", "Maximum", "Weight", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sidddii",keywords_smooth,
+                                     &method, &iter, &lambda, &micro, &maximum, &weight, &threads))
         return nullptr;
 
     PY_TRY {
@@ -1763,12 +1770,14 @@ PyObject* MeshPy::smooth(PyObject *args, PyObject *kwds)
         MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
         if (strcmp(method, "Laplace") == 0) {
             MeshCore::LaplaceSmoothing smooth(kernel);
+            smooth.SetThreads(threads);
             if (lambda > 0)
                 smooth.SetLambda(lambda);
             smooth.Smooth(iter);
         }
         else if (strcmp(method, "Taubin") == 0) {
             MeshCore::TaubinSmoothing smooth(kernel);
+            smooth.SetThreads(threads);
             if (lambda > 0)
                 smooth.SetLambda(lambda);
             if (micro > 0)
@@ -1777,11 +1786,13 @@ PyObject* MeshPy::smooth(PyObject *args, PyObject *kwds)
         }
         else if (strcmp(method, "PlaneFit") == 0) {
             MeshCore::PlaneFitSmoothing smooth(kernel);
+            smooth.SetThreads(threads);
             smooth.SetMaximum(maximum);
             smooth.Smooth(iter);
         }
         else if (strcmp(method, "MedianFilter") == 0) {
             MeshCore::MedianFilterSmoothing smooth(kernel);
+            smooth.SetThreads(threads);
             smooth.SetWeight(weight);
             smooth.Smooth(iter);
         }
@@ -1793,8 +1804,31 @@ PyObject* MeshPy::smooth(PyObject *args, PyObject *kwds)
     Py_Return;
 }
 
-PyObject*  MeshPy::decimate(PyObject *args)
+PyObject*  MeshPy::decimate(PyObject *args, PyObject *kwds)
 {
+    if (kwds && PyDict_Size(kwds) > 0) {
+        int targetSize = 0;
+        float maxError = 0.0f;
+        unsigned long partitionSize = 0;
+        PyObject* parallel = Py_True;
+        static char* keywords_decimate[] = {"TargetSize", "MaxError", "PartitionSize", "Parallel", nullptr};
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ifkO!", keywords_decimate,
+                                         &targetSize, &maxError, &partitionSize, &PyBool_Type, &parallel))
+            return nullptr;
+
+        if (targetSize <= 0 && maxError <= 0.0f) {
+            PyErr_SetString(PyExc_ValueError, "Either TargetSize or MaxError must be set");
+            return nullptr;
+        }
+
+        PY_TRY {
+            getMeshObjectPtr()->decimate(targetSize, maxError, partitionSize,
+                                         Base::asBoolean(parallel));
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
     float fTol, fRed;
     if (PyArg_ParseTuple(args, "ff", &fTol,&fRed)) {
         PY_TRY {
@@ -1814,7 +1848,8 @@ PyObject*  MeshPy::decimate(PyObject *args)
         Py_Return;
     }
 
-    PyErr_SetString(PyExc_ValueError, "decimate(tolerance=float, reduction=float) or decimate(targetSize=int)");
+    PyErr_SetString(PyExc_ValueError, "decimate(tolerance=float, reduction=float), decimate(targetSize=int) or "
+                                      "decimate(TargetSize=int, MaxError=float, PartitionSize=int, Parallel=bool)");
     return nullptr;
 }
 
@@ -1873,12 +1908,14 @@ PyObject*  MeshPy::getPlanarSegments(PyObject *args)
     return Py::new_reference_to(s);
 }
 
-PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
+PyObject*  MeshPy::getSegmentsOfType(PyObject *args, PyObject *kwds)
 {
     char* type;
     float dev;
     unsigned long minFacets=0;
-    if (!PyArg_ParseTuple(args, "sf|k",&type,&dev,&minFacets))
+    int threads=1;
+    static char* keywords_segments[] = {"Type", "Deviation", "MinFacets", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sf|ki", keywords_segments, &type, &dev, &minFacets, &threads))
         return nullptr;
 
     Mesh::MeshObject::GeometryType geoType;
@@ -1898,7 +1935,7 @@ PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
 
     Mesh::MeshObject* mesh = getMeshObjectPtr();
     std::vector<Mesh::Segment> segments = mesh->getSegmentsOfType
-        (geoType, dev, minFacets);
+        (geoType, dev, minFacets, threads);
 
     Py::List s;
     for (std::vector<Mesh::Segment>::iterator it = segments.begin(); it != segments.end(); ++it) {
@@ -1913,15 +1950,19 @@ PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
     return Py::new_reference_to(s);
 }
 
-PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
+PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args, PyObject *kwds)
 {
     PyObject* l;
-    if (!PyArg_ParseTuple(args, "O",&l))
+    int threads=1;
+    static char* keywords_segments[] = {"List", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i", keywords_segments, &l, &threads))
         return nullptr;
 
     const MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
     MeshCore::MeshSegmentAlgorithm finder(kernel);
+    finder.SetThreads(threads);
     MeshCore::MeshCurvature meshCurv(kernel);
+    meshCurv.SetThreads(threads);
     meshCurv.ComputePerVertex();
 
     Py::Sequence func(l);
@@ -1953,13 +1994,16 @@ PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
     return Py::new_reference_to(list);
 }
 
-PyObject* MeshPy::getCurvaturePerVertex(PyObject* args)
+PyObject* MeshPy::getCurvaturePerVertex(PyObject* args, PyObject* kwds)
 {
-    if (!PyArg_ParseTuple(args, ""))
+    int threads = 1;
+    static char* keywords_curvature[] = {"Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", keywords_curvature, &threads))
         return nullptr;
 
     const MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
     MeshCore::MeshCurvature meshCurv(kernel);
+    meshCurv.SetThreads(threads);
     meshCurv.ComputePerVertex();
 
     const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
@@ -683,6 +683,318 @@ class MeshSubElement(unittest.TestCase):
     def tearDown(self):
         pass
 
+class MeshDecimation(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0, 100)
+
+    def testTargetSize(self):
+        self.mesh.decimate(TargetSize=500)
+        self.assertLessEqual(self.mesh.CountFacets, 500)
+        self.assertFalse(self.mesh.hasNonManifolds())
+
+    def testPartitioned(self):
+        count = self.mesh.CountFacets
+        self.mesh.decimate(TargetSize=count // 4, PartitionSize=count // 8)
+        self.assertLessEqual(self.mesh.CountFacets, count // 4)
+        self.assertFalse(self.mesh.hasNonManifolds())
+
+    def testMaxError(self):
+        count = self.mesh.CountFacets
+        self.mesh.decimate(MaxError=1e-5, PartitionSize=count // 4, Parallel=False)
+        self.assertLess(self.mesh.CountFacets, count)
+
+    def testInvalidArguments(self):
+        with self.assertRaises(ValueError):
+            self.mesh.decimate(Parallel=True)
+
+    def tearDown(self):
+        pass
+
+class MeshParallelKernels(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0, 50)
+
+    def testCurvaturePerVertex(self):
+        serial = self.mesh.getCurvaturePerVertex()
+        parallel = self.mesh.getCurvaturePerVertex(Threads=0)
+        self.assertEqual(len(serial), len(parallel))
+        for i, j in zip(serial, parallel):
+            self.assertAlmostEqual(i[0], j[0], 4)
+            self.assertAlmostEqual(i[1], j[1], 4)
+
+    def testSmoothing(self):
+        for method in ("Laplace", "Taubin", "PlaneFit", "MedianFilter"):
+            mesh = self.mesh.copy()
+            mesh.smooth(Method=method, Iteration=3, Threads=0)
+            self.assertEqual(mesh.CountPoints, self.mesh.CountPoints)
+            self.assertFalse(mesh.hasInvalidPoints())
+
+    def testSmoothingSerialParallel(self):
+        # a fixed noisy sphere, the noise gives all methods something to remove
+        for i in range(self.mesh.CountPoints):
+            a = 0.7 * i
+            self.mesh.movePoint(i, FreeCAD.Vector(math.sin(a), math.cos(1.3 * a), math.sin(2.1 * a)) * 0.02)
+        original = [p.Vector for p in self.mesh.Points]
+        neighbours = [set() for p in original]
+        for facet in self.mesh.Topology[1]:
+            for i in facet:
+                neighbours[i].update(facet)
+
+        def smoothed(method, threads):
+            mesh = self.mesh.copy()
+            mesh.smooth(Method=method, Iteration=1, Threads=threads)
+            return [p.Vector for p in mesh.Points]
+
+        def roughness(points):
+            # mean distance of the points to the center of their neighbours
+            total = 0.0
+            for i, pnt in enumerate(points):
+                others = [points[j] for j in neighbours[i] if j != i]
+                total += (sum(others, FreeCAD.Vector()) / len(others) - pnt).Length
+            return total / len(points)
+
+        for method in ("Laplace", "Taubin", "PlaneFit", "MedianFilter"):
+            serial = smoothed(method, 1)
+            parallel = smoothed(method, 2)
+            # the parallel result does not depend on the number of threads
+            for i, j in zip(parallel, smoothed(method, 4)):
+                self.assertEqual(i, j)
+
+            moved = max((i - j).Length for i, j in zip(serial, original))
+            diff = max((i - j).Length for i, j in zip(serial, parallel))
+            self.assertGreater(moved, 0.0)
+            if method == "PlaneFit":
+                # the serial version already uses the positions of the previous iteration
+                self.assertLess(diff, 1e-5)
+            else:
+                # the serial version uses the points already moved in the same iteration,
+                # so the results differ but both remove the noise
+                self.assertLess(diff, moved)
+                self.assertLess(roughness(parallel), roughness(original))
+
+    def testFeatureSmoothing(self):
+        for i in range(self.mesh.CountPoints):
+            a = 0.7 * i
+            self.mesh.movePoint(i, FreeCAD.Vector(math.sin(a), math.cos(1.3 * a), math.sin(2.1 * a)) * 0.02)
+        original = [p.Vector for p in self.mesh.Points]
+
+        doc = FreeCAD.newDocument("MeshSmoothing")
+        try:
+            feature = doc.addObject("Mesh::Feature", "Mesh")
+            results = []
+            for threads in (1, 2, 4):
+                feature.Mesh = self.mesh
+                feature.smooth(3, 0.005, threads)
+                points = [p.Vector for p in feature.Mesh.Points]
+                # no point moves further than the given maximum
+                moved = max((i - j).Length for i, j in zip(points, original))
+                self.assertGreater(moved, 0.0)
+                self.assertLessEqual(moved, 0.005 + 1e-6)
+                results.append(points)
+            # the parallel result does not depend on the number of threads
+            for i, j in zip(results[1], results[2]):
+                self.assertEqual(i, j)
+        finally:
+            FreeCAD.closeDocument(doc.Name)
+
+    def tearDown(self):
+        pass
+
+class MeshBooleanOperations(unittest.TestCase):
+    def setUp(self):
+        self.mesh1 = Mesh.createSphere(1.0, 40)
+        self.mesh2 = Mesh.createSphere(0.7, 30)
+        self.mesh2.translate(0.8, 0.013, 0.007)
+
+    def testRobustUnion(self):
+        res1 = self.mesh1.unite(self.mesh2)
+        res2 = self.mesh1.unite(self.mesh2, True)
+        self.assertGreater(res2.CountFacets, 0)
+        self.assertAlmostEqual(res1.Area, res2.Area, 2)
+
+    def testRobustDifference(self):
+        res = self.mesh1.difference(self.mesh2, True)
+        self.assertGreater(res.CountFacets, 0)
+        self.assertLess(res.Area, self.mesh1.Area + self.mesh2.Area)
+
+    def testSection(self):
+        curves = self.mesh1.section(self.mesh2)
+        self.assertGreater(len(curves), 0)
+
+    def testThreadsParameter(self):
+        # the result does not depend on the number of threads
+        params = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Mesh")
+        threads = params.GetInt("BooleanThreads", 0)
+        try:
+            results = []
+            for count in (1, 4):
+                params.SetInt("BooleanThreads", count)
+                results.append(self.mesh1.unite(self.mesh2, True))
+        finally:
+            params.SetInt("BooleanThreads", threads)
+        self.assertEqual(results[0].CountFacets, results[1].CountFacets)
+        for i, j in zip(results[0].Points, results[1].Points):
+            self.assertEqual(i.Vector, j.Vector)
+
+    def tearDown(self):
+        pass
+
+class MeshSegmentation(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0, 50)
+
+    def testSphere(self):
+        segments = self.mesh.getSegmentsOfType("Sphere", 0.001)
+        self.assertEqual(len(segments), 1)
+        self.assertEqual(len(segments[0]), self.mesh.CountFacets)
+
+    def testPlanes(self):
+        box = Mesh.createBox(1.0, 1.0, 1.0)
+        segments = box.getSegmentsOfType("Plane", 0.001, Threads=0)
+        self.assertEqual(len(segments), 6)
+
+    def testParallel(self):
+        for kind in ("Plane", "Cylinder", "Sphere"):
+            serial = self.mesh.getSegmentsOfType(kind, 0.01, 10)
+            parallel = self.mesh.getSegmentsOfType(kind, 0.01, 10, Threads=0)
+            self.assertEqual(serial, parallel)
+        curvature = [(1.0, 1.0, 0.1, 0.1, 10)]
+        serial = self.mesh.getSegmentsByCurvature(curvature)
+        parallel = self.mesh.getSegmentsByCurvature(curvature, Threads=0)
+        self.assertEqual(serial, parallel)
+
+    def tearDown(self):
+        pass
+
+class MeshCrossSections(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0, 50)
+        self.heights = [0.1 * i for i in range(-9, 10)]
+
+    def sectionLength(self, section):
+        length = 0.0
+        for polyline in section:
+            for i in range(1, len(polyline)):
+                length += (polyline[i] - polyline[i-1]).Length
+        return length
+
+    def testParallelPlanes(self):
+        planes = [(Base.Vector(0, 0, z), Base.Vector(0, 0, 1)) for z in self.heights]
+        sections = self.mesh.crossSections(planes)
+        self.assertEqual(len(sections), len(planes))
+        for z, section in zip(self.heights, sections):
+            radius = math.sqrt(1.0 - z * z)
+            self.assertAlmostEqual(self.sectionLength(section), 2.0 * math.pi * radius, 1)
+
+    def testPlacement(self):
+        mesh = self.mesh.copy()
+        mesh.Placement = Base.Placement(Base.Vector(0, 0, 5), Base.Rotation(Base.Vector(1, 0, 0), 90))
+        planes = [(Base.Vector(0, 0, 5 + z), Base.Vector(0, 0, 1)) for z in self.heights]
+        sections = mesh.crossSections(planes, 0.01, True)
+        self.assertEqual(len(sections), len(planes))
+        for z, section in zip(self.heights, sections):
+            radius = math.sqrt(1.0 - z * z)
+            self.assertAlmostEqual(self.sectionLength(section), 2.0 * math.pi * radius, 1)
+            for polyline in section:
+                for point in polyline:
+                    self.assertAlmostEqual(point.z, 5 + z, 4)
+
+    def tearDown(self):
+        pass
+
+class MeshExport(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0, 200)
+
+    def testRoundTrip(self):
+        for ext in ("stl", "ast", "obj", "off", "ply"):
+            name = tempfile.gettempdir() + os.sep + "mesh_export." + ext
+            self.mesh.write(name)
+            mesh = Mesh.read(name)
+            os.remove(name)
+            self.assertEqual(mesh.CountFacets, self.mesh.CountFacets)
+            self.assertAlmostEqual(mesh.Area, self.mesh.Area, 3)
+
+    def testThreads(self):
+        # the written data does not depend on the number of threads
+        for ext in ("stl", "ast", "obj", "off", "ply", "aply"):
+            data = []
+            for threads in (1, 4):
+                stream = io.BytesIO()
+                self.mesh.write(Stream=stream, Format=ext, Threads=threads)
+                data.append(stream.getvalue())
+            self.assertEqual(data[0], data[1])
+
+    def testObjGroups(self):
+        # two meshes are exported as groups of one OBJ file
+        doc = FreeCAD.newDocument("MeshExport")
+        name = tempfile.gettempdir() + os.sep + "mesh_groups.obj"
+        try:
+            sphere = doc.addObject("Mesh::Feature", "Sphere")
+            sphere.Mesh = self.mesh
+            box = doc.addObject("Mesh::Feature", "Box")
+            box.Mesh = Mesh.createBox(1.0, 1.0, 1.0)
+            Mesh.export([sphere, box], name)
+            mesh = Mesh.read(name)
+            os.remove(name)
+        finally:
+            FreeCAD.closeDocument(doc.Name)
+        self.assertEqual(mesh.countSegments(), 2)
+        self.assertEqual(mesh.CountFacets, self.mesh.CountFacets + 12)
+
+    def tearDown(self):
+        pass
+
+class MeshAsciiImport(unittest.TestCase):
+    def setUp(self):
+        self.name = tempfile.gettempdir() + os.sep + "mesh_import."
+
+    def readText(self, ext, text):
+        name = self.name + ext
+        with open(name, "w", newline="") as f:
+            f.write(text)
+        mesh = Mesh.read(name)
+        os.remove(name)
+        return mesh
+
+    def testObj(self):
+        text = "# comment\r\n" \
+               "v 0 0 0\r\n" \
+               "v 1 0 0\r\n" \
+               "vn 0 0 1\r\n" \
+               "v 1 1 0\r\n" \
+               "v 0 1 0\r\n" \
+               "g first\r\n" \
+               "f 1/1/1 2//1 3\r\n" \
+               "g second\r\n" \
+               "v 2 0 0\r\n" \
+               "v 2 1 0\r\n" \
+               "f -5 -2 -1 -4"
+        mesh = self.readText("obj", text)
+        self.assertEqual(mesh.CountPoints, 5)
+        self.assertEqual(mesh.CountFacets, 3)
+        self.assertEqual(mesh.countSegments(), 2)
+        self.assertAlmostEqual(mesh.Area, 1.5, 6)
+
+    def testAsciiStl(self):
+        facets = []
+        for i in range(1000):
+            facets.append("facet normal 0 0 1\n"
+                          " outer loop\n"
+                          "  vertex {0} 0 0\n"
+                          "  vertex {1} 0 0\n"
+                          "  vertex {0} 1.0e0 0\n"
+                          " endloop\n"
+                          "endfacet\n".format(i, i + 1))
+        text = "solid test\n" + "".join(facets) + "endsolid test\n"
+        mesh = self.readText("ast", text)
+        self.assertEqual(mesh.CountPoints, 2001)
+        self.assertEqual(mesh.CountFacets, 1000)
+        self.assertAlmostEqual(mesh.Area, 500.0, 6)
+
+    def tearDown(self):
+        pass
+
 class MeshProperty(unittest.TestCase):
     def setUp(self):
         self.doc = FreeCAD.newDocument("MeshTest")
@@ -40,8 +40,10 @@
 // standard
 #include <cstdio>
 #include <cassert>
+#include <charconv>
 #include <cmath>
 #include <cfloat>
+#include <cstring>
 #include <fcntl.h>
 #include <fstream>
 #include <ios>
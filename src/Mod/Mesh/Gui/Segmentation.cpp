@@ -78,7 +78,9 @@ void Segmentation::accept()
     }
 
     MeshCore::MeshSegmentAlgorithm finder(kernel);
+    finder.SetThreads(0);
     MeshCore::MeshCurvature meshCurv(kernel);
+    meshCurv.SetThreads(0);
     meshCurv.ComputePerVertex();
 
     std::vector<MeshCore::MeshSurfaceSegmentPtr> segm;
@@ -428,6 +428,7 @@ void SegmentationBestFit::accept()
     const MeshCore::MeshKernel& kernel = mesh->getKernel();
 
     MeshCore::MeshSegmentAlgorithm finder(kernel);
+    finder.SetThreads(0);
 
     std::vector<MeshCore::MeshSurfaceSegmentPtr> segm;
     if (ui->groupBoxCyl->isChecked()) {
@@ -50,6 +50,8 @@
 #include <Base/Stream.h>
 
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/Functional.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
@@ -66,6 +68,29 @@ using MeshCore::MeshAlgorithm;
 using MeshCore::MeshFacetGrid;
 using MeshCore::MeshFacet;
 
+namespace {
+/*
+ * Calls \a func for the indices 0..count-1 concurrently. The work is done in waves of
+ * one item per thread so that the progress is reported and a cancellation is checked
+ * by the calling thread after each wave.
+ */
+template <class Func>
+void forEachEdge(std::size_t count, const char* message, Func func)
+{
+    Base::SequencerLauncher seq(message, count);
+    const std::size_t waveSize = static_cast<std::size_t>(Base::idealThreadCount());
+    for (std::size_t wave = 0; wave < count; wave += waveSize) {
+        std::size_t num = std::min(waveSize, count - wave);
+        MeshCore::parallel_for(num, static_cast<int>(num), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                func(wave + i);
+        });
+        for (std::size_t i = 0; i < num; i++)
+            seq.next();
+    }
+}
+}
+
 CurveProjector::CurveProjector(const TopoDS_Shape &aShape, const MeshKernel &pMesh)
 : _Shape(aShape), _Mesh(pMesh)
 {
@@ -86,6 +111,66 @@ void CurveProjector::writeIntersectionPointsToFile(const char *name)
   str.close();
 }
 
+template<class Func>
+void CurveProjector::projectEdges(Func func)
+{
+  // an edge shared by several faces is projected once but its split edges are
+  // appended for every occurrence
+  std::vector<TopoDS_Edge> aEdges;
+  std::vector<std::size_t> aOccurrences;
+  std::map<TopoDS_Edge, std::size_t, TopoDSLess<TopoDS_Edge> > aDistinct;
+  TopExp_Explorer Ex;
+  for (Ex.Init(_Shape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
+    const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
+    auto it = aDistinct.emplace(aEdge, aDistinct.size()).first;
+    aOccurrences.push_back(it->second);
+    if (it->second == aEdges.size())
+      aEdges.push_back(aEdge);
+  }
+
+  // the edges are independent of each other
+  std::vector<std::vector<FaceSplitEdge> > aSplitEdges(aEdges.size());
+  MeshCore::parallel_for(aEdges.size(), 0, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+      func(aEdges[i], aSplitEdges[i]);
+  });
+
+  for (std::size_t index : aOccurrences) {
+    std::vector<FaceSplitEdge>& vSplitEdges = mvEdgeSplitPoints[aEdges[index]];
+    vSplitEdges.insert(vSplitEdges.end(), aSplitEdges[index].begin(), aSplitEdges[index].end());
+  }
+}
+
+const MeshCore::MeshFacetBVH& CurveProjector::getFacetBVH()
+{
+  if (!_FacetBVH)
+    _FacetBVH = std::make_shared<MeshCore::MeshFacetBVH>(_Mesh);
+  return *_FacetBVH;
+}
+
+bool CurveProjector::findNearestProjection(const MeshKernel &MeshK, const MeshCore::MeshFacetBVH &BVH,
+                                           const Base::Vector3f &Pnt, Base::Vector3f &Rslt,
+                                           MeshCore::FacetIndex &FaceIndex)
+{
+  // A projected point lies in the facet, so its distance is never smaller than the
+  // distance to the bounding box of the facet and the nearest facets can be visited first.
+  MeshCore::FacetIndex index = BVH.NearestFacet(Pnt, [&MeshK, &Pnt](MeshCore::FacetIndex facet) {
+    Base::Vector3f TempResultPoint;
+    MeshGeomFacet cFacet = MeshK.GetFacet(facet);
+    // try to project (with angle) to the face
+    if (cFacet.Foraminate(Pnt, cFacet.GetNormal(), TempResultPoint))
+      return (Pnt-TempResultPoint).Length();
+    return FLOAT_MAX;
+  });
+
+  if (index == MeshCore::FACET_INDEX_MAX)
+    return false;
+  MeshGeomFacet cFacet = MeshK.GetFacet(index);
+  cFacet.Foraminate(Pnt, cFacet.GetNormal(), Rslt);
+  FaceIndex = index;
+  return true;
+}
+
 
 //**************************************************************************
 //**************************************************************************
@@ -100,13 +185,11 @@ CurveProjectorShape::CurveProjectorShape(const TopoDS_Shape &aShape, const MeshK
 
 void CurveProjectorShape::Do()
 {
-  TopExp_Explorer Ex;
-  for (Ex.Init(_Shape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
-    const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
-
-    //std::vector<FaceSplitEdge> vSplitEdges;
-    projectCurve(aEdge, mvEdgeSplitPoints[aEdge]);
-  }
+  // build the facet hierarchy before the projection threads use it
+  getFacetBVH();
+  projectEdges([this](const TopoDS_Edge& aEdge, std::vector<FaceSplitEdge>& vSplitEdges) {
+    projectCurve(aEdge, vSplitEdges);
+  });
 }
 
 
@@ -221,30 +304,10 @@ void CurveProjectorShape::projectCurve( const TopoDS_Edge& aEdge,
 
 bool CurveProjectorShape::findStartPoint(const MeshKernel &MeshK,const Base::Vector3f &Pnt,Base::Vector3f &Rslt,MeshCore::FacetIndex &FaceIndex)
 {
-  Base::Vector3f TempResultPoint;
-  float MinLength = FLOAT_MAX;
-  bool bHit = false;
-
-  // go through the whole Mesh
-  MeshFacetIterator It(MeshK);
-  for(It.Init();It.More();It.Next())
-  {
-    // try to project (with angle) to the face
-    if(It->Foraminate (Pnt, It->GetNormal(), TempResultPoint) )
-    {
-      // distance to the projected point
-      float Dist = (Pnt-TempResultPoint).Length();
-      if(Dist < MinLength)
-      {
-        // remember the point with the closest distance
-        bHit = true;
-        MinLength = Dist;
-        Rslt = TempResultPoint;
-        FaceIndex = It.Position();
-      }
-    }
-  }
-  return bHit;
+  if (&MeshK == &_Mesh)
+    return findNearestProjection(MeshK, getFacetBVH(), Pnt, Rslt, FaceIndex);
+  MeshCore::MeshFacetBVH cBVH(MeshK);
+  return findNearestProjection(MeshK, cBVH, Pnt, Rslt, FaceIndex);
 }
 
 
@@ -533,30 +596,10 @@ void CurveProjectorSimple::projectCurve( const TopoDS_Edge& aEdge,
 
 bool CurveProjectorSimple::findStartPoint(const MeshKernel &MeshK,const Base::Vector3f &Pnt,Base::Vector3f &Rslt,MeshCore::FacetIndex &FaceIndex)
 {
-  Base::Vector3f TempResultPoint;
-  float MinLength = FLOAT_MAX;
-  bool bHit = false;
-
-  // go through the whole Mesh
-  MeshFacetIterator It(MeshK);
-  for(It.Init();It.More();It.Next())
-  {
-    // try to project (with angle) to the face
-    if(It->Foraminate (Pnt, It->GetNormal(), TempResultPoint) )
-    {
-      // distance to the projected point
-      float Dist = (Pnt-TempResultPoint).Length();
-      if(Dist < MinLength)
-      {
-        // remember the point with the closest distance
-        bHit = true;
-        MinLength = Dist;
-        Rslt = TempResultPoint;
-        FaceIndex = It.Position();
-      }
-    }
-  }
-  return bHit;
+  if (&MeshK == &_Mesh)
+    return findNearestProjection(MeshK, getFacetBVH(), Pnt, Rslt, FaceIndex);
+  MeshCore::MeshFacetBVH cBVH(MeshK);
+  return findNearestProjection(MeshK, cBVH, Pnt, Rslt, FaceIndex);
 }
 
 //**************************************************************************
@@ -806,25 +849,22 @@ void MeshProjection::projectToMesh (const TopoDS_Shape &aShape, float fMaxDist,
     float fAvgLen = clAlg.GetAverageEdgeLength();
     MeshFacetGrid cGrid( _rcMesh, 5.0f*fAvgLen );
 
+    std::vector<TopoDS_Edge> aEdges;
     TopExp_Explorer Ex;
-
-    int iCnt=0;
     for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next())
-        iCnt++;
-
-    Base::SequencerLauncher seq( "Project curve on mesh", iCnt );
+        aEdges.push_back(TopoDS::Edge(Ex.Current()));
 
-    for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
-        const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
+    // the edges are projected concurrently, the grid is only read
+    std::vector<PolyLine> aPolyLines(aEdges.size());
+    forEachEdge(aEdges.size(), "Project curve on mesh", [&](std::size_t i) {
         std::vector<SplitEdge> rSplitEdges;
-        projectEdgeToEdge(aEdge, fMaxDist, cGrid, rSplitEdges);
-        PolyLine polyline;
+        projectEdgeToEdge(aEdges[i], fMaxDist, cGrid, rSplitEdges);
+        PolyLine& polyline = aPolyLines[i];
         polyline.points.reserve(rSplitEdges.size());
-        for (auto it : rSplitEdges)
+        for (const auto& it : rSplitEdges)
             polyline.points.push_back(it.cPt);
-        rPolyLines.push_back(polyline);
-        seq.next();
-    }
+    });
+    rPolyLines.insert(rPolyLines.end(), aPolyLines.begin(), aPolyLines.end());
 }
 
 void MeshProjection::projectOnMesh(const std::vector<Base::Vector3f>& pointsIn,
@@ -913,50 +953,20 @@ void MeshProjection::projectParallelToMesh (const TopoDS_Shape &aShape, const Ba
     MeshAlgorithm clAlg(_rcMesh);
     float fAvgLen = clAlg.GetAverageEdgeLength();
     MeshFacetGrid cGrid(_rcMesh, 5.0f*fAvgLen);
-    TopExp_Explorer Ex;
 
-    int iCnt=0;
+    std::vector<TopoDS_Edge> aEdges;
+    TopExp_Explorer Ex;
     for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next())
-        iCnt++;
-
-    Base::SequencerLauncher seq( "Project curve on mesh", iCnt );
+        aEdges.push_back(TopoDS::Edge(Ex.Current()));
 
-    for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
-        const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
+    // the edges are projected concurrently, the grid is only read
+    std::vector<PolyLine> aPolyLines(aEdges.size());
+    forEachEdge(aEdges.size(), "Project curve on mesh", [&](std::size_t i) {
         std::vector<Base::Vector3f> points;
-        discretize(aEdge, points, 5);
-
-        using HitPoint = std::pair<Base::Vector3f, MeshCore::FacetIndex>;
-        std::vector<HitPoint> hitPoints;
-        using HitPoints = std::pair<HitPoint, HitPoint>;
-        std::vector<HitPoints> hitPointPairs;
-        for (auto it : points) {
-            Base::Vector3f result;
-            MeshCore::FacetIndex index;
-            if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
-                hitPoints.emplace_back(result, index);
-
-                if (hitPoints.size() > 1) {
-                    HitPoint p1 = hitPoints[hitPoints.size()-2];
-                    HitPoint p2 = hitPoints[hitPoints.size()-1];
-                    hitPointPairs.emplace_back(p1, p2);
-                }
-            }
-        }
-
-        MeshCore::MeshProjection meshProjection(_rcMesh);
-        PolyLine polyline;
-        for (auto it : hitPointPairs) {
-            points.clear();
-            if (meshProjection.projectLineOnMesh(cGrid, it.first.first, it.first.second,
-                                                 it.second.first, it.second.second, dir, points)) {
-                polyline.points.insert(polyline.points.end(), points.begin(), points.end());
-            }
-        }
-        rPolyLines.push_back(polyline);
-
-        seq.next();
-    }
+        discretize(aEdges[i], points, 5);
+        projectPolyLineToMesh(points, dir, cGrid, aPolyLines[i]);
+    });
+    rPolyLines.insert(rPolyLines.end(), aPolyLines.begin(), aPolyLines.end());
 }
 
 void MeshProjection::projectParallelToMesh (const std::vector<PolyLine> &aEdges, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const
@@ -966,41 +976,45 @@ void MeshProjection::projectParallelToMesh (const std::vector<PolyLine> &aEdges,
     float fAvgLen = clAlg.GetAverageEdgeLength();
     MeshFacetGrid cGrid(_rcMesh, 5.0f*fAvgLen);
 
-    Base::SequencerLauncher seq( "Project curve on mesh", aEdges.size() );
-
-    for (const auto& it : aEdges) {
-        std::vector<Base::Vector3f> points = it.points;
-
-        using HitPoint = std::pair<Base::Vector3f, MeshCore::FacetIndex>;
-        std::vector<HitPoint> hitPoints;
-        using HitPoints = std::pair<HitPoint, HitPoint>;
-        std::vector<HitPoints> hitPointPairs;
-        for (auto it : points) {
-            Base::Vector3f result;
-            MeshCore::FacetIndex index;
-            if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
-                hitPoints.emplace_back(result, index);
-
-                if (hitPoints.size() > 1) {
-                    HitPoint p1 = hitPoints[hitPoints.size()-2];
-                    HitPoint p2 = hitPoints[hitPoints.size()-1];
-                    hitPointPairs.emplace_back(p1, p2);
-                }
-            }
-        }
+    // the polylines are projected concurrently, the grid is only read
+    std::vector<PolyLine> aPolyLines(aEdges.size());
+    forEachEdge(aEdges.size(), "Project curve on mesh", [&](std::size_t i) {
+        projectPolyLineToMesh(aEdges[i].points, dir, cGrid, aPolyLines[i]);
+    });
+    rPolyLines.insert(rPolyLines.end(), aPolyLines.begin(), aPolyLines.end());
+}
 
-        MeshCore::MeshProjection meshProjection(_rcMesh);
-        PolyLine polyline;
-        for (auto it : hitPointPairs) {
-            points.clear();
-            if (meshProjection.projectLineOnMesh(cGrid, it.first.first, it.first.second,
-                                                 it.second.first, it.second.second, dir, points)) {
-                polyline.points.insert(polyline.points.end(), points.begin(), points.end());
+void MeshProjection::projectPolyLineToMesh(const std::vector<Base::Vector3f>& points, const Base::Vector3f& dir,
+                                           const MeshCore::MeshFacetGrid& rGrid, PolyLine& polyline) const
+{
+    MeshAlgorithm clAlg(_rcMesh);
+
+    using HitPoint = std::pair<Base::Vector3f, MeshCore::FacetIndex>;
+    std::vector<HitPoint> hitPoints;
+    using HitPoints = std::pair<HitPoint, HitPoint>;
+    std::vector<HitPoints> hitPointPairs;
+    for (auto it : points) {
+        Base::Vector3f result;
+        MeshCore::FacetIndex index;
+        if (clAlg.NearestFacetOnRay(it, dir, rGrid, result, index)) {
+            hitPoints.emplace_back(result, index);
+
+            if (hitPoints.size() > 1) {
+                HitPoint p1 = hitPoints[hitPoints.size()-2];
+                HitPoint p2 = hitPoints[hitPoints.size()-1];
+                hitPointPairs.emplace_back(p1, p2);
             }
         }
-        rPolyLines.push_back(polyline);
+    }
 
-        seq.next();
+    MeshCore::MeshProjection meshProjection(_rcMesh);
+    std::vector<Base::Vector3f> segment;
+    for (auto it : hitPointPairs) {
+        segment.clear();
+        if (meshProjection.projectLineOnMesh(rGrid, it.first.first, it.first.second,
+                                             it.second.first, it.second.second, dir, segment)) {
+            polyline.points.insert(polyline.points.end(), segment.begin(), segment.end());
+        }
     }
 }
 
@@ -1045,11 +1059,9 @@ void MeshProjection::projectEdgeToEdge( const TopoDS_Edge &aEdge, float fMaxDist
     MeshPointIterator cPI( _rcMesh );
     MeshFacetIterator cFI( _rcMesh );
 
-    Base::SequencerLauncher seq( "Project curve on mesh", pEdgeToFace.size() );
+    // this runs in the worker threads of projectToMesh which reports the progress per edge
     std::map<std::pair<MeshCore::PointIndex, MeshCore::PointIndex>, std::list<MeshCore::FacetIndex> >::iterator it;
     for ( it = pEdgeToFace.begin(); it != pEdgeToFace.end(); ++it ) {
-        seq.next();
-
         // edge points
         MeshCore::PointIndex uE0 = it->first.first;
         cPI.Set( uE0 );
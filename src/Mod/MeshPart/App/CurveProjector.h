@@ -27,6 +27,8 @@
 # include <gts.h>
 #endif
 
+#include <memory>
+
 #include <TopoDS_Edge.hxx>
 
 #include <Mod/Mesh/App/Mesh.h>
@@ -38,6 +40,7 @@ namespace MeshCore
 class MeshKernel;
 class MeshGeomFacet;
 class MeshFacetGrid;
+class MeshFacetBVH;
 }
 
 using MeshCore::MeshKernel;
@@ -76,9 +79,23 @@ public:
 
 protected:
   virtual void Do()=0;
+  /** Projects every distinct edge of the shape concurrently with \a func(edge, splitEdges)
+   * and appends the results in the order of the explorer.
+   */
+  template<class Func>
+  void projectEdges(Func func);
+  /// Returns the facet hierarchy of the mesh, the first call builds it and is not thread-safe
+  const MeshCore::MeshFacetBVH& getFacetBVH();
+  /** Searches the facet onto which \a Pnt can be projected along the facet normal with the
+   * shortest distance. The result is the same as testing all facets.
+   */
+  static bool findNearestProjection(const MeshKernel &MeshK, const MeshCore::MeshFacetBVH &BVH,
+                                    const Base::Vector3f &Pnt, Base::Vector3f &Rslt,
+                                    MeshCore::FacetIndex &FaceIndex);
   const TopoDS_Shape &_Shape;
   const MeshKernel &_Mesh;
   result_type mvEdgeSplitPoints;
+  std::shared_ptr<MeshCore::MeshFacetBVH> _FacetBVH;
 
 };
 
@@ -224,6 +241,8 @@ public:
 protected:
     void projectEdgeToEdge(const TopoDS_Edge &aCurve, float fMaxDist, const MeshCore::MeshFacetGrid& rGrid,
                            std::vector<SplitEdge>& rSplitEdges) const;
+    void projectPolyLineToMesh(const std::vector<Base::Vector3f>& points, const Base::Vector3f& dir,
+                               const MeshCore::MeshFacetGrid& rGrid, PolyLine& polyline) const;
     bool findIntersection(const Edge&, const Edge&, const Base::Vector3f& dir, Base::Vector3f& res) const;
 
 private:
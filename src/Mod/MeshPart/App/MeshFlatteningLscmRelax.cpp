@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 # include <array>
 # include <cmath>
 # include <iostream>
@@ -34,7 +35,7 @@
 # define M_PI 3.14159265358979323846f
 #endif
 
-#include <Eigen/SparseCholesky>
+#include <Base/Parallel.h>
 
 #include "MeshFlatteningLscmRelax.h"
 
@@ -49,6 +50,22 @@ namespace lscmrelax
 using trip = Eigen::Triplet<double>;
 using spMat = Eigen::SparseMatrix<double>;
 
+namespace
+{
+
+// see Base::parallel_for, the work per item is small so short ranges are done serially
+template <typename Func>
+void parallel_for(long count, int threads, Func func)
+{
+    if (count < 1000)
+        threads = 1;
+    Base::parallel_for(static_cast<std::size_t>(count), threads, [&func](std::size_t begin, std::size_t end)
+    {
+        func(static_cast<long>(begin), static_cast<long>(end));
+    });
+}
+
+}
 
 
 ColMat<double, 2> map_to_2D(ColMat<double, 3> points)
@@ -144,151 +161,224 @@ LscmRelax::LscmRelax(
 //////////////////////////////////////////////////////////////////////////
 /////////////////                 F.E.M                      /////////////
 //////////////////////////////////////////////////////////////////////////
-void LscmRelax::relax(double weight)
+void LscmRelax::init_relax_pattern()
 {
-    ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
-    // for every triangle
-    Eigen::Matrix<double, 3, 6> B;
-    Eigen::Matrix<double, 2, 2> T;
-    Eigen::Matrix<double, 6, 6> K_m;
-    Eigen::Matrix<double, 6, 1> u_m, rhs_m;
-    Eigen::VectorXd rhs(this->vertices.cols() * 2 + 3);
-    if (this->sol.size() == 0)
-        this->sol.Zero(this->vertices.cols() * 2 + 3);
-    spMat K_g(this->vertices.cols() * 2 + 3, this->vertices.cols() * 2 + 3);
+    // the pattern of the stiffness matrix only depends on the triangles, so the
+    // position of every entry of the element matrices is computed once
+    long n_dof = this->vertices.cols() * 2;
+    long n_tri = this->triangles.cols();
     std::vector<trip> K_g_triplets;
-    Vector2 v1, v2, v3, v12, v23, v31;
-    long row_pos, col_pos;
-    double A;
-
-    rhs.setZero();
-
-    for (long i=0; i<this->triangles.cols(); i++)
+    K_g_triplets.reserve(n_tri * 36 + this->vertices.cols() * 8);
+    for (long i=0; i < n_tri; i++)
     {
-        // 1: construct B-mat in m-system
-        v1 = this->flat_vertices.col(this->triangles(0, i));
-        v2 = this->flat_vertices.col(this->triangles(1, i));
-        v3 = this->flat_vertices.col(this->triangles(2, i));
-        v12 = v2 - v1;
-        v23 = v3 - v2;
-        v31 = v1 - v3;
-        B << -v23.y(),   0,        -v31.y(),   0,        -v12.y(),   0,
-              0,         v23.x(),   0,         v31.x(),   0,         v12.x(),
-             -v23.x(),   v23.y(),  -v31.x(),   v31.y(),  -v12.x(),   v12.y();
-        T << v12.x(), -v12.y(),
-             v12.y(), v12.x();
-        T /= v12.norm();
-        A = std::abs(this->q_l_m(i, 0) * this->q_l_m(i, 2) / 2);
-        B /= A * 2; // (2*area)
-
-        // 2: sigma due dqlg in m-system
-        u_m << Vector2(0, 0), T * Vector2(d_q_l_g(i, 0), 0), T * Vector2(d_q_l_g(i, 1), d_q_l_g(i, 2));
-
-        // 3: rhs_m = B.T * C * B * dqlg_m
-        //    K_m = B.T * C * B
-        rhs_m = B.transpose() * this->C * B * u_m * A;
-        K_m = B.transpose() * this->C * B * A;
-
-        // 5: add to rhs_g, K_g
-        for (int j=0; j < 3; j++)
+        for (int a=0; a < 6; a++)
+            for (int b=0; b < 6; b++)
+                K_g_triplets.push_back(trip(this->triangles(a / 2, i) * 2 + a % 2,
+                                            this->triangles(b / 2, i) * 2 + b % 2, 0.));
+    }
+    // lagrange multiplier: fixing total ux, total uy and ux*y-uy*x
+    for (long i=0; i < this->vertices.cols(); i++)
+    {
+        for (long k=0; k < 3; k++)
         {
-            row_pos = this->triangles(j, i);
-            rhs[row_pos * 2]     += rhs_m[j * 2];
-            rhs[row_pos * 2 + 1] += rhs_m[j * 2 +1];
-            for (int k=0; k < 3; k++)
+            if (k < 2)
             {
-                col_pos = this->triangles(k, i);
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2,        K_m(j * 2,      k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2,        K_m(j * 2 + 1,  k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2 + 1,    K_m(j * 2 + 1,  k * 2 + 1)));
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2 + 1,    K_m(j * 2,      k * 2 + 1)));
-                // we don't have to fill all because the matrix is symmetric.
+                K_g_triplets.push_back(trip(i * 2 + k, n_dof + k, 0.));
+                K_g_triplets.push_back(trip(n_dof + k, i * 2 + k, 0.));
+            }
+            else
+            {
+                for (long c=0; c < 2; c++)
+                {
+                    K_g_triplets.push_back(trip(i * 2 + c, n_dof + 2, 0.));
+                    K_g_triplets.push_back(trip(n_dof + 2, i * 2 + c, 0.));
+                }
             }
         }
     }
-    // FIXING SOME PINS:
-    // - if there are no pins (or only one pin) selected solve the system without the nullspace solution.
-    // - if there are some pins selected, delete all columns, rows that refer to this pins
-    //          set the diagonal element of these pins to 1 + the rhs to zero
-    //          (? is it possible to fix in the inner of the face? for sure for fem, but lscm could have some problems)
-    //          (we also need some extra variables to see if the pins come from user)
-
-    // fixing some points
-    // although only internal forces are applied there has to be locked
-    // at least 3 degrees of freedom to stop the mesh from pure rotation and pure translation
-    // std::vector<long> fixed_dof;
-    // fixed_dof.push_back(this->triangles(0, 0) * 2); //x0
-    // fixed_dof.push_back(this->triangles(0, 0) * 2 + 1); //y0
-    // fixed_dof.push_back(this->triangles(1, 0) * 2 + 1); // y1
-
-    // align flat mesh to fixed edge
-    // Vector2 edge = this->flat_vertices.col(this->triangles(1, 0)) -
-    //                this->flat_vertices.col(this->triangles(0, 0));
-    // edge.normalize();
-    // Eigen::Matrix<double, 2, 2> rot;
-    // rot << edge.x(), edge.y(), -edge.y(), edge.x();
-    // this->flat_vertices = rot * this->flat_vertices;
-
-    // // return true if triplet row / col is in fixed_dof
-    // auto is_in_fixed_dof = [fixed_dof](const trip & element) -> bool {
-    //     return (
-    //         (std::find(fixed_dof.begin(), fixed_dof.end(), element.row()) != fixed_dof.end()) or
-    //         (std::find(fixed_dof.begin(), fixed_dof.end(), element.col()) != fixed_dof.end()));
-    // };
-    // std::cout << "size of triplets: " << K_g_triplets.size() << std::endl;
-    // K_g_triplets.erase(
-    //     std::remove_if(K_g_triplets.begin(), K_g_triplets.end(), is_in_fixed_dof),
-    //     K_g_triplets.end());
-    // std::cout << "size of triplets: " << K_g_triplets.size() << std::endl;
-    // for (long fixed: fixed_dof)
-    // {
-    //     K_g_triplets.push_back(trip(fixed, fixed, 1.));
-    //     rhs[fixed] = 0;
-    // }
-
-    // for (long i=0; i< this->vertices.cols() * 2; i++)
-    //     K_g_triplets.push_back(trip(i, i, 0.01));
-
-    // lagrange multiplier
-    for (long i=0; i < this->flat_vertices.cols() ; i++)
-    {
-        // fixing total ux
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2, i * 2, 1));
-        // fixing total uy
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 1, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 1, i * 2 + 1, 1));
-        // fixing ux*y-uy*x
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2 + 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 2, this->flat_vertices(0, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2 + 1, this->flat_vertices(0, i)));
+    this->K_relax.resize(n_dof + 3, n_dof + 3);
+    this->K_relax.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
+    this->K_relax.makeCompressed();
+
+    auto slot = [this](long row, long col) -> long {
+        const int* begin = this->K_relax.innerIndexPtr() + this->K_relax.outerIndexPtr()[col];
+        const int* end = this->K_relax.innerIndexPtr() + this->K_relax.outerIndexPtr()[col + 1];
+        return std::lower_bound(begin, end, static_cast<int>(row)) - this->K_relax.innerIndexPtr();
+    };
+
+    // for every non-zero the entries of the element matrices that sum up to it
+    long n_nonzeros = this->K_relax.nonZeros();
+    std::vector<long> slots(n_tri * 36);
+    this->K_relax_offsets.assign(n_nonzeros + 1, 0);
+    for (long i=0; i < n_tri; i++)
+    {
+        for (int e=0; e < 36; e++)
+        {
+            slots[i * 36 + e] = slot(this->triangles(e / 12, i) * 2 + (e / 6) % 2,
+                                     this->triangles((e % 6) / 2, i) * 2 + e % 2);
+            this->K_relax_offsets[slots[i * 36 + e] + 1]++;
+        }
+    }
+    for (long v=0; v < n_nonzeros; v++)
+        this->K_relax_offsets[v + 1] += this->K_relax_offsets[v];
+    this->K_relax_sources.resize(slots.size());
+    std::vector<long> fill(this->K_relax_offsets.begin(), this->K_relax_offsets.end() - 1);
+    for (long j=0; j < static_cast<long>(slots.size()); j++)
+        this->K_relax_sources[fill[slots[j]]++] = j;
+
+    this->lagrange_slots.resize(this->vertices.cols() * 8);
+    for (long i=0; i < this->vertices.cols(); i++)
+    {
+        this->lagrange_slots[i * 8]     = slot(i * 2, n_dof);
+        this->lagrange_slots[i * 8 + 1] = slot(n_dof, i * 2);
+        this->lagrange_slots[i * 8 + 2] = slot(i * 2 + 1, n_dof + 1);
+        this->lagrange_slots[i * 8 + 3] = slot(n_dof + 1, i * 2 + 1);
+        this->lagrange_slots[i * 8 + 4] = slot(i * 2, n_dof + 2);
+        this->lagrange_slots[i * 8 + 5] = slot(n_dof + 2, i * 2);
+        this->lagrange_slots[i * 8 + 6] = slot(i * 2 + 1, n_dof + 2);
+        this->lagrange_slots[i * 8 + 7] = slot(n_dof + 2, i * 2 + 1);
     }
 
-    // project out the nullspace solution:
+    // the triangles adjacent to every vertex to gather the forces
+    this->vertex_offsets.assign(this->vertices.cols() + 1, 0);
+    for (long i=0; i < n_tri; i++)
+        for (int j=0; j < 3; j++)
+            this->vertex_offsets[this->triangles(j, i) + 1]++;
+    for (long v=0; v < this->vertices.cols(); v++)
+        this->vertex_offsets[v + 1] += this->vertex_offsets[v];
+    this->vertex_sources.resize(n_tri * 3);
+    fill.assign(this->vertex_offsets.begin(), this->vertex_offsets.end() - 1);
+    for (long i=0; i < n_tri; i++)
+        for (int j=0; j < 3; j++)
+            this->vertex_sources[fill[this->triangles(j, i)]++] = i * 3 + j;
 
-    // Eigen::VectorXd nullspace1(this->flat_vertices.cols() * 2);
-    // Eigen::VectorXd nullspace2(this->flat_vertices.cols() * 2);
-    // nullspace1.setZero();
-    // nullspace2.setOnes();
-    // for (long i= 0; i < this->flat_vertices.cols(); i++)
-    // {
-    //     nullspace1(i) = 1;
-    //     nullspace2(i) = 0;
-    // }
-    // nullspace1.normalize();
-    // nullspace2.normalize();
-    // rhs -= nullspace1.dot(rhs) * nullspace1;
-    // rhs -= nullspace2.dot(rhs) * nullspace2;
+    this->ldlt_solver.reset();
+}
 
-    K_g.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
-    // rhs +=  K_g * Eigen::VectorXd::Ones(K_g.rows());
+void LscmRelax::relax(double weight)
+{
+    long n_dof = this->vertices.cols() * 2;
+    long n_tri = this->triangles.cols();
+    if (this->K_relax.rows() != n_dof + 3 ||
+        static_cast<long>(this->K_relax_sources.size()) != n_tri * 36)
+        this->init_relax_pattern();
 
-    // solve linear system (privately store the value for guess in next step)
-    Eigen::SimplicialLDLT<spMat, Eigen::Lower> solver;
-    solver.compute(K_g);
-    this->sol = solver.solve(-rhs);
-    this->set_shift(this->sol.head(this->vertices.cols() * 2) * weight);
+    // 1: element stiffness matrices and forces, every triangle is independent
+    ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
+    std::vector<double> K_e(n_tri * 36);
+    std::vector<double> rhs_e(n_tri * 6);
+    parallel_for(n_tri, this->threads, [&](long begin, long end)
+    {
+        Eigen::Matrix<double, 3, 6> B;
+        Eigen::Matrix<double, 2, 2> T;
+        Eigen::Matrix<double, 6, 6> K_m;
+        Eigen::Matrix<double, 6, 1> u_m, rhs_m;
+        Vector2 v1, v2, v3, v12, v23, v31;
+        double A;
+        for (long i=begin; i < end; i++)
+        {
+            // construct B-mat in m-system
+            v1 = this->flat_vertices.col(this->triangles(0, i));
+            v2 = this->flat_vertices.col(this->triangles(1, i));
+            v3 = this->flat_vertices.col(this->triangles(2, i));
+            v12 = v2 - v1;
+            v23 = v3 - v2;
+            v31 = v1 - v3;
+            B << -v23.y(),   0,        -v31.y(),   0,        -v12.y(),   0,
+                  0,         v23.x(),   0,         v31.x(),   0,         v12.x(),
+                 -v23.x(),   v23.y(),  -v31.x(),   v31.y(),  -v12.x(),   v12.y();
+            T << v12.x(), -v12.y(),
+                 v12.y(), v12.x();
+            T /= v12.norm();
+            A = std::abs(this->q_l_m(i, 0) * this->q_l_m(i, 2) / 2);
+            B /= A * 2; // (2*area)
+
+            // sigma due dqlg in m-system
+            u_m << Vector2(0, 0), T * Vector2(d_q_l_g(i, 0), 0), T * Vector2(d_q_l_g(i, 1), d_q_l_g(i, 2));
+
+            // rhs_m = B.T * C * B * dqlg_m
+            // K_m = B.T * C * B
+            K_m = B.transpose() * this->C * B * A;
+            rhs_m = K_m * u_m;
+            for (int a=0; a < 6; a++)
+            {
+                rhs_e[i * 6 + a] = rhs_m[a];
+                for (int b=0; b < 6; b++)
+                    K_e[i * 36 + a * 6 + b] = K_m(a, b);
+            }
+        }
+    });
+
+    // 2: sum up the global stiffness matrix and the forces
+    double* values = this->K_relax.valuePtr();
+    parallel_for(this->K_relax.nonZeros(), this->threads, [&](long begin, long end)
+    {
+        for (long v=begin; v < end; v++)
+        {
+            double value = 0;
+            for (long j=this->K_relax_offsets[v]; j < this->K_relax_offsets[v + 1]; j++)
+                value += K_e[this->K_relax_sources[j]];
+            values[v] = value;
+        }
+    });
+
+    Eigen::VectorXd rhs(n_dof + 3);
+    rhs.setZero();
+    parallel_for(this->vertices.cols(), this->threads, [&](long begin, long end)
+    {
+        for (long i=begin; i < end; i++)
+        {
+            for (long j=this->vertex_offsets[i]; j < this->vertex_offsets[i + 1]; j++)
+            {
+                long source = this->vertex_sources[j];
+                rhs[i * 2]     += rhs_e[(source / 3) * 6 + (source % 3) * 2];
+                rhs[i * 2 + 1] += rhs_e[(source / 3) * 6 + (source % 3) * 2 + 1];
+            }
+            // lagrange multiplier
+            double lagrange[8] = {1, 1, 1, 1,
+                                  -this->flat_vertices(1, i), -this->flat_vertices(1, i),
+                                  this->flat_vertices(0, i), this->flat_vertices(0, i)};
+            for (int k=0; k < 8; k++)
+                values[this->lagrange_slots[i * 8 + k]] = lagrange[k];
+        }
+    });
+
+    // 3: solve linear system (privately store the value for guess in next step)
+    if (this->use_cg)
+    {
+        // the stiffness matrix without the lagrange multipliers is positive semi-definite,
+        // the rigid body motions are projected out of the solution
+        spMat K_g = this->K_relax.topLeftCorner(n_dof, n_dof);
+        Eigen::ConjugateGradient<spMat, Eigen::Lower | Eigen::Upper, NullSpaceProjector> solver;
+        solver.preconditioner().setNullSpace(this->get_nullspace());
+        solver.preconditioner().inv_diagonal = K_g.diagonal().cwiseInverse();
+        solver.setTolerance(this->cg_tolerance);
+        solver.compute(K_g);
+        Eigen::VectorXd guess = Eigen::VectorXd::Zero(n_dof);
+        if (this->sol.size() == n_dof + 3)
+        {
+            // start from the last solution without its rigid body motion
+            const NullSpaceProjector& projector = solver.preconditioner();
+            Eigen::VectorXd last = this->sol.head(n_dof);
+            guess = last - projector.null_space_1 * (projector.null_space_2 * last);
+        }
+        Eigen::VectorXd neg_rhs = -rhs.head(n_dof);
+        Eigen::VectorXd u = solver.solveWithGuess(neg_rhs, guess);
+        this->sol.setZero(n_dof + 3);
+        this->sol.head(n_dof) = u;
+    }
+    else
+    {
+        // the pattern doesn't change, so the symbolic factorization is reused
+        if (!this->ldlt_solver)
+        {
+            this->ldlt_solver = std::make_shared<Eigen::SimplicialLDLT<spMat, Eigen::Lower>>();
+            this->ldlt_solver->analyzePattern(this->K_relax);
+        }
+        this->ldlt_solver->factorize(this->K_relax);
+        this->sol = this->ldlt_solver->solve(-rhs);
+    }
+    this->set_shift(this->sol.head(n_dof) * weight);
     this->set_q_l_m();
 }
 
@@ -481,10 +571,21 @@ void LscmRelax::lscm()
 
     // 6. solve the system and set the flatted coordinates
     // Eigen::SparseQR<spMat, Eigen::COLAMDOrdering<int> > solver;
-    Eigen::LeastSquaresConjugateGradient<spMat > solver;
     Eigen::VectorXd sol(this->vertices.size() * 2);
-    solver.compute(A);
-    sol = solver.solve(-rhs);
+    if (this->use_cg)
+    {
+        Eigen::LeastSquaresConjugateGradient<spMat > solver;
+        solver.compute(A);
+        sol = solver.solve(-rhs);
+    }
+    else
+    {
+        // with at least two fixed pins A has full rank and the normal equations are
+        // positive definite
+        spMat AtA = A.transpose() * A;
+        Eigen::SimplicialLDLT<spMat> solver(AtA);
+        sol = solver.solve(A.transpose() * -rhs);
+    }
 
     // TODO: create function, is needed also in the fem step
     this->set_position(sol);
@@ -700,7 +801,7 @@ std::vector<long> LscmRelax::get_fem_fixed_pins()
 Eigen::MatrixXd LscmRelax::get_nullspace()
 {
     Eigen::MatrixXd null_space;
-    null_space.setZero(this->flat_vertices.size() * 2, 3);
+    null_space.setZero(this->flat_vertices.cols() * 2, 3);
 
     for (int i=0; i<this->flat_vertices.cols(); i++)
     {
@@ -39,6 +39,9 @@
 #include <tuple>
 #include <vector>
 
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
+
 #include "MeshFlattening.h"
 
 
@@ -52,10 +55,15 @@ class NullSpaceProjector: public Eigen::IdentityPreconditioner
   public:
     Eigen::MatrixXd null_space_1;
     Eigen::MatrixXd null_space_2;
+    Eigen::VectorXd inv_diagonal;  // optional jacobi scaling between the projections
 
     template<typename Rhs>
     inline Rhs solve(Rhs& b) const {
-        return b - this->null_space_1 * (this->null_space_2 * b);
+        if (this->inv_diagonal.size() == 0)
+            return b - this->null_space_1 * (this->null_space_2 * b);
+        Rhs p = b - this->null_space_1 * (this->null_space_2 * b);
+        p = p.cwiseProduct(this->inv_diagonal);
+        return p - this->null_space_1 * (this->null_space_2 * p);
     }
 
     void setNullSpace(Eigen::MatrixXd null_space) {
@@ -88,6 +96,18 @@ private:
     std::vector<long> get_fem_fixed_pins();
     Eigen::MatrixXd get_nullspace();
 
+    // the stiffness matrix of the relaxation keeps its pattern over all iterations,
+    // the entries of the element matrices are summed up into the values directly
+    void init_relax_pattern();
+    spMat K_relax;
+    std::vector<long> K_relax_offsets;  // per non-zero: range in K_relax_sources
+    std::vector<long> K_relax_sources;  // entry of the element matrices (triangle * 36 + a * 6 + b)
+    std::vector<long> lagrange_slots;   // per vertex: the 8 non-zeros of the lagrange multipliers
+    std::vector<long> vertex_offsets;   // per vertex: range in vertex_sources
+    std::vector<long> vertex_sources;   // corner of a triangle (triangle * 3 + j)
+    // shared to keep the class copyable, Eigen's solvers are not
+    std::shared_ptr<Eigen::SimplicialLDLT<spMat, Eigen::Lower>> ldlt_solver;
+
 public:
     LscmRelax() {}
     LscmRelax(
@@ -105,6 +125,13 @@ public:
     double nue=0.9;
     double elasticity=1.;
 
+    // solve the lscm and the relaxation with conjugate gradient solvers instead of
+    // sparse LDLT factorizations, the relaxation starts with the last solution
+    bool use_cg=false;
+    double cg_tolerance=1e-8;
+    // number of threads to assemble the stiffness matrix, 0 uses all cores
+    int threads=0;
+
     void lscm();
     void relax(double);
     void area_relax(double);
@@ -112,6 +112,9 @@ PYBIND11_MODULE(flatmesh, m)
         .def("transform", &lscmrelax::LscmRelax::transform)
         .def_readonly("rhs", &lscmrelax::LscmRelax::rhs)
         .def_readonly("MATRIX", &lscmrelax::LscmRelax::MATRIX)
+        .def_readwrite("use_cg", &lscmrelax::LscmRelax::use_cg)
+        .def_readwrite("cg_tolerance", &lscmrelax::LscmRelax::cg_tolerance)
+        .def_readwrite("threads", &lscmrelax::LscmRelax::threads)
         .def_property_readonly("area", &lscmrelax::LscmRelax::get_area)
         .def_property_readonly("flat_area", &lscmrelax::LscmRelax::get_flat_area)
         .def_property_readonly("flat_vertices", [](lscmrelax::LscmRelax& L){return L.flat_vertices.transpose();}, py::return_value_policy::copy)
@@ -23,17 +23,14 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <cfloat>
-# include <sstream>
 
 # include <BRep_Builder.hxx>
 # include <BRepBuilderAPI_MakePolygon.hxx>
 # include <TopoDS.hxx>
 # include <TopoDS_Compound.hxx>
 
-# include <QFuture>
 # include <QKeyEvent>
 # include <QMessageBox>
-# include <QtConcurrentMap>
 
 # include <Inventor/nodes/SoBaseColor.h>
 # include <Inventor/nodes/SoCoordinate3.h>
@@ -45,7 +42,6 @@
 #include <App/Document.h>
 #include <Gui/Application.h>
 #include <Gui/BitmapFactory.h>
-#include <Gui/Command.h>
 #include <Gui/Document.h>
 #include <Gui/ViewProvider.h>
 #include <Gui/View3DInventor.h>
@@ -53,15 +49,12 @@
 #include <Mod/Mesh/App/MeshFeature.h>
 #include <Mod/Part/App/PartFeature.h>
 #include <Mod/Part/App/Tools.h>
-#include <Mod/Mesh/App/Core/Algorithm.h>
-#include <Mod/Mesh/App/Core/Grid.h>
 
 #include "CrossSections.h"
 #include "ui_CrossSections.h"
 
 
 using namespace MeshPartGui;
-namespace bp = boost::placeholders;
 
 namespace MeshPartGui {
 class ViewProviderCrossSections : public Gui::ViewProvider
@@ -120,51 +113,6 @@ private:
     SoCoordinate3* coords;
     SoLineSet* planes;
 };
-
-class MeshCrossSection {
-public:
-    MeshCrossSection(const MeshCore::MeshKernel& mesh,
-                     const MeshCore::MeshFacetGrid& grid,
-                     double x, double y, double z,
-                     bool connectEdges, double eps)
-        : mesh(mesh)
-        , grid(grid)
-        , x(x)
-        , y(y)
-        , z(z)
-        , connectEdges(connectEdges)
-        , epsilon(eps)
-    {
-    }
-    std::list<TopoDS_Wire> section(double d)
-    {
-        Mesh::MeshObject::TPolylines polylines;
-        MeshCore::MeshAlgorithm algo(mesh);
-        Base::Vector3f p(x*d, y*d, z*d);
-        Base::Vector3f n(x, y, z);
-        algo.CutWithPlane(p, n, grid, polylines, epsilon, connectEdges);
-
-        std::list<TopoDS_Wire> wires;
-        for (auto it = polylines.begin(); it != polylines.end(); ++it) {
-            BRepBuilderAPI_MakePolygon mkPoly;
-            for (auto jt = it->begin(); jt != it->end(); ++jt) {
-                mkPoly.Add(Base::convertTo<gp_Pnt>(*jt));
-            }
-
-            if (mkPoly.IsDone())
-                wires.push_back(mkPoly.Wire());
-        }
-
-        return wires;
-    }
-
-private:
-    const MeshCore::MeshKernel& mesh;
-    const MeshCore::MeshFacetGrid& grid;
-    double x,y,z;
-    bool connectEdges;
-    double epsilon;
-};
 }
 
 CrossSections::CrossSections(const Base::BoundBox3d& bb, QWidget* parent, Qt::WindowFlags fl)
@@ -285,87 +233,49 @@ void CrossSections::apply()
     bool connectEdges = ui->checkBoxConnect->isChecked();
     double eps = ui->spinEpsilon->value();
 
-#if 1 // multi-threaded sections
-    for (std::vector<App::DocumentObject*>::iterator it = obj.begin(); it != obj.end(); ++it) {
-        const Mesh::MeshObject& mesh = static_cast<Mesh::Feature*>(*it)->Mesh.getValue();
+    try {
+        std::vector<Mesh::MeshObject::TPlane> planes;
+        planes.reserve(d.size());
+        Base::Vector3f n(a, b, c);
+        for (double dist : d) {
+            Base::Vector3f p(a*dist, b*dist, c*dist);
+            planes.emplace_back(p, n);
+        }
 
-        MeshCore::MeshKernel kernel(mesh.getKernel());
-        kernel.Transform(mesh.getTransform());
+        for (std::vector<App::DocumentObject*>::iterator it = obj.begin(); it != obj.end(); ++it) {
+            const Mesh::MeshObject& mesh = static_cast<Mesh::Feature*>(*it)->Mesh.getValue();
 
-        MeshCore::MeshFacetGrid grid(kernel);
+            std::vector<Mesh::MeshObject::TPolylines> sections;
+            mesh.crossSections(planes, sections, eps, connectEdges);
 
-        MeshCrossSection cs(kernel, grid, a, b, c, connectEdges, eps);
-        QFuture< std::list<TopoDS_Wire> > future = QtConcurrent::mapped
-            (d, boost::bind(&MeshCrossSection::section, &cs, bp::_1));
-        future.waitForFinished();
+            TopoDS_Compound comp;
+            BRep_Builder builder;
+            builder.MakeCompound(comp);
 
-        TopoDS_Compound comp;
-        BRep_Builder builder;
-        builder.MakeCompound(comp);
+            for (const auto& polylines : sections) {
+                for (const auto& polyline : polylines) {
+                    BRepBuilderAPI_MakePolygon mkPoly;
+                    for (const auto& pnt : polyline) {
+                        mkPoly.Add(Base::convertTo<gp_Pnt>(pnt));
+                    }
 
-        for (auto ft = future.begin(); ft != future.end(); ++ft) {
-            const std::list<TopoDS_Wire>& w = *ft;
-            for (std::list<TopoDS_Wire>::const_iterator wt = w.begin(); wt != w.end(); ++wt) {
-                if (!wt->IsNull())
-                    builder.Add(comp, *wt);
+                    if (mkPoly.IsDone())
+                        builder.Add(comp, mkPoly.Wire());
+                }
             }
-        }
 
-        App::Document* doc = (*it)->getDocument();
-        std::string s = (*it)->getNameInDocument();
-        s += "_cs";
-        Part::Feature* section = static_cast<Part::Feature*>
-            (doc->addObject("Part::Feature",s.c_str()));
-        section->Shape.setValue(comp);
-        section->purgeTouched();
-    }
-#else
-    try {
-        Gui::Command::runCommand(Gui::Command::App, "import Mesh, Part\n");
-        Gui::Command::runCommand(Gui::Command::App, "from FreeCAD import Base\n");
-
-        std::stringstream str;
-        str << "[";
-        for (std::vector<double>::iterator jt = d.begin(); jt != d.end(); ++jt) {
-            double d = *jt;
-            str << "("
-                << "App.Vector(" << a*d << ", " << b*d << ", " << c*d << "), "
-                << "App.Vector(" << a   << ", " << b   << ", " << c   << ")"
-                << "), ";
-        }
-        str << "]";
-
-        QString planes = QString::fromStdString(str.str());
-        for (std::vector<App::DocumentObject*>::iterator it = obj.begin(); it != obj.end(); ++it) {
             App::Document* doc = (*it)->getDocument();
             std::string s = (*it)->getNameInDocument();
             s += "_cs";
-            Gui::Command::runCommand(Gui::Command::App, QString::fromLatin1(
-                "points=FreeCAD.getDocument(\"%1\").%2.Mesh.crossSections(%3, %4, %5)\n"
-                "wires=[]\n"
-                "for i in points:\n"
-                "    wires.extend([Part.makePolygon(j) for j in i])\n")
-                .arg(QLatin1String(doc->getName()))
-                .arg(QLatin1String((*it)->getNameInDocument()))
-                .arg(planes)
-                .arg(eps)
-                .arg(connectEdges ? QLatin1String("True") : QLatin1String("False"))
-                .toLatin1());
-
-            Gui::Command::runCommand(Gui::Command::App, QString::fromLatin1(
-                "comp=Part.Compound(wires)\n"
-                "slice=FreeCAD.getDocument(\"%1\").addObject(\"Part::Feature\",\"%2\")\n"
-                "slice.Shape=comp\n"
-                "slice.purgeTouched()\n"
-                "del slice,comp,wires,points")
-                .arg(QLatin1String(doc->getName()))
-                .arg(QLatin1String(s.c_str())).toLatin1());
+            Part::Feature* section = static_cast<Part::Feature*>
+                (doc->addObject("Part::Feature",s.c_str()));
+            section->Shape.setValue(comp);
+            section->purgeTouched();
         }
     }
     catch (const Base::Exception& e) {
         QMessageBox::critical(this, tr("Failure"), QString::fromLatin1(e.what()));
     }
-#endif
 }
 
 void CrossSections::xyPlaneClicked()
@@ -23,3 +23,5 @@
 #*   USA                                                                   *
 #*                                                                         *
 #***************************************************************************/
+
+FreeCAD.__unit_test__ += [ "TestMeshPartApp" ]
@@ -0,0 +1,87 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+import math
+import unittest
+
+import FreeCAD  # noqa: F401
+
+try:
+    import numpy as np
+    import flatmesh
+except ImportError:
+    flatmesh = None
+
+
+def _cylinderPatch(rows, cols, radius=10.0, angle=1.5, height=10.0):
+    verts = []
+    for j in range(rows):
+        for i in range(cols):
+            phi = angle * i / (cols - 1)
+            verts.append((radius * math.cos(phi), radius * math.sin(phi), height * j / (rows - 1)))
+    tris = []
+    for j in range(rows - 1):
+        for i in range(cols - 1):
+            a = j * cols + i
+            tris.append((a, a + 1, a + cols + 1))
+            tris.append((a, a + cols + 1, a + cols))
+    return np.array(verts), np.array(tris, dtype=int)
+
+
+@unittest.skipIf(flatmesh is None, "flatmesh is not available")
+class LscmRelaxTestCases(unittest.TestCase):
+    def setUp(self):
+        self.verts, self.tris = _cylinderPatch(25, 30)
+
+    def flattener(self):
+        flat = flatmesh.LscmRelax(self.verts, self.tris, [])
+        flat.lscm()
+        return flat
+
+    def testRelaxConjugateGradient(self):
+        # the conjugate gradient solver starts each step from the last solution while
+        # the direct solver doesn't need a guess, both must end at the same result
+        direct = self.flattener()
+        iterative = self.flattener()
+        iterative.use_cg = True
+        iterative.cg_tolerance = 1e-12
+        iterative.threads = 4
+        extent = np.ptp(direct.flat_vertices, axis=0).max()
+        for _ in range(3):
+            direct.relax(0.9)
+            iterative.relax(0.9)
+            diff = np.abs(direct.flat_vertices - iterative.flat_vertices).max()
+            self.assertLess(diff, 1e-6 * extent)
+
+        # the sheet is developable, so the relaxation keeps its area
+        self.assertAlmostEqual(iterative.flat_area / iterative.area, 1.0, places=2)
+
+    def testRelaxThreads(self):
+        serial = self.flattener()
+        serial.threads = 1
+        parallel = self.flattener()
+        parallel.threads = 4
+        for _ in range(2):
+            serial.relax(0.9)
+            parallel.relax(0.9)
+        self.assertTrue(np.array_equal(serial.flat_vertices, parallel.flat_vertices))
@@ -27,6 +27,8 @@
 
 #ifndef _PreComp_
 # include <cfloat>
+# include <exception>
+# include <sstream>
 
 # include <boost_geometry.hpp>
 # include <boost/geometry/geometries/register/point.hpp>
@@ -39,6 +41,7 @@
 # include <BRepAdaptor_Curve.hxx>
 # include <BRepAdaptor_Surface.hxx>
 # include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_MakeEdge.hxx>
 # include <BRepBuilderAPI_MakeFace.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
@@ -61,6 +64,7 @@
 # include <ShapeExtend_WireData.hxx>
 # include <ShapeFix_ShapeTolerance.hxx>
 # include <ShapeFix_Wire.hxx>
+# include <Standard.hxx>
 # include <Standard_Failure.hxx>
 # include <Standard_Version.hxx>
 # include <TopExp.hxx>
@@ -72,6 +76,7 @@
 #include <App/Application.h>
 #include <App/Document.h>
 #include <Base/Exception.h>
+#include <Base/Parallel.h>
 #include <Mod/Part/App/CrossSection.h>
 #include <Mod/Part/App/FaceMakerBullseye.h>
 #include <Mod/Part/App/PartFeature.h>
@@ -1323,7 +1328,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     if (plane.IsNull())
         throw Base::ValueError("failed to obtain section plane");
 
-    FC_TIME_INIT2(t, t1);
+    FC_TIME_INIT(t);
 
     TopLoc_Location loc(trsf);
 
@@ -1458,7 +1463,22 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     bool can_retry = fabs(tolerance) > Precision::Confusion();
     TopLoc_Location locInverse(loc.Inverted());
 
-    for (size_t i = 0; i < heights.size(); ++i) {
+    // The result of the section at each height, computed independently of
+    // each other. Warnings are collected here and reported by the calling
+    // thread, because the console is not safe to be used from other threads.
+    struct SectionResult {
+        shared_ptr<Area> area;
+        std::vector<std::string> warnings;
+        std::exception_ptr error;
+
+        void warn(const std::string& msg) {
+            warnings.push_back(msg);
+        }
+    };
+    std::vector<SectionResult> results(heights.size());
+
+    auto makeSection = [&](size_t i, const std::list<Shape>& shapes, SectionResult& result) {
+        FC_TIME_INIT(t1);
         double z = heights[i];
         bool retried = !can_retry;
         while (true) {
@@ -1479,11 +1499,11 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                     TopLoc_Location wloc(t);
                     area->add(s.shape.Moved(wloc).Moved(locInverse), s.op);
                 }
-                sections.push_back(area);
+                result.area = area;
                 break;
             }
 
-            for (auto it = myShapes.begin(); it != myShapes.end(); ++it) {
+            for (auto it = shapes.begin(); it != shapes.end(); ++it) {
                 const auto& s = *it;
                 BRep_Builder builder;
                 TopoDS_Compound comp;
@@ -1511,7 +1531,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                         mkFace.Build();
                         const TopoDS_Shape& shape = mkFace.Shape();
                         if (shape.IsNull())
-                            AREA_WARN("FaceMakerBullseye return null shape on section");
+                            result.warn("FaceMakerBullseye return null shape on section");
                         else {
                             showShape(shape, nullptr, "section_%u_face", i);
                             for (auto it = wires.begin(), itNext = it; it != wires.end(); it = itNext) {
@@ -1527,7 +1547,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                         }
                     }
                     catch (Base::Exception& e) {
-                        AREA_WARN("FaceMakerBullseye failed on section: " << e.what());
+                        result.warn(std::string("FaceMakerBullseye failed on section: ") + e.what());
                     }
                     for (const TopoDS_Wire& wire : wires)
                         builder.Add(comp, wire);
@@ -1541,7 +1561,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 }
                 else if (area->myShapes.empty()) {
                     auto itNext = it;
-                    if (++itNext != myShapes.end() &&
+                    if (++itNext != shapes.end() &&
                         (itNext->op == OperationIntersection ||
                             itNext->op == OperationDifference))
                     {
@@ -1550,13 +1570,13 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 }
             }
             if (!area->myShapes.empty()) {
-                sections.push_back(area);
+                result.area = area;
                 FC_TIME_LOG(t1, "makeSection " << z);
                 showShape(area->getShape(), nullptr, "section_%u_final", i);
                 break;
             }
             if (retried) {
-                AREA_WARN("Discard empty section");
+                result.warn("Discard empty section");
                 break;
             }
             else {
@@ -1565,6 +1585,43 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 retried = true;
             }
         }
+    };
+
+    // Showing the intermediate shapes and logging only work in the main
+    // thread, so the sections are computed serially when debugging.
+    int threads = myParams.SectionThreads;
+    if (FC_LOG_INSTANCE.isEnabled(FC_LOGLEVEL_LOG))
+        threads = 1;
+    else
+        Standard::SetReentrant(Standard_True);
+
+    Base::parallel_for(heights.size(), threads, [&](size_t first, size_t last) {
+        // Boolean operations may modify the tolerance of the input shapes,
+        // so unless a single thread does all sections, each works on a copy.
+        std::list<Shape> copies;
+        bool copy = !project && (first != 0 || last != heights.size());
+        if (copy) {
+            for (const Shape& s : myShapes)
+                copies.emplace_back(s.op, BRepBuilderAPI_Copy(s.shape).Shape());
+        }
+        for (size_t i = first; i < last; ++i) {
+            try {
+                makeSection(i, copy ? copies : myShapes, results[i]);
+            }
+            catch (...) {
+                results[i].error = std::current_exception();
+                break;
+            }
+        }
+    });
+
+    for (SectionResult& result : results) {
+        for (const std::string& warning : result.warnings)
+            AREA_WARN(warning);
+        if (result.error)
+            std::rethrow_exception(result.error);
+        if (result.area)
+            sections.push_back(result.area);
     }
     FC_TIME_LOG(t, "makeSection count: " << sections.size() << ", total");
     return sections;
@@ -1953,63 +2010,72 @@ void Area::makeOffset(list<shared_ptr<CArea> >& areas,
         else
             last_stepover = 0;
     }
-    for (int i = 0; count < 0 || i < count; ++i, offset += stepover) {
-        if (from_center)
-            areas.push_front(make_shared<CArea>());
-        else
-            areas.push_back(make_shared<CArea>());
-        CArea& area = from_center ? (*areas.front()) : (*areas.back());
-        CArea areaOpen;
+    // The passes are independent offsets of myArea, so a batch of them is computed at
+    // once. When looping until clipper gives no output, a batch holds one pass per
+    // thread and the passes after the first empty one are dropped.
+    int threads = myParams.OffsetThreads > 0 ? (int)myParams.OffsetThreads : Base::idealThreadCount();
+    std::vector<double> offsets;
+    std::vector<CArea> results;
+    for (int i = 0; count < 0 || i < count;) {
+        offsets.clear();
+        double value = offset;
+        for (long k = count < 0 ? std::max(threads, 1) : count - i; k > 0; --k, value += stepover)
+            offsets.push_back(value);
+
 #ifdef AREA_OFFSET_ALGO
         if (myParams.Algo == Area::Algolibarea) {
-            for (const CCurve& c : myArea->m_curves) {
-                if (c.IsClosed())
-                    area.append(c);
-                else
-                    areaOpen.append(c);
+            results.assign(offsets.size(), CArea());
+            for (size_t k = 0; k < offsets.size(); ++k) {
+                CArea& area = results[k];
+                CArea areaOpen;
+                for (const CCurve& c : myArea->m_curves) {
+                    if (c.IsClosed())
+                        area.append(c);
+                    else
+                        areaOpen.append(c);
+                }
+                // libarea somehow fails offset without Reorder, but ClipperOffset
+                // works okay. Don't know why
+                area.Reorder();
+                area.Offset(-offsets[k]);
+                if (areaOpen.m_curves.size()) {
+                    areaOpen.Thicken(offsets[k]);
+                    area.Clip(ClipperLib::ctUnion, &areaOpen, SubjectFill, ClipFill);
+                }
             }
         }
         else
 #endif
-            area = *myArea;
-
-#ifdef AREA_OFFSET_ALGO
-        switch (myParams.Algo) {
-        case Area::Algolibarea:
-            // libarea somehow fails offset without Reorder, but ClipperOffset
-            // works okay. Don't know why
-            area.Reorder();
-            area.Offset(-offset);
-            if (areaOpen.m_curves.size()) {
-                areaOpen.Thicken(offset);
-                area.Clip(ClipperLib::ctUnion, &areaOpen, SubjectFill, ClipFill);
+            myArea->OffsetsWithClipper(offsets, results, JoinType, EndType,
+                myParams.MiterLimit, myParams.RoundPrecision, threads);
+
+        bool stop = false;
+        for (CArea& area : results) {
+            if (count > 1)
+                FC_TIME_LOG(t1, "makeOffset " << i << '/' << count);
+            if (area.m_curves.empty()) {
+                if (areas.empty()) {
+                    stop = true;
+                    break;
+                }
+                if (last_stepover && last_stepover > stepover) {
+                    // the next batch starts with this pass using the last stepover
+                    offset -= stepover;
+                    stepover = last_stepover;
+                    offset += stepover;
+                    break;
+                }
+                return;
             }
-            break;
-        case Area::AlgoClipperOffset:
-#endif
-            area.OffsetWithClipper(offset, JoinType, EndType,
-                myParams.MiterLimit, myParams.RoundPrecision);
-#ifdef AREA_OFFSET_ALGO
-            break;
-        }
-#endif
-        if (count > 1)
-            FC_TIME_LOG(t1, "makeOffset " << i << '/' << count);
-        if (area.m_curves.empty()) {
             if (from_center)
-                areas.pop_front();
+                areas.push_front(make_shared<CArea>(std::move(area)));
             else
-                areas.pop_back();
-            if (areas.empty())
-                break;
-            if (last_stepover && last_stepover > stepover) {
-                offset -= stepover;
-                stepover = last_stepover;
-                --i;
-                continue;
-            }
-            return;
+                areas.push_back(make_shared<CArea>(std::move(area)));
+            ++i;
+            offset += stepover;
         }
+        if (stop)
+            break;
     }
     FC_TIME_LOG(t, "makeOffset count: " << count);
 }
@@ -3212,12 +3278,16 @@ static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
 static inline void addG1(bool verbose, Toolpath& path, const gp_Pnt& last,
     const gp_Pnt& next, double f, double& last_f)
 {
-    addGCode(verbose, path, last, next, "G1");
+    Command cmd;
+    cmd.Name = "G1";
+    addParameter(verbose, cmd, "X", last.X(), next.X());
+    addParameter(verbose, cmd, "Y", last.Y(), next.Y());
+    addParameter(verbose, cmd, "Z", last.Z(), next.Z());
     if (f > Precision::Confusion()) {
-        Command* cmd = path.getCommands().back();
-        addParameter(verbose, *cmd, "F", last_f, f);
+        addParameter(verbose, cmd, "F", last_f, f);
         last_f = f;
     }
+    path.addCommand(cmd);
     return;
 }
 
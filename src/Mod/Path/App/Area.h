@@ -148,7 +148,8 @@ protected:
 
     /** Obtain a list of offset areas
      *
-     * See #AREA_PARAMS_OFFSET for description of the arguments.
+     * See #AREA_PARAMS_OFFSET for description of the arguments. The passes are
+     * computed in up to \c OffsetThreads threads.
      */
     void makeOffset(std::list<std::shared_ptr<CArea> >& areas,
         PARAM_ARGS_DEF(PARAM_FARG, AREA_PARAMS_OFFSET), bool from_center = false);
@@ -234,6 +235,9 @@ public:
      * \arg \c plane: the section plane if the section mode is
      * SectionModeWorkplane, otherwise ignored
      *
+     * The sections at different heights are computed in up to \c SectionThreads
+     * threads, and returned in the order of their heights.
+     *
      * See #AREA_PARAMS_EXTRA for description of the arguments. Currently, there
      * is only one argument, namely \c mode for section mode.
      */
@@ -160,6 +160,8 @@
         "When the section hits or over the shape boundary, a section with the height of that boundary\n"\
         "will be created. A small offset is usually required to avoid the tangential cut.",\
         App::PropertyPrecision))\
+    ((long,threads,SectionThreads,0,"Number of threads used to compute the sections. 0 means as many\n"\
+        "threads as available cores, 1 computes the sections one after another."))\
      AREA_PARAMS_SECTION_EXTRA
 
 #ifdef AREA_OFFSET_ALGO
@@ -180,7 +182,9 @@
         "Miter limit for joint type Miter. See https://goo.gl/K8xX9h",App::PropertyFloat))\
     ((double,round_precision,RoundPrecision,0.0,\
         "Round joint precision. If =0, it defaults to Accuracy. \n"\
-        "See https://goo.gl/4odfQh",App::PropertyPrecision))
+        "See https://goo.gl/4odfQh",App::PropertyPrecision))\
+    ((long,offset_threads,OffsetThreads,0,"Number of threads used to compute the offset passes. 0 means\n"\
+        "as many threads as available cores, 1 computes the passes one after another."))
 
 #define AREA_PARAMS_MIN_DIST \
     ((double, min_dist, MinDistance, 0.0, \
@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <charconv>
 # include <cinttypes>
 # include <iomanip>
 # include <boost/algorithm/string.hpp>
@@ -99,40 +100,52 @@ bool Command::has(const std::string& attr) const
 
 std::string Command::toGCode (int precision, bool padzero) const
 {
-    std::stringstream str;
-    str.fill('0');
-    str << Name;
+    std::string str = Name;
+    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+        if(i->first == "N") continue;
+
+        str += ' ';
+        str += i->first;
+        appendValue(str, i->second, precision, padzero);
+    }
+    return str;
+}
+
+void Command::appendValue(std::string &str, double value, int precision, bool padzero)
+{
+    static const double powers[] = {1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+                                    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
     if(precision<0)
         precision = 0;
-    double scale = std::pow(10.0,precision+1);
+    double scale = precision < 18 ? powers[precision] : std::pow(10.0,precision+1);
     std::int64_t iscale = static_cast<std::int64_t>(scale)/10;
-    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
-        if(i->first == "N") continue;
 
-        str << " " << i->first;
+    char buf[32];
+    std::int64_t v = static_cast<std::int64_t>(value*scale);
+    if(v<0) {
+        v = -v;
+        str += '-'; //shall we allow -0 ?
+    }
+    v+=5;
+    v /= 10;
+    str.append(buf, std::to_chars(buf, buf + sizeof(buf), v/iscale).ptr);
+    if(!precision) return;
 
-        std::int64_t v = static_cast<std::int64_t>(i->second*scale);
-        if(v<0) {
-            v = -v;
-            str << '-'; //shall we allow -0 ?
-        }
-        v+=5;
-        v /= 10;
-        str << (v/iscale);
-        if(!precision) continue;
-
-        int width = precision;
-        std::int64_t digits = v%iscale;
-        if(!padzero) {
-            if(!digits) continue;
-            while(digits%10 == 0) {
-                digits/=10;
-                --width;
-            }
+    int width = precision;
+    std::int64_t digits = v%iscale;
+    if(!padzero) {
+        if(!digits) return;
+        while(digits%10 == 0) {
+            digits/=10;
+            --width;
         }
-        str << '.' << std::setw(width) << std::right << digits;
     }
-    return str.str();
+    str += '.';
+    int len = static_cast<int>(std::to_chars(buf, buf + sizeof(buf), digits).ptr - buf);
+    if(len < width)
+        str.append(width - len, '0');
+    str.append(buf, len);
 }
 
 void Command::setFromGCode (const std::string& str)
@@ -280,6 +293,30 @@ Command Command::transform(const Base::Placement& other)
     return c;
 }
 
+CommandCode Command::getCode(const std::string& name)
+{
+    static const std::map<std::string, CommandCode> codes = {
+        {"G0", CommandCode::Rapid}, {"G00", CommandCode::Rapid},
+        {"G1", CommandCode::Linear}, {"G01", CommandCode::Linear},
+        {"G2", CommandCode::ArcCW}, {"G02", CommandCode::ArcCW},
+        {"G3", CommandCode::ArcCCW}, {"G03", CommandCode::ArcCCW},
+        {"G73", CommandCode::Drill}, {"G81", CommandCode::Drill},
+        {"G82", CommandCode::Drill}, {"G83", CommandCode::Drill},
+        {"G84", CommandCode::Drill}, {"G85", CommandCode::Drill},
+        {"G86", CommandCode::Drill}, {"G89", CommandCode::Drill},
+        {"G38.2", CommandCode::Probe}, {"G38.3", CommandCode::Probe},
+        {"G38.4", CommandCode::Probe}, {"G38.5", CommandCode::Probe},
+        {"G90", CommandCode::Absolute}, {"G91", CommandCode::Relative},
+        {"G90.1", CommandCode::AbsoluteCenter}, {"G91.1", CommandCode::RelativeCenter},
+        {"G17", CommandCode::PlaneXY}, {"G18", CommandCode::PlaneXZ},
+        {"G19", CommandCode::PlaneYZ},
+        {"G98", CommandCode::RetractInitial}, {"G99", CommandCode::RetractR}
+    };
+
+    auto it = codes.find(name);
+    return it == codes.end() ? CommandCode::Other : it->second;
+}
+
 void Command::scaleBy(double factor)
 {
     for(std::map<std::string, double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
@@ -24,6 +24,7 @@
 #ifndef PATH_COMMAND_H
 #define PATH_COMMAND_H
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <Base/Persistence.h>
@@ -32,6 +33,27 @@
 
 namespace Path
 {
+    /** The kinds of commands the path algorithms interpret */
+    enum class CommandCode : std::uint8_t
+    {
+        Other,
+        Rapid,          // G0
+        Linear,         // G1
+        ArcCW,          // G2
+        ArcCCW,         // G3
+        Drill,          // G73, G81 - G86, G89
+        Probe,          // G38.2 - G38.5
+        Absolute,       // G90
+        Relative,       // G91
+        AbsoluteCenter, // G90.1
+        RelativeCenter, // G91.1
+        PlaneXY,        // G17
+        PlaneXZ,        // G18
+        PlaneYZ,        // G19
+        RetractInitial, // G98
+        RetractR        // G99
+    };
+
     /** The representation of a cnc command in a path */
     class PathExport Command : public Base::Persistence
     {
@@ -59,6 +81,9 @@ namespace Path
         Command transform(const Base::Placement&); // returns a transformed copy of this command
         double getValue(const std::string &name) const; // returns the value of a given parameter
         void scaleBy(double factor); // scales the receiver - use for imperial/metric conversions
+        CommandCode getCode() const { return getCode(Name); } // returns the kind of the command
+        static CommandCode getCode(const std::string &name); // returns the kind of the given upper case command name
+        static void appendValue(std::string &str, double value, int precision=6, bool padzero=true); // appends a value formatted like toGCode() does
 
         // this assumes the name is upper case
         inline double getParam(const std::string &name, double fallback = 0.0) const {
@@ -21,9 +21,17 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <atomic>
+# include <charconv>
+# include <cstdlib>
+# include <iterator>
+#endif
 
 #include <App/Application.h>
 #include <Base/Console.h>
+#include <Base/Parallel.h>
 #include <Base/Reader.h>
 #include <Base/Stream.h>
 #include <Base/Writer.h>
@@ -37,21 +45,57 @@ using namespace Base;
 
 TYPESYSTEM_SOURCE(Path::Toolpath , Base::Persistence)
 
+namespace {
+
+const char* const axisNames[Toolpath::AxisCount] = {
+    "X", "Y", "Z", "A", "B", "C", "I", "J", "K", "F"
+};
+
+// returns the column of the given word or -1 if it has none
+int axisOf(char key)
+{
+    switch (key) {
+    case 'X': return Toolpath::AxisX;
+    case 'Y': return Toolpath::AxisY;
+    case 'Z': return Toolpath::AxisZ;
+    case 'A': return Toolpath::AxisA;
+    case 'B': return Toolpath::AxisB;
+    case 'C': return Toolpath::AxisC;
+    case 'I': return Toolpath::AxisI;
+    case 'J': return Toolpath::AxisJ;
+    case 'K': return Toolpath::AxisK;
+    case 'F': return Toolpath::AxisF;
+    default:  return -1;
+    }
+}
+
+int axisOf(const std::string &name)
+{
+    return name.size() == 1 ? axisOf(name[0]) : -1;
+}
+
+}
+
+namespace {
+
+// the revisions are unique among all toolpaths so that a revision identifies the contents
+std::atomic<std::uint64_t> lastRevision(0);
+
+}
+
 Toolpath::Toolpath()
+    : revision(++lastRevision)
 {
+    wordOffsets.push_back(0);
 }
 
 Toolpath::Toolpath(const Toolpath& otherPath)
-    : vpcCommands(otherPath.vpcCommands.size())
-    , center(otherPath.center)
 {
     *this = otherPath;
-    recalculate();
 }
 
 Toolpath::~Toolpath()
 {
-    clear();
 }
 
 Toolpath &Toolpath::operator=(const Toolpath& otherPath)
@@ -59,75 +103,215 @@ Toolpath &Toolpath::operator=(const Toolpath& otherPath)
     if (this == &otherPath)
         return *this;
 
-    clear();
-    vpcCommands.resize(otherPath.vpcCommands.size());
-    int i = 0;
-    for (std::vector<Command*>::const_iterator it=otherPath.vpcCommands.begin();it!=otherPath.vpcCommands.end();++it,i++) {
-        vpcCommands[i] = new Command(**it);
-    }
+    nameIds = otherPath.nameIds;
+    axisMasks = otherPath.axisMasks;
+    for (int axis = 0; axis < AxisCount; axis++)
+        axisValues[axis] = otherPath.axisValues[axis];
+    wordOffsets = otherPath.wordOffsets;
+    words = otherPath.words;
+    names = otherPath.names;
+    codes = otherPath.codes;
+    nameIndex = otherPath.nameIndex;
+    keys = otherPath.keys;
+    keyIndex = otherPath.keyIndex;
     center = otherPath.center;
     recalculate();
+    revision = otherPath.revision;
     return *this;
 }
 
 void Toolpath::clear()
 {
-    for(std::vector<Command*>::iterator it = vpcCommands.begin();it!=vpcCommands.end();++it)
-        delete ( *it );
-    vpcCommands.clear();
+    nameIds.clear();
+    axisMasks.clear();
+    for (int axis = 0; axis < AxisCount; axis++)
+        axisValues[axis].clear();
+    wordOffsets.assign(1, 0);
+    words.clear();
+    names.clear();
+    codes.clear();
+    nameIndex.clear();
+    keys.clear();
+    keyIndex.clear();
     recalculate();
 }
 
+std::uint32_t Toolpath::addName(const std::string &name)
+{
+    auto it = nameIndex.find(name);
+    if (it != nameIndex.end())
+        return it->second;
+
+    std::uint32_t id = static_cast<std::uint32_t>(names.size());
+    names.push_back(name);
+    codes.push_back(Command::getCode(name));
+    nameIndex[name] = id;
+    return id;
+}
+
+std::uint32_t Toolpath::addKey(const std::string &key)
+{
+    auto it = keyIndex.find(key);
+    if (it != keyIndex.end())
+        return it->second;
+
+    std::uint32_t id = static_cast<std::uint32_t>(keys.size());
+    keys.push_back(key);
+    keyIndex[key] = id;
+    return id;
+}
+
 void Toolpath::addCommand(const Command &Cmd)
 {
-    Command *tmp = new Command(Cmd);
-    vpcCommands.push_back(tmp);
-    recalculate();
+    insertCommand(Cmd, -1);
 }
 
 void Toolpath::insertCommand(const Command &Cmd, int pos)
 {
-    if (pos == -1) {
-        addCommand(Cmd);
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        Command *tmp = new Command(Cmd);
-        vpcCommands.insert(vpcCommands.begin()+pos,tmp);
-    } else {
+    std::size_t size = nameIds.size();
+    if (pos > static_cast<int>(size)) {
         throw Base::IndexError("Index not in range");
     }
+    std::size_t index = pos < 0 ? size : static_cast<std::size_t>(pos);
+
+    std::uint16_t mask = 0;
+    double values[AxisCount];
+    std::vector<Word> extra;
+    for (const auto& it : Cmd.Parameters) {
+        int axis = axisOf(it.first);
+        if (axis < 0) {
+            extra.push_back({addKey(it.first), it.second});
+        }
+        else {
+            mask |= 1 << axis;
+            values[axis] = it.second;
+        }
+    }
+
+    insertWords(index, addName(Cmd.Name), mask, values, extra);
     recalculate();
 }
 
+void Toolpath::insertWords(std::size_t index, std::uint32_t name, std::uint16_t mask,
+                           const double *values, const std::vector<Word> &extra)
+{
+    std::size_t size = nameIds.size();
+    nameIds.insert(nameIds.begin() + index, name);
+    axisMasks.insert(axisMasks.begin() + index, mask);
+    for (int axis = 0; axis < AxisCount; axis++) {
+        // a column is allocated once it holds a value for each command
+        std::vector<double>& column = axisValues[axis];
+        bool given = mask & (1 << axis);
+        if (given && column.size() != size)
+            column.resize(size, 0.0);
+        if (column.size() == size && (size > 0 || given))
+            column.insert(column.begin() + index, given ? values[axis] : 0.0);
+    }
+
+    std::uint32_t first = wordOffsets[index];
+    words.insert(words.begin() + first, extra.begin(), extra.end());
+    wordOffsets.insert(wordOffsets.begin() + index + 1, first);
+    for (std::size_t i = index + 1; i < wordOffsets.size(); i++)
+        wordOffsets[i] += static_cast<std::uint32_t>(extra.size());
+}
+
 void Toolpath::deleteCommand(int pos)
 {
-    if (pos == -1) {
-        //delete(*vpcCommands.rbegin()); // causes crash
-        vpcCommands.pop_back();
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        vpcCommands.erase (vpcCommands.begin()+pos);
-    } else {
+    std::size_t size = nameIds.size();
+    if (pos >= static_cast<int>(size) || size == 0) {
         throw Base::IndexError("Index not in range");
     }
+    std::size_t index = pos < 0 ? size - 1 : static_cast<std::size_t>(pos);
+
+    nameIds.erase(nameIds.begin() + index);
+    axisMasks.erase(axisMasks.begin() + index);
+    for (int axis = 0; axis < AxisCount; axis++) {
+        std::vector<double>& column = axisValues[axis];
+        if (!column.empty())
+            column.erase(column.begin() + index);
+    }
+
+    std::uint32_t first = wordOffsets[index];
+    std::uint32_t count = wordOffsets[index + 1] - first;
+    words.erase(words.begin() + first, words.begin() + first + count);
+    wordOffsets.erase(wordOffsets.begin() + index + 1);
+    for (std::size_t i = index + 1; i < wordOffsets.size(); i++)
+        wordOffsets[i] -= count;
+
     recalculate();
 }
 
+Command Toolpath::getCommand(unsigned int pos) const
+{
+    Command cmd;
+    cmd.Name = getName(pos);
+    for (int axis = 0; axis < AxisCount; axis++) {
+        if (has(pos, static_cast<Axis>(axis)))
+            cmd.Parameters[axisNames[axis]] = axisValues[axis][pos];
+    }
+    for (std::uint32_t i = wordOffsets[pos]; i < wordOffsets[pos + 1]; i++)
+        cmd.Parameters[keys[words[i].key]] = words[i].value;
+    return cmd;
+}
+
+std::vector<Command> Toolpath::getCommands() const
+{
+    std::vector<Command> commands;
+    commands.reserve(getSize());
+    for (unsigned int pos = 0; pos < getSize(); pos++)
+        commands.push_back(getCommand(pos));
+    return commands;
+}
+
+bool Toolpath::has(unsigned int pos, const std::string &name) const
+{
+    int axis = axisOf(name);
+    if (axis >= 0)
+        return has(pos, static_cast<Axis>(axis));
+
+    auto it = keyIndex.find(name);
+    if (it == keyIndex.end())
+        return false;
+    for (std::uint32_t i = wordOffsets[pos]; i < wordOffsets[pos + 1]; i++) {
+        if (words[i].key == it->second)
+            return true;
+    }
+    return false;
+}
+
+double Toolpath::getValue(unsigned int pos, const std::string &name, double fallback) const
+{
+    int axis = axisOf(name);
+    if (axis >= 0)
+        return getValue(pos, static_cast<Axis>(axis), fallback);
+
+    auto it = keyIndex.find(name);
+    if (it == keyIndex.end())
+        return fallback;
+    for (std::uint32_t i = wordOffsets[pos]; i < wordOffsets[pos + 1]; i++) {
+        if (words[i].key == it->second)
+            return words[i].value;
+    }
+    return fallback;
+}
+
 double Toolpath::getLength()
 {
-    if(vpcCommands.empty())
+    if(nameIds.empty())
         return 0;
     double l = 0;
     Vector3d last(0,0,0);
     Vector3d next;
-    for(std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        next = (*it)->getPlacement(last).getPosition();
-        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
+    for (unsigned int i = 0; i < getSize(); i++) {
+        CommandCode code = getCode(i);
+        next = getPosition(i, last);
+        if ( (code == CommandCode::Rapid) || (code == CommandCode::Linear) ) {
             // straight line
             l += (next - last).Length();
             last = next;
-        } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        } else if ( (code == CommandCode::ArcCW) || (code == CommandCode::ArcCCW) ) {
             // arc
-            Vector3d center = (*it)->getCenter();
+            Vector3d center = getCenter(i);
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -156,7 +340,7 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
         vRapid = vFeed;
     }
 
-    if (vpcCommands.empty()) {
+    if (nameIds.empty()) {
         return 0;
     }
     double l = 0;
@@ -164,33 +348,33 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
     bool verticalMove = false;
     Vector3d last(0,0,0);
     Vector3d next;
-    for (std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        float feedrate = (*it)->getParam("F");
+    for (unsigned int i = 0; i < getSize(); i++) {
+        CommandCode code = getCode(i);
+        float feedrate;
 
         l = 0;
         verticalMove = false;
         feedrate = hFeed;
-        next = (*it)->getPlacement(last).getPosition();
+        next = getPosition(i, last);
 
         if (last.z != next.z){
             verticalMove = true;
             feedrate = vFeed;
         }
 
-        if ((name == "G0") || (name == "G00")){
+        if (code == CommandCode::Rapid){
             // Rapid Move
             l += (next - last).Length();
             feedrate = hRapid;
             if(verticalMove){
                 feedrate = vRapid;
             }
-        }else if ((name == "G1") || (name == "G01")) {
+        }else if (code == CommandCode::Linear) {
             // Feed Move
             l += (next - last).Length();
-        }else if ((name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        }else if ((code == CommandCode::ArcCW) || (code == CommandCode::ArcCCW)) {
             // Arc Move
-            Vector3d center = (*it)->getCenter();
+            Vector3d center = getCenter(i);
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -274,91 +458,402 @@ Base::BoundBox3d Toolpath::getBoundBox() const
     return visitor.bb;
 }
 
-static void bulkAddCommand(const std::string &gcodestr, std::vector<Command*> &commands, bool &inches)
+namespace {
+
+// A word as read from G-code, the key is upper case
+struct GCodeWord {
+    char key;
+    double value;
+};
+
+// The commands read from a part of a G-code string
+struct GCodeBlock {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::uint32_t> nameIndex;
+    std::vector<std::uint32_t> nameIds;
+    std::vector<std::uint32_t> wordOffsets = std::vector<std::uint32_t>(1, 0);
+    std::vector<GCodeWord> words;
+    std::string name;
+    std::string error; // the reason why the block could not be read completely
+};
+
+inline bool isLetter(char c)
 {
-    Command *cmd = new Command();
-    cmd->setFromGCode(gcodestr);
-    if ("G20" == cmd->Name) {
-        inches = true;
-        delete cmd;
-    } else if ("G21" == cmd->Name) {
-        inches = false;
-        delete cmd;
-    } else {
-        if (inches) {
-            cmd->scaleBy(25.4);
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline char toUpper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+inline bool isValueChar(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+// returns the next character that starts a command or a comment
+inline const char* findCommandStart(const char *begin, const char *end)
+{
+    for (; begin != end; ++begin) {
+        switch (*begin) {
+        case '(': case 'g': case 'G': case 'm': case 'M':
+            return begin;
+        default:
+            break;
         }
-        commands.push_back(cmd);
     }
+    return end;
 }
 
-void Toolpath::setFromGCode(const std::string instr)
+// parses the value like std::atof does, the characters are digits, '-' and '.' only
+inline double toDouble(const char *value, std::size_t len)
 {
-    clear();
+#if defined(__cpp_lib_to_chars)
+    double result = 0.0;
+    std::from_chars(value, value + len, result);
+    return result;
+#else
+    (void)len;
+    return std::atof(value);
+#endif
+}
 
-    // remove comments
-    //boost::regex e("\\(.*?\\)");
-    //std::string str = boost::regex_replace(instr, e, "");
-    std::string str(instr);
+void addName(GCodeBlock &block)
+{
+    auto it = block.nameIndex.find(block.name);
+    std::uint32_t id;
+    if (it == block.nameIndex.end()) {
+        id = static_cast<std::uint32_t>(block.names.size());
+        block.names.push_back(block.name);
+        block.nameIndex[block.name] = id;
+    }
+    else {
+        id = it->second;
+    }
+    block.nameIds.push_back(id);
+    block.wordOffsets.push_back(static_cast<std::uint32_t>(block.words.size()));
+}
 
-    // split input string by () or G or M commands
-    std::string mode = "command";
-    std::size_t found = str.find_first_of("(gGmM");
-    int last = -1;
-    bool inches = false;
-    while (found != std::string::npos)
-    {
-        if (str[found] == '(') {
-            // start of comment
-            if ( (last > -1) && (mode == "command") ) {
-                // before opening a comment, add the last found command
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+// reads the command with Command::setFromGCode, used for comments and unusual input
+bool parseSlow(const char *begin, const char *end, GCodeBlock &block)
+{
+    Command cmd;
+    try {
+        cmd.setFromGCode(std::string(begin, end));
+    }
+    catch (const Base::Exception &e) {
+        block.error = e.what();
+        return false;
+    }
+
+    for (const auto &it : cmd.Parameters)
+        block.words.push_back({it.first[0], it.second});
+    block.name = cmd.Name;
+    addName(block);
+    return true;
+}
+
+// reads the command in [begin, end) the same way as Command::setFromGCode does
+bool parseCommand(const char *begin, const char *end, GCodeBlock &block)
+{
+    if (*begin == '(')
+        return parseSlow(begin, end, block);
+
+    std::size_t first = block.words.size();
+    char key = 0;
+    char value[64];
+    std::size_t len = 0;
+    bool named = false;
+    for (const char *it = begin; it != end; ++it) {
+        char c = *it;
+        if (isValueChar(c)) {
+            if (len + 1 == sizeof(value)) {
+                block.words.resize(first);
+                return parseSlow(begin, end, block);
             }
-            mode = "comment";
+            value[len++] = c;
+        }
+        else if (isLetter(c)) {
+            if (key) {
+                if (len == 0) {
+                    block.words.resize(first);
+                    block.error = named ? "Badly formatted GCode argument"
+                                        : "Badly formatted GCode command";
+                    return false;
+                }
+                if (named) {
+                    value[len] = '\0';
+                    block.words.push_back({key, toDouble(value, len)});
+                }
+                else {
+                    block.name.assign(1, key);
+                    block.name.append(value, len);
+                    named = true;
+                }
+                len = 0;
+            }
+            key = toUpper(c);
+        }
+        else if (c == ')') {
+            block.words.resize(first);
+            return parseSlow(begin, end, block);
+        }
+    }
+
+    if (len == 0) {
+        block.words.resize(first);
+        block.error = "Badly formatted GCode argument";
+        return false;
+    }
+    if (named) {
+        value[len] = '\0';
+        block.words.push_back({key, toDouble(value, len)});
+    }
+    else {
+        block.name.assign(1, key);
+        block.name.append(value, len);
+    }
+    addName(block);
+    return true;
+}
+
+// splits [begin, end) into commands and comments like the former string based parser did
+void parseBlock(const char *begin, const char *end, GCodeBlock &block)
+{
+    bool comment = false;
+    const char *last = nullptr;
+    const char *found = findCommandStart(begin, end);
+    while (found != end) {
+        if (*found == '(' && !comment) {
+            // before opening a comment, add the last found command
+            if (last && !parseCommand(last, found, block))
+                return;
+            comment = true;
             last = found;
-            found = str.find_first_of(')', found+1);
-        } else if (str[found] == ')') {
+            found = std::find(found + 1, end, ')');
+        }
+        else if (*found == ')') {
             // end of comment
-            std::string gcodestr = str.substr(last, found-last+1);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-            last = -1;
-            found = str.find_first_of("(gGmM", found+1);
-            mode = "command";
-        } else if (mode == "command") {
-            // command
-            if (last > -1) {
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
-            }
+            if (!parseCommand(last, found + 1, block))
+                return;
+            comment = false;
+            last = nullptr;
+            found = findCommandStart(found + 1, end);
+        }
+        else {
+            if (last && !parseCommand(last, found, block))
+                return;
             last = found;
-            found = str.find_first_of("(gGmM", found+1);
+            found = findCommandStart(found + 1, end);
         }
     }
     // add the last command found, if any
-    if (last > -1) {
-        if (mode == "command") {
-            std::string gcodestr = str.substr(last,std::string::npos);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
+    if (last && !comment)
+        parseCommand(last, end, block);
+}
+
+// returns the start of the first command at or after pos where a block can begin,
+// prev is the start of the previous block
+const char* findBlockStart(const char *prev, const char *pos, const char *end)
+{
+    // pos lies in a comment if the closest parenthesis in [prev, pos) opens one, this
+    // includes prev itself because a block may start with a comment
+    auto paren = std::find_if(std::make_reverse_iterator(pos), std::make_reverse_iterator(prev),
+                              [](char c) { return c == '(' || c == ')'; });
+    if (paren != std::make_reverse_iterator(prev) && *paren == '(') {
+        pos = std::find(pos, end, ')');
+        if (pos == end)
+            return end;
+        ++pos;
+    }
+    return findCommandStart(pos, end);
+}
+
+inline bool isScaledByUnit(char key)
+{
+    switch (key) {
+    case 'X': case 'Y': case 'Z': case 'I': case 'J': case 'R': case 'Q': case 'F':
+        return true;
+    default:
+        return false;
+    }
+}
+
+}
+
+void Toolpath::setFromGCode(const std::string &instr)
+{
+    clear();
+
+    // the string is split into blocks at command boundaries that are read in parallel,
+    // the commands are added in order afterwards because G20/G21 change their meaning
+    const std::size_t minBlockSize = 0x100000;
+    const char *begin = instr.data();
+    const char *end = begin + instr.size();
+    std::size_t numBlocks = std::max<std::size_t>(1, std::min<std::size_t>(
+        instr.size() / minBlockSize, static_cast<std::size_t>(Base::idealThreadCount())));
+
+    std::vector<const char*> starts(numBlocks + 1, end);
+    starts[0] = begin;
+    for (std::size_t i = 1; i < numBlocks; i++) {
+        const char *pos = std::max(begin + i * (instr.size() / numBlocks), starts[i - 1]);
+        starts[i] = findBlockStart(starts[i - 1], pos, end);
+    }
+
+    std::vector<GCodeBlock> blocks(numBlocks);
+    Base::parallel_for(numBlocks, static_cast<int>(numBlocks), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++)
+            parseBlock(starts[i], starts[i + 1], blocks[i]);
+    });
+
+    bool inches = false;
+    double values[AxisCount];
+    std::vector<Word> extra;
+    std::uint32_t keyIds[256];
+    std::fill(std::begin(keyIds), std::end(keyIds), UINT32_MAX);
+    for (const GCodeBlock &block : blocks) {
+        // the kind of each name of the block, 0 is a command, 1 is G20 and 2 is G21
+        std::vector<std::uint32_t> ids(block.names.size());
+        std::vector<int> units(block.names.size());
+        for (std::size_t i = 0; i < block.names.size(); i++) {
+            const std::string &name = block.names[i];
+            units[i] = name == "G20" ? 1 : name == "G21" ? 2 : 0;
+            if (!units[i])
+                ids[i] = addName(name);
         }
+
+        for (std::size_t i = 0; i < block.nameIds.size(); i++) {
+            std::uint32_t id = block.nameIds[i];
+            if (units[id]) {
+                inches = units[id] == 1;
+                continue;
+            }
+
+            std::uint16_t mask = 0;
+            extra.clear();
+            for (std::uint32_t j = block.wordOffsets[i]; j < block.wordOffsets[i + 1]; j++) {
+                const GCodeWord &word = block.words[j];
+                double value = word.value;
+                if (inches && isScaledByUnit(word.key))
+                    value *= 25.4;
+
+                int axis = axisOf(word.key);
+                if (axis >= 0) {
+                    mask |= 1 << axis;
+                    values[axis] = value;
+                    continue;
+                }
+
+                std::uint32_t &key = keyIds[static_cast<unsigned char>(word.key)];
+                if (key == UINT32_MAX)
+                    key = addKey(std::string(1, word.key));
+                auto it = std::find_if(extra.begin(), extra.end(), [key](const Word &w) {
+                    return w.key == key;
+                });
+                if (it != extra.end())
+                    it->value = value;
+                else
+                    extra.push_back({key, value});
+            }
+            insertWords(nameIds.size(), ids[id], mask, values, extra);
+        }
+
+        if (!block.error.empty())
+            throw Base::BadFormatError(block.error.c_str());
     }
     recalculate();
 }
 
 std::string Toolpath::toGCode() const
 {
+    // large paths are formatted in parallel parts that are joined afterwards
+    const std::size_t minPartSize = 100000;
+    std::size_t size = getSize();
+    std::size_t numParts = std::max<std::size_t>(1, std::min<std::size_t>(
+        size / minPartSize, static_cast<std::size_t>(Base::idealThreadCount())));
+
+    std::vector<std::string> parts(numParts);
+    Base::parallel_for(numParts, static_cast<int>(numParts), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            std::size_t begin = i * size / numParts;
+            std::size_t end = (i + 1) * size / numParts;
+            std::string &part = parts[i];
+            part.reserve((end - begin) * 40);
+            for (std::size_t pos = begin; pos < end; pos++) {
+                appendGCode(part, static_cast<unsigned int>(pos));
+                part += '\n';
+            }
+        }
+    });
+
+    if (numParts == 1)
+        return std::move(parts[0]);
+
+    std::size_t length = 0;
+    for (const std::string &part : parts)
+        length += part.size();
     std::string result;
-    for (std::vector<Command*>::const_iterator it=vpcCommands.begin();it!=vpcCommands.end();++it) {
-        result += (*it)->toGCode();
-        result += "\n";
-    }
+    result.reserve(length);
+    for (const std::string &part : parts)
+        result += part;
     return result;
 }
 
+void Toolpath::appendGCode(std::string &str, unsigned int pos) const
+{
+    // the axis words in alphabetical order
+    static const Axis sorted[AxisCount] = {
+        AxisA, AxisB, AxisC, AxisF, AxisI, AxisJ, AxisK, AxisX, AxisY, AxisZ
+    };
+
+    // the other words sorted by their names as in Command::Parameters
+    const Word *extra[16];
+    std::vector<const Word*> moreExtra;
+    const Word **others = extra;
+    std::size_t numOthers = 0;
+    std::uint32_t count = wordOffsets[pos + 1] - wordOffsets[pos];
+    if (count > 16) {
+        moreExtra.resize(count);
+        others = moreExtra.data();
+    }
+    for (std::uint32_t i = wordOffsets[pos]; i < wordOffsets[pos + 1]; i++) {
+        const Word *word = &words[i];
+        if (keys[word->key] == "N")
+            continue;
+        std::size_t j = numOthers++;
+        for (; j > 0 && keys[word->key] < keys[others[j - 1]->key]; j--)
+            others[j] = others[j - 1];
+        others[j] = word;
+    }
+
+    str += getName(pos);
+    std::uint16_t mask = axisMasks[pos];
+    std::size_t other = 0;
+    for (Axis axis : sorted) {
+        if (!(mask & (1 << axis)))
+            continue;
+        for (; other < numOthers && keys[others[other]->key] < axisNames[axis]; other++) {
+            str += ' ';
+            str += keys[others[other]->key];
+            Command::appendValue(str, others[other]->value);
+        }
+        str += ' ';
+        str += axisNames[axis];
+        Command::appendValue(str, axisValues[axis][pos]);
+    }
+    for (; other < numOthers; other++) {
+        str += ' ';
+        str += keys[others[other]->key];
+        Command::appendValue(str, others[other]->value);
+    }
+}
+
 void Toolpath::recalculate() // recalculates the path cache
 {
+    revision = ++lastRevision;
 
-    if(vpcCommands.empty())
+    if(nameIds.empty())
         return;
 
     // TODO recalculate the KDL stuff. At the moment, this is unused.
@@ -422,7 +917,17 @@ void Toolpath::recalculate() // recalculates the path cache
 
 unsigned int Toolpath::getMemSize () const
 {
-    return toGCode().size();
+    std::size_t size = nameIds.capacity() * sizeof(std::uint32_t)
+                     + axisMasks.capacity() * sizeof(std::uint16_t)
+                     + wordOffsets.capacity() * sizeof(std::uint32_t)
+                     + words.capacity() * sizeof(Word);
+    for (int axis = 0; axis < AxisCount; axis++)
+        size += axisValues[axis].capacity() * sizeof(double);
+    for (const auto& name : names)
+        size += name.capacity();
+    for (const auto& key : keys)
+        size += key.capacity();
+    return static_cast<unsigned int>(size);
 }
 
 void Toolpath::setCenter(const Base::Vector3d &c)
@@ -443,7 +948,7 @@ void Toolpath::Save (Writer &writer) const
         writer.incInd();
         saveCenter(writer, center);
         for(unsigned int i = 0; i < getSize(); i++) {
-            vpcCommands[i]->Save(writer);
+            getCommand(i).Save(writer);
         }
         writer.decInd();
     } else {
@@ -458,7 +963,7 @@ void Toolpath::Save (Writer &writer) const
 
 void Toolpath::SaveDocFile (Base::Writer &writer) const
 {
-    if (toGCode().empty())
+    if (nameIds.empty())
         return;
     writer.Stream() << toGCode();
 }
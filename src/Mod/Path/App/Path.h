@@ -23,6 +23,11 @@
 #ifndef PATH_Path_H
 #define PATH_Path_H
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <Base/BoundBox.h>
 #include <Base/Persistence.h>
 #include <Base/Vector3D.h>
@@ -33,13 +38,29 @@
 namespace Path
 {
 
-    /** The representation of a CNC Toolpath */
+    /** The representation of a CNC Toolpath
+     *
+     * The commands are not kept as Command objects but in columns: the name of each
+     * command is an index into a table of the distinct names, the axis words X, Y, Z,
+     * A, B, C, I, J, K and F are kept in fixed columns with a bit mask of the given ones
+     * and any other word is kept in a sparse list. An axis column is only allocated
+     * once a command uses it. Command objects are created on demand by getCommand().
+     */
 
     class PathExport Toolpath : public Base::Persistence
     {
         TYPESYSTEM_HEADER();
 
         public:
+            /// The words that are kept in fixed columns
+            enum Axis {
+                AxisX, AxisY, AxisZ,
+                AxisA, AxisB, AxisC,
+                AxisI, AxisJ, AxisK,
+                AxisF,
+                AxisCount
+            };
+
             Toolpath();
             Toolpath(const Toolpath&);
             ~Toolpath();
@@ -47,6 +68,7 @@ namespace Path
             Toolpath &operator=(const Toolpath&);
 
             // from base class
+            /// returns the memory used by the columns, not the size of the G-code as before
             virtual unsigned int getMemSize (void) const;
             virtual void Save (Base::Writer &/*writer*/) const;
             virtual void Restore(Base::XMLReader &/*reader*/);
@@ -61,14 +83,37 @@ namespace Path
             double getLength(void); // return the Length (mm) of the Path
             double getCycleTime(double, double, double, double); // return the Cycle Time (s) of the Path
             void recalculate(void); // recalculates the points
-            void setFromGCode(const std::string); // sets the path from the contents of the given GCode string
+            void setFromGCode(const std::string&); // sets the path from the contents of the given GCode string
             std::string toGCode(void) const; // gets a gcode string representation from the Path
             Base::BoundBox3d getBoundBox(void) const;
+            /// returns a number that changes with every modification, copies share it
+            std::uint64_t getRevision(void) const { return revision; }
 
             // shortcut functions
-            unsigned int getSize(void) const { return vpcCommands.size(); }
-            const std::vector<Command*> &getCommands(void) const { return vpcCommands; }
-            const Command &getCommand(unsigned int pos)    const { return *vpcCommands[pos]; }
+            unsigned int getSize(void) const { return nameIds.size(); }
+            Command getCommand(unsigned int pos) const; // creates the command at the given position
+            /// Creates all commands. This replaces the former access to the stored Command
+            /// objects and is expensive for large paths, prefer getCommand() or the column
+            /// accessors below.
+            std::vector<Command> getCommands(void) const;
+
+            // access to the columns without creating commands
+            CommandCode getCode(unsigned int pos) const { return codes[nameIds[pos]]; }
+            const std::string &getName(unsigned int pos) const { return names[nameIds[pos]]; }
+            bool has(unsigned int pos, Axis axis) const { return (axisMasks[pos] >> axis) & 1; }
+            double getValue(unsigned int pos, Axis axis, double fallback = 0.0) const {
+                return has(pos, axis) ? axisValues[axis][pos] : fallback;
+            }
+            bool has(unsigned int pos, const std::string &name) const; // the name must be upper case
+            double getValue(unsigned int pos, const std::string &name, double fallback = 0.0) const;
+            Base::Vector3d getPosition(unsigned int pos, const Base::Vector3d &fallback) const {
+                return Base::Vector3d(getValue(pos, AxisX, fallback.x),
+                                      getValue(pos, AxisY, fallback.y),
+                                      getValue(pos, AxisZ, fallback.z));
+            }
+            Base::Vector3d getCenter(unsigned int pos) const {
+                return Base::Vector3d(getValue(pos, AxisI), getValue(pos, AxisJ), getValue(pos, AxisK));
+            }
 
             // support for rotation
             const Base::Vector3d& getCenter() const { return center; }
@@ -77,8 +122,32 @@ namespace Path
             static const int SchemaVersion = 2;
 
         protected:
-            std::vector<Command*> vpcCommands;
+            /// A word that has no fixed column
+            struct Word {
+                std::uint32_t key;
+                double value;
+            };
+
+            std::uint32_t addName(const std::string &name);
+            std::uint32_t addKey(const std::string &key);
+            void insertWords(std::size_t index, std::uint32_t name, std::uint16_t mask,
+                             const double *values, const std::vector<Word> &extra);
+            void appendGCode(std::string &str, unsigned int pos) const;
+
+            std::vector<std::uint32_t> nameIds;
+            std::vector<std::uint16_t> axisMasks;
+            std::vector<double> axisValues[AxisCount];
+            std::vector<std::uint32_t> wordOffsets; // the first word of each command and the end
+            std::vector<Word> words;
+
+            std::vector<std::string> names;
+            std::vector<CommandCode> codes;
+            std::unordered_map<std::string, std::uint32_t> nameIndex;
+            std::vector<std::string> keys;
+            std::unordered_map<std::string, std::uint32_t> keyIndex;
+
             Base::Vector3d center;
+            std::uint64_t revision;
             //KDL::Path_Composite *pcPath;
 
         /*
@@ -0,0 +1,219 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+#endif
+
+#include <Base/Parallel.h>
+
+#include "PathPolyline.h"
+#include "PathSegmentWalker.h"
+
+
+using namespace Path;
+
+namespace {
+
+// the segments of a range of commands, the edges end relative to the first point of the range
+class PolylineChunk
+: public PathSegmentVisitor
+{
+public:
+    void g0(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts) override
+    {
+        (void)last;
+        gx(id, &next, pts, 0);
+    }
+
+    void g1(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts) override
+    {
+        (void)last;
+        gx(id, &next, pts, 1);
+    }
+
+    void g23(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts, const Base::Vector3d &center) override
+    {
+        (void)last;
+        gx(id, &next, pts, 1);
+        pushMarker(center);
+    }
+
+    void g8x(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts,
+                     const std::deque<Base::Vector3d> &p, const std::deque<Base::Vector3d> &q) override
+    {
+        (void)last;
+
+        gx(id, nullptr, pts, 0);
+
+        pushPoint(p[0], 0);
+        pushMarker(p[0]);
+
+        pushPoint(p[1], 0);
+        pushMarker(p[1]);
+
+        pushPoint(next, 1);
+        pushMarker(next);
+
+        for (const auto &pt : q)
+            pushMarker(pt);
+
+        pushPoint(p[2], 0);
+        pushMarker(p[2]);
+
+        pushCommand(id);
+    }
+
+    void g38(int id, const Base::Vector3d &last, const Base::Vector3d &next) override
+    {
+        (void)last;
+        gx(id, &next, std::deque<Base::Vector3d>(), 2);
+    }
+
+    std::vector<float> points;
+    std::vector<float> markers;
+    std::vector<std::uint8_t> colorindex;
+    std::vector<int> edge2Command;
+    std::vector<int> edgeIndices;
+
+private:
+    void gx(int id, const Base::Vector3d *next, const std::deque<Base::Vector3d> &pts, int color)
+    {
+        for (const auto &pt : pts)
+            pushPoint(pt, color);
+
+        if (next) {
+            pushPoint(*next, color);
+            pushMarker(*next);
+            pushCommand(id);
+        }
+    }
+
+    void pushPoint(const Base::Vector3d &pt, int color)
+    {
+        points.push_back(static_cast<float>(pt.x));
+        points.push_back(static_cast<float>(pt.y));
+        points.push_back(static_cast<float>(pt.z));
+        colorindex.push_back(static_cast<std::uint8_t>(color));
+    }
+
+    void pushMarker(const Base::Vector3d &pt)
+    {
+        markers.push_back(static_cast<float>(pt.x));
+        markers.push_back(static_cast<float>(pt.y));
+        markers.push_back(static_cast<float>(pt.z));
+    }
+
+    void pushCommand(int id)
+    {
+        edgeIndices.push_back(static_cast<int>(points.size() / 3));
+        edge2Command.push_back(id);
+    }
+};
+
+}
+
+void PathPolyline::clear()
+{
+    points.clear();
+    markers.clear();
+    colorindex.clear();
+    command2Edge.clear();
+    edge2Command.clear();
+    edgeIndices.clear();
+    coordIndex.clear();
+}
+
+void PathPolyline::build(const Toolpath &tp, const Base::Vector3d &startPosition, int threads)
+{
+    clear();
+
+    unsigned int size = tp.getSize();
+    if (size == 0)
+        return;
+
+    // small paths are segmented in one go
+    const unsigned int minChunkSize = 0x1000;
+    unsigned int numChunks = std::max(1u, std::min(size / minChunkSize,
+                                                   static_cast<unsigned int>(Base::idealThreadCount(threads))));
+
+    // the modal state at the start of each chunk is found by a pass that does not segment
+    PathSegmentWalker walker(tp);
+    std::vector<unsigned int> starts(numChunks + 1, size);
+    std::vector<PathSegmentWalker::State> states(numChunks, PathSegmentWalker::State(startPosition));
+    starts[0] = 0;
+    for (unsigned int i = 1; i < numChunks; i++) {
+        starts[i] = static_cast<unsigned int>(std::uint64_t(size) * i / numChunks);
+        states[i] = states[i - 1];
+        walker.skip(states[i], starts[i - 1], starts[i]);
+    }
+
+    std::vector<PolylineChunk> chunks(numChunks);
+    Base::parallel_for(numChunks, static_cast<int>(numChunks), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++)
+            walker.walk(chunks[i], states[i], starts[i], starts[i + 1]);
+    });
+
+    std::size_t pointCount = 3, markerCount = 3, edgeCount = 0;
+    for (const auto &chunk : chunks) {
+        pointCount += chunk.points.size();
+        markerCount += chunk.markers.size();
+        edgeCount += chunk.edgeIndices.size();
+    }
+    points.reserve(pointCount);
+    markers.reserve(markerCount);
+    colorindex.reserve(pointCount / 3);
+    edge2Command.reserve(edgeCount);
+    edgeIndices.reserve(edgeCount);
+    command2Edge.assign(size, -1);
+
+    const float start[3] = {static_cast<float>(startPosition.x),
+                            static_cast<float>(startPosition.y),
+                            static_cast<float>(startPosition.z)};
+    points.insert(points.end(), start, start + 3);
+    markers.insert(markers.end(), start, start + 3);
+
+    for (auto &chunk : chunks) {
+        int pointOffset = static_cast<int>(points.size() / 3);
+        points.insert(points.end(), chunk.points.begin(), chunk.points.end());
+        markers.insert(markers.end(), chunk.markers.begin(), chunk.markers.end());
+        colorindex.insert(colorindex.end(), chunk.colorindex.begin(), chunk.colorindex.end());
+        for (std::size_t i = 0; i < chunk.edgeIndices.size(); i++) {
+            command2Edge[chunk.edge2Command[i]] = static_cast<int>(edgeIndices.size());
+            edge2Command.push_back(chunk.edge2Command[i]);
+            edgeIndices.push_back(chunk.edgeIndices[i] + pointOffset);
+        }
+        chunk = PolylineChunk();
+    }
+
+    coordIndex.resize(coordIndexOffset(edgeIndices.size()));
+    std::int32_t *idx = coordIndex.data();
+    int first = 0;
+    for (int end : edgeIndices) {
+        for (; first < end; ++first)
+            *idx++ = first;
+        *idx++ = -1;
+        --first;
+    }
+}
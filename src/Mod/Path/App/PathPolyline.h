@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PATH_PATHPOLYLINE_H
+#define PATH_PATHPOLYLINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+#include "Path.h"
+
+
+namespace Path
+{
+
+/**
+ * PathPolyline holds a toolpath split into straight segments by PathSegmentWalker the
+ * way it is displayed, with the points packed into float arrays. Each movement command
+ * is an edge that starts with the last point of the previous edge, the first point is
+ * the start position.
+ */
+class PathExport PathPolyline
+{
+public:
+    /** Walks the toolpath in consecutive chunks of commands, which are segmented in
+     * up to \a threads threads. A value of 0 uses as many threads as cores are available.
+     */
+    void build(const Toolpath &tp, const Base::Vector3d &startPosition, int threads = 0);
+    void clear();
+
+    std::size_t numPoints() const { return points.size() / 3; }
+    std::size_t numMarkers() const { return markers.size() / 3; }
+    std::size_t numEdges() const { return edgeIndices.size(); }
+
+    /// returns the position of the given edge in coordIndex, numEdges() gives its size
+    std::size_t coordIndexOffset(std::size_t edge) const {
+        return edge == 0 ? 0 : edgeIndices[edge - 1] + 2 * edge - 1;
+    }
+
+    std::vector<float> points;          // x, y and z of each point
+    std::vector<float> markers;         // x, y and z of each marker
+    std::vector<std::uint8_t> colorindex; // of each point, 0 rapid, 1 feed and 2 probe moves
+    std::vector<int> command2Edge;      // the edge of each command or -1
+    std::vector<int> edge2Command;
+    std::vector<int> edgeIndices;       // the end of each edge in points
+    std::vector<std::int32_t> coordIndex; // the points of each edge followed by -1
+};
+
+}
+
+#endif // PATH_PATHPOLYLINE_H
@@ -23,12 +23,15 @@
 #include "PreCompiled.h"
 
 #include "Base/GeometryPyCXX.h"
+#include <Base/VectorPy.h>
 
 // inclusion of the generated files (generated out of PathPy.xml)
 #include "PathPy.h"
 #include "PathPy.cpp"
 
 #include "CommandPy.h"
+#include "PathPolyline.h"
+#include "PyBytes.h"
 
 
 using namespace Path;
@@ -196,6 +199,32 @@ PyObject* PathPy::getCycleTime(PyObject * args)
     return nullptr;
 }
 
+PyObject* PathPy::getPolyline(PyObject * args, PyObject * kwds)
+{
+    static char *kwlist[] = { "start", "threads", nullptr };
+    PyObject *pcStart = nullptr;
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O!i", kwlist, &(Base::VectorPy::Type), &pcStart, &threads))
+        return nullptr;
+
+    Base::Vector3d start;
+    if (pcStart)
+        start = *static_cast<Base::VectorPy*>(pcStart)->getVectorPtr();
+
+    PY_TRY {
+        PathPolyline polyline;
+        polyline.build(*getToolpathPtr(), start, threads);
+
+        Py::Dict result;
+        result.setItem("Points", toBytes(polyline.points));
+        result.setItem("Markers", toBytes(polyline.markers));
+        result.setItem("Colors", toBytes(polyline.colorindex));
+        result.setItem("EdgeIndices", toBytes(polyline.edgeIndices));
+        result.setItem("EdgeCommands", toBytes(polyline.edge2Command));
+        return Py::new_reference_to(result);
+    } PY_CATCH
+}
+
 // GCode methods
 
 PyObject* PathPy::toGCode(PyObject * args)
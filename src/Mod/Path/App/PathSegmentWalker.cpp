@@ -110,9 +110,23 @@ void PathSegmentVisitor::g38(int id, const Base::Vector3d &last, const Base::Vec
     (void)next;
 }
 
+PathSegmentWalker::State::State(const Base::Vector3d &startPosition)
+    :last(startPosition)
+    ,A(0.0)
+    ,B(0.0)
+    ,C(0.0)
+    ,absolute(true)
+    ,absolutecenter(false)
+    ,pz(&Base::Vector3d::z)
+    ,retract_mode(98)
+{}
+
 PathSegmentWalker::PathSegmentWalker(const Toolpath &tp_)
     :tp(tp_)
-{}
+{
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Part");
+    deviation = hGrp->GetFloat("MeshDeviation",0.2);
+}
 
 
 void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &startPosition)
@@ -121,50 +135,60 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
         return;
     }
 
-    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Part");
-    float deviation = hGrp->GetFloat("MeshDeviation",0.2);
-
-    Base::Vector3d rotCenter = tp.getCenter();
-    Base::Vector3d last(startPosition);
-    Base::Rotation lrot;
-    double A = 0.0;
-    double B = 0.0;
-    double C = 0.0;
+    State state(startPosition);
+    cb.setup(state.last);
+    walkRange(&cb, state, 0, tp.getSize());
+}
 
-    bool absolute = true;
-    bool absolutecenter = false;
+void PathSegmentWalker::walk(PathSegmentVisitor &cb, State &state, unsigned int begin, unsigned int end) const
+{
+    walkRange(&cb, state, begin, end);
+}
 
-    // for mapping the coordinates to XY plane
-    double Base::Vector3d::*pz = &Base::Vector3d::z;
+void PathSegmentWalker::skip(State &state, unsigned int begin, unsigned int end) const
+{
+    walkRange(nullptr, state, begin, end);
+}
 
-    cb.setup(last);
+void PathSegmentWalker::walkRange(PathSegmentVisitor *cb, State &state, unsigned int begin, unsigned int end) const
+{
+    end = std::min(end, tp.getSize());
 
-    for (unsigned int  i = 0; i < tp.getSize(); i++) {
+    Base::Vector3d rotCenter = tp.getCenter();
+    Base::Vector3d &last = state.last;
+    double &A = state.A;
+    double &B = state.B;
+    double &C = state.C;
+    bool &absolute = state.absolute;
+    bool &absolutecenter = state.absolutecenter;
+    double Base::Vector3d::*&pz = state.pz;
+    int &retract_mode = state.retract_mode;
+
+    // the rotation always follows A, B and C, it is identity for the initial state
+    Base::Rotation lrot = yawPitchRoll(A, B, C);
+
+    for (unsigned int  i = begin; i < end; i++) {
         std::deque<Base::Vector3d> points;
 
-        const Path::Command &cmd = tp.getCommand(i);
-        const std::string &name = cmd.Name;
-        Base::Vector3d next = cmd.getPlacement().getPosition();
-        double a = A;
-        double b = B;
-        double c = C;
+        CommandCode code = tp.getCode(i);
+        Base::Vector3d next = tp.getPosition(i, Base::Vector3d());
+        double a = tp.getValue(i, Toolpath::AxisA, A);
+        double b = tp.getValue(i, Toolpath::AxisB, B);
+        double c = tp.getValue(i, Toolpath::AxisC, C);
 
         if (!absolute)
             next = last + next;
-        if (!cmd.has("X")) next.x = last.x;
-        if (!cmd.has("Y")) next.y = last.y;
-        if (!cmd.has("Z")) next.z = last.z;
-        if ( cmd.has("A")) a = cmd.getValue("A");
-        if ( cmd.has("B")) b = cmd.getValue("B");
-        if ( cmd.has("C")) c = cmd.getValue("C");
+        if (!tp.has(i, Toolpath::AxisX)) next.x = last.x;
+        if (!tp.has(i, Toolpath::AxisY)) next.y = last.y;
+        if (!tp.has(i, Toolpath::AxisZ)) next.z = last.z;
 
         Base::Rotation nrot = yawPitchRoll(a, b, c);
 
         Base::Vector3d rnext = compensateRotation(next, nrot, rotCenter);
 
-        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
+        if ( (code == CommandCode::Rapid) || (code == CommandCode::Linear) ) {
             // straight line
-            if (nrot != lrot) {
+            if (cb && nrot != lrot) {
                 double amax = std::max(fmod(fabs(a - A), 360), std::max(fmod(fabs(b - B), 360), fmod(fabs(c - C), 360)));
                 double angle = amax / 180 * M_PI;
                 int segments = std::max(ARC_MIN_SEGMENTS, 3.0/(deviation/angle));
@@ -185,10 +209,12 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
                 }
             }
 
-            if ("G0" == name || "G00" == name) {
-                cb.g0(i, last, rnext, points);
+            if (!cb) {
+                // only the state is advanced
+            } else if (code == CommandCode::Rapid) {
+                cb->g0(i, last, rnext, points);
             } else {
-                cb.g1(i, last, rnext, points);
+                cb->g1(i, last, rnext, points);
             }
 
             last = next;
@@ -197,62 +223,64 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             C = c;
             lrot = nrot;
 
-        } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        } else if ( (code == CommandCode::ArcCW) || (code == CommandCode::ArcCCW) ) {
             // arc
-            Base::Vector3d norm;
-            Base::Vector3d center;
+            if (cb) {
+                Base::Vector3d norm;
+                Base::Vector3d center;
+
+                if (code == CommandCode::ArcCW)
+                    norm.*pz = -1.0;
+                else
+                    norm.*pz = 1.0;
+
+                if (absolutecenter)
+                    center = tp.getCenter(i);
+                else
+                    center = (last + tp.getCenter(i));
+                Base::Vector3d next0(next);
+                next0.*pz = 0.0;
+                Base::Vector3d last0(last);
+                last0.*pz = 0.0;
+                Base::Vector3d center0(center);
+                center0.*pz = 0.0;
+                //double radius = (last - center).Length();
+                double angle = (next0 - center0).GetAngle(last0 - center0);
+                // GetAngle will always return the minor angle. Switch if needed
+                Base::Vector3d anorm = (last0 - center0) % (next0 - center0);
+                if (anorm.*pz < 0) {
+                    if(code == CommandCode::ArcCCW)
+                        angle = M_PI * 2 - angle;
+                } else if(anorm.*pz > 0) {
+                    if(code == CommandCode::ArcCW)
+                        angle = M_PI * 2 - angle;
+                } else if (angle == 0)
+                    angle = M_PI * 2;
 
-            if ( (name == "G2") || (name == "G02") )
-                norm.*pz = -1.0;
-            else
-                norm.*pz = 1.0;
+                double amax = std::max(fmod(fabs(a - A), 360), std::max(fmod(fabs(b - B), 360), fmod(fabs(c - C), 360)));
 
-            if (absolutecenter)
-                center = cmd.getCenter();
-            else
-                center = (last + cmd.getCenter());
-            Base::Vector3d next0(next);
-            next0.*pz = 0.0;
-            Base::Vector3d last0(last);
-            last0.*pz = 0.0;
-            Base::Vector3d center0(center);
-            center0.*pz = 0.0;
-            //double radius = (last - center).Length();
-            double angle = (next0 - center0).GetAngle(last0 - center0);
-            // GetAngle will always return the minor angle. Switch if needed
-            Base::Vector3d anorm = (last0 - center0) % (next0 - center0);
-            if (anorm.*pz < 0) {
-                if(name == "G3" || name == "G03")
-                    angle = M_PI * 2 - angle;
-            } else if(anorm.*pz > 0) {
-                if(name == "G2" || name == "G02")
-                    angle = M_PI * 2 - angle;
-            } else if (angle == 0)
-                angle = M_PI * 2;
-
-            double amax = std::max(fmod(fabs(a - A), 360), std::max(fmod(fabs(b - B), 360), fmod(fabs(c - C), 360)));
-
-            int segments = std::max(ARC_MIN_SEGMENTS, 3.0/(deviation/std::max(angle, amax))); //we use a rather simple rule here, provisorily
-            double dZ = (next.*pz - last.*pz)/segments; //How far each segment will helix in Z
-
-            double dangle = angle/segments;
-            double da = (a - A) / segments;
-            double db = (b - B) / segments;
-            double dc = (c - C) / segments;
-
-            for (int j = 1; j < segments; j++) {
-                Base::Vector3d inter;
-                Base::Rotation rot(norm, dangle*j);
-                rot.multVec((last0 - center0), inter);
-                inter.*pz = last.*pz + dZ * j; //Enable displaying helices
-
-                Base::Rotation arot = yawPitchRoll(A + da*j, B + db*j, C + dc*j);
-                Base::Vector3d rinter = compensateRotation(center0 + inter, arot, rotCenter);
-
-                points.push_back(rinter);
-            }
+                int segments = std::max(ARC_MIN_SEGMENTS, 3.0/(deviation/std::max(angle, amax))); //we use a rather simple rule here, provisorily
+                double dZ = (next.*pz - last.*pz)/segments; //How far each segment will helix in Z
+
+                double dangle = angle/segments;
+                double da = (a - A) / segments;
+                double db = (b - B) / segments;
+                double dc = (c - C) / segments;
 
-            cb.g23(i, last, rnext, points, center);
+                for (int j = 1; j < segments; j++) {
+                    Base::Vector3d inter;
+                    Base::Rotation rot(norm, dangle*j);
+                    rot.multVec((last0 - center0), inter);
+                    inter.*pz = last.*pz + dZ * j; //Enable displaying helices
+
+                    Base::Rotation arot = yawPitchRoll(A + da*j, B + db*j, C + dc*j);
+                    Base::Vector3d rinter = compensateRotation(center0 + inter, arot, rotCenter);
+
+                    points.push_back(rinter);
+                }
+
+                cb->g23(i, last, rnext, points, center);
+            }
 
             last = next;
             A = a;
@@ -260,27 +288,25 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             C = c;
             lrot = nrot;
 
-        } else if (name == "G90") {
+        } else if (code == CommandCode::Absolute) {
             // absolute mode
             absolute = true;
 
-        } else if (name == "G91") {
+        } else if (code == CommandCode::Relative) {
             // relative mode
             absolute = false;
 
-        } else if (name == "G90.1") {
+        } else if (code == CommandCode::AbsoluteCenter) {
             // absolute mode
             absolutecenter = true;
 
-        } else if (name == "G91.1") {
+        } else if (code == CommandCode::RelativeCenter) {
             // relative mode
             absolutecenter = false;
 
-        } else if ((name=="G73")||(name=="G81")||(name=="G82")||(name=="G83")||(name=="G84")||(name=="G85")||(name=="G86")||(name=="G89")){
+        } else if (code == CommandCode::Drill) {
             // drill,tap,bore
-            double r = 0;
-            if (cmd.has("R"))
-                r = cmd.getValue("R");
+            double r = tp.getValue(i, "R");
 
             std::deque<Base::Vector3d> plist;
             std::deque<Base::Vector3d> qlist;
@@ -288,7 +314,7 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             Base::Vector3d p1(next);
             p1.*pz = last.*pz;
 
-            if (nrot != lrot) {
+            if (cb && nrot != lrot) {
                 double amax = std::max(fmod(fabs(a - A), 360), std::max(fmod(fabs(b - B), 360), fmod(fabs(c - C), 360)));
                 double angle = amax / 180 * M_PI;
                 int segments = std::max(ARC_MIN_SEGMENTS, 3.0/(deviation/angle));
@@ -315,8 +341,8 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             Base::Vector3d p2r = compensateRotation(p2, nrot, rotCenter);
 
             double q;
-            if (cmd.has("Q")) {
-                q = cmd.getValue("Q");
+            if (cb && tp.has(i, "Q")) {
+                q = tp.getValue(i, "Q");
                 if (q>0) {
                     Base::Vector3d temp(next);
                     for(temp.*pz=r;temp.*pz>next.*pz;temp.*pz-=q) {
@@ -339,7 +365,8 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             plist.push_back(p2r);
             plist.push_back(p3r);
 
-            cb.g8x(i, last, next, points, plist, qlist);
+            if (cb)
+                cb->g8x(i, last, next, points, plist, qlist);
 
             last = p3;
             A = a;
@@ -348,19 +375,20 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             lrot = nrot;
 
 
-        } else if ((name=="G38.2")||(name=="G38.3")||(name=="G38.4")||(name=="G38.5")){
+        } else if (code == CommandCode::Probe) {
             // Straight probe
-            cb.g38(i, last, next);
+            if (cb)
+                cb->g38(i, last, next);
             last = next;
-        } else if(name=="G17") {
+        } else if(code == CommandCode::PlaneXY) {
             pz = &Base::Vector3d::z;
-        } else if(name=="G18") {
+        } else if(code == CommandCode::PlaneXZ) {
             pz = &Base::Vector3d::y;
-        } else if(name=="G19") {
+        } else if(code == CommandCode::PlaneYZ) {
             pz = &Base::Vector3d::x;
-        } else if(name=="G98") {
+        } else if(code == CommandCode::RetractInitial) {
             retract_mode = 98;
-        } else if(name=="G99") {
+        } else if(code == CommandCode::RetractR) {
             retract_mode = 99;
         }
     }
@@ -59,14 +59,35 @@ class PathExport PathSegmentVisitor
 class PathExport PathSegmentWalker
 {
 public:
+    /// The modal state of the machine between two commands
+    struct State {
+        State(const Base::Vector3d &startPosition = Base::Vector3d());
+
+        Base::Vector3d last;
+        double A, B, C;
+        bool absolute;
+        bool absolutecenter;
+        double Base::Vector3d::*pz; // for mapping the coordinates to XY plane
+        int retract_mode;
+    };
+
     PathSegmentWalker(const Toolpath &tp_);
 
 
     void walk(PathSegmentVisitor &cb, const Base::Vector3d &startPosition);
+    /** Walks the commands [begin, end) starting with the given state and advances the
+     * state past them. PathSegmentVisitor::setup() is not called. Several ranges of
+     * the same path can be walked concurrently if each has its own state.
+     */
+    void walk(PathSegmentVisitor &cb, State &state, unsigned int begin, unsigned int end) const;
+    /// Advances the state past the commands [begin, end) without segmenting any of them
+    void skip(State &state, unsigned int begin, unsigned int end) const;
 
 private:
+    void walkRange(PathSegmentVisitor *cb, State &state, unsigned int begin, unsigned int end) const;
+
     const Toolpath &tp;
-    int retract_mode;
+    double deviation;
 };
 
 
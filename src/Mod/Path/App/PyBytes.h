@@ -0,0 +1,43 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PATH_PYBYTES_H
+#define PATH_PYBYTES_H
+
+#include <vector>
+
+#include <CXX/Objects.hxx>
+
+
+namespace Path
+{
+
+/// Returns the raw memory of \a values as Python bytes, e.g. to build numpy arrays from it.
+template <class T>
+Py::Bytes toBytes(const std::vector<T> &values)
+{
+    return Py::Bytes(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+}
+
+#endif // PATH_PYBYTES_H
@@ -23,6 +23,8 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <Standard_math.hxx>
+# include <algorithm>
+# include <set>
 #endif
 
 #include <Base/Vector3D.h>
@@ -37,6 +39,167 @@ TYPESYSTEM_SOURCE(Path::Voronoi , Base::BaseClass)
 
 // Helpers
 
+namespace {
+
+  using edge_type   = Voronoi::diagram_type::edge_type;
+  using cell_type   = Voronoi::diagram_type::cell_type;
+  using vertex_type = Voronoi::diagram_type::vertex_type;
+
+  double distanceBetween(double x0, double y0, double x1, double y1) {
+    return sqrt((x0 - x1) * (x0 - x1) + (y0 - y1) * (y0 - y1));
+  }
+
+  double distanceToLine(double x, double y, const Voronoi::segment_type &s) {
+    double dx = high(s).x() - low(s).x();
+    double dy = high(s).y() - low(s).y();
+    double len = sqrt(dx * dx + dy * dy);
+    if (len == 0) {
+      return distanceBetween(x, y, low(s).x(), low(s).y());
+    }
+    return fabs(dx * (y - low(s).y()) - dy * (x - low(s).x())) / len;
+  }
+
+  double distanceToSegment(double x, double y, const Voronoi::segment_type &s) {
+    double dx = high(s).x() - low(s).x();
+    double dy = high(s).y() - low(s).y();
+    double len2 = dx * dx + dy * dy;
+    double t = len2 == 0 ? 0 : ((x - low(s).x()) * dx + (y - low(s).y()) * dy) / len2;
+    t = std::max(0., std::min(1., t));
+    return distanceBetween(x, y, low(s).x() + t * dx, low(s).y() + t * dy);
+  }
+
+  // Even-odd test of points against the closed loops formed by the input segments. The
+  // segments are sorted into horizontal bands, so a point is only tested against the
+  // segments of the band it is in. Points within tolerance of a segment are inside.
+  class SegmentBands {
+  public:
+    SegmentBands(const std::vector<Voronoi::segment_type> &segs, double tol)
+      : segments(segs)
+      , tolerance(tol)
+      , ymin(0)
+      , height(0)
+    {
+      if (segments.empty()) {
+        return;
+      }
+      double ymax = ymin = low(segments.front()).y();
+      for (const auto &s : segments) {
+        ymin = std::min(ymin, std::min(low(s).y(), high(s).y()));
+        ymax = std::max(ymax, std::max(low(s).y(), high(s).y()));
+      }
+      ymin -= tolerance;
+      ymax += tolerance;
+      std::size_t count = std::max<std::size_t>(1, std::size_t(sqrt(double(segments.size()))));
+      height = (ymax - ymin) / count;
+      bands.resize(count);
+      for (std::size_t i = 0; i < segments.size(); ++i) {
+        const auto &s = segments[i];
+        int first = band(std::min(low(s).y(), high(s).y()) - tolerance);
+        int last  = band(std::max(low(s).y(), high(s).y()) + tolerance);
+        for (int b = first; b <= last; ++b) {
+          bands[b].push_back(int(i));
+        }
+      }
+    }
+
+    bool isInside(double x, double y) const {
+      if (bands.empty() || y < ymin || y > ymin + height * bands.size()) {
+        return false;
+      }
+      bool inside = false;
+      for (int i : bands[band(y)]) {
+        const auto &s = segments[i];
+        if (distanceToSegment(x, y, s) <= tolerance) {
+          return true;
+        }
+        double x0 = low(s).x(), y0 = low(s).y();
+        double x1 = high(s).x(), y1 = high(s).y();
+        if ((y0 > y) != (y1 > y) && x < x0 + (y - y0) * (x1 - x0) / (y1 - y0)) {
+          inside = !inside;
+        }
+      }
+      return inside;
+    }
+
+  private:
+    int band(double y) const {
+      if (height <= 0) {
+        return 0;
+      }
+      int b = int((y - ymin) / height);
+      return std::max(0, std::min(int(bands.size()) - 1, b));
+    }
+
+    const std::vector<Voronoi::segment_type> &segments;
+    double tolerance;
+    double ymin;
+    double height;
+    std::vector<std::vector<int> > bands;
+  };
+
+  // the distance of a vertex of the edge to the input geometry, see VoronoiEdge.getDistances()
+  double distanceToSource(const Voronoi::diagram_type &dia, const edge_type *edge, const vertex_type *v) {
+    const cell_type *c0 = edge->cell();
+    const cell_type *c1 = edge->twin()->cell();
+    if (c0->contains_point() || c1->contains_point()) {
+      Voronoi::point_type p = dia.retrievePoint(c0->contains_point() ? c0 : c1);
+      return distanceBetween(v->x(), v->y(), p.x(), p.y()) / dia.getScale();
+    }
+    return distanceToLine(v->x(), v->y(), dia.retrieveSegment(c0)) / dia.getScale();
+  }
+
+  // Appends the points of the parabola equidistant to focus and segment between v0 and v1,
+  // without the end points, so that no chord deviates more than deflection from it. Each
+  // chord is split at the point with a tangent parallel to it, which is farthest from it.
+  void sampleParabola(const Voronoi::point_type &focus, const Voronoi::segment_type &segment,
+                      const vertex_type &v0, const vertex_type &v1, double deflection,
+                      std::vector<Voronoi::point_type> &samples) {
+    double ax = low(segment).x();
+    double ay = low(segment).y();
+    double dx = high(segment).x() - ax;
+    double dy = high(segment).y() - ay;
+    double len = sqrt(dx * dx + dy * dy);
+    if (len == 0 || deflection <= 0) {
+      return;
+    }
+    dx /= len;
+    dy /= len;
+    // in the coordinate system of the segment the parabola is y = ((x - px)^2 + py^2) / 2py
+    auto toX = [&](double x, double y) { return (x - ax) * dx + (y - ay) * dy; };
+    auto toY = [&](double x, double y) { return (y - ay) * dx - (x - ax) * dy; };
+    double px = toX(focus.x(), focus.y());
+    double py = toY(focus.x(), focus.y());
+    if (py == 0) {
+      return;
+    }
+    auto parabola = [&](double x) { return ((x - px) * (x - px) + py * py) / (2 * py); };
+
+    double x = toX(v0.x(), v0.y());
+    std::vector<double> ends(1, toX(v1.x(), v1.y()));
+    while (!ends.empty()) {
+      double xe = ends.back();
+      double dist = 0;
+      if (xe != x) {
+        double y  = parabola(x);
+        double ye = parabola(xe);
+        double xm = (x + xe) / 2;
+        double slope = (ye - y) / (xe - x);
+        dist = fabs(parabola(xm) - (y + ye) / 2) / sqrt(1 + slope * slope);
+        if (dist > deflection) {
+          ends.push_back(xm);
+          continue;
+        }
+      }
+      ends.pop_back();
+      if (!ends.empty()) {
+        double ye = parabola(xe);
+        samples.emplace_back(ax + xe * dx - ye * dy, ay + xe * dy + ye * dx);
+      }
+      x = xe;
+    }
+  }
+}
+
 // Voronoi::diagram_type
 
 Voronoi::diagram_type::diagram_type()
@@ -210,6 +373,52 @@ void Voronoi::colorExterior(Voronoi::color_type color) {
   }
 }
 
+void Voronoi::colorExterior(Voronoi::color_type color, const std::function<bool(const vertex_type*)> &isExterior) {
+  colorExterior(color);
+
+  // each vertex is only checked once
+  std::vector<signed char> cache(vd->num_vertices(), -1);
+  auto exterior = [&](const vertex_type *v) {
+    if (v->color()) {
+      return false;
+    }
+    signed char &c = cache[v - &vd->vertices().front()];
+    if (c < 0) {
+      c = isExterior(v) ? 1 : 0;
+    }
+    return c == 1;
+  };
+
+  std::map<int32_t, std::set<int32_t> > pts;
+  for (auto e = vd->edges().begin(); e != vd->edges().end(); ++e) {
+    if (e->is_finite() && e->color() == 0) {
+      const vertex_type *v0 = e->vertex0();
+      const vertex_type *v1 = e->vertex1();
+      if (exterior(v0) && exterior(v1)) {
+        colorExterior(&(*e), color);
+      } else if (exterior(v1)) {
+        if (pts.empty()) {
+          for (auto s = vd->segments.begin(); s != vd->segments.end(); ++s) {
+            pts[low(*s).x()].insert(low(*s).y());
+            pts[high(*s).x()].insert(high(*s).y());
+          }
+        }
+        auto ys = pts.find(int32_t(v0->x()));
+        if (ys != pts.end() && ys->second.find(v0->y()) != ys->second.end()) {
+          colorExterior(&(*e), color);
+        }
+      }
+    }
+  }
+}
+
+void Voronoi::colorOutside(Voronoi::color_type color, double tolerance) {
+  SegmentBands bands(vd->segments, tolerance * vd->getScale());
+  colorExterior(color, [&](const vertex_type *v) {
+    return !bands.isInside(v->x(), v->y());
+  });
+}
+
 void Voronoi::colorTwins(Voronoi::color_type color) {
   for (diagram_type::const_edge_iterator it = vd->edges().begin(); it != vd->edges().end(); ++it) {
     if (!it->color()) {
@@ -285,6 +494,118 @@ void Voronoi::colorColinear(Voronoi::color_type color, double degree) {
   }
 }
 
+bool Voronoi::diagram_type::isBorderline(const Voronoi::diagram_type::edge_type *edge) const {
+  if (edge->is_linear()) {
+    return false;
+  }
+  bool pointCell = edge->cell()->contains_point();
+  Voronoi::point_type   point   = retrievePoint(pointCell ? edge->cell() : edge->twin()->cell());
+  Voronoi::segment_type segment = retrieveSegment(pointCell ? edge->twin()->cell() : edge->cell());
+  return 1e-6 > distanceBetween(point.x(), point.y(), low(segment).x(), low(segment).y()) / scale
+      || 1e-6 > distanceBetween(point.x(), point.y(), high(segment).x(), high(segment).y()) / scale;
+}
+
+void Voronoi::colorEdges(Voronoi::color_type primary, Voronoi::color_type secondary, Voronoi::color_type borderline) {
+  for (auto it = vd->edges().begin(); it != vd->edges().end(); ++it) {
+    if (!it->is_primary()) {
+      it->color(secondary);
+    } else if (vd->isBorderline(&(*it))) {
+      it->color(borderline);
+    } else {
+      it->color(primary);
+    }
+  }
+}
+
+void Voronoi::getMedialAxis(Voronoi::color_type color, double deflection,
+                            std::vector<double> &points, std::vector<int> &wireIndices) const {
+  points.clear();
+  wireIndices.clear();
+  if (vd->vertices().empty()) {
+    return;
+  }
+  auto vertexIndex = [&](const vertex_type *v) {
+    return int(v - &vd->vertices().front());
+  };
+
+  // the edges at each vertex, and the vertices in the order they are first used
+  std::vector<std::vector<const edge_type*> > adjacent(vd->num_vertices());
+  std::vector<int> order;
+  for (auto e = vd->edges().begin(); e != vd->edges().end(); ++e) {
+    if (e->is_finite() && e->color() == color) {
+      for (const vertex_type *v : {e->vertex0(), e->vertex1()}) {
+        auto &edges = adjacent[vertexIndex(v)];
+        if (edges.empty()) {
+          order.push_back(vertexIndex(v));
+        }
+        edges.push_back(&(*e));
+      }
+    }
+  }
+
+  // wires start and end at the knots, which are the vertices that are not just part of a wire
+  std::vector<int> knots;
+  for (int v : order) {
+    if (adjacent[v].size() == 1) {
+      knots.push_back(v);
+    }
+  }
+  for (int v : order) {
+    if (adjacent[v].size() > 2) {
+      knots.push_back(v);
+    }
+  }
+  if (knots.empty() && !order.empty()) {
+    knots.push_back(order.front());
+  }
+
+  auto consume = [&](int v, const edge_type *edge) {
+    auto &edges = adjacent[v];
+    edges.erase(std::remove(edges.begin(), edges.end(), edge), edges.end());
+    return edges.empty();
+  };
+  double scale = vd->getScale();
+  auto addPoint = [&](double x, double y, double distance) {
+    points.push_back(x / scale);
+    points.push_back(y / scale);
+    points.push_back(distance);
+  };
+
+  // the edge or its twin, whichever starts at the given vertex
+  auto startingAt = [&](int v, const edge_type *edge) {
+    return vertexIndex(edge->vertex0()) == v ? edge : edge->twin();
+  };
+
+  std::vector<Voronoi::point_type> samples;
+  for (int knot : knots) {
+    while (!adjacent[knot].empty()) {
+      const edge_type *first = startingAt(knot, adjacent[knot].front());
+      addPoint(first->vertex0()->x(), first->vertex0()->y(), distanceToSource(*vd, first, first->vertex0()));
+      for (int v = knot; v >= 0 && !adjacent[v].empty(); ) {
+        const edge_type *edge = adjacent[v].front();
+        const edge_type *directed = startingAt(v, edge);
+        if (directed->is_curved()) {
+          bool pointCell = directed->cell()->contains_point();
+          Voronoi::point_type   focus   = vd->retrievePoint(pointCell ? directed->cell() : directed->twin()->cell());
+          Voronoi::segment_type segment = vd->retrieveSegment(pointCell ? directed->twin()->cell() : directed->cell());
+          samples.clear();
+          sampleParabola(focus, segment, *directed->vertex0(), *directed->vertex1(), deflection * scale, samples);
+          for (const auto &p : samples) {
+            addPoint(p.x(), p.y(), distanceBetween(p.x(), p.y(), focus.x(), focus.y()) / scale);
+          }
+        }
+        const vertex_type *v1 = directed->vertex1();
+        addPoint(v1->x(), v1->y(), distanceToSource(*vd, directed, v1));
+
+        int next = vertexIndex(v1);
+        consume(v, edge);
+        v = consume(next, edge) ? -1 : next;
+      }
+      wireIndices.push_back(int(points.size() / 3));
+    }
+  }
+}
+
 void Voronoi::resetColor(Voronoi::color_type color) {
   for (auto it = vd->cells().begin(); it != vd->cells().end(); ++it) {
     if (color == 0 || it->color() == color) {
@@ -23,6 +23,7 @@
 #define PATH_VORONOI_H
 
 #include <climits>
+#include <functional>
 #include <map>
 #include <vector>
 #include <Base/BaseClass.h>
@@ -95,6 +96,9 @@ namespace Path
       double angleOfSegment(int i, angle_map_t *angle = nullptr) const;
       bool segmentsAreConnected(int i, int j) const;
 
+      // a curved edge between a segment and one of its end points
+      bool isBorderline(const edge_type *edge) const;
+
     private:
       double          scale;
       cell_map_type   cell_index;
@@ -114,8 +118,19 @@ namespace Path
 
     void resetColor(color_type color);
     void colorExterior(color_type color);
+    void colorExterior(color_type color, const std::function<bool(const vertex_type*)> &isExterior);
+    void colorOutside(color_type color, double tolerance);
     void colorTwins(color_type color);
     void colorColinear(color_type color, double degree);
+    void colorEdges(color_type primary, color_type secondary, color_type borderline);
+
+    /** Chains the finite edges with the given color into wires. Each wire is appended
+     * to \a points as x, y and the distance to the input geometry of its points, curved
+     * edges are discretized with the given deflection. \a wireIndices receives the end
+     * of each wire in points.
+     */
+    void getMedialAxis(color_type color, double deflection,
+        std::vector<double> &points, std::vector<int> &wireIndices) const;
 
     template<typename T>
     T* create(int index) {
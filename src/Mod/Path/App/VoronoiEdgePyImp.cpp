@@ -402,14 +402,7 @@ PyObject* VoronoiEdgePy::isSecondary(PyObject *args)
 PyObject* VoronoiEdgePy::isBorderline(PyObject *args)
 {
   VoronoiEdge *e = getVoronoiEdgeFromPy(this, args);
-  PyObject *chk = Py_False;
-  if (e->isBound() && !e->ptr->is_linear()) {
-    Voronoi::point_type   point   = e->ptr->cell()->contains_point() ? e->dia->retrievePoint(e->ptr->cell())  : e->dia->retrievePoint(e->ptr->twin()->cell());
-    Voronoi::segment_type segment = e->ptr->cell()->contains_point() ? e->dia->retrieveSegment(e->ptr->twin()->cell()) : e->dia->retrieveSegment(e->ptr->cell());
-    if (isPointOnSegment(point, segment, e->dia->getScale())) {
-      chk = Py_True;
-    }
-  }
+  PyObject *chk = e->dia->isBorderline(e->ptr) ? Py_True : Py_False;
   Py_INCREF(chk);
   return chk;
 }
@@ -31,6 +31,7 @@
 #include "VoronoiCellPy.h"
 #include "VoronoiEdgePy.h"
 #include "VoronoiVertexPy.h"
+#include "PyBytes.h"
 
 
 using namespace Path;
@@ -162,45 +163,6 @@ Py::List VoronoiPy::getCells() const {
   return list;
 }
 
-using exterior_map_t = std::map<uintptr_t,bool>;
-using coordinate_map_t = std::map<int32_t, std::set<int32_t> >;
-
-#define VORONOI_USE_EXTERIOR_CACHE 1
-
-static bool callbackWithVertex(Voronoi::diagram_type *dia, PyObject *callback, const Voronoi::diagram_type::vertex_type *v, bool &bail, exterior_map_t &cache) {
-  bool rc = false;
-  if (!bail && v->color() == 0) {
-#if VORONOI_USE_EXTERIOR_CACHE
-    auto it = cache.find(uintptr_t(v));
-    if (it == cache.end()) {
-#endif
-      PyObject *vx = new VoronoiVertexPy(new VoronoiVertex(dia, v));
-      PyObject *arglist = Py_BuildValue("(O)", vx);
-#if PY_VERSION_HEX < 0x03090000
-      PyObject *result = PyEval_CallObject(callback, arglist);
-#else
-      PyObject *result = PyObject_CallObject(callback, arglist);
-#endif
-      Py_DECREF(arglist);
-      Py_DECREF(vx);
-      if (!result) {
-        bail = true;
-      } else {
-        rc = result == Py_True;
-        Py_DECREF(result);
-        cache.insert(exterior_map_t::value_type(uintptr_t(v), rc));
-      }
-#if VORONOI_USE_EXTERIOR_CACHE
-    } else {
-      rc = it->second;
-    }
-#else
-    (void)cache;
-#endif
-  }
-  return rc;
-}
-
 PyObject* VoronoiPy::colorExterior(PyObject *args) {
   Voronoi::color_type color = 0;
   PyObject *callback = nullptr;
@@ -208,40 +170,54 @@ PyObject* VoronoiPy::colorExterior(PyObject *args) {
     throw  Py::RuntimeError("colorExterior requires an integer (color) argument");
   }
   Voronoi *vo = getVoronoiPtr();
-  vo->colorExterior(color);
-  if (callback) {
-    exterior_map_t   cache;
-    coordinate_map_t pts;
-    for (auto e = vo->vd->edges().begin(); e != vo->vd->edges().end(); ++e) {
-      if (e->is_finite() && e->color() == 0) {
-        const Voronoi::diagram_type::vertex_type *v0 = e->vertex0();
-        const Voronoi::diagram_type::vertex_type *v1 = e->vertex1();
-        bool bail = false;
-        if (callbackWithVertex(vo->vd, callback, v0, bail, cache) && callbackWithVertex(vo->vd, callback, v1, bail, cache)) {
-          vo->colorExterior(&(*e), color);
-        } else if (!bail && callbackWithVertex(vo->vd, callback, v1, bail, cache)) {
-          if (pts.empty()) {
-            for (auto s = vo->vd->segments.begin(); s != vo->vd->segments.end(); ++s) {
-              pts[low(*s).x()].insert(low(*s).y());
-              pts[high(*s).x()].insert(high(*s).y());
-            }
-          }
-          auto ys = pts.find(int32_t(v0->x()));
-          if (ys != pts.end() && ys->second.find(v0->y()) != ys->second.end()) {
-            vo->colorExterior(&(*e), color);
-          }
-        }
-        if (bail) {
-          return nullptr;
-        }
+  if (!callback) {
+    vo->colorExterior(color);
+  } else {
+    vo->colorExterior(color, [&](const Voronoi::diagram_type::vertex_type *v) {
+      Py::Tuple arglist(1);
+      arglist.setItem(0, Py::asObject(new VoronoiVertexPy(new VoronoiVertex(vo->vd, v))));
+      PyObject *result = PyObject_CallObject(callback, arglist.ptr());
+      if (!result) {
+        throw Py::Exception();
       }
-    }
+      bool rc = result == Py_True;
+      Py_DECREF(result);
+      return rc;
+    });
   }
 
   Py_INCREF(Py_None);
   return Py_None;
 }
 
+PyObject* VoronoiPy::colorOutside(PyObject *args) {
+  Voronoi::color_type color = 0;
+  double tolerance = 0;
+  if (!PyArg_ParseTuple(args, "k|d", &color, &tolerance)) {
+    throw  Py::RuntimeError("colorOutside requires an integer (color) and optionally a tolerance argument");
+  }
+  getVoronoiPtr()->colorOutside(color, tolerance);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* VoronoiPy::colorEdges(PyObject *args) {
+  Voronoi::color_type primary = 0;
+  Voronoi::color_type secondary = 0;
+  Voronoi::color_type borderline = 0;
+  if (!PyArg_ParseTuple(args, "kk|k", &primary, &secondary, &borderline)) {
+    throw  Py::RuntimeError("colorEdges requires two or three integer (color) arguments");
+  }
+  if (PyTuple_Size(args) < 3) {
+    borderline = primary;
+  }
+  getVoronoiPtr()->colorEdges(primary, secondary, borderline);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
 PyObject* VoronoiPy::colorTwins(PyObject *args) {
   Voronoi::color_type color = 0;
   if (!PyArg_ParseTuple(args, "k", &color)) {
@@ -325,6 +301,23 @@ PyObject* VoronoiPy::numSegments(PyObject *args)
 }
 
 
+PyObject* VoronoiPy::getMedialAxis(PyObject *args) {
+  Voronoi::color_type color = 0;
+  double deflection = 0.01;
+  if (!PyArg_ParseTuple(args, "k|d", &color, &deflection)) {
+    throw  Py::RuntimeError("getMedialAxis requires an integer (color) and optionally a deflection argument");
+  }
+  std::vector<double> points;
+  std::vector<int> wireIndices;
+  getVoronoiPtr()->getMedialAxis(color, deflection, points, wireIndices);
+
+  Py::Dict result;
+  result.setItem("Points", toBytes(points));
+  result.setItem("WireIndices", toBytes(wireIndices));
+  return Py::new_reference_to(result);
+}
+
+
 // custom attributes get/set
 
 PyObject *VoronoiPy::getCustomAttributes(const char* /*attr*/) const
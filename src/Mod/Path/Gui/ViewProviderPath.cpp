@@ -48,7 +48,6 @@
 #include <Gui/SoFCBoundingBox.h>
 #include <Gui/SoFCUnifiedSelection.h>
 #include <Mod/Path/App/FeaturePath.h>
-#include <Mod/Path/App/PathSegmentWalker.h>
 
 #include "ViewProviderPath.h"
 
@@ -133,7 +132,7 @@ public:
 PROPERTY_SOURCE(PathGui::ViewProviderPath, Gui::ViewProviderGeometryObject)
 
 ViewProviderPath::ViewProviderPath()
-    :pt0Index(-1),blockPropertyChange(false),edgeStart(-1),coordStart(-1),coordEnd(-1)
+    :polylineRevision(0),pt0Index(-1),blockPropertyChange(false),edgeStart(-1),coordStart(-1),coordEnd(-1)
 {
     ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Path");
     unsigned long lcol = hGrp->GetUnsigned("DefaultNormalPathColor",11141375UL); // dark green (0,170,0)
@@ -296,8 +295,8 @@ std::string ViewProviderPath::getElement(const SoDetail* detail) const
     if(edgeStart>=0 && detail && detail->getTypeId() == SoLineDetail::getClassTypeId()) {
         const SoLineDetail* line_detail = static_cast<const SoLineDetail*>(detail);
         int index = line_detail->getLineIndex()+edgeStart;
-        if(index>=0 && index<(int)edge2Command.size()) {
-            index = edge2Command[index];
+        if(index>=0 && index<(int)polyline.edge2Command.size()) {
+            index = polyline.edge2Command[index];
             Path::Feature* pcPathObj = static_cast<Path::Feature*>(pcObject);
             const Toolpath &tp = pcPathObj->Path.getValue();
             if(index<(int)tp.getSize()) {
@@ -319,8 +318,8 @@ SoDetail* ViewProviderPath::getDetail(const char* subelement) const
 {
     int index = std::atoi(subelement);
     SoDetail* detail = nullptr;
-    if (index>0 && index<=(int)command2Edge.size()) {
-        index = command2Edge[index-1];
+    if (index>0 && index<=(int)polyline.command2Edge.size()) {
+        index = polyline.command2Edge[index-1];
         if(index>=0 && edgeStart>=0 && edgeStart<=index) {
             detail = new SoLineDetail();
             static_cast<SoLineDetail*>(detail)->setLineIndex(index-edgeStart);
@@ -337,6 +336,7 @@ void ViewProviderPath::onChanged(const App::Property* prop)
     if (prop == &LineWidth) {
         pcDrawStyle->lineWidth = LineWidth.getValue();
     } else if (prop == &NormalColor) {
+        const auto &colorindex = polyline.colorindex;
         if (!colorindex.empty() && coordStart>=0 && coordStart<(int)colorindex.size()) {
             const App::Color& c = NormalColor.getValue();
             ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Path");
@@ -384,6 +384,9 @@ void ViewProviderPath::onChanged(const App::Property* prop)
             const Base::Vector3d &pt = StartPosition.getValue();
             pcLineCoords->point.set1Value(0,pt.x,pt.y,pt.z);
             pcMarkerCoords->point.set1Value(0,pt.x,pt.y,pt.z);
+            polyline.points[0] = polyline.markers[0] = pt.x;
+            polyline.points[1] = polyline.markers[1] = pt.y;
+            polyline.points[2] = polyline.markers[2] = pt.z;
         }
     } else {
         inherited::onChanged(prop);
@@ -450,153 +453,6 @@ void ViewProviderPath::hideSelection() {
     pcArrowSwitch->whichChild = -1;
 }
 
-class VisualPathSegmentVisitor
-: public PathSegmentVisitor
-{
-public:
-    VisualPathSegmentVisitor(
-        const Toolpath &tp,
-        SoCoordinate3 *pcLineCoords_,
-        SoCoordinate3 *pcMarkerCoords_,
-        std::vector<int> &command2Edge_,
-        std::deque<int> &edge2Command_,
-        std::deque<int> &edgeIndices_,
-        std::vector<int> &colorindex_,
-        std::deque<Base::Vector3d> &points_,
-        std::deque<Base::Vector3d> &markers_)
-    : pcLineCoords(pcLineCoords_)
-    , pcMarkerCoords(pcMarkerCoords_)
-    , command2Edge(command2Edge_)
-    , edge2Command(edge2Command_)
-    , edgeIndices(edgeIndices_)
-    , colorindex(colorindex_)
-    , points(points_)
-    , markers(markers_)
-    {
-        pcLineCoords->point.deleteValues(0);
-        pcMarkerCoords->point.deleteValues(0);
-
-        command2Edge.clear();
-        edge2Command.clear();
-        edgeIndices.clear();
-
-        colorindex.clear();
-
-        command2Edge.resize(tp.getSize(),-1);
-    }
-
-    void setup(const Base::Vector3d &last) override
-    {
-        points.push_back(last);
-        markers.push_back(last);
-    }
-
-    void g0(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts) override
-    {
-        (void)last;
-        gx(id, &next, pts, 0);
-    }
-
-    void g1(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts) override
-    {
-        (void)last;
-        gx(id, &next, pts, 1);
-    }
-
-    void g23(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts, const Base::Vector3d &center) override
-    {
-        (void)last;
-        gx(id, &next, pts, 1);
-        markers.push_back(center);
-    }
-
-    void g8x(int id, const Base::Vector3d &last, const Base::Vector3d &next, const std::deque<Base::Vector3d> &pts,
-                     const std::deque<Base::Vector3d> &p, const std::deque<Base::Vector3d> &q) override
-    {
-        (void)last;
-
-        gx(id, nullptr, pts, 0);
-
-        points.push_back(p[0]);
-        markers.push_back(p[0]);
-        colorindex.push_back(0);
-
-        points.push_back(p[1]);
-        markers.push_back(p[1]);
-        colorindex.push_back(0);
-
-        points.push_back(next);
-        markers.push_back(next);
-        colorindex.push_back(1);
-
-        for (std::deque<Base::Vector3d>::const_iterator it=q.begin(); q.end() != it; ++it) {
-            markers.push_back(*it);
-        }
-
-        points.push_back(p[2]);
-        markers.push_back(p[2]);
-        colorindex.push_back(0);
-
-        pushCommand(id);
-    }
-
-    void g38(int id, const Base::Vector3d &last, const Base::Vector3d &next) override
-    {
-#if 0
-      Base::Vector3d p1(next.x,next.y,last.z);
-      points.push_back(p1);
-      colorindex.push_back(0);
-
-      points.push_back(next);
-      colorindex.push_back(2);
-
-      Base::Vector3d p3(next.x,next.y,last.z);
-      points.push_back(p3);
-      colorindex.push_back(0);
-
-      pushCommand(id);
-#else
-      (void)last;
-      const std::deque<Base::Vector3d> pts{};
-      gx(id, &next, pts, 2);
-#endif
-    }
-
-private:
-    SoCoordinate3 *pcLineCoords;
-    SoCoordinate3 *pcMarkerCoords;
-
-    std::vector<int> &command2Edge;
-    std::deque<int> &edge2Command;
-    std::deque<int> &edgeIndices;
-
-    std::vector<int> &colorindex;
-    std::deque<Base::Vector3d> &points;
-    std::deque<Base::Vector3d> &markers;
-
-    virtual void gx(int id, const Base::Vector3d *next, const std::deque<Base::Vector3d> &pts, int color)
-    {
-        for (std::deque<Base::Vector3d>::const_iterator it=pts.begin(); pts.end() != it; ++it) {
-          points.push_back(*it);
-          colorindex.push_back(color);
-        }
-
-        if (next) {
-            points.push_back(*next);
-            markers.push_back(*next);
-            colorindex.push_back(color);
-
-            pushCommand(id);
-        }
-    }
-
-    void pushCommand(int id) {
-      command2Edge[id] = edgeIndices.size();
-      edgeIndices.push_back(points.size());
-      edge2Command.push_back(id);
-    }
-};
-
 void ViewProviderPath::updateVisual(bool rebuild) {
 
     hideSelection();
@@ -608,43 +464,32 @@ void ViewProviderPath::updateVisual(bool rebuild) {
     if(rebuild) {
         Path::Feature* pcPathObj = static_cast<Path::Feature*>(pcObject);
         const Toolpath &tp = pcPathObj->Path.getValue();
+        const Base::Vector3d &start = StartPosition.getValue();
 
-        std::deque<Base::Vector3d> points;
-        std::deque<Base::Vector3d> markers;
-
-        VisualPathSegmentVisitor collect(tp,
-            pcLineCoords,
-            pcMarkerCoords,
-            command2Edge,
-            edge2Command,
-            edgeIndices,
-            colorindex,
-            points,
-            markers);
+        // the nodes already show the polyline if neither the toolpath nor the start changed
+        if(tp.getRevision() != polylineRevision || start != polylineStart) {
+            polyline.build(tp, start);
+            polylineRevision = tp.getRevision();
+            polylineStart = start;
 
-        PathSegmentWalker segments(tp);
-        segments.walk(collect, StartPosition.getValue());
+            pcLineCoords->point.deleteValues(0);
+            pcMarkerCoords->point.deleteValues(0);
 
+            if (polyline.numEdges()) {
+                pcLineCoords->point.setValues(0, polyline.numPoints(),
+                        reinterpret_cast<const float (*)[3]>(polyline.points.data()));
+                pcMarkerCoords->point.setValues(0, polyline.numMarkers(),
+                        reinterpret_cast<const float (*)[3]>(polyline.markers.data()));
 
-        if (!edgeIndices.empty()) {
-            pcLineCoords->point.setNum(points.size());
-            SbVec3f* verts = pcLineCoords->point.startEditing();
-            int i=0;
-            for(const auto &pt : points)
-                verts[i++].setValue(pt.x,pt.y,pt.z);
-            pcLineCoords->point.finishEditing();
-
-            pcMarkerCoords->point.setNum(markers.size());
-            for(unsigned int i=0;i<markers.size();i++)
-                pcMarkerCoords->point.set1Value(i,markers[i].x,markers[i].y,markers[i].z);
-
-            recomputeBoundingBox();
+                recomputeBoundingBox();
+            }
         }
     }
 
     // count = index + separators
     edgeStart = -1;
     int i;
+    const std::vector<int> &command2Edge = polyline.command2Edge;
     for(i=StartIndex.getValue();i<(int)command2Edge.size();++i)
         if((edgeStart=command2Edge[i])>=0) break;
 
@@ -659,28 +504,17 @@ void ViewProviderPath::updateVisual(bool rebuild) {
     }
 
     int edgeEnd = edgeStart+ShowCount.getValue();
-    if(edgeEnd==edgeStart || edgeEnd>(int)edgeIndices.size())
-        edgeEnd = edgeIndices.size();
+    if(edgeEnd==edgeStart || edgeEnd>(int)polyline.numEdges())
+        edgeEnd = polyline.numEdges();
 
     // coord index start
-    coordStart = edgeStart==0?0:(edgeIndices[edgeStart-1]-1);
-    coordEnd = edgeIndices[edgeEnd-1];
-
-    // count = coord indices + index separators
-    int count = coordEnd-coordStart+2*(edgeEnd-edgeStart-1)+1;
-
-    pcLines->coordIndex.setNum(count);
-    int32_t *idx = pcLines->coordIndex.startEditing();
-    i=0;
-    int start = coordStart;
-    for(int e=edgeStart;e!=edgeEnd;++e) {
-        for(int end=edgeIndices[e];start<end;++start)
-            idx[i++] = start;
-        idx[i++]=-1;
-        --start;
-    }
-    pcLines->coordIndex.finishEditing();
-    assert(i==count);
+    coordStart = edgeStart==0?0:(polyline.edgeIndices[edgeStart-1]-1);
+    coordEnd = polyline.edgeIndices[edgeEnd-1];
+
+    // the coord indices of the shown edges are a slice of those of the whole path
+    std::size_t first = polyline.coordIndexOffset(edgeStart);
+    std::size_t count = polyline.coordIndexOffset(edgeEnd) - first;
+    pcLines->coordIndex.setValues(0, count, polyline.coordIndex.data() + first);
 
     NormalColor.touch();
 }
@@ -698,10 +532,11 @@ void ViewProviderPath::recomputeBoundingBox()
     Path::Feature* pcPathObj = static_cast<Path::Feature*>(pcObject);
     Base::Placement pl = *(&pcPathObj->Placement.getValue());
     Base::Vector3d pt;
-    for (int i=1;i<pcLineCoords->point.getNum();i++) {
-        pt.x = pcLineCoords->point[i].getValue()[0];
-        pt.y = pcLineCoords->point[i].getValue()[1];
-        pt.z = pcLineCoords->point[i].getValue()[2];
+    const std::vector<float> &points = polyline.points;
+    for (std::size_t i=3;i+2<points.size();i+=3) {
+        pt.x = points[i];
+        pt.y = points[i+1];
+        pt.z = points[i+2];
         pl.multVec(pt,pt);
         if (pt.x < MinX)  MinX = pt.x;
         if (pt.y < MinY)  MinY = pt.y;
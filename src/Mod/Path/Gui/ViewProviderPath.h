@@ -28,6 +28,7 @@
 #include <Gui/ViewProviderGeometryObject.h>
 #include <Gui/ViewProviderPythonFeature.h>
 #include <Mod/Part/Gui/SoBrepEdgeSet.h>
+#include <Mod/Path/App/PathPolyline.h>
 
 
 class SoCoordinate3;
@@ -99,14 +100,15 @@ protected:
     SoMaterial            * pcLineColor;
     SoBaseColor           * pcMarkerColor;
     SoMaterialBinding     * pcMatBind;
-    std::vector<int>        colorindex;
     SoSwitch              * pcMarkerSwitch;
     SoSwitch              * pcArrowSwitch;
     SoTransform           * pcArrowTransform;
 
-    std::vector<int>   command2Edge;
-    std::deque<int>   edge2Command;
-    std::deque<int>   edgeIndices;
+    // the segmented toolpath shown in pcLineCoords, it is kept until the toolpath
+    // or the start position changes, other changes only select a range of it
+    Path::PathPolyline polyline;
+    std::uint64_t polylineRevision;
+    Base::Vector3d polylineStart;
 
     mutable int pt0Index;
     bool blockPropertyChange;
@@ -26,6 +26,7 @@ import Path
 import Path.Op.Base as PathOp
 import Path.Op.EngraveBase as PathEngraveBase
 import PathScripts.PathUtils as PathUtils
+import array
 import math
 from PySide.QtCore import QT_TRANSLATE_NOOP
 
@@ -53,62 +54,15 @@ translate = FreeCAD.Qt.translate
 _sorting = "global"
 
 
-def _collectVoronoiWires(vd):
-    edges = [e for e in vd.Edges if e.Color == PRIMARY]
-    vertex = {}
-    for e in edges:
-        for v in e.Vertices:
-            i = v.Index
-            j = vertex.get(i, [])
-            j.append(e)
-            vertex[i] = j
-
-    # knots are the start and end points of a wire
-    knots = [i for i in vertex if len(vertex[i]) == 1]
-    knots.extend([i for i in vertex if len(vertex[i]) > 2])
-    if len(knots) == 0:
-        for i in vertex:
-            if len(vertex[i]) > 0:
-                knots.append(i)
-                break
-
-    def consume(v, edge):
-        vertex[v] = [e for e in vertex[v] if e.Index != edge.Index]
-        return len(vertex[v]) == 0
-
-    def traverse(vStart, edge, edges):
-        if vStart == edge.Vertices[0].Index:
-            vEnd = edge.Vertices[1].Index
-            edges.append(edge)
-        else:
-            vEnd = edge.Vertices[0].Index
-            edges.append(edge.Twin)
-
-        consume(vStart, edge)
-        if consume(vEnd, edge):
-            return None
-        return vEnd
-
+def _collectVoronoiWires(vd, deflection):
+    """Returns the medial axis as wires, each a list of (x, y, distance) tuples."""
+    axis = vd.getMedialAxis(PRIMARY, deflection)
+    points = array.array("d", axis["Points"])
     wires = []
-    while knots:
-        we = []
-        vFirst = knots[0]
-        vStart = vFirst
-        vLast = vFirst
-        if len(vertex[vStart]):
-            while vStart is not None:
-                vLast = vStart
-                edges = vertex[vStart]
-                if len(edges) > 0:
-                    edge = edges[0]
-                    vStart = traverse(vStart, edge, we)
-                else:
-                    vStart = None
-            wires.append(we)
-        if len(vertex[vFirst]) == 0:
-            knots = [v for v in knots if v != vFirst]
-        if len(vertex[vLast]) == 0:
-            knots = [v for v in knots if v != vLast]
+    begin = 0
+    for end in array.array("i", axis["WireIndices"]):
+        wires.append([tuple(points[3 * i : 3 * i + 3]) for i in range(begin, end)])
+        begin = end
     return wires
 
 
@@ -126,8 +80,8 @@ def _sortVoronoiWires(wires, start=FreeCAD.Vector(0, 0, 0)):
     end = {}
 
     for i, w in enumerate(wires):
-        begin[i] = w[0].Vertices[0].toPoint()
-        end[i] = w[-1].Vertices[1].toPoint()
+        begin[i] = FreeCAD.Vector(w[0][0], w[0][1], 0)
+        end[i] = FreeCAD.Vector(w[-1][0], w[-1][1], 0)
 
     result = []
     while begin:
@@ -139,7 +93,7 @@ def _sortVoronoiWires(wires, start=FreeCAD.Vector(0, 0, 0)):
             del begin[bIdx]
             del end[bIdx]
         else:
-            result.append([e.Twin for e in reversed(wires[eIdx])])
+            result.append(list(reversed(wires[eIdx])))
             start = begin[eIdx]
             del begin[eIdx]
             del end[eIdx]
@@ -183,11 +137,8 @@ def _calculate_depth(MIC, geom):
     return max(depth, geom.stop)
 
 
-def _getPartEdge(edge, depths):
-    dist = edge.getDistances()
-    zBegin = _calculate_depth(dist[0], depths)
-    zEnd = _calculate_depth(dist[1], depths)
-    return edge.toShape(zBegin, zEnd)
+def _getWirePoints(wire, depths):
+    return [FreeCAD.Vector(x, y, _calculate_depth(d, depths)) for (x, y, d) in wire]
 
 
 class ObjectVcarve(PathEngraveBase.ObjectOp):
@@ -250,12 +201,6 @@ class ObjectVcarve(PathEngraveBase.ObjectOp):
         # upgrade ...
         self.setupAdditionalProperties(obj)
 
-    def _getPartEdges(self, obj, vWire, geom):
-        edges = []
-        for e in vWire:
-            edges.append(_getPartEdge(e, geom))
-        return edges
-
     def buildPathMedial(self, obj, faces):
         """constructs a medial axis path using openvoronoi"""
 
@@ -269,11 +214,10 @@ class ObjectVcarve(PathEngraveBase.ObjectOp):
                 for i in range(len(pts)):
                     vd.addSegment(ptv[i], ptv[i + 1])
 
-        def cutWire(edges):
+        def cutWire(points):
             path = []
             path.append(Path.Command("G0 Z{}".format(obj.SafeHeight.Value)))
-            e = edges[0]
-            p = e.valueAt(e.FirstParameter)
+            p = points[0]
             path.append(
                 Path.Command("G0 X{} Y{} Z{}".format(p.x, p.y, obj.SafeHeight.Value))
             )
@@ -282,8 +226,11 @@ class ObjectVcarve(PathEngraveBase.ObjectOp):
             path.append(
                 Path.Command("G1 X{} Y{} Z{} F{}".format(p.x, p.y, p.z, vSpeed))
             )
-            for e in edges:
-                path.extend(Path.Geom.cmdsForEdge(e, hSpeed=hSpeed, vSpeed=vSpeed))
+            for p0, p1 in zip(points, points[1:]):
+                params = {"X": p1.x, "Y": p1.y, "Z": p1.z}
+                if hSpeed > 0 and vSpeed > 0:
+                    params["F"] = Path.Geom.speedBetweenPoints(p0, p1, hSpeed, vSpeed)
+                path.append(Path.Command("G1", params))
 
             return path
 
@@ -294,25 +241,13 @@ class ObjectVcarve(PathEngraveBase.ObjectOp):
 
             vd.construct()
 
-            for e in vd.Edges:
-                if e.isPrimary():
-                    if e.isBorderline():
-                        e.Color = BORDERLINE
-                    else:
-                        e.Color = PRIMARY
-                else:
-                    e.Color = SECONDARY
+            vd.colorEdges(PRIMARY, SECONDARY, BORDERLINE)
             vd.colorExterior(EXTERIOR1)
-            vd.colorExterior(
-                EXTERIOR2,
-                lambda v: not f.isInside(
-                    v.toPoint(f.BoundBox.ZMin), obj.Tolerance, True
-                ),
-            )
+            vd.colorOutside(EXTERIOR2, obj.Tolerance)
             vd.colorColinear(COLINEAR, obj.Colinear)
             vd.colorTwins(TWIN)
 
-            wires = _collectVoronoiWires(vd)
+            wires = _collectVoronoiWires(vd, obj.Discretize)
             if _sorting != "global":
                 wires = _sortVoronoiWires(wires)
             voronoiWires.extend(wires)
@@ -325,10 +260,9 @@ class ObjectVcarve(PathEngraveBase.ObjectOp):
         pathlist = []
         pathlist.append(Path.Command("(starting)"))
         for w in voronoiWires:
-            pWire = self._getPartEdges(obj, w, geom)
-            if pWire:
-                wires.append(pWire)
-                pathlist.extend(cutWire(pWire))
+            points = _getWirePoints(w, geom)
+            if points:
+                pathlist.extend(cutWire(points))
         self.commandlist = pathlist
 
     def opExecute(self, obj):
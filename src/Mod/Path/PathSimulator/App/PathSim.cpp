@@ -22,12 +22,102 @@
 
 #include "PreCompiled.h"
 
+#include <Mod/Path/App/PathSegmentWalker.h>
+
 #include "PathSim.h"
 
 
 using namespace Base;
 using namespace PathSimulator;
 
+namespace {
+
+/* Collects the moves of a toolpath as straight segments and sums up the
+   machining time from the programmed feed rates */
+class SimSegmentVisitor : public PathSegmentVisitor
+{
+public:
+	SimSegmentVisitor(const Toolpath & tp, double rapidRate)
+		: cycleTime(0), tp(tp), rapidRate(rapidRate), feedRate(0)
+	{}
+
+	void setup(const Vector3d & last) override
+	{
+		end = last;
+	}
+
+	void g0(int id, const Vector3d & last, const Vector3d & next, const std::deque<Vector3d> & pts) override
+	{
+		addMoves(id, last, pts, next, true);
+	}
+
+	void g1(int id, const Vector3d & last, const Vector3d & next, const std::deque<Vector3d> & pts) override
+	{
+		updateFeed(id);
+		addMoves(id, last, pts, next, false);
+	}
+
+	void g23(int id, const Vector3d & last, const Vector3d & next, const std::deque<Vector3d> & pts,
+	         const Vector3d & center) override
+	{
+		(void)center;
+		updateFeed(id);
+		addMoves(id, last, pts, next, false);
+	}
+
+	void g8x(int id, const Vector3d & last, const Vector3d & next, const std::deque<Vector3d> & pts,
+	         const std::deque<Vector3d> & p, const std::deque<Vector3d> & q) override
+	{
+		(void)q; // the pecks do not go deeper than the final depth
+		updateFeed(id);
+		addMoves(id, last, pts, p[0], true);
+		addMove(id, p[0], p[1], true);
+		addMove(id, p[1], next, false);
+		addMove(id, next, p[2], true);
+	}
+
+	void g38(int id, const Vector3d & last, const Vector3d & next) override
+	{
+		updateFeed(id);
+		addMove(id, last, next, false);
+	}
+
+	std::vector<cSimMove> moves;
+	Vector3d end;
+	double cycleTime;
+
+private:
+	void updateFeed(int id)
+	{
+		feedRate = tp.getValue(id, "F", feedRate);
+	}
+
+	void addMoves(int id, const Vector3d & last, const std::deque<Vector3d> & pts, const Vector3d & next, bool rapid)
+	{
+		Vector3d from = last;
+		for (const Vector3d & pt : pts) {
+			addMove(id, from, pt, rapid);
+			from = pt;
+		}
+		addMove(id, from, next, rapid);
+	}
+
+	void addMove(int id, const Vector3d & from, const Vector3d & to, bool rapid)
+	{
+		double rate = rapid ? rapidRate : feedRate;
+		if (rate > 0)
+			cycleTime += (to - from).Length() / rate;
+		moves.emplace_back(Point3D(from.x, from.y, from.z), Point3D(to.x, to.y, to.z), id, rapid);
+		end = to;
+	}
+
+	const Toolpath & tp;
+	double rapidRate;
+	double feedRate;
+};
+
+}
+
 TYPESYSTEM_SOURCE(PathSimulator::PathSim , Base::BaseClass);
 
 PathSim::PathSim()
@@ -80,6 +170,27 @@ Base::Placement * PathSim::ApplyCommand(Base::Placement * pos, Command * cmd)
 	return plc;
 }
 
+Base::Placement * PathSim::ApplyToolpath(Base::Placement * pos, const Toolpath & path, SimulationReport & report,
+                                         double rapidRate, int threads)
+{
+	if (!m_stock)
+		throw Base::RuntimeError("Path Simulation: No stock, BeginSimulation has to be called first");
+	if (!m_tool)
+		throw Base::RuntimeError("Path Simulation: No tool, SetToolShape has to be called first");
+
+	SimSegmentVisitor visitor(path, rapidRate);
+	PathSegmentWalker walker(path);
+	walker.walk(visitor, pos->getPosition());
+
+	report.gouges.clear();
+	report.removedVolume = m_stock->ApplyMoves(visitor.moves, *m_tool, report.gouges, threads);
+	report.cycleTime = visitor.cycleTime;
+
+	Base::Placement *plc = new Base::Placement();
+	plc->setPosition(visitor.end);
+	return plc;
+}
+
 
 
 
@@ -24,9 +24,11 @@
 #define PATHSIMULATOR_PathSim_H
 
 #include <memory>
+#include <vector>
 #include <TopoDS_Shape.hxx>
 
 #include <Mod/Path/App/Command.h>
+#include <Mod/Path/App/Path.h>
 #include <Mod/Part/App/TopoShape.h>
 
 #include "VolSim.h"
@@ -37,6 +39,14 @@ using namespace Path;
 namespace PathSimulator
 {
 
+    /** The outcome of simulating a whole toolpath */
+    struct SimulationReport
+    {
+        double removedVolume = 0.0;
+        double cycleTime = 0.0;     // seconds, rapid moves only count if a rapid rate is given
+        std::vector<int> gouges;    // indices of the rapid moves cutting into the stock
+    };
+
     /** The representation of a CNC Toolpath Simulator */
 
 	class PathSimulatorExport PathSim : public Base::BaseClass
@@ -50,6 +60,8 @@ namespace PathSimulator
 			void BeginSimulation(Part::TopoShape * stock, float resolution);
 			void SetToolShape(const TopoDS_Shape& toolShape, float resolution);
 			Base::Placement * ApplyCommand(Base::Placement * pos, Command * cmd);
+			Base::Placement * ApplyToolpath(Base::Placement * pos, const Toolpath & path, SimulationReport & report,
+			                                double rapidRate = 0.0, int threads = 0);
 
 		public:
 			std::unique_ptr<cStock> m_stock;
@@ -26,6 +26,7 @@
 
 #include <Mod/Mesh/App/MeshPy.h>
 #include <Mod/Path/App/CommandPy.h>
+#include <Mod/Path/App/PathPy.h>
 #include <Mod/Part/App/TopoShapePy.h>
 
 #include "PathSim.h"
@@ -122,6 +123,35 @@ PyObject* PathSimPy::ApplyCommand(PyObject * args, PyObject * kwds)
 	return newposPy;
 }
 
+PyObject* PathSimPy::ApplyToolpath(PyObject * args, PyObject * kwds)
+{
+	static char *kwlist[] = { "position", "path", "rapid", "threads", nullptr };
+	PyObject *pObjPlace;
+	PyObject *pObjPath;
+	double rapid = 0;
+	int threads = 0;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O!|di", kwlist, &(Base::PlacementPy::Type), &pObjPlace,
+	                                 &(Path::PathPy::Type), &pObjPath, &rapid, &threads))
+		return nullptr;
+	PY_TRY {
+		PathSim *sim = getPathSimPtr();
+		Base::Placement *pos = static_cast<Base::PlacementPy*>(pObjPlace)->getPlacementPtr();
+		Path::Toolpath *path = static_cast<Path::PathPy*>(pObjPath)->getToolpathPtr();
+		SimulationReport report;
+		Base::Placement *newpos = sim->ApplyToolpath(pos, *path, report, rapid, threads);
+
+		Py::Dict dict;
+		dict.setItem("Placement", Py::asObject(new Base::PlacementPy(newpos)));
+		dict.setItem("RemovedVolume", Py::Float(report.removedVolume));
+		dict.setItem("CycleTime", Py::Float(report.cycleTime));
+		Py::List gouges;
+		for (int id : report.gouges)
+			gouges.append(Py::Long(id));
+		dict.setItem("Gouges", gouges);
+		return Py::new_reference_to(dict);
+	} PY_CATCH
+}
+
 Py::Object PathSimPy::getTool() const
 {
     //return Py::Object();
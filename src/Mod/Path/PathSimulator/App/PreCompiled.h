@@ -50,6 +50,7 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <sstream>
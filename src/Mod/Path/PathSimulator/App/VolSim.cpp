@@ -23,6 +23,9 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <set>
 #endif
 
 #include <BRepBndLib.hxx>
@@ -30,6 +33,8 @@
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <gp_Pnt.hxx>
 
+#include <Base/Parallel.h>
+
 #include "VolSim.h"
 
 
@@ -666,6 +671,190 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 	}
 }
 
+// Applies all moves in order and returns the removed stock volume. Each dexel only depends on the
+// moves passing over it, so the columns of the stock are split among the threads, every thread
+// walking all moves but only lowering the dexels of its own columns. The indices of the rapid
+// moves that cut into the stock are returned in rapidCuts.
+double cStock::ApplyMoves(const std::vector<cSimMove> & moves, cSimTool & tool, std::vector<int> & rapidCuts, int threads)
+{
+	// tool profile by distance from the tool axis in SIM_PROFILE_STEPS steps per dexel
+	float rad = tool.radius / m_res;
+	std::vector<float> profile((int)(rad * SIM_PROFILE_STEPS) + 2);
+	for (std::size_t i = 0; i < profile.size(); i++)
+		profile[i] = tool.GetToolProfileAt(std::min(1.0f, i / (rad * SIM_PROFILE_STEPS)));
+	bool flatTool = tool.IsFlat();
+
+	std::vector<double> removed(m_x, 0.0);
+	std::set<int> cuts;
+	std::mutex cutsMutex;
+
+	Base::parallel_for(m_x, threads, [&](std::size_t first, std::size_t last) {
+		int xs = (int)first;
+		int xe = (int)last;
+		std::vector<int> localCuts;
+		for (int x = xs; x < xe; x++)
+			removed[x] = GetColumnVolume(x);
+		for (const cSimMove & move : moves)
+		{
+			if (ApplyMove(move, profile, rad, flatTool, xs, xe) && move.rapid)
+				localCuts.push_back(move.id);
+		}
+		for (int x = xs; x < xe; x++)
+			removed[x] -= GetColumnVolume(x);
+		std::lock_guard<std::mutex> lock(cutsMutex);
+		cuts.insert(localCuts.begin(), localCuts.end());
+	});
+
+	rapidCuts.assign(cuts.begin(), cuts.end());
+	double volume = 0;
+	for (double v : removed)
+		volume += v;
+	return volume * m_res * m_res;
+}
+
+// Lowers the dexels of columns xs..xe-1 touched by the tool moving along a straight line.
+// Instead of walking along the path, every dexel within the tool radius of the line is visited
+// once and gets the lowest tool height over it. Returns true if any material was removed.
+bool cStock::ApplyMove(const cSimMove & move, const std::vector<float> & profile, float rad, bool flatTool, int xs, int xe)
+{
+	Point3D p1 = move.p1;
+	Point3D p2 = move.p2;
+	Point3D a = ToInner(p1);
+	Point3D b = ToInner(p2);
+	float rad2 = rad * rad;
+	float dx = b.x - a.x;
+	float dy = b.y - a.y;
+	float dz = b.z - a.z;
+	float len2 = dx * dx + dy * dy;
+	float len = sqrt(len2);
+	float invLen2 = len2 < SIM_EPSILON ? 0 : 1 / len2;
+
+	int x1 = std::max(xs, (int)floor(std::min(a.x, b.x) - rad));
+	int x2 = std::min(xe, (int)ceil(std::max(a.x, b.x) + rad) + 1);
+	if (x1 >= x2 || std::min(a.z, b.z) >= m_plane)
+		return false;
+
+	auto profileAt = [&](float d2) {
+		return profile[(int)ceil(sqrt(d2) * SIM_PROFILE_STEPS)];
+	};
+	// height of the tool over the dexel at offset (cx,cy) from the start, at parameter s of the move
+	auto heightAt = [&](float s, float cx, float cy) {
+		float px = cx - s * dx;
+		float py = cy - s * dy;
+		return a.z + s * dz + profileAt(std::min(px * px + py * py, rad2));
+	};
+
+	bool cut = false;
+	for (int x = x1; x < x2; x++)
+	{
+		float cx = x + 0.5f - a.x;
+
+		// the dexels of this column the tool can reach
+		float ya = a.y;
+		float yb = b.y;
+		if (fabs(dx) > SIM_EPSILON)
+		{
+			float sa = (cx - rad) / dx;
+			float sb = (cx + rad) / dx;
+			if (sa > sb)
+				std::swap(sa, sb);
+			sa = std::max(sa, 0.0f);
+			sb = std::min(sb, 1.0f);
+			if (sa > sb)
+				continue;
+			ya = a.y + sa * dy;
+			yb = a.y + sb * dy;
+		}
+		int y1 = std::max(0, (int)floor(std::min(ya, yb) - rad));
+		int y2 = std::min(m_y, (int)ceil(std::max(ya, yb) + rad) + 1);
+
+		float *column = m_stock[x];
+		for (int y = y1; y < y2; y++)
+		{
+			float cy = y + 0.5f - a.y;
+			float z;
+			if (len2 < SIM_EPSILON)
+			{
+				// plunge or retract
+				float d2 = cx * cx + cy * cy;
+				if (d2 > rad2)
+					continue;
+				z = std::min(a.z, b.z) + profileAt(d2);
+			}
+			else
+			{
+				// the range s0..s1 of the move in which the dexel is under the tool
+				float u = (cx * dx + cy * dy) * invLen2;
+				float e2 = cx * cx + cy * cy - u * u * len2;
+				if (e2 > rad2)
+					continue;
+				float half = sqrt((rad2 - std::max(e2, 0.0f)) * invLen2);
+				float s0 = std::max(0.0f, u - half);
+				float s1 = std::min(1.0f, u + half);
+				if (s0 > s1)
+					continue;
+				// lowest possible height of the tool, which is its height if it is flat
+				z = a.z + std::min(s0 * dz, s1 * dz) + profile[0];
+				if (column[y] <= z)
+					continue;
+				if (!flatTool)
+				{
+					// The profile grows with the radius, so on a level move the lowest point is the
+					// closest one. Otherwise the height along the move is convex for the usual
+					// convex cutters and its minimum is found by a golden section search.
+					z = heightAt(std::min(std::max(u, s0), s1), cx, cy);
+					if (fabs(dz) > SIM_EPSILON && column[y] > z - fabs(dz) * (s1 - s0))
+					{
+						const float g = 0.618034f;
+						float lo = s0;
+						float hi = s1;
+						float m1 = hi - g * (hi - lo);
+						float m2 = lo + g * (hi - lo);
+						float f1 = heightAt(m1, cx, cy);
+						float f2 = heightAt(m2, cx, cy);
+						while ((hi - lo) * len > SIM_WALK_RES)
+						{
+							if (f1 < f2)
+							{
+								hi = m2;
+								m2 = m1;
+								f2 = f1;
+								m1 = hi - g * (hi - lo);
+								f1 = heightAt(m1, cx, cy);
+							}
+							else
+							{
+								lo = m1;
+								m1 = m2;
+								f1 = f2;
+								m2 = lo + g * (hi - lo);
+								f2 = heightAt(m2, cx, cy);
+							}
+						}
+						z = std::min({z, f1, f2, heightAt(s0, cx, cy), heightAt(s1, cx, cy)});
+					}
+				}
+			}
+			if (column[y] > z)
+			{
+				if (column[y] - z > SIM_EPSILON && column[y] > m_pz)
+					cut = true;
+				column[y] = z;
+			}
+		}
+	}
+	return cut;
+}
+
+double cStock::GetColumnVolume(int x)
+{
+	double volume = 0;
+	float *column = m_stock[x];
+	for (int y = 0; y < m_y; y++)
+		volume += std::max(column[y], m_pz) - m_pz;
+	return volume;
+}
+
 
 //************************************************************************************************************
 // Line Segment
@@ -790,6 +979,16 @@ float cSimTool::GetToolProfileAt(float pos)  // pos is -1..1 location along the
     return it != m_toolShape.end() ? it->heightPos : 0.0f;
 }
 
+bool cSimTool::IsFlat()
+{
+	for (const toolShapePoint & point : m_toolShape)
+	{
+		if (fabs(point.heightPos - m_toolShape.front().heightPos) > SIM_EPSILON)
+			return false;
+	}
+	return true;
+}
+
 bool cSimTool::isInside(const TopoDS_Shape& toolShape, Base::Vector3d pnt, float res)
 {
     bool checkFace = true;
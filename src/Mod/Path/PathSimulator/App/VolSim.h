@@ -35,6 +35,7 @@
 #define SIM_TESSEL_TOP		1
 #define SIM_TESSEL_BOT		2
 #define SIM_WALK_RES		0.6   // step size in pixel units (to make sure all pixels in the path are visited)
+#define SIM_PROFILE_STEPS	8     // tool profile samples per pixel
 
 struct toolShapePoint {
   float radiusPos;
@@ -85,6 +86,16 @@ struct Triangle3D
 	Point3D points[3];
 };
 
+/* a straight move of the tool, arcs and drilling cycles are split into several moves */
+struct cSimMove
+{
+	cSimMove(const Point3D & p1, const Point3D & p2, int id, bool rapid) : p1(p1), p2(p2), id(id), rapid(rapid) {}
+	Point3D p1;
+	Point3D p2;
+	int id;		// index of the command in the toolpath
+	bool rapid;
+};
+
 struct cLineSegment
 {
 	cLineSegment() : len(0), lenXY(0) {}
@@ -105,6 +116,7 @@ public:
 	~cSimTool() {}
 
 	float GetToolProfileAt(float pos);
+	bool IsFlat();
 	bool isInside(const TopoDS_Shape& toolShape, Base::Vector3d pnt, float res);
 
 /* m_toolShape has to be populated with linearly increased
@@ -148,11 +160,14 @@ public:
     void CreatePocket(float x, float y, float rad, float height);
     void ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool &tool);
     void ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool, bool isCCW);
+    double ApplyMoves(const std::vector<cSimMove> & moves, cSimTool & tool, std::vector<int> & rapidCuts, int threads = 0);
     inline Point3D ToInner(Point3D & p) {
 		return Point3D((p.x - m_px) / m_res, (p.y - m_py) / m_res, p.z);
 	}
 
 private:
+	bool ApplyMove(const cSimMove & move, const std::vector<float> & profile, float rad, bool flatTool, int xs, int xe);
+	double GetColumnVolume(int x);
 	float FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
 	void FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
 	void SetFacetPoints(MeshCore::MeshGeomFacet & facet, Point3D & p1, Point3D & p2, Point3D & p3);
@@ -24,6 +24,7 @@
 
 import FreeCAD
 import Part
+import area
 import Path.Op.Adaptive as PathAdaptive
 import Path.Main.Job as PathJob
 from PathTests.PathTestUtils import PathTestBase
@@ -414,6 +415,28 @@ class TestPathAdaptive(PathTestBase):
                 break
         self.assertTrue(isInBox, "No paths originating within the inner hole.")
 
+    def test08(self):
+        """test08() Verify separate regions give the same paths with any number of threads."""
+
+        stock, pockets = _pocketGrid(3, 2)
+        outputs = []
+        for threads in [1, 4]:
+            a2d = _adaptive2d(threads)
+            outputs.append(_adaptiveOutput(a2d.Execute(stock, pockets, lambda tpaths: False)))
+
+        self.assertEqual(len(outputs[0]), 6)
+        self.assertEqual(outputs[0], outputs[1])
+
+    def test09(self):
+        """test09() Verify an error in the progress callback is raised by Execute."""
+
+        def progressFn(tpaths):
+            raise ValueError("stop")
+
+        stock, pockets = _pocketGrid(3, 2)
+        a2d = _adaptive2d(4)
+        self.assertRaises(ValueError, a2d.Execute, stock, pockets, progressFn)
+
 
 # Eclass
 
@@ -552,3 +575,40 @@ G1 X17.5 Y20.0 Z5.0;  \
 G1 X32.5 Y20.0 Z5.0;  \
 G1 X32.5 Y17.5 Z5.0;  \
 G1 X17.5 Y17.5 Z5.0"
+
+
+def _pocketGrid(columns, rows, size=20.0, gap=10.0):
+    """Returns the stock outline and a grid of square pockets as 2D paths."""
+    pockets = []
+    for i in range(columns):
+        for j in range(rows):
+            x = gap + i * (size + gap)
+            y = gap + j * (size + gap)
+            pockets.append([(x, y), (x + size, y), (x + size, y + size), (x, y + size)])
+    w = gap + columns * (size + gap)
+    h = gap + rows * (size + gap)
+    return [[(0.0, 0.0), (w, 0.0), (w, h), (0.0, h)]], pockets
+
+
+def _adaptive2d(threads):
+    a2d = area.Adaptive2d()
+    a2d.opType = area.AdaptiveOperationType.ClearingInside
+    a2d.toolDiameter = 6.0
+    a2d.stepOverFactor = 0.2
+    a2d.tolerance = 0.1
+    a2d.finishingProfile = False
+    a2d.threads = threads
+    return a2d
+
+
+def _adaptiveOutput(results):
+    return [
+        (
+            r.HelixCenterPoint,
+            r.StartPoint,
+            [(int(p[0]), p[1]) for p in r.AdaptivePaths],
+            int(r.ReturnMotionType),
+        )
+        for r in results
+    ]
+
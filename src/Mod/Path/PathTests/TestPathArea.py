@@ -0,0 +1,117 @@
+# -*- coding: utf-8 -*-
+# ***************************************************************************
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+# *   as published by the Free Software Foundation; either version 2 of     *
+# *   the License, or (at your option) any later version.                   *
+# *   for detail see the LICENCE text file.                                 *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU Library General Public License for more details.                  *
+# *                                                                         *
+# *   You should have received a copy of the GNU Library General Public     *
+# *   License along with this program; if not, write to the Free Software   *
+# *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+# *   USA                                                                   *
+# *                                                                         *
+# ***************************************************************************
+
+import math
+import FreeCAD
+import Part
+import Path
+from PathTests.PathTestUtils import PathTestBase
+
+
+def steppedPart():
+    """A 10x10x10 block with a 4x4x4 boss on top and a hole of radius 1 through both."""
+    base = Part.makeBox(10, 10, 10)
+    boss = Part.makeBox(4, 4, 4, FreeCAD.Vector(3, 3, 10))
+    hole = Part.makeCylinder(1, 20, FreeCAD.Vector(5, 5, -1))
+    return base.fuse(boss).cut(hole).removeSplitter()
+
+
+class TestPathArea(PathTestBase):
+    """Unit tests for the sections of Path.Area."""
+
+    heights = [0.5 + i for i in range(14)]
+
+    def makeSections(self, threads):
+        area = Path.Area()
+        area.add(steppedPart())
+        area.setParams(SectionThreads=threads)
+        return area.makeSections(mode=0, project=False, heights=self.heights)
+
+    def sectionLength(self, section):
+        return sum(e.Length for e in section.getShape().Edges)
+
+    def test00(self):
+        """Check each section matches the part at its height."""
+        sections = self.makeSections(0)
+        self.assertEqual(len(sections), len(self.heights))
+        hole = 2 * math.pi
+        for z, section in zip(self.heights, sections):
+            shape = section.getShape()
+            self.assertRoughly(shape.BoundBox.ZMin, z)
+            self.assertRoughly(shape.BoundBox.ZMax, z)
+            expected = (40 if z < 10 else 16) + hole
+            self.assertRoughly(self.sectionLength(section), expected)
+
+    def test01(self):
+        """Check the sections computed in parallel match the serial ones."""
+        serial = self.makeSections(1)
+        for threads in (2, 4, 0):
+            batched = self.makeSections(threads)
+            self.assertEqual(len(batched), len(serial))
+            for a, b in zip(serial, batched):
+                sa = a.getShape()
+                sb = b.getShape()
+                self.assertRoughly(sa.BoundBox.ZMin, sb.BoundBox.ZMin)
+                self.assertEqual(len(sa.Edges), len(sb.Edges))
+                self.assertRoughly(self.sectionLength(a), self.sectionLength(b))
+
+    def test02(self):
+        """Check empty sections are dropped without disturbing the order."""
+        area = Path.Area()
+        area.add(Part.makeBox(10, 10, 4))
+        area.add(Part.makeBox(10, 10, 4, FreeCAD.Vector(0, 0, 6)))
+        area.setParams(SectionThreads=4)
+        heights = [1.0, 5.0, 7.0, 3.0]
+        sections = area.makeSections(mode=0, project=False, heights=heights)
+        self.assertEqual(len(sections), 3)
+        zs = [s.getShape().BoundBox.ZMin for s in sections]
+        for z, expected in zip(zs, [1.0, 7.0, 3.0]):
+            self.assertRoughly(z, expected)
+
+    def makeOffset(self, threads, **kwargs):
+        area = Path.Area()
+        area.add(Part.Face(Part.makePolygon([
+            FreeCAD.Vector(0, 0), FreeCAD.Vector(20, 0),
+            FreeCAD.Vector(20, 20), FreeCAD.Vector(0, 20), FreeCAD.Vector(0, 0)])))
+        area.setParams(OffsetThreads=threads)
+        return sorted((w.Length for w in area.makeOffset(**kwargs).Wires), reverse=True)
+
+    def test10(self):
+        """Check each offset pass of a square is computed with its own offset."""
+        lengths = self.makeOffset(4, offset=-0.5, extra_pass=5, stepover=1.0)
+        self.assertEqual(len(lengths), 6)
+        for k, length in enumerate(lengths):
+            self.assertRoughly(length, 4 * (20 - 2 * (0.5 + k)))
+
+    def test11(self):
+        """Check the offset passes computed in batches match the serial ones."""
+        for kwargs in [
+            dict(offset=-0.5, extra_pass=5, stepover=1.0),
+            dict(offset=-0.5, extra_pass=-1, stepover=-1.0),
+        ]:
+            serial = self.makeOffset(1, **kwargs)
+            self.assertTrue(len(serial) > 1)
+            for threads in (2, 3, 0):
+                batched = self.makeOffset(threads, **kwargs)
+                self.assertEqual(len(batched), len(serial))
+                for a, b in zip(serial, batched):
+                    self.assertRoughly(a, b)
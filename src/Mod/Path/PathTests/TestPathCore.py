@@ -20,6 +20,7 @@
 # *                                                                         *
 # ***************************************************************************
 
+import array
 import FreeCAD
 import Path
 from PathTests.PathTestUtils import PathTestBase
@@ -130,6 +131,83 @@ G0 Z0.500000
         p.setFromGCode(lines)
         self.assertEqual(p.toGCode(), output)
 
+    def test20(self):
+        """Test Path insertion and deletion of commands"""
+
+        p = Path.Path()
+        p.addCommands(Path.Command("G0", {"X": 1, "Y": 2, "Z": 3}))
+        p.addCommands(Path.Command("G2", {"X": 3, "Y": 2, "I": 1, "J": 0}))
+        p.addCommands(Path.Command("M3", {"S": 12000}))
+
+        # insert a command which uses words the path has not seen before
+        p.insertCommand(Path.Command("G1", {"A": 90, "Q": 0.5, "Z": -1}), 1)
+        p.insertCommand(Path.Command("G90"), 0)
+        self.assertEqual(
+            p.toGCode(),
+            "G90\n"
+            "G0 X1.000000 Y2.000000 Z3.000000\n"
+            "G1 A90.000000 Q0.500000 Z-1.000000\n"
+            "G2 I1.000000 J0.000000 X3.000000 Y2.000000\n"
+            "M3 S12000.000000\n",
+        )
+        self.assertEqual(p.Commands[2].Parameters, {"A": 90, "Q": 0.5, "Z": -1})
+
+        p.deleteCommand(2)
+        p.deleteCommand()
+        self.assertEqual(
+            p.toGCode(),
+            "G90\n"
+            "G0 X1.000000 Y2.000000 Z3.000000\n"
+            "G2 I1.000000 J0.000000 X3.000000 Y2.000000\n",
+        )
+        self.assertEqual(p.Commands[2].Parameters, {"I": 1, "J": 0, "X": 3, "Y": 2})
+
+        # a copy of the path keeps all words
+        q = Path.Path(p.toGCode())
+        self.assertEqual(q.toGCode(), p.toGCode())
+        self.assertEqual(q.Size, 3)
+
+    def test30(self):
+        """Test Path GCode parsing of units, comments and line numbers"""
+
+        lines = """
+(Program start)
+N10 G20
+N20 G0 X1 Y-.5 z0.25
+N30 g1 x2 F10 (feed in inches)
+N40 G21
+N50 G1 X2 Q1.5 S1000
+M5
+"""
+        p = Path.Path()
+        p.setFromGCode(lines)
+        self.assertEqual(p.Size, 6)
+        self.assertEqual(
+            p.toGCode(),
+            "(Program start)\n"
+            "G0 X25.400000 Y-12.700000 Z6.350000\n"
+            "G1 F254.000000 X50.800000\n"
+            "(feed in inches)\n"
+            "G1 Q1.500000 S1000.000000 X2.000000\n"
+            "M5\n",
+        )
+        # line numbers are kept with the preceding command but not written
+        self.assertEqual(p.Commands[1].Parameters["N"], 30)
+
+    def test31(self):
+        """Test Path GCode parsing of large programs with long comments"""
+
+        # programs larger than 1 MB are read in blocks, none of them may start
+        # inside a comment even if it contains commands
+        comment = "(" + " ".join(["G0 X9 M3"] * 150) + ")"
+        count = 3000
+        p = Path.Path()
+        p.setFromGCode("G1 X1 {}\n".format(comment) * count)
+        self.assertEqual(p.Size, 2 * count)
+        names = [c.Name for c in p.Commands]
+        self.assertEqual(names.count("G1"), count)
+        self.assertEqual(names.count(comment), count)
+
     def test50(self):
         """Test Path.Length calculation"""
         commands = []
@@ -138,3 +216,46 @@ G0 Z0.500000
         path = Path.Path(commands)
 
         self.assertEqual(path.Length, 2)
+
+    def test60(self):
+        """Test Path polyline segmentation"""
+        p = Path.Path(
+            [
+                Path.Command("G0", {"X": 1, "Y": 0, "Z": 5}),
+                Path.Command("G1", {"Z": 0}),
+                Path.Command("M3", {"S": 1000}),
+                Path.Command("G2", {"X": 3, "Y": 0, "I": 1, "J": 0}),
+                Path.Command("G38.2", {"Z": -1}),
+            ]
+        )
+        polyline = p.getPolyline(FreeCAD.Vector(0, 0, 10))
+        points = array.array("f", polyline["Points"])
+        edges = array.array("i", polyline["EdgeIndices"])
+        colors = polyline["Colors"]
+
+        # one edge per move, each ends at the end point of its command
+        self.assertEqual(list(array.array("i", polyline["EdgeCommands"])), [0, 1, 3, 4])
+        self.assertEqual(list(points[0:3]), [0, 0, 10])
+        self.assertEqual(list(points[3 * edges[0] - 3 : 3 * edges[0]]), [1, 0, 5])
+        self.assertEqual(list(points[3 * edges[2] - 3 : 3 * edges[2]]), [3, 0, 0])
+        self.assertEqual(len(points), 3 * edges[-1])
+
+        # the arc is split into segments, each segment has a color
+        self.assertGreaterEqual(edges[2] - edges[1], 20)
+        self.assertEqual(len(colors), edges[-1] - 1)
+        self.assertEqual(colors[0], 0)
+        self.assertEqual(colors[1], 1)
+        self.assertEqual(colors[-1], 2)
+
+        # large paths are segmented in chunks with the same result
+        commands = [Path.Command("G91")]
+        for i in range(20000):
+            commands.append(Path.Command("G1", {"X": 1, "Y": i % 2}))
+            if i % 100 == 0:
+                commands.append(Path.Command("G3", {"X": 2, "I": 1, "J": 0}))
+        p = Path.Path(commands)
+        serial = p.getPolyline(threads=1)
+        chunked = p.getPolyline(threads=4)
+        self.assertEqual(serial, chunked)
+        points = array.array("f", serial["Points"])
+        self.assertEqual(list(points[-3:]), [20400, 10000, 0])
@@ -0,0 +1,96 @@
+# -*- coding: utf-8 -*-
+# ***************************************************************************
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+# *   as published by the Free Software Foundation; either version 2 of     *
+# *   the License, or (at your option) any later version.                   *
+# *   for detail see the LICENCE text file.                                 *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU Library General Public License for more details.                  *
+# *                                                                         *
+# *   You should have received a copy of the GNU Library General Public     *
+# *   License along with this program; if not, write to the Free Software   *
+# *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+# *   USA                                                                   *
+# *                                                                         *
+# ***************************************************************************
+
+import math
+
+import FreeCAD
+import Part
+import Path
+import PathSimulator
+from PathTests.PathTestUtils import PathTestBase
+
+
+class TestPathSimulator(PathTestBase):
+    def setUp(self):
+        self.start = FreeCAD.Placement(FreeCAD.Vector(0, 0, 10), FreeCAD.Rotation())
+
+    def simulator(self):
+        sim = PathSimulator.PathSim()
+        sim.BeginSimulation(Part.makeBox(20, 10, 5), 0.1)
+        sim.SetToolShape(Part.makeCylinder(1, 10), 0.1)
+        return sim
+
+    def test00(self):
+        """Verify the removed volume and cycle time of a toolpath"""
+        path = Path.Path(
+            [
+                Path.Command("G0", {"X": 2, "Y": 5, "Z": 10}),
+                Path.Command("G1", {"Z": 4, "F": 2}),
+                Path.Command("G1", {"X": 18, "F": 4}),
+                Path.Command("G0", {"Z": 10}),
+            ]
+        )
+        result = self.simulator().ApplyToolpath(self.start, path, rapid=10)
+
+        # a 1mm deep slot of 16mm length with a 2mm cutter
+        volume = 16 * 2 + math.pi
+        self.assertRoughly(result["RemovedVolume"], volume, 0.05 * volume)
+        self.assertRoughly(result["CycleTime"], math.sqrt(29) / 10 + 6 / 2 + 16 / 4 + 6 / 10, 1e-6)
+        self.assertEqual(result["Gouges"], [])
+        self.assertPlacement(result["Placement"], FreeCAD.Placement(FreeCAD.Vector(18, 5, 10), FreeCAD.Rotation()))
+
+    def test01(self):
+        """Verify that rapid moves through the stock are reported"""
+        path = Path.Path(
+            [
+                Path.Command("G0", {"X": 2, "Y": 5, "Z": 10}),
+                Path.Command("G0", {"Z": 4}),
+                Path.Command("G1", {"X": 10, "F": 4}),
+                Path.Command("G0", {"X": 18}),
+                Path.Command("G0", {"Z": 10}),
+            ]
+        )
+        result = self.simulator().ApplyToolpath(self.start, path)
+        self.assertEqual(result["Gouges"], [1, 3])
+        self.assertEqual(result["CycleTime"], 2)
+
+    def test02(self):
+        """Verify that the result does not depend on the number of threads"""
+        path = Path.Path(
+            [
+                Path.Command("G0", {"X": 1, "Y": 1, "Z": 10}),
+                Path.Command("G1", {"Z": 3, "F": 2}),
+                Path.Command("G2", {"X": 19, "Y": 1, "I": 9, "J": 0, "F": 4}),
+                Path.Command("G1", {"X": 1, "Y": 9, "Z": 2}),
+                Path.Command("G0", {"Z": 10}),
+            ]
+        )
+        serial = self.simulator()
+        result1 = serial.ApplyToolpath(self.start, path, threads=1)
+        parallel = self.simulator()
+        result4 = parallel.ApplyToolpath(self.start, path, threads=4)
+        self.assertEqual(result1["RemovedVolume"], result4["RemovedVolume"])
+
+        mesh1 = serial.GetResultMesh()[1]
+        mesh4 = parallel.GetResultMesh()[1]
+        self.assertTrue(mesh1.CountFacets > 0)
+        self.assertEqual(mesh1.Topology, mesh4.Topology)
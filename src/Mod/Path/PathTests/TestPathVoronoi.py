@@ -24,35 +24,45 @@ import FreeCAD
 import Part
 import Path
 import PathTests.PathTestUtils as PathTestUtils
+import array
 
 vd = None
 
+pts = [
+    (0, 0),
+    (3.5, 0),
+    (3.5, 1),
+    (1, 1),
+    (1, 2),
+    (2.5, 2),
+    (2.5, 3),
+    (1, 3),
+    (1, 4),
+    (3.5, 4),
+    (3.5, 5),
+    (0, 5),
+]
+
+
+def outline():
+    ptv = [FreeCAD.Vector(p[0], p[1]) for p in pts]
+    ptv.append(ptv[0])
+    return ptv
+
+
+def createVD():
+    ptv = outline()
+    diagram = Path.Voronoi.Diagram()
+    for i in range(len(pts)):
+        diagram.addSegment(ptv[i], ptv[i + 1])
+    diagram.construct()
+    return diagram
+
 
 def initVD():
     global vd
     if vd is None:
-        pts = [
-            (0, 0),
-            (3.5, 0),
-            (3.5, 1),
-            (1, 1),
-            (1, 2),
-            (2.5, 2),
-            (2.5, 3),
-            (1, 3),
-            (1, 4),
-            (3.5, 4),
-            (3.5, 5),
-            (0, 5),
-        ]
-        ptv = [FreeCAD.Vector(p[0], p[1]) for p in pts]
-        ptv.append(ptv[0])
-
-        vd = Path.Voronoi.Diagram()
-        for i in range(len(pts)):
-            vd.addSegment(ptv[i], ptv[i + 1])
-
-        vd.construct()
+        vd = createVD()
 
         for e in vd.Edges:
             e.Color = 0 if e.isPrimary() else 1
@@ -206,3 +216,58 @@ class TestPathVoronoi(PathTestUtils.PathTestBase):
         )
         self.assertRoughly(e.valueAt(e.FirstParameter).z, 2.37)
         self.assertRoughly(e.valueAt(e.LastParameter).z, 5.14)
+
+    def test70(self):
+        """Check colorEdges colors primary, secondary and borderline edges"""
+
+        diagram = createVD()
+        diagram.colorEdges(0, 1, 6)
+        for e in diagram.Edges:
+            if not e.isPrimary():
+                self.assertEqual(e.Color, 1)
+            elif e.isBorderline():
+                self.assertEqual(e.Color, 6)
+            else:
+                self.assertEqual(e.Color, 0)
+
+    def test71(self):
+        """Check colorOutside colors like colorExterior with an inside callback"""
+
+        face = Part.Face(Part.makePolygon(outline()))
+        d0 = createVD()
+        d1 = createVD()
+        for diagram in [d0, d1]:
+            diagram.colorEdges(0, 1)
+            diagram.colorExterior(2)
+        d0.colorExterior(3, lambda v: not face.isInside(v.toPoint(), 0.01, True))
+        d1.colorOutside(3, 0.01)
+
+        self.assertEqual([e.Color for e in d0.Edges], [e.Color for e in d1.Edges])
+        self.assertNotEqual(len([e for e in d1.Edges if e.Color == 0]), 0)
+
+    def test72(self):
+        """Check getMedialAxis chains all edges of a color into wires"""
+
+        diagram = createVD()
+        diagram.colorEdges(0, 1, 6)
+        diagram.colorExterior(2)
+        diagram.colorColinear(3)
+        diagram.colorTwins(4)
+
+        axis = diagram.getMedialAxis(0, 0.001)
+        points = array.array("d", axis["Points"])
+        ends = array.array("i", axis["WireIndices"])
+        self.assertNotEqual(len(ends), 0)
+        self.assertEqual(3 * ends[-1], len(points))
+
+        # each edge is traversed once, curved edges add points in between
+        edges = [e for e in diagram.Edges if e.Color == 0 and e.isFinite()]
+        self.assertTrue(ends[-1] - len(ends) >= len(edges))
+        self.assertNotEqual(len([e for e in edges if e.isCurved()]), 0)
+
+        # all points are as far from the outline as given
+        segments = [Part.makeLine(a, b) for a, b in zip(outline(), outline()[1:])]
+        for i in range(0, len(points), 3):
+            v = Part.Vertex(points[i], points[i + 1], 0)
+            dist = min(v.distToShape(s)[0] for s in segments)
+            self.assertRoughly(points[i + 2], dist, 0.001)
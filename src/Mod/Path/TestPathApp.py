@@ -25,6 +25,7 @@ import TestApp
 from PathTests.TestPathProfile import TestPathProfile
 
 from PathTests.TestPathAdaptive import TestPathAdaptive
+from PathTests.TestPathArea import TestPathArea
 from PathTests.TestPathCore import TestPathCore
 from PathTests.TestPathDepthParams import depthTestCases
 from PathTests.TestPathDressupDogbone import TestDressupDogbone
@@ -53,6 +54,7 @@ from PathTests.TestPathProfile import TestPathProfile
 from PathTests.TestPathPropertyBag import TestPathPropertyBag
 from PathTests.TestPathRotationGenerator import TestPathRotationGenerator
 from PathTests.TestPathSetupSheet import TestPathSetupSheet
+from PathTests.TestPathSimulator import TestPathSimulator
 from PathTests.TestPathStock import TestPathStock
 from PathTests.TestPathThreadMilling import TestPathThreadMilling
 from PathTests.TestPathThreadMillingGenerator import TestPathThreadMillingGenerator
@@ -84,6 +86,7 @@ False if TestHoldingTags.__name__ else True
 False if TestPathLanguage.__name__ else True
 False if TestOutputNameSubstitution.__name__ else True
 False if TestPathAdaptive.__name__ else True
+False if TestPathArea.__name__ else True
 False if TestPathCore.__name__ else True
 False if TestPathOpDeburr.__name__ else True
 False if TestPathDrillable.__name__ else True
@@ -99,6 +102,7 @@ False if TestPathProfile.__name__ else True
 False if TestPathPropertyBag.__name__ else True
 False if TestPathRotationGenerator.__name__ else True
 False if TestPathSetupSheet.__name__ else True
+False if TestPathSimulator.__name__ else True
 False if TestPathStock.__name__ else True
 False if TestPathThreadMilling.__name__ else True
 False if TestPathThreadMillingGenerator.__name__ else True
@@ -26,6 +26,10 @@
 #include <cstring>
 #include <ctime>
 #include <algorithm>
+#include <exception>
+#include <random>
+#include <sstream>
+#include <thread>
 
 namespace ClipperLib
 {
@@ -1114,7 +1118,8 @@ class Interpolation
 
 	double getRandomAngle()
 	{
-		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * double(rand()) / double(RAND_MAX);
+		// own generator instead of rand(), so that the result of a region does not depend on other regions
+		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * double(random() - random.min()) / double(random.max() - random.min());
 	}
 	size_t getPointCount()
 	{
@@ -1124,6 +1129,7 @@ class Interpolation
   private:
 	vector<double> angles;
 	vector<double> areas;
+	minstd_rand random;
 };
 
 //***************************************
@@ -1687,7 +1693,6 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 		scaleFactor = maxScaleFactor;
 	//scaleFactor = round(scaleFactor);
 
-	current_region=0;
 	cout << "Tool Diameter: " << toolDiameter << endl;
 	cout << "Accuracy: " << round(10000.0/scaleFactor)/10 << " um" << endl;
 	cout << flush;
@@ -1695,7 +1700,6 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 	toolRadiusScaled = long(toolDiameter * scaleFactor / 2);
 	stepOverScaled = toolRadiusScaled * stepOverFactor;
 	progressCallback = &progressCallbackFn;
-	lastProgressTime = clock();
 	stopProcessing = false;
 
 	if(helixRampDiameter<NTOL)
@@ -1778,6 +1782,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 	//	Resolve hierarchy and run processing
 	//***************************************
 	double cornerRoundingOffset = 0.15 * toolRadiusScaled / 2;
+	std::vector<std::pair<Paths, Paths>> regions; // bound paths and tool bound paths of each region
 	if (opType == OperationType::otClearingInside || opType == OperationType::otClearingOutside)
 	{
 
@@ -1830,7 +1835,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 				clipof.Clear();
 				clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 				clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
-				ProcessPolyNode(boundPaths, toolBoundPaths);
+				regions.emplace_back(boundPaths, toolBoundPaths);
 			}
 		}
 	}
@@ -1889,14 +1894,107 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 					clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 					clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
 
-					ProcessPolyNode(boundPaths, toolBoundPaths);
+					regions.emplace_back(boundPaths, toolBoundPaths);
 				}
 			}
 		}
 	}
+
+	ProcessRegions(regions);
 	return results;
 }
 
+void Adaptive2d::ProcessRegions(const std::vector<std::pair<Paths, Paths>> &regions)
+{
+	size_t threadCount = threads > 0 ? size_t(threads) : size_t(std::thread::hardware_concurrency());
+	threadCount = max<size_t>(1, min(threadCount, regions.size()));
+
+	// the regions are taken in turn by the workers, the results are kept per region to keep their order
+	std::vector<std::list<AdaptiveOutput>> regionResults(regions.size());
+	std::atomic<size_t> nextRegion(0);
+	std::atomic<size_t> runningWorkers(threadCount);
+	// exceptions of the workers and the callback are kept until all workers are joined,
+	// a joinable thread must not be left behind
+	std::exception_ptr error;
+	auto setError = [&](std::exception_ptr e) {
+		std::lock_guard<std::mutex> lock(progressMutex);
+		if (!error)
+			error = e;
+		stopProcessing = true;
+	};
+	auto worker = [&]() {
+		try
+		{
+			for (size_t i = nextRegion++; i < regions.size() && !stopProcessing; i = nextRegion++)
+			{
+				std::ostringstream message;
+				message << "** Processing region: " << i + 1 << endl;
+				cout << message.str() << flush;
+				ProcessPolyNode(regions[i].first, regions[i].second, regionResults[i]);
+			}
+		}
+		catch (...)
+		{
+			setError(std::current_exception());
+		}
+		std::lock_guard<std::mutex> lock(progressMutex);
+		runningWorkers--;
+		progressCondition.notify_all();
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount);
+	try
+	{
+		for (size_t i = 0; i < threadCount; i++)
+			workers.emplace_back(worker);
+	}
+	catch (...)
+	{
+		setError(std::current_exception());
+		std::lock_guard<std::mutex> lock(progressMutex);
+		runningWorkers -= threadCount - workers.size();
+	}
+
+	// pass the progress of all regions to the callback
+	TPaths progressPaths;
+	bool callbackFailed = false;
+	std::unique_lock<std::mutex> lock(progressMutex);
+	for (;;)
+	{
+		progressCondition.wait_for(lock, PROGRESS_INTERVAL, [&]() { return progressForced || runningWorkers == 0; });
+		bool finished = runningWorkers == 0;
+		progressPaths.swap(pendingProgress);
+		progressForced = false;
+		lock.unlock();
+		if (!progressPaths.empty() && progressCallback && !callbackFailed)
+		{
+			try
+			{
+				if ((*progressCallback)(progressPaths))
+					stopProcessing = true; // call python function, if returns true signal stop processing
+			}
+			catch (...)
+			{
+				callbackFailed = true;
+				setError(std::current_exception());
+			}
+		}
+		progressPaths.clear();
+		if (finished)
+			break;
+		lock.lock();
+	}
+
+	for (auto &thread : workers)
+		thread.join();
+	if (error)
+		std::rethrow_exception(error);
+
+	for (auto &output : regionResults)
+		results.splice(results.end(), output);
+}
+
 bool Adaptive2d::FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &boundPaths,
 								ClearedArea &clearedArea /*output-initial cleared area by helix*/,
 								IntPoint &entryPoint /*output*/,
@@ -2169,15 +2267,15 @@ bool Adaptive2d::ResolveLinkPath(const IntPoint &startPoint, const IntPoint &end
 	double par;
 
 	// put a time limit on the resolving the link path
-	clock_t time_limit = (clock_t)(max(keepToolDownDistRatio, 3.0) * CLOCKS_PER_SEC / 6);
-
-	clock_t time_out = clock() + time_limit;
+	// (wall clock time, the CPU time of the process grows with the number of threads)
+	Clock::time_point time_out = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<double>(max(keepToolDownDistRatio, 3.0) / 6));
 
 	while (!queue.empty())
 	{
 		if (stopProcessing)
 			return false;
-		if (clock() > time_out)
+		if (Clock::now() > time_out)
 		{
 			cout << "Unable to resolve tool down linking path (limit reached)." << endl;
 			return false;
@@ -2549,16 +2647,23 @@ void Adaptive2d::AppendToolPath(TPaths &progressPaths, AdaptiveOutput &output,
 	Perf_AppendToolPath.Stop();
 }
 
-void Adaptive2d::CheckReportProgress(TPaths &progressPaths, bool force)
+void Adaptive2d::CheckReportProgress(TPaths &progressPaths, Clock::time_point &lastProgressTime, bool force)
 {
-	if (!force && (clock() - lastProgressTime < PROGRESS_TICKS))
+	if (!force && (Clock::now() - lastProgressTime < PROGRESS_INTERVAL))
 		return; // not yet
-	lastProgressTime = clock();
+	lastProgressTime = Clock::now();
 	if (progressPaths.empty())
 		return;
-	if (progressCallback)
-		if ((*progressCallback)(progressPaths))
-			stopProcessing = true; // call python function, if returns true signal stop processing
+	{
+		// hand the paths over to the thread calling the python function
+		std::lock_guard<std::mutex> lock(progressMutex);
+		pendingProgress.insert(pendingProgress.end(), progressPaths.begin(), progressPaths.end());
+		if (force)
+		{
+			progressForced = true;
+			progressCondition.notify_all();
+		}
+	}
 	// clean the paths - keep the last point
 	if (progressPaths.back().second.empty())
 		return;
@@ -2599,11 +2704,9 @@ void Adaptive2d::AddPathToProgress(TPaths &progressPaths, const Path pth, Motion
 	}
 }
 
-void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
+void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths, std::list<AdaptiveOutput> &regionResults)
 {
 	Perf_ProcessPolyNode.Start();
-	current_region++;
-	cout << "** Processing region: " << current_region << endl;
 
 	// node paths are already constrained to tool boundary path for adaptive path before finishing pass
 	Clipper clip;
@@ -2612,6 +2715,7 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 	IntPoint entryPoint;
 	TPaths progressPaths;
 	progressPaths.reserve(10000);
+	Clock::time_point lastProgressTime = Clock::now();
 
 	CleanPolygons(toolBoundPaths);
 	SimplifyPolygons(toolBoundPaths);
@@ -2675,7 +2779,7 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 	IntPoint newToolPos;
 	DoublePoint newToolDir;
 
-	CheckReportProgress(progressPaths, true);
+	CheckReportProgress(progressPaths, lastProgressTime, true);
 
 	IntPoint startPoint = toolPos;
 	output.StartPoint = DPoint(double(startPoint.X) / scaleFactor, double(startPoint.Y) / scaleFactor);
@@ -2929,7 +3033,7 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 				// append gyro
 				gyro.push_back(newToolDir);
 				gyro.erase(gyro.begin());
-				CheckReportProgress(progressPaths);
+				CheckReportProgress(progressPaths, lastProgressTime);
 			}
 			else
 			{
@@ -2956,7 +3060,7 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 			CleanPath(passToolPath, cleaned, CLEAN_PATH_TOLERANCE);
 			total_output_points += long(cleaned.size());
 			AppendToolPath(progressPaths, output, cleaned, clearedBeforePass, cleared, toolBoundPaths);
-			CheckReportProgress(progressPaths);
+			CheckReportProgress(progressPaths, lastProgressTime);
 			bad_engage_count = 0;
 			engage.ResetPasses();
 		}
@@ -3113,7 +3217,7 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 		Perf_IsAllowedToCutTrough.DumpResults();
 		Perf_IsClearPath.DumpResults();
 #endif
-		CheckReportProgress(progressPaths, true);
+		CheckReportProgress(progressPaths, lastProgressTime, true);
 #ifdef DEV_MODE
 		double duration = ((double) (clock() - start_clock)) / CLOCKS_PER_SEC;
 		cout << "PolyNode perf:" << perf_total_len / double(scaleFactor) / duration << " mm/sec"
@@ -3138,7 +3242,7 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 				<< "Hint: try to modify accuracy and/or step-over." << endl;
 		}
 	}
-	results.push_back(output);
+	regionResults.push_back(output);
 }
 
 } // namespace AdaptivePath
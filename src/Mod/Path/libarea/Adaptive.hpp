@@ -21,8 +21,13 @@
 ***************************************************************************/
 
 #include "clipper.hpp"
-#include <vector>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <list>
+#include <mutex>
+#include <vector>
 #include <time.h>
 
 #ifndef ADAPTIVE_HPP
@@ -81,7 +86,7 @@ struct AdaptiveOutput
 	int ReturnMotionType; // MotionType enum, problem with serialization if enum is used
 };
 
-// used to isolate state -> enable potential adding of multi-threaded processing of separate regions
+// the state of each region is isolated, separate regions are processed in parallel
 
 class Adaptive2d
 {
@@ -96,6 +101,7 @@ class Adaptive2d
 	bool finishingProfile = true;
 	double keepToolDownDistRatio = 3.0; // keep tool down distance ratio
 	OperationType opType = OperationType::otClearingInside;
+	int threads = 0; // number of threads processing separate regions, 0 uses all cores
 
 	std::list<AdaptiveOutput> Execute(const DPaths &stockPaths, const DPaths &paths, std::function<bool(TPaths)> progressCallbackFn);
 
@@ -118,14 +124,21 @@ class Adaptive2d
 	long helixRampRadiusScaled = 0;
 	double referenceCutArea = 0;
 	double optimalCutAreaPD = 0;
-	bool stopProcessing = false;
-	int current_region=0;
-	clock_t lastProgressTime = 0;
+	std::atomic<bool> stopProcessing{false};
+
+	// progress of the regions not yet passed to the callback, the callback is only called from the thread running Execute
+	std::mutex progressMutex;
+	std::condition_variable progressCondition;
+	TPaths pendingProgress;
+	bool progressForced = false;
 
 	std::function<bool(TPaths)> *progressCallback = NULL;
 	Path toolGeometry; // tool geometry at coord 0,0, should not be modified
 
-	void ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths);
+	typedef std::chrono::steady_clock Clock;
+
+	void ProcessRegions(const std::vector<std::pair<Paths, Paths>> &regions);
+	void ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths, std::list<AdaptiveOutput> &regionResults);
 	bool FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &bound, ClearedArea &cleared /*output*/,
 						IntPoint &entryPoint /*output*/, IntPoint &toolPos, DoublePoint &toolDir);
 	bool FindEntryPointOutside(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &bound, ClearedArea &cleared /*output*/,
@@ -142,7 +155,7 @@ class Adaptive2d
 
 	friend class EngagePoint; // for CalcCutArea
 
-	void CheckReportProgress(TPaths &progressPaths, bool force = false);
+	void CheckReportProgress(TPaths &progressPaths, Clock::time_point &lastProgressTime, bool force = false);
 	void AddPathsToProgress(TPaths &progressPaths, const Paths paths, MotionType mt = MotionType::mtCutting);
 	void AddPathToProgress(TPaths &progressPaths, const Path pth, MotionType mt = MotionType::mtCutting);
 	void ApplyStockToLeave(Paths &inputPaths);
@@ -164,7 +177,7 @@ class Adaptive2d
 
 	const long PASSES_LIMIT = __LONG_MAX__;			   // limit used while debugging
 	const long POINTS_PER_PASS_LIMIT = __LONG_MAX__;   // limit used while debugging
-	const clock_t PROGRESS_TICKS = CLOCKS_PER_SEC / 10; // progress report interval
+	const Clock::duration PROGRESS_INTERVAL = std::chrono::milliseconds(100); // progress report interval
 };
 } // namespace AdaptivePath
 #endif
\ No newline at end of file
@@ -71,6 +71,16 @@ public:
                             ClipperLib::EndType endType=ClipperLib::etOpenRound,
                             double miterLimit = 5.0, 
                             double roundPrecision = 0.0);
+    // Offsets a copy of this area by each of the offsets into results, which gives the
+    // same as OffsetWithClipper on each copy. The curves are converted to Clipper paths
+    // only once and the offsets run in up to 'threads' threads, 0 uses one per core.
+    void OffsetsWithClipper(const std::vector<double> &offsets,
+                            std::vector<CArea> &results,
+                            ClipperLib::JoinType joinType=ClipperLib::jtRound,
+                            ClipperLib::EndType endType=ClipperLib::etOpenRound,
+                            double miterLimit = 5.0,
+                            double roundPrecision = 0.0,
+                            int threads = 0)const;
 	void Thicken(double value);
 	void FitArcs();
 	unsigned int num_curves(){return static_cast<int>(m_curves.size());}
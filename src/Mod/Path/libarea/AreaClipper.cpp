@@ -2,6 +2,11 @@
 
 // implements CArea methods using Angus Johnson's "Clipper"
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 #include "Area.h"
 #include "clipper.hpp"
 using namespace ClipperLib;
@@ -24,7 +29,8 @@ public:
 	IntPoint int_point(){return IntPoint((long64)(X * CArea::m_clipper_scale), (long64)(Y * CArea::m_clipper_scale));}
 };
 
-static std::list<DoubleAreaPoint> pts_for_AddVertex;
+// per thread, so that areas can be converted to clipper paths concurrently
+static thread_local std::list<DoubleAreaPoint> pts_for_AddVertex;
 
 static void AddPoint(const DoubleAreaPoint& p)
 {
@@ -509,25 +515,31 @@ void CArea::Clip(ClipType op, const CArea *a,
 	SetFromResult(*this, solution, false, false, false);
 }
 
-void CArea::OffsetWithClipper(double offset, 
-                              JoinType joinType/* =jtRound */,
-                              EndType endType/* =etOpenRound */,
-                              double miterLimit/*  = 5.0 */,
-                              double roundPrecision/*  = 0.0 */)
+// returns the clipper round precision for the given offset, both in clipper units
+static double ClipperRoundPrecision(double offset, double roundPrecision)
 {
-    offset *= m_units*m_clipper_scale;
     if(roundPrecision == 0.0) {
         // Clipper roundPrecision definition: https://goo.gl/4odfQh
-		double dphi=acos(1.0-m_accuracy*m_clipper_scale/fabs(offset));
+		double dphi=acos(1.0-CArea::m_accuracy*CArea::m_clipper_scale/fabs(offset));
         int Segments=(int)ceil(PI/dphi);
         if (Segments < 2*CArea::m_min_arc_points)
             Segments = 2*CArea::m_min_arc_points;
         // if (Segments > CArea::m_max_arc_points)
         //     Segments=CArea::m_max_arc_points;
         dphi = PI/Segments;
-        roundPrecision = (1.0-cos(dphi))*fabs(offset);
-    }else
-        roundPrecision *= m_clipper_scale;
+        return (1.0-cos(dphi))*fabs(offset);
+    }
+    return roundPrecision * CArea::m_clipper_scale;
+}
+
+void CArea::OffsetWithClipper(double offset, 
+                              JoinType joinType/* =jtRound */,
+                              EndType endType/* =etOpenRound */,
+                              double miterLimit/*  = 5.0 */,
+                              double roundPrecision/*  = 0.0 */)
+{
+    offset *= m_units*m_clipper_scale;
+    roundPrecision = ClipperRoundPrecision(offset, roundPrecision);
 
     ClipperOffset clipper(miterLimit,roundPrecision);
 	TPolyPolygon pp, pp2;
@@ -540,6 +552,67 @@ void CArea::OffsetWithClipper(double offset,
     this->Reorder();
 }
 
+void CArea::OffsetsWithClipper(const std::vector<double> &offsets,
+                               std::vector<CArea> &results,
+                               JoinType joinType/* =jtRound */,
+                               EndType endType/* =etOpenRound */,
+                               double miterLimit/*  = 5.0 */,
+                               double roundPrecision/*  = 0.0 */,
+                               int threads/* = 0 */)const
+{
+    results.clear();
+    results.resize(offsets.size());
+    if(offsets.empty())
+        return;
+
+    TPolyPolygon pp;
+	MakePolyPoly(*this, pp, false);
+    std::vector<EndType> endTypes;
+    for(const CCurve &c : m_curves)
+        endTypes.push_back(c.IsClosed()?etClosedPolygon:endType);
+
+    size_t threadCount = threads > 0 ? size_t(threads) : size_t(std::thread::hardware_concurrency());
+    threadCount = std::max<size_t>(1, std::min(threadCount, offsets.size()));
+
+    // the offsets are taken in turn by the workers. A clipper is not executed twice, since
+    // it fixes the orientation of the paths on each execution.
+    std::atomic<size_t> nextOffset(0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto worker = [&]() {
+        try
+        {
+            for(size_t i = nextOffset++; i < offsets.size(); i = nextOffset++)
+            {
+                double offset = offsets[i]*m_units*m_clipper_scale;
+                ClipperOffset clipper(miterLimit,ClipperRoundPrecision(offset, roundPrecision));
+                for(size_t j = 0; j < pp.size(); j++)
+                    clipper.AddPath(pp[j],joinType,endTypes[j]);
+                TPolyPolygon pp2;
+                clipper.Execute(pp2,(long64)(offset));
+                SetFromResult(results[i], pp2, false);
+                results[i].Reorder();
+            }
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if(!error)
+                error = std::current_exception();
+            nextOffset = offsets.size();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(size_t i = 1; i < threadCount; i++)
+        workers.emplace_back(worker);
+    worker();
+    for(auto &thread : workers)
+        thread.join();
+    if(error)
+        std::rethrow_exception(error);
+}
+
 void CArea::Thicken(double value)
 {
 	TPolyPolygon pp;
@@ -33,8 +33,6 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace std;
 
-CAreaOrderer* CInnerCurves::area_orderer = NULL;
-
 CInnerCurves::CInnerCurves(shared_ptr<CInnerCurves> pOuter, shared_ptr<CCurve> curve)
 :m_pOuter(pOuter)
 ,m_curve(curve)
@@ -145,8 +143,6 @@ CAreaOrderer::CAreaOrderer()
 
 void CAreaOrderer::Insert(shared_ptr<CCurve> pcurve)
 {
-	CInnerCurves::area_orderer = this;
-
 	// make them all anti-clockwise as they come in
 	if(pcurve->IsClockwise())pcurve->Reverse();
 
@@ -25,6 +25,7 @@
 #include <Base/Console.h>
 #include <Base/Interpreter.h>
 
+#include "FeaturePointsFilter.h"
 #include "Points.h"
 #include "PointsPy.h"
 #include "Properties.h"
@@ -58,5 +59,9 @@ PyMOD_INIT_FUNC(Points)
     Points::FeatureCustom         ::init();
     Points::StructuredCustom      ::init();
     Points::FeaturePython         ::init();
+    Points::Filter                ::init();
+    Points::EstimateNormals       ::init();
+    Points::RemoveOutliers        ::init();
+    Points::DownSample            ::init();
     PyMOD_Return(pointsModule);
 }
@@ -0,0 +1,280 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <cfloat>
+# include <climits>
+# include <type_traits>
+#endif
+
+#include "FeaturePointsFilter.h"
+#include "PointsFilter.h"
+
+
+using namespace Points;
+
+namespace {
+
+const App::PropertyIntegerConstraint::Constraints neighbourRange = {3, INT_MAX, 1};
+const App::PropertyFloatConstraint::Constraints factorRange = {0.0, FLT_MAX, 0.1};
+const App::PropertyFloatConstraint::Constraints sizeRange = {0.001, FLT_MAX, 1.0};
+
+/**
+ * Creates the points in global coordinates so that the result doesn't depend
+ * on the placement of the source.
+ */
+PointKernel toGlobal(const PointKernel& kernel)
+{
+    PointKernel global;
+    global.reserve(kernel.size());
+    for (auto it = kernel.begin(); it != kernel.end(); ++it)
+        global.push_back(*it);
+    return global;
+}
+
+/**
+ * Rotates the normals of the source by its placement so that they match the
+ * points created by toGlobal().
+ */
+std::vector<Base::Vector3f> toGlobal(const std::vector<Base::Vector3f>& normals, const Base::Matrix4D& mat)
+{
+    Base::Matrix4D rot(mat);
+    rot.setCol(3, Base::Vector3d());
+
+    std::vector<Base::Vector3f> global;
+    global.reserve(normals.size());
+    for (const auto& it : normals) {
+        Base::Vector3f normal = rot * it;
+        global.push_back(normal.Normalize());
+    }
+    return global;
+}
+
+/**
+ * Copies the list properties of type \a PropT from \a source to \a target where
+ * \a mapValues transforms the values. Missing properties are added dynamically.
+ */
+template <class PropT, class Func>
+void copyAttributes(App::DocumentObject* target, const App::DocumentObject* source, Func mapValues)
+{
+    std::vector<App::Property*> props;
+    source->getPropertyList(props);
+    for (App::Property* prop : props) {
+        if (prop->getTypeId() != PropT::getClassTypeId())
+            continue;
+        const char* name = prop->getName();
+        auto dst = dynamic_cast<PropT*>(target->getPropertyByName(name));
+        if (!dst) {
+            dst = dynamic_cast<PropT*>(target->addDynamicProperty(
+                PropT::getClassTypeId().getName(), name, prop->getGroup()));
+        }
+        if (dst)
+            dst->setValues(mapValues(static_cast<PropT*>(prop)->getValues()));
+    }
+}
+
+template <class T>
+std::vector<T> selectValues(const std::vector<T>& values, const std::vector<unsigned long>& indices)
+{
+    std::vector<T> result;
+    result.reserve(indices.size());
+    for (unsigned long index : indices) {
+        if (index < values.size())
+            result.push_back(values[index]);
+    }
+    return result;
+}
+
+} // namespace
+
+//===========================================================================
+// Filter Feature
+//===========================================================================
+
+PROPERTY_SOURCE(Points::Filter, Points::Feature)
+
+Filter::Filter()
+{
+    ADD_PROPERTY(Source, (nullptr));
+}
+
+short Filter::mustExecute() const
+{
+    if (Source.isTouched())
+        return 1;
+    return 0;
+}
+
+const PointKernel* Filter::getSourcePoints() const
+{
+    App::DocumentObject* link = Source.getValue();
+    if (!link)
+        return nullptr;
+    auto prop = dynamic_cast<PropertyPointKernel*>(link->getPropertyByName("Points"));
+    if (!prop)
+        return nullptr;
+    return &prop->getValue();
+}
+
+// ----------------------------------------------------------------------
+
+PROPERTY_SOURCE(Points::EstimateNormals, Points::Filter)
+
+EstimateNormals::EstimateNormals()
+{
+    ADD_PROPERTY(KSearch, (10));
+    ADD_PROPERTY(Orient, (true));
+    ADD_PROPERTY(Normal, ());
+    KSearch.setConstraints(&neighbourRange);
+    Normal.setStatus(App::Property::Output, true);
+}
+
+short EstimateNormals::mustExecute() const
+{
+    if (KSearch.isTouched() || Orient.isTouched())
+        return 1;
+    return Filter::mustExecute();
+}
+
+App::DocumentObjectExecReturn *EstimateNormals::execute()
+{
+    const PointKernel* kernel = getSourcePoints();
+    if (!kernel)
+        return new App::DocumentObjectExecReturn("No points linked");
+
+    PointKernel points = toGlobal(*kernel);
+    NormalEstimation estimate(points);
+    estimate.SetKSearch(static_cast<unsigned long>(KSearch.getValue()));
+    estimate.SetOrientNormals(Orient.getValue());
+
+    std::vector<Base::Vector3f> normals;
+    estimate.Perform(normals);
+
+    Points.setValue(points);
+    Normal.setValues(normals);
+
+    // the point order is kept so that colours and intensities are just copied
+    auto copy = [](const auto& values) { return values; };
+    copyAttributes<App::PropertyColorList>(this, Source.getValue(), copy);
+    copyAttributes<PropertyGreyValueList>(this, Source.getValue(), copy);
+    return App::DocumentObject::StdReturn;
+}
+
+// ----------------------------------------------------------------------
+
+PROPERTY_SOURCE(Points::RemoveOutliers, Points::Filter)
+
+RemoveOutliers::RemoveOutliers()
+{
+    ADD_PROPERTY(KSearch, (8));
+    ADD_PROPERTY(StdDevFactor, (1.0));
+    KSearch.setConstraints(&neighbourRange);
+    StdDevFactor.setConstraints(&factorRange);
+}
+
+short RemoveOutliers::mustExecute() const
+{
+    if (KSearch.isTouched() || StdDevFactor.isTouched())
+        return 1;
+    return Filter::mustExecute();
+}
+
+App::DocumentObjectExecReturn *RemoveOutliers::execute()
+{
+    const PointKernel* kernel = getSourcePoints();
+    if (!kernel)
+        return new App::DocumentObjectExecReturn("No points linked");
+
+    PointKernel points = toGlobal(*kernel);
+    OutlierRemoval filter(points);
+    filter.SetKSearch(static_cast<unsigned long>(KSearch.getValue()));
+    filter.SetStdDevFactor(StdDevFactor.getValue());
+
+    std::vector<unsigned long> inliers;
+    filter.Perform(inliers);
+
+    PointKernel result;
+    result.reserve(inliers.size());
+    for (unsigned long index : inliers)
+        result.push_back(points.getPoint(index));
+    Points.setValue(result);
+
+    auto select = [&inliers](const auto& values) { return selectValues(values, inliers); };
+    const Base::Matrix4D mat = kernel->getTransform();
+    copyAttributes<PropertyNormalList>(this, Source.getValue(), [&](const auto& values) {
+        return select(toGlobal(values, mat));
+    });
+    copyAttributes<App::PropertyColorList>(this, Source.getValue(), select);
+    copyAttributes<PropertyGreyValueList>(this, Source.getValue(), select);
+    return App::DocumentObject::StdReturn;
+}
+
+// ----------------------------------------------------------------------
+
+PROPERTY_SOURCE(Points::DownSample, Points::Filter)
+
+DownSample::DownSample()
+{
+    ADD_PROPERTY(VoxelSize, (1.0));
+    VoxelSize.setConstraints(&sizeRange);
+}
+
+short DownSample::mustExecute() const
+{
+    if (VoxelSize.isTouched())
+        return 1;
+    return Filter::mustExecute();
+}
+
+App::DocumentObjectExecReturn *DownSample::execute()
+{
+    const PointKernel* kernel = getSourcePoints();
+    if (!kernel)
+        return new App::DocumentObjectExecReturn("No points linked");
+
+    PointKernel points = toGlobal(*kernel);
+    double size = VoxelSize.getValue();
+    VoxelGridFilter filter(points, Base::Vector3d(size, size, size));
+
+    std::vector<Base::Vector3d> centroids;
+    filter.Perform(centroids);
+
+    PointKernel result;
+    result.reserve(centroids.size());
+    for (const auto& pnt : centroids)
+        result.push_back(pnt);
+    Points.setValue(result);
+
+    auto average = [&filter](const auto& values) {
+        std::remove_const_t<std::remove_reference_t<decltype(values)>> averaged;
+        filter.Average(values, averaged);
+        return averaged;
+    };
+    const Base::Matrix4D mat = kernel->getTransform();
+    copyAttributes<PropertyNormalList>(this, Source.getValue(), [&](const auto& values) {
+        return average(toGlobal(values, mat));
+    });
+    copyAttributes<App::PropertyColorList>(this, Source.getValue(), average);
+    copyAttributes<PropertyGreyValueList>(this, Source.getValue(), average);
+    return App::DocumentObject::StdReturn;
+}
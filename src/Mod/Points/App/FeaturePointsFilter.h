@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef POINTS_FEATURE_POINTS_FILTER_H
+#define POINTS_FEATURE_POINTS_FILTER_H
+
+#include <App/PropertyLinks.h>
+#include <App/PropertyStandard.h>
+
+#include "PointsFeature.h"
+#include "Properties.h"
+
+
+namespace Points
+{
+
+/**
+ * The Filter class is the base of features that compute a new point cloud
+ * from the points of the linked feature. The result is in global coordinates,
+ * i.e. the placement of the source is applied to its points and normals.
+ */
+class PointsExport Filter : public Points::Feature
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::Filter);
+
+public:
+    /// Constructor
+    Filter();
+
+    /** @name Properties */
+    //@{
+    App::PropertyLink Source;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    short mustExecute() const override;
+    //@}
+
+protected:
+    /// Returns the points of the linked feature or null
+    const PointKernel* getSourcePoints() const;
+};
+
+/**
+ * The EstimateNormals class computes a normal for each point of the linked feature.
+ */
+class PointsExport EstimateNormals : public Points::Filter
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::EstimateNormals);
+
+public:
+    /// Constructor
+    EstimateNormals();
+
+    /** @name Properties */
+    //@{
+    App::PropertyIntegerConstraint KSearch;
+    App::PropertyBool Orient;
+    PropertyNormalList Normal;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    /// recalculate the Feature
+    App::DocumentObjectExecReturn *execute() override;
+    short mustExecute() const override;
+    //@}
+};
+
+/**
+ * The RemoveOutliers class removes the points of the linked feature whose mean
+ * distance to their neighbours is statistically too large.
+ */
+class PointsExport RemoveOutliers : public Points::Filter
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::RemoveOutliers);
+
+public:
+    /// Constructor
+    RemoveOutliers();
+
+    /** @name Properties */
+    //@{
+    App::PropertyIntegerConstraint KSearch;
+    App::PropertyFloatConstraint StdDevFactor;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    /// recalculate the Feature
+    App::DocumentObjectExecReturn *execute() override;
+    short mustExecute() const override;
+    //@}
+};
+
+/**
+ * The DownSample class replaces the points of the linked feature inside a voxel
+ * by their centroid.
+ */
+class PointsExport DownSample : public Points::Filter
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::DownSample);
+
+public:
+    /// Constructor
+    DownSample();
+
+    /** @name Properties */
+    //@{
+    App::PropertyFloatConstraint VoxelSize;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    /// recalculate the Feature
+    App::DocumentObjectExecReturn *execute() override;
+    short mustExecute() const override;
+    //@}
+};
+
+} // namespace Points
+
+#endif // POINTS_FEATURE_POINTS_FILTER_H
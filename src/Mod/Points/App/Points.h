@@ -128,11 +128,11 @@ public:
 
 
     /// get the points
-    inline const Base::Vector3d getPoint(const int idx) const {
+    inline const Base::Vector3d getPoint(size_type idx) const {
         return transformPointToOutside(_Points[idx]);
     }
     /// set the points
-    inline void setPoint(const int idx,const Base::Vector3d& point) {
+    inline void setPoint(size_type idx,const Base::Vector3d& point) {
         _Points[idx] = transformPointToInside(point);
     }
     /// insert the points
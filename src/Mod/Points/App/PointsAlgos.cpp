@@ -25,13 +25,16 @@
 # ifdef FC_OS_LINUX
 #  include <unistd.h>
 # endif
+# include <cstring>
 # include <memory>
+# include <numeric>
 # include <sstream>
 
 # include <boost/lexical_cast.hpp>
-# include <boost/regex.hpp>
 # include <boost/algorithm/string.hpp>
 # include <boost/math/special_functions/fpclassify.hpp> // needed for compilation on some systems
+
+# include <QFile>
 #endif
 
 #include <Base/Console.h>
@@ -40,12 +43,160 @@
 #include <Base/FileInfo.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/TextScanner.h>
 
 #include "PointsAlgos.h"
+#include "Tools.h"
 #include <E57Format.h>
 
 
 using namespace Points;
+using Base::TextScanner;
+
+namespace {
+
+/*!
+ * Gives read access to the content of a file from position \a pos on. The file is
+ * memory-mapped if possible, otherwise it is read in at once.
+ */
+class TextFile
+{
+public:
+    explicit TextFile(const std::string& filename, qint64 pos = 0)
+        : file(QString::fromUtf8(filename.c_str()))
+    {
+        if (!file.open(QIODevice::ReadOnly))
+            throw Base::FileException("File to load not existing or not readable", filename.c_str());
+
+        qint64 size = file.size();
+        if (pos >= size)
+            return;
+
+        uchar* data = file.map(pos, size - pos);
+        if (data) {
+            first = reinterpret_cast<const char*>(data);
+            last = first + (size - pos);
+        }
+        else {
+            file.seek(pos);
+            buffer = file.readAll();
+            first = buffer.constData();
+            last = first + buffer.size();
+        }
+    }
+    const char* begin() const
+    {
+        return first;
+    }
+    const char* end() const
+    {
+        return last;
+    }
+
+private:
+    QFile file;
+    QByteArray buffer;
+    const char* first = nullptr;
+    const char* last = nullptr;
+};
+
+/*!
+ * Splits the text into line-aligned chunks of at least 1 MB so that each thread gets
+ * one of them. Large texts are split into chunks of at most 8 MB so that the progress
+ * can be shown per chunk. The returned list contains the start of each chunk and the
+ * end of the text.
+ */
+std::vector<const char*> splitLines(const char* begin, const char* end)
+{
+    const std::size_t minChunkSize = 1 << 20;
+    const std::size_t maxChunkSize = 8 << 20;
+    std::size_t size = static_cast<std::size_t>(end - begin);
+    std::size_t numChunks = std::max<std::size_t>(std::min<std::size_t>(size / minChunkSize + 1,
+                                                                        Base::idealThreadCount()),
+                                                  size / maxChunkSize + 1);
+
+    std::vector<const char*> chunks;
+    chunks.reserve(numChunks + 1);
+    chunks.push_back(begin);
+    for (std::size_t i = 1; i < numChunks; i++) {
+        const char* pos = TextScanner::NextLine(begin + i * size / numChunks - 1, end);
+        chunks.push_back(std::max(pos, chunks.back()));
+    }
+    chunks.push_back(end);
+    return chunks;
+}
+
+/*!
+ * Calls \a func(i) for all chunks. The chunks are processed in parallel in waves of as
+ * many chunks as threads are available and the progress is advanced per chunk in the
+ * calling thread after each wave.
+ */
+template <class Func>
+void forEachChunk(std::size_t numChunks, const char* message, Func func)
+{
+    Base::SequencerLauncher seq(message, numChunks);
+    const std::size_t waveSize = static_cast<std::size_t>(Base::idealThreadCount());
+    for (std::size_t wave = 0; wave < numChunks; wave += waveSize) {
+        std::size_t count = std::min(waveSize, numChunks - wave);
+        parallel_for(count, static_cast<int>(count), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++)
+                func(wave + i);
+        });
+        for (std::size_t i = 0; i < count; i++)
+            seq.next();
+    }
+}
+
+/*!
+ * Reads the whitespace separated columns of the non-blank lines of the text into the rows
+ * of \a data. The first \a skip lines are ignored and missing columns are set to zero.
+ */
+void readTable(const char* begin, const char* end, std::size_t skip, Eigen::MatrixXd& data)
+{
+    std::vector<const char*> chunks = splitLines(begin, end);
+    std::size_t numChunks = chunks.size() - 1;
+
+    // count the non-blank lines to get the first row of each chunk
+    std::vector<std::size_t> rows(numChunks + 1, 0);
+    parallel_for(numChunks, static_cast<int>(numChunks), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            for (const char* ptr = chunks[i]; ptr != chunks[i+1]; ptr = TextScanner::NextLine(ptr, chunks[i+1])) {
+                if (!TextScanner::IsLineEnd(TextScanner::SkipBlanks(ptr, chunks[i+1]), chunks[i+1]))
+                    rows[i+1]++;
+            }
+        }
+    });
+    std::partial_sum(rows.begin(), rows.end(), rows.begin());
+
+    std::size_t numRows = data.rows();
+    std::size_t numCols = data.cols();
+    std::vector<char> failed(numChunks, 0);
+    forEachChunk(numChunks, "Loading points...", [&](std::size_t i) {
+        const char* end = chunks[i+1];
+        std::size_t line = rows[i];
+        for (const char* ptr = chunks[i]; ptr != end && line < skip + numRows; ptr = TextScanner::NextLine(ptr, end)) {
+            if (TextScanner::IsLineEnd(TextScanner::SkipBlanks(ptr, end), end))
+                continue;
+            if (line++ < skip)
+                continue;
+
+            std::size_t row = line - skip - 1;
+            for (std::size_t col = 0; col < numCols; col++) {
+                double value = 0.0;
+                if (!TextScanner::IsLineEnd(TextScanner::SkipBlanks(ptr, end), end) && !TextScanner::ReadNumber(ptr, end, value)) {
+                    failed[i] = 1;
+                    return;
+                }
+                data(row, col) = value;
+            }
+        }
+    });
+
+    if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+        throw Base::BadFormatError("Reading in points failed.");
+}
+
+}
 
 void PointsAlgos::Load(PointKernel &points, const char *FileName)
 {
@@ -63,57 +214,52 @@ void PointsAlgos::Load(PointKernel &points, const char *FileName)
 
 void PointsAlgos::LoadAscii(PointKernel &points, const char *FileName)
 {
-    boost::regex rx("^\\s*([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    //boost::regex rx("(\\b[0-9]+\\.([0-9]+\\b)?|\\.[0-9]+\\b)");
-    //boost::regex rx("^\\s*(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s*$");
-    boost::cmatch what;
-
-    Base::Vector3d pt;
-    int LineCnt=0;
-    std::string line;
-    Base::FileInfo fi(FileName);
-
-    Base::ifstream tmp_str(fi, std::ios::in);
-
-    // estimating size
-    while (std::getline(tmp_str,line))
-        LineCnt++;
-
-    // resize the PointKernel
-    points.resize(LineCnt);
-
-    Base::SequencerLauncher seq( "Loading points...", LineCnt );
+    TextFile file(FileName);
+    std::vector<const char*> chunks = splitLines(file.begin(), file.end());
+    std::size_t numChunks = chunks.size() - 1;
 
-    // again to the beginning
-    Base::ifstream file(fi, std::ios::in);
-    LineCnt = 0;
-
-    try {
-        // read file
-        while (std::getline(file, line)) {
-            if (boost::regex_match(line.c_str(), what, rx)) {
-                pt.x = std::atof(what[1].first);
-                pt.y = std::atof(what[4].first);
-                pt.z = std::atof(what[7].first);
-
-                points.setPoint(LineCnt,pt);
-                seq.next();
-                LineCnt++;
+    // Note: first we allocate memory corresponding to the number of lines (points and comments)
+    //       and let each chunk fill its own range. Afterwards the gaps are closed.
+    std::vector<std::size_t> offsets(numChunks + 1, 0);
+    parallel_for(numChunks, static_cast<int>(numChunks), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            std::size_t lines = std::count(chunks[i], chunks[i+1], '\n');
+            if (chunks[i] != chunks[i+1] && chunks[i+1][-1] != '\n')
+                lines++;
+            offsets[i+1] = lines;
+        }
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    points.resize(offsets.back());
+
+    // every line that starts with three numbers is a point, further columns are ignored
+    std::vector<std::size_t> counts(numChunks, 0);
+    forEachChunk(numChunks, "Loading points...", [&](std::size_t i) {
+        const char* end = chunks[i+1];
+        for (const char* ptr = chunks[i]; ptr != end; ptr = TextScanner::NextLine(ptr, end)) {
+            const char* pos = ptr;
+            Base::Vector3d pt;
+            if (TextScanner::ReadNumber(pos, end, pt.x) &&
+                TextScanner::ReadNumber(pos, end, pt.y) &&
+                TextScanner::ReadNumber(pos, end, pt.z)) {
+                points.setPoint(offsets[i] + counts[i], pt);
+                counts[i]++;
             }
         }
-    }
-    catch (...) {
-        points.clear();
-        throw Base::BadFormatError("Reading in points failed.");
+    });
+
+    std::vector<PointKernel::value_type>& pts = points.getBasicPoints();
+    std::size_t numPoints = counts[0];
+    for (std::size_t i = 1; i < numChunks; i++) {
+        auto first = pts.begin() + offsets[i];
+        std::copy(first, first + counts[i], pts.begin() + numPoints);
+        numPoints += counts[i];
     }
 
     // now remove the last points from the kernel
-    // Note: first we allocate memory corresponding to the number of lines (points and comments)
-    //       and read in the file twice. But then the size of the kernel is too high
-    if (LineCnt < (int)points.size())
-        points.erase(LineCnt, points.size());
+    if (numPoints < points.size())
+        points.erase(numPoints, points.size());
 }
 
 // ----------------------------------------------------------------------------
@@ -530,7 +676,7 @@ void PlyReader::read(const std::string& filename)
 
     Eigen::MatrixXd data(numPoints, fields.size());
     if (format == "ascii") {
-        readAscii(inp, offset, data);
+        readAscii(filename, inp.tellg(), offset, data);
     }
     else if (format == "binary_little_endian") {
         readBinary(false, inp, offset, types, sizes, data);
@@ -832,35 +978,12 @@ std::size_t PlyReader::readHeader(std::istream& in,
     return numPoints;
 }
 
-void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
+void PlyReader::readAscii(const std::string& filename, std::streamoff pos,
+                          std::size_t offset, Eigen::MatrixXd& data)
 {
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
+    // the lines of the preceding elements are skipped
+    TextFile file(filename, pos);
+    readTable(file.begin(), file.end(), offset, data);
 }
 
 void PlyReader::readBinary(bool swapByteOrder,
@@ -974,7 +1097,7 @@ void PcdReader::read(const std::string& filename)
 
     Eigen::MatrixXd data(numPoints, fields.size());
     if (format == "ascii") {
-        readAscii(inp, data);
+        readAscii(filename, inp.tellg(), data);
     }
     else if (format == "binary") {
         readBinary(false, inp, types, sizes, data);
@@ -1180,30 +1303,10 @@ std::size_t PcdReader::readHeader(std::istream& in,
     return points;
 }
 
-void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
+void PcdReader::readAscii(const std::string& filename, std::streamoff pos, Eigen::MatrixXd& data)
 {
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
+    TextFile file(filename, pos);
+    readTable(file.begin(), file.end(), 0, data);
 }
 
 void PcdReader::readBinary(bool transpose,
@@ -92,7 +92,8 @@ private:
     std::size_t readHeader(std::istream&, std::string& format, std::size_t& offset,
         std::vector<std::string>& fields, std::vector<std::string>& types,
         std::vector<int>& sizes);
-    void readAscii(std::istream&, std::size_t offset, Eigen::MatrixXd& data);
+    void readAscii(const std::string& filename, std::streamoff pos, std::size_t offset,
+        Eigen::MatrixXd& data);
     void readBinary(bool swapByteOrder, std::istream&, std::size_t offset,
         const std::vector<std::string>& types,
         const std::vector<int>& sizes,
@@ -109,7 +110,7 @@ public:
 private:
     std::size_t readHeader(std::istream&, std::string& format, std::vector<std::string>& fields,
         std::vector<std::string>& types, std::vector<int>& sizes);
-    void readAscii(std::istream&, Eigen::MatrixXd& data);
+    void readAscii(const std::string& filename, std::streamoff pos, Eigen::MatrixXd& data);
     void readBinary(bool transpose, std::istream&,
         const std::vector<std::string>& types,
         const std::vector<int>& sizes,
@@ -0,0 +1,359 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <cmath>
+# include <functional>
+# include <numeric>
+# include <queue>
+# include <tuple>
+#endif
+
+#include <Eigen/Eigenvalues>
+
+#include <Base/Converter.h>
+
+#include "PointsFilter.h"
+#include "PointsGrid.h"
+#include "Tools.h"
+
+
+using namespace Points;
+
+namespace {
+
+bool isValid(const Base::Vector3d& pnt)
+{
+    return std::isfinite(pnt.x) && std::isfinite(pnt.y) && std::isfinite(pnt.z);
+}
+
+/*
+ * Returns the k nearest neighbours of all points of the kernel, see PointsGrid::FindNearest().
+ */
+void findNearest(const PointKernel& kernel, unsigned long k, int threads, std::vector<unsigned long>& neighbours)
+{
+    unsigned long ulX, ulY, ulZ;
+    PointsGrid::CalculateGridCounts(kernel, POINTS_CT_GRID_SEARCH, ulX, ulY, ulZ);
+    PointsGrid grid(kernel, ulX, ulY, ulZ);
+    grid.SetThreads(threads);
+    grid.FindNearest(k, neighbours);
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+NormalEstimation::NormalEstimation(const PointKernel& kernel)
+  : kernel(kernel)
+{
+}
+
+void NormalEstimation::Perform(std::vector<Base::Vector3f>& normals) const
+{
+    normals.clear();
+    std::size_t numPoints = kernel.size();
+    if (numPoints == 0)
+        return;
+
+    unsigned long k = std::max<unsigned long>(kSearch, 3);
+    std::vector<unsigned long> neighbours;
+    findNearest(kernel, k, threads, neighbours);
+
+    const std::vector<PointKernel::value_type>& points = kernel.getBasicPoints();
+    const Base::Matrix4D mat = kernel.getTransform();
+    normals.resize(numPoints);
+    parallel_for(numPoints, threads, [&](std::size_t begin, std::size_t end) {
+        std::vector<Base::Vector3d> pnts;
+        for (std::size_t i = begin; i < end; i++) {
+            pnts.clear();
+            for (std::size_t j = i * k; j < (i + 1) * k && neighbours[j] != POINTS_NO_INDEX; j++)
+                pnts.push_back(mat * Base::convertTo<Base::Vector3d>(points[neighbours[j]]));
+            if (pnts.size() < 3)
+                continue;
+
+            Base::Vector3d mean = std::accumulate(pnts.begin(), pnts.end(), Base::Vector3d());
+            mean /= static_cast<double>(pnts.size());
+
+            Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+            for (const auto& it : pnts) {
+                Eigen::Vector3d diff(it.x - mean.x, it.y - mean.y, it.z - mean.z);
+                covariance += diff * diff.transpose();
+            }
+
+            // the eigenvalues are sorted in increasing order
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig;
+            eig.computeDirect(covariance);
+            Eigen::Vector3d normal = eig.eigenvectors().col(0);
+            normals[i].Set(static_cast<float>(normal.x()), static_cast<float>(normal.y()), static_cast<float>(normal.z()));
+            normals[i].Normalize();
+        }
+    });
+
+    if (orient)
+        Orient(neighbours, normals);
+}
+
+void NormalEstimation::Orient(const std::vector<unsigned long>& neighbours, std::vector<Base::Vector3f>& normals) const
+{
+    // Propagate the orientation along a minimum spanning tree of the neighbourhood graph
+    // where an edge has the weight 1 - |ni * nj|, i.e. the orientation is passed over
+    // nearly parallel normals first. Each connected part starts at its highest point
+    // whose normal is oriented upwards.
+    std::size_t numPoints = normals.size();
+    std::size_t k = neighbours.size() / numPoints;
+
+    // invalid points don't have neighbours and come last
+    std::vector<double> heights(numPoints);
+    for (std::size_t i = 0; i < numPoints; i++) {
+        double z = kernel.getPoint(i).z;
+        heights[i] = std::isfinite(z) ? z : -DBL_MAX;
+    }
+    std::vector<unsigned long> order(numPoints);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&heights](unsigned long a, unsigned long b) {
+        return heights[a] > heights[b] || (heights[a] == heights[b] && a < b);
+    });
+
+    // weight, target, source
+    using Edge = std::tuple<double, unsigned long, unsigned long>;
+    std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge> > queue;
+    std::vector<bool> visited(numPoints, false);
+    auto addEdges = [&](unsigned long from) {
+        for (std::size_t j = from * k; j < (from + 1) * k && neighbours[j] != POINTS_NO_INDEX; j++) {
+            unsigned long to = neighbours[j];
+            if (!visited[to])
+                queue.emplace(1.0 - std::fabs(normals[from] * normals[to]), to, from);
+        }
+    };
+
+    for (unsigned long seed : order) {
+        if (visited[seed])
+            continue;
+        if (normals[seed].z < 0.0f)
+            normals[seed] = -normals[seed];
+        visited[seed] = true;
+        addEdges(seed);
+
+        while (!queue.empty()) {
+            unsigned long to = std::get<1>(queue.top());
+            unsigned long from = std::get<2>(queue.top());
+            queue.pop();
+            if (visited[to])
+                continue;
+            if (normals[from] * normals[to] < 0.0f)
+                normals[to] = -normals[to];
+            visited[to] = true;
+            addEdges(to);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+OutlierRemoval::OutlierRemoval(const PointKernel& kernel)
+  : kernel(kernel)
+{
+}
+
+void OutlierRemoval::Perform(std::vector<unsigned long>& inliers) const
+{
+    inliers.clear();
+    std::size_t numPoints = kernel.size();
+    if (numPoints == 0)
+        return;
+
+    // the point itself is its own nearest neighbour
+    unsigned long k = std::max<unsigned long>(kSearch, 1) + 1;
+    std::vector<unsigned long> neighbours;
+    findNearest(kernel, k, threads, neighbours);
+
+    // mean distance of each point to its neighbours, NaN for invalid points
+    const std::vector<PointKernel::value_type>& points = kernel.getBasicPoints();
+    const Base::Matrix4D mat = kernel.getTransform();
+    std::vector<double> meanDist(numPoints, std::nan(""));
+    parallel_for(numPoints, threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Base::Vector3d pnt = mat * Base::convertTo<Base::Vector3d>(points[i]);
+            if (!isValid(pnt))
+                continue;
+            double sum = 0.0;
+            int count = 0;
+            for (std::size_t j = i * k; j < (i + 1) * k && neighbours[j] != POINTS_NO_INDEX; j++) {
+                if (neighbours[j] == i)
+                    continue;
+                sum += Base::Distance(pnt, mat * Base::convertTo<Base::Vector3d>(points[neighbours[j]]));
+                count++;
+            }
+            meanDist[i] = count > 0 ? sum / count : 0.0;
+        }
+    });
+
+    double sum = 0.0, sumSq = 0.0;
+    std::size_t count = 0;
+    for (double dist : meanDist) {
+        if (!std::isnan(dist)) {
+            sum += dist;
+            sumSq += dist * dist;
+            count++;
+        }
+    }
+    if (count == 0)
+        return;
+
+    double mean = sum / count;
+    double variance = count > 1 ? std::max(0.0, (sumSq - sum * mean) / (count - 1)) : 0.0;
+    double threshold = mean + stdDevFactor * std::sqrt(variance);
+    for (std::size_t i = 0; i < numPoints; i++) {
+        if (meanDist[i] <= threshold)
+            inliers.push_back(i);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+VoxelGridFilter::VoxelGridFilter(const PointKernel& kernel, const Base::Vector3d& size)
+  : kernel(kernel)
+  , size(size)
+{
+}
+
+void VoxelGridFilter::Perform(std::vector<Base::Vector3d>& centroids)
+{
+    centroids.clear();
+    voxelStart.clear();
+    indices.clear();
+
+    std::size_t numPoints = kernel.size();
+    if (numPoints == 0 || size.x <= 0.0 || size.y <= 0.0 || size.z <= 0.0)
+        return;
+
+    std::vector<Base::Vector3d> pnts(numPoints);
+    const std::vector<PointKernel::value_type>& points = kernel.getBasicPoints();
+    const Base::Matrix4D mat = kernel.getTransform();
+    parallel_for(numPoints, threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+            pnts[i] = mat * Base::convertTo<Base::Vector3d>(points[i]);
+    });
+
+    Base::BoundBox3d bbox;
+    for (const auto& it : pnts) {
+        if (isValid(it))
+            bbox.Add(it);
+    }
+    if (!bbox.IsValid())
+        return;
+
+    // sort the valid points by voxel and index
+    using Voxel = std::tuple<unsigned long, unsigned long, unsigned long, unsigned long>;
+    std::vector<Voxel> voxels(numPoints);
+    parallel_for(numPoints, threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const Base::Vector3d& p = pnts[i];
+            if (isValid(p)) {
+                voxels[i] = Voxel(static_cast<unsigned long>((p.z - bbox.MinZ) / size.z),
+                                  static_cast<unsigned long>((p.y - bbox.MinY) / size.y),
+                                  static_cast<unsigned long>((p.x - bbox.MinX) / size.x), i);
+            }
+            else {
+                voxels[i] = Voxel(~0UL, ~0UL, ~0UL, i);
+            }
+        }
+    });
+    std::sort(voxels.begin(), voxels.end());
+
+    indices.reserve(numPoints);
+    for (std::size_t i = 0; i < numPoints; i++) {
+        unsigned long index = std::get<3>(voxels[i]);
+        if (!isValid(pnts[index]))
+            break;
+        if (i == 0 || std::get<0>(voxels[i]) != std::get<0>(voxels[i - 1]) ||
+                      std::get<1>(voxels[i]) != std::get<1>(voxels[i - 1]) ||
+                      std::get<2>(voxels[i]) != std::get<2>(voxels[i - 1]))
+            voxelStart.push_back(indices.size());
+        indices.push_back(index);
+    }
+    voxelStart.push_back(indices.size());
+
+    centroids.resize(voxelStart.size() - 1);
+    parallel_for(centroids.size(), threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Base::Vector3d sum;
+            for (unsigned long j = voxelStart[i]; j < voxelStart[i + 1]; j++)
+                sum += pnts[indices[j]];
+            centroids[i] = sum / static_cast<double>(voxelStart[i + 1] - voxelStart[i]);
+        }
+    });
+}
+
+void VoxelGridFilter::Average(const std::vector<Base::Vector3f>& normals, std::vector<Base::Vector3f>& result) const
+{
+    result.clear();
+    if (voxelStart.empty() || normals.size() != kernel.size())
+        return;
+
+    result.resize(voxelStart.size() - 1);
+    for (std::size_t i = 0; i < result.size(); i++) {
+        Base::Vector3f sum;
+        for (unsigned long j = voxelStart[i]; j < voxelStart[i + 1]; j++)
+            sum += normals[indices[j]];
+        result[i] = sum.Normalize();
+    }
+}
+
+void VoxelGridFilter::Average(const std::vector<App::Color>& colors, std::vector<App::Color>& result) const
+{
+    result.clear();
+    if (voxelStart.empty() || colors.size() != kernel.size())
+        return;
+
+    result.resize(voxelStart.size() - 1);
+    for (std::size_t i = 0; i < result.size(); i++) {
+        float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+        for (unsigned long j = voxelStart[i]; j < voxelStart[i + 1]; j++) {
+            const App::Color& col = colors[indices[j]];
+            r += col.r;
+            g += col.g;
+            b += col.b;
+            a += col.a;
+        }
+        float num = static_cast<float>(voxelStart[i + 1] - voxelStart[i]);
+        result[i] = App::Color(r / num, g / num, b / num, a / num);
+    }
+}
+
+void VoxelGridFilter::Average(const std::vector<float>& values, std::vector<float>& result) const
+{
+    result.clear();
+    if (voxelStart.empty() || values.size() != kernel.size())
+        return;
+
+    result.resize(voxelStart.size() - 1);
+    for (std::size_t i = 0; i < result.size(); i++) {
+        float sum = 0.0f;
+        for (unsigned long j = voxelStart[i]; j < voxelStart[i + 1]; j++)
+            sum += values[indices[j]];
+        result[i] = sum / static_cast<float>(voxelStart[i + 1] - voxelStart[i]);
+    }
+}
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef POINTS_FILTER_H
+#define POINTS_FILTER_H
+
+#include <vector>
+
+#include <App/Color.h>
+#include <Base/Vector3D.h>
+
+#include "Points.h"
+
+
+namespace Points
+{
+
+/**
+ * The NormalEstimation class estimates a normal for each point of a point cloud.
+ * The normal is the direction of least variance of the k nearest neighbours of a point.
+ * Optionally the normals are oriented consistently by propagating the orientation along
+ * a minimum spanning tree of the neighbourhood graph.
+ */
+class PointsExport NormalEstimation
+{
+public:
+    explicit NormalEstimation(const PointKernel&);
+
+    /** Sets the number of nearest neighbours, default is 10. */
+    void SetKSearch(unsigned long k)
+    { kSearch = k; }
+    /** Enables or disables the orientation of the normals, default is true. */
+    void SetOrientNormals(bool on)
+    { orient = on; }
+    /** Sets the number of threads to use. A value of 0 or less uses all cores. */
+    void SetThreads(int num)
+    { threads = num; }
+    /** Computes the normals in global coordinates. Points with too few neighbours
+     * get a null vector. */
+    void Perform(std::vector<Base::Vector3f>& normals) const;
+
+private:
+    void Orient(const std::vector<unsigned long>& neighbours, std::vector<Base::Vector3f>& normals) const;
+
+private:
+    const PointKernel& kernel;
+    unsigned long kSearch{10};
+    bool orient{true};
+    int threads{0};
+};
+
+/**
+ * The OutlierRemoval class detects outliers by their mean distance to the k nearest
+ * neighbours. A point is an outlier if its mean distance is larger than the global mean
+ * plus a multiple of the standard deviation.
+ */
+class PointsExport OutlierRemoval
+{
+public:
+    explicit OutlierRemoval(const PointKernel&);
+
+    /** Sets the number of nearest neighbours, default is 8. */
+    void SetKSearch(unsigned long k)
+    { kSearch = k; }
+    /** Sets the multiple of the standard deviation, default is 1. */
+    void SetStdDevFactor(double factor)
+    { stdDevFactor = factor; }
+    /** Sets the number of threads to use. A value of 0 or less uses all cores. */
+    void SetThreads(int num)
+    { threads = num; }
+    /** Returns the ascending indices of the points that are kept. */
+    void Perform(std::vector<unsigned long>& inliers) const;
+
+private:
+    const PointKernel& kernel;
+    unsigned long kSearch{8};
+    double stdDevFactor{1.0};
+    int threads{0};
+};
+
+/**
+ * The VoxelGridFilter class downsamples a point cloud by replacing all points inside
+ * a voxel with their centroid. Per-point values like normals or colours can be averaged
+ * the same way after Perform() has been called.
+ */
+class PointsExport VoxelGridFilter
+{
+public:
+    VoxelGridFilter(const PointKernel&, const Base::Vector3d& size);
+
+    /** Sets the number of threads to use. A value of 0 or less uses all cores. */
+    void SetThreads(int num)
+    { threads = num; }
+    /** Computes the centroids in global coordinates ordered by voxel. */
+    void Perform(std::vector<Base::Vector3d>& centroids);
+    /** Averages and normalizes the normals per voxel. */
+    void Average(const std::vector<Base::Vector3f>& normals, std::vector<Base::Vector3f>& result) const;
+    /** Averages the colours per voxel. */
+    void Average(const std::vector<App::Color>& colors, std::vector<App::Color>& result) const;
+    /** Averages the values per voxel. */
+    void Average(const std::vector<float>& values, std::vector<float>& result) const;
+
+private:
+    const PointKernel& kernel;
+    Base::Vector3d size;
+    int threads{0};
+    std::vector<unsigned long> voxelStart; /**< Offsets into indices, one more than voxels. */
+    std::vector<unsigned long> indices;    /**< Point indices sorted by voxel. */
+};
+
+} // namespace Points
+
+#endif // POINTS_FILTER_H
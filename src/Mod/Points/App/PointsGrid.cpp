@@ -21,18 +21,122 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <cstdlib>
+# include <numeric>
+#endif
+
+#include <Base/Converter.h>
 
 #include "PointsGrid.h"
+#include "Tools.h"
 
 
 using namespace Points;
 
+namespace {
+
+/*
+ * Gives access to the points of a kernel in global coordinates. The transformation
+ * is skipped for the common case of an identity placement.
+ */
+class GlobalPoints
+{
+public:
+  explicit GlobalPoints(const PointKernel& kernel)
+    : points(kernel.getBasicPoints())
+    , mat(kernel.getTransform())
+    , unity(mat.isUnity())
+  {
+  }
+  std::size_t size() const
+  {
+    return points.size();
+  }
+  Base::Vector3d operator[] (std::size_t index) const
+  {
+    Base::Vector3d pnt = Base::convertTo<Base::Vector3d>(points[index]);
+    return unity ? pnt : mat * pnt;
+  }
+
+private:
+  const std::vector<PointKernel::value_type>& points;
+  Base::Matrix4D mat;
+  bool unity;
+};
+
+bool isFinite(const Base::Vector3d& rclPt)
+{
+  return std::isfinite(rclPt.x) && std::isfinite(rclPt.y) && std::isfinite(rclPt.z);
+}
+
+/*
+ * Grid position of a coordinate clamped to [0, count-1]. The clamping is done before the
+ * conversion to an integer so that far away or infinite coordinates don't overflow.
+ */
+unsigned long clampedPosition(double value, double min, double length, unsigned long count)
+{
+  if (!(value > min))
+    return 0;
+  double pos = (value - min) / length;
+  if (pos >= double(count - 1))
+    return count - 1;
+  return (unsigned long)pos;
+}
+
+/*
+ * Bounding box of the points of a kernel. Points with an infinite or NaN coordinate
+ * are left out because they would make the grid lengths infinite.
+ */
+Base::BoundBox3d finiteBoundBox(const PointKernel& kernel)
+{
+  Base::BoundBox3d clBB;
+  for (PointKernel::const_iterator it = kernel.begin(); it != kernel.end(); ++it) {
+    if (isFinite(*it))
+      clBB.Add(*it);
+  }
+  return clBB;
+}
+
+/*
+ * Calls func with the position and flat index of every grid element whose distance in grid
+ * elements to (x, y, z) is exactly level, i.e. the shell of the cube of size 2*level+1.
+ */
+template <class Func>
+void forEachShellCell(long nx, long ny, long nz, long x, long y, long z, long level, Func func)
+{
+  long x1 = std::max<long>(0, x - level), x2 = std::min<long>(nx - 1, x + level);
+  long y1 = std::max<long>(0, y - level), y2 = std::min<long>(ny - 1, y + level);
+  long z1 = std::max<long>(0, z - level), z2 = std::min<long>(nz - 1, z + level);
+  for (long k = z1; k <= z2; k++) {
+    bool onZ = std::labs(k - z) == level;
+    for (long j = y1; j <= y2; j++) {
+      long row = (k * ny + j) * nx;
+      if (onZ || std::labs(j - y) == level) {
+        for (long i = x1; i <= x2; i++)
+          func(i, j, k, static_cast<unsigned long>(row + i));
+      }
+      else {
+        if (x - level >= 0)
+          func(x - level, j, k, static_cast<unsigned long>(row + x - level));
+        if (x + level < nx)
+          func(x + level, j, k, static_cast<unsigned long>(row + x + level));
+      }
+    }
+  }
+}
+
+}
+
 PointsGrid::PointsGrid (const PointKernel &rclM)
 : _pclPoints(&rclM),
   _ulCtElements(0),
   _ulCtGridsX(0), _ulCtGridsY(0), _ulCtGridsZ(0),
   _fGridLenX(0.0f), _fGridLenY(0.0f), _fGridLenZ(0.0f),
-  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f)
+  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f),
+  _iThreads(0)
 {
   RebuildGrid();
 }
@@ -42,7 +146,8 @@ PointsGrid::PointsGrid ()
   _ulCtElements(0),
   _ulCtGridsX(POINTS_CT_GRID), _ulCtGridsY(POINTS_CT_GRID), _ulCtGridsZ(POINTS_CT_GRID),
   _fGridLenX(0.0f), _fGridLenY(0.0f), _fGridLenZ(0.0f),
-  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f)
+  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f),
+  _iThreads(0)
 {
 }
 
@@ -51,7 +156,8 @@ PointsGrid::PointsGrid (const PointKernel &rclM, unsigned long ulX, unsigned lon
   _ulCtElements(0),
   _ulCtGridsX(0), _ulCtGridsY(0), _ulCtGridsZ(0),
   _fGridLenX(0.0f), _fGridLenY(0.0f), _fGridLenZ(0.0f),
-  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f)
+  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f),
+  _iThreads(0)
 {
   Rebuild(ulX, ulY, ulZ);
 }
@@ -61,7 +167,8 @@ PointsGrid::PointsGrid (const PointKernel &rclM, int   iCtGridPerAxis)
   _ulCtElements(0),
   _ulCtGridsX(0), _ulCtGridsY(0), _ulCtGridsZ(0),
   _fGridLenX(0.0f), _fGridLenY(0.0f), _fGridLenZ(0.0f),
-  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f)
+  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f),
+  _iThreads(0)
 {
   Rebuild(iCtGridPerAxis);
 }
@@ -71,11 +178,10 @@ PointsGrid::PointsGrid (const PointKernel &rclM, double fGridLen)
   _ulCtElements(0),
   _ulCtGridsX(0), _ulCtGridsY(0), _ulCtGridsZ(0),
   _fGridLenX(0.0f), _fGridLenY(0.0f), _fGridLenZ(0.0f),
-  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f)
+  _fMinX(0.0f), _fMinY(0.0f), _fMinZ(0.0f),
+  _iThreads(0)
 {
-  Base::BoundBox3d clBBPts;// = _pclPoints->GetBoundBox();
-  for (PointKernel::const_iterator it = _pclPoints->begin(); it != _pclPoints->end(); ++it )
-    clBBPts.Add(*it);
+  Base::BoundBox3d clBBPts = finiteBoundBox(*_pclPoints);
   Rebuild(std::max<unsigned long>((unsigned long)(clBBPts.LengthX() / fGridLen), 1),
           std::max<unsigned long>((unsigned long)(clBBPts.LengthY() / fGridLen), 1),
           std::max<unsigned long>((unsigned long)(clBBPts.LengthZ() / fGridLen), 1));
@@ -89,7 +195,8 @@ void PointsGrid::Attach (const PointKernel &rclM)
 
 void PointsGrid::Clear ()
 {
-  _aulGrid.clear();
+  _aulCellStart.clear();
+  _aulIndices.clear();
   _pclPoints = nullptr;
 }
 
@@ -120,8 +227,6 @@ void PointsGrid::InitGrid ()
 {
   assert(_pclPoints);
 
-  unsigned long i, j;
-
   // Calculate grid lengths if not initialized
   //
   if ((_ulCtGridsX == 0) || (_ulCtGridsY == 0) || (_ulCtGridsZ == 0))
@@ -130,9 +235,7 @@ void PointsGrid::InitGrid ()
   // Determine the grid length and offset
   //
   {
-  Base::BoundBox3d clBBPts;// = _pclPoints->GetBoundBox();
-  for (PointKernel::const_iterator it = _pclPoints->begin(); it != _pclPoints->end(); ++it )
-    clBBPts.Add(*it);
+  Base::BoundBox3d clBBPts = finiteBoundBox(*_pclPoints);
 
   double fLengthX = clBBPts.LengthX();
   double fLengthY = clBBPts.LengthY();
@@ -166,14 +269,8 @@ void PointsGrid::InitGrid ()
   }
 
   // Create data structure
-  _aulGrid.clear();
-  _aulGrid.resize(_ulCtGridsX);
-  for (i = 0; i < _ulCtGridsX; i++)
-  {
-    _aulGrid[i].resize(_ulCtGridsY);
-    for (j = 0; j < _ulCtGridsY; j++)
-      _aulGrid[i][j].resize(_ulCtGridsZ);
-  }
+  _aulIndices.clear();
+  _aulCellStart.assign(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ + 1, 0);
 }
 
 unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::vector<unsigned long> &raulElements, bool bDelDoubles) const
@@ -192,7 +289,7 @@ unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::vector<uns
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(raulElements.end(), CellBegin(i, j, k), CellEnd(i, j, k));
       }
     }
   }
@@ -226,7 +323,7 @@ unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::vector<uns
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
         if (Base::DistanceP2(GetBoundBox(i, j, k).GetCenter(), rclOrg) < fMinDistP2)
-          raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+          raulElements.insert(raulElements.end(), CellBegin(i, j, k), CellEnd(i, j, k));
       }
     }
   }
@@ -257,7 +354,7 @@ unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::set<unsign
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(CellBegin(i, j, k), CellEnd(i, j, k));
       }
     }
   }
@@ -267,20 +364,9 @@ unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::set<unsign
 
 void PointsGrid::Position (const Base::Vector3d &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const
 {
-  if (rclPoint.x <= _fMinX)
-    rulX = 0;
-  else
-    rulX = std::min<unsigned long>((unsigned long)((rclPoint.x - _fMinX) / _fGridLenX), _ulCtGridsX - 1);
-
-  if (rclPoint.y <= _fMinY)
-    rulY = 0;
-  else
-    rulY = std::min<unsigned long>((unsigned long)((rclPoint.y - _fMinY) / _fGridLenY), _ulCtGridsY - 1);
-
-  if (rclPoint.z <= _fMinZ)
-    rulZ = 0;
-  else
-    rulZ = std::min<unsigned long>((unsigned long)((rclPoint.z - _fMinZ) / _fGridLenZ), _ulCtGridsZ - 1);
+  rulX = clampedPosition(rclPoint.x, _fMinX, _fGridLenX, _ulCtGridsX);
+  rulY = clampedPosition(rclPoint.y, _fMinY, _fGridLenY, _ulCtGridsY);
+  rulZ = clampedPosition(rclPoint.z, _fMinZ, _fGridLenZ, _ulCtGridsZ);
 }
 
 void PointsGrid::CalculateGridLength (unsigned long ulCtGrid, unsigned long ulMaxGrids)
@@ -288,9 +374,7 @@ void PointsGrid::CalculateGridLength (unsigned long ulCtGrid, unsigned long ulMa
     // Calculate grid lengths or number of grids per dimension
     // There should be about 10 (?!?!) facets per grid
     // or max grids should not exceed 10000
-    Base::BoundBox3d clBBPtsEnlarged;// = _pclPoints->GetBoundBox();
-    for (PointKernel::const_iterator it = _pclPoints->begin(); it != _pclPoints->end(); ++it )
-        clBBPtsEnlarged.Add(*it);
+    Base::BoundBox3d clBBPtsEnlarged = finiteBoundBox(*_pclPoints);
     double fVolElem;
 
     if (_ulCtElements > (ulMaxGrids * ulCtGrid))
@@ -325,9 +409,7 @@ void PointsGrid::CalculateGridLength (int iCtGridPerAxis)
   // Calculate grid lengths or number of grids per dimension
   // There should be about 10 (?!?!) facets per grid
   // or max grids should not exceed 10000
-  Base::BoundBox3d clBBPts;// = _pclPoints->GetBoundBox();
-  for (PointKernel::const_iterator it = _pclPoints->begin(); it != _pclPoints->end(); ++it )
-    clBBPts.Add(*it);
+  Base::BoundBox3d clBBPts = finiteBoundBox(*_pclPoints);
 
   double fLenghtX = clBBPts.LengthX();
   double fLenghtY = clBBPts.LengthY();
@@ -486,7 +568,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(CellBegin(nX, i, j), CellEnd(nX, i, j));
           }
           nX++;
         }
@@ -500,7 +582,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(CellBegin(nX, i, j), CellEnd(nX, i, j));
           }
           nX++;
         }
@@ -514,7 +596,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(CellBegin(i, nY, j), CellEnd(i, nY, j));
           }
           nY++;
         }
@@ -528,7 +610,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(CellBegin(i, nY, j), CellEnd(i, nY, j));
           }
           nY--;
         }
@@ -542,7 +624,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(CellBegin(i, j, nZ), CellEnd(i, j, nZ));
           }
           nZ++;
         }
@@ -556,7 +638,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(CellBegin(i, j, nZ), CellEnd(i, j, nZ));
           }
           nZ--;
         }
@@ -622,24 +704,17 @@ void PointsGrid::GetHull (unsigned long ulX, unsigned long ulY, unsigned long ul
 unsigned long PointsGrid::GetElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ,
                                      std::set<unsigned long> &raclInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  if (!rclSet.empty())
+  const unsigned long* pBegin = CellBegin(ulX, ulY, ulZ);
+  const unsigned long* pEnd = CellEnd(ulX, ulY, ulZ);
+  if (pBegin != pEnd)
   {
-    raclInd.insert(rclSet.begin(), rclSet.end());
-    return rclSet.size();
+    raclInd.insert(pBegin, pEnd);
+    return static_cast<unsigned long>(pEnd - pBegin);
   }
 
   return 0;
 }
 
-void PointsGrid::AddPoint (const Base::Vector3d &rclPt, unsigned long ulPtIndex, float /*fEpsilon*/)
-{
-  unsigned long ulX, ulY, ulZ;
-  Pos(Base::Vector3d(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
-  if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
-    _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
-}
-
 void PointsGrid::Validate (const PointKernel &rclPoints)
 {
   if (_pclPoints != &rclPoints)
@@ -686,12 +761,37 @@ void PointsGrid::RebuildGrid ()
 
   InitGrid();
 
-  // Fill data structure
+  // Fill data structure with a counting sort: determine the grid element of each point,
+  // count the points per grid element and distribute the indices. As the indices are
+  // distributed in ascending order each grid element keeps them sorted. Points with
+  // an infinite or NaN coordinate are not added to any grid element.
+  const GlobalPoints points(*_pclPoints);
+  const unsigned long ulCtCells = _aulCellStart.size() - 1;
+  std::vector<unsigned long> aulCells(points.size());
+  parallel_for(points.size(), _iThreads, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      Base::Vector3d clPt = points[i];
+      if (!isFinite(clPt)) {
+        aulCells[i] = ulCtCells;
+        continue;
+      }
+      unsigned long ulX, ulY, ulZ;
+      Pos(clPt, ulX, ulY, ulZ);
+      aulCells[i] = CheckPos(ulX, ulY, ulZ) ? CellIndex(ulX, ulY, ulZ) : ulCtCells;
+    }
+  });
+
+  for (unsigned long ulCell : aulCells) {
+    if (ulCell < ulCtCells)
+      _aulCellStart[ulCell + 1]++;
+  }
+  std::partial_sum(_aulCellStart.begin(), _aulCellStart.end(), _aulCellStart.begin());
 
-  unsigned long i = 0;
-  for (PointKernel::const_iterator it = _pclPoints->begin(); it != _pclPoints->end(); ++it )
-  {
-    AddPoint(*it, i++);
+  _aulIndices.resize(_aulCellStart.back());
+  std::vector<unsigned long> aulNext(_aulCellStart.begin(), _aulCellStart.end() - 1);
+  for (unsigned long i = 0; i < aulCells.size(); i++) {
+    if (aulCells[i] < ulCtCells)
+      _aulIndices[aulNext[aulCells[i]]++] = i;
   }
 }
 
@@ -716,6 +816,242 @@ unsigned long PointsGrid::FindElements (const Base::Vector3d &rclPoint, std::set
   return 0;
 }
 
+void PointsGrid::CalculateGridCounts (const PointKernel &rclM, unsigned long ulPerGrid,
+                                      unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ)
+{
+  Base::BoundBox3d clBBPts = finiteBoundBox(rclM);
+
+  // the grid gets extended by 0.5 on each side, see InitGrid()
+  double afLength[3] = {1.0 + clBBPts.LengthX(), 1.0 + clBBPts.LengthY(), 1.0 + clBBPts.LengthZ()};
+  if (!clBBPts.IsValid())
+    afLength[0] = afLength[1] = afLength[2] = 1.0;
+  double fCtGrids = std::max<double>(double(rclM.size()) / double(std::max<unsigned long>(ulPerGrid, 1)), 1.0);
+
+  // Distribute the grids over all three extents. If an extent is shorter than the
+  // resulting grid length it gets only one grid element and the others are re-distributed.
+  double afSorted[3] = {afLength[0], afLength[1], afLength[2]};
+  std::sort(afSorted, afSorted + 3);
+  double fGridLen = afSorted[2];
+  for (int i = 0; i < 3; i++) {
+    double fMeasure = 1.0;
+    for (int j = i; j < 3; j++)
+      fMeasure *= afSorted[j];
+    fGridLen = std::pow(fMeasure / fCtGrids, 1.0 / double(3 - i));
+    if (afSorted[i] >= fGridLen)
+      break;
+  }
+
+  rulX = std::max<unsigned long>((unsigned long)(afLength[0] / fGridLen), 1);
+  rulY = std::max<unsigned long>((unsigned long)(afLength[1] / fGridLen), 1);
+  rulZ = std::max<unsigned long>((unsigned long)(afLength[2] / fGridLen), 1);
+}
+
+double PointsGrid::GetShellDistance (const Base::Vector3d &rclPt, unsigned long ulX, unsigned long ulY, unsigned long ulZ,
+                                     unsigned long ulDistance) const
+{
+  // distance to the nearest face of the visited block behind which there are further grids
+  double fDist = DBL_MAX;
+  if (ulX > ulDistance)
+    fDist = std::min(fDist, rclPt.x - (_fMinX + double(ulX - ulDistance) * _fGridLenX));
+  if (ulX + ulDistance + 1 < _ulCtGridsX)
+    fDist = std::min(fDist, _fMinX + double(ulX + ulDistance + 1) * _fGridLenX - rclPt.x);
+  if (ulY > ulDistance)
+    fDist = std::min(fDist, rclPt.y - (_fMinY + double(ulY - ulDistance) * _fGridLenY));
+  if (ulY + ulDistance + 1 < _ulCtGridsY)
+    fDist = std::min(fDist, _fMinY + double(ulY + ulDistance + 1) * _fGridLenY - rclPt.y);
+  if (ulZ > ulDistance)
+    fDist = std::min(fDist, rclPt.z - (_fMinZ + double(ulZ - ulDistance) * _fGridLenZ));
+  if (ulZ + ulDistance + 1 < _ulCtGridsZ)
+    fDist = std::min(fDist, _fMinZ + double(ulZ + ulDistance + 1) * _fGridLenZ - rclPt.z);
+  return fDist;
+}
+
+void PointsGrid::SearchNearest (const Base::Vector3d &rclPt, unsigned long k, double fMaxDist,
+                                std::vector<std::pair<double, unsigned long> > &raclNeighbours) const
+{
+  raclNeighbours.clear();
+  if (k == 0 || _aulIndices.empty() || !isFinite(rclPt))
+    return;
+
+  const GlobalPoints points(*_pclPoints);
+  const double fMaxDist2 = fMaxDist * fMaxDist;
+
+  // Visit the grids shell by shell around the start grid and keep the k nearest points
+  // in a max-heap. Grids that are further away than the farthest candidate are skipped
+  // and once no point behind the visited shells can be nearer the search stops.
+  unsigned long ulX, ulY, ulZ;
+  Position(rclPt, ulX, ulY, ulZ);
+  for (unsigned long ulLevel = 0; ; ulLevel++) {
+    forEachShellCell(_ulCtGridsX, _ulCtGridsY, _ulCtGridsZ, ulX, ulY, ulZ, ulLevel, [&](long iX, long iY, long iZ, unsigned long ulCell) {
+      if (_aulCellStart[ulCell] == _aulCellStart[ulCell + 1])
+        return;
+      if (raclNeighbours.size() == k) {
+        double fDx = std::max<double>({_fMinX + double(iX) * _fGridLenX - rclPt.x, 0.0, rclPt.x - _fMinX - double(iX + 1) * _fGridLenX});
+        double fDy = std::max<double>({_fMinY + double(iY) * _fGridLenY - rclPt.y, 0.0, rclPt.y - _fMinY - double(iY + 1) * _fGridLenY});
+        double fDz = std::max<double>({_fMinZ + double(iZ) * _fGridLenZ - rclPt.z, 0.0, rclPt.z - _fMinZ - double(iZ + 1) * _fGridLenZ});
+        if (fDx * fDx + fDy * fDy + fDz * fDz > raclNeighbours.front().first)
+          return;
+      }
+      for (unsigned long i = _aulCellStart[ulCell]; i < _aulCellStart[ulCell + 1]; i++) {
+        std::pair<double, unsigned long> clNear(Base::DistanceP2(rclPt, points[_aulIndices[i]]), _aulIndices[i]);
+        if (clNear.first > fMaxDist2)
+          continue;
+        if (raclNeighbours.size() < k) {
+          raclNeighbours.push_back(clNear);
+          std::push_heap(raclNeighbours.begin(), raclNeighbours.end());
+        }
+        else if (clNear < raclNeighbours.front()) {
+          std::pop_heap(raclNeighbours.begin(), raclNeighbours.end());
+          raclNeighbours.back() = clNear;
+          std::push_heap(raclNeighbours.begin(), raclNeighbours.end());
+        }
+      }
+    });
+
+    double fBound = GetShellDistance(rclPt, ulX, ulY, ulZ, ulLevel);
+    if (fBound == DBL_MAX)
+      break;
+    if (fBound > 0.0) {
+      double fBound2 = fBound * fBound;
+      if (fBound2 > fMaxDist2)
+        break;
+      if (raclNeighbours.size() == k && raclNeighbours.front().first < fBound2)
+        break;
+    }
+  }
+
+  std::sort_heap(raclNeighbours.begin(), raclNeighbours.end());
+}
+
+void PointsGrid::SearchInRadius (const Base::Vector3d &rclPt, double fRadius,
+                                 std::vector<std::pair<double, unsigned long> > &raclNeighbours) const
+{
+  raclNeighbours.clear();
+  if (!(fRadius >= 0.0) || _aulIndices.empty() || !isFinite(rclPt))
+    return;
+
+  const GlobalPoints points(*_pclPoints);
+  const double fRadius2 = fRadius * fRadius;
+
+  unsigned long ulMinX, ulMinY, ulMinZ, ulMaxX, ulMaxY, ulMaxZ;
+  Position(rclPt - Base::Vector3d(fRadius, fRadius, fRadius), ulMinX, ulMinY, ulMinZ);
+  Position(rclPt + Base::Vector3d(fRadius, fRadius, fRadius), ulMaxX, ulMaxY, ulMaxZ);
+  for (unsigned long k = ulMinZ; k <= ulMaxZ; k++) {
+    for (unsigned long j = ulMinY; j <= ulMaxY; j++) {
+      for (unsigned long ulCell = CellIndex(ulMinX, j, k); ulCell <= CellIndex(ulMaxX, j, k); ulCell++) {
+        for (unsigned long i = _aulCellStart[ulCell]; i < _aulCellStart[ulCell + 1]; i++) {
+          double fDist2 = Base::DistanceP2(rclPt, points[_aulIndices[i]]);
+          if (fDist2 <= fRadius2)
+            raclNeighbours.emplace_back(fDist2, _aulIndices[i]);
+        }
+      }
+    }
+  }
+
+  std::sort(raclNeighbours.begin(), raclNeighbours.end());
+}
+
+unsigned long PointsGrid::FindNearest (const Base::Vector3d &rclPt, unsigned long k, std::vector<unsigned long> &raulElements,
+                                       std::vector<double>* pDistances, double fMaxDist) const
+{
+  std::vector<std::pair<double, unsigned long> > aclNeighbours;
+  SearchNearest(rclPt, k, fMaxDist, aclNeighbours);
+
+  raulElements.clear();
+  if (pDistances)
+    pDistances->clear();
+  for (const auto& it : aclNeighbours) {
+    raulElements.push_back(it.second);
+    if (pDistances)
+      pDistances->push_back(sqrt(it.first));
+  }
+
+  return raulElements.size();
+}
+
+unsigned long PointsGrid::FindInRadius (const Base::Vector3d &rclPt, double fRadius, std::vector<unsigned long> &raulElements,
+                                        std::vector<double>* pDistances) const
+{
+  std::vector<std::pair<double, unsigned long> > aclNeighbours;
+  SearchInRadius(rclPt, fRadius, aclNeighbours);
+
+  raulElements.clear();
+  if (pDistances)
+    pDistances->clear();
+  for (const auto& it : aclNeighbours) {
+    raulElements.push_back(it.second);
+    if (pDistances)
+      pDistances->push_back(sqrt(it.first));
+  }
+
+  return raulElements.size();
+}
+
+void PointsGrid::FindNearest (const std::vector<Base::Vector3d> &rclPts, unsigned long k, std::vector<unsigned long> &raulElements) const
+{
+  raulElements.assign(rclPts.size() * k, POINTS_NO_INDEX);
+  parallel_for(rclPts.size(), _iThreads, [&](std::size_t begin, std::size_t end) {
+    std::vector<std::pair<double, unsigned long> > aclNeighbours;
+    for (std::size_t i = begin; i < end; i++) {
+      SearchNearest(rclPts[i], k, DBL_MAX, aclNeighbours);
+      for (std::size_t j = 0; j < aclNeighbours.size(); j++)
+        raulElements[i * k + j] = aclNeighbours[j].second;
+    }
+  });
+}
+
+void PointsGrid::FindInRadius (const std::vector<Base::Vector3d> &rclPts, double fRadius, std::vector<std::vector<unsigned long> > &raulElements) const
+{
+  raulElements.clear();
+  raulElements.resize(rclPts.size());
+  parallel_for(rclPts.size(), _iThreads, [&](std::size_t begin, std::size_t end) {
+    std::vector<std::pair<double, unsigned long> > aclNeighbours;
+    for (std::size_t i = begin; i < end; i++) {
+      SearchInRadius(rclPts[i], fRadius, aclNeighbours);
+      raulElements[i].reserve(aclNeighbours.size());
+      for (const auto& it : aclNeighbours)
+        raulElements[i].push_back(it.second);
+    }
+  });
+}
+
+void PointsGrid::FindNearest (unsigned long k, std::vector<unsigned long> &raulElements) const
+{
+  raulElements.clear();
+  if (!_pclPoints)
+    return;
+
+  const GlobalPoints points(*_pclPoints);
+  raulElements.assign(points.size() * k, POINTS_NO_INDEX);
+  parallel_for(points.size(), _iThreads, [&](std::size_t begin, std::size_t end) {
+    std::vector<std::pair<double, unsigned long> > aclNeighbours;
+    for (std::size_t i = begin; i < end; i++) {
+      SearchNearest(points[i], k, DBL_MAX, aclNeighbours);
+      for (std::size_t j = 0; j < aclNeighbours.size(); j++)
+        raulElements[i * k + j] = aclNeighbours[j].second;
+    }
+  });
+}
+
+void PointsGrid::FindInRadius (double fRadius, std::vector<std::vector<unsigned long> > &raulElements) const
+{
+  raulElements.clear();
+  if (!_pclPoints)
+    return;
+
+  const GlobalPoints points(*_pclPoints);
+  raulElements.resize(points.size());
+  parallel_for(points.size(), _iThreads, [&](std::size_t begin, std::size_t end) {
+    std::vector<std::pair<double, unsigned long> > aclNeighbours;
+    for (std::size_t i = begin; i < end; i++) {
+      SearchInRadius(points[i], fRadius, aclNeighbours);
+      raulElements[i].reserve(aclNeighbours.size());
+      for (const auto& it : aclNeighbours)
+        raulElements[i].push_back(it.second);
+    }
+  });
+}
+
 // ----------------------------------------------------------------
 
 PointsGridIterator::PointsGridIterator (const PointsGrid &rclG)
@@ -754,7 +1090,7 @@ bool PointsGridIterator::InitOnRay (const Base::Vector3d &rclPt, const Base::Vec
   if (_rclGrid.GetBoundBox().IsInBox(rclPt))
   {  // determine the voxel by the starting point
     _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ));
     _bValidRay = true;
   }
   else
@@ -767,7 +1103,7 @@ bool PointsGridIterator::InitOnRay (const Base::Vector3d &rclPt, const Base::Vec
       else
         _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
 
-      raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+      raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ));
       _bValidRay = true;
     }
   }
@@ -818,7 +1154,7 @@ bool PointsGridIterator::NextOnRay (std::vector<unsigned long> &raulElements)
   if (_bValidRay && _rclGrid.CheckPos(_ulX, _ulY, _ulZ))
   {
     GridElement pos(_ulX, _ulY, _ulZ); _cSearchPositions.insert(pos);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ));
   }
   else {
     _bValidRay = false;  // ray exited
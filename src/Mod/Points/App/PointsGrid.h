@@ -23,7 +23,10 @@
 #ifndef POINTS_GRID_H
 #define POINTS_GRID_H
 
+#include <cfloat>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <Base/BoundBox.h>
 #include <Base/Vector3D.h>
@@ -34,6 +37,8 @@
 #define  POINTS_MAX_GRIDS         100000  // Default value for maximum number of grids
 #define  POINTS_CT_GRID_PER_AXIS  20
 #define  PONTSGRID_BBOX_EXTENSION 10.0f
+#define  POINTS_CT_GRID_SEARCH    8       // Default value for number of elements per grid for neighbourhood queries
+#define  POINTS_NO_INDEX          (~0UL)  // Marks a missing neighbour in batched queries
 
 
 namespace Points {
@@ -89,6 +94,40 @@ public:
   void SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<unsigned long> &rclInd) const;
   //@}
 
+  /** @name Neighbourhood queries
+   * The queries don't modify the grid and thus can be called from several threads at once.
+   */
+  //@{
+  /** Searches for the \a k nearest points to \a rclPt that are not further away than \a fMaxDist.
+   * The indices are sorted by ascending distance, equal distances by index. If \a pDistances
+   * is given it gets the according distances. Returns the number of found points. */
+  unsigned long FindNearest (const Base::Vector3d &rclPt, unsigned long k, std::vector<unsigned long> &raulElements,
+                             std::vector<double>* pDistances = nullptr, double fMaxDist = DBL_MAX) const;
+  /** Searches for all points within the distance \a fRadius to \a rclPt. The indices are sorted
+   * by ascending distance, equal distances by index. Returns the number of found points. */
+  unsigned long FindInRadius (const Base::Vector3d &rclPt, double fRadius, std::vector<unsigned long> &raulElements,
+                              std::vector<double>* pDistances = nullptr) const;
+  /** Searches for the \a k nearest points of each point in \a rclPts. The result is stored row by row,
+   * i.e. the neighbours of the i-th point are at [i*k, (i+1)*k). Missing neighbours are set to POINTS_NO_INDEX. */
+  void FindNearest (const std::vector<Base::Vector3d> &rclPts, unsigned long k, std::vector<unsigned long> &raulElements) const;
+  /** Searches for all points within the distance \a fRadius of each point in \a rclPts. */
+  void FindInRadius (const std::vector<Base::Vector3d> &rclPts, double fRadius, std::vector<std::vector<unsigned long> > &raulElements) const;
+  /** Same as above but takes the points of the attached point kernel as query points. Each point
+   * is its own nearest neighbour. */
+  void FindNearest (unsigned long k, std::vector<unsigned long> &raulElements) const;
+  /** Same as above but takes the points of the attached point kernel as query points. */
+  void FindInRadius (double fRadius, std::vector<std::vector<unsigned long> > &raulElements) const;
+  /** Calculates the number of grid elements per axis so that a grid element contains about \a ulPerGrid
+   * points on average. Flat or thin point clouds get only one grid element along their small extents.
+   * Pass the numbers to the constructor to get a grid suited for neighbourhood queries. */
+  static void CalculateGridCounts (const PointKernel &rclM, unsigned long ulPerGrid,
+                                   unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ);
+  /** Sets the number of threads used by the batched queries. A value of 0 or less uses as many
+   * threads as cores are available. */
+  void SetThreads (int iThreads)
+  { _iThreads = iThreads; }
+  //@}
+
   /** Returns the lengths of the grid elements in x,y and z direction. */
   virtual void  GetGridLengths (double &rfLenX, double &rfLenY, double &rfLenZ) const
   { rfLenX = _fGridLenX; rfLenY = _fGridLenY; rfLenZ = _fGridLenZ; }
@@ -105,7 +144,7 @@ public:
   //@}
   /** Returns the number of elements in a given grid. */
   unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
-  { return _aulGrid[ulX][ulY][ulZ].size(); }
+  { unsigned long ulIdx = CellIndex(ulX, ulY, ulZ); return _aulCellStart[ulIdx + 1] - _aulCellStart[ulIdx]; }
   /** Finds all points that lie in the same grid as the point \a rclPoint. */
   unsigned long FindElements(const Base::Vector3d &rclPoint, std::set<unsigned long>& aulElements) const;
   /** Validates the grid structure and rebuilds it if needed. */
@@ -123,6 +162,14 @@ public:
 protected:
   /** Checks if this is a valid grid position. */
   inline bool CheckPos (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const;
+  /** Returns the index of the grid element in the flat cell array. */
+  unsigned long CellIndex (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return (ulZ * _ulCtGridsY + ulY) * _ulCtGridsX + ulX; }
+  /** Returns the range of point indices stored in the given grid element. */
+  const unsigned long* CellBegin (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return _aulIndices.data() + _aulCellStart[CellIndex(ulX, ulY, ulZ)]; }
+  const unsigned long* CellEnd (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return _aulIndices.data() + _aulCellStart[CellIndex(ulX, ulY, ulZ) + 1]; }
   /** Initializes the size of the internal structure. */
   virtual void InitGrid ();
   /** Deletes the grid structure. */
@@ -138,9 +185,19 @@ protected:
   { return _pclPoints->size(); }
   /** Get the indices of all elements lying in the grids around a given grid with distance \a ulDistance. */
   void GetHull (unsigned long ulX, unsigned long ulY, unsigned long ulZ, unsigned long ulDistance, std::set<unsigned long> &raclInd) const;
+  /** Returns a lower bound for the distance of \a rclPt to all points outside the grids with distance
+   * of at most \a ulDistance to the given grid. Returns DBL_MAX if there are no such grids. */
+  double GetShellDistance (const Base::Vector3d &rclPt, unsigned long ulX, unsigned long ulY, unsigned long ulZ, unsigned long ulDistance) const;
+  /** Collects the \a k nearest points as pairs of squared distance and index, sorted ascending. */
+  void SearchNearest (const Base::Vector3d &rclPt, unsigned long k, double fMaxDist,
+                      std::vector<std::pair<double, unsigned long> > &raclNeighbours) const;
+  /** Collects all points within \a fRadius as pairs of squared distance and index, sorted ascending. */
+  void SearchInRadius (const Base::Vector3d &rclPt, double fRadius,
+                       std::vector<std::pair<double, unsigned long> > &raclNeighbours) const;
 
 protected:
-  std::vector<std::vector<std::vector<std::set<unsigned long> > > >  _aulGrid;   /**< Grid data structure. */
+  std::vector<unsigned long> _aulCellStart; /**< Offsets of the grid elements into _aulIndices, one more than grid elements. */
+  std::vector<unsigned long> _aulIndices;   /**< Point indices sorted by grid element, ascending within each element. */
   const PointKernel* _pclPoints;  /**< The point kernel. */
   unsigned long     _ulCtElements;/**< Number of grid elements for validation issues. */
   unsigned long     _ulCtGridsX;  /**< Number of grid elements in z. */
@@ -152,17 +209,13 @@ protected:
   double             _fMinX;       /**< Grid null position in x. */
   double             _fMinY;       /**< Grid null position in y. */
   double             _fMinZ;       /**< Grid null position in z. */
+  int                _iThreads;    /**< Number of threads for batched queries. */
 
   // friends
   friend class PointsGridIterator;
   friend class PointsGridIteratorStatistic;
 
-public:
-
 protected:
-  /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a ulPtIndex
-   * the corresponding index in the point kernel. */
-  void AddPoint (const Base::Vector3d &rclPt, unsigned long ulPtIndex, float fEpsilon = 0.0f);
   /** Returns the grid numbers to the given point \a rclPoint. */
   void Pos(const Base::Vector3d &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
 };
@@ -182,7 +235,7 @@ public:
   /** Returns indices of the elements in the current grid. */
   void GetElements (std::vector<unsigned long> &raulElements) const
   {
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ));
   }
   /** @name Iteration */
   //@{
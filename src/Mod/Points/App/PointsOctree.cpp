@@ -0,0 +1,351 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <cstdint>
+# include <queue>
+#endif
+
+#include "PointsOctree.h"
+#include "Tools.h"
+
+
+using namespace Points;
+
+namespace {
+
+using Key = std::uint64_t;
+
+/// Number of subdivisions encoded in a Morton key
+const int KeyLevels = 21;
+
+/// Spreads the lower 21 bits of value so that there are two zero bits between them
+Key spreadBits(Key value)
+{
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffff;
+    value = (value | value << 16) & 0x1f0000ff0000ff;
+    value = (value | value << 8) & 0x100f00f00f00f00f;
+    value = (value | value << 4) & 0x10c30c30c30c30c3;
+    value = (value | value << 2) & 0x1249249249249249;
+    return value;
+}
+
+/// Returns the number of leading subdivisions two keys have in common
+int commonLevels(Key a, Key b)
+{
+    Key diff = a ^ b;
+    int levels = 0;
+    while (levels < KeyLevels && (diff >> (3 * (KeyLevels - levels - 1))) == 0)
+        levels++;
+    return levels;
+}
+
+/// Returns the octant of the key in the subdivision level (1-based)
+inline int octant(Key key, int level)
+{
+    return static_cast<int>((key >> (3 * (KeyLevels - level))) & 7);
+}
+
+Base::BoundBox3d childBox(const Base::BoundBox3d& box, int octant)
+{
+    Base::Vector3d center = box.GetCenter();
+    Base::BoundBox3d child = box;
+    (octant & 1 ? child.MinX : child.MaxX) = center.x;
+    (octant & 2 ? child.MinY : child.MaxY) = center.y;
+    (octant & 4 ? child.MinZ : child.MaxZ) = center.z;
+    return child;
+}
+
+double distanceToBox(const Base::Vector3d& pnt, const Base::BoundBox3d& box)
+{
+    double dx = std::max({box.MinX - pnt.x, 0.0, pnt.x - box.MaxX});
+    double dy = std::max({box.MinY - pnt.y, 0.0, pnt.y - box.MaxY});
+    double dz = std::max({box.MinZ - pnt.z, 0.0, pnt.z - box.MaxZ});
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/// Node under construction with its range in the sorted points
+struct PendingNode
+{
+    unsigned long node;
+    std::size_t begin, end;
+};
+
+}
+
+// ----------------------------------------------------------------------------
+
+PointsOctree::Camera PointsOctree::Camera::perspective(const Base::Vector3d& position, const Base::Vector3d& direction,
+                                                       const Base::Vector3d& up, double fieldOfView, double aspect,
+                                                       double nearDistance, double farDistance, int screenHeight)
+{
+    Camera camera;
+    camera.position = position;
+    camera.direction = direction;
+    camera.direction.Normalize();
+    camera.fieldOfView = fieldOfView;
+    camera.nearDistance = nearDistance;
+    camera.screenHeight = screenHeight;
+
+    const Base::Vector3d& dir = camera.direction;
+    Base::Vector3d right = dir % up;
+    right.Normalize();
+    Base::Vector3d upward = right % dir;
+
+    double vertical = 0.5 * fieldOfView;
+    double horizontal = std::atan(aspect * std::tan(vertical));
+    std::vector<Base::Vector3d> normals = {
+        dir,
+        -dir,
+        dir * std::sin(vertical) - upward * std::cos(vertical),
+        dir * std::sin(vertical) + upward * std::cos(vertical),
+        dir * std::sin(horizontal) - right * std::cos(horizontal),
+        dir * std::sin(horizontal) + right * std::cos(horizontal)
+    };
+    for (const auto& it : normals)
+        camera.planes.push_back({it, -(it * position)});
+    camera.planes[0].distance -= nearDistance;
+    camera.planes[1].distance += farDistance;
+    return camera;
+}
+
+PointsOctree::Camera PointsOctree::Camera::orthographic(const Base::Vector3d& position, const Base::Vector3d& direction,
+                                                        const Base::Vector3d& up, double width, double height,
+                                                        double nearDistance, double farDistance, int screenHeight)
+{
+    Camera camera;
+    camera.position = position;
+    camera.direction = direction;
+    camera.direction.Normalize();
+    camera.height = height;
+    camera.nearDistance = nearDistance;
+    camera.screenHeight = screenHeight;
+
+    const Base::Vector3d& dir = camera.direction;
+    Base::Vector3d right = dir % up;
+    right.Normalize();
+    Base::Vector3d upward = right % dir;
+
+    std::vector<Base::Vector3d> normals = {dir, -dir, -upward, upward, -right, right};
+    std::vector<double> offsets = {-nearDistance, farDistance, 0.5 * height, 0.5 * height, 0.5 * width, 0.5 * width};
+    for (std::size_t i = 0; i < normals.size(); i++)
+        camera.planes.push_back({normals[i], offsets[i] - normals[i] * position});
+    return camera;
+}
+
+double PointsOctree::Camera::projectedSize(double size, double distance) const
+{
+    if (fieldOfView > 0.0) {
+        distance = std::max(distance, std::max(nearDistance, 1e-12));
+        return size * screenHeight / (2.0 * distance * std::tan(0.5 * fieldOfView));
+    }
+    return height > 0.0 ? size * screenHeight / height : 0.0;
+}
+
+bool PointsOctree::Camera::isVisible(const Base::BoundBox3d& box) const
+{
+    for (const auto& it : planes) {
+        // the corner that lies furthest in the direction of the normal
+        Base::Vector3d corner(it.normal.x >= 0.0 ? box.MaxX : box.MinX,
+                              it.normal.y >= 0.0 ? box.MaxY : box.MinY,
+                              it.normal.z >= 0.0 ? box.MaxZ : box.MinZ);
+        if (it.normal * corner + it.distance < 0.0)
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+PointsOctree::PointsOctree() = default;
+
+void PointsOctree::Clear()
+{
+    nodes.clear();
+    indices.clear();
+}
+
+void PointsOctree::Build(const PointKernel& kernel)
+{
+    Clear();
+
+    const std::vector<PointKernel::value_type>& points = kernel.getBasicPoints();
+    Base::BoundBox3d bbox;
+    std::vector<unsigned long> valid;
+    valid.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const PointKernel::value_type& pnt = points[i];
+        if (std::isfinite(pnt.x) && std::isfinite(pnt.y) && std::isfinite(pnt.z)) {
+            bbox.Add(Base::Vector3d(pnt.x, pnt.y, pnt.z));
+            valid.push_back(static_cast<unsigned long>(i));
+        }
+    }
+    if (valid.empty())
+        return;
+
+    // the root is a cube that is slightly enlarged to keep all keys in range
+    double length = std::max({bbox.LengthX(), bbox.LengthY(), bbox.LengthZ()});
+    length = length > 0.0 ? length * (1.0 + 1e-6) : 1.0;
+    Base::BoundBox3d root(bbox.MinX, bbox.MinY, bbox.MinZ,
+                          bbox.MinX + length, bbox.MinY + length, bbox.MinZ + length);
+
+    // Sort the points along the Morton curve. The key of a point followed by its index
+    // makes the order unique.
+    const double scale = static_cast<double>(1 << KeyLevels) / length;
+    std::vector<std::pair<Key, unsigned long> > sorted(valid.size());
+    parallel_for(valid.size(), threads, [&](std::size_t begin, std::size_t end) {
+        const Key maxCoord = (Key(1) << KeyLevels) - 1;
+        for (std::size_t i = begin; i < end; i++) {
+            const PointKernel::value_type& pnt = points[valid[i]];
+            Key x = std::min(static_cast<Key>((pnt.x - root.MinX) * scale), maxCoord);
+            Key y = std::min(static_cast<Key>((pnt.y - root.MinY) * scale), maxCoord);
+            Key z = std::min(static_cast<Key>((pnt.z - root.MinZ) * scale), maxCoord);
+            sorted[i] = std::make_pair(spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2), valid[i]);
+        }
+    });
+    std::vector<unsigned long>().swap(valid);
+    parallel_sort(sorted.begin(), sorted.end(), std::less<std::pair<Key, unsigned long> >(), threads);
+
+    // Create the nodes level by level. A node is subdivided if it contains more than
+    // maxPoints points.
+    Node rootNode;
+    rootNode.box = root;
+    rootNode.spacing = length / (1 << SampleLevels);
+    nodes.push_back(rootNode);
+    std::vector<PendingNode> level = {{0, 0, sorted.size()}};
+    while (!level.empty()) {
+        std::vector<std::vector<PendingNode> > children(level.size());
+        parallel_for(level.size(), threads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                const PendingNode& pending = level[i];
+                int depth = nodes[pending.node].depth;
+                if (pending.end - pending.begin <= maxPoints || depth >= MaxDepth)
+                    continue;
+                // the range of each octant follows from the sorted keys
+                auto it = sorted.begin() + pending.begin;
+                auto last = sorted.begin() + pending.end;
+                while (it != last) {
+                    int child = octant(it->first, depth + 1);
+                    auto next = std::partition_point(it, last, [&](const std::pair<Key, unsigned long>& p) {
+                        return octant(p.first, depth + 1) == child;
+                    });
+                    children[i].push_back({static_cast<unsigned long>(child),
+                                           static_cast<std::size_t>(it - sorted.begin()),
+                                           static_cast<std::size_t>(next - sorted.begin())});
+                    it = next;
+                }
+            }
+        });
+
+        std::vector<PendingNode> nextLevel;
+        for (std::size_t i = 0; i < level.size(); i++) {
+            for (const auto& it : children[i]) {
+                int child = static_cast<int>(it.node);
+                Node node;
+                node.box = childBox(nodes[level[i].node].box, child);
+                node.depth = nodes[level[i].node].depth + 1;
+                node.spacing = nodes[level[i].node].spacing * 0.5;
+                unsigned long index = static_cast<unsigned long>(nodes.size());
+                nodes[level[i].node].children[child] = index;
+                nodes.push_back(node);
+                nextLevel.push_back({index, it.begin, it.end});
+            }
+        }
+        level.swap(nextLevel);
+    }
+
+    // A point that is the first one in its cell of the sampling grid of a node belongs to
+    // the highest such node, all other points belong to the leaves.
+    // Pairs of node and position in the sorted list, a packed 64-bit key would limit
+    // the number of points to 2^32.
+    using Owner = std::pair<unsigned long, std::size_t>;
+    std::vector<Owner> owners(sorted.size());
+    parallel_for(sorted.size(), threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Key key = sorted[i].first;
+            int first = i == 0 ? 0 : (sorted[i - 1].first == key ? KeyLevels + 1
+                                                                   : commonLevels(sorted[i - 1].first, key) + 1);
+            int depth = std::max(0, first - SampleLevels);
+            unsigned long node = 0;
+            while (nodes[node].depth < depth) {
+                unsigned long child = nodes[node].children[octant(key, nodes[node].depth + 1)];
+                if (child == NoChild)
+                    break;
+                node = child;
+            }
+            owners[i] = Owner(node, i);
+        }
+    });
+    parallel_sort(owners.begin(), owners.end(), std::less<Owner>(), threads);
+
+    indices.resize(owners.size());
+    for (std::size_t i = 0; i < owners.size(); i++) {
+        unsigned long node = owners[i].first;
+        indices[i] = sorted[owners[i].second].second;
+        if (nodes[node].count++ == 0)
+            nodes[node].first = static_cast<unsigned long>(i);
+    }
+}
+
+void PointsOctree::Select(const Camera& camera, double maxError, std::size_t pointBudget,
+                          std::vector<unsigned long>& selection) const
+{
+    selection.clear();
+    if (nodes.empty() || !camera.isVisible(nodes[0].box))
+        return;
+
+    auto error = [&](unsigned long index) {
+        const Node& node = nodes[index];
+        return camera.projectedSize(node.spacing, distanceToBox(camera.position, node.box));
+    };
+
+    // nodes with the largest error come first, equal errors by index
+    using Entry = std::pair<double, unsigned long>;
+    auto compare = [](const Entry& a, const Entry& b) {
+        return a.first < b.first || (a.first == b.first && a.second > b.second);
+    };
+    std::priority_queue<Entry, std::vector<Entry>, decltype(compare)> queue(compare);
+    queue.emplace(error(0), 0);
+
+    std::size_t numPoints = 0;
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+
+        const Node& node = nodes[entry.second];
+        if (numPoints + node.count > pointBudget && !selection.empty())
+            break;
+        selection.push_back(entry.second);
+        numPoints += node.count;
+
+        if (entry.first <= maxError)
+            continue;
+        for (unsigned long child : node.children) {
+            if (child != NoChild && camera.isVisible(nodes[child].box))
+                queue.emplace(error(child), child);
+        }
+    }
+}
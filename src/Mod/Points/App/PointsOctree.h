@@ -0,0 +1,142 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef POINTS_OCTREE_H
+#define POINTS_OCTREE_H
+
+#include <vector>
+
+#include <Base/BoundBox.h>
+#include <Base/Vector3D.h>
+
+#include "Points.h"
+
+
+namespace Points
+{
+
+/**
+ * The PointsOctree class arranges the points of a point cloud in an octree for level of
+ * detail rendering. Every node owns a spatially uniform subset of the points of its cube
+ * that hasn't been taken by an ancestor, so drawing a node and all its ancestors gives a
+ * representation of the cube whose density grows with the depth. The points of a node are
+ * stored contiguously so that they can be handed over as one chunk.
+ * The octree works in the local coordinate system of the point kernel and doesn't depend
+ * on any GUI classes, so building and selecting can also be done without a display.
+ */
+class PointsExport PointsOctree
+{
+public:
+    /** Number of subdivisions per axis of the sampling grid of a node, i.e. a node owns at
+     * most one point per 1/32 of its edge length. */
+    static const int SampleLevels = 5;
+    /** Maximum depth of the octree. */
+    static const int MaxDepth = 16;
+    static const unsigned long NoChild = ~0UL;
+
+    struct Node
+    {
+        Base::BoundBox3d box;                                    /**< cube of the node */
+        double spacing = 0.0;                                    /**< minimum distance of the owned points */
+        unsigned long first = 0;                                 /**< position of the first owned point */
+        unsigned long count = 0;                                 /**< number of owned points */
+        unsigned long children[8] = {NoChild, NoChild, NoChild, NoChild,
+                                     NoChild, NoChild, NoChild, NoChild};
+        int depth = 0;
+    };
+
+    /**
+     * A camera given by the position and the planes of the view frustum. The planes point
+     * inside, i.e. a point p is visible if normal * p + distance >= 0 for all of them.
+     */
+    struct Camera
+    {
+        struct Plane
+        {
+            Base::Vector3d normal;
+            double distance = 0.0;
+        };
+        Base::Vector3d position;
+        Base::Vector3d direction;
+        double fieldOfView = 0.0;   /**< vertical opening angle, 0 for an orthographic camera */
+        double height = 0.0;        /**< height of the view volume of an orthographic camera */
+        double nearDistance = 0.0;
+        int screenHeight = 0;       /**< height of the viewport in pixels */
+        std::vector<Plane> planes;
+
+        /** Creates a perspective camera, \a fieldOfView is the vertical angle in radians and
+         * \a aspect the ratio of width to height. */
+        static Camera perspective(const Base::Vector3d& position, const Base::Vector3d& direction,
+                                  const Base::Vector3d& up, double fieldOfView, double aspect,
+                                  double nearDistance, double farDistance, int screenHeight);
+        /** Creates an orthographic camera whose view volume has the size \a width x \a height. */
+        static Camera orthographic(const Base::Vector3d& position, const Base::Vector3d& direction,
+                                   const Base::Vector3d& up, double width, double height,
+                                   double nearDistance, double farDistance, int screenHeight);
+        /** Returns the size in pixels of a length \a size at the given distance to the camera. */
+        double projectedSize(double size, double distance) const;
+        /** Returns false if the box is completely outside the view frustum. */
+        bool isVisible(const Base::BoundBox3d& box) const;
+    };
+
+public:
+    PointsOctree();
+
+    /** Sets the number of points from which on a node gets subdivided, default is 20000. */
+    void SetMaxPointsPerNode(unsigned long num)
+    { maxPoints = num; }
+    /** Sets the number of threads to use. A value of 0 or less uses all cores. */
+    void SetThreads(int num)
+    { threads = num; }
+    /** Builds the octree of the valid points of the kernel. */
+    void Build(const PointKernel&);
+    /** Removes all nodes. */
+    void Clear();
+
+    /**
+     * Selects the visible nodes for the camera, starting with the largest screen-space error.
+     * A node is refined as long as the projected spacing of its points is above \a maxError pixels
+     * and the number of selected points stays below \a pointBudget. The selected nodes are
+     * returned in the order of their importance.
+     */
+    void Select(const Camera& camera, double maxError, std::size_t pointBudget,
+                std::vector<unsigned long>& nodes) const;
+
+    const std::vector<Node>& GetNodes() const
+    { return nodes; }
+    /** Returns the indices of the points into the point kernel, grouped by their nodes. */
+    const std::vector<unsigned long>& GetPointIndices() const
+    { return indices; }
+    /** Returns the number of valid points of the octree. */
+    std::size_t CountPoints() const
+    { return indices.size(); }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<unsigned long> indices;
+    unsigned long maxPoints{20000};
+    int threads{0};
+};
+
+} // namespace Points
+
+#endif // POINTS_OCTREE_H
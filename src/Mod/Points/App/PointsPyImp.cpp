@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <limits>
 # include <boost/math/special_functions/fpclassify.hpp>
 #endif
 
@@ -31,6 +32,9 @@
 #include <Base/VectorPy.h>
 
 #include "Points.h"
+#include "PointsFilter.h"
+#include "PointsGrid.h"
+#include "PointsOctree.h"
 // inclusion of the generated files (generated out of PointsPy.xml)
 #include "PointsPy.h"
 #include "PointsPy.cpp"
@@ -223,6 +227,245 @@ PyObject* PointsPy::fromValid(PyObject * args)
     }
 }
 
+namespace {
+std::vector<Base::Vector3d> getQueryPoints(PyObject* obj)
+{
+    std::vector<Base::Vector3d> points;
+    Py::Sequence list(obj);
+    Py::Type vType(Base::getTypeAsObject(&Base::VectorPy::Type));
+    points.reserve(list.size());
+    for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+        if ((*it).isType(vType)) {
+            Py::Vector p(*it);
+            points.push_back(p.toVector());
+        }
+        else {
+            Py::Tuple tuple(*it);
+            points.emplace_back((double)Py::Float(tuple[0]),
+                                (double)Py::Float(tuple[1]),
+                                (double)Py::Float(tuple[2]));
+        }
+    }
+    return points;
+}
+}
+
+PyObject* PointsPy::nearestNeighbours(PyObject * args, PyObject * kwds)
+{
+    unsigned long k;
+    PyObject *obj = Py_None;
+    int threads = 0;
+    static char* keywords_nearest[] = {"K", "Points", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "k|Oi", keywords_nearest, &k, &obj, &threads))
+        return nullptr;
+
+    try {
+        const PointKernel* points = getPointKernelPtr();
+        unsigned long ulX, ulY, ulZ;
+        PointsGrid::CalculateGridCounts(*points, POINTS_CT_GRID_SEARCH, ulX, ulY, ulZ);
+        PointsGrid grid(*points, ulX, ulY, ulZ);
+        grid.SetThreads(threads);
+
+        std::vector<unsigned long> indices;
+        std::size_t count = points->size();
+        if (obj == Py_None) {
+            grid.FindNearest(k, indices);
+        }
+        else {
+            std::vector<Base::Vector3d> query = getQueryPoints(obj);
+            grid.FindNearest(query, k, indices);
+            count = query.size();
+        }
+
+        Py::List list(count);
+        for (std::size_t i = 0; i < count; i++) {
+            Py::List neighbours;
+            for (std::size_t j = i * k; j < (i + 1) * k && indices[j] != POINTS_NO_INDEX; j++)
+                neighbours.append(Py::Long(indices[j]));
+            list.setItem(i, neighbours);
+        }
+        return Py::new_reference_to(list);
+    }
+    catch (const Py::Exception&) {
+        PyErr_SetString(PyExc_TypeError, "either expect\n"
+            "-- [Vector,...] \n"
+            "-- [(x,y,z),...]");
+        return nullptr;
+    }
+}
+
+PyObject* PointsPy::neighboursInRadius(PyObject * args, PyObject * kwds)
+{
+    double radius;
+    PyObject *obj = Py_None;
+    int threads = 0;
+    static char* keywords_radius[] = {"Radius", "Points", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|Oi", keywords_radius, &radius, &obj, &threads))
+        return nullptr;
+
+    try {
+        const PointKernel* points = getPointKernelPtr();
+        unsigned long ulX, ulY, ulZ;
+        PointsGrid::CalculateGridCounts(*points, POINTS_CT_GRID_SEARCH, ulX, ulY, ulZ);
+        PointsGrid grid(*points, ulX, ulY, ulZ);
+        grid.SetThreads(threads);
+
+        std::vector<std::vector<unsigned long> > indices;
+        if (obj == Py_None)
+            grid.FindInRadius(radius, indices);
+        else
+            grid.FindInRadius(getQueryPoints(obj), radius, indices);
+
+        Py::List list(indices.size());
+        for (std::size_t i = 0; i < indices.size(); i++) {
+            Py::List neighbours;
+            for (unsigned long index : indices[i])
+                neighbours.append(Py::Long(index));
+            list.setItem(i, neighbours);
+        }
+        return Py::new_reference_to(list);
+    }
+    catch (const Py::Exception&) {
+        PyErr_SetString(PyExc_TypeError, "either expect\n"
+            "-- [Vector,...] \n"
+            "-- [(x,y,z),...]");
+        return nullptr;
+    }
+}
+
+PyObject* PointsPy::estimateNormals(PyObject * args, PyObject * kwds)
+{
+    unsigned long k = 10;
+    PyObject *orient = Py_True;
+    int threads = 0;
+    static char* keywords_normals[] = {"K", "Orient", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|kO!i", keywords_normals, &k, &PyBool_Type, &orient, &threads))
+        return nullptr;
+
+    NormalEstimation estimate(*getPointKernelPtr());
+    estimate.SetKSearch(k);
+    estimate.SetOrientNormals(PyObject_IsTrue(orient) ? true : false);
+    estimate.SetThreads(threads);
+
+    std::vector<Base::Vector3f> normals;
+    estimate.Perform(normals);
+
+    Py::List list(normals.size());
+    for (std::size_t i = 0; i < normals.size(); i++)
+        list.setItem(i, Py::Vector(normals[i]));
+    return Py::new_reference_to(list);
+}
+
+PyObject* PointsPy::removeOutliers(PyObject * args, PyObject * kwds)
+{
+    unsigned long k = 8;
+    double factor = 1.0;
+    int threads = 0;
+    static char* keywords_outliers[] = {"K", "StdDev", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|kdi", keywords_outliers, &k, &factor, &threads))
+        return nullptr;
+
+    OutlierRemoval filter(*getPointKernelPtr());
+    filter.SetKSearch(k);
+    filter.SetStdDevFactor(factor);
+    filter.SetThreads(threads);
+
+    std::vector<unsigned long> inliers;
+    filter.Perform(inliers);
+
+    Py::List list(inliers.size());
+    for (std::size_t i = 0; i < inliers.size(); i++)
+        list.setItem(i, Py::Long(inliers[i]));
+    return Py::new_reference_to(list);
+}
+
+PyObject* PointsPy::downSample(PyObject * args, PyObject * kwds)
+{
+    double size;
+    int threads = 0;
+    static char* keywords_voxel[] = {"Size", "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", keywords_voxel, &size, &threads))
+        return nullptr;
+
+    if (!(size > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "Size must be positive");
+        return nullptr;
+    }
+
+    VoxelGridFilter filter(*getPointKernelPtr(), Base::Vector3d(size, size, size));
+    filter.SetThreads(threads);
+
+    std::vector<Base::Vector3d> centroids;
+    filter.Perform(centroids);
+
+    std::unique_ptr<PointKernel> pts(new PointKernel());
+    pts->reserve(centroids.size());
+    for (const auto& pnt : centroids)
+        pts->push_back(pnt);
+    return new PointsPy(pts.release());
+}
+
+PyObject* PointsPy::selectVisible(PyObject * args, PyObject * kwds)
+{
+    PyObject *pos, *dir, *up;
+    double angle, aspect, nearDist, farDist;
+    int height = 1000;
+    double maxError = 1.0;
+    unsigned long budget = 0;
+    unsigned long maxPoints = 20000;
+    int threads = 0;
+    static char* keywords_visible[] = {"Position", "Direction", "Up", "Angle", "Aspect", "Near", "Far",
+                                       "ScreenHeight", "MaxError", "PointBudget", "MaxPointsPerNode",
+                                       "Threads", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O!O!dddd|idkki", keywords_visible,
+                                     &(Base::VectorPy::Type), &pos,
+                                     &(Base::VectorPy::Type), &dir,
+                                     &(Base::VectorPy::Type), &up,
+                                     &angle, &aspect, &nearDist, &farDist,
+                                     &height, &maxError, &budget, &maxPoints, &threads))
+        return nullptr;
+
+    if (!(angle > 0.0 && angle < M_PI) || !(aspect > 0.0) || !(farDist > nearDist) || height <= 0) {
+        PyErr_SetString(PyExc_ValueError, "Invalid camera");
+        return nullptr;
+    }
+    if (maxPoints == 0) {
+        PyErr_SetString(PyExc_ValueError, "MaxPointsPerNode must be positive");
+        return nullptr;
+    }
+
+    // the octree works in the local coordinate system of the points
+    const PointKernel* points = getPointKernelPtr();
+    Base::Matrix4D mat = points->getTransform();
+    mat.inverse();
+    Base::Vector3d position = *static_cast<Base::VectorPy*>(pos)->getVectorPtr();
+    Base::Vector3d direction = *static_cast<Base::VectorPy*>(dir)->getVectorPtr();
+    Base::Vector3d upward = *static_cast<Base::VectorPy*>(up)->getVectorPtr();
+    Base::Vector3d localPos = mat * position;
+    Base::Vector3d localDir = mat * (position + direction) - localPos;
+    Base::Vector3d localUp = mat * (position + upward) - localPos;
+
+    PointsOctree octree;
+    octree.SetMaxPointsPerNode(maxPoints);
+    octree.SetThreads(threads);
+    octree.Build(*points);
+
+    PointsOctree::Camera camera = PointsOctree::Camera::perspective(localPos, localDir, localUp,
+        angle, aspect, nearDist, farDist, height);
+    std::vector<unsigned long> nodes;
+    octree.Select(camera, maxError, budget > 0 ? budget : std::numeric_limits<std::size_t>::max(), nodes);
+
+    const std::vector<PointsOctree::Node>& octreeNodes = octree.GetNodes();
+    const std::vector<unsigned long>& indices = octree.GetPointIndices();
+    Py::List list;
+    for (unsigned long index : nodes) {
+        const PointsOctree::Node& node = octreeNodes[index];
+        for (unsigned long i = node.first; i < node.first + node.count; i++)
+            list.append(Py::Long(indices[i]));
+    }
+    return Py::new_reference_to(list);
+}
+
 Py::Long PointsPy::getCountPoints() const
 {
     return Py::Long((long)getPointKernelPtr()->size());
@@ -39,9 +39,16 @@
 
 // STL
 # include <algorithm>
+# include <cfloat>
+# include <charconv>
 # include <cmath>
+# include <cstdint>
+# include <cstring>
 # include <iostream>
+# include <limits>
 # include <memory>
+# include <numeric>
+# include <queue>
 # include <set>
 # include <sstream>
 # include <vector>
@@ -53,7 +60,10 @@
 # include <boost/math/special_functions/fpclassify.hpp>
 
 // Qt
+# include <QFile>
 # include <QtConcurrentMap>
+# include <QtConcurrentRun>
+# include <QThread>
 
 #endif //_PreComp_
 
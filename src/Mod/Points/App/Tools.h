@@ -26,9 +26,13 @@
 
 #include <algorithm>
 #include <App/DocumentObject.h>
+#include <Base/Parallel.h>
 
 namespace Points {
 
+using Base::parallel_for;
+using Base::parallel_sort;
+
 template<typename PropertyT>
 bool copyProperty(App::DocumentObject* target,
                   std::vector<App::DocumentObject*> source,
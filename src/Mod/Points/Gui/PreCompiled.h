@@ -30,6 +30,7 @@
 // STL
 # include <algorithm>
 # include <limits>
+# include <map>
 # include <memory>
 
 // boost
@@ -42,7 +43,14 @@
 // Inventor
 # include <Inventor/SbVec2f.h>
 # include <Inventor/errors/SoDebugError.h>
+# include <Inventor/SbViewVolume.h>
+# include <Inventor/actions/SoGLRenderAction.h>
+# include <Inventor/elements/SoCacheElement.h>
+# include <Inventor/elements/SoModelMatrixElement.h>
+# include <Inventor/elements/SoViewVolumeElement.h>
+# include <Inventor/elements/SoViewportRegionElement.h>
 # include <Inventor/events/SoMouseButtonEvent.h>
+# include <Inventor/nodes/SoCallback.h>
 # include <Inventor/nodes/SoCamera.h>
 # include <Inventor/nodes/SoCoordinate3.h>
 # include <Inventor/nodes/SoDrawStyle.h>
@@ -51,6 +59,7 @@
 # include <Inventor/nodes/SoMaterialBinding.h>
 # include <Inventor/nodes/SoNormal.h>
 # include <Inventor/nodes/SoPointSet.h>
+# include <Inventor/sensors/SoOneShotSensor.h>
 
 #endif  //_PreComp_
 
@@ -22,11 +22,20 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
 # include <limits>
 # include <boost/math/special_functions/fpclassify.hpp>
 
+# include <Inventor/SbViewVolume.h>
+# include <Inventor/actions/SoGLRenderAction.h>
+# include <Inventor/elements/SoCacheElement.h>
+# include <Inventor/elements/SoModelMatrixElement.h>
+# include <Inventor/elements/SoViewVolumeElement.h>
+# include <Inventor/elements/SoViewportRegionElement.h>
 # include <Inventor/errors/SoDebugError.h>
 # include <Inventor/events/SoMouseButtonEvent.h>
+# include <Inventor/nodes/SoCallback.h>
 # include <Inventor/nodes/SoCamera.h>
 # include <Inventor/nodes/SoCoordinate3.h>
 # include <Inventor/nodes/SoDrawStyle.h>
@@ -35,6 +44,7 @@
 # include <Inventor/nodes/SoMaterialBinding.h>
 # include <Inventor/nodes/SoNormal.h>
 # include <Inventor/nodes/SoPointSet.h>
+# include <Inventor/sensors/SoOneShotSensor.h>
 #endif
 
 #include <App/Document.h>
@@ -44,6 +54,7 @@
 #include <Gui/SoFCSelection.h>
 #include <Gui/View3DInventorViewer.h>
 #include <Mod/Points/App/PointsFeature.h>
+#include <Mod/Points/App/PointsOctree.h>
 #include <Mod/Points/App/Properties.h>
 
 #include "ViewProvider.h"
@@ -342,14 +353,34 @@ void ViewProviderPoints::clipPointsCallback(void *, SoEventCallback * n)
 
 PROPERTY_SOURCE(PointsGui::ViewProviderScattered, PointsGui::ViewProviderPoints)
 
+App::PropertyIntegerConstraint::Constraints ViewProviderScattered::budgetRange = {0,std::numeric_limits<int>::max(),100000};
+
 ViewProviderScattered::ViewProviderScattered()
 {
+    static const char *osgroup = "Object Style";
+
+    ADD_PROPERTY_TYPE(PointBudget, (5000000), osgroup, App::Prop_None,
+                      "Maximum number of points to draw, 0 draws all points");
+    PointBudget.setConstraints(&budgetRange);
+
     pcPoints = new SoPointSet();
     pcPoints->ref();
+
+    pcLodCallback = new SoCallback();
+    pcLodCallback->ref();
+    pcLodCallback->setCallback(lodCallback, this);
+    pcChunks = new SoGroup();
+    pcChunks->ref();
+    pcChunkSensor = new SoOneShotSensor(chunkSensorCallback, this);
 }
 
 ViewProviderScattered::~ViewProviderScattered()
 {
+    delete pcChunkSensor;
+    for (auto& it : chunks)
+        it.second->unref();
+    pcChunks->unref();
+    pcLodCallback->unref();
     pcPoints->unref();
 }
 
@@ -405,6 +436,7 @@ void ViewProviderScattered::updateData(const App::Property* prop)
     if (prop->getTypeId() == Points::PropertyPointKernel::getClassTypeId()) {
         ViewProviderPointsBuilder builder;
         builder.createPoints(prop, pcPointsCoord, pcPoints);
+        setupLevelOfDetail();
 
         // The number of points might have changed, so force also a resize of the Inventor internals
         setActiveMode();
@@ -420,6 +452,160 @@ void ViewProviderScattered::updateData(const App::Property* prop)
     }
 }
 
+void ViewProviderScattered::onChanged(const App::Property* prop)
+{
+    if (prop == &PointBudget) {
+        if (pcObject)
+            setupLevelOfDetail();
+    }
+    else if (prop == &PointSize) {
+        ViewProviderPoints::onChanged(prop);
+        // the point size is the tolerated screen-space error
+        if (octree)
+            pcChunks->touch();
+    }
+    else {
+        ViewProviderPoints::onChanged(prop);
+    }
+}
+
+void ViewProviderScattered::setupLevelOfDetail()
+{
+    pcChunkSensor->unschedule();
+    pcChunks->removeAllChildren();
+    for (auto& it : chunks)
+        it.second->unref();
+    chunks.clear();
+    drawnNodes.clear();
+    selectedNodes.clear();
+    octree.reset();
+
+    const Points::PointKernel& kernel = static_cast<Points::Feature*>(pcObject)->Points.getValue();
+    int budget = PointBudget.getValue();
+    if (budget > 0 && kernel.size() > static_cast<std::size_t>(budget)) {
+        octree = std::make_unique<Points::PointsOctree>();
+        octree->Build(kernel);
+    }
+
+    // Draw the whole point set or the chunks selected by the octree. The chunks index
+    // into the shared coordinates so that the per-vertex colors and normals still apply.
+    int index = pcHighlight->findChild(pcPoints);
+    if (octree && index >= 0) {
+        pcHighlight->replaceChild(index, pcChunks);
+        pcHighlight->insertChild(pcLodCallback, index);
+    }
+    else if (!octree && index < 0) {
+        index = pcHighlight->findChild(pcLodCallback);
+        if (index >= 0) {
+            pcHighlight->removeChild(pcChunks);
+            pcHighlight->replaceChild(index, pcPoints);
+        }
+    }
+}
+
+void ViewProviderScattered::lodCallback(void * ud, SoAction * action)
+{
+    if (action->isOfType(SoGLRenderAction::getClassTypeId())) {
+        static_cast<ViewProviderScattered*>(ud)->selectLevelOfDetail(action);
+    }
+}
+
+void ViewProviderScattered::selectLevelOfDetail(SoAction* action)
+{
+    if (!octree)
+        return;
+
+    // the selection depends on the camera, so the render caches must not store it
+    SoState* state = action->getState();
+    SoCacheElement::invalidate(state);
+
+    // the octree uses the local coordinates of the point kernel
+    SbViewVolume vv = SoViewVolumeElement::get(state);
+    vv.transform(SoModelMatrixElement::get(state).inverse());
+    int screenHeight = SoViewportRegionElement::get(state).getViewportSizePixels()[1];
+
+    SbVec3f pos = vv.getProjectionPoint();
+    SbVec3f dir = vv.getProjectionDirection();
+    SbVec3f up = vv.getViewUp();
+    Base::Vector3d position(pos[0], pos[1], pos[2]);
+    Base::Vector3d direction(dir[0], dir[1], dir[2]);
+    Base::Vector3d upward(up[0], up[1], up[2]);
+    double nearDist = vv.getNearDist();
+    double farDist = nearDist + vv.getDepth();
+    double width = vv.getWidth();
+    double height = vv.getHeight();
+    if (height <= 0.0 || screenHeight <= 0)
+        return;
+
+    Points::PointsOctree::Camera camera;
+    if (vv.getProjectionType() == SbViewVolume::PERSPECTIVE) {
+        double fieldOfView = 2.0 * std::atan(0.5 * height / nearDist);
+        camera = Points::PointsOctree::Camera::perspective(position, direction, upward,
+            fieldOfView, width / height, nearDist, farDist, screenHeight);
+    }
+    else {
+        camera = Points::PointsOctree::Camera::orthographic(position, direction, upward,
+            width, height, nearDist, farDist, screenHeight);
+    }
+
+    std::vector<unsigned long> nodes;
+    octree->Select(camera, PointSize.getValue(), PointBudget.getValue(), nodes);
+    std::sort(nodes.begin(), nodes.end());
+
+    // the scene graph must not be changed while it's traversed
+    if (nodes != drawnNodes) {
+        selectedNodes.swap(nodes);
+        pcChunkSensor->schedule();
+    }
+}
+
+void ViewProviderScattered::chunkSensorCallback(void * ud, SoSensor *)
+{
+    static_cast<ViewProviderScattered*>(ud)->updateChunks();
+}
+
+void ViewProviderScattered::updateChunks()
+{
+    if (!octree)
+        return;
+
+    const std::vector<Points::PointsOctree::Node>& nodes = octree->GetNodes();
+    const std::vector<unsigned long>& indices = octree->GetPointIndices();
+
+    // keep the chunks that are still visible and create the new ones
+    std::map<unsigned long, SoIndexedPointSet*> visible;
+    for (unsigned long node : selectedNodes) {
+        auto it = chunks.find(node);
+        if (it != chunks.end()) {
+            visible.insert(*it);
+            chunks.erase(it);
+            continue;
+        }
+
+        const Points::PointsOctree::Node& data = nodes[node];
+        SoIndexedPointSet* chunk = new SoIndexedPointSet();
+        chunk->ref();
+        chunk->coordIndex.setNum(data.count);
+        int32_t* idx = chunk->coordIndex.startEditing();
+        for (unsigned long i = 0; i < data.count; i++)
+            idx[i] = static_cast<int32_t>(indices[data.first + i]);
+        chunk->coordIndex.finishEditing();
+        visible[node] = chunk;
+    }
+
+    for (auto& it : chunks)
+        it.second->unref();
+    chunks.swap(visible);
+
+    pcChunks->enableNotify(false);
+    pcChunks->removeAllChildren();
+    for (auto& it : chunks)
+        pcChunks->addChild(it.second);
+    pcChunks->enableNotify(true);
+    pcChunks->touch();
+    drawnNodes = selectedNodes;
+}
+
 void ViewProviderScattered::cut(const std::vector<SbVec2f>& picked, Gui::View3DInventorViewer &Viewer)
 {
     // create the polygon from the picked points
@@ -23,6 +23,9 @@
 #ifndef POINTSGUI_VIEWPROVIDERPOINTS_H
 #define POINTSGUI_VIEWPROVIDERPOINTS_H
 
+#include <map>
+#include <memory>
+
 #include <Inventor/SbVec2f.h>
 
 #include <Gui/ViewProviderBuilder.h>
@@ -38,6 +41,11 @@ class SoLocateHighlight;
 class SoCoordinate3;
 class SoNormal;
 class SoEventCallback;
+class SoCallback;
+class SoGroup;
+class SoOneShotSensor;
+class SoSensor;
+class SoAction;
 
 namespace App {
     class PropertyColorList;
@@ -51,6 +59,7 @@ namespace Points {
     class PropertyGreyValueList;
     class PropertyNormalList;
     class PointKernel;
+    class PointsOctree;
     class Feature;
 }
 
@@ -126,6 +135,9 @@ public:
     ViewProviderScattered();
     ~ViewProviderScattered() override;
 
+    /// Maximum number of points to draw, 0 draws all points
+    App::PropertyIntegerConstraint PointBudget;
+
     /**
      * Extracts the point data from the feature \a pcFeature and creates
      * an Inventor node \a SoNode with these data.
@@ -135,10 +147,31 @@ public:
     void updateData(const App::Property*) override;
 
 protected:
+    void onChanged(const App::Property* prop) override;
     void cut(const std::vector<SbVec2f>& picked, Gui::View3DInventorViewer &Viewer) override;
 
+private:
+    /// Builds the octree if the point cloud exceeds the point budget and sets up the scene graph
+    void setupLevelOfDetail();
+    /// Selects the octree nodes to draw for the current view
+    void selectLevelOfDetail(SoAction* action);
+    /// Replaces the drawn chunks with the selected ones
+    void updateChunks();
+    static void lodCallback(void * ud, SoAction * action);
+    static void chunkSensorCallback(void * ud, SoSensor * sensor);
+
 protected:
     SoPointSet          * pcPoints;
+
+private:
+    SoCallback          * pcLodCallback;
+    SoGroup             * pcChunks;
+    SoOneShotSensor     * pcChunkSensor;
+    std::unique_ptr<Points::PointsOctree> octree;
+    std::map<unsigned long, SoIndexedPointSet*> chunks;
+    std::vector<unsigned long> drawnNodes;
+    std::vector<unsigned long> selectedNodes;
+    static App::PropertyIntegerConstraint::Constraints budgetRange;
 };
 
 /**
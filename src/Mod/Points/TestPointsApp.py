@@ -0,0 +1,309 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+import math
+import os
+import random
+import tempfile
+import unittest
+
+import FreeCAD
+import Points
+
+
+def _distance2(p, q):
+    return (p.x - q.x) ** 2 + (p.y - q.y) ** 2 + (p.z - q.z) ** 2
+
+
+def _isFinite(p):
+    return all(math.isfinite(v) for v in (p.x, p.y, p.z))
+
+
+class PointsNeighbourTestCases(unittest.TestCase):
+    def setUp(self):
+        rnd = random.Random(4711)
+        pts = [FreeCAD.Vector(rnd.uniform(-10, 10), rnd.uniform(-5, 5), rnd.uniform(0, 2))
+               for _ in range(1500)]
+        # points with an infinite or NaN coordinate must not disturb the grid
+        pts.insert(10, FreeCAD.Vector(float("nan"), 0, 0))
+        pts.insert(20, FreeCAD.Vector(0, float("inf"), 0))
+        pts.insert(30, FreeCAD.Vector(0, 0, -float("inf")))
+        self.points = Points.Points(pts)
+        self.coords = self.points.Points
+        self.finite = [i for i, p in enumerate(self.coords) if _isFinite(p)]
+
+    def bruteNearest(self, pnt, k):
+        dist = sorted((_distance2(pnt, self.coords[i]), i) for i in self.finite)
+        return [i for _, i in dist[:k]]
+
+    def bruteRadius(self, pnt, radius):
+        dist = sorted((_distance2(pnt, self.coords[i]), i) for i in self.finite)
+        return [i for d, i in dist if d <= radius * radius]
+
+    def testNearestNeighbours(self):
+        k = 6
+        result = self.points.nearestNeighbours(k)
+        self.assertEqual(len(result), len(self.coords))
+        for i, pnt in enumerate(self.coords):
+            if _isFinite(pnt):
+                self.assertEqual(result[i], self.bruteNearest(pnt, k))
+            else:
+                self.assertEqual(result[i], [])
+
+    def testNearestNeighboursQuery(self):
+        query = [FreeCAD.Vector(0, 0, 1), FreeCAD.Vector(25, 0, 0), FreeCAD.Vector(-9.5, 4.5, 0.1)]
+        result = self.points.nearestNeighbours(4, query)
+        self.assertEqual(result, [self.bruteNearest(p, 4) for p in query])
+        self.assertEqual(self.points.nearestNeighbours(4, [FreeCAD.Vector(float("nan"), 0, 0)]), [[]])
+
+    def testNeighboursInRadius(self):
+        radius = 0.9
+        result = self.points.neighboursInRadius(radius)
+        self.assertEqual(len(result), len(self.coords))
+        for i, pnt in enumerate(self.coords):
+            if _isFinite(pnt):
+                self.assertEqual(result[i], self.bruteRadius(pnt, radius))
+            else:
+                self.assertEqual(result[i], [])
+
+    def testThreads(self):
+        serial = self.points.nearestNeighbours(8, Threads=1)
+        parallel = self.points.nearestNeighbours(8, Threads=4)
+        self.assertEqual(serial, parallel)
+
+
+class PointsFilterTestCases(unittest.TestCase):
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("PointsFilterTest")
+        # a planar grid in local coordinates plus one far away outlier
+        pts = [FreeCAD.Vector(x * 0.5, y * 0.5, 0) for x in range(20) for y in range(20)]
+        pts.append(FreeCAD.Vector(2.5, 2.5, 50))
+        self.local = pts
+        self.source = self.doc.addObject("Points::FeatureCustom", "Source")
+        self.source.addProperty("Points::PropertyNormalList", "Normal")
+        self.source.Points = Points.Points(pts)
+        self.source.Normal = [FreeCAD.Vector(0, 0, 1)] * len(pts)
+        self.source.Placement = FreeCAD.Placement(FreeCAD.Vector(5, -3, 2),
+                                                  FreeCAD.Rotation(FreeCAD.Vector(1, 0, 0), 90))
+        self.normal = self.source.Placement.Rotation.multVec(FreeCAD.Vector(0, 0, 1))
+        self.doc.recompute()
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.doc.Name)
+
+    def testRemoveOutliers(self):
+        filt = self.doc.addObject("Points::RemoveOutliers", "RemoveOutliers")
+        filt.Source = self.source
+        self.doc.recompute()
+
+        placement = self.source.Placement
+        expected = [placement.multVec(p) for p in self.local[:400]]
+        result = filt.Points.Points
+        self.assertEqual(len(result), len(expected))
+        for p, q in zip(result, expected):
+            self.assertAlmostEqual((p - q).Length, 0.0, places=4)
+
+        self.assertEqual(len(filt.Normal), len(result))
+        for n in filt.Normal:
+            self.assertAlmostEqual((n - self.normal).Length, 0.0, places=5)
+
+    def testDownSample(self):
+        filt = self.doc.addObject("Points::DownSample", "DownSample")
+        filt.Source = self.source
+        filt.VoxelSize = 2.0
+        self.doc.recompute()
+
+        box = self.source.Points.BoundBox
+        result = filt.Points.Points
+        self.assertGreater(len(result), 1)
+        self.assertLess(len(result), 401)
+        for p in result:
+            self.assertTrue(box.isInside(p))
+
+        self.assertEqual(len(filt.Normal), len(result))
+        for n in filt.Normal:
+            self.assertAlmostEqual((n - self.normal).Length, 0.0, places=5)
+
+    def testDownSampleInvalid(self):
+        # points with inf or nan coordinates are skipped
+        inf = float("inf")
+        nan = float("nan")
+        pts = list(self.local[:400])
+        valid = self.doc.addObject("Points::Feature", "Valid")
+        valid.Points = Points.Points(pts)
+        pts += [FreeCAD.Vector(inf, 0, 0), FreeCAD.Vector(0, -inf, 0),
+                FreeCAD.Vector(0, 0, nan), FreeCAD.Vector(nan, inf, -inf)]
+        invalid = self.doc.addObject("Points::Feature", "Invalid")
+        invalid.Points = Points.Points(pts)
+
+        results = []
+        for source in (valid, invalid):
+            filt = self.doc.addObject("Points::DownSample", "DownSample")
+            filt.Source = source
+            filt.VoxelSize = 2.0
+            self.doc.recompute()
+            results.append(filt.Points.Points)
+
+        self.assertEqual(len(results[0]), len(results[1]))
+        for p, q in zip(results[0], results[1]):
+            self.assertAlmostEqual((p - q).Length, 0.0, places=6)
+
+    def testEstimateNormals(self):
+        filt = self.doc.addObject("Points::EstimateNormals", "EstimateNormals")
+        filt.Source = self.source
+        self.doc.recompute()
+
+        self.assertEqual(filt.Points.CountPoints, 401)
+        for n in filt.Normal[:400]:
+            self.assertAlmostEqual(abs(n.dot(self.normal)), 1.0, places=4)
+
+
+class PointsOctreeTestCases(unittest.TestCase):
+    def setUp(self):
+        rnd = random.Random(815)
+        self.coords = [FreeCAD.Vector(rnd.uniform(-10, 10), rnd.uniform(-10, 10), rnd.uniform(-10, 10))
+                       for _ in range(100000)]
+        self.points = Points.Points(self.coords)
+        # the frustum doesn't reach the half of the cube with y < 0
+        self.camera = dict(Position=FreeCAD.Vector(6, 6, 30), Direction=FreeCAD.Vector(0, 0, -1),
+                           Up=FreeCAD.Vector(0, 1, 0), Angle=0.25, Aspect=1.5, Near=1.0, Far=45.0)
+
+    def bruteVisible(self, coords):
+        cam = self.camera
+        direction = FreeCAD.Vector(cam["Direction"]).normalize()
+        right = direction.cross(cam["Up"]).normalize()
+        upward = right.cross(direction)
+        tanV = math.tan(0.5 * cam["Angle"])
+        tanH = cam["Aspect"] * tanV
+        visible = []
+        for i, p in enumerate(coords):
+            v = p - cam["Position"]
+            d = v.dot(direction)
+            if cam["Near"] <= d <= cam["Far"] and abs(v.dot(upward)) <= d * tanV and abs(v.dot(right)) <= d * tanH:
+                visible.append(i)
+        return visible
+
+    def testFrustum(self):
+        # without an error limit every node that intersects the frustum is selected
+        result = self.points.selectVisible(MaxError=0.0, MaxPointsPerNode=2000, **self.camera)
+        self.assertEqual(len(result), len(set(result)))
+        self.assertLess(len(result), len(self.coords))
+        visible = self.bruteVisible(self.coords)
+        self.assertGreater(len(visible), 0)
+        self.assertTrue(set(visible).issubset(result))
+
+    def testPlacement(self):
+        # the camera is given in global coordinates
+        placement = FreeCAD.Placement(FreeCAD.Vector(3, 1, -2), FreeCAD.Rotation(FreeCAD.Vector(0, 1, 1), 30))
+        self.points.Placement = placement
+        result = self.points.selectVisible(MaxError=0.0, MaxPointsPerNode=2000, **self.camera)
+        visible = self.bruteVisible(self.points.Points)
+        self.assertGreater(len(visible), 0)
+        self.assertTrue(set(visible).issubset(result))
+
+    def testBudget(self):
+        full = self.points.selectVisible(MaxError=0.0, MaxPointsPerNode=2000, **self.camera)
+        limited = self.points.selectVisible(MaxError=0.0, PointBudget=45000, MaxPointsPerNode=2000, **self.camera)
+        self.assertLessEqual(len(limited), 45000)
+        self.assertLess(len(limited), len(full))
+        self.assertTrue(set(limited).issubset(full))
+        coarse = self.points.selectVisible(MaxError=1000.0, MaxPointsPerNode=2000, **self.camera)
+        self.assertLess(len(coarse), len(limited))
+
+    def testThreads(self):
+        serial = self.points.selectVisible(Threads=1, **self.camera)
+        parallel = self.points.selectVisible(Threads=4, **self.camera)
+        self.assertEqual(serial, parallel)
+
+
+class PointsAsciiImport(unittest.TestCase):
+    def setUp(self):
+        self.name = tempfile.gettempdir() + os.sep + "points_import."
+
+    def writeText(self, ext, text):
+        name = self.name + ext
+        with open(name, "w", newline="") as f:
+            f.write(text)
+        return name
+
+    def readText(self, ext, text):
+        name = self.writeText(ext, text)
+        points = Points.Points()
+        points.read(name)
+        os.remove(name)
+        return points
+
+    def testAsc(self):
+        text = "# comment\r\n" \
+               "1 2 3\r\n" \
+               "\r\n" \
+               "  -1.5e0\t+2.5 0.25 255 0 0\r\n" \
+               "not a point\r\n" \
+               "4 5\r\n" \
+               "7 8 9"
+        points = self.readText("asc", text)
+        self.assertEqual(points.Points, [FreeCAD.Vector(1, 2, 3),
+                                         FreeCAD.Vector(-1.5, 2.5, 0.25),
+                                         FreeCAD.Vector(7, 8, 9)])
+
+    def testLargeAsc(self):
+        # more than one chunk, the points must keep the order of the file
+        count = 300000
+        lines = ["{} {} {}\n".format(i, i % 7, -i) if i % 1000 else "# line {}\n".format(i)
+                 for i in range(count)]
+        points = self.readText("asc", "".join(lines))
+        expected = [i for i in range(count) if i % 1000]
+        self.assertEqual(points.CountPoints, len(expected))
+        pts = points.Points
+        for i in (0, 1, len(expected) // 2, len(expected) - 1):
+            self.assertEqual(pts[i], FreeCAD.Vector(expected[i], expected[i] % 7, -expected[i]))
+        self.assertEqual(sum(p.x for p in pts), sum(expected))
+
+    def testAsciiPly(self):
+        count = 100000
+        header = "ply\n" \
+                 "format ascii 1.0\n" \
+                 "comment test\n" \
+                 "element vertex {}\n" \
+                 "property float x\n" \
+                 "property float y\n" \
+                 "property float z\n" \
+                 "property float nx\n" \
+                 "property float ny\n" \
+                 "property float nz\n" \
+                 "end_header\n".format(count)
+        lines = ["{} {} 0 0 0 1\n".format(i, i % 10) for i in range(count)]
+        name = self.writeText("ply", header + "".join(lines))
+        doc = FreeCAD.newDocument("PointsAsciiImport")
+        try:
+            Points.insert(name, doc.Name)
+            feature = doc.Objects[0]
+            self.assertEqual(feature.Points.CountPoints, count)
+            pts = feature.Points.Points
+            for i in (0, count // 3, count - 1):
+                self.assertEqual(pts[i], FreeCAD.Vector(i, i % 10, 0))
+            self.assertEqual(len(feature.Normal), count)
+            self.assertEqual(feature.Normal[count // 2], FreeCAD.Vector(0, 0, 1))
+        finally:
+            FreeCAD.closeDocument(doc.Name)
+            os.remove(name)
@@ -23,6 +23,11 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <Geom_BSplineSurface.hxx>
+# include <Geom_ConicalSurface.hxx>
+# include <Geom_CylindricalSurface.hxx>
+# include <Geom_Plane.hxx>
+# include <Geom_SphericalSurface.hxx>
+# include <gp_Ax3.hxx>
 # include <TColgp_Array1OfPnt.hxx>
 #endif
 
@@ -31,6 +36,7 @@
 #include <Base/GeometryPyCXX.h>
 #include <Base/Interpreter.h>
 #include <Mod/Part/App/BSplineSurfacePy.h>
+#include <Mod/Part/App/Geometry.h>
 #include <Mod/Mesh/App/MeshPy.h>
 #include <Mod/Points/App/PointsPy.h>
 #if defined(HAVE_PCL_FILTERS)
@@ -41,6 +47,8 @@
 
 #include "ApproxSurface.h"
 #include "BSplineFitting.h"
+#include "ImplicitReconstruction.h"
+#include "PrimitiveDetection.h"
 #include "RegionGrowing.h"
 #include "SampleConsensus.h"
 #include "Segmentation.h"
@@ -93,6 +101,35 @@ public:
             "UVDirs: set the u,v parameter directions as tuple of two vectors\n"
             "        If not set then they will be determined by computing a best-fit plane\n"
         );
+        add_keyword_method("detectPrimitives",&Module::detectPrimitives,
+            "detectPrimitives(Points,[Normals, Types, Epsilon=0.01, Deviation=20, MinSupport=100,\n"
+            "                 Probability=0.01, MaxShapes=0, ClusterEpsilon=0, Threads=0, Seed=0]) -> list\n"
+            "Extracts planes, spheres, cylinders and cones from a point cloud.\n"
+            "Normals is an optional list of vectors; if omitted the normals are estimated.\n"
+            "Types is a list of the names 'Plane', 'Sphere', 'Cylinder' and 'Cone'.\n"
+            "Epsilon is the maximum distance of a point to a shape and Deviation the\n"
+            "maximum angle in degrees between the point normal and the shape normal.\n"
+            "MinSupport is the minimum number of points of a shape and Probability the\n"
+            "probability to overlook the largest shape. MaxShapes limits the number of shapes\n"
+            "and ClusterEpsilon > 0 keeps only the largest connected part of each shape.\n"
+            "The result only depends on Seed, not on the number of threads.\n"
+            "Each shape is a dict with the keys 'Type', 'Model' (point indices),\n"
+            "'Parameters' and 'Surface'.\n"
+            "Example:\n"
+            "\n"
+            "import ReverseEngineering as Reen\n"
+            "pts=App.ActiveDocument.ActiveObject.Points\n"
+            "for shape in Reen.detectPrimitives(pts, Epsilon=0.05):\n"
+            "    Part.show(shape['Surface'].toShape())\n"
+        );
+        add_keyword_method("implicitReconstruction",&Module::implicitReconstruction,
+            "implicitReconstruction(Points,[KSearch=10, CellSize=0, NearestNeighbors=8, Threads=0, Normals]) -> Mesh\n"
+            "Creates a mesh from the zero level set of the signed distance to the tangent planes\n"
+            "of the points. The normals must point to the outside, if they are omitted they are\n"
+            "estimated and oriented with the KSearch nearest neighbours. CellSize is the grid\n"
+            "resolution, with 0 it's three times the mean distance between neighbouring points.\n"
+            "NearestNeighbors is the number of points to evaluate the distance function."
+        );
 #if defined(HAVE_PCL_SURFACE)
         add_keyword_method("triangulate",&Module::triangulate,
             "triangulate(PointKernel,searchRadius[,mu=2.5])."
@@ -286,6 +323,173 @@ private:
             throw Py::RuntimeError("Unknown C++ exception");
         }
     }
+
+    Py::Object implicitReconstruction(const Py::Tuple& args, const Py::Dict& kwds)
+    {
+        PyObject *pts;
+        PyObject *vec = nullptr;
+        int ksearch = 10;
+        double cellSize = 0.0;
+        int neighbours = 8;
+        int threads = 0;
+
+        static char* kwds_implicit[] = {"Points", "KSearch", "CellSize", "NearestNeighbors",
+                                        "Threads", "Normals", nullptr};
+        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|idiiO", kwds_implicit,
+                                        &(Points::PointsPy::Type), &pts,
+                                        &ksearch, &cellSize, &neighbours, &threads, &vec))
+            throw Py::Exception();
+
+        if (cellSize < 0.0)
+            throw Py::ValueError("CellSize must not be negative");
+        if (neighbours < 1)
+            throw Py::ValueError("NearestNeighbors must be positive");
+
+        Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
+
+        std::unique_ptr<Mesh::MeshObject> mesh(new Mesh::MeshObject());
+        Reen::ImplicitReconstruction implicit(*points, *mesh);
+        implicit.setCellSize(cellSize);
+        implicit.setNearestNeighbors(static_cast<unsigned long>(neighbours));
+        implicit.setThreads(threads);
+        try {
+            if (vec && vec != Py_None) {
+                Py::Sequence list(vec);
+                std::vector<Base::Vector3f> normals;
+                normals.reserve(list.size());
+                for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+                    Base::Vector3d v = Py::Vector(*it).toVector();
+                    normals.push_back(Base::convertTo<Base::Vector3f>(v));
+                }
+                implicit.perform(normals);
+            }
+            else {
+                implicit.perform(ksearch);
+            }
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
+
+        return Py::asObject(new Mesh::MeshPy(mesh.release()));
+    }
+
+    Py::Object detectPrimitives(const Py::Tuple& args, const Py::Dict& kwds)
+    {
+        PyObject *pts;
+        PyObject *vec = nullptr;
+        PyObject *typ = nullptr;
+        double epsilon = 0.01;
+        double deviation = 20.0;
+        int minSupport = 100;
+        double probability = 0.01;
+        int maxShapes = 0;
+        double clusterEpsilon = 0.0;
+        int threads = 0;
+        unsigned int seed = 0;
+
+        static char* kwds_detect[] = {"Points", "Normals", "Types", "Epsilon", "Deviation",
+                                      "MinSupport", "Probability", "MaxShapes", "ClusterEpsilon",
+                                      "Threads", "Seed", nullptr};
+        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|OOddidiidiI", kwds_detect,
+                                        &(Points::PointsPy::Type), &pts, &vec, &typ,
+                                        &epsilon, &deviation, &minSupport, &probability,
+                                        &maxShapes, &clusterEpsilon, &threads, &seed))
+            throw Py::Exception();
+
+        if (epsilon <= 0.0)
+            throw Py::ValueError("Epsilon must be positive");
+        if (deviation <= 0.0 || deviation > 90.0)
+            throw Py::ValueError("Value of Deviation out of range (0,90]");
+        if (probability <= 0.0 || probability >= 1.0)
+            throw Py::ValueError("Value of Probability out of range (0,1)");
+        if (minSupport < 3 || maxShapes < 0 || threads < 0)
+            throw Py::ValueError("Invalid number of points, shapes or threads");
+
+        const std::string names[] = {"Plane", "Sphere", "Cylinder", "Cone"};
+        Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
+        std::vector<Base::Vector3f> normals;
+        if (vec && vec != Py_None) {
+            Py::Sequence list(vec);
+            normals.reserve(list.size());
+            for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+                Base::Vector3d v = Py::Vector(*it).toVector();
+                normals.push_back(Base::convertTo<Base::Vector3f>(v));
+            }
+            if (normals.size() != points->size())
+                throw Py::ValueError("Number of normals does not match number of points");
+        }
+
+        PrimitiveDetection detection(*points, normals);
+        if (typ && typ != Py_None) {
+            std::vector<PrimitiveDetection::PrimitiveType> types;
+            Py::Sequence list(typ);
+            for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+                std::string name = Py::String(*it).as_std_string();
+                auto pos = std::find(std::begin(names), std::end(names), name);
+                if (pos == std::end(names))
+                    throw Py::ValueError("Unknown primitive type: " + name);
+                types.push_back(static_cast<PrimitiveDetection::PrimitiveType>(pos - std::begin(names)));
+            }
+            detection.setTypes(types);
+        }
+        detection.setEpsilon(epsilon);
+        detection.setNormalDeviation(Base::toRadians<double>(deviation));
+        detection.setMinSupport(static_cast<unsigned long>(minSupport));
+        detection.setProbability(probability);
+        detection.setMaxPrimitives(static_cast<std::size_t>(maxShapes));
+        detection.setClusterEpsilon(clusterEpsilon);
+        detection.setThreads(threads);
+        detection.setSeed(seed);
+
+        std::vector<PrimitiveDetection::Primitive> primitives;
+        try {
+            detection.perform(primitives);
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
+
+        Py::List list;
+        for (const auto& it : primitives) {
+            gp_Ax3 ax3(gp_Pnt(it.base.x, it.base.y, it.base.z),
+                       gp_Dir(it.axis.x, it.axis.y, it.axis.z));
+
+            std::unique_ptr<Part::GeomSurface> surface;
+            Py::Tuple parameters;
+            switch (it.type) {
+            case PrimitiveDetection::Plane:
+                surface = std::make_unique<Part::GeomPlane>(new Geom_Plane(ax3));
+                parameters = Py::TupleN(Py::Vector(it.base), Py::Vector(it.axis));
+                break;
+            case PrimitiveDetection::Sphere:
+                surface = std::make_unique<Part::GeomSphere>(new Geom_SphericalSurface(ax3, it.radius));
+                parameters = Py::TupleN(Py::Vector(it.base), Py::Float(it.radius));
+                break;
+            case PrimitiveDetection::Cylinder:
+                surface = std::make_unique<Part::GeomCylinder>(new Geom_CylindricalSurface(ax3, it.radius));
+                parameters = Py::TupleN(Py::Vector(it.base), Py::Vector(it.axis), Py::Float(it.radius));
+                break;
+            case PrimitiveDetection::Cone:
+                surface = std::make_unique<Part::GeomCone>(new Geom_ConicalSurface(ax3, it.angle, 0.0));
+                parameters = Py::TupleN(Py::Vector(it.base), Py::Vector(it.axis), Py::Float(it.angle));
+                break;
+            }
+
+            Py::Tuple model(it.inliers.size());
+            for (std::size_t i = 0; i < it.inliers.size(); i++)
+                model.setItem(i, Py::Long(static_cast<unsigned long>(it.inliers[i])));
+
+            Py::Dict dict;
+            dict.setItem(Py::String("Type"), Py::String(names[it.type]));
+            dict.setItem(Py::String("Model"), model);
+            dict.setItem(Py::String("Parameters"), parameters);
+            dict.setItem(Py::String("Surface"), Py::asObject(surface->getPyObject()));
+            list.append(dict);
+        }
+
+        return list;
+    }
 #if defined(HAVE_PCL_SURFACE)
     /*
 import ReverseEngineering as Reen
@@ -22,25 +22,25 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
-# include <QFuture>
-# include <QFutureWatcher>
-# include <QtConcurrentMap>
+# include <limits>
+# include <mutex>
 
 # include <Geom_BSplineSurface.hxx>
-# include <math_Gauss.hxx>
-# include <math_Householder.hxx>
+# include <math_Matrix.hxx>
 # include <Precision.hxx>
 #endif
 
+#include <Eigen/SparseCholesky>
+
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
 #include <Mod/Mesh/App/Core/Approximation.h>
+#include <Mod/Mesh/App/Core/Functional.h>
 
 #include "ApproxSurface.h"
 
 
 using namespace Reen;
-namespace bp = boost::placeholders;
 
 // SplineBasisfunction
 
@@ -768,14 +768,10 @@ BSplineParameterCorrection::BSplineParameterCorrection(unsigned usUOrder, unsign
   : ParameterCorrection(usUOrder, usVOrder, usUCtrlpoints, usVCtrlpoints)
   , _clUSpline(usUCtrlpoints+usUOrder)
   , _clVSpline(usVCtrlpoints+usVOrder)
-  , _clSmoothMatrix(0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
-  , _clFirstMatrix (0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
-  , _clSecondMatrix(0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
-  , _clThirdMatrix (0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
+  , _clSmoothMatrix(usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
+  , _clFirstMatrix (usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
+  , _clSecondMatrix(usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
+  , _clThirdMatrix (usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
 {
     Init();
 }
@@ -785,10 +781,10 @@ void BSplineParameterCorrection::Init()
     // Initializations
     _pvcUVParam       = nullptr;
     _pvcPoints        = nullptr;
-    _clFirstMatrix.Init(0.0);
-    _clSecondMatrix.Init(0.0);
-    _clThirdMatrix.Init(0.0);
-    _clSmoothMatrix.Init(0.0);
+    _clFirstMatrix.setZero();
+    _clSecondMatrix.setZero();
+    _clThirdMatrix.setZero();
+    _clSmoothMatrix.setZero();
 
     /* Calculate the knot vectors */
     unsigned usUMax = _usUCtrlpoints-_usUOrder+1;
@@ -864,7 +860,7 @@ void BSplineParameterCorrection::DoParameterCorrection(int iIter)
     double fMaxDiff=0.0, fMaxScalar=1.0;
     double fWeight = _fSmoothInfluence;
 
-    Base::SequencerLauncher seq("Calc surface...", iIter*_pvcPoints->Length());
+    Base::SequencerLauncher seq("Calc surface...", iIter);
 
     do {
         fMaxScalar = 1.0;
@@ -873,48 +869,61 @@ void BSplineParameterCorrection::DoParameterCorrection(int iIter)
         Handle(Geom_BSplineSurface) pclBSplineSurf = new Geom_BSplineSurface(_vCtrlPntsOfSurf,
                                                     _vUKnots, _vVKnots, _vUMults, _vVMults, _usUOrder-1, _usVOrder-1);
 
-        for (int ii=_pvcPoints->Lower();ii <=_pvcPoints->Upper();ii++) {
-            double fDeltaU, fDeltaV, fU, fV;
-            const gp_Pnt& pnt = (*_pvcPoints)(ii);
-            gp_Vec P(pnt.X(), pnt.Y(), pnt.Z());
-            gp_Pnt PntX;
-            gp_Vec Xu, Xv, Xuv, Xuu, Xvv;
-            // Calculate the first two derivatives and point at (u,v)
-            gp_Pnt2d& uvValue = (*_pvcUVParam)(ii);
-            pclBSplineSurf->D2(uvValue.X(), uvValue.Y(), PntX, Xu, Xv, Xuu, Xvv, Xuv);
-            gp_Vec X(PntX.X(), PntX.Y(), PntX.Z());
-            gp_Vec ErrorVec = X - P;
-
-            // Calculate Xu x Xv the normal in X(u,v)
-            gp_Dir clNormal = Xu ^ Xv;
-
-            //Check, if X = P
-            if (!(X.IsEqual(P,0.001,0.001))) {
-                ErrorVec.Normalize();
-                if (fabs(clNormal*ErrorVec) < fMaxScalar)
-                    fMaxScalar = fabs(clNormal*ErrorVec);
-            }
+        // The points are corrected independently of each other. The evaluation of the
+        // surface doesn't modify it so that it can be shared between the threads.
+        std::mutex mutex;
+        int iLower = _pvcPoints->Lower();
+        MeshCore::parallel_for(static_cast<std::size_t>(_pvcPoints->Length()), 0,
+                               [&](std::size_t begin, std::size_t end) {
+            double fChunkDiff = 0.0, fChunkScalar = 1.0;
+            for (std::size_t n = begin; n < end; n++) {
+                int ii = iLower + static_cast<int>(n);
+                double fDeltaU, fDeltaV, fU, fV;
+                const gp_Pnt& pnt = (*_pvcPoints)(ii);
+                gp_Vec P(pnt.X(), pnt.Y(), pnt.Z());
+                gp_Pnt PntX;
+                gp_Vec Xu, Xv, Xuv, Xuu, Xvv;
+                // Calculate the first two derivatives and point at (u,v)
+                gp_Pnt2d& uvValue = (*_pvcUVParam)(ii);
+                pclBSplineSurf->D2(uvValue.X(), uvValue.Y(), PntX, Xu, Xv, Xuu, Xvv, Xuv);
+                gp_Vec X(PntX.X(), PntX.Y(), PntX.Z());
+                gp_Vec ErrorVec = X - P;
+
+                // Calculate Xu x Xv the normal in X(u,v)
+                gp_Vec clNormal = Xu ^ Xv;
+                double fLength = clNormal.Magnitude();
+
+                //Check, if X = P
+                if (!(X.IsEqual(P,0.001,0.001)) && fLength > gp::Resolution()) {
+                    clNormal /= fLength;
+                    ErrorVec.Normalize();
+                    if (fabs(clNormal*ErrorVec) < fChunkScalar)
+                        fChunkScalar = fabs(clNormal*ErrorVec);
+                }
 
-            fDeltaU =  ( (P-X) * Xu ) / ( (P-X)*Xuu - Xu*Xu );
-            if (fabs(fDeltaU) < Precision::Confusion())
-                fDeltaU = 0.0;
-            fDeltaV =  ( (P-X) * Xv ) / ( (P-X)*Xvv - Xv*Xv );
-            if (fabs(fDeltaV) < Precision::Confusion())
-                fDeltaV = 0.0;
-
-            //Replace old u/v values with new ones
-            fU = uvValue.X() - fDeltaU;
-            fV = uvValue.Y() - fDeltaV;
-            if (fU <= 1.0 && fU >= 0.0 &&
-                fV <= 1.0 && fV >= 0.0) {
-                uvValue.SetX(fU);
-                uvValue.SetY(fV);
-                fMaxDiff = std::max<double>(fabs(fDeltaU), fMaxDiff);
-                fMaxDiff = std::max<double>(fabs(fDeltaV), fMaxDiff);
+                fDeltaU =  ( (P-X) * Xu ) / ( (P-X)*Xuu - Xu*Xu );
+                if (fabs(fDeltaU) < Precision::Confusion())
+                    fDeltaU = 0.0;
+                fDeltaV =  ( (P-X) * Xv ) / ( (P-X)*Xvv - Xv*Xv );
+                if (fabs(fDeltaV) < Precision::Confusion())
+                    fDeltaV = 0.0;
+
+                //Replace old u/v values with new ones
+                fU = uvValue.X() - fDeltaU;
+                fV = uvValue.Y() - fDeltaV;
+                if (fU <= 1.0 && fU >= 0.0 &&
+                    fV <= 1.0 && fV >= 0.0) {
+                    uvValue.SetX(fU);
+                    uvValue.SetY(fV);
+                    fChunkDiff = std::max<double>(fabs(fDeltaU), fChunkDiff);
+                    fChunkDiff = std::max<double>(fabs(fDeltaV), fChunkDiff);
+                }
             }
 
-            seq.next();
-        }
+            std::lock_guard<std::mutex> lock(mutex);
+            fMaxScalar = std::min<double>(fChunkScalar, fMaxScalar);
+            fMaxDiff = std::max<double>(fChunkDiff, fMaxDiff);
+        });
 
         if (_bSmoothing) {
             fWeight *= 0.5f;
@@ -924,79 +933,163 @@ void BSplineParameterCorrection::DoParameterCorrection(int iIter)
             SolveWithoutSmoothing();
         }
 
+        seq.next();
         i++;
     }
     while(i<iIter && fMaxDiff > Precision::Confusion() && fMaxScalar < 0.99);
 }
 
-bool BSplineParameterCorrection::SolveWithoutSmoothing()
+namespace {
+/**
+ * Evaluates the basis functions that do not vanish at \a fParam and returns the
+ * index of the first of them, or -1 if \a fParam is outside the knot vector.
+ */
+int NonZeroBasisFunctions(BSplineBasis& spline, const TColStd_Array1OfReal& knots,
+                          double fParam, TColStd_Array1OfReal& values)
 {
-    unsigned ulSize = _pvcPoints->Length();
-    unsigned ulDim  = _usUCtrlpoints*_usVCtrlpoints;
-    math_Matrix M  (0, ulSize-1, 0, ulDim-1);
-    math_Matrix Xx (0, ulDim-1, 0, 0);
-    math_Matrix Xy (0, ulDim-1, 0, 0);
-    math_Matrix Xz (0, ulDim-1, 0, 0);
-    math_Vector bx (0, ulSize-1);
-    math_Vector by (0, ulSize-1);
-    math_Vector bz (0, ulSize-1);
-
-    // Determining the coefficient matrix of the overdetermined LGS
-    for (unsigned i=0; i<ulSize; i++) {
-        const gp_Pnt2d& uvValue = (*_pvcUVParam)(i);
-        double fU = uvValue.X();
-        double fV = uvValue.Y();
-        unsigned ulIdx=0;
-
-        // Pre-calculation of the values of the base functions
-        std::vector<double> basisU(_usUCtrlpoints);
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            basisU[j] = _clUSpline.BasisFunction(j,fU);
-        }
-        std::vector<double> basisV(_usVCtrlpoints);
-        for (unsigned k=0; k<_usVCtrlpoints; k++) {
-            basisV[k] = _clVSpline.BasisFunction(k,fV);
-        }
+    if (!(fParam >= knots(knots.Lower()) && fParam <= knots(knots.Upper())))
+        return -1;
+    spline.AllBasisFunctions(fParam, values);
+    return spline.FindSpan(fParam) - values.Length() + 1;
+}
 
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            double valueU = basisU[j];
-            if (valueU == 0.0) {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = 0.0;
-                    ulIdx++;
+/// Minimum number of points whose products are summed up in one block
+const std::size_t BlockSize = 16384;
+/// Maximum number of blocks, each of them needs its own copy of the system
+const std::size_t MaxBlocks = 32;
+}
+
+void BSplineParameterCorrection::CalcNormalEquations(Eigen::SparseMatrix<double>& MTM, Eigen::MatrixX3d& MTb)
+{
+    const int iUOrder = static_cast<int>(_usUOrder);
+    const int iVOrder = static_cast<int>(_usVOrder);
+    const int iUCtrl  = static_cast<int>(_usUCtrlpoints);
+    const int iVCtrl  = static_cast<int>(_usVCtrlpoints);
+    const int iDim    = iUCtrl*iVCtrl;
+
+    // Two control points only interact if their basis functions overlap. So, each row
+    // of M^T*M has at most (2*UOrder-1)*(2*VOrder-1) non-zero entries that are stored
+    // by their offset to the diagonal.
+    const int iBandU = 2*iUOrder-1;
+    const int iBandV = 2*iVOrder-1;
+    const int iBand  = iBandU*iBandV;
+
+    // The points are split into blocks that only depend on the number of points. The
+    // blocks are summed up in order afterwards so that the result doesn't depend on
+    // the number of threads.
+    const std::size_t numPoints = static_cast<std::size_t>(_pvcPoints->Length());
+    const std::size_t numBlocks = std::max<std::size_t>(1,
+        std::min(MaxBlocks, (numPoints + BlockSize - 1) / BlockSize));
+    const std::size_t blockLength = (numPoints + numBlocks - 1) / numBlocks;
+    std::vector< std::vector<double> > bands(numBlocks);
+    std::vector< std::vector<double> > sides(numBlocks);
+
+    const int iLower = _pvcPoints->Lower();
+    MeshCore::parallel_for(numBlocks, 0, [&](std::size_t blockBegin, std::size_t blockEnd) {
+        TColStd_Array1OfReal basisU(0, iUOrder-1);
+        TColStd_Array1OfReal basisV(0, iVOrder-1);
+        std::vector<double> values(iUOrder*iVOrder);
+        for (std::size_t block = blockBegin; block < blockEnd; block++) {
+            std::vector<double>& band = bands[block];
+            std::vector<double>& side = sides[block];
+            band.resize(iDim*iBand, 0.0);
+            side.resize(iDim*3, 0.0);
+
+            std::size_t end = std::min(numPoints, (block + 1) * blockLength);
+            for (std::size_t n = block * blockLength; n < end; n++) {
+                int ii = iLower + static_cast<int>(n);
+                const gp_Pnt2d& uvValue = (*_pvcUVParam)(ii);
+                int iFirstU = NonZeroBasisFunctions(_clUSpline, _vUKnots, uvValue.X(), basisU);
+                int iFirstV = NonZeroBasisFunctions(_clVSpline, _vVKnots, uvValue.Y(), basisV);
+                if (iFirstU < 0 || iFirstV < 0)
+                    continue;
+
+                for (int a=0; a<iUOrder; a++) {
+                    for (int b=0; b<iVOrder; b++)
+                        values[a*iVOrder+b] = basisU(a) * basisV(b);
                 }
-            }
-            else {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = valueU * basisV[k];
-                    ulIdx++;
+
+                const gp_Pnt& pnt = (*_pvcPoints)(ii);
+                for (int a=0; a<iUOrder; a++) {
+                    for (int b=0; b<iVOrder; b++) {
+                        double fValue = values[a*iVOrder+b];
+                        if (fValue == 0.0)
+                            continue;
+
+                        int row = (iFirstU+a)*iVCtrl + iFirstV+b;
+                        side[row*3  ] += fValue * pnt.X();
+                        side[row*3+1] += fValue * pnt.Y();
+                        side[row*3+2] += fValue * pnt.Z();
+
+                        double* entries = &band[row*iBand];
+                        for (int c=0; c<iUOrder; c++) {
+                            int offset = (c-a+iUOrder-1)*iBandV - b + iVOrder-1;
+                            for (int d=0; d<iVOrder; d++)
+                                entries[offset+d] += fValue * values[c*iVOrder+d];
+                        }
+                    }
                 }
             }
         }
+    });
+
+    // Sum up the blocks
+    std::vector<double> band(iDim*iBand, 0.0);
+    MTb.setZero(iDim, 3);
+    for (std::size_t block = 0; block < numBlocks; block++) {
+        const std::vector<double>& part = bands[block];
+        for (std::size_t n = 0; n < part.size(); n++)
+            band[n] += part[n];
+        const std::vector<double>& side = sides[block];
+        for (int row = 0; row < iDim; row++) {
+            MTb(row, 0) += side[row*3  ];
+            MTb(row, 1) += side[row*3+1];
+            MTb(row, 2) += side[row*3+2];
+        }
     }
 
-    // Determine the right side
-    for (int ii=_pvcPoints->Lower(); ii<=_pvcPoints->Upper(); ii++) {
-        const gp_Pnt& pnt = (*_pvcPoints)(ii);
-        bx(ii) = pnt.X(); by(ii) = pnt.Y(); bz(ii) = pnt.Z();
+    std::vector< Eigen::Triplet<double> > triplets;
+    triplets.reserve(iDim*iBand);
+    for (int row = 0; row < iDim; row++) {
+        int iU = row / iVCtrl;
+        int iV = row % iVCtrl;
+        for (int du = 0; du < iBandU; du++) {
+            int iColU = iU + du - iUOrder + 1;
+            if (iColU < 0 || iColU >= iUCtrl)
+                continue;
+            for (int dv = 0; dv < iBandV; dv++) {
+                int iColV = iV + dv - iVOrder + 1;
+                if (iColV < 0 || iColV >= iVCtrl)
+                    continue;
+                triplets.emplace_back(row, iColU*iVCtrl + iColV, band[row*iBand + du*iBandV + dv]);
+            }
+        }
     }
 
-    // Solve the over-determined LGS with Householder-Transformation
-    math_Householder hhX(M,bx);
-    math_Householder hhY(M,by);
-    math_Householder hhZ(M,bz);
+    MTM.resize(iDim, iDim);
+    MTM.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+bool BSplineParameterCorrection::SolveNormalEquations(const Eigen::SparseMatrix<double>& A,
+                                                      const Eigen::MatrixX3d& b)
+{
+    Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > solver(A);
+    if (solver.info() != Eigen::Success)
+        return false;
+
+    // A vanishing pivot means that some control points are not determined by the data
+    const Eigen::VectorXd& pivots = solver.vectorD();
+    if (!(pivots.minCoeff() > std::numeric_limits<double>::epsilon() * pivots.maxCoeff()))
+        return false;
 
-    if (!(hhX.IsDone() && hhY.IsDone() && hhZ.IsDone()))
-        // LGS could not be solved
+    Eigen::MatrixX3d X = solver.solve(b);
+    if (solver.info() != Eigen::Success)
         return false;
-    Xx = hhX.AllValues();
-    Xy = hhY.AllValues();
-    Xz = hhZ.AllValues();
 
     unsigned ulIdx=0;
     for (unsigned j=0;j<_usUCtrlpoints;j++) {
         for (unsigned k=0;k<_usVCtrlpoints;k++) {
-            _vCtrlPntsOfSurf(j,k) = gp_Pnt(Xx(ulIdx,0),Xy(ulIdx,0),Xz(ulIdx,0));
+            _vCtrlPntsOfSurf(j,k) = gp_Pnt(X(ulIdx,0),X(ulIdx,1),X(ulIdx,2));
             ulIdx++;
         }
     }
@@ -1004,153 +1097,90 @@ bool BSplineParameterCorrection::SolveWithoutSmoothing()
     return true;
 }
 
-namespace Reen {
-class ScalarProduct
+bool BSplineParameterCorrection::SolveWithoutSmoothing()
 {
-public:
-    explicit ScalarProduct(const math_Matrix& mat) : mat(mat)
-    {
-    }
-    std::vector<double> multiply(int col) const
-    {
-        math_Vector vec = mat.Col(col);
-        std::vector<double> out(mat.ColNumber());
-        for (int n=mat.LowerCol(); n<=mat.UpperCol(); n++) {
-            out[n] = vec * mat.Col(n);
-        }
-        return out;
-    }
-
-private:
-    const math_Matrix& mat;
-};
+    // Instead of the over-determined system M*X = b the normal equations
+    // M^T*M*X = M^T*b are solved that are small and sparse
+    Eigen::SparseMatrix<double> MTM;
+    Eigen::MatrixX3d MTb;
+    CalcNormalEquations(MTM, MTb);
+    return SolveNormalEquations(MTM, MTb);
 }
 
 bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
 {
-    unsigned ulSize = _pvcPoints->Length();
-    unsigned ulDim  = _usUCtrlpoints*_usVCtrlpoints;
-    math_Matrix M  (0, ulSize-1, 0, ulDim-1);
-    math_Vector Xx (0, ulDim-1);
-    math_Vector Xy (0, ulDim-1);
-    math_Vector Xz (0, ulDim-1);
-    math_Vector bx (0, ulSize-1);
-    math_Vector by (0, ulSize-1);
-    math_Vector bz (0, ulSize-1);
-    math_Vector Mbx(0, ulDim-1);
-    math_Vector Mby(0, ulDim-1);
-    math_Vector Mbz(0, ulDim-1);
-
-    // Determining the coefficient matrix of the overdetermined LGS
-    for (unsigned i=0; i<ulSize; i++) {
-        const gp_Pnt2d& uvValue = (*_pvcUVParam)(i);
-        double fU = uvValue.X();
-        double fV = uvValue.Y();
-        int ulIdx=0;
-
-        // Pre-calculation of the values of the basis functions
-        std::vector<double> basisU(_usUCtrlpoints);
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            basisU[j] = _clUSpline.BasisFunction(j,fU);
-        }
-        std::vector<double> basisV(_usVCtrlpoints);
-        for (unsigned k=0; k<_usVCtrlpoints; k++) {
-            basisV[k] = _clVSpline.BasisFunction(k,fV);
-        }
-
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            double valueU = basisU[j];
-            if (valueU == 0.0) {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = 0.0;
-                    ulIdx++;
-                }
-            }
-            else {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = valueU * basisV[k];
-                    ulIdx++;
-                }
-            }
-        }
-    }
-
-    // The product of its transform and itself results in the quadratic
-    // system matrix (slowly)
-#if 0
-    math_Matrix MTM = M.TMultiply(M);
-#elif 0
-    math_Matrix MTM(0, ulDim-1, 0, ulDim-1);
-    for (unsigned m=0; m<ulDim; m++) {
-        math_Vector Mm = M.Col(m);
-        for (unsigned n=m; n<ulDim; n++) {
-            MTM(m,n) = MTM(n,m) = Mm * M.Col(n);
-        }
-    }
-#else // multi-threaded
-    std::vector<int> columns(ulDim);
-    std::generate(columns.begin(), columns.end(), Base::iotaGen<int>(0));
-    ScalarProduct scalar(M);
-    QFuture< std::vector<double> > future = QtConcurrent::mapped
-        (columns, boost::bind(&ScalarProduct::multiply, &scalar, bp::_1));
-    QFutureWatcher< std::vector<double> > watcher;
-    watcher.setFuture(future);
-    watcher.waitForFinished();
-
-    math_Matrix MTM(0, ulDim-1, 0, ulDim-1);
-    int rowIndex=0;
-    for (QFuture< std::vector<double> >::const_iterator it = future.begin(); it != future.end(); ++it) {
-        int colIndex=0;
-        for (std::vector<double>::const_iterator jt = it->begin(); jt != it->end(); ++jt, colIndex++)
-            MTM(rowIndex, colIndex) = *jt;
-        rowIndex++;
-    }
-#endif
+    Eigen::SparseMatrix<double> MTM;
+    Eigen::MatrixX3d MTb;
+    CalcNormalEquations(MTM, MTb);
+    Eigen::SparseMatrix<double> A = MTM + fWeight*_clSmoothMatrix;
+    return SolveNormalEquations(A, MTb);
+}
 
-    // Determine the right side
-    for (int ii=_pvcPoints->Lower(); ii<=_pvcPoints->Upper(); ii++) {
-        const gp_Pnt& pnt = (*_pvcPoints)(ii);
-        bx(ii) = pnt.X(); by(ii) = pnt.Y(); bz(ii) = pnt.Z();
-    }
-    for (unsigned i=0; i<ulDim; i++) {
-        math_Vector Mi = M.Col(i);
-        Mbx(i) = Mi * bx;
-        Mby(i) = Mi * by;
-        Mbz(i) = Mi * bz;
+namespace {
+/**
+ * Tabulates the integrals of the products of the r-th and s-th derivatives of
+ * two basis functions. Only basis functions with overlapping support are integrated,
+ * all others are zero.
+ */
+std::vector<double> IntegralTable(BSplineBasis& spline, int iCount, int iOrder, int r, int s)
+{
+    std::vector<double> table(iCount*iCount, 0.0);
+    for (int i=0; i<iCount; i++) {
+        int iEnd = std::min(iCount, i+iOrder);
+        for (int k=std::max(0, i-iOrder+1); k<iEnd; k++)
+            table[i*iCount+k] = spline.GetIntegralOfProductOfBSplines(i,k,r,s);
     }
+    return table;
+}
 
-    // Solve the LGS with the LU decomposition
-    math_Gauss mgGaussX(MTM+fWeight*_clSmoothMatrix);
-    math_Gauss mgGaussY(MTM+fWeight*_clSmoothMatrix);
-    math_Gauss mgGaussZ(MTM+fWeight*_clSmoothMatrix);
-
-    mgGaussX.Solve(Mbx,Xx);
-    if (!mgGaussX.IsDone())
-        return false;
-
-    mgGaussY.Solve(Mby,Xy);
-    if (!mgGaussY.IsDone())
-        return false;
-
-    mgGaussZ.Solve(Mbz,Xz);
-    if (!mgGaussZ.IsDone())
-        return false;
+/**
+ * A smoothing term is the weighted product of an integral table in u- and v-direction.
+ */
+struct SmoothingTerm
+{
+    double weight;
+    std::vector<double> u;
+    std::vector<double> v;
+};
 
-    unsigned ulIdx=0;
-    for (unsigned j=0;j<_usUCtrlpoints;j++) {
-        for (unsigned k=0;k<_usVCtrlpoints;k++) {
-            _vCtrlPntsOfSurf(j,k) = gp_Pnt(Xx(ulIdx),Xy(ulIdx),Xz(ulIdx));
-            ulIdx++;
+/**
+ * Assembles the matrix of smoothing functionals as sum of the given terms.
+ */
+void CalcSmoothMatrix(const std::vector<SmoothingTerm>& terms,
+                      int iUCtrl, int iVCtrl, int iUOrder, int iVOrder,
+                      Eigen::SparseMatrix<double>& mat,
+                      Base::SequencerLauncher& seq)
+{
+    std::vector< Eigen::Triplet<double> > triplets;
+    triplets.reserve(iUCtrl*iVCtrl*(2*iUOrder-1)*(2*iVOrder-1));
+
+    int m=0;
+    for (int k=0; k<iUCtrl; k++) {
+        for (int l=0; l<iVCtrl; l++) {
+            int iEndU = std::min(iUCtrl, k+iUOrder);
+            int iEndV = std::min(iVCtrl, l+iVOrder);
+            for (int i=std::max(0, k-iUOrder+1); i<iEndU; i++) {
+                for (int j=std::max(0, l-iVOrder+1); j<iEndV; j++) {
+                    double fValue = 0.0;
+                    for (const auto& term : terms)
+                        fValue += term.weight * term.u[i*iUCtrl+k] * term.v[j*iVCtrl+l];
+                    triplets.emplace_back(m, i*iVCtrl+j, fValue);
+                }
+            }
+            seq.next();
+            m++;
         }
     }
 
-    return true;
+    mat.resize(iUCtrl*iVCtrl, iUCtrl*iVCtrl);
+    mat.setFromTriplets(triplets.begin(), triplets.end());
+}
 }
 
 void BSplineParameterCorrection::CalcSmoothingTerms(bool bRecalc, double fFirst, double fSecond, double fThird)
 {
     if (bRecalc) {
-        Base::SequencerLauncher seq("Initializing...", 3 * _usUCtrlpoints * _usUCtrlpoints * _usVCtrlpoints * _usVCtrlpoints);
+        Base::SequencerLauncher seq("Initializing...", 3 * _usUCtrlpoints * _usVCtrlpoints);
         CalcFirstSmoothMatrix(seq);
         CalcSecondSmoothMatrix(seq);
         CalcThirdSmoothMatrix(seq);
@@ -1163,82 +1193,45 @@ void BSplineParameterCorrection::CalcSmoothingTerms(bool bRecalc, double fFirst,
 
 void BSplineParameterCorrection::CalcFirstSmoothMatrix(Base::SequencerLauncher& seq)
 {
-    unsigned m=0;
-    for (unsigned k=0; k<_usUCtrlpoints; k++) {
-        for (unsigned l=0; l<_usVCtrlpoints; l++) {
-            unsigned n=0;
-
-            for (unsigned i=0; i<_usUCtrlpoints; i++) {
-                for (unsigned j=0; j<_usVCtrlpoints; j++) {
-                    _clFirstMatrix(m,n) =   _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
-                                            _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1);
-                    seq.next();
-                    n++;
-                }
-            }
-            m++;
-        }
-    }
+    int iU = static_cast<int>(_usUCtrlpoints), iUOrd = static_cast<int>(_usUOrder);
+    int iV = static_cast<int>(_usVCtrlpoints), iVOrd = static_cast<int>(_usVOrder);
+
+    std::vector<SmoothingTerm> terms = {
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,1,1), IntegralTable(_clVSpline,iV,iVOrd,0,0)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,0,0), IntegralTable(_clVSpline,iV,iVOrd,1,1)}
+    };
+    CalcSmoothMatrix(terms, iU, iV, iUOrd, iVOrd, _clFirstMatrix, seq);
 }
 
 void BSplineParameterCorrection::CalcSecondSmoothMatrix(Base::SequencerLauncher& seq)
 {
-    unsigned m=0;
-    for (unsigned k=0; k<_usUCtrlpoints; k++) {
-        for (unsigned l=0; l<_usVCtrlpoints; l++) {
-            unsigned n=0;
-
-            for (unsigned i=0; i<_usUCtrlpoints; i++) {
-                for (unsigned j=0; j<_usVCtrlpoints; j++) {
-                    _clSecondMatrix(m,n) =  _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,2) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
-                                          2*_clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1) +
-                                            _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,2);
-                    seq.next();
-                    n++;
-                }
-            }
-            m++;
-        }
-    }
+    int iU = static_cast<int>(_usUCtrlpoints), iUOrd = static_cast<int>(_usUOrder);
+    int iV = static_cast<int>(_usVCtrlpoints), iVOrd = static_cast<int>(_usVOrder);
+
+    std::vector<SmoothingTerm> terms = {
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,2,2), IntegralTable(_clVSpline,iV,iVOrd,0,0)},
+        {2.0, IntegralTable(_clUSpline,iU,iUOrd,1,1), IntegralTable(_clVSpline,iV,iVOrd,1,1)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,0,0), IntegralTable(_clVSpline,iV,iVOrd,2,2)}
+    };
+    CalcSmoothMatrix(terms, iU, iV, iUOrd, iVOrd, _clSecondMatrix, seq);
 }
 
 void BSplineParameterCorrection::CalcThirdSmoothMatrix(Base::SequencerLauncher& seq)
 {
-    unsigned m=0;
-    for (unsigned k=0; k<_usUCtrlpoints; k++) {
-        for (unsigned l=0; l<_usVCtrlpoints; l++) {
-            unsigned n=0;
-
-            for (unsigned i=0; i<_usUCtrlpoints; i++) {
-                for (unsigned j=0; j<_usVCtrlpoints; j++) {
-                    _clThirdMatrix(m,n) = _clUSpline.GetIntegralOfProductOfBSplines(i,k,3,3) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,3,1) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,2) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,3) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,0) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,2) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,2) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,2) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,3,1) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,0) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,3) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,3,3) ;
-                    seq.next();
-                    n++;
-                }
-            }
-            m++;
-        }
-    }
+    int iU = static_cast<int>(_usUCtrlpoints), iUOrd = static_cast<int>(_usUOrder);
+    int iV = static_cast<int>(_usVCtrlpoints), iVOrd = static_cast<int>(_usVOrder);
+
+    std::vector<SmoothingTerm> terms = {
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,3,3), IntegralTable(_clVSpline,iV,iVOrd,0,0)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,3,1), IntegralTable(_clVSpline,iV,iVOrd,0,2)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,1,3), IntegralTable(_clVSpline,iV,iVOrd,2,0)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,1,1), IntegralTable(_clVSpline,iV,iVOrd,2,2)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,2,2), IntegralTable(_clVSpline,iV,iVOrd,1,1)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,0,2), IntegralTable(_clVSpline,iV,iVOrd,3,1)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,2,0), IntegralTable(_clVSpline,iV,iVOrd,1,3)},
+        {1.0, IntegralTable(_clUSpline,iU,iUOrd,0,0), IntegralTable(_clVSpline,iV,iVOrd,3,3)}
+    };
+    CalcSmoothMatrix(terms, iU, iV, iUOrd, iVOrd, _clThirdMatrix, seq);
 }
 
 void BSplineParameterCorrection::EnableSmoothing(bool bSmooth, double fSmoothInfl)
@@ -1257,32 +1250,59 @@ void BSplineParameterCorrection::EnableSmoothing(bool bSmooth, double fSmoothInf
     ParameterCorrection::EnableSmoothing(bSmooth, fSmoothInfl);
 }
 
-const math_Matrix& BSplineParameterCorrection::GetFirstSmoothMatrix() const
+namespace {
+math_Matrix toDense(const Eigen::SparseMatrix<double>& mat)
+{
+    math_Matrix dense(0, static_cast<int>(mat.rows())-1, 0, static_cast<int>(mat.cols())-1, 0.0);
+    for (int k=0; k<mat.outerSize(); k++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(mat, k); it; ++it)
+            dense(static_cast<int>(it.row()), static_cast<int>(it.col())) = it.value();
+    }
+    return dense;
+}
+
+Eigen::SparseMatrix<double> toSparse(const math_Matrix& mat)
+{
+    std::vector< Eigen::Triplet<double> > triplets;
+    for (int i=mat.LowerRow(); i<=mat.UpperRow(); i++) {
+        for (int j=mat.LowerCol(); j<=mat.UpperCol(); j++) {
+            if (mat(i,j) != 0.0)
+                triplets.emplace_back(i-mat.LowerRow(), j-mat.LowerCol(), mat(i,j));
+        }
+    }
+
+    Eigen::SparseMatrix<double> sparse(mat.RowNumber(), mat.ColNumber());
+    sparse.setFromTriplets(triplets.begin(), triplets.end());
+    return sparse;
+}
+}
+
+math_Matrix BSplineParameterCorrection::GetFirstSmoothMatrix() const
 {
-    return _clFirstMatrix;
+    return toDense(_clFirstMatrix);
 }
 
-const math_Matrix& BSplineParameterCorrection::GetSecondSmoothMatrix() const
+math_Matrix BSplineParameterCorrection::GetSecondSmoothMatrix() const
 {
-    return _clSecondMatrix;
+    return toDense(_clSecondMatrix);
 }
 
-const math_Matrix& BSplineParameterCorrection::GetThirdSmoothMatrix() const
+math_Matrix BSplineParameterCorrection::GetThirdSmoothMatrix() const
 {
-    return _clThirdMatrix;
+    return toDense(_clThirdMatrix);
 }
 
 void BSplineParameterCorrection::SetFirstSmoothMatrix(const math_Matrix& rclMat)
 {
-    _clFirstMatrix = rclMat;
+    _clFirstMatrix = toSparse(rclMat);
 }
 
 void BSplineParameterCorrection::SetSecondSmoothMatrix(const math_Matrix& rclMat)
 {
-    _clSecondMatrix = rclMat;
+    _clSecondMatrix = toSparse(rclMat);
 }
 
 void BSplineParameterCorrection::SetThirdSmoothMatrix(const math_Matrix& rclMat)
 {
-    _clThirdMatrix = rclMat;
+    _clThirdMatrix = toSparse(rclMat);
 }
@@ -30,6 +30,7 @@
 #include <TColStd_Array1OfReal.hxx>
 #include <Geom_BSplineSurface.hxx>
 #include <math_Matrix.hxx>
+#include <Eigen/SparseCore>
 
 #include <Base/Vector3D.h>
 #include <Mod/ReverseEngineering/ReverseEngineeringGlobal.h>
@@ -389,16 +390,27 @@ protected:
     void DoParameterCorrection(int iIter) override;
 
     /**
-     * Solve an overdetermined LGS with the help of the Householder-Tansformation
+     * Solve an overdetermined LGS by its normal equations
      */
     bool SolveWithoutSmoothing() override;
 
     /**
-     * Solve a regular system of equations by LU decomposition. Depending on the weighting,
-     * smoothing terms are included
+     * Solve a regular system of equations by sparse Cholesky decomposition. Depending on
+     * the weighting, smoothing terms are included
      */
     bool SolveWithSmoothing(double fWeight) override;
 
+    /**
+     * Calculates the sparse matrix M^T*M and the right side M^T*b of the normal equations.
+     * Only the basis functions that do not vanish at a point are evaluated.
+     */
+    virtual void CalcNormalEquations(Eigen::SparseMatrix<double>& MTM, Eigen::MatrixX3d& MTb);
+
+    /**
+     * Solves the normal equations and sets the control points
+     */
+    virtual bool SolveNormalEquations(const Eigen::SparseMatrix<double>& A, const Eigen::MatrixX3d& b);
+
 public:
     /**
      * Setting the knot vector
@@ -411,19 +423,22 @@ public:
     void SetVKnots(const std::vector<double>& afKnots);
 
     /**
-     * Returns the first matrix of smoothing terms, if calculated
+     * Returns the first matrix of smoothing terms, if calculated.
+     * The matrices are stored sparse, this returns a dense copy.
      */
-    virtual const math_Matrix& GetFirstSmoothMatrix() const;
+    virtual math_Matrix GetFirstSmoothMatrix() const;
 
     /**
-     * Returns the second matrix of smoothing terms, if calculated
+     * Returns the second matrix of smoothing terms, if calculated.
+     * The matrices are stored sparse, this returns a dense copy.
      */
-    virtual const math_Matrix& GetSecondSmoothMatrix() const;
+    virtual math_Matrix GetSecondSmoothMatrix() const;
 
     /**
-     * Returns the third matrix of smoothing terms, if calculated
+     * Returns the third matrix of smoothing terms, if calculated.
+     * The matrices are stored sparse, this returns a dense copy.
      */
-    virtual const math_Matrix& GetThirdSmoothMatrix() const;
+    virtual math_Matrix GetThirdSmoothMatrix() const;
 
     /**
      * Sets the first matrix of the smoothing terms
@@ -478,10 +493,10 @@ protected:
 protected:
     BSplineBasis           _clUSpline;        //! B-spline basic function in the u-direction
     BSplineBasis           _clVSpline;        //! B-spline basic function in the v-direction
-    math_Matrix            _clSmoothMatrix;   //! Matrix of smoothing functionals
-    math_Matrix            _clFirstMatrix;    //! Matrix of the 1st smoothing functionals
-    math_Matrix            _clSecondMatrix;   //! Matrix of the 2nd smoothing functionals
-    math_Matrix            _clThirdMatrix;    //! Matrix of the 3rd smoothing functionals
+    Eigen::SparseMatrix<double> _clSmoothMatrix; //! Matrix of smoothing functionals
+    Eigen::SparseMatrix<double> _clFirstMatrix;  //! Matrix of the 1st smoothing functionals
+    Eigen::SparseMatrix<double> _clSecondMatrix; //! Matrix of the 2nd smoothing functionals
+    Eigen::SparseMatrix<double> _clThirdMatrix;  //! Matrix of the 3rd smoothing functionals
 };
 
 } // namespace Reen
@@ -0,0 +1,503 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <cstdint>
+# include <limits>
+#endif
+
+#include <QThread>
+
+#include <Base/BoundBox.h>
+#include <Base/Converter.h>
+#include <Base/Exception.h>
+#include <Mod/Mesh/App/Mesh.h>
+#include <Mod/Mesh/App/Core/Functional.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Points/App/Points.h>
+#include <Mod/Points/App/PointsFilter.h>
+#include <Mod/Points/App/PointsGrid.h>
+
+#include "ImplicitReconstruction.h"
+
+
+using namespace Reen;
+
+namespace {
+
+using Key = std::uint64_t;
+
+/// Number of bits per axis of a packed grid position
+const int KeyBits = 21;
+const long MaxGridSize = (1L << KeyBits) - 1;
+/// Number of points or cells handled by one task, fixed to keep the output order independent of the threads
+const std::size_t BlockSize = 65536;
+
+/// Decomposition of a grid cell into six tetrahedra around its diagonal 0-7. Bit 0 of a corner
+/// index is the offset in x, bit 1 in y and bit 2 in z direction. Adjacent cells share the
+/// diagonals of their common faces so that the extracted surface has no cracks.
+const int Tetrahedra[6][4] = {
+    {0, 1, 3, 7}, {0, 3, 2, 7}, {0, 2, 6, 7}, {0, 6, 4, 7}, {0, 4, 5, 7}, {0, 5, 1, 7}
+};
+
+inline Base::Vector3d cornerOffset(int corner)
+{
+    return Base::Vector3d(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+}
+
+inline Key packKey(long x, long y, long z)
+{
+    return (Key(x) << (2 * KeyBits)) | (Key(y) << KeyBits) | Key(z);
+}
+
+inline void unpackKey(Key key, long& x, long& y, long& z)
+{
+    const Key mask = (Key(1) << KeyBits) - 1;
+    x = static_cast<long>(key >> (2 * KeyBits));
+    y = static_cast<long>((key >> KeyBits) & mask);
+    z = static_cast<long>(key & mask);
+}
+
+/// An edge of the grid is identified by the indices of its two vertices
+inline Key edgeKey(std::size_t a, std::size_t b)
+{
+    return a < b ? (Key(a) << 32) | Key(b) : (Key(b) << 32) | Key(a);
+}
+
+inline bool isValid(const Base::Vector3d& pnt)
+{
+    return !std::isnan(pnt.x) && !std::isnan(pnt.y) && !std::isnan(pnt.z);
+}
+
+void sortUnique(std::vector<Key>& keys, int threads)
+{
+    MeshCore::parallel_sort(keys.begin(), keys.end(), std::less<Key>(), threads);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+/*
+ * Calls func(index, begin, end) for each block of BlockSize elements and concatenates the
+ * key lists produced per block in block order.
+ */
+template <class Func>
+void collectKeys(std::size_t count, int threads, std::vector<Key>& keys, Func func)
+{
+    std::size_t numBlocks = (count + BlockSize - 1) / BlockSize;
+    std::vector<std::vector<Key> > blocks(numBlocks);
+    MeshCore::parallel_for(numBlocks, threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t b = begin; b < end; b++)
+            func(blocks[b], b * BlockSize, std::min(count, (b + 1) * BlockSize));
+    });
+
+    keys.clear();
+    std::size_t total = 0;
+    for (const auto& it : blocks)
+        total += it.size();
+    keys.reserve(total);
+    for (auto& it : blocks) {
+        keys.insert(keys.end(), it.begin(), it.end());
+        std::vector<Key>().swap(it);
+    }
+}
+
+/*
+ * Merges the sorted keys \a newKeys into \a keys. If \a newValues is not empty the values are
+ * merged in the same way.
+ */
+void mergeSorted(std::vector<Key>& keys, std::vector<double>& values,
+                 const std::vector<Key>& newKeys, const std::vector<double>& newValues)
+{
+    std::vector<Key> mergedKeys;
+    std::vector<double> mergedValues;
+    mergedKeys.reserve(keys.size() + newKeys.size());
+    mergedValues.reserve(newValues.empty() ? 0 : keys.size() + newKeys.size());
+    std::size_t i = 0, j = 0;
+    while (i < keys.size() || j < newKeys.size()) {
+        bool takeNew = i == keys.size() || (j < newKeys.size() && newKeys[j] < keys[i]);
+        if (takeNew) {
+            mergedKeys.push_back(newKeys[j]);
+            if (!newValues.empty())
+                mergedValues.push_back(newValues[j]);
+            j++;
+        }
+        else {
+            mergedKeys.push_back(keys[i]);
+            if (!newValues.empty())
+                mergedValues.push_back(values[i]);
+            i++;
+        }
+    }
+    keys.swap(mergedKeys);
+    values.swap(mergedValues);
+}
+
+struct Triangle
+{
+    Key edges[3];
+};
+
+}
+
+// ----------------------------------------------------------------------------
+
+ImplicitReconstruction::ImplicitReconstruction(const Points::PointKernel& pts, Mesh::MeshObject& mesh)
+  : myPoints(pts)
+  , myMesh(mesh)
+{
+}
+
+void ImplicitReconstruction::perform(int ksearch)
+{
+    Points::NormalEstimation estimation(myPoints);
+    estimation.SetKSearch(static_cast<unsigned long>(std::max(ksearch, 3)));
+    estimation.SetOrientNormals(true);
+    estimation.SetThreads(threads);
+
+    std::vector<Base::Vector3f> normals;
+    estimation.Perform(normals);
+    perform(normals);
+}
+
+void ImplicitReconstruction::perform(const std::vector<Base::Vector3f>& normals)
+{
+    if (myPoints.size() != normals.size())
+        throw Base::RuntimeError("Number of points doesn't match with number of normals");
+
+    const std::size_t numPoints = myPoints.size();
+    const int numThreads = threads < 1 ? QThread::idealThreadCount() : threads;
+
+    // The grid and the distance function work on the points of the kernel in place
+    const std::vector<Points::PointKernel::value_type>& basicPoints = myPoints.getBasicPoints();
+    const Base::Matrix4D mat = myPoints.getTransform();
+    const bool unity = mat.isUnity();
+    auto point = [&](std::size_t index) {
+        Base::Vector3d pnt = Base::convertTo<Base::Vector3d>(basicPoints[index]);
+        return unity ? pnt : mat * pnt;
+    };
+
+    Base::BoundBox3d bbox;
+    for (std::size_t i = 0; i < numPoints; i++) {
+        Base::Vector3d pnt = point(i);
+        if (isValid(pnt))
+            bbox.Add(pnt);
+    }
+    if (!bbox.IsValid())
+        throw Base::ValueError("Point cloud has no valid points");
+
+    // The default cell size is three times the mean distance of a point to its nearest neighbour
+    double size = cellSize;
+    if (size <= 0.0) {
+        unsigned long ulX, ulY, ulZ;
+        Points::PointsGrid::CalculateGridCounts(myPoints, POINTS_CT_GRID_SEARCH, ulX, ulY, ulZ);
+        Points::PointsGrid grid(myPoints, ulX, ulY, ulZ);
+
+        std::size_t step = std::max<std::size_t>(numPoints / 10000, 1);
+        std::vector<unsigned long> indices;
+        std::vector<double> distances;
+        double sum = 0.0;
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < numPoints; i += step) {
+            if (grid.FindNearest(point(i), 2, indices, &distances) == 2 && distances[1] > 0.0) {
+                sum += distances[1];
+                count++;
+            }
+        }
+        if (count == 0)
+            throw Base::ValueError("Cannot determine the cell size of a point cloud without distinct points");
+        size = 3.0 * sum / static_cast<double>(count);
+    }
+
+    // The points of a scanned surface occupy only a small part of their bounding box. So, the
+    // grid for the distance queries is adjusted to the cell size as long as it doesn't get more
+    // than eight grid elements per point.
+    double volume = std::max(bbox.LengthX(), size) * std::max(bbox.LengthY(), size) * std::max(bbox.LengthZ(), size);
+    double gridLength = std::max(size, std::cbrt(volume / (8.0 * static_cast<double>(numPoints))));
+    Points::PointsGrid grid(myPoints, gridLength);
+
+    // The surface may leave the cells around the points by up to three cell sizes
+    const Base::Vector3d origin(bbox.MinX - 4.0 * size, bbox.MinY - 4.0 * size, bbox.MinZ - 4.0 * size);
+    if ((bbox.LengthX() / size) + 8.0 >= MaxGridSize ||
+        (bbox.LengthY() / size) + 8.0 >= MaxGridSize ||
+        (bbox.LengthZ() / size) + 8.0 >= MaxGridSize)
+        throw Base::ValueError("Cell size is too small for the extent of the point cloud");
+
+    auto gridVertex = [&](long x, long y, long z) {
+        return Base::Vector3d(origin.x + x * size, origin.y + y * size, origin.z + z * size);
+    };
+    auto gridIndex = [&](double value, double start) {
+        return static_cast<long>(std::floor((value - start) / size));
+    };
+
+    // Signed distance to the tangent planes of the nearest points, weighted by their distance.
+    // Vertices further than three cell sizes from the points or whose neighbours have no
+    // normals are invalid and cut the surface off.
+    auto evaluate = [&](const std::vector<Key>& keys, std::vector<double>& values) {
+        values.assign(keys.size(), std::numeric_limits<double>::quiet_NaN());
+        MeshCore::parallel_for(keys.size(), numThreads, [&](std::size_t begin, std::size_t end) {
+            std::vector<unsigned long> indices;
+            std::vector<double> distances;
+            for (std::size_t i = begin; i < end; i++) {
+                long x, y, z;
+                unpackKey(keys[i], x, y, z);
+                Base::Vector3d pos = gridVertex(x, y, z);
+                grid.FindNearest(pos, neighbours, indices, &distances, 3.0 * size);
+
+                double sum = 0.0, weights = 0.0;
+                for (std::size_t j = 0; j < indices.size(); j++) {
+                    Base::Vector3d normal = Base::convertTo<Base::Vector3d>(normals[indices[j]]);
+                    double length = normal.Length();
+                    if (length == 0.0 || std::isnan(length))
+                        continue;
+                    double weight = std::exp(-(distances[j] * distances[j]) / (size * size));
+                    sum += weight * (normal * (pos - point(indices[j]))) / length;
+                    weights += weight;
+                }
+                if (weights > 0.0) {
+                    // exact zeros would produce coincident surface vertices
+                    double value = sum / weights;
+                    values[i] = std::fabs(value) < 1e-6 * size ? 1e-6 * size : value;
+                }
+            }
+        });
+    };
+
+    std::vector<Key> cells;
+    std::vector<Key> vertices;
+    std::vector<double> values;
+    auto vertexIndex = [&](long x, long y, long z) {
+        return static_cast<std::size_t>(std::lower_bound(vertices.begin(), vertices.end(), packKey(x, y, z)) - vertices.begin());
+    };
+
+    // Start with the cells that overlap the cube of half a cell size around a point
+    std::vector<Key> newCells;
+    collectKeys(numPoints, numThreads, newCells, [&](std::vector<Key>& keys, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Base::Vector3d pnt = point(i);
+            if (!isValid(pnt))
+                continue;
+            long x0 = gridIndex(pnt.x - 0.5 * size, origin.x), x1 = gridIndex(pnt.x + 0.5 * size, origin.x);
+            long y0 = gridIndex(pnt.y - 0.5 * size, origin.y), y1 = gridIndex(pnt.y + 0.5 * size, origin.y);
+            long z0 = gridIndex(pnt.z - 0.5 * size, origin.z), z1 = gridIndex(pnt.z + 0.5 * size, origin.z);
+            for (long x = x0; x <= x1; x++) {
+                for (long y = y0; y <= y1; y++) {
+                    for (long z = z0; z <= z1; z++)
+                        keys.push_back(packKey(x, y, z));
+                }
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    });
+    sortUnique(newCells, numThreads);
+
+    // Add the neighbours of cells whose common face is crossed by the surface until it is closed
+    // or reaches invalid vertices
+    while (!newCells.empty()) {
+        std::vector<Key> newVertices;
+        collectKeys(newCells.size(), numThreads, newVertices, [&](std::vector<Key>& keys, std::size_t begin, std::size_t end) {
+            keys.reserve(8 * (end - begin));
+            for (std::size_t i = begin; i < end; i++) {
+                long x, y, z;
+                unpackKey(newCells[i], x, y, z);
+                for (int c = 0; c < 8; c++) {
+                    Key key = packKey(x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1));
+                    if (!std::binary_search(vertices.begin(), vertices.end(), key))
+                        keys.push_back(key);
+                }
+            }
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        });
+        sortUnique(newVertices, numThreads);
+
+        std::vector<double> newValues;
+        evaluate(newVertices, newValues);
+        mergeSorted(vertices, values, newVertices, newValues);
+        if (vertices.size() > std::numeric_limits<std::uint32_t>::max())
+            throw Base::ValueError("Cell size is too small for the number of points");
+
+        std::vector<double> noValues;
+        std::vector<Key> addedCells;
+        addedCells.swap(newCells);
+        mergeSorted(cells, noValues, addedCells, noValues);
+
+        collectKeys(addedCells.size(), numThreads, newCells, [&](std::vector<Key>& keys, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                long x, y, z;
+                unpackKey(addedCells[i], x, y, z);
+                double corners[8];
+                for (int c = 0; c < 8; c++)
+                    corners[c] = values[vertexIndex(x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1))];
+                for (int axis = 0; axis < 3; axis++) {
+                    for (int side = 0; side < 2; side++) {
+                        int negative = 0, positive = 0;
+                        for (int c = 0; c < 8; c++) {
+                            if (((c >> axis) & 1) != side)
+                                continue;
+                            if (corners[c] < 0.0)
+                                negative++;
+                            else if (corners[c] >= 0.0)
+                                positive++;
+                        }
+                        if (negative == 0 || positive == 0 || negative + positive < 4)
+                            continue;
+                        long offset = side == 0 ? -1 : 1;
+                        Key key = packKey(x + (axis == 0 ? offset : 0), y + (axis == 1 ? offset : 0),
+                                          z + (axis == 2 ? offset : 0));
+                        if (!std::binary_search(cells.begin(), cells.end(), key))
+                            keys.push_back(key);
+                    }
+                }
+            }
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        });
+        sortUnique(newCells, numThreads);
+    }
+
+    auto surfacePoint = [&](std::size_t a, std::size_t b) {
+        long x, y, z;
+        unpackKey(vertices[a], x, y, z);
+        Base::Vector3d pa = gridVertex(x, y, z);
+        unpackKey(vertices[b], x, y, z);
+        Base::Vector3d pb = gridVertex(x, y, z);
+        double t = values[a] / (values[a] - values[b]);
+        return pa + (pb - pa) * t;
+    };
+
+    // Marching tetrahedra, the triangles are oriented towards the positive side
+    std::size_t numBlocks = (cells.size() + BlockSize - 1) / BlockSize;
+    std::vector<std::vector<Triangle> > blocks(numBlocks);
+    MeshCore::parallel_for(numBlocks, numThreads, [&](std::size_t blockBegin, std::size_t blockEnd) {
+        for (std::size_t b = blockBegin; b < blockEnd; b++) {
+            std::vector<Triangle>& triangles = blocks[b];
+            std::size_t end = std::min(cells.size(), (b + 1) * BlockSize);
+            for (std::size_t i = b * BlockSize; i < end; i++) {
+                long x, y, z;
+                unpackKey(cells[i], x, y, z);
+                std::size_t corners[8];
+                bool valid = true;
+                int negative = 0;
+                for (int c = 0; c < 8 && valid; c++) {
+                    corners[c] = vertexIndex(x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1));
+                    double value = values[corners[c]];
+                    valid = !std::isnan(value);
+                    if (value < 0.0)
+                        negative++;
+                }
+                if (!valid || negative == 0 || negative == 8)
+                    continue;
+
+                for (const auto& tet : Tetrahedra) {
+                    // corners of the tetrahedron on the negative and positive side
+                    int inside[4], outside[4];
+                    int numInside = 0, numOutside = 0;
+                    for (int c : tet) {
+                        if (values[corners[c]] < 0.0)
+                            inside[numInside++] = c;
+                        else
+                            outside[numOutside++] = c;
+                    }
+                    if (numInside == 0 || numOutside == 0)
+                        continue;
+
+                    // The orientation is determined with the edge midpoints because the interpolated
+                    // points may coincide. The normal must point from the negative to the positive side.
+                    Base::Vector3d direction;
+                    for (int c : tet)
+                        direction += values[corners[c]] < 0.0 ? -cornerOffset(c) : cornerOffset(c);
+                    auto addTriangle = [&](int a0, int b0, int a1, int b1, int a2, int b2) {
+                        Triangle triangle{{edgeKey(corners[a0], corners[b0]),
+                                           edgeKey(corners[a1], corners[b1]),
+                                           edgeKey(corners[a2], corners[b2])}};
+                        Base::Vector3d m0 = cornerOffset(a0) + cornerOffset(b0);
+                        Base::Vector3d m1 = cornerOffset(a1) + cornerOffset(b1);
+                        Base::Vector3d m2 = cornerOffset(a2) + cornerOffset(b2);
+                        if (((m1 - m0) % (m2 - m0)) * direction < 0.0)
+                            std::swap(triangle.edges[1], triangle.edges[2]);
+                        triangles.push_back(triangle);
+                    };
+
+                    if (numInside == 1) {
+                        addTriangle(inside[0], outside[0], inside[0], outside[1], inside[0], outside[2]);
+                    }
+                    else if (numOutside == 1) {
+                        addTriangle(outside[0], inside[0], outside[0], inside[1], outside[0], inside[2]);
+                    }
+                    else {
+                        // the four edges between the two sides form a quadrilateral
+                        addTriangle(inside[0], outside[0], inside[0], outside[1], inside[1], outside[1]);
+                        addTriangle(inside[0], outside[0], inside[1], outside[1], inside[1], outside[0]);
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<Triangle> triangles;
+    std::size_t numTriangles = 0;
+    for (const auto& it : blocks)
+        numTriangles += it.size();
+    triangles.reserve(numTriangles);
+    for (auto& it : blocks) {
+        triangles.insert(triangles.end(), it.begin(), it.end());
+        std::vector<Triangle>().swap(it);
+    }
+    std::vector<Key>().swap(cells);
+
+    // Each intersected grid edge becomes a mesh point
+    std::vector<Key> edges(3 * triangles.size());
+    MeshCore::parallel_for(triangles.size(), numThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            for (int j = 0; j < 3; j++)
+                edges[3 * i + j] = triangles[i].edges[j];
+        }
+    });
+    sortUnique(edges, numThreads);
+
+    MeshCore::MeshPointArray meshPoints(edges.size());
+    MeshCore::parallel_for(edges.size(), numThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            std::size_t a = static_cast<std::size_t>(edges[i] >> 32);
+            std::size_t b = static_cast<std::size_t>(edges[i] & 0xffffffff);
+            meshPoints[i] = Base::convertTo<Base::Vector3f>(surfacePoint(a, b));
+        }
+    });
+
+    MeshCore::MeshFacetArray meshFacets(triangles.size());
+    MeshCore::parallel_for(triangles.size(), numThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            MeshCore::MeshFacet& facet = meshFacets[i];
+            for (int j = 0; j < 3; j++) {
+                auto it = std::lower_bound(edges.begin(), edges.end(), triangles[i].edges[j]);
+                facet._aulPoints[j] = static_cast<MeshCore::PointIndex>(it - edges.begin());
+            }
+        }
+    });
+
+    MeshCore::MeshKernel kernel;
+    kernel.Adopt(meshPoints, meshFacets, true);
+    myMesh.swap(kernel);
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef REEN_IMPLICITRECONSTRUCTION_H
+#define REEN_IMPLICITRECONSTRUCTION_H
+
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+
+namespace Points {class PointKernel;}
+namespace Mesh {class MeshObject;}
+
+namespace Reen {
+
+/**
+ * The ImplicitReconstruction class creates a closed or open triangle mesh from a point cloud
+ * with oriented normals. The signed distance to the tangent planes of the nearest points
+ * (Hoppe et al.) is sampled on a sparse grid around the points and its zero level set is
+ * extracted by marching tetrahedra. Vertices and facets are written directly into the mesh
+ * kernel, the points are accessed in place and no copy of the point cloud is created.
+ * The result doesn't depend on the number of threads.
+ */
+class ImplicitReconstruction
+{
+public:
+    ImplicitReconstruction(const Points::PointKernel&, Mesh::MeshObject&);
+    /** \brief Estimates and orients the normals with the \a ksearch nearest neighbours. */
+    void perform(int ksearch=10);
+    /** \brief Pass the normals to the points given in the constructor. The normals
+      * must point to the outside.
+      * \param[in] normals the normals to the given points.
+      */
+    void perform(const std::vector<Base::Vector3f>& normals);
+
+    /** \brief Set the edge length of the grid cells. With a value of 0 the cell size
+      * is three times the mean distance of a point to its nearest neighbour.
+      */
+    inline void
+    setCellSize(double size) { this->cellSize = size; }
+
+    /** \brief Set the number of nearest points to evaluate the distance function. */
+    inline void
+    setNearestNeighbors(unsigned long num) { this->neighbours = num; }
+
+    /** \brief Set the number of threads, a value of 0 or less uses all cores. */
+    inline void
+    setThreads(int num) { this->threads = num; }
+
+private:
+    const Points::PointKernel& myPoints;
+    Mesh::MeshObject& myMesh;
+    double cellSize{0.0};
+    unsigned long neighbours{8};
+    int threads{0};
+};
+
+} // namespace Reen
+
+#endif // REEN_IMPLICITRECONSTRUCTION_H
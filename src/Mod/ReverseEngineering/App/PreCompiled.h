@@ -41,7 +41,9 @@
 #ifdef _PreComp_
 
 // standard
+#include <limits>
 #include <map>
+#include <mutex>
 
 // boost
 #include <boost/math/special_functions/fpclassify.hpp>
@@ -50,6 +52,7 @@
 #include <Geom_BSplineSurface.hxx>
 #include <math_Gauss.hxx>
 #include <math_Householder.hxx>
+#include <math_Matrix.hxx>
 #include <Precision.hxx>
 #include <TColgp_Array1OfPnt.hxx>
 
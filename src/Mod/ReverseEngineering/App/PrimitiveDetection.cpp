@@ -0,0 +1,633 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <queue>
+# include <random>
+#endif
+
+#include <Eigen/Dense>
+
+#include <Base/Converter.h>
+#include <Mod/Mesh/App/Core/Approximation.h>
+#include <Mod/Mesh/App/Core/Functional.h>
+#include <Mod/Points/App/PointsFilter.h>
+#include <Mod/Points/App/PointsGrid.h>
+
+#include "PrimitiveDetection.h"
+
+
+using namespace Reen;
+
+namespace {
+
+/// Number of hypotheses that are generated and scored at once
+const std::size_t BatchSize = 256;
+/// Upper limit of hypotheses per extracted shape
+const std::size_t MaxHypotheses = 32768;
+/// Number of points to estimate the support of a hypothesis
+const std::size_t SubsetSize = 4096;
+/// Smallest number of neighbours the samples of a hypothesis are drawn from
+const unsigned long SampleNeighbours = 32;
+/// Number of neighbourhood sizes, each one four times larger than the previous
+const int SampleLevels = 3;
+
+struct Candidate
+{
+    PrimitiveDetection::PrimitiveType type = PrimitiveDetection::Plane;
+    Base::Vector3d base;
+    Base::Vector3d axis;
+    double radius = 0.0;
+    double angle = 0.0;
+    std::size_t score = 0;
+};
+
+/**
+ * Checks whether the point lies within \a eps of the shape and whether its normal
+ * deviates at most by the angle with the cosine \a cosDev from the shape normal.
+ * The orientation of the normal doesn't matter.
+ */
+bool isCompatible(const Candidate& shape, const Base::Vector3d& pnt, const Base::Vector3d& nor,
+                  double eps, double cosDev)
+{
+    Base::Vector3d dir;
+    double dist = 0.0;
+    switch (shape.type) {
+    case PrimitiveDetection::Plane:
+        dist = (pnt - shape.base) * shape.axis;
+        dir = shape.axis;
+        break;
+    case PrimitiveDetection::Sphere:
+    {
+        dir = pnt - shape.base;
+        double len = dir.Length();
+        if (len == 0.0)
+            return false;
+        dist = len - shape.radius;
+        dir /= len;
+    }   break;
+    case PrimitiveDetection::Cylinder:
+    {
+        Base::Vector3d vec = pnt - shape.base;
+        dir = vec - shape.axis * (vec * shape.axis);
+        double len = dir.Length();
+        if (len == 0.0)
+            return false;
+        dist = len - shape.radius;
+        dir /= len;
+    }   break;
+    case PrimitiveDetection::Cone:
+    {
+        // the distance to the generating line in the plane of axis and point
+        Base::Vector3d vec = pnt - shape.base;
+        double height = vec * shape.axis;
+        if (height <= 0.0)
+            return false;
+        Base::Vector3d radial = vec - shape.axis * height;
+        double len = radial.Length();
+        if (len == 0.0)
+            return false;
+        radial /= len;
+        double sina = std::sin(shape.angle);
+        double cosa = std::cos(shape.angle);
+        dist = len * cosa - height * sina;
+        dir = radial * cosa - shape.axis * sina;
+    }   break;
+    }
+
+    return std::fabs(dist) <= eps && std::fabs(dir * nor) >= cosDev;
+}
+
+/**
+ * Returns the parameter on the line \a p1 + t * \a d1 of the closest point to the
+ * line \a p2 + s * \a d2, or false if the lines are parallel.
+ */
+bool closestPoints(const Base::Vector3d& p1, const Base::Vector3d& d1,
+                   const Base::Vector3d& p2, const Base::Vector3d& d2,
+                   Base::Vector3d& c1, Base::Vector3d& c2)
+{
+    Base::Vector3d w = p1 - p2;
+    double a = d1 * d1, b = d1 * d2, c = d2 * d2;
+    double d = d1 * w, e = d2 * w;
+    double denom = a * c - b * b;
+    if (denom <= 1e-12 * a * c)
+        return false;
+    double t = (b * e - c * d) / denom;
+    double s = (a * e - b * d) / denom;
+    c1 = p1 + d1 * t;
+    c2 = p2 + d2 * s;
+    return true;
+}
+
+bool fitPlane(const Base::Vector3d* pnt, const Base::Vector3d*, Candidate& shape)
+{
+    Base::Vector3d normal = (pnt[1] - pnt[0]) % (pnt[2] - pnt[0]);
+    double len = normal.Length();
+    if (len == 0.0)
+        return false;
+    shape.base = pnt[0];
+    shape.axis = normal / len;
+    return true;
+}
+
+bool fitSphere(const Base::Vector3d* pnt, const Base::Vector3d* nor, Candidate& shape)
+{
+    Base::Vector3d c1, c2;
+    if (!closestPoints(pnt[0], nor[0], pnt[1], nor[1], c1, c2))
+        return false;
+    shape.base = (c1 + c2) / 2.0;
+    shape.radius = (Base::Distance(pnt[0], shape.base) + Base::Distance(pnt[1], shape.base)) / 2.0;
+    return shape.radius > 0.0;
+}
+
+bool fitCylinder(const Base::Vector3d* pnt, const Base::Vector3d* nor, Candidate& shape)
+{
+    Base::Vector3d axis = nor[0] % nor[1];
+    double len = axis.Length();
+    if (len < 1e-6)
+        return false;
+    axis /= len;
+
+    // intersect the normal lines projected onto a plane perpendicular to the axis
+    Base::Vector3d p0 = pnt[0];
+    Base::Vector3d p1 = pnt[1] - axis * ((pnt[1] - pnt[0]) * axis);
+    Base::Vector3d n0 = nor[0] - axis * (nor[0] * axis);
+    Base::Vector3d n1 = nor[1] - axis * (nor[1] * axis);
+    Base::Vector3d c1, c2;
+    if (!closestPoints(p0, n0, p1, n1, c1, c2))
+        return false;
+    shape.base = (c1 + c2) / 2.0;
+    shape.axis = axis;
+    shape.radius = (Base::Distance(p0, shape.base) + Base::Distance(p1, shape.base)) / 2.0;
+    return shape.radius > 0.0;
+}
+
+bool fitCone(const Base::Vector3d* pnt, const Base::Vector3d* nor, Candidate& shape)
+{
+    // the apex is the intersection of the three tangent planes
+    Base::Vector3d n12 = nor[1] % nor[2];
+    Base::Vector3d n20 = nor[2] % nor[0];
+    Base::Vector3d n01 = nor[0] % nor[1];
+    double det = nor[0] * n12;
+    if (std::fabs(det) < 1e-6)
+        return false;
+    Base::Vector3d apex = (n12 * (pnt[0] * nor[0]) + n20 * (pnt[1] * nor[1]) + n01 * (pnt[2] * nor[2])) / det;
+
+    // the directions to the points lie on a circle around the axis
+    Base::Vector3d dir[3];
+    for (int i = 0; i < 3; i++) {
+        dir[i] = pnt[i] - apex;
+        double len = dir[i].Length();
+        if (len == 0.0)
+            return false;
+        dir[i] /= len;
+    }
+    Base::Vector3d axis = (dir[1] - dir[0]) % (dir[2] - dir[0]);
+    double len = axis.Length();
+    if (len == 0.0)
+        return false;
+    axis /= len;
+    if (axis * (dir[0] + dir[1] + dir[2]) < 0.0)
+        axis = -axis;
+
+    double angle = 0.0;
+    for (int i = 0; i < 3; i++)
+        angle += std::acos(std::min(1.0, std::max(-1.0, dir[i] * axis)));
+    angle /= 3.0;
+    if (angle < 0.01 || angle > M_PI / 2.0 - 0.01)
+        return false;
+
+    shape.base = apex;
+    shape.axis = axis;
+    shape.angle = angle;
+    return true;
+}
+
+bool fitCandidate(const Base::Vector3d* pnt, const Base::Vector3d* nor, Candidate& shape,
+                  double eps, double cosDev)
+{
+    bool ok = false;
+    switch (shape.type) {
+    case PrimitiveDetection::Plane:
+        ok = fitPlane(pnt, nor, shape);
+        break;
+    case PrimitiveDetection::Sphere:
+        ok = fitSphere(pnt, nor, shape);
+        break;
+    case PrimitiveDetection::Cylinder:
+        ok = fitCylinder(pnt, nor, shape);
+        break;
+    case PrimitiveDetection::Cone:
+        ok = fitCone(pnt, nor, shape);
+        break;
+    }
+
+    // all samples must be compatible with the hypothesis
+    for (int i = 0; ok && i < 3; i++)
+        ok = isCompatible(shape, pnt[i], nor[i], eps, cosDev);
+    return ok;
+}
+
+/**
+ * Fits a cone to the points by minimizing the distances with Levenberg-Marquardt
+ * starting from the current parameters.
+ */
+bool refitCone(const std::vector<Base::Vector3d>& points, const std::vector<unsigned long>& inliers,
+               Candidate& shape)
+{
+    // parameters: apex, axis (normalized after each step) and half angle
+    using Vector7d = Eigen::Matrix<double, 7, 1>;
+    using Matrix7d = Eigen::Matrix<double, 7, 7>;
+    auto residuals = [&](const Vector7d& x, Eigen::VectorXd& res) {
+        Base::Vector3d apex(x[0], x[1], x[2]);
+        Base::Vector3d axis(x[3], x[4], x[5]);
+        axis.Normalize();
+        double sina = std::sin(x[6]), cosa = std::cos(x[6]);
+        res.resize(inliers.size());
+        for (std::size_t i = 0; i < inliers.size(); i++) {
+            Base::Vector3d vec = points[inliers[i]] - apex;
+            double height = vec * axis;
+            double radial = (vec - axis * height).Length();
+            res[i] = radial * cosa - height * sina;
+        }
+        return res.squaredNorm();
+    };
+
+    Vector7d x;
+    x << shape.base.x, shape.base.y, shape.base.z, shape.axis.x, shape.axis.y, shape.axis.z, shape.angle;
+    Eigen::VectorXd res, tmp;
+    double error = residuals(x, res);
+    double lambda = 1e-3;
+    Eigen::MatrixXd jac(inliers.size(), 7);
+    for (int iter = 0; iter < 20; iter++) {
+        for (int j = 0; j < 7; j++) {
+            Vector7d dx = x;
+            double h = 1e-7 * std::max(1.0, std::fabs(x[j]));
+            dx[j] += h;
+            residuals(dx, tmp);
+            jac.col(j) = (tmp - res) / h;
+        }
+
+        Matrix7d JTJ = jac.transpose() * jac;
+        Vector7d JTr = jac.transpose() * res;
+        bool improved = false;
+        while (lambda < 1e10) {
+            Matrix7d A = JTJ;
+            A.diagonal() *= 1.0 + lambda;
+            Vector7d step = A.ldlt().solve(-JTr);
+            Vector7d next = x + step;
+            double nextError = residuals(next, tmp);
+            if (nextError < error) {
+                x = next;
+                res = tmp;
+                lambda = std::max(lambda * 0.1, 1e-12);
+                improved = error - nextError > 1e-12 * error;
+                error = nextError;
+                break;
+            }
+            lambda *= 10.0;
+        }
+        if (!improved)
+            break;
+    }
+
+    Base::Vector3d axis(x[3], x[4], x[5]);
+    if (axis.Length() == 0.0 || !(x[6] > 0.0 && x[6] < M_PI / 2.0))
+        return false;
+    shape.base.Set(x[0], x[1], x[2]);
+    shape.axis = axis.Normalize();
+    shape.angle = x[6];
+    return true;
+}
+
+/**
+ * Refines the shape by a least-squares fit of the inliers.
+ */
+bool refitCandidate(const std::vector<Base::Vector3d>& points, const std::vector<unsigned long>& inliers,
+                    Candidate& shape)
+{
+    // fit relative to the centroid to keep the precision of the float based fitters
+    Base::Vector3d center;
+    for (unsigned long index : inliers)
+        center += points[index];
+    center /= static_cast<double>(inliers.size());
+
+    std::vector<Base::Vector3f> local;
+    local.reserve(inliers.size());
+    for (unsigned long index : inliers)
+        local.push_back(Base::convertTo<Base::Vector3f>(points[index] - center));
+
+    switch (shape.type) {
+    case PrimitiveDetection::Plane:
+    {
+        MeshCore::PlaneFit fit;
+        fit.AddPoints(local);
+        if (fit.Fit() >= FLOAT_MAX)
+            return false;
+        shape.base = Base::convertTo<Base::Vector3d>(fit.GetBase()) + center;
+        shape.axis = Base::convertTo<Base::Vector3d>(fit.GetNormal());
+    }   return true;
+    case PrimitiveDetection::Sphere:
+    {
+        MeshCore::SphereFit fit;
+        fit.AddPoints(local);
+        if (fit.Fit() >= FLOAT_MAX)
+            return false;
+        shape.base = Base::convertTo<Base::Vector3d>(fit.GetCenter()) + center;
+        shape.radius = fit.GetRadius();
+    }   return true;
+    case PrimitiveDetection::Cylinder:
+    {
+        MeshCore::CylinderFit fit;
+        fit.AddPoints(local);
+        fit.SetInitialValues(Base::convertTo<Base::Vector3f>(shape.base - center),
+                             Base::convertTo<Base::Vector3f>(shape.axis));
+        if (fit.Fit() >= FLOAT_MAX)
+            return false;
+        shape.base = Base::convertTo<Base::Vector3d>(fit.GetBase()) + center;
+        shape.axis = Base::convertTo<Base::Vector3d>(fit.GetAxis());
+        shape.axis.Normalize();
+        shape.radius = fit.GetRadius();
+    }   return true;
+    case PrimitiveDetection::Cone:
+        return refitCone(points, inliers, shape);
+    }
+
+    return false;
+}
+
+}
+
+PrimitiveDetection::PrimitiveDetection(const Points::PointKernel& pts, const std::vector<Base::Vector3f>& nor)
+  : myPoints(pts)
+  , myNormals(nor)
+{
+}
+
+void PrimitiveDetection::perform(std::vector<Primitive>& primitives) const
+{
+    primitives.clear();
+    if (types.empty() || myPoints.size() == 0)
+        return;
+
+    // work in global coordinates
+    std::vector<Base::Vector3d> points;
+    points.reserve(myPoints.size());
+    for (Points::PointKernel::const_point_iterator it = myPoints.begin(); it != myPoints.end(); ++it)
+        points.push_back(*it);
+    Points::PointKernel kernel;
+    kernel.reserve(points.size());
+    for (const auto& it : points)
+        kernel.push_back(it);
+
+    std::vector<Base::Vector3d> normals(points.size());
+    if (myNormals.size() == points.size()) {
+        for (std::size_t i = 0; i < points.size(); i++)
+            normals[i] = Base::convertTo<Base::Vector3d>(myNormals[i]);
+    }
+    else {
+        std::vector<Base::Vector3f> estimated;
+        Points::NormalEstimation estimate(kernel);
+        estimate.SetOrientNormals(false);
+        estimate.SetThreads(threads);
+        estimate.Perform(estimated);
+        for (std::size_t i = 0; i < points.size(); i++)
+            normals[i] = Base::convertTo<Base::Vector3d>(estimated[i]);
+    }
+
+    // only points with a valid position and normal take part
+    std::vector<char> available(points.size(), 0);
+    std::vector<unsigned long> remaining;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const Base::Vector3d& p = points[i];
+        Base::Vector3d& n = normals[i];
+        if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z) ||
+            std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z) || n.Sqr() == 0.0)
+            continue;
+        n.Normalize();
+        available[i] = 1;
+        remaining.push_back(static_cast<unsigned long>(i));
+    }
+
+    unsigned long ulX, ulY, ulZ;
+    Points::PointsGrid::CalculateGridCounts(kernel, POINTS_CT_GRID_SEARCH, ulX, ulY, ulZ);
+    Points::PointsGrid grid(kernel, ulX, ulY, ulZ);
+
+    const double cosDev = std::cos(deviation);
+    std::mt19937 rng(seed);
+
+    auto compatible = [&](const Candidate& shape, unsigned long index) {
+        return isCompatible(shape, points[index], normals[index], epsilon, cosDev);
+    };
+
+    // returns the remaining points that support the shape
+    auto findInliers = [&](const Candidate& shape, std::vector<unsigned long>& inliers) {
+        std::vector<char> flags(remaining.size(), 0);
+        MeshCore::parallel_for(remaining.size(), threads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                flags[i] = compatible(shape, remaining[i]) ? 1 : 0;
+        });
+        inliers.clear();
+        for (std::size_t i = 0; i < remaining.size(); i++) {
+            if (flags[i])
+                inliers.push_back(remaining[i]);
+        }
+    };
+
+    std::size_t numFailures = 0;
+    while (remaining.size() >= minSupport && remaining.size() >= 3) {
+        if (maxPrimitives > 0 && primitives.size() >= maxPrimitives)
+            break;
+
+        // the support of the hypotheses is estimated on a random subset
+        std::vector<unsigned long> subset;
+        if (remaining.size() <= SubsetSize) {
+            subset = remaining;
+        }
+        else {
+            std::uniform_int_distribution<std::size_t> pick(0, remaining.size() - 1);
+            subset.reserve(SubsetSize);
+            for (std::size_t i = 0; i < SubsetSize; i++)
+                subset.push_back(remaining[pick(rng)]);
+        }
+
+        // the best hypothesis of each type, the overall best decides when to stop
+        std::vector<Candidate> bestOfType(types.size());
+        Candidate best;
+        std::size_t numHypotheses = 0;
+        while (numHypotheses < MaxHypotheses) {
+            std::vector<unsigned int> seeds(BatchSize);
+            for (auto& it : seeds)
+                it = rng();
+
+            std::vector<Candidate> batch(BatchSize * types.size());
+            MeshCore::parallel_for(BatchSize, threads, [&](std::size_t begin, std::size_t end) {
+                std::vector<unsigned long> neighbours;
+                for (std::size_t h = begin; h < end; h++) {
+                    // Draw a point and two further points from its neighbourhood. Small
+                    // neighbourhoods find small shapes, large ones give stable hypotheses
+                    // for curved shapes.
+                    std::mt19937 local(seeds[h]);
+                    std::uniform_int_distribution<std::size_t> pick(0, remaining.size() - 1);
+                    std::uniform_int_distribution<int> level(0, SampleLevels - 1);
+                    unsigned long first = remaining[pick(local)];
+                    grid.FindNearest(points[first], SampleNeighbours << (2 * level(local)), neighbours);
+                    neighbours.erase(std::remove_if(neighbours.begin(), neighbours.end(), [&](unsigned long index) {
+                        return index == first || !available[index];
+                    }), neighbours.end());
+                    if (neighbours.size() < 2)
+                        continue;
+
+                    std::uniform_int_distribution<std::size_t> next(0, neighbours.size() - 1);
+                    std::size_t second = next(local);
+                    std::size_t third = next(local);
+                    if (second == third)
+                        third = (third + 1) % neighbours.size();
+
+                    Base::Vector3d pnt[3] = {points[first], points[neighbours[second]], points[neighbours[third]]};
+                    Base::Vector3d nor[3] = {normals[first], normals[neighbours[second]], normals[neighbours[third]]};
+
+                    for (std::size_t t = 0; t < types.size(); t++) {
+                        Candidate& shape = batch[h * types.size() + t];
+                        shape.type = types[t];
+                        if (!fitCandidate(pnt, nor, shape, epsilon, cosDev))
+                            continue;
+                        for (unsigned long index : subset) {
+                            if (compatible(shape, index))
+                                shape.score++;
+                        }
+                    }
+                }
+            });
+            numHypotheses += BatchSize;
+
+            for (std::size_t i = 0; i < batch.size(); i++) {
+                Candidate& it = bestOfType[i % types.size()];
+                if (batch[i].score > it.score)
+                    it = batch[i];
+                if (batch[i].score > best.score)
+                    best = batch[i];
+            }
+
+            // stop if the chance to have missed a larger shape is small enough
+            double ratio = static_cast<double>(best.score) / static_cast<double>(subset.size());
+            if (ratio > 0.0 && std::pow(1.0 - ratio, static_cast<double>(numHypotheses)) < probability)
+                break;
+        }
+
+        double estimate = static_cast<double>(best.score) * remaining.size() / subset.size();
+        if (best.score == 0 || estimate < minSupport)
+            break;
+
+        // A hypothesis only depends on a few samples so that a fit of its support may
+        // grow it considerably. This is done for the best hypothesis of each type because
+        // e.g. a rough cone may score less than a cylinder that covers a strip of it.
+        std::vector<unsigned long> inliers;
+        for (Candidate candidate : bestOfType) {
+            if (static_cast<double>(candidate.score) * remaining.size() / subset.size() < minSupport)
+                continue;
+
+            std::vector<unsigned long> support;
+            findInliers(candidate, support);
+            for (int iter = 0; iter < 5 && support.size() >= 7; iter++) {
+                Candidate refined = candidate;
+                if (!refitCandidate(points, support, refined))
+                    break;
+                std::vector<unsigned long> refinedSupport;
+                findInliers(refined, refinedSupport);
+                if (refinedSupport.size() < support.size())
+                    break;
+                bool grown = refinedSupport.size() > support.size();
+                candidate = refined;
+                support.swap(refinedSupport);
+                if (!grown)
+                    break;
+            }
+
+            if (support.size() > inliers.size()) {
+                best = candidate;
+                inliers.swap(support);
+            }
+        }
+
+        // keep only the largest connected part
+        if (clusterEpsilon > 0.0 && !inliers.empty()) {
+            std::vector<char> isInlier(points.size(), 0);
+            for (unsigned long index : inliers)
+                isInlier[index] = 1;
+
+            std::vector<unsigned long> largest;
+            std::vector<unsigned long> neighbours;
+            for (unsigned long start : inliers) {
+                if (isInlier[start] != 1)
+                    continue;
+                std::vector<unsigned long> component;
+                std::queue<unsigned long> front;
+                front.push(start);
+                isInlier[start] = 2;
+                while (!front.empty()) {
+                    unsigned long index = front.front();
+                    front.pop();
+                    component.push_back(index);
+                    grid.FindInRadius(points[index], clusterEpsilon, neighbours);
+                    for (unsigned long next : neighbours) {
+                        if (isInlier[next] == 1) {
+                            isInlier[next] = 2;
+                            front.push(next);
+                        }
+                    }
+                }
+                if (component.size() > largest.size())
+                    largest.swap(component);
+            }
+
+            std::sort(largest.begin(), largest.end());
+            inliers.swap(largest);
+        }
+
+        if (inliers.size() < minSupport) {
+            // a large candidate that falls apart, try again with other samples
+            if (++numFailures >= 3)
+                break;
+            continue;
+        }
+
+        numFailures = 0;
+        for (unsigned long index : inliers)
+            available[index] = 0;
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](unsigned long index) {
+            return !available[index];
+        }), remaining.end());
+
+        Primitive shape;
+        shape.type = best.type;
+        shape.base = best.base;
+        shape.axis = best.axis;
+        shape.radius = best.radius;
+        shape.angle = best.angle;
+        shape.inliers.swap(inliers);
+        primitives.push_back(std::move(shape));
+    }
+}
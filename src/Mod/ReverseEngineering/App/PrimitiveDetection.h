@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef REEN_PRIMITIVEDETECTION_H
+#define REEN_PRIMITIVEDETECTION_H
+
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+
+namespace Points {class PointKernel;}
+
+namespace Reen {
+
+/**
+ * The PrimitiveDetection class extracts planes, spheres, cylinders and cones from a
+ * point cloud with an efficient RANSAC approach (Schnabel et al. 2007).
+ * Hypotheses are built from small neighbourhoods of randomly drawn points and scored
+ * in parallel on a random subset of the remaining points. The best shape is extracted
+ * and the search continues on the rest until no shape with enough support is left.
+ * The result only depends on the seed, not on the number of threads.
+ */
+class PrimitiveDetection
+{
+public:
+    enum PrimitiveType
+    {
+        Plane,
+        Sphere,
+        Cylinder,
+        Cone
+    };
+
+    struct Primitive
+    {
+        PrimitiveType type;
+        Base::Vector3d base;                /**< point on plane, sphere center, point on axis or cone apex */
+        Base::Vector3d axis;                /**< plane normal or axis direction */
+        double radius = 0.0;                /**< sphere or cylinder radius */
+        double angle = 0.0;                 /**< half angle of the cone */
+        std::vector<unsigned long> inliers; /**< ascending indices of the supporting points */
+    };
+
+    /**
+     * The normals must be empty or of the same size as the points. If they are empty
+     * they are estimated from the neighbourhood of each point.
+     */
+    PrimitiveDetection(const Points::PointKernel&, const std::vector<Base::Vector3f>& normals);
+
+    /** Sets the primitives to search for, default are all. */
+    void setTypes(const std::vector<PrimitiveType>& t)
+    { types = t; }
+    /** Sets the maximum distance of a point to a shape, default is 0.01. */
+    void setEpsilon(double eps)
+    { epsilon = eps; }
+    /** Sets the maximum angle in radians between a point normal and the shape normal, default is 20 degrees. */
+    void setNormalDeviation(double angle)
+    { deviation = angle; }
+    /** Sets the minimum number of points of a shape, default is 100. */
+    void setMinSupport(unsigned long num)
+    { minSupport = num; }
+    /** Sets the probability to miss the largest shape in a search step, default is 0.01. */
+    void setProbability(double prob)
+    { probability = prob; }
+    /** Sets the maximum number of shapes. A value of 0 searches for all of them. */
+    void setMaxPrimitives(std::size_t num)
+    { maxPrimitives = num; }
+    /** Sets the distance to connect the points of a shape. If positive only the largest
+     * connected part of a shape is extracted, default is 0. */
+    void setClusterEpsilon(double eps)
+    { clusterEpsilon = eps; }
+    /** Sets the number of threads to use. A value of 0 or less uses all cores. */
+    void setThreads(int num)
+    { threads = num; }
+    /** Sets the seed of the random number generator. */
+    void setSeed(unsigned int s)
+    { seed = s; }
+
+    /** Extracts the shapes ordered by detection, i.e. usually by decreasing size. */
+    void perform(std::vector<Primitive>& primitives) const;
+
+private:
+    const Points::PointKernel& myPoints;
+    const std::vector<Base::Vector3f>& myNormals;
+    std::vector<PrimitiveType> types{Plane, Sphere, Cylinder, Cone};
+    double epsilon{0.01};
+    double deviation{0.349};
+    unsigned long minSupport{100};
+    double probability{0.01};
+    std::size_t maxPrimitives{0};
+    double clusterEpsilon{0.0};
+    int threads{0};
+    unsigned int seed{0};
+};
+
+} // namespace Reen
+
+#endif // REEN_PRIMITIVEDETECTION_H
@@ -24,6 +24,7 @@
 
 #include <Base/Exception.h>
 #include <Mod/Points/App/Points.h>
+#include <Mod/Points/App/PointsFilter.h>
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/Mesh/App/Core/Algorithm.h>
 #include <Mod/Mesh/App/Core/Elements.h>
@@ -60,6 +61,75 @@ using namespace pcl::io;
 using namespace std;
 using namespace Reen;
 
+namespace {
+
+// Estimates and orients the normals in parallel without going through an intermediate PCL cloud
+std::vector<Base::Vector3f> estimateNormals(const Points::PointKernel& pts, int ksearch)
+{
+    Points::NormalEstimation estimation(pts);
+    estimation.SetKSearch(static_cast<unsigned long>(std::max(ksearch, 3)));
+    estimation.SetOrientNormals(true);
+
+    std::vector<Base::Vector3f> normals;
+    estimation.Perform(normals);
+    return normals;
+}
+
+// Fills the PCL cloud in a single pass, invalid points are skipped
+PointCloud<PointNormal>::Ptr createCloud(const Points::PointKernel& pts, const std::vector<Base::Vector3f>& normals)
+{
+    PointCloud<PointNormal>::Ptr cloud (new PointCloud<PointNormal>);
+    cloud->reserve(pts.size());
+
+    std::size_t index = 0;
+    for (Points::PointKernel::const_point_iterator it = pts.begin(); it != pts.end(); ++it, ++index) {
+        if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z)) {
+            const Base::Vector3f& n = normals[index];
+            PointNormal pn;
+            pn.x = it->x;
+            pn.y = it->y;
+            pn.z = it->z;
+            pn.normal_x = n.x;
+            pn.normal_y = n.y;
+            pn.normal_z = n.z;
+            cloud->push_back(pn);
+        }
+    }
+
+    return cloud;
+}
+
+// Writes the typed cloud and polygons directly into the mesh kernel instead of going through
+// the serialized point data of a pcl::PolygonMesh
+template <typename PointT>
+void convertMesh(const PointCloud<PointT>& cloud, std::vector<Vertices>& polygons, Mesh::MeshObject& meshObject)
+{
+    MeshCore::MeshPointArray points;
+    points.reserve(cloud.size());
+    for (const auto& it : cloud.points)
+        points.push_back(Base::Vector3f(it.x, it.y, it.z));
+
+    MeshCore::MeshFacetArray facets;
+    facets.reserve(polygons.size());
+    MeshCore::MeshFacet face;
+    for (const auto& it : polygons) {
+        if (it.vertices.size() < 3)
+            continue;
+        face._aulPoints[0] = it.vertices[0];
+        face._aulPoints[1] = it.vertices[1];
+        face._aulPoints[2] = it.vertices[2];
+        facets.push_back(face);
+    }
+    std::vector<Vertices>().swap(polygons);
+
+    MeshCore::MeshKernel kernel;
+    kernel.Adopt(points, facets, true);
+    meshObject.swap(kernel);
+    meshObject.harmonizeNormals();
+}
+
+}
+
 // See
 // http://www.ics.uci.edu/~gopi/PAPERS/Euro00.pdf
 // http://www.ics.uci.edu/~gopi/PAPERS/CGMV.pdf
@@ -73,61 +143,7 @@ SurfaceTriangulation::SurfaceTriangulation(const Points::PointKernel& pts, Mesh:
 
 void SurfaceTriangulation::perform(int ksearch)
 {
-    PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
-    search::KdTree<PointXYZ>::Ptr tree;
-    search::KdTree<PointNormal>::Ptr tree2;
-
-    cloud->reserve(myPoints.size());
-    for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z))
-            cloud->push_back(PointXYZ(it->x, it->y, it->z));
-    }
-
-    // Create search tree
-    tree.reset (new search::KdTree<PointXYZ> (false));
-    tree->setInputCloud (cloud);
-
-    // Normal estimation
-    NormalEstimation<PointXYZ, Normal> n;
-    PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
-    n.setInputCloud (cloud);
-    //n.setIndices (indices[B);
-    n.setSearchMethod (tree);
-    n.setKSearch (ksearch);
-    n.compute (*normals);
-
-    // Concatenate XYZ and normal information
-    pcl::concatenateFields (*cloud, *normals, *cloud_with_normals);
-
-    // Create search tree
-    tree2.reset (new search::KdTree<PointNormal>);
-    tree2->setInputCloud (cloud_with_normals);
-
-    // Init objects
-    GreedyProjectionTriangulation<PointNormal> gp3;
-
-    // Set parameters
-    gp3.setInputCloud (cloud_with_normals);
-    gp3.setSearchMethod (tree2);
-    gp3.setSearchRadius (searchRadius);
-    gp3.setMu (mu);
-    gp3.setMaximumNearestNeighbors (100);
-    gp3.setMaximumSurfaceAngle(M_PI/4); // 45 degrees
-    gp3.setMinimumAngle(M_PI/18); // 10 degrees
-    gp3.setMaximumAngle(2*M_PI/3); // 120 degrees
-    gp3.setNormalConsistency(false);
-    gp3.setConsistentVertexOrdering(true);
-
-    // Reconstruct
-    PolygonMesh mesh;
-    gp3.reconstruct (mesh);
-
-    MeshConversion::convert(mesh, myMesh);
-
-    // Additional vertex information
-    //std::vector<int> parts = gp3.getPartIDs();
-    //std::vector<int> states = gp3.getPointStates();
+    perform(estimateNormals(myPoints, ksearch));
 }
 
 void SurfaceTriangulation::perform(const std::vector<Base::Vector3f>& normals)
@@ -135,27 +151,9 @@ void SurfaceTriangulation::perform(const std::vector<Base::Vector3f>& normals)
     if (myPoints.size() != normals.size())
         throw Base::RuntimeError("Number of points doesn't match with number of normals");
 
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
+    PointCloud<PointNormal>::Ptr cloud_with_normals = createCloud(myPoints, normals);
     search::KdTree<PointNormal>::Ptr tree;
 
-    cloud_with_normals->reserve(myPoints.size());
-    std::size_t num_points = myPoints.size();
-    const std::vector<Base::Vector3f>& points = myPoints.getBasicPoints();
-    for (std::size_t index=0; index<num_points; index++) {
-        const Base::Vector3f& p = points[index];
-        const Base::Vector3f& n = normals[index];
-        if (!boost::math::isnan(p.x) && !boost::math::isnan(p.y) && !boost::math::isnan(p.z)) {
-            PointNormal pn;
-            pn.x = p.x;
-            pn.y = p.y;
-            pn.z = p.z;
-            pn.normal_x = n.x;
-            pn.normal_y = n.y;
-            pn.normal_z = n.z;
-            cloud_with_normals->push_back(pn);
-        }
-    }
-
     // Create search tree
     tree.reset (new search::KdTree<PointNormal>);
     tree->setInputCloud (cloud_with_normals);
@@ -176,10 +174,10 @@ void SurfaceTriangulation::perform(const std::vector<Base::Vector3f>& normals)
     gp3.setConsistentVertexOrdering(true);
 
     // Reconstruct
-    PolygonMesh mesh;
-    gp3.reconstruct (mesh);
+    std::vector<Vertices> polygons;
+    gp3.reconstruct (polygons);
 
-    MeshConversion::convert(mesh, myMesh);
+    convertMesh(*cloud_with_normals, polygons, myMesh);
 
     // Additional vertex information
     //std::vector<int> parts = gp3.getPartIDs();
@@ -201,55 +199,7 @@ PoissonReconstruction::PoissonReconstruction(const Points::PointKernel& pts, Mes
 
 void PoissonReconstruction::perform(int ksearch)
 {
-    PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
-    search::KdTree<PointXYZ>::Ptr tree;
-    search::KdTree<PointNormal>::Ptr tree2;
-
-    cloud->reserve(myPoints.size());
-    for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z))
-            cloud->push_back(PointXYZ(it->x, it->y, it->z));
-    }
-
-    // Create search tree
-    tree.reset (new search::KdTree<PointXYZ> (false));
-    tree->setInputCloud (cloud);
-
-    // Normal estimation
-    NormalEstimation<PointXYZ, Normal> n;
-    PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
-    n.setInputCloud (cloud);
-    //n.setIndices (indices[B);
-    n.setSearchMethod (tree);
-    n.setKSearch (ksearch);
-    n.compute (*normals);
-
-    // Concatenate XYZ and normal information
-    pcl::concatenateFields (*cloud, *normals, *cloud_with_normals);
-
-    // Create search tree
-    tree2.reset (new search::KdTree<PointNormal>);
-    tree2->setInputCloud (cloud_with_normals);
-
-    // Init objects
-    Poisson<PointNormal> poisson;
-
-    // Set parameters
-    poisson.setInputCloud (cloud_with_normals);
-    poisson.setSearchMethod (tree2);
-    if (depth >= 1)
-        poisson.setDepth(depth);
-    if (solverDivide >= 1)
-        poisson.setSolverDivide(solverDivide);
-    if (samplesPerNode >= 1.0f)
-        poisson.setSamplesPerNode(samplesPerNode);
-
-    // Reconstruct
-    PolygonMesh mesh;
-    poisson.reconstruct (mesh);
-
-    MeshConversion::convert(mesh, myMesh);
+    perform(estimateNormals(myPoints, ksearch));
 }
 
 void PoissonReconstruction::perform(const std::vector<Base::Vector3f>& normals)
@@ -257,27 +207,9 @@ void PoissonReconstruction::perform(const std::vector<Base::Vector3f>& normals)
     if (myPoints.size() != normals.size())
         throw Base::RuntimeError("Number of points doesn't match with number of normals");
 
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
+    PointCloud<PointNormal>::Ptr cloud_with_normals = createCloud(myPoints, normals);
     search::KdTree<PointNormal>::Ptr tree;
 
-    cloud_with_normals->reserve(myPoints.size());
-    std::size_t num_points = myPoints.size();
-    const std::vector<Base::Vector3f>& points = myPoints.getBasicPoints();
-    for (std::size_t index=0; index<num_points; index++) {
-        const Base::Vector3f& p = points[index];
-        const Base::Vector3f& n = normals[index];
-        if (!boost::math::isnan(p.x) && !boost::math::isnan(p.y) && !boost::math::isnan(p.z)) {
-            PointNormal pn;
-            pn.x = p.x;
-            pn.y = p.y;
-            pn.z = p.z;
-            pn.normal_x = n.x;
-            pn.normal_y = n.y;
-            pn.normal_z = n.z;
-            cloud_with_normals->push_back(pn);
-        }
-    }
-
     // Create search tree
     tree.reset (new search::KdTree<PointNormal>);
     tree->setInputCloud (cloud_with_normals);
@@ -296,10 +228,11 @@ void PoissonReconstruction::perform(const std::vector<Base::Vector3f>& normals)
         poisson.setSamplesPerNode(samplesPerNode);
 
     // Reconstruct
-    PolygonMesh mesh;
-    poisson.reconstruct (mesh);
+    PointCloud<PointNormal> points;
+    std::vector<Vertices> polygons;
+    poisson.reconstruct (points, polygons);
 
-    MeshConversion::convert(mesh, myMesh);
+    convertMesh(points, polygons, myMesh);
 }
 
 // ----------------------------------------------------------------------------
@@ -312,53 +245,7 @@ GridReconstruction::GridReconstruction(const Points::PointKernel& pts, Mesh::Mes
 
 void GridReconstruction::perform(int ksearch)
 {
-    PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
-    search::KdTree<PointXYZ>::Ptr tree;
-    search::KdTree<PointNormal>::Ptr tree2;
-
-    cloud->reserve(myPoints.size());
-    for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z))
-            cloud->push_back(PointXYZ(it->x, it->y, it->z));
-    }
-
-    // Create search tree
-    tree.reset (new search::KdTree<PointXYZ> (false));
-    tree->setInputCloud (cloud);
-
-    // Normal estimation
-    NormalEstimation<PointXYZ, Normal> n;
-    PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
-    n.setInputCloud (cloud);
-    //n.setIndices (indices[B);
-    n.setSearchMethod (tree);
-    n.setKSearch (ksearch);
-    n.compute (*normals);
-
-    // Concatenate XYZ and normal information
-    pcl::concatenateFields (*cloud, *normals, *cloud_with_normals);
-
-    // Create search tree
-    tree2.reset (new search::KdTree<PointNormal>);
-    tree2->setInputCloud (cloud_with_normals);
-
-    // Init objects
-    GridProjection<PointNormal> grid;
-
-    // Set parameters
-    grid.setResolution(0.005);
-    grid.setPaddingSize(3);
-    grid.setNearestNeighborNum(100);
-    grid.setMaxBinarySearchLevel(10);
-    grid.setInputCloud (cloud_with_normals);
-    grid.setSearchMethod (tree2);
-
-    // Reconstruct
-    PolygonMesh mesh;
-    grid.reconstruct (mesh);
-
-    MeshConversion::convert(mesh, myMesh);
+    perform(estimateNormals(myPoints, ksearch));
 }
 
 void GridReconstruction::perform(const std::vector<Base::Vector3f>& normals)
@@ -366,27 +253,9 @@ void GridReconstruction::perform(const std::vector<Base::Vector3f>& normals)
     if (myPoints.size() != normals.size())
         throw Base::RuntimeError("Number of points doesn't match with number of normals");
 
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
+    PointCloud<PointNormal>::Ptr cloud_with_normals = createCloud(myPoints, normals);
     search::KdTree<PointNormal>::Ptr tree;
 
-    cloud_with_normals->reserve(myPoints.size());
-    std::size_t num_points = myPoints.size();
-    const std::vector<Base::Vector3f>& points = myPoints.getBasicPoints();
-    for (std::size_t index=0; index<num_points; index++) {
-        const Base::Vector3f& p = points[index];
-        const Base::Vector3f& n = normals[index];
-        if (!boost::math::isnan(p.x) && !boost::math::isnan(p.y) && !boost::math::isnan(p.z)) {
-            PointNormal pn;
-            pn.x = p.x;
-            pn.y = p.y;
-            pn.z = p.z;
-            pn.normal_x = n.x;
-            pn.normal_y = n.y;
-            pn.normal_z = n.z;
-            cloud_with_normals->push_back(pn);
-        }
-    }
-
     // Create search tree
     tree.reset (new search::KdTree<PointNormal>);
     tree->setInputCloud (cloud_with_normals);
@@ -403,10 +272,11 @@ void GridReconstruction::perform(const std::vector<Base::Vector3f>& normals)
     grid.setSearchMethod (tree);
 
     // Reconstruct
-    PolygonMesh mesh;
-    grid.reconstruct (mesh);
+    PointCloud<PointNormal> points;
+    std::vector<Vertices> polygons;
+    grid.reconstruct (points, polygons);
 
-    MeshConversion::convert(mesh, myMesh);
+    convertMesh(points, polygons, myMesh);
 }
 
 // ----------------------------------------------------------------------------
@@ -454,10 +324,10 @@ void ImageTriangulation::perform()
     ofm.storeShadowedFaces(true);
 
     // Reconstruct
-    PolygonMesh mesh;
-    ofm.reconstruct (mesh);
+    std::vector<Vertices> polygons;
+    ofm.reconstruct (polygons);
 
-    MeshConversion::convert(mesh, myMesh);
+    convertMesh(*cloud_organized, polygons, myMesh);
 
     // remove invalid points
     //
@@ -498,54 +368,7 @@ Reen::MarchingCubesRBF::MarchingCubesRBF(const Points::PointKernel& pts, Mesh::M
 
 void Reen::MarchingCubesRBF::perform(int ksearch)
 {
-    PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
-    search::KdTree<PointXYZ>::Ptr tree;
-    search::KdTree<PointNormal>::Ptr tree2;
-
-    cloud->reserve(myPoints.size());
-    for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z))
-            cloud->push_back(PointXYZ(it->x, it->y, it->z));
-    }
-
-    // Create search tree
-    tree.reset (new search::KdTree<PointXYZ> (false));
-    tree->setInputCloud (cloud);
-
-    // Normal estimation
-    NormalEstimation<PointXYZ, Normal> n;
-    PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
-    n.setInputCloud (cloud);
-    //n.setIndices (indices[B);
-    n.setSearchMethod (tree);
-    n.setKSearch (ksearch);
-    n.compute (*normals);
-
-    // Concatenate XYZ and normal information
-    pcl::concatenateFields (*cloud, *normals, *cloud_with_normals);
-
-    // Create search tree
-    tree2.reset (new search::KdTree<PointNormal>);
-    tree2->setInputCloud (cloud_with_normals);
-
-    // Init objects
-    pcl::MarchingCubesRBF<PointNormal> rbf;
-
-    // Set parameters
-    rbf.setIsoLevel (0);
-    rbf.setGridResolution (60, 60, 60);
-    rbf.setPercentageExtendGrid (0.1f);
-    rbf.setOffSurfaceDisplacement (0.02f);
-
-    rbf.setInputCloud (cloud_with_normals);
-    rbf.setSearchMethod (tree2);
-
-    // Reconstruct
-    PolygonMesh mesh;
-    rbf.reconstruct (mesh);
-
-    MeshConversion::convert(mesh, myMesh);
+    perform(estimateNormals(myPoints, ksearch));
 }
 
 void Reen::MarchingCubesRBF::perform(const std::vector<Base::Vector3f>& normals)
@@ -553,27 +376,9 @@ void Reen::MarchingCubesRBF::perform(const std::vector<Base::Vector3f>& normals)
     if (myPoints.size() != normals.size())
         throw Base::RuntimeError("Number of points doesn't match with number of normals");
 
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
+    PointCloud<PointNormal>::Ptr cloud_with_normals = createCloud(myPoints, normals);
     search::KdTree<PointNormal>::Ptr tree;
 
-    cloud_with_normals->reserve(myPoints.size());
-    std::size_t num_points = myPoints.size();
-    const std::vector<Base::Vector3f>& points = myPoints.getBasicPoints();
-    for (std::size_t index=0; index<num_points; index++) {
-        const Base::Vector3f& p = points[index];
-        const Base::Vector3f& n = normals[index];
-        if (!boost::math::isnan(p.x) && !boost::math::isnan(p.y) && !boost::math::isnan(p.z)) {
-            PointNormal pn;
-            pn.x = p.x;
-            pn.y = p.y;
-            pn.z = p.z;
-            pn.normal_x = n.x;
-            pn.normal_y = n.y;
-            pn.normal_z = n.z;
-            cloud_with_normals->push_back(pn);
-        }
-    }
-
     // Create search tree
     tree.reset (new search::KdTree<PointNormal>);
     tree->setInputCloud (cloud_with_normals);
@@ -592,10 +397,11 @@ void Reen::MarchingCubesRBF::perform(const std::vector<Base::Vector3f>& normals)
     rbf.setSearchMethod (tree);
 
     // Reconstruct
-    PolygonMesh mesh;
-    rbf.reconstruct (mesh);
+    PointCloud<PointNormal> points;
+    std::vector<Vertices> polygons;
+    rbf.reconstruct (points, polygons);
 
-    MeshConversion::convert(mesh, myMesh);
+    convertMesh(points, polygons, myMesh);
 }
 
 // ----------------------------------------------------------------------------
@@ -608,53 +414,7 @@ Reen::MarchingCubesHoppe::MarchingCubesHoppe(const Points::PointKernel& pts, Mes
 
 void Reen::MarchingCubesHoppe::perform(int ksearch)
 {
-    PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
-    search::KdTree<PointXYZ>::Ptr tree;
-    search::KdTree<PointNormal>::Ptr tree2;
-
-    cloud->reserve(myPoints.size());
-    for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z))
-            cloud->push_back(PointXYZ(it->x, it->y, it->z));
-    }
-
-    // Create search tree
-    tree.reset (new search::KdTree<PointXYZ> (false));
-    tree->setInputCloud (cloud);
-
-    // Normal estimation
-    NormalEstimation<PointXYZ, Normal> n;
-    PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
-    n.setInputCloud (cloud);
-    //n.setIndices (indices[B);
-    n.setSearchMethod (tree);
-    n.setKSearch (ksearch);
-    n.compute (*normals);
-
-    // Concatenate XYZ and normal information
-    pcl::concatenateFields (*cloud, *normals, *cloud_with_normals);
-
-    // Create search tree
-    tree2.reset (new search::KdTree<PointNormal>);
-    tree2->setInputCloud (cloud_with_normals);
-
-    // Init objects
-    pcl::MarchingCubesHoppe<PointNormal> hoppe;
-
-    // Set parameters
-    hoppe.setIsoLevel (0);
-    hoppe.setGridResolution (60, 60, 60);
-    hoppe.setPercentageExtendGrid (0.1f);
-
-    hoppe.setInputCloud (cloud_with_normals);
-    hoppe.setSearchMethod (tree2);
-
-    // Reconstruct
-    PolygonMesh mesh;
-    hoppe.reconstruct (mesh);
-
-    MeshConversion::convert(mesh, myMesh);
+    perform(estimateNormals(myPoints, ksearch));
 }
 
 void Reen::MarchingCubesHoppe::perform(const std::vector<Base::Vector3f>& normals)
@@ -662,27 +422,9 @@ void Reen::MarchingCubesHoppe::perform(const std::vector<Base::Vector3f>& normal
     if (myPoints.size() != normals.size())
         throw Base::RuntimeError("Number of points doesn't match with number of normals");
 
-    PointCloud<PointNormal>::Ptr cloud_with_normals (new PointCloud<PointNormal>);
+    PointCloud<PointNormal>::Ptr cloud_with_normals = createCloud(myPoints, normals);
     search::KdTree<PointNormal>::Ptr tree;
 
-    cloud_with_normals->reserve(myPoints.size());
-    std::size_t num_points = myPoints.size();
-    const std::vector<Base::Vector3f>& points = myPoints.getBasicPoints();
-    for (std::size_t index=0; index<num_points; index++) {
-        const Base::Vector3f& p = points[index];
-        const Base::Vector3f& n = normals[index];
-        if (!boost::math::isnan(p.x) && !boost::math::isnan(p.y) && !boost::math::isnan(p.z)) {
-            PointNormal pn;
-            pn.x = p.x;
-            pn.y = p.y;
-            pn.z = p.z;
-            pn.normal_x = n.x;
-            pn.normal_y = n.y;
-            pn.normal_z = n.z;
-            cloud_with_normals->push_back(pn);
-        }
-    }
-
     // Create search tree
     tree.reset (new search::KdTree<PointNormal>);
     tree->setInputCloud (cloud_with_normals);
@@ -700,67 +442,11 @@ void Reen::MarchingCubesHoppe::perform(const std::vector<Base::Vector3f>& normal
     hoppe.setSearchMethod (tree);
 
     // Reconstruct
-    PolygonMesh mesh;
-    hoppe.reconstruct (mesh);
+    PointCloud<PointNormal> points;
+    std::vector<Vertices> polygons;
+    hoppe.reconstruct (points, polygons);
 
-    MeshConversion::convert(mesh, myMesh);
-}
-
-// ----------------------------------------------------------------------------
-
-void MeshConversion::convert(const pcl::PolygonMesh& pclMesh, Mesh::MeshObject& meshObject)
-{
-    // number of points
-    size_t nr_points  = pclMesh.cloud.width * pclMesh.cloud.height;
-    size_t point_size = pclMesh.cloud.data.size () / nr_points;
-    // number of faces for header
-    size_t nr_faces = pclMesh.polygons.size ();
-
-    MeshCore::MeshPointArray points;
-    points.reserve(nr_points);
-    MeshCore::MeshFacetArray facets;
-    facets.reserve(nr_faces);
-
-    // get vertices
-    MeshCore::MeshPoint vertex;
-    for (size_t i = 0; i < nr_points; ++i) {
-        int xyz = 0;
-        for (size_t d = 0; d < pclMesh.cloud.fields.size(); ++d) {
-            int c = 0;
-            // adding vertex
-            if ((pclMesh.cloud.fields[d].datatype ==
-#if PCL_VERSION_COMPARE(>,1,6,0)
-                 pcl::PCLPointField::FLOAT32) &&
-#else
-                 sensor_msgs::PointField::FLOAT32) &&
-#endif
-                (pclMesh.cloud.fields[d].name == "x" ||
-                 pclMesh.cloud.fields[d].name == "y" ||
-                 pclMesh.cloud.fields[d].name == "z"))
-            {
-                float value;
-                memcpy (&value, &pclMesh.cloud.data[i * point_size + pclMesh.cloud.fields[d].offset + c * sizeof (float)], sizeof (float));
-                vertex[xyz] = value;
-                if (++xyz == 3) {
-                    points.push_back(vertex);
-                    break;
-                }
-            }
-        }
-    }
-    // get faces
-    MeshCore::MeshFacet face;
-    for (size_t i = 0; i < nr_faces; i++) {
-        face._aulPoints[0] = pclMesh.polygons[i].vertices[0];
-        face._aulPoints[1] = pclMesh.polygons[i].vertices[1];
-        face._aulPoints[2] = pclMesh.polygons[i].vertices[2];
-        facets.push_back(face);
-    }
-
-    MeshCore::MeshKernel kernel;
-    kernel.Adopt(points, facets, true);
-    meshObject.swap(kernel);
-    meshObject.harmonizeNormals();
+    convertMesh(points, polygons, myMesh);
 }
 
 #endif // HAVE_PCL_SURFACE
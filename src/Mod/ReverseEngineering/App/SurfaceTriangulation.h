@@ -30,16 +30,9 @@
 
 namespace Points {class PointKernel;}
 namespace Mesh {class MeshObject;}
-namespace pcl {struct PolygonMesh;}
 
 namespace Reen {
 
-class MeshConversion
-{
-public:
-    static void convert(const pcl::PolygonMesh&, Mesh::MeshObject&);
-};
-
 class SurfaceTriangulation
 {
 public:
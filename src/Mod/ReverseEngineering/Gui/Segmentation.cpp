@@ -92,7 +92,9 @@ void Segmentation::accept()
     }
 
     MeshCore::MeshSegmentAlgorithm finder(kernel);
+    finder.SetThreads(0);
     MeshCore::MeshCurvature meshCurv(kernel);
+    meshCurv.SetThreads(0);
     meshCurv.ComputePerVertex();
 
     // First create segments by curavture to get the surface type
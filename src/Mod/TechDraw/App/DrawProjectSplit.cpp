@@ -22,10 +22,17 @@
 
 #include "PreCompiled.h"
 
+// From Boost 1.75 on the geometry component requires C++14
+#define BOOST_GEOMETRY_DISABLE_DEPRECATED_03_WARNING
+
 #ifndef _PreComp_
 # include <algorithm>
+# include <cmath>
 # include <limits>
 # include <sstream>
+# include <boost_geometry.hpp>
+# include <boost/geometry/index/rtree.hpp>
+# include <QtConcurrentMap>
 #include <Bnd_Box.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepAdaptor_Curve.hxx>
@@ -56,6 +63,109 @@
 
 using namespace TechDraw;
 
+namespace bg = boost::geometry;
+namespace bgi = boost::geometry::index;
+
+namespace {
+
+//the pair loops below only need the exact (and expensive) checks for edges with
+//overlapping bounding boxes.  The boxes go into an rtree so each edge finds its
+//neighbours without visiting every other edge.
+using BoxPoint = bg::model::point<double, 3, bg::cs::cartesian>;
+using EdgeBox = bg::model::box<BoxPoint>;
+using BoxValue = std::pair<EdgeBox, int>;
+using BoxTree = bgi::rtree<BoxValue, bgi::linear<16>>;
+
+//the bounding boxes of a pile of edges, with the same generous gap as boxesIntersect
+class EdgeBoxes
+{
+public:
+    explicit EdgeBoxes(const std::vector<TopoDS_Edge>& edges, bool optimal = false)
+        : m_optimal(optimal)
+    {
+        std::vector<BoxValue> values;
+        for (auto& edge: edges) {
+            if (addBox(edge)) {
+                values.emplace_back(m_boxes.back(), int(m_boxes.size()) - 1);
+            }
+        }
+        m_tree = BoxTree(values);       //packing is faster than inserting one by one
+    }
+
+    //add the box of a new edge at the end of the pile
+    void add(const TopoDS_Edge& edge)
+    {
+        if (addBox(edge)) {
+            m_tree.insert(BoxValue(m_boxes.back(), int(m_boxes.size()) - 1));
+        }
+    }
+
+    //a void box intersects nothing
+    bool isVoid(int index) const
+    {
+        return !m_valid.at(index);
+    }
+
+    bool intersects(int index0, int index1) const
+    {
+        return !isVoid(index0) && !isVoid(index1) &&
+               bg::intersects(m_boxes.at(index0), m_boxes.at(index1));
+    }
+
+    //the other edges from index first on whose boxes intersect the box of edge
+    //index, in ascending order so the pair loops visit them in the same order as before.
+    std::vector<int> touching(int index, int first = 0) const
+    {
+        std::vector<int> result;
+        if (isVoid(index)) {
+            return result;
+        }
+        for (auto it = m_tree.qbegin(bgi::intersects(m_boxes.at(index))); it != m_tree.qend(); ++it) {
+            if (it->second >= first && it->second != index) {
+                result.push_back(it->second);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+private:
+    bool addBox(const TopoDS_Edge& edge)
+    {
+        Bnd_Box bnd;
+        if (m_optimal) {
+            BRepBndLib::AddOptimal(edge, bnd);
+        } else {
+            BRepBndLib::Add(edge, bnd);
+        }
+        bnd.SetGap(0.1);
+        m_boxes.emplace_back();
+        m_valid.push_back(!bnd.IsVoid());
+        if (bnd.IsVoid()) {
+            return false;
+        }
+        double xMin, yMin, zMin, xMax, yMax, zMax;
+        bnd.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        m_boxes.back() = EdgeBox(BoxPoint(xMin, yMin, zMin), BoxPoint(xMax, yMax, zMax));
+        return true;
+    }
+
+    bool m_optimal;
+    std::vector<EdgeBox> m_boxes;
+    std::vector<bool> m_valid;
+    BoxTree m_tree;
+};
+
+//the splits found for one edge of DrawProjectSplit::getEdges
+struct EdgeSplits
+{
+    int index;
+    std::vector<int> others;
+    std::vector<splitPoint> splits;
+};
+
+}   //end anonymous namespace
+
 //===========================================================================
 // DrawProjectSplit
 //===========================================================================
@@ -129,72 +239,65 @@ std::vector<TopoDS_Edge> DrawProjectSplit::getEdges(TechDraw::GeometryObject* ge
         origEdges.push_back((*itEdge)->getOCCEdge());
     }
 
-    std::vector<TopoDS_Edge> faceEdges;
     std::vector<TopoDS_Edge> nonZero;
     for (auto& e:origEdges) {                            //drop any zero edges (shouldn't be any by now!!!)
         if (!DrawUtil::isZeroEdge(e, 2.0 * EWTOLERANCE)) {
             nonZero.push_back(e);
         }
     }
-    faceEdges = nonZero;
-    origEdges = nonZero;
+    return getEdges(nonZero);
+}
 
+//! split the edges where a vertex of another edge touches them and drop the duplicates.
+std::vector<TopoDS_Edge> DrawProjectSplit::getEdges(const std::vector<TopoDS_Edge>& faceEdges)
+{
     //HLR algo does not provide all edge intersections for edge endpoints.
     //need to split long edges touched by Vertex of another edge
-    std::vector<splitPoint> splits;
-    std::vector<TopoDS_Edge>::iterator itOuter = origEdges.begin();
-    int iOuter = 0;
-    for (; itOuter != origEdges.end(); ++itOuter, iOuter++) {
-        TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-        TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-        Bnd_Box sOuter;
-        BRepBndLib::AddOptimal(*itOuter, sOuter);
-        sOuter.SetGap(0.1);
-        if (sOuter.IsVoid()) {
+    //only edges with intersecting boxes can touch, so the candidates for each
+    //edge come from the box tree instead of a loop over all the other edges
+    EdgeBoxes boxes(faceEdges, true);
+    std::vector<EdgeSplits> work;
+    int edgeCount = faceEdges.size();
+    for (int iOuter = 0; iOuter < edgeCount; iOuter++) {
+        if (boxes.isVoid(iOuter)) {
             continue;
         }
-        if (DrawUtil::isZeroEdge(*itOuter)) {
-            continue;  //skip zero length edges. shouldn't happen ;)
-        }
-        int iInner = 0;
-        std::vector<TopoDS_Edge>::iterator itInner = faceEdges.begin();
-        for (; itInner != faceEdges.end(); ++itInner, iInner++) {
-            if (iInner == iOuter) {
-                continue;
-            }
-            if (DrawUtil::isZeroEdge((*itInner))) {
-                continue;  //skip zero length edges. shouldn't happen ;)
-            }
-
-            Bnd_Box sInner;
-            BRepBndLib::AddOptimal(*itInner, sInner);
-            sInner.SetGap(0.1);
-            if (sInner.IsVoid()) {
-                continue;
-            }
-            if (sOuter.IsOut(sInner)) {      //bboxes of edges don't intersect, don't bother
-                continue;
-            }
+        EdgeSplits item;
+        item.index = iOuter;
+        item.others = boxes.touching(iOuter);
+        work.push_back(std::move(item));
+    }
 
+    //isOnEdge only reads the edges, so the outer edges can be checked in parallel
+    QtConcurrent::blockingMap(work, [&faceEdges](EdgeSplits& item) {
+        const TopoDS_Edge& outer = faceEdges.at(item.index);
+        TopoDS_Vertex v1 = TopExp::FirstVertex(outer);
+        TopoDS_Vertex v2 = TopExp::LastVertex(outer);
+        for (int iInner: item.others) {
             double param = -1;
-            if (isOnEdge((*itInner), v1, param, false)) {
+            if (isOnEdge(faceEdges.at(iInner), v1, param, false)) {
                 gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
                 splitPoint s1;
                 s1.i = iInner;
                 s1.v = Base::Vector3d(pnt1.X(), pnt1.Y(), pnt1.Z());
                 s1.param = param;
-                splits.push_back(s1);
+                item.splits.push_back(s1);
             }
-            if (isOnEdge((*itInner), v2, param, false)) {
+            if (isOnEdge(faceEdges.at(iInner), v2, param, false)) {
                 gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
                 splitPoint s2;
                 s2.i = iInner;
                 s2.v = Base::Vector3d(pnt2.X(), pnt2.Y(), pnt2.Z());
                 s2.param = param;
-                splits.push_back(s2);
+                item.splits.push_back(s2);
             }
-        } //inner loop
-    }   //outer loop
+        }
+    });
+
+    std::vector<splitPoint> splits;
+    for (auto& item: work) {
+        splits.insert(splits.end(), item.splits.begin(), item.splits.end());
+    }
 
     std::vector<splitPoint> sorted = sortSplits(splits, true);
     auto last = std::unique(sorted.begin(), sorted.end(), DrawProjectSplit::splitEqual);  //duplicates to back
@@ -549,21 +652,9 @@ vertexMap DrawProjectSplit::getUniqueVertexes(std::vector<TopoDS_Edge> inEdges)
     //count the occurrences of each vertex in the pile
     for (auto& edge: inEdges) {
         gp_Pnt p = BRep_Tool::Pnt(TopExp::FirstVertex(edge));
-        Base::Vector3d v0(p.X(), p.Y(), p.Z());
-        vertexMap::iterator it0(verts.find(v0));
-        if (it0 != verts.end()) {
-            it0->second++;
-        } else {
-            verts[v0] = 1;
-        }
+        verts.add(Base::Vector3d(p.X(), p.Y(), p.Z()));
         p = BRep_Tool::Pnt(TopExp::LastVertex(edge));
-        Base::Vector3d v1(p.X(), p.Y(), p.Z());
-        vertexMap::iterator it1(verts.find(v1));
-        if (it1 != verts.end()) {
-            it1->second++;
-        } else {
-            verts[v1] = 1;
-        }
+        verts.add(Base::Vector3d(p.X(), p.Y(), p.Z()));
     }
     return verts;
 }
@@ -580,19 +671,9 @@ std::vector<TopoDS_Edge> DrawProjectSplit::pruneUnconnected(vertexMap verts,
     std::vector<TopoDS_Edge> deadEnds;
     for (auto& edge: edges) {
         gp_Pnt p = BRep_Tool::Pnt(TopExp::FirstVertex(edge));
-        Base::Vector3d v0(p.X(), p.Y(), p.Z());
-        int count0 = 0;
-        vertexMap::iterator it0(verts.find(v0));
-        if (it0 != verts.end()) {
-            count0 = it0->second;
-        }
+        int count0 = verts.count(Base::Vector3d(p.X(), p.Y(), p.Z()));
         p = BRep_Tool::Pnt(TopExp::LastVertex(edge));
-        Base::Vector3d v1(p.X(), p.Y(), p.Z());
-        int count1 = 0;
-        vertexMap::iterator it1(verts.find(v1));
-        if (it1 != verts.end()) {
-            count1 = it1->second;
-        }
+        int count1 = verts.count(Base::Vector3d(p.X(), p.Y(), p.Z()));
         if ((count0 > 1) && (count1 > 1)) {           //connected at both ends
             newPile.push_back(edge);
         } else if ((count0 == 1) && (count1 == 1)) {
@@ -638,14 +719,15 @@ std::vector<TopoDS_Edge> DrawProjectSplit::removeOverlapEdges(const std::vector<
     std::vector<TopoDS_Edge> outEdges;
     std::vector<TopoDS_Edge> overlapEdges;
     std::vector<bool> skipThisEdge(inEdges.size(), false);
+    EdgeBoxes boxes(inEdges);
     int edgeCount = inEdges.size();
     int ie0 = 0;
     for (; ie0 < edgeCount; ie0++) {
         if (skipThisEdge.at(ie0)) {
             continue;
         }
-        int ie1 = ie0 + 1;
-        for (; ie1 < edgeCount; ie1++) {
+        //edges whose boxes don't intersect are not a subset of each other
+        for (int ie1 : boxes.touching(ie0, ie0 + 1)) {
             if (skipThisEdge.at(ie1)) {
                 continue;
             }
@@ -755,102 +837,109 @@ std::vector<TopoDS_Edge> DrawProjectSplit::splitIntersectingEdges(std::vector<To
 //    Base::Console().Message("DPS::splitIntersectingEdges() - edges in: %d\n", inEdges.size());
     std::vector<TopoDS_Edge> outEdges;
     std::vector<bool> skipThisEdge(inEdges.size(), false);
+    EdgeBoxes boxes(inEdges);
     int edgeCount = inEdges.size();
     int iEdge0 = 0;
     for (; iEdge0 < edgeCount; iEdge0++) {  //all but last one
         if (skipThisEdge.at(iEdge0)) {
             continue;
         }
-        int iEdge1 = iEdge0 + 1;
+        //only the edges whose boxes intersect the outer edge's box need fusing.
+        //pieces split off while the inner loop runs are appended to the candidates
+        //if their boxes intersect it too.
+        std::vector<int> candidates = boxes.touching(iEdge0, iEdge0 + 1);
+        auto addPiece = [&](const TopoDS_Edge& piece) {
+            inEdges.push_back(piece);
+            skipThisEdge.push_back(false);
+            boxes.add(piece);
+            if (boxes.intersects(iEdge0, edgeCount)) {
+                candidates.push_back(edgeCount);
+            }
+            edgeCount++;
+        };
         bool outerEdgeSplit = false;
-        for (; iEdge1 < edgeCount; iEdge1++) {
+        for (size_t iCandidate = 0; iCandidate < candidates.size(); iCandidate++) {
+            int iEdge1 = candidates.at(iCandidate);
             if (skipThisEdge.at(iEdge1)) {
                 continue;
             }
 
-            if (boxesIntersect(inEdges.at(iEdge0), inEdges.at(iEdge1))) {
-                std::vector<TopoDS_Edge> intersectEdges = fuseEdges(inEdges.at(iEdge0), inEdges.at(iEdge1));
-                if (intersectEdges.empty()) {
-                    //don't think this can happen. fusion of disjoint edges is 2 edges.
-                    //maybe an error?
-                    continue;   //next inner edge
-                }
+            std::vector<TopoDS_Edge> intersectEdges = fuseEdges(inEdges.at(iEdge0), inEdges.at(iEdge1));
+            if (intersectEdges.empty()) {
+                //don't think this can happen. fusion of disjoint edges is 2 edges.
+                //maybe an error?
+                continue;   //next inner edge
+            }
 
-                if (intersectEdges.size() == 1) {
-                    //one edge is a subset of the other.
-                    if (sameEndPoints(inEdges.at(iEdge0), intersectEdges.front())) {
-                        //we got the outer edge back so mark the inner edge
-                        skipThisEdge.at(iEdge1) = true;
-                    } else if (sameEndPoints(inEdges.at(iEdge1), intersectEdges.front())) {
-                        //we got the inner edge back so mark the outer edge and go to the next outer edge
-                        skipThisEdge.at(iEdge0) = true;
-                        break;          //next outer edge
-                    } else {
-                        //not sure what this means?  bad geometry?
-                    }
+            if (intersectEdges.size() == 1) {
+                //one edge is a subset of the other.
+                if (sameEndPoints(inEdges.at(iEdge0), intersectEdges.front())) {
+                    //we got the outer edge back so mark the inner edge
+                    skipThisEdge.at(iEdge1) = true;
+                } else if (sameEndPoints(inEdges.at(iEdge1), intersectEdges.front())) {
+                    //we got the inner edge back so mark the outer edge and go to the next outer edge
+                    skipThisEdge.at(iEdge0) = true;
+                    break;          //next outer edge
+                } else {
+                    //not sure what this means?  bad geometry?
+                }
 
-                } else if (intersectEdges.size() == 2) {
-                    //got the input edges back, so no intersection. carry on with next inner edge
-                    continue;    //next inner edge
-
-                } else if (intersectEdges.size() == 3) {
-                    //we have split 1 edge at a vertex of the other edge
-                    //check if outer edge is the one split
-                    bool innerEdgeSplit = false;
-                    for (auto& interEdge : intersectEdges) {
-                        if (!sameEndPoints(inEdges.at(iEdge0), interEdge) &&
-                            !sameEndPoints(inEdges.at(iEdge1), interEdge)) {
-                            //interEdge does not match either outer or inner edge,
-                            //so this is a piece of the split edge and we need to add it
-                            //to end of list
-                            inEdges.push_back(interEdge);
-                            skipThisEdge.push_back(false);
-                            edgeCount++;
-                         }
-                        if (sameEndPoints(inEdges.at(iEdge0), interEdge)) {
-                            //outer edge is in output, so it was not split.
-                            //therefore the inner edge was split and we should skip it in the future
-                            //the two pieces of the split edge will have been added to edgesToKeep
-                            //in the previous if
-                            innerEdgeSplit = true;
-                            skipThisEdge.at(iEdge1) = true;
-                        } else if (sameEndPoints(inEdges.at(iEdge1), interEdge)) {
-                            //inner edge is in output, so it was not split.
-                            //therefore the outer edge was split and we should skip it in the future.
-                            outerEdgeSplit = true;
-                            skipThisEdge.at(iEdge0) = true;
-                        }
-                    }
-                    if (!innerEdgeSplit && !outerEdgeSplit) {
-                        //neither edge found in output, so this was a partial overlap, so
-                        //both edges are replaced by the 3 split pieces
-                        //Q: why does this happen if we have run pruneOverlaps before this???
-                        skipThisEdge.at(iEdge0) = true;
+            } else if (intersectEdges.size() == 2) {
+                //got the input edges back, so no intersection. carry on with next inner edge
+                continue;    //next inner edge
+
+            } else if (intersectEdges.size() == 3) {
+                //we have split 1 edge at a vertex of the other edge
+                //check if outer edge is the one split
+                bool innerEdgeSplit = false;
+                for (auto& interEdge : intersectEdges) {
+                    if (!sameEndPoints(inEdges.at(iEdge0), interEdge) &&
+                        !sameEndPoints(inEdges.at(iEdge1), interEdge)) {
+                        //interEdge does not match either outer or inner edge,
+                        //so this is a piece of the split edge and we need to add it
+                        //to end of list
+                        addPiece(interEdge);
+                     }
+                    if (sameEndPoints(inEdges.at(iEdge0), interEdge)) {
+                        //outer edge is in output, so it was not split.
+                        //therefore the inner edge was split and we should skip it in the future
+                        //the two pieces of the split edge will have been added to edgesToKeep
+                        //in the previous if
+                        innerEdgeSplit = true;
                         skipThisEdge.at(iEdge1) = true;
+                    } else if (sameEndPoints(inEdges.at(iEdge1), interEdge)) {
+                        //inner edge is in output, so it was not split.
+                        //therefore the outer edge was split and we should skip it in the future.
                         outerEdgeSplit = true;
+                        skipThisEdge.at(iEdge0) = true;
                     }
-                    if (outerEdgeSplit) {
-                        //we can't use the outer edge any more, so we should exit the inner loop
-                        break;
-                    }
-
-                } else if (intersectEdges.size() == 4) {
-                    //we have split both edges at a single intersection
+                }
+                if (!innerEdgeSplit && !outerEdgeSplit) {
+                    //neither edge found in output, so this was a partial overlap, so
+                    //both edges are replaced by the 3 split pieces
+                    //Q: why does this happen if we have run pruneOverlaps before this???
                     skipThisEdge.at(iEdge0) = true;
                     skipThisEdge.at(iEdge1) = true;
-                    inEdges.insert(inEdges.end(), intersectEdges.begin(), intersectEdges.end());
-                    skipThisEdge.insert(skipThisEdge.end(), { false, false, false, false});
-                    edgeCount += 4;
                     outerEdgeSplit = true;
+                }
+                if (outerEdgeSplit) {
+                    //we can't use the outer edge any more, so we should exit the inner loop
                     break;
+                }
 
-                } else {
-                    //this means multiple intersections of the 2 edges. we don't handle that yet.
-                    continue;  //next inner edge?
+            } else if (intersectEdges.size() == 4) {
+                //we have split both edges at a single intersection
+                skipThisEdge.at(iEdge0) = true;
+                skipThisEdge.at(iEdge1) = true;
+                for (auto& interEdge : intersectEdges) {
+                    addPiece(interEdge);
                 }
+                outerEdgeSplit = true;
+                break;
 
             } else {
-                //bboxes of edges do not intersect, so edges do not intersect
+                //this means multiple intersections of the 2 edges. we don't handle that yet.
+                continue;  //next inner edge?
             }
         }  //inner loop boundary
 
@@ -882,6 +971,72 @@ bool DrawProjectSplit::boxesIntersect(const TopoDS_Edge &edge0, const TopoDS_Edg
     return true;
 }
 
+//*************************
+//* vertexMap Methods
+//*************************
+void vertexMap::add(const Base::Vector3d& point)
+{
+    int index = find(point);
+    if (index >= 0) {
+        m_verts.at(index).second++;
+        return;
+    }
+    m_cells[cellOf(point)].push_back(m_verts.size());
+    m_verts.emplace_back(point, 1);
+}
+
+int vertexMap::count(const Base::Vector3d& point) const
+{
+    int index = find(point);
+    if (index >= 0) {
+        return m_verts.at(index).second;
+    }
+    return 0;
+}
+
+//the index of the first vertex within EWTOLERANCE of point or -1. Cells are
+//EWTOLERANCE wide, so any such vertex is in the cell of point or a neighbour.
+int vertexMap::find(const Base::Vector3d& point) const
+{
+    int result = -1;
+    cellKey center = cellOf(point);
+    cellKey key;
+    for (long long dx = -1; dx <= 1; dx++) {
+        for (long long dy = -1; dy <= 1; dy++) {
+            for (long long dz = -1; dz <= 1; dz++) {
+                key = {center[0] + dx, center[1] + dy, center[2] + dz};
+                auto cell = m_cells.find(key);
+                if (cell == m_cells.end()) {
+                    continue;
+                }
+                for (int index : cell->second) {
+                    if ((result < 0 || index < result) &&
+                        (m_verts.at(index).first - point).Length() <= EWTOLERANCE) {
+                        result = index;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+vertexMap::cellKey vertexMap::cellOf(const Base::Vector3d& point)
+{
+    return {static_cast<long long>(std::floor(point.x / EWTOLERANCE)),
+            static_cast<long long>(std::floor(point.y / EWTOLERANCE)),
+            static_cast<long long>(std::floor(point.z / EWTOLERANCE))};
+}
+
+size_t vertexMap::cellHash::operator()(const cellKey& key) const
+{
+    size_t seed = 0;
+    for (long long value : key) {
+        seed ^= std::hash<long long>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
 //this is an aid to debugging and isn't used in normal processing.
 void DrawProjectSplit::dumpVertexMap(vertexMap verts)
 {
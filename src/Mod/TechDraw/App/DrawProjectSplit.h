@@ -23,6 +23,11 @@
 #ifndef DrawProjectSplit_h_
 #define DrawProjectSplit_h_
 
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Vertex.hxx>
 
@@ -77,7 +82,38 @@ public:
     std::string dump();
 };
 
-using vertexMap = std::map<Base::Vector3d, int, DrawUtil::vectorLessType>;
+//! the unique vertexes of a pile of edges and the number of edge ends at each.
+//! Points closer than EWTOLERANCE are the same vertex. The points are hashed into
+//! a grid of EWTOLERANCE sized cells, so a lookup only visits the neighbouring cells
+//! instead of comparing against every known vertex.
+class TechDrawExport vertexMap
+{
+public:
+    using value_type = std::pair<Base::Vector3d, int>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    //! count one more edge end at point
+    void add(const Base::Vector3d& point);
+    //! number of edge ends at point
+    int count(const Base::Vector3d& point) const;
+
+    size_t size() const { return m_verts.size(); }
+    const_iterator begin() const { return m_verts.begin(); }
+    const_iterator end() const { return m_verts.end(); }
+
+private:
+    using cellKey = std::array<long long, 3>;
+    struct cellHash
+    {
+        size_t operator()(const cellKey& key) const;
+    };
+
+    static cellKey cellOf(const Base::Vector3d& point);
+    int find(const Base::Vector3d& point) const;
+
+    std::vector<value_type> m_verts;
+    std::unordered_map<cellKey, std::vector<int>, cellHash> m_cells;
+};
 
 class edgeVectorEntry {
 public:
@@ -110,6 +146,7 @@ public:
     static bool splitEqual(const splitPoint& p1, const splitPoint& p2);
     static std::vector<TopoDS_Edge> removeDuplicateEdges(std::vector<TopoDS_Edge>& inEdges);
     static std::vector<edgeSortItem> sortEdges(std::vector<edgeSortItem>& e, bool ascend);
+    static std::vector<TopoDS_Edge> getEdges(const std::vector<TopoDS_Edge>& faceEdges);
 
 
     //routines for revised face finding approach
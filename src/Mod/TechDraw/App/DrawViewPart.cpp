@@ -603,73 +603,11 @@ void DrawViewPart::extractFaces()
 
         //HLR algo does not provide all edge intersections for edge endpoints.
         //need to split long edges touched by Vertex of another edge
-        std::vector<splitPoint> splits;
-        std::vector<TopoDS_Edge>::iterator itOuter = nonZero.begin();
-        int iOuter = 0;
-        for (; itOuter != nonZero.end(); ++itOuter, iOuter++) {//*** itOuter != nonZero.end() - 1
-            TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-            TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-            Bnd_Box sOuter;
-            BRepBndLib::AddOptimal(*itOuter, sOuter);
-            sOuter.SetGap(0.1);
-            if (sOuter.IsVoid()) {
-                continue;
-            }
-            if (DrawUtil::isZeroEdge(*itOuter)) {
-                continue;                   //skip zero length edges. shouldn't happen ;)
-            }
-            int iInner = 0;
-            std::vector<TopoDS_Edge>::iterator itInner = nonZero.begin();//***sb itOuter + 1;
-            for (; itInner != nonZero.end(); ++itInner, iInner++) {
-                if (iInner == iOuter) {
-                    continue;
-                }
-                if (DrawUtil::isZeroEdge((*itInner))) {
-                    continue;//skip zero length edges. shouldn't happen ;)
-                }
-
-                Bnd_Box sInner;
-                BRepBndLib::AddOptimal(*itInner, sInner);
-                sInner.SetGap(0.1);
-                if (sInner.IsVoid()) {
-                    continue;
-                }
-                if (sOuter.IsOut(sInner)) {//bboxes of edges don't intersect, don't bother
-                    continue;
-                }
-
-                double param = -1;
-                if (DrawProjectSplit::isOnEdge((*itInner), v1, param, false)) {
-                    gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
-                    splitPoint s1;
-                    s1.i = iInner;
-                    s1.v = Base::Vector3d(pnt1.X(), pnt1.Y(), pnt1.Z());
-                    s1.param = param;
-                    splits.push_back(s1);
-                }
-                if (DrawProjectSplit::isOnEdge((*itInner), v2, param, false)) {
-                    gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
-                    splitPoint s2;
-                    s2.i = iInner;
-                    s2.v = Base::Vector3d(pnt2.X(), pnt2.Y(), pnt2.Z());
-                    s2.param = param;
-                    splits.push_back(s2);
-                }
-            }//inner loop
-        }    //outer loop
-
-        std::vector<splitPoint> sorted = DrawProjectSplit::sortSplits(splits, true);
-        auto last = std::unique(sorted.begin(), sorted.end(),
-                                DrawProjectSplit::splitEqual);//duplicates to back
-        sorted.erase(last, sorted.end());                     //remove dupl splits
-        std::vector<TopoDS_Edge> newEdges = DrawProjectSplit::splitEdges(nonZero, sorted);
-
+        std::vector<TopoDS_Edge> newEdges = DrawProjectSplit::getEdges(nonZero);
         if (newEdges.empty()) {
             return;
         }
 
-        newEdges = DrawProjectSplit::removeDuplicateEdges(newEdges);
-
         geometryObject->clearFaceGeom();
 
         //find all the wires in the pile of faceEdges
@@ -36,6 +36,7 @@
 
 #include <Mod/Part/App/TopoShape.h>
 #include <Mod/Part/App/TopoShapeEdgePy.h>
+#include <Mod/Part/App/TopoShapeFacePy.h>
 #include <Mod/Part/App/TopoShapeVertexPy.h>
 
 #include "CenterLine.h"
@@ -98,6 +99,23 @@ PyObject* DrawViewPartPy::getHiddenEdges(PyObject *args)
     return Py::new_reference_to(pEdgeList);
 }
 
+PyObject* DrawViewPartPy::getFaces(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, "")) {
+        return nullptr;
+    }
+
+    DrawViewPart* dvp = getDrawViewPartPtr();
+    Py::List pFaceList;
+    std::vector<TechDraw::FacePtr> faces = dvp->getFaceGeometry();
+    for (auto& f: faces) {
+        PyObject* pFace = new Part::TopoShapeFacePy(new Part::TopoShape(f->toOccFace()));
+        pFaceList.append(Py::asObject(pFace));
+    }
+
+    return Py::new_reference_to(pFaceList);
+}
+
 PyObject* DrawViewPartPy::requestPaint(PyObject *args)
 {
     if (!PyArg_ParseTuple(args, "")) {
@@ -71,6 +71,8 @@
 #include "DrawViewPart.h"
 #include "GeometryObject.h"
 #include "DrawProjectSplit.h"
+#include "HLRCache.h"
+#include "Preferences.h"
 
 using namespace TechDraw;
 using namespace std;
@@ -146,6 +148,19 @@ void GeometryObject::projectShape(const TopoDS_Shape& inShape, const gp_Ax2& vie
 //    Base::Console().Message("GO::projectShape()\n");
     clear();
 
+    //a view that is recomputed without changing its projection, or that is reopened,
+    //can reuse the edges from an earlier run
+    std::string cacheKey;
+    if (Preferences::useHlrCache()) {
+        cacheKey = HLRCache::makeKey(inShape, viewAxis, m_isPersp, m_focus, m_isoCount);
+        std::vector<TopoDS_Shape> compounds;
+        if (!cacheKey.empty() && HLRCache::read(cacheKey, compounds)) {
+            setHlrCompounds(compounds);
+            makeTDGeometry();
+            return;
+        }
+    }
+
     Handle(HLRBRep_Algo) brep_hlr;
     try {
         brep_hlr = new HLRBRep_Algo();
@@ -246,9 +261,43 @@ void GeometryObject::projectShape(const TopoDS_Shape& inShape, const gp_Ax2& vie
             "GeometryObject::projectShape - unknown error occurred while extracting edges");
     }
 
+    if (!cacheKey.empty()) {
+        HLRCache::write(cacheKey, getHlrCompounds());
+    }
+
     makeTDGeometry();
 }
 
+std::vector<TopoDS_Shape> GeometryObject::getHlrCompounds() const
+{
+    std::vector<TopoDS_Shape> compounds(HLRCache::CompoundCount);
+    compounds[HLRCache::VisHard] = visHard;
+    compounds[HLRCache::VisOutline] = visOutline;
+    compounds[HLRCache::VisSmooth] = visSmooth;
+    compounds[HLRCache::VisSeam] = visSeam;
+    compounds[HLRCache::VisIso] = visIso;
+    compounds[HLRCache::HidHard] = hidHard;
+    compounds[HLRCache::HidOutline] = hidOutline;
+    compounds[HLRCache::HidSmooth] = hidSmooth;
+    compounds[HLRCache::HidSeam] = hidSeam;
+    compounds[HLRCache::HidIso] = hidIso;
+    return compounds;
+}
+
+void GeometryObject::setHlrCompounds(const std::vector<TopoDS_Shape>& compounds)
+{
+    visHard = compounds.at(HLRCache::VisHard);
+    visOutline = compounds.at(HLRCache::VisOutline);
+    visSmooth = compounds.at(HLRCache::VisSmooth);
+    visSeam = compounds.at(HLRCache::VisSeam);
+    visIso = compounds.at(HLRCache::VisIso);
+    hidHard = compounds.at(HLRCache::HidHard);
+    hidOutline = compounds.at(HLRCache::HidOutline);
+    hidSmooth = compounds.at(HLRCache::HidSmooth);
+    hidSeam = compounds.at(HLRCache::HidSeam);
+    hidIso = compounds.at(HLRCache::HidIso);
+}
+
 //convert the hlr output into TD Geometry
 void GeometryObject::makeTDGeometry()
 {
@@ -180,6 +180,9 @@ protected:
     TopoDS_Shape hidIso;
 
     void addGeomFromCompound(TopoDS_Shape edgeCompound, edgeClass category, bool visible);
+    //! the HLR output compounds in HLRCache::Compound order
+    std::vector<TopoDS_Shape> getHlrCompounds() const;
+    void setHlrCompounds(const std::vector<TopoDS_Shape>& compounds);
     TechDraw::DrawViewDetail* isParentDetail();
 
     //similar function in Geometry?
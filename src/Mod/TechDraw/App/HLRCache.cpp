@@ -0,0 +1,273 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <array>
+# include <iomanip>
+# include <sstream>
+# include <streambuf>
+# include <thread>
+
+# include <QByteArray>
+# include <QCryptographicHash>
+
+# include <BRep_Builder.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
+# include <BRepTools.hxx>
+# include <gp_Ax2.hxx>
+# include <Standard_Failure.hxx>
+# include <Standard_Version.hxx>
+# include <TopoDS_Compound.hxx>
+# include <TopoDS_Iterator.hxx>
+#endif
+
+#include <Base/Console.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+#include <Base/TimeInfo.h>
+
+#include "HLRCache.h"
+#include "Preferences.h"
+
+
+using namespace TechDraw;
+
+//bump this if the way the HLR output is produced changes, so old entries are not used
+static const int CacheVersion = 1;
+//temporary files older than this (in seconds) were left behind by a crashed write
+static const float StaleTempAge = 600.0F;
+
+namespace {
+
+//! a stream buffer that feeds everything written to it into a hash, so big shapes
+//! do not need to be written to memory first
+class HashBuffer: public std::streambuf
+{
+public:
+    explicit HashBuffer(QCryptographicHash& hash)
+        : m_hash(hash)
+    {
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        flushBuffer();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override
+    {
+        flushBuffer();
+        return 0;
+    }
+
+private:
+    void flushBuffer()
+    {
+        m_hash.addData(QByteArray::fromRawData(pbase(), static_cast<int>(pptr() - pbase())));
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+    }
+
+    QCryptographicHash& m_hash;
+    std::array<char, 65536> m_buffer;
+};
+
+}// namespace
+
+std::string HLRCache::makeKey(const TopoDS_Shape& shape, const gp_Ax2& viewAxis,
+                              bool perspective, double focus, int isoCount)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    std::stringstream options;
+    options << std::setprecision(17) << "TechDraw HLR " << CacheVersion << " OCC "
+            << OCC_VERSION_COMPLETE;
+    const gp_Pnt& location = viewAxis.Location();
+    const gp_Dir& direction = viewAxis.Direction();
+    const gp_Dir& xDirection = viewAxis.XDirection();
+    options << " location " << location.X() << " " << location.Y() << " " << location.Z()
+            << " direction " << direction.X() << " " << direction.Y() << " " << direction.Z()
+            << " xdirection " << xDirection.X() << " " << xDirection.Y() << " " << xDirection.Z()
+            << " iso " << isoCount;
+    if (perspective) {
+        //the focus is not used by orthographic projections
+        options << " focus " << focus;
+    }
+    options << "\n";
+    hash.addData(QByteArray::fromStdString(options.str()));
+
+    try {
+        //the triangulation depends on whether the shape was displayed before and is not
+        //used by HLR, so it is removed from a copy to keep the key stable
+        TopoDS_Shape geometry = BRepBuilderAPI_Copy(shape).Shape();
+        BRepTools::Clean(geometry);
+        HashBuffer buffer(hash);
+        std::ostream out(&buffer);
+        BRepTools::Write(geometry, out);
+        out.flush();
+    }
+    catch (const Standard_Failure& e) {
+        Base::Console().Warning("HLRCache::makeKey - OCC error - %s - while hashing shape\n",
+                                e.GetMessageString());
+        return std::string();
+    }
+
+    return hash.result().toHex().toStdString();
+}
+
+bool HLRCache::read(const std::string& key, std::vector<TopoDS_Shape>& compounds)
+{
+    Base::FileInfo fi(entryFile(key));
+    if (!fi.isReadable()) {
+        return false;
+    }
+
+    TopoDS_Shape entry;
+    try {
+        Base::ifstream in(fi, std::ios::in | std::ios::binary);
+        BRep_Builder builder;
+        BRepTools::Read(entry, in, builder);
+    }
+    catch (const Standard_Failure& e) {
+        Base::Console().Warning("HLRCache::read - OCC error - %s - while reading %s\n",
+                                e.GetMessageString(), fi.fileName().c_str());
+        return false;
+    }
+    if (entry.IsNull() || entry.ShapeType() != TopAbs_COMPOUND) {
+        return false;
+    }
+
+    std::vector<TopoDS_Shape> result;
+    for (TopoDS_Iterator it(entry); it.More(); it.Next()) {
+        TopoDS_Shape compound = it.Value();
+        if (!TopoDS_Iterator(compound).More()) {
+            //empty compounds stand for HLR classes without edges
+            compound.Nullify();
+        }
+        result.push_back(compound);
+    }
+    if (result.size() != CompoundCount) {
+        return false;
+    }
+
+    compounds = result;
+    return true;
+}
+
+void HLRCache::write(const std::string& key, const std::vector<TopoDS_Shape>& compounds)
+{
+    Base::FileInfo dir(cacheDir());
+    if (!dir.exists() && !dir.createDirectories()) {
+        Base::Console().Warning("HLRCache::write - can not create %s\n", dir.filePath().c_str());
+        return;
+    }
+
+    //null shapes can't be written, so they are stored as empty compounds
+    BRep_Builder builder;
+    TopoDS_Compound entry;
+    builder.MakeCompound(entry);
+    for (auto& compound : compounds) {
+        if (compound.IsNull()) {
+            TopoDS_Compound empty;
+            builder.MakeCompound(empty);
+            builder.Add(entry, empty);
+        }
+        else {
+            builder.Add(entry, compound);
+        }
+    }
+
+    //write to a temporary file and rename it, so nobody ever reads a partial entry
+    std::string target = entryFile(key);
+    std::stringstream tempName;
+    tempName << target << "." << std::this_thread::get_id() << ".tmp";
+    Base::FileInfo temp(tempName.str());
+    bool written = false;
+    try {
+        Base::ofstream out(temp, std::ios::out | std::ios::binary);
+        BRepTools::Write(entry, out);
+        out.close();
+        written = out.good();
+    }
+    catch (const Standard_Failure& e) {
+        Base::Console().Warning("HLRCache::write - OCC error - %s - while writing %s\n",
+                                e.GetMessageString(), temp.fileName().c_str());
+    }
+    //another view may have stored the same entry in the meantime
+    if (!written || Base::FileInfo(target).exists() || !temp.renameFile(target.c_str())) {
+        temp.deleteFile();
+        return;
+    }
+
+    prune();
+}
+
+std::string HLRCache::cacheDir()
+{
+    return Preferences::hlrCacheDir();
+}
+
+std::string HLRCache::entryFile(const std::string& key)
+{
+    return cacheDir() + key + ".brep";
+}
+
+//remove the oldest entries until the cache fits in its size limit, and the
+//temporary files of writes that never finished
+void HLRCache::prune()
+{
+    std::vector<Base::FileInfo> entries;
+    for (auto& fi : Base::FileInfo(cacheDir()).getDirectoryContent()) {
+        if (!fi.isFile()) {
+            continue;
+        }
+        if (fi.hasExtension("brep")) {
+            entries.push_back(fi);
+        }
+        else if (fi.hasExtension("tmp") && fi.fileName().find(".brep.") != std::string::npos
+                 && Base::TimeInfo::diffTimeF(fi.lastModified()) > StaleTempAge) {
+            fi.deleteFile();
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Base::FileInfo& a, const Base::FileInfo& b) {
+        return a.lastModified() > b.lastModified();
+    });
+
+    double limit = Preferences::hlrCacheSize() * 1024.0 * 1024.0;
+    double total = 0.0;
+    for (auto& fi : entries) {
+        total += fi.size();
+        if (total > limit) {
+            fi.deleteFile();
+        }
+    }
+}
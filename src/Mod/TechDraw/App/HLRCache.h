@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TECHDRAW_HLRCACHE_H
+#define TECHDRAW_HLRCACHE_H
+
+#include <string>
+#include <vector>
+
+#include <TopoDS_Shape.hxx>
+
+#include <Mod/TechDraw/TechDrawGlobal.h>
+
+
+class gp_Ax2;
+
+namespace TechDraw
+{
+
+//! A persistent cache of hidden line removal results.  HLR is the slow part of
+//! building a view and it is repeated every time a view is recomputed or a document
+//! is reopened, so the edge compounds it produces are kept in the user cache
+//! directory under a hash of everything that determines them.
+class TechDrawExport HLRCache
+{
+public:
+    //! the order of the edge compounds in a cache entry
+    enum Compound
+    {
+        VisHard,
+        VisOutline,
+        VisSmooth,
+        VisSeam,
+        VisIso,
+        HidHard,
+        HidOutline,
+        HidSmooth,
+        HidSeam,
+        HidIso,
+        CompoundCount
+    };
+
+    //! returns the key for projecting shape (already centered, scaled and rotated)
+    //! with viewAxis, or an empty string if the shape can not be hashed
+    static std::string makeKey(const TopoDS_Shape& shape, const gp_Ax2& viewAxis,
+                               bool perspective, double focus, int isoCount);
+    //! fills compounds from the entry for key. returns false if there is no usable entry.
+    static bool read(const std::string& key, std::vector<TopoDS_Shape>& compounds);
+    //! stores compounds as the entry for key and removes the oldest entries if the
+    //! cache has grown beyond its size limit
+    static void write(const std::string& key, const std::vector<TopoDS_Shape>& compounds);
+
+private:
+    static std::string cacheDir();
+    static std::string entryFile(const std::string& key);
+    static void prune();
+};
+
+}// namespace TechDraw
+
+#endif
@@ -33,6 +33,8 @@
 
 // standard
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdio>
 #include <chrono>
 #include <fstream>
@@ -41,24 +43,32 @@
 #include <limits>
 #include <map>
 #include <sstream>
+#include <streambuf>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // boost
 #include <boost/graph/boyer_myrvold_planar_test.hpp>
 #include <boost/graph/is_kuratowski_subgraph.hpp>
+#include <boost_geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
 #include <boost_regex.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
 // Qt
+#include <QByteArray>
+#include <QCryptographicHash>
 #include <QDomDocument>
 #include "QDomNodeModel.h"
 #include <QFile>
 #include <QLocale>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 #include <QXmlQuery>
 #include <QXmlResultItems>
@@ -395,6 +395,32 @@ int Preferences::scrubCount()
     return getPreferenceGroup("General")->GetInt("ScrubCount", 0);
 }
 
+//! keep the results of hidden line removal in the cache directory
+bool Preferences::useHlrCache()
+{
+    return getPreferenceGroup("General")->GetBool("UseHLRCache", true);
+}
+
+//! size limit of the hidden line removal cache in MB
+int Preferences::hlrCacheSize()
+{
+    return getPreferenceGroup("General")->GetInt("HLRCacheSize", 500);
+}
+
+//! directory of the hidden line removal cache, by default in the user cache directory
+std::string Preferences::hlrCacheDir()
+{
+    std::string defaultDir = App::Application::getUserCachePath() + "TechDraw/HLR/";
+    std::string prefDir = getPreferenceGroup("General")->GetASCII("HLRCacheDir", "");
+    if (prefDir.empty()) {
+        return defaultDir;
+    }
+    if (prefDir.back() != '/') {
+        prefDir += '/';
+    }
+    return prefDir;
+}
+
 //! Returns the factor for the overlap of svg tiles when hatching faces
 double Preferences::svgHatchFactor()
 {
@@ -102,6 +102,9 @@ public:
 
     static bool autoCorrectDimRefs();
     static int scrubCount();
+    static bool useHlrCache();
+    static int hlrCacheSize();
+    static std::string hlrCacheDir();
 
     static double svgHatchFactor();
 };
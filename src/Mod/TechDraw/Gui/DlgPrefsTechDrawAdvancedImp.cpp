@@ -60,6 +60,8 @@ void DlgPrefsTechDrawAdvancedImp::saveSettings()
     ui->cbAutoCorrectRefs->onSave();
     ui->cbNewFaceFinder->onSave();
     ui->sbScrubCount->onSave();
+    ui->cbHlrCache->onSave();
+    ui->sbHlrCacheSize->onSave();
 }
 
 void DlgPrefsTechDrawAdvancedImp::loadSettings()
@@ -80,6 +82,8 @@ void DlgPrefsTechDrawAdvancedImp::loadSettings()
     ui->cbAutoCorrectRefs->onRestore();
     ui->cbNewFaceFinder->onRestore();
     ui->sbScrubCount->onRestore();
+    ui->cbHlrCache->onRestore();
+    ui->sbHlrCacheSize->onRestore();
 }
 
 /**
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# tests for the edge cleanup that runs before face detection
+# (DrawProjectSplit::scrubEdges via TechDraw.edgeWalker)
+
+import time
+import unittest
+
+import FreeCAD
+import Part
+import TechDraw
+
+
+def makeGrid(count, size=10.0, overlaps=False):
+    """Returns the edges of a synthetic projection: count horizontal and count
+    vertical lines crossing in a square grid of (count - 1)**2 cells.  With
+    overlaps, half of every line is drawn a second time."""
+    length = (count - 1) * size
+    edges = []
+    for i in range(count):
+        offset = i * size
+        edges.append(Part.makeLine(FreeCAD.Vector(0, offset, 0), FreeCAD.Vector(length, offset, 0)))
+        edges.append(Part.makeLine(FreeCAD.Vector(offset, 0, 0), FreeCAD.Vector(offset, length, 0)))
+        if overlaps:
+            edges.append(Part.makeLine(FreeCAD.Vector(0, offset, 0), FreeCAD.Vector(length / 2, offset, 0)))
+            edges.append(Part.makeLine(FreeCAD.Vector(offset, length / 2, 0), FreeCAD.Vector(offset, length, 0)))
+    return edges
+
+
+class DrawProjectSplitTest(unittest.TestCase):
+    def testGridFaces(self):
+        """Tests that crossing lines are split into the cells of the grid"""
+        count = 6
+        wires = TechDraw.edgeWalker(makeGrid(count), False)
+        self.assertEqual(len(wires), (count - 1) ** 2, "wrong number of faces in grid")
+
+    def testOverlappingEdges(self):
+        """Tests that edges drawn twice do not create extra faces"""
+        count = 6
+        wires = TechDraw.edgeWalker(makeGrid(count, overlaps=True), False)
+        self.assertEqual(len(wires), (count - 1) ** 2, "wrong number of faces in grid with overlaps")
+
+    def testLargeProjection(self):
+        """Benchmark: face detection on a large synthetic projection"""
+        count = 40
+        edges = makeGrid(count, overlaps=True)
+        start = time.perf_counter()
+        wires = TechDraw.edgeWalker(edges, False)
+        elapsed = time.perf_counter() - start
+        print("DrawProjectSplit test: {0} edges in, {1} faces in {2:.2f}s".format(
+            len(edges), len(wires), elapsed))
+        self.assertEqual(len(wires), (count - 1) ** 2, "wrong number of faces in large grid")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -5,7 +5,12 @@
 # creates a page and 1 view
 
 
+import os
+import shutil
+import tempfile
+
 import FreeCAD
+import Part
 import unittest
 from .TechDrawTestUtilities import createPageWithSVGTemplate
 from PySide import QtCore
@@ -50,5 +55,92 @@ class DrawViewPartTest(unittest.TestCase):
         self.assertEqual(len(edges), 4, "DrawViewPart has wrong number of edges")
         self.assertTrue("Up-to-date" in view.State, "DrawViewPart is not Up-to-date")
 
+    def testCachedProjection(self):
+        """Tests that a view restored from the HLR cache has the same edges"""
+        print("testing DrawViewPart with HLR cache")
+        box = FreeCAD.ActiveDocument.addObject("Part::Box", "CacheBox")
+        # an empty cache of its own, so the first view can not find an entry left by
+        # earlier runs and the user cache is not touched
+        cacheDir = tempfile.mkdtemp()
+
+        def entries():
+            if not os.path.isdir(cacheDir):
+                return set()
+            return {name for name in os.listdir(cacheDir) if name.endswith(".brep")}
+
+        params = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/TechDraw/General")
+        useCache = params.GetBool("UseHLRCache", True)
+        userCacheDir = params.GetString("HLRCacheDir", "")
+        params.SetBool("UseHLRCache", True)
+        params.SetString("HLRCacheDir", cacheDir)
+        try:
+            counts = []
+            newEntries = []
+            for name in ("View", "View001"):    # the second view is projected from the cache
+                before = entries()
+                view = FreeCAD.ActiveDocument.addObject("TechDraw::DrawViewPart", name)
+                self.page.addView(view)
+                view.Source = [box]
+                FreeCAD.ActiveDocument.recompute()
+
+                #wait for threads to complete before checking result
+                loop = QtCore.QEventLoop()
+
+                timer = QtCore.QTimer()
+                timer.setSingleShot(True)
+                timer.timeout.connect(loop.quit)
+
+                timer.start(2000)   #2 second delay
+                loop.exec_()
+
+                counts.append(len(view.getVisibleEdges()))
+                newEntries.append(len(entries() - before))
+                self.assertTrue("Up-to-date" in view.State, "DrawViewPart is not Up-to-date")
+        finally:
+            params.SetBool("UseHLRCache", useCache)
+            params.SetString("HLRCacheDir", userCacheDir)
+            shutil.rmtree(cacheDir, ignore_errors=True)
+        self.assertEqual(newEntries, [1, 0], "first view did not store exactly one cache entry")
+        self.assertEqual(counts, [4, 4], "cached DrawViewPart has wrong number of edges")
+
+    def testFaceFinders(self):
+        """Tests that both face finders split a stepped block into its top faces"""
+        print("testing DrawViewPart face finders")
+        # seen from the top, the riser projects onto the line between the two
+        # faces, and the front and back edges of the faces meet it in T-junctions.
+        # Both finders keep the outline of the view as a face too.
+        step = FreeCAD.ActiveDocument.addObject("Part::Feature", "Step")
+        step.Shape = (
+            Part.makeBox(10, 10, 5)
+            .fuse(Part.makeBox(5, 10, 5, FreeCAD.Vector(0, 0, 5)))
+            .removeSplitter()
+        )
+        params = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/TechDraw/General")
+        newFaceFinder = params.GetBool("NewFaceFinder", False)
+        try:
+            counts = []
+            for useNew in (False, True):
+                params.SetBool("NewFaceFinder", useNew)
+                view = FreeCAD.ActiveDocument.addObject("TechDraw::DrawViewPart", "View")
+                self.page.addView(view)
+                view.Source = [step]
+                FreeCAD.ActiveDocument.recompute()
+
+                #wait for threads to complete before checking result
+                loop = QtCore.QEventLoop()
+
+                timer = QtCore.QTimer()
+                timer.setSingleShot(True)
+                timer.timeout.connect(loop.quit)
+
+                timer.start(2000)   #2 second delay
+                loop.exec_()
+
+                self.assertTrue("Up-to-date" in view.State, "DrawViewPart is not Up-to-date")
+                counts.append(len(view.getFaces()))
+        finally:
+            params.SetBool("NewFaceFinder", newFaceFinder)
+        self.assertEqual(counts, [3, 3], "DrawViewPart has wrong number of faces")
+
 if __name__ == "__main__":
     unittest.main()
@@ -22,6 +22,7 @@
 
 #tests that do not require Gui
 from TDTest.DrawHatchTest import DrawHatchTest  # noqa: F401
+from TDTest.DrawProjectSplitTest import DrawProjectSplitTest  # noqa: F401
 from TDTest.DrawViewAnnotationTest import DrawViewAnnotationTest  # noqa: F401
 from TDTest.DrawViewBalloonTest import DrawViewBalloonTest  # noqa: F401
 from TDTest.DrawViewImageTest import DrawViewImageTest  # noqa: F401
@@ -0,0 +1,87 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+"""Times the adaptive clearing of separate pockets with different numbers of threads.
+
+Run it with:
+    FreeCADCmd src/Tools/benchmarks/PathAdaptive.py
+
+24 pockets on a 400x300 stock are cleared with a 6 mm tool and a step over of 0.2.
+The output must be the same for every number of threads.
+"""
+
+import os
+import time
+
+import FreeCAD  # noqa: F401, sets up the module path
+import area
+
+COLUMNS = 6
+ROWS = 4
+STOCK = (400.0, 300.0)
+GAP = 10.0
+
+
+def pockets():
+    width = (STOCK[0] - GAP) / COLUMNS - GAP
+    height = (STOCK[1] - GAP) / ROWS - GAP
+    paths = []
+    for i in range(COLUMNS):
+        for j in range(ROWS):
+            x = GAP + i * (width + GAP)
+            y = GAP + j * (height + GAP)
+            paths.append([(x, y), (x + width, y), (x + width, y + height), (x, y + height)])
+    stock = [[(0.0, 0.0), (STOCK[0], 0.0), (STOCK[0], STOCK[1]), (0.0, STOCK[1])]]
+    return stock, paths
+
+
+def run(threads, stock, paths):
+    a2d = area.Adaptive2d()
+    a2d.opType = area.AdaptiveOperationType.ClearingInside
+    a2d.toolDiameter = 6.0
+    a2d.stepOverFactor = 0.2
+    a2d.tolerance = 0.1
+    a2d.threads = threads
+    start = time.perf_counter()
+    results = a2d.Execute(stock, paths, lambda tpaths: False)
+    elapsed = time.perf_counter() - start
+    output = [
+        (r.HelixCenterPoint, r.StartPoint, [(int(p[0]), p[1]) for p in r.AdaptivePaths])
+        for r in results
+    ]
+    return elapsed, output
+
+
+def main():
+    stock, paths = pockets()
+    reference = None
+    for threads in sorted({1, 2, 4, os.cpu_count() or 1}):
+        elapsed, output = run(threads, stock, paths)
+        if reference is None:
+            reference = output
+        same = "same" if output == reference else "DIFFERENT"
+        print("threads {:3d}: {:7.2f} s, {} regions, output {}".format(
+            threads, elapsed, len(output), same))
+
+
+main()
@@ -0,0 +1,72 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+"""Times splitting a toolpath with one million moves into the polyline it is displayed as.
+
+Run it with:
+    FreeCADCmd src/Tools/benchmarks/PathPolyline.py
+
+Every fifth move is an arc, so most of the points come from the arc segmentation. The
+polyline is built with one thread and with all cores and both results must be the same.
+"""
+
+import time
+
+import FreeCAD  # noqa: F401, sets up the module path
+import Path
+
+MOVES = 1000000
+
+
+def program(count):
+    lines = []
+    for i in range(count):
+        x = (i % 1000) * 0.1
+        y = (i // 1000) * 0.1
+        if i % 1000 == 0:
+            lines.append("G0 X{:.3f} Y{:.3f} Z5.000".format(x, y))
+        elif i % 5 == 0:
+            lines.append("G2 X{:.3f} Y{:.3f} I0.050 J0.000 F300.000".format(x, y))
+        else:
+            lines.append("G1 X{:.3f} Y{:.3f} Z-1.000 F600.000".format(x, y))
+    return "\n".join(lines) + "\n"
+
+
+def timed(label, func):
+    start = time.perf_counter()
+    result = func()
+    print("{:14s} {:7.2f} s".format(label, time.perf_counter() - start))
+    return result
+
+
+def main():
+    path = Path.Path()
+    path.setFromGCode(program(MOVES))
+    serial = timed("1 thread", lambda: path.getPolyline(threads=1))
+    parallel = timed("all cores", lambda: path.getPolyline(threads=0))
+    print("{} points of {} moves".format(len(serial["Points"]) // 12, path.Size))
+    if serial != parallel:
+        raise RuntimeError("the polyline depends on the number of threads")
+
+
+main()
@@ -0,0 +1,79 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+"""Times building and evaluating a toolpath with five million moves.
+
+Run it with:
+    FreeCADCmd src/Tools/benchmarks/PathToolpath.py
+
+The program is a mix of G0, G1 and G2 moves with a sparse S word. The peak memory is
+the maximum resident set size of the process, so it includes the G-code strings.
+"""
+
+import resource
+import time
+
+import FreeCAD  # noqa: F401, sets up the module path
+import Path
+
+MOVES = 5000000
+
+
+def program(count):
+    lines = []
+    for i in range(count):
+        x = (i % 1000) * 0.1
+        y = (i // 1000) * 0.1
+        if i % 10 == 0:
+            lines.append("G0 X{:.3f} Y{:.3f} Z5.000".format(x, y))
+        elif i % 10 == 5:
+            lines.append("G2 X{:.3f} Y{:.3f} I0.050 J0.000 F300.000".format(x, y))
+        elif i % 100 == 1:
+            lines.append("G1 X{:.3f} Y{:.3f} Z-1.000 F600.000 S12000".format(x, y))
+        else:
+            lines.append("G1 X{:.3f} Y{:.3f} Z-1.000".format(x, y))
+    return "\n".join(lines) + "\n"
+
+
+def timed(label, func):
+    start = time.perf_counter()
+    result = func()
+    print("{:14s} {:7.2f} s".format(label, time.perf_counter() - start))
+    return result
+
+
+def main():
+    text = program(MOVES)
+    before = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    path = Path.Path()
+    timed("build", lambda: path.setFromGCode(text))
+    after = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    print("{} commands, peak memory grew by {} MB".format(path.Size, (after - before) // 1024))
+    timed("bound box", lambda: path.BoundBox)
+    timed("length", lambda: path.Length)
+    timed("cycle time", lambda: path.getCycleTime(10, 10, 50, 50))
+    gcode = timed("toGCode", path.toGCode)
+    print("{} MB of G-code".format(len(gcode) // (1024 * 1024)))
+
+
+main()
@@ -0,0 +1,77 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+"""Times the level of detail octree of a large point cloud with different numbers of threads.
+
+Run it with:
+    FreeCADCmd src/Tools/benchmarks/PointsOctree.py
+
+The octree of five million random points in a cube is built and the points for a camera
+looking at a part of the cube are selected. A huge error limit selects only the root, so
+that run mostly measures building the octree. The selection must be the same for every
+number of threads.
+"""
+
+import os
+import random
+import time
+
+import FreeCAD
+import Points
+
+COUNT = 5000000
+CAMERA = dict(Position=FreeCAD.Vector(60, 60, 300), Direction=FreeCAD.Vector(0, 0, -1),
+              Up=FreeCAD.Vector(0, 1, 0), Angle=0.5, Aspect=1.5, Near=1.0, Far=500.0,
+              ScreenHeight=1000)
+
+
+def cloud(count):
+    rnd = random.Random(1)
+    return Points.Points([FreeCAD.Vector(rnd.uniform(-100, 100), rnd.uniform(-100, 100),
+                                         rnd.uniform(-100, 100)) for _ in range(count)])
+
+
+def run(points, threads, **kwargs):
+    start = time.perf_counter()
+    result = points.selectVisible(Threads=threads, **kwargs, **CAMERA)
+    return time.perf_counter() - start, result
+
+
+def main():
+    points = cloud(COUNT)
+    print("{} points".format(points.CountPoints))
+    cases = (("build only", dict(MaxError=1e9)),
+             ("error 1 px", dict(MaxError=1.0)),
+             ("error 1 px, budget 1M", dict(MaxError=1.0, PointBudget=1000000)))
+    for label, kwargs in cases:
+        reference = None
+        for threads in sorted({1, 2, 4, os.cpu_count() or 1}):
+            elapsed, result = run(points, threads, **kwargs)
+            if reference is None:
+                reference = result
+            same = "same" if result == reference else "DIFFERENT"
+            print("{}, threads {:3d}: {:7.2f} s, {} points selected, selection {}".format(
+                label, threads, elapsed, len(result), same))
+
+
+main()
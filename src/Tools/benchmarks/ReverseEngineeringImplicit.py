@@ -0,0 +1,81 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+"""Times the implicit surface reconstruction of a large point cloud with different numbers of threads.
+
+Run it with:
+    FreeCADCmd src/Tools/benchmarks/ReverseEngineeringImplicit.py
+
+Two million points on a unit sphere are reconstructed with their exact normals and once
+with estimated normals. The mesh must be the same for every number of threads.
+"""
+
+import math
+import os
+import time
+
+import FreeCAD
+import Points
+import ReverseEngineering
+
+COUNT = 2000000
+
+
+def sphere(count):
+    """Evenly distributed points on a Fibonacci sphere, the normals are the points themselves."""
+    golden = math.pi * (3.0 - math.sqrt(5.0))
+    pts = []
+    for i in range(count):
+        z = 1.0 - 2.0 * (i + 0.5) / count
+        r = math.sqrt(1.0 - z * z)
+        phi = golden * i
+        pts.append(FreeCAD.Vector(r * math.cos(phi), r * math.sin(phi), z))
+    return pts
+
+
+def run(points, threads, normals):
+    start = time.perf_counter()
+    if normals is None:
+        mesh = ReverseEngineering.implicitReconstruction(points, Threads=threads)
+    else:
+        mesh = ReverseEngineering.implicitReconstruction(points, Threads=threads, Normals=normals)
+    elapsed = time.perf_counter() - start
+    return elapsed, (mesh.CountPoints, mesh.CountFacets, round(mesh.Volume, 6))
+
+
+def main():
+    pts = sphere(COUNT)
+    points = Points.Points(pts)
+    print("{} points, exact volume {:.6f}".format(points.CountPoints, 4.0 / 3.0 * math.pi))
+    for label, normals in (("given normals", pts), ("estimated normals", None)):
+        reference = None
+        for threads in sorted({1, 2, 4, os.cpu_count() or 1}):
+            elapsed, result = run(points, threads, normals)
+            if reference is None:
+                reference = result
+            same = "same" if result == reference else "DIFFERENT"
+            print("{}, threads {:3d}: {:7.2f} s, {} vertices, {} facets, volume {}, mesh {}".format(
+                label, threads, elapsed, result[0], result[1], result[2], same))
+
+
+main()
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+#include <Base/TextScanner.h>
+
+using Base::TextScanner;
+
+TEST(TextScanner, readNumbersOfLine)  // NOLINT
+{
+    // Arrange
+    const char* text = "  1.5\t-2 +3e2 \r\nnext";
+    const char* end = text + std::strlen(text);
+    const char* ptr = text;
+    double x {}, y {}, z {}, w {};
+
+    // Act
+    bool ok = TextScanner::ReadNumber(ptr, end, x) && TextScanner::ReadNumber(ptr, end, y)
+        && TextScanner::ReadNumber(ptr, end, z);
+
+    // Assert
+    EXPECT_TRUE(ok);
+    EXPECT_DOUBLE_EQ(x, 1.5);
+    EXPECT_DOUBLE_EQ(y, -2.0);
+    EXPECT_DOUBLE_EQ(z, 300.0);
+    // no further number on the line
+    EXPECT_FALSE(TextScanner::ReadNumber(ptr, end, w));
+    EXPECT_TRUE(TextScanner::IsLineEnd(TextScanner::SkipBlanks(ptr, end), end));
+    EXPECT_EQ(TextScanner::NextLine(ptr, end), end - 4);
+}
+
+TEST(TextScanner, rejectInvalidNumbers)  // NOLINT
+{
+    // Arrange
+    const char* text = "1.5x +-2";
+    const char* end = text + std::strlen(text);
+    const char* ptr = text;
+    double value {};
+
+    // Act
+    bool ok = TextScanner::ReadNumber(ptr, end, value);
+
+    // Assert
+    EXPECT_FALSE(ok);
+    // the position is kept on failure
+    EXPECT_EQ(ptr, text);
+    ptr = text + 5;
+    EXPECT_FALSE(TextScanner::ReadNumber(ptr, end, value));
+}
+
+TEST(TextScanner, nextLineWithoutLineBreak)  // NOLINT
+{
+    // Arrange
+    const char* text = "1 2 3";
+    const char* end = text + std::strlen(text);
+
+    // Act
+    const char* next = TextScanner::NextLine(text, end);
+
+    // Assert
+    EXPECT_EQ(next, end);
+}
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+
+class MeshFacetBVHTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a sphere with center (1,2,3) and radius 2 and a separate plane below of it
+        const int rings = 20;
+        const int sectors = 40;
+        auto point = [](int i, int j) {
+            float theta = float(M_PI) * float(i) / float(rings);
+            float phi = 2.0F * float(M_PI) * float(j) / float(sectors);
+            return Base::Vector3f(1.0F + 2.0F * std::sin(theta) * std::cos(phi),
+                                  2.0F + 2.0F * std::sin(theta) * std::sin(phi),
+                                  3.0F + 2.0F * std::cos(theta));
+        };
+
+        std::vector<MeshCore::MeshGeomFacet> triangles;
+        for (int i = 0; i < rings; i++) {
+            for (int j = 0; j < sectors; j++) {
+                if (i > 0) {
+                    triangles.emplace_back(point(i, j), point(i + 1, j), point(i, j + 1));
+                }
+                if (i < rings - 1) {
+                    triangles.emplace_back(point(i + 1, j), point(i + 1, j + 1), point(i, j + 1));
+                }
+            }
+        }
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 10; j++) {
+                Base::Vector3f p(float(i) - 4.0F, float(j) - 3.0F, -1.0F);
+                triangles.emplace_back(p,
+                                       p + Base::Vector3f(1, 0, 0),
+                                       p + Base::Vector3f(1, 1, 0));
+                triangles.emplace_back(p,
+                                       p + Base::Vector3f(1, 1, 0),
+                                       p + Base::Vector3f(0, 1, 0));
+            }
+        }
+        _kernel = triangles;
+    }
+
+    // deterministic query points around the mesh
+    static std::vector<Base::Vector3f> queryPoints()
+    {
+        std::vector<Base::Vector3f> points;
+        for (int i = 0; i < 500; i++) {
+            float t = float(i);
+            points.emplace_back(1.0F + 5.0F * std::sin(0.37F * t),
+                                2.0F + 5.0F * std::sin(0.53F * t + 1.0F),
+                                2.0F + 4.0F * std::sin(0.71F * t + 2.0F));
+        }
+        return points;
+    }
+
+    // returns the facet with the smallest distance or the lowest index of equal distances
+    template<class Func>
+    MeshCore::FacetIndex bruteForce(Func func) const
+    {
+        MeshCore::FacetIndex nearest = MeshCore::FACET_INDEX_MAX;
+        float minDist = FLOAT_MAX;
+        for (MeshCore::FacetIndex i = 0; i < _kernel.CountFacets(); i++) {
+            float dist = func(i);
+            if (dist < minDist) {
+                minDist = dist;
+                nearest = i;
+            }
+        }
+        return nearest;
+    }
+
+    MeshCore::MeshKernel _kernel;
+};
+
+TEST_F(MeshFacetBVHTest, nearestFacetMatchesBruteForce)  // NOLINT
+{
+    // Arrange
+    MeshCore::MeshFacetBVH bvh(_kernel);
+
+    for (const auto& pnt : queryPoints()) {
+        auto distance = [this, &pnt](MeshCore::FacetIndex facet) {
+            return _kernel.GetFacet(facet).DistanceToPoint(pnt);
+        };
+
+        // Act
+        MeshCore::FacetIndex expected = bruteForce(distance);
+        MeshCore::FacetIndex nearest = bvh.NearestFacet(pnt, distance);
+
+        // Assert
+        ASSERT_NE(nearest, MeshCore::FACET_INDEX_MAX);
+        EXPECT_FLOAT_EQ(distance(nearest), distance(expected));
+    }
+}
+
+TEST_F(MeshFacetBVHTest, nearestProjectionMatchesBruteForce)  // NOLINT
+{
+    // Arrange
+    MeshCore::MeshFacetBVH bvh(_kernel, 1);
+
+    for (const auto& pnt : queryPoints()) {
+        // the distance of the projection along the facet normal as used by the curve projector
+        auto distance = [this, &pnt](MeshCore::FacetIndex facet) {
+            Base::Vector3f result;
+            MeshCore::MeshGeomFacet geomFacet = _kernel.GetFacet(facet);
+            if (geomFacet.Foraminate(pnt, geomFacet.GetNormal(), result)) {
+                return Base::Distance(pnt, result);
+            }
+            return FLOAT_MAX;
+        };
+
+        // Act
+        MeshCore::FacetIndex expected = bruteForce(distance);
+        MeshCore::FacetIndex nearest = bvh.NearestFacet(pnt, distance);
+
+        // Assert
+        EXPECT_EQ(nearest, expected);
+    }
+}
+
+TEST_F(MeshFacetBVHTest, intersectMatchesBruteForce)  // NOLINT
+{
+    // Arrange
+    MeshCore::MeshFacetBVH bvh(_kernel);
+    Base::BoundBox3f box(0.0F, 1.0F, -2.0F, 2.5F, 3.0F, 4.0F);
+
+    // Act
+    std::vector<MeshCore::FacetIndex> facets;
+    bvh.Intersect(box, facets);
+    std::sort(facets.begin(), facets.end());
+
+    // Assert
+    std::vector<MeshCore::FacetIndex> expected;
+    for (MeshCore::FacetIndex i = 0; i < _kernel.CountFacets(); i++) {
+        if (_kernel.GetFacet(i).GetBoundBox() && box) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(facets, expected);
+    EXPECT_EQ(bvh.GetBoundBox().MinZ, _kernel.GetBoundBox().MinZ);
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include <Mod/Mesh/App/Core/Approximation.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/Segmentation.h>
+
+namespace
+{
+// Triangles of a grid on the plane z = 0.2*x - 0.1*y + 1 with a small deterministic noise
+std::vector<MeshCore::MeshGeomFacet> planeTriangles()
+{
+    auto point = [](int i, int j) {
+        float x = float(i);
+        float y = float(j);
+        float z = 0.2F * x - 0.1F * y + 1.0F + 0.001F * std::sin(float(3 * i + 7 * j));
+        return Base::Vector3f(x, y, z);
+    };
+
+    std::vector<MeshCore::MeshGeomFacet> triangles;
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            triangles.emplace_back(point(i, j), point(i + 1, j), point(i + 1, j + 1));
+            triangles.emplace_back(point(i, j), point(i + 1, j + 1), point(i, j + 1));
+        }
+    }
+    return triangles;
+}
+
+// Triangles of a sphere with center (1,2,3) and radius 2 with a small radial noise
+std::vector<MeshCore::MeshGeomFacet> sphereTriangles()
+{
+    const int rings = 20;
+    const int sectors = 40;
+    auto point = [](int i, int j) {
+        float theta = float(M_PI) * (float(i) + 0.5F) / float(rings);
+        float phi = 2.0F * float(M_PI) * float(j) / float(sectors);
+        float radius = 2.0F + 0.001F * std::sin(float(5 * i + 3 * j));
+        return Base::Vector3f(1.0F + radius * std::sin(theta) * std::cos(phi),
+                              2.0F + radius * std::sin(theta) * std::sin(phi),
+                              3.0F + radius * std::cos(theta));
+    };
+
+    std::vector<MeshCore::MeshGeomFacet> triangles;
+    for (int i = 0; i < rings - 1; i++) {
+        for (int j = 0; j < sectors; j++) {
+            triangles.emplace_back(point(i, j), point(i + 1, j), point(i + 1, j + 1));
+            triangles.emplace_back(point(i, j), point(i + 1, j + 1), point(i, j + 1));
+        }
+    }
+    return triangles;
+}
+}  // namespace
+
+TEST(SurfaceFit, planeParametersMatchPlaneFit)  // NOLINT
+{
+    // Arrange
+    std::vector<MeshCore::MeshGeomFacet> triangles = planeTriangles();
+    MeshCore::PlaneSurfaceFit surface;
+    MeshCore::PlaneFit reference;
+
+    // Act
+    surface.Initialize(triangles.front());
+    reference.AddPoint(triangles.front()._aclPoints[0]);
+    reference.AddPoint(triangles.front()._aclPoints[1]);
+    reference.AddPoint(triangles.front()._aclPoints[2]);
+    for (std::size_t i = 1; i < triangles.size(); i++) {
+        surface.AddTriangle(triangles[i]);
+        reference.AddPoint(triangles[i].GetGravityPoint());
+        if (!surface.Done()) {
+            surface.Fit();
+        }
+    }
+    reference.Fit();
+    std::vector<float> par = surface.Parameters();
+
+    // Assert
+    ASSERT_EQ(par.size(), 6);
+    Base::Vector3f base = reference.GetBase();
+    Base::Vector3f normal = reference.GetNormal();
+    EXPECT_FLOAT_EQ(par[0], base.x);
+    EXPECT_FLOAT_EQ(par[1], base.y);
+    EXPECT_FLOAT_EQ(par[2], base.z);
+    // same orientation as the plane fit, not only the same plane
+    EXPECT_FLOAT_EQ(par[3], normal.x);
+    EXPECT_FLOAT_EQ(par[4], normal.y);
+    EXPECT_FLOAT_EQ(par[5], normal.z);
+
+    Base::Vector3f expected(-0.2F, 0.1F, 1.0F);
+    expected.Normalize();
+    EXPECT_NEAR(std::fabs(normal * expected), 1.0F, 1e-5F);
+}
+
+TEST(SurfaceFit, sphereParametersMatchSphereFit)  // NOLINT
+{
+    // Arrange
+    std::vector<MeshCore::MeshGeomFacet> triangles = sphereTriangles();
+    MeshCore::SphereSurfaceFit surface;
+    MeshCore::SphereFit reference;
+
+    // Act
+    surface.Initialize(triangles.front());
+    reference.AddPoint(triangles.front()._aclPoints[0]);
+    reference.AddPoint(triangles.front()._aclPoints[1]);
+    reference.AddPoint(triangles.front()._aclPoints[2]);
+    for (std::size_t i = 1; i < triangles.size(); i++) {
+        surface.AddTriangle(triangles[i]);
+        for (const auto& pnt : triangles[i]._aclPoints) {
+            reference.AddPoint(pnt);
+        }
+        if (!surface.Done()) {
+            surface.Fit();
+        }
+    }
+    reference.Fit();
+    std::vector<float> par = surface.Parameters();
+
+    // Assert
+    ASSERT_EQ(par.size(), 4);
+    Base::Vector3f center = reference.GetCenter();
+    EXPECT_FLOAT_EQ(par[0], center.x);
+    EXPECT_FLOAT_EQ(par[1], center.y);
+    EXPECT_FLOAT_EQ(par[2], center.z);
+    EXPECT_FLOAT_EQ(par[3], reference.GetRadius());
+
+    EXPECT_NEAR(par[0], 1.0F, 1e-3F);
+    EXPECT_NEAR(par[1], 2.0F, 1e-3F);
+    EXPECT_NEAR(par[2], 3.0F, 1e-3F);
+    EXPECT_NEAR(par[3], 2.0F, 1e-3F);
+}
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <BRep_Builder.hxx>
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <gp_Pnt.hxx>
+
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/MeshPart/App/CurveProjector.h>
+
+using MeshPart::CurveProjector;
+using MeshPart::CurveProjectorShape;
+using MeshPart::MeshProjection;
+
+class CurveProjectorTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a grid of 20x20 squares on the xy plane
+        std::vector<MeshCore::MeshGeomFacet> triangles;
+        for (int i = 0; i < 20; i++) {
+            for (int j = 0; j < 20; j++) {
+                Base::Vector3f p(float(i), float(j), 0.0F);
+                triangles.emplace_back(p,
+                                       p + Base::Vector3f(1, 0, 0),
+                                       p + Base::Vector3f(1, 1, 0));
+                triangles.emplace_back(p,
+                                       p + Base::Vector3f(1, 1, 0),
+                                       p + Base::Vector3f(0, 1, 0));
+            }
+        }
+        _kernel = triangles;
+
+        // lines slightly above of the grid that don't pass through its vertices
+        for (int k = 0; k < 8; k++) {
+            double y = 0.3 + 2.3 * k;
+            BRepBuilderAPI_MakeEdge mkEdge(gp_Pnt(0.55, y, 0.25), gp_Pnt(18.65, y + 0.9, 0.25));
+            _edges.push_back(mkEdge.Edge());
+        }
+
+        BRep_Builder builder;
+        builder.MakeCompound(_compound);
+        for (const auto& edge : _edges) {
+            builder.Add(_compound, edge);
+        }
+        // an edge used twice is projected once but reported for every occurrence
+        builder.Add(_compound, _edges.front());
+    }
+
+    static void expectEqual(const std::vector<MeshProjection::PolyLine>& polylines1,
+                            const std::vector<MeshProjection::PolyLine>& polylines2)
+    {
+        ASSERT_EQ(polylines1.size(), polylines2.size());
+        for (std::size_t i = 0; i < polylines1.size(); i++) {
+            EXPECT_FALSE(polylines1[i].points.empty());
+            EXPECT_EQ(polylines1[i].points, polylines2[i].points);
+        }
+    }
+
+    MeshCore::MeshKernel _kernel;
+    std::vector<TopoDS_Edge> _edges;
+    TopoDS_Compound _compound;
+};
+
+TEST_F(CurveProjectorTest, projectShapeLikeSingleEdges)  // NOLINT
+{
+    // Arrange
+    std::vector<CurveProjector::result_type> expected;
+    for (const auto& edge : _edges) {
+        CurveProjectorShape single(edge, _kernel);
+        expected.push_back(single.result());
+    }
+
+    // Act
+    CurveProjectorShape projector(_compound, _kernel);
+    CurveProjector::result_type& result = projector.result();
+
+    // Assert
+    ASSERT_EQ(result.size(), _edges.size());
+    for (std::size_t i = 0; i < _edges.size(); i++) {
+        const auto& splitEdges = result[_edges[i]];
+        const auto& reference = expected[i][_edges[i]];
+        ASSERT_FALSE(reference.empty());
+        // the first edge appears twice in the compound
+        ASSERT_EQ(splitEdges.size(), i == 0 ? 2 * reference.size() : reference.size());
+        for (std::size_t j = 0; j < splitEdges.size(); j++) {
+            const auto& ref = reference[j % reference.size()];
+            EXPECT_EQ(splitEdges[j].ulFaceIndex, ref.ulFaceIndex);
+            EXPECT_EQ(splitEdges[j].p1, ref.p1);
+            EXPECT_EQ(splitEdges[j].p2, ref.p2);
+        }
+    }
+}
+
+TEST_F(CurveProjectorTest, projectToMeshLikeSingleEdges)  // NOLINT
+{
+    // Arrange
+    MeshProjection projection(_kernel);
+    std::vector<MeshProjection::PolyLine> expected;
+    for (const auto& edge : _edges) {
+        projection.projectToMesh(edge, 0.5F, expected);
+    }
+    expected.push_back(expected.front());
+
+    // Act
+    std::vector<MeshProjection::PolyLine> polylines;
+    projection.projectToMesh(_compound, 0.5F, polylines);
+
+    // Assert
+    expectEqual(polylines, expected);
+}
+
+TEST_F(CurveProjectorTest, projectParallelLikeSingleEdges)  // NOLINT
+{
+    // Arrange
+    MeshProjection projection(_kernel);
+    Base::Vector3f dir(0, 0, -1);
+    std::vector<MeshProjection::PolyLine> expected;
+    for (const auto& edge : _edges) {
+        projection.projectParallelToMesh(edge, dir, expected);
+    }
+    expected.push_back(expected.front());
+
+    // Act
+    std::vector<MeshProjection::PolyLine> polylines;
+    projection.projectParallelToMesh(_compound, dir, polylines);
+
+    // Assert
+    expectEqual(polylines, expected);
+}
+
+TEST_F(CurveProjectorTest, projectPolyLinesLikeSingleEdges)  // NOLINT
+{
+    // Arrange
+    MeshProjection projection(_kernel);
+    Base::Vector3f dir(0, 0, -1);
+    std::vector<MeshProjection::PolyLine> input;
+    for (const auto& edge : _edges) {
+        MeshProjection::PolyLine polyline;
+        projection.discretize(edge, polyline.points, 5);
+        input.push_back(polyline);
+    }
+    std::vector<MeshProjection::PolyLine> expected;
+    for (const auto& polyline : input) {
+        projection.projectParallelToMesh(std::vector<MeshProjection::PolyLine> {polyline},
+                                         dir,
+                                         expected);
+    }
+
+    // Act
+    std::vector<MeshProjection::PolyLine> polylines;
+    projection.projectParallelToMesh(input, dir, polylines);
+
+    // Assert
+    expectEqual(polylines, expected);
+}
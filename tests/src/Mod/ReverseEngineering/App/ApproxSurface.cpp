@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include <Eigen/Dense>
+#include <Geom_BSplineSurface.hxx>
+#include <TColgp_Array1OfPnt.hxx>
+#include <TColgp_Array2OfPnt.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColStd_Array1OfReal.hxx>
+
+#include <Mod/ReverseEngineering/App/ApproxSurface.h>
+
+// Solves each system of normal equations a second time with a dense LU decomposition
+// and records the largest deviation of the control points
+class DenseCheckCorrection: public Reen::BSplineParameterCorrection
+{
+public:
+    using Reen::BSplineParameterCorrection::BSplineParameterCorrection;
+
+    double maxDeviation {0.0};
+    int numSolved {0};
+
+protected:
+    bool SolveNormalEquations(const Eigen::SparseMatrix<double>& A,
+                              const Eigen::MatrixX3d& b) override
+    {
+        if (!BSplineParameterCorrection::SolveNormalEquations(A, b)) {
+            return false;
+        }
+
+        Eigen::MatrixXd dense(A);
+        Eigen::MatrixX3d X = dense.fullPivLu().solve(b);
+        Eigen::Index idx = 0;
+        for (unsigned j = 0; j < _usUCtrlpoints; j++) {
+            for (unsigned k = 0; k < _usVCtrlpoints; k++) {
+                const gp_Pnt& pnt = _vCtrlPntsOfSurf(j, k);
+                Eigen::Vector3d sparse(pnt.X(), pnt.Y(), pnt.Z());
+                maxDeviation = std::max(maxDeviation, (sparse - X.row(idx).transpose()).norm());
+                idx++;
+            }
+        }
+        numSolved++;
+        return true;
+    }
+};
+
+class ApproxSurfaceTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // A cubic surface with 6x6 poles over the same knots the approximation uses. The
+        // x and y coordinates of the poles are the Greville abscissae so that x(u) = u
+        // and y(v) = v, i.e. the initial parametrization reproduces the surface.
+        const double greville[6] = {0.0, 1.0 / 9.0, 1.0 / 3.0, 2.0 / 3.0, 8.0 / 9.0, 1.0};
+        TColgp_Array2OfPnt poles(1, 6, 1, 6);
+        for (int i = 1; i <= 6; i++) {
+            for (int j = 1; j <= 6; j++) {
+                double z = 0.2 * std::sin(double(i)) * std::cos(double(j));
+                poles(i, j) = gp_Pnt(greville[i - 1], greville[j - 1], z);
+            }
+        }
+        TColStd_Array1OfReal knots(1, 4);
+        TColStd_Array1OfInteger mults(1, 4);
+        for (int i = 1; i <= 4; i++) {
+            knots(i) = double(i - 1) / 3.0;
+            mults(i) = 1;
+        }
+        mults(1) = 4;
+        mults(4) = 4;
+        _surface = new Geom_BSplineSurface(poles, knots, knots, mults, mults, 3, 3);
+
+        const int count = 25;
+        _points = new TColgp_Array1OfPnt(0, count * count - 1);
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < count; j++) {
+                double u = double(i) / double(count - 1);
+                double v = double(j) / double(count - 1);
+                _points->SetValue(i * count + j, _surface->Value(u, v));
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        delete _points;
+    }
+
+    Handle(Geom_BSplineSurface) _surface;
+    TColgp_Array1OfPnt* _points {nullptr};
+};
+
+TEST_F(ApproxSurfaceTest, reproduceBSplineSurface)  // NOLINT
+{
+    // Arrange
+    DenseCheckCorrection approx(4, 4, 6, 6);
+    approx.SetUV(Base::Vector3d(1, 0, 0), Base::Vector3d(0, 1, 0));
+
+    // Act
+    Handle(Geom_BSplineSurface) fit = approx.CreateSurface(*_points, 0, false, 1.0);
+
+    // Assert
+    ASSERT_FALSE(fit.IsNull());
+    ASSERT_EQ(fit->NbUPoles(), 6);
+    ASSERT_EQ(fit->NbVPoles(), 6);
+    for (int i = 1; i <= 6; i++) {
+        for (int j = 1; j <= 6; j++) {
+            EXPECT_NEAR(fit->Pole(i, j).Distance(_surface->Pole(i, j)), 0.0, 1e-8);
+        }
+    }
+    EXPECT_EQ(approx.numSolved, 1);
+    EXPECT_NEAR(approx.maxDeviation, 0.0, 1e-10);
+}
+
+TEST_F(ApproxSurfaceTest, sparseMatchesDenseWithCorrection)  // NOLINT
+{
+    // Arrange
+    DenseCheckCorrection approx(4, 4, 5, 5);
+
+    // Act
+    Handle(Geom_BSplineSurface) fit = approx.CreateSurface(*_points, 3, true, 1.0);
+
+    // Assert
+    ASSERT_FALSE(fit.IsNull());
+    EXPECT_GT(approx.numSolved, 1);
+    EXPECT_NEAR(approx.maxDeviation, 0.0, 1e-10);
+}
+
+TEST_F(ApproxSurfaceTest, sparseMatchesDenseWithSmoothing)  // NOLINT
+{
+    // Arrange
+    DenseCheckCorrection approx(4, 4, 8, 8);
+    approx.EnableSmoothing(true, 0.1, 1.0, 0.5, 0.1);
+
+    // Act
+    Handle(Geom_BSplineSurface) fit = approx.CreateSurface(*_points, 3, true, 1.0);
+
+    // Assert
+    ASSERT_FALSE(fit.IsNull());
+    EXPECT_GT(approx.numSolved, 1);
+    EXPECT_NEAR(approx.maxDeviation, 0.0, 1e-10);
+}
+
+TEST_F(ApproxSurfaceTest, smoothMatrixAccessors)  // NOLINT
+{
+    // Arrange
+    Reen::BSplineParameterCorrection approx(4, 4, 6, 6);
+    approx.EnableSmoothing(true, 0.1, 1.0, 0.5, 0.1);
+
+    // Act
+    math_Matrix first = approx.GetFirstSmoothMatrix();
+    Reen::BSplineParameterCorrection copy(4, 4, 6, 6);
+    copy.SetFirstSmoothMatrix(first);
+
+    // Assert
+    ASSERT_EQ(first.RowNumber(), 36);
+    ASSERT_EQ(first.ColNumber(), 36);
+    math_Matrix second = copy.GetFirstSmoothMatrix();
+    for (int i = first.LowerRow(); i <= first.UpperRow(); i++) {
+        for (int j = first.LowerCol(); j <= first.UpperCol(); j++) {
+            EXPECT_DOUBLE_EQ(first(i, j), second(i, j));
+            EXPECT_DOUBLE_EQ(first(i, j), first(j, i));
+        }
+    }
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include <Base/Converter.h>
+#include <Mod/Mesh/App/Mesh.h>
+#include <Mod/Points/App/Points.h>
+#include <Mod/ReverseEngineering/App/ImplicitReconstruction.h>
+
+class ImplicitReconstructionTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // evenly distributed points on the sphere with the center (1,2,3) and radius 2
+        const int count = 2000;
+        const double golden = M_PI * (3.0 - std::sqrt(5.0));
+        for (int i = 0; i < count; i++) {
+            double z = 1.0 - (2.0 * i + 1.0) / count;
+            double r = std::sqrt(1.0 - z * z);
+            Base::Vector3d dir(r * std::cos(golden * i), r * std::sin(golden * i), z);
+            _points.push_back(_center + dir * _radius);
+            _normals.push_back(Base::convertTo<Base::Vector3f>(dir));
+        }
+    }
+
+    void checkSphere(const Mesh::MeshObject& mesh) const
+    {
+        ASSERT_GT(mesh.countFacets(), 0UL);
+        EXPECT_TRUE(mesh.isSolid());
+        EXPECT_FALSE(mesh.hasNonManifolds());
+        EXPECT_EQ(mesh.countComponents(), 1UL);
+        for (unsigned long i = 0; i < mesh.countPoints(); i++) {
+            EXPECT_NEAR(Base::Distance(mesh.getPoint(i), _center), _radius, 0.05);
+        }
+    }
+
+    const Base::Vector3d _center {1, 2, 3};
+    const double _radius {2.0};
+    Points::PointKernel _points;
+    std::vector<Base::Vector3f> _normals;
+};
+
+TEST_F(ImplicitReconstructionTest, sphereWithNormals)  // NOLINT
+{
+    // Arrange
+    Mesh::MeshObject mesh;
+    Reen::ImplicitReconstruction implicit(_points, mesh);
+
+    // Act
+    implicit.perform(_normals);
+
+    // Assert
+    checkSphere(mesh);
+}
+
+TEST_F(ImplicitReconstructionTest, sphereWithEstimatedNormals)  // NOLINT
+{
+    // Arrange
+    Mesh::MeshObject mesh;
+    Reen::ImplicitReconstruction implicit(_points, mesh);
+
+    // Act
+    implicit.perform(10);
+
+    // Assert
+    checkSphere(mesh);
+}
+
+TEST_F(ImplicitReconstructionTest, independentOfThreads)  // NOLINT
+{
+    // Arrange
+    Mesh::MeshObject serial;
+    Mesh::MeshObject parallel;
+    Reen::ImplicitReconstruction implicit1(_points, serial);
+    implicit1.setThreads(1);
+    Reen::ImplicitReconstruction implicit4(_points, parallel);
+    implicit4.setThreads(4);
+
+    // Act
+    implicit1.perform(_normals);
+    implicit4.perform(_normals);
+
+    // Assert
+    ASSERT_EQ(serial.countPoints(), parallel.countPoints());
+    ASSERT_EQ(serial.countFacets(), parallel.countFacets());
+    for (unsigned long i = 0; i < serial.countPoints(); i++) {
+        EXPECT_EQ(serial.getPoint(i), parallel.getPoint(i));
+    }
+}
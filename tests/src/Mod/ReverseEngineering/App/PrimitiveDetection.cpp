@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include <Base/Converter.h>
+#include <Mod/Points/App/Points.h>
+#include <Mod/ReverseEngineering/App/PrimitiveDetection.h>
+
+using Reen::PrimitiveDetection;
+
+class PrimitiveDetectionTest: public ::testing::Test
+{
+protected:
+    void addPoint(const Base::Vector3d& pnt, const Base::Vector3d& nor)
+    {
+        _points.push_back(pnt);
+        _normals.push_back(Base::convertTo<Base::Vector3f>(nor));
+    }
+
+    // 900 points of the plane through (1,2,3) with the normal (1,1,1)
+    void addPlane()
+    {
+        Base::Vector3d normal(1, 1, 1);
+        normal.Normalize();
+        Base::Vector3d dirU(1, -1, 0);
+        dirU.Normalize();
+        Base::Vector3d dirV = normal % dirU;
+        for (int i = 0; i < 30; i++) {
+            for (int j = 0; j < 30; j++) {
+                addPoint(Base::Vector3d(1, 2, 3) + dirU * (0.1 * i) + dirV * (0.1 * j), normal);
+            }
+        }
+    }
+
+    // points of the sphere with the center and radius
+    void addSphere(const Base::Vector3d& center, double radius)
+    {
+        const int rings = 30;
+        const int sectors = 60;
+        for (int i = 0; i < rings; i++) {
+            double theta = M_PI * (i + 0.5) / rings;
+            for (int j = 0; j < sectors; j++) {
+                double phi = 2.0 * M_PI * j / sectors;
+                Base::Vector3d dir(std::sin(theta) * std::cos(phi),
+                                   std::sin(theta) * std::sin(phi),
+                                   std::cos(theta));
+                addPoint(center + dir * radius, dir);
+            }
+        }
+    }
+
+    // 1600 points of the cylinder with the axis through (1,0,0) in y-direction and radius 0.5
+    void addCylinder()
+    {
+        for (int i = 0; i < 40; i++) {
+            double phi = 2.0 * M_PI * i / 40;
+            Base::Vector3d dir(std::cos(phi), 0, std::sin(phi));
+            for (int j = 0; j < 40; j++) {
+                addPoint(Base::Vector3d(1, 0.1 * j, 0) + dir * 0.5, dir);
+            }
+        }
+    }
+
+    // 1800 points of the cone with the apex (1,-1,2), axis in z-direction and half angle 30 degrees
+    void addCone()
+    {
+        const double angle = M_PI / 6.0;
+        for (int i = 0; i < 30; i++) {
+            double height = 1.0 + 2.0 * i / 29;
+            for (int j = 0; j < 60; j++) {
+                double phi = 2.0 * M_PI * j / 60;
+                Base::Vector3d radial(std::cos(phi), std::sin(phi), 0);
+                Base::Vector3d pnt = Base::Vector3d(1, -1, 2)
+                    + radial * (height * std::tan(angle)) + Base::Vector3d(0, 0, height);
+                addPoint(pnt, radial * std::cos(angle) - Base::Vector3d(0, 0, std::sin(angle)));
+            }
+        }
+    }
+
+    std::vector<PrimitiveDetection::Primitive> detect(int threads = 1)
+    {
+        PrimitiveDetection detection(_points, _normals);
+        detection.setThreads(threads);
+        std::vector<PrimitiveDetection::Primitive> primitives;
+        detection.perform(primitives);
+        return primitives;
+    }
+
+    Points::PointKernel _points;
+    std::vector<Base::Vector3f> _normals;
+};
+
+TEST_F(PrimitiveDetectionTest, detectPlane)  // NOLINT
+{
+    // Arrange
+    addPlane();
+
+    // Act
+    auto primitives = detect();
+
+    // Assert
+    ASSERT_EQ(primitives.size(), 1U);
+    const auto& plane = primitives.front();
+    EXPECT_EQ(plane.type, PrimitiveDetection::Plane);
+    EXPECT_EQ(plane.inliers.size(), 900U);
+    EXPECT_NEAR(std::fabs(plane.axis * Base::Vector3d(1, 1, 1)), std::sqrt(3.0), 1e-6);
+    EXPECT_NEAR((plane.base - Base::Vector3d(1, 2, 3)) * plane.axis, 0.0, 1e-5);
+}
+
+TEST_F(PrimitiveDetectionTest, detectSphere)  // NOLINT
+{
+    // Arrange
+    addSphere(Base::Vector3d(1, 2, 3), 2.0);
+
+    // Act
+    auto primitives = detect();
+
+    // Assert
+    ASSERT_EQ(primitives.size(), 1U);
+    const auto& sphere = primitives.front();
+    EXPECT_EQ(sphere.type, PrimitiveDetection::Sphere);
+    EXPECT_EQ(sphere.inliers.size(), 1800U);
+    EXPECT_NEAR(Base::Distance(sphere.base, Base::Vector3d(1, 2, 3)), 0.0, 1e-3);
+    EXPECT_NEAR(sphere.radius, 2.0, 1e-3);
+}
+
+TEST_F(PrimitiveDetectionTest, detectCylinder)  // NOLINT
+{
+    // Arrange
+    addCylinder();
+
+    // Act
+    auto primitives = detect();
+
+    // Assert
+    ASSERT_EQ(primitives.size(), 1U);
+    const auto& cylinder = primitives.front();
+    EXPECT_EQ(cylinder.type, PrimitiveDetection::Cylinder);
+    EXPECT_EQ(cylinder.inliers.size(), 1600U);
+    EXPECT_NEAR(std::fabs(cylinder.axis.y), 1.0, 1e-4);
+    EXPECT_NEAR(cylinder.base.x, 1.0, 1e-3);
+    EXPECT_NEAR(cylinder.base.z, 0.0, 1e-3);
+    EXPECT_NEAR(cylinder.radius, 0.5, 1e-3);
+}
+
+TEST_F(PrimitiveDetectionTest, detectCone)  // NOLINT
+{
+    // Arrange
+    addCone();
+
+    // Act
+    auto primitives = detect();
+
+    // Assert
+    ASSERT_EQ(primitives.size(), 1U);
+    const auto& cone = primitives.front();
+    EXPECT_EQ(cone.type, PrimitiveDetection::Cone);
+    EXPECT_EQ(cone.inliers.size(), 1800U);
+    EXPECT_NEAR(Base::Distance(cone.base, Base::Vector3d(1, -1, 2)), 0.0, 1e-3);
+    EXPECT_NEAR(cone.axis.z, 1.0, 1e-4);
+    EXPECT_NEAR(cone.angle, M_PI / 6.0, 1e-3);
+}
+
+TEST_F(PrimitiveDetectionTest, independentOfThreads)  // NOLINT
+{
+    // Arrange
+    addPlane();
+    addSphere(Base::Vector3d(5, 5, 5), 1.0);
+    addCylinder();
+
+    // Act
+    auto serial = detect(1);
+    auto parallel = detect(4);
+
+    // Assert
+    ASSERT_EQ(serial.size(), 3U);
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (std::size_t i = 0; i < serial.size(); i++) {
+        EXPECT_EQ(serial[i].type, parallel[i].type);
+        EXPECT_EQ(serial[i].base, parallel[i].base);
+        EXPECT_EQ(serial[i].axis, parallel[i].axis);
+        EXPECT_DOUBLE_EQ(serial[i].radius, parallel[i].radius);
+        EXPECT_DOUBLE_EQ(serial[i].angle, parallel[i].angle);
+        EXPECT_EQ(serial[i].inliers, parallel[i].inliers);
+    }
+}